@@ -0,0 +1,106 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <mutex>
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include "common/log/log.h"
+#include "storage/buffer/page.h"
+#include "storage/common/io_backend.h"
+
+using namespace std;
+using namespace common;
+using namespace benchmark;
+
+/**
+ * @brief 比较不同 IoBackend 随机读取页面的性能
+ * @details 每次提交 queue depth 个随机页面的读请求，等待全部完成。
+ * 文件系统支持时使用 O_DIRECT 打开文件，避免全部从操作系统的缓存中读取。
+ */
+
+static const char *BENCHMARK_FILE = "io_backend_benchmark.data";
+static const int   FILE_PAGES     = 4096;
+
+static int open_benchmark_file()
+{
+  static once_flag init_flag;
+  call_once(init_flag, []() {
+    LoggerFactory::init_default("io_backend_benchmark.log", LOG_LEVEL_WARN);
+
+    int fd = open(BENCHMARK_FILE, O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+    vector<char> page(BP_PAGE_SIZE);
+    for (int i = 0; i < FILE_PAGES; i++) {
+      memset(page.data(), i, page.size());
+      if (write(fd, page.data(), page.size()) != static_cast<ssize_t>(page.size())) {
+        LOG_ERROR("failed to write benchmark file");
+        abort();
+      }
+    }
+    fsync(fd);
+    close(fd);
+  });
+
+  int fd = open(BENCHMARK_FILE, O_RDONLY | O_DIRECT);
+  if (fd < 0) {
+    fd = open(BENCHMARK_FILE, O_RDONLY);
+  }
+  return fd;
+}
+
+template <typename Backend>
+static void BM_RandomRead(State &state)
+{
+  Backend backend;
+  if (is_same<Backend, IoUringBackend>::value && !IoUringBackend::available()) {
+    state.SkipWithError("io_uring is not available");
+    return;
+  }
+
+  const int depth = state.range(0);
+  const int fd    = open_benchmark_file();
+
+  char *buffer = nullptr;
+  if (posix_memalign(reinterpret_cast<void **>(&buffer), 4096, static_cast<size_t>(depth) * BP_PAGE_SIZE) != 0) {
+    state.SkipWithError("failed to allocate buffer");
+    return;
+  }
+
+  mt19937                    random(depth);
+  uniform_int_distribution<> page_dist(0, FILE_PAGES - 1);
+  vector<IoRequest>          requests(depth);
+  for (auto _ : state) {
+    for (int i = 0; i < depth; i++) {
+      requests[i].fd     = fd;
+      requests[i].buf    = buffer + static_cast<int64_t>(i) * BP_PAGE_SIZE;
+      requests[i].len    = BP_PAGE_SIZE;
+      requests[i].offset = static_cast<int64_t>(page_dist(random)) * BP_PAGE_SIZE;
+    }
+    if (backend.read(requests.data(), depth) != RC::SUCCESS) {
+      state.SkipWithError("failed to read pages");
+      break;
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * depth);
+  state.SetBytesProcessed(state.iterations() * depth * BP_PAGE_SIZE);
+  free(buffer);
+  close(fd);
+}
+
+BENCHMARK_TEMPLATE(BM_RandomRead, PosixIoBackend)->RangeMultiplier(2)->Range(1, 64);
+BENCHMARK_TEMPLATE(BM_RandomRead, IoUringBackend)->RangeMultiplier(2)->Range(1, 64);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,64 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <benchmark/benchmark.h>
+
+#include "sql/parser/parse.h"
+#include "common/log/log.h"
+
+using namespace std;
+using namespace common;
+using namespace benchmark;
+
+/**
+ * @brief 语法解析的吞吐量
+ * @details 每次迭代解析一遍语句集合，语句以短小的OLTP语句为主。
+ * 和 SQLStageEvent 一样，每条语句使用一个新的 Arena。
+ */
+
+static const char *SQL_CORPUS[] = {
+    "select * from t where id = 1;",
+    "select id, name, score from t where id > 10 and name = 'abc';",
+    "select t.id, s.name from t, s where t.id = s.id and t.score < 3.5;",
+    "select count(*) from t;",
+    "insert into t values (1, 'abc', 2.5);",
+    "insert into t values (1, 'a', 1.5), (2, 'b', 2.5), (3, 'c', 3.5);",
+    "update t set score = 4.5 where id = 1;",
+    "delete from t where id = 1 and name = 'abc';",
+    "create table t(id int, name char(16), score float);",
+    "create index t_id on t(id);",
+    "begin;",
+    "commit;",
+};
+
+static const int SQL_NUM = sizeof(SQL_CORPUS) / sizeof(SQL_CORPUS[0]);
+
+static void BM_Parse(State &state)
+{
+  LoggerFactory::init_default("parse_benchmark.log", LOG_LEVEL_WARN);
+
+  for (auto _ : state) {
+    for (const char *sql : SQL_CORPUS) {
+      Arena           arena;
+      ParsedSqlResult result;
+      parse(sql, &result, arena);
+      if (result.sql_nodes().empty() || result.sql_nodes().front()->flag == SCF_ERROR) {
+        state.SkipWithError(sql);
+        return;
+      }
+      DoNotOptimize(result.sql_nodes().front());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * SQL_NUM);
+}
+
+BENCHMARK(BM_Parse);
+
+BENCHMARK_MAIN();
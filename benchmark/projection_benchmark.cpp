@@ -0,0 +1,155 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <filesystem>
+#include <mutex>
+#include <stdexcept>
+#include <benchmark/benchmark.h>
+
+#include "sql/expr/expression.h"
+#include "sql/expr/tuple.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/common/meta_util.h"
+#include "storage/record/record.h"
+#include "storage/table/table.h"
+#include "storage/trx/trx.h"
+#include "common/log/log.h"
+
+using namespace std;
+using namespace common;
+using namespace benchmark;
+
+/**
+ * @brief 比较投影和表达式求值时，按照名字查找字段与使用 SlotBinder 绑定的位置取值的开销
+ * @details 两张各有16个整数字段的表做连接，投影右表的所有字段，并计算右表最后一个字段上的比较表达式。
+ */
+
+static const int FIELD_NUM = 16;
+
+once_flag         init_flag;
+BufferPoolManager bpm{64};
+
+class ProjectionBenchmark : public Fixture
+{
+public:
+  void SetUp(const State &state) override
+  {
+    std::call_once(init_flag, []() {
+      LoggerFactory::init_default("projection_benchmark.log", LOG_LEVEL_WARN);
+      BufferPoolManager::set_instance(&bpm);
+      TrxKit::init_global("mvcc");  // 表中带上事务使用的系统字段
+    });
+
+    filesystem::remove_all(base_dir_);
+    filesystem::create_directories(base_dir_);
+
+    vector<AttrInfoSqlNode> attrs(FIELD_NUM);
+    for (int i = 0; i < FIELD_NUM; i++) {
+      attrs[i].type   = INTS;
+      attrs[i].name   = "c" + to_string(i);
+      attrs[i].length = sizeof(int);
+    }
+
+    for (int i = 0; i < 2; i++) {
+      tables_[i] = make_unique<Table>();
+      row_tuples_[i] = make_unique<RowTuple>();
+    }
+    joined_tuple_  = make_unique<JoinedTuple>();
+    project_tuple_ = make_unique<ProjectTuple>();
+
+    const char *names[] = {"t1", "t2"};
+    for (int i = 0; i < 2; i++) {
+      string meta_file = table_meta_file(base_dir_, names[i]);
+      RC rc = tables_[i]->create(i, meta_file.c_str(), names[i], base_dir_, FIELD_NUM, attrs.data());
+      if (rc != RC::SUCCESS) {
+        throw runtime_error("failed to create table");
+      }
+
+      const TableMeta &table_meta = tables_[i]->table_meta();
+      data_[i].assign(table_meta.record_size(), 0);
+      records_[i].set_data(data_[i].data(), table_meta.record_size());
+      row_tuples_[i]->set_schema(tables_[i].get(), table_meta.field_metas());
+      row_tuples_[i]->set_record(&records_[i]);
+    }
+
+    joined_tuple_->set_left(row_tuples_[0].get());
+    joined_tuple_->set_right(row_tuples_[1].get());
+
+    const TableMeta &right_meta = tables_[1]->table_meta();
+    const int        sys_field_num = right_meta.sys_field_num();
+    const int        left_cell_num = row_tuples_[0]->cell_num();
+    for (int i = 0; i < FIELD_NUM; i++) {
+      const FieldMeta *field_meta = right_meta.field(sys_field_num + i);
+      project_tuple_->add_cell_spec(new TupleCellSpec(tables_[1]->name(), field_meta->name()));
+      if (state.range(0) != 0) {
+        project_tuple_->set_slot(i, left_cell_num + sys_field_num + i);
+      }
+    }
+    project_tuple_->set_tuple(joined_tuple_.get());
+
+    const FieldMeta *last_field = right_meta.field(sys_field_num + FIELD_NUM - 1);
+    auto field_expr = make_unique<FieldExpr>(tables_[1].get(), last_field);
+    if (state.range(0) != 0) {
+      field_expr->set_slot(left_cell_num + sys_field_num + FIELD_NUM - 1);
+    }
+    predicate_ = make_unique<ComparisonExpr>(EQUAL_TO, std::move(field_expr), make_unique<ValueExpr>(Value(0)));
+  }
+
+  void TearDown(const State &) override
+  {
+    predicate_.reset();
+    project_tuple_.reset();
+    joined_tuple_.reset();
+    for (int i = 0; i < 2; i++) {
+      row_tuples_[i].reset();
+      tables_[i].reset();
+    }
+  }
+
+protected:
+  const char *base_dir_ = "projection_benchmark_dir";
+
+  unique_ptr<Table>        tables_[2];
+  vector<char>             data_[2];
+  Record                   records_[2];
+  unique_ptr<RowTuple>     row_tuples_[2];
+  unique_ptr<JoinedTuple>  joined_tuple_;
+  unique_ptr<ProjectTuple> project_tuple_;
+
+  unique_ptr<Expression> predicate_;
+};
+
+BENCHMARK_DEFINE_F(ProjectionBenchmark, Project)(State &state)
+{
+  Value value;
+  for (auto _ : state) {
+    for (int i = 0; i < project_tuple_->cell_num(); i++) {
+      project_tuple_->cell_at(i, value);
+    }
+    DoNotOptimize(value);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_DEFINE_F(ProjectionBenchmark, Predicate)(State &state)
+{
+  Value value;
+  for (auto _ : state) {
+    predicate_->get_value(*joined_tuple_, value);
+    DoNotOptimize(value);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// 参数为0时按照名字查找字段，为1时使用绑定的位置
+BENCHMARK_REGISTER_F(ProjectionBenchmark, Project)->Arg(0)->Arg(1);
+BENCHMARK_REGISTER_F(ProjectionBenchmark, Predicate)->Arg(0)->Arg(1);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,43 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <benchmark/benchmark.h>
+
+#include "session/statement_digest.h"
+
+using namespace std;
+using namespace benchmark;
+
+/**
+ * @brief 记录一条语句执行统计的开销
+ * @details 和 SessionStage 中一样，每条语句取两次计数器并记录到 StatementDigests 中。
+ * 多个线程记录同一个摘要时，看条带化的计数器在竞争下的表现。
+ */
+static void BM_RecordStatement(State &state)
+{
+  const string digest_text = "select * from test where id = ?";
+  StatementDigests &digests = StatementDigests::instance();
+  if (state.thread_index() == 0) {
+    digests.reset();
+  }
+
+  int64_t latency_ns = 0;
+  for (auto _ : state) {
+    const StatementCounters start_counters = StatementCounters::current();
+    StatementCounters::current().rows_examined++;
+    StatementCounters::current().rows_returned++;
+    digests.record(digest_text, 10000 + (latency_ns++ & 0xfff), StatementCounters::current() - start_counters);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_RecordStatement)->Threads(1)->Threads(4)->Threads(8);
+
+BENCHMARK_MAIN();
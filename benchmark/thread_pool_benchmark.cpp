@@ -0,0 +1,222 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include "common/log/log.h"
+#include "common/seda/thread_pool.h"
+
+using namespace std;
+using namespace common;
+using namespace benchmark;
+
+/**
+ * @brief 比较 seda 线程池的任务分发延迟和吞吐量
+ * @details Threadpool 是当前基于工作窃取(work stealing)的线程池，MutexQueuePool 按照原来 Threadpool
+ * 的方式实现：所有线程共用一个由互斥锁保护的队列。
+ * - Throughput: 外部线程(比如网络线程)一次提交一批任务，等待全部执行完成
+ * - FanOut: 任务在线程池中继续提交子任务，类似多个stage组成的流水线或并行查询
+ * - Latency: 提交一个任务，等它执行完再提交下一个
+ */
+
+class MutexQueuePool
+{
+public:
+  explicit MutexQueuePool(int threads)
+  {
+    for (int i = 0; i < threads; i++) {
+      threads_.emplace_back([this]() { run(); });
+    }
+  }
+
+  ~MutexQueuePool()
+  {
+    {
+      lock_guard<mutex> guard(mutex_);
+      stopped_ = true;
+    }
+    cond_.notify_all();
+    for (thread &t : threads_) {
+      t.join();
+    }
+  }
+
+  void execute(Runnable *task)
+  {
+    lock_guard<mutex> guard(mutex_);
+    bool was_empty = queue_.empty();
+    queue_.push_back(task);
+    if ((!was_empty || current_pool_ != this) && idles_ > 0) {
+      cond_.notify_one();
+    }
+  }
+
+private:
+  void run()
+  {
+    current_pool_ = this;
+    while (true) {
+      Runnable *task = nullptr;
+      {
+        unique_lock<mutex> lock(mutex_);
+        while (queue_.empty() && !stopped_) {
+          idles_++;
+          cond_.wait(lock);
+          idles_--;
+        }
+        if (queue_.empty()) {
+          return;
+        }
+        task = queue_.front();
+        queue_.pop_front();
+      }
+      task->run();
+    }
+  }
+
+private:
+  mutex               mutex_;
+  condition_variable  cond_;
+  deque<Runnable *>   queue_;
+  int                 idles_   = 0;
+  bool                stopped_ = false;
+  vector<thread>      threads_;
+
+  static thread_local MutexQueuePool *current_pool_;
+};
+
+thread_local MutexQueuePool *MutexQueuePool::current_pool_ = nullptr;
+
+static void init_threadpool()
+{
+  static once_flag init_flag;
+  call_once(init_flag, []() {
+    LoggerFactory::init_default("thread_pool_benchmark.log", LOG_LEVEL_WARN);
+    Threadpool::create_pool_key();
+  });
+}
+
+template <typename Pool>
+static unique_ptr<Pool> make_pool(int threads)
+{
+  init_threadpool();
+  return make_unique<Pool>(threads);
+}
+
+template <>
+unique_ptr<Threadpool> make_pool<Threadpool>(int threads)
+{
+  init_threadpool();
+  return make_unique<Threadpool>(threads, "BenchThreads");
+}
+
+static void wait_for(const atomic<int64_t> &counter, int64_t target)
+{
+  while (counter.load(memory_order_acquire) < target) {
+    this_thread::yield();
+  }
+}
+
+class CountTask : public Runnable
+{
+public:
+  void run() override { counter.fetch_add(1, memory_order_release); }
+
+  atomic<int64_t> counter{0};
+};
+
+template <typename Pool>
+class SpawnTask : public Runnable
+{
+public:
+  void run() override
+  {
+    // 每个任务再提交两个子任务，直到提交的任务总数达到 target_
+    int64_t spawned = spawned_.fetch_add(2, memory_order_relaxed);
+    for (int64_t i = spawned; i < spawned + 2 && i < target_; i++) {
+      pool_->execute(this);
+    }
+    finished.fetch_add(1, memory_order_release);
+  }
+
+  void reset(Pool *pool, int64_t target)
+  {
+    pool_   = pool;
+    target_ = target;
+    spawned_.store(1, memory_order_relaxed);
+    finished.store(0, memory_order_relaxed);
+  }
+
+  atomic<int64_t> finished{0};
+
+private:
+  Pool           *pool_   = nullptr;
+  int64_t         target_ = 0;
+  atomic<int64_t> spawned_{0};
+};
+
+static const int64_t BATCH_TASKS = 10000;
+
+template <typename Pool>
+static void BM_Throughput(State &state)
+{
+  unique_ptr<Pool> pool = make_pool<Pool>(state.range(0));
+  CountTask task;
+  int64_t target = 0;
+  for (auto _ : state) {
+    for (int64_t i = 0; i < BATCH_TASKS; i++) {
+      pool->execute(&task);
+    }
+    target += BATCH_TASKS;
+    wait_for(task.counter, target);
+  }
+  state.SetItemsProcessed(state.iterations() * BATCH_TASKS);
+}
+
+template <typename Pool>
+static void BM_FanOut(State &state)
+{
+  unique_ptr<Pool> pool = make_pool<Pool>(state.range(0));
+  SpawnTask<Pool> task;
+  for (auto _ : state) {
+    task.reset(pool.get(), BATCH_TASKS);
+    pool->execute(&task);
+    wait_for(task.finished, BATCH_TASKS);
+  }
+  state.SetItemsProcessed(state.iterations() * BATCH_TASKS);
+}
+
+template <typename Pool>
+static void BM_Latency(State &state)
+{
+  unique_ptr<Pool> pool = make_pool<Pool>(state.range(0));
+  CountTask task;
+  int64_t target = 0;
+  for (auto _ : state) {
+    pool->execute(&task);
+    wait_for(task.counter, ++target);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_TEMPLATE(BM_Throughput, MutexQueuePool)->RangeMultiplier(2)->Range(1, 64)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Throughput, Threadpool)->RangeMultiplier(2)->Range(1, 64)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_FanOut, MutexQueuePool)->RangeMultiplier(2)->Range(1, 64)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_FanOut, Threadpool)->RangeMultiplier(2)->Range(1, 64)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Latency, MutexQueuePool)->RangeMultiplier(2)->Range(1, 64)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Latency, Threadpool)->RangeMultiplier(2)->Range(1, 64)->UseRealTime();
+
+BENCHMARK_MAIN();
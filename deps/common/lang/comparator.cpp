@@ -23,7 +23,13 @@ int compare_int(void *arg1, void *arg2)
 {
   int v1 = *(int *)arg1;
   int v2 = *(int *)arg2;
-  return v1 - v2;
+  // 不能直接返回 v1 - v2，可能会溢出
+  if (v1 > v2) {
+    return 1;
+  } else if (v1 < v2) {
+    return -1;
+  }
+  return 0;
 }
 
 int compare_float(void *arg1, void *arg2)
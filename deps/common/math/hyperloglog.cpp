@@ -0,0 +1,78 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <math.h>
+#include <algorithm>
+#include <functional>
+#include <string_view>
+
+#include "common/math/hyperloglog.h"
+
+namespace common {
+
+/**
+ * @brief 打散哈希值的比特位
+ * @details std::hash 对很多类型不做任何混淆，这里使用splitmix64的最后一步
+ */
+static uint64_t mix_hash(uint64_t x)
+{
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
+HyperLogLog::HyperLogLog(int precision) : precision_(std::clamp(precision, 4, 16)), registers_(1 << precision_, 0)
+{}
+
+void HyperLogLog::add(const void *data, size_t len)
+{
+  add_hash(mix_hash(std::hash<std::string_view>()(std::string_view(static_cast<const char *>(data), len))));
+}
+
+void HyperLogLog::add_hash(uint64_t hash)
+{
+  const uint64_t index = hash & ((1ULL << precision_) - 1);
+  const uint64_t rest = hash >> precision_;
+  // rest 中只有 64 - precision_ 个有效位，全为0时取最大值
+  const int bits = 64 - precision_;
+  const uint8_t rank = rest == 0 ? bits + 1 : __builtin_ctzll(rest) + 1;
+  registers_[index] = std::max(registers_[index], rank);
+}
+
+double HyperLogLog::estimate() const
+{
+  const double m = static_cast<double>(registers_.size());
+  double sum = 0;
+  int zeros = 0;
+  for (uint8_t value : registers_) {
+    sum += ldexp(1.0, -value);
+    if (value == 0) {
+      zeros++;
+    }
+  }
+
+  const double alpha = 0.7213 / (1 + 1.079 / m);
+  double estimate = alpha * m * m / sum;
+  // 基数比较小时，使用线性计数修正
+  if (estimate <= 2.5 * m && zeros > 0) {
+    estimate = m * log(m / zeros);
+  }
+  return estimate;
+}
+
+void HyperLogLog::clear()
+{
+  std::fill(registers_.begin(), registers_.end(), 0);
+}
+
+}  // namespace common
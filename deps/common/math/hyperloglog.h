@@ -0,0 +1,46 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#ifndef __COMMON_MATH_HYPERLOGLOG_H_
+#define __COMMON_MATH_HYPERLOGLOG_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace common {
+
+/**
+ * @brief 使用HyperLogLog估算不同值的个数(NDV)
+ * @details 每个值先计算64位的哈希值，低 precision 位选择一个寄存器，其余位中第一个1出现的位置
+ * 记录到寄存器中。使用 2^precision 个字节的内存，标准误差大约是 1.04/sqrt(2^precision)。
+ */
+class HyperLogLog {
+public:
+  explicit HyperLogLog(int precision = 12);
+
+  void add(const void *data, size_t len);
+  void add_hash(uint64_t hash);
+
+  /**
+   * @brief 估算添加过的不同值的个数
+   */
+  double estimate() const;
+
+  void clear();
+
+private:
+  int precision_;
+  std::vector<uint8_t> registers_;
+};
+
+}  // namespace common
+
+#endif /* __COMMON_MATH_HYPERLOGLOG_H_ */
@@ -0,0 +1,97 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <new>
+
+#include "common/mm/arena.h"
+
+namespace common {
+
+static char *align_up(char *ptr, size_t alignment)
+{
+  uintptr_t value = reinterpret_cast<uintptr_t>(ptr);
+  return reinterpret_cast<char *>((value + alignment - 1) & ~(uintptr_t)(alignment - 1));
+}
+
+Arena::~Arena()
+{
+  reset();
+}
+
+void *Arena::alloc(size_t size, size_t alignment)
+{
+  char *ptr = align_up(pos_, alignment);
+  if (ptr > end_ || size > static_cast<size_t>(end_ - ptr)) {
+    return alloc_from_new_block(size, alignment);
+  }
+
+  used_ += ptr + size - pos_;
+  pos_ = ptr + size;
+  return ptr;
+}
+
+char *Arena::dup(const char *str, size_t len)
+{
+  char *ptr = static_cast<char *>(alloc(len + 1, 1));
+  memcpy(ptr, str, len);
+  ptr[len] = '\0';
+  return ptr;
+}
+
+void *Arena::alloc_from_new_block(size_t size, size_t alignment)
+{
+  // 块头之后按照 max_align_t 对齐，更大的对齐要求预留额外的空间
+  const size_t header_size = (sizeof(Block) + alignof(max_align_t) - 1) & ~(alignof(max_align_t) - 1);
+  const size_t extra = alignment > alignof(max_align_t) ? alignment : 0;
+  const size_t block_size = std::max(next_block_size_, header_size + size + extra);
+
+  Block *block = static_cast<Block *>(malloc(block_size));
+  if (block == nullptr) {
+    throw std::bad_alloc();
+  }
+  block->prev = last_block_;
+  block->size = block_size;
+  last_block_ = block;
+  next_block_size_ = std::min(next_block_size_ * 2, MAX_BLOCK_SIZE);
+
+  char *begin = reinterpret_cast<char *>(block) + header_size;
+  char *ptr = align_up(begin, alignment);
+  pos_ = ptr + size;
+  end_ = reinterpret_cast<char *>(block) + block_size;
+  used_ += pos_ - begin;
+  return ptr;
+}
+
+void Arena::reset()
+{
+  // 析构函数中还可能访问 arena 中的其它对象，要在释放内存之前全部调用
+  while (last_destructor_ != nullptr) {
+    Destructor *destructor = last_destructor_;
+    last_destructor_ = destructor->prev;
+    destructor->destroy(destructor->object);
+  }
+
+  while (last_block_ != nullptr) {
+    Block *prev = last_block_->prev;
+    free(last_block_);
+    last_block_ = prev;
+  }
+
+  pos_ = inline_block_;
+  end_ = inline_block_ + INLINE_SIZE;
+  next_block_size_ = MIN_BLOCK_SIZE;
+  used_ = 0;
+}
+
+}  // namespace common
@@ -0,0 +1,110 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <stddef.h>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace common {
+
+/**
+ * @brief 按顺序分配内存的内存池(bump allocator)
+ * @details 从当前内存块中顺序切分内存，不能单独释放，Arena 析构或者 reset 时一次性释放。
+ * 适合生命周期相同的大量小对象，比如一条SQL语句解析过程中的临时数据。
+ * 对象自带一小块内存，短语句通常不需要再向系统申请内存。
+ * alloc 分配的内存不会调用析构函数，需要析构的对象使用 create 构造。不是线程安全的。
+ */
+class Arena
+{
+public:
+  static constexpr size_t INLINE_SIZE = 1024;
+  static constexpr size_t MIN_BLOCK_SIZE = 4096;
+  static constexpr size_t MAX_BLOCK_SIZE = 1024 * 1024;
+
+public:
+  Arena() = default;
+  ~Arena();
+
+  Arena(const Arena &) = delete;
+  Arena &operator=(const Arena &) = delete;
+
+  /**
+   * @brief 分配 size 字节的内存，按照 alignment 对齐
+   * @param alignment 必须是2的幂
+   */
+  void *alloc(size_t size, size_t alignment = alignof(max_align_t));
+
+  /**
+   * @brief 复制一个字符串，结尾补充'\0'
+   */
+  char *dup(const char *str, size_t len);
+
+  /**
+   * @brief 在 arena 中构造一个对象
+   * @details 对象需要析构时记录下来，Arena 析构或者 reset 时按照构造的逆序调用析构函数，
+   * 调用者不能再 delete 这个对象
+   */
+  template <typename T, typename... Args>
+  T *create(Args &&...args)
+  {
+    T *object = new (alloc(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      Destructor *destructor = static_cast<Destructor *>(alloc(sizeof(Destructor), alignof(Destructor)));
+      destructor->prev    = last_destructor_;
+      destructor->object  = object;
+      destructor->destroy = [](void *ptr) { static_cast<T *>(ptr)->~T(); };
+      last_destructor_    = destructor;
+    }
+    return object;
+  }
+
+  /**
+   * @brief 析构 create 构造的对象，释放所有的内存，只保留对象自带的内存
+   */
+  void reset();
+
+  /**
+   * @brief 已经分配出去的字节数，包括对齐浪费的部分
+   */
+  size_t used() const { return used_; }
+
+private:
+  void *alloc_from_new_block(size_t size, size_t alignment);
+
+private:
+  /// 额外申请的内存块，按照链表组织，方便一次释放
+  struct Block
+  {
+    Block *prev;
+    size_t size;
+  };
+
+  /// create 构造的需要析构的对象，也按照链表组织，本身也分配在 arena 中
+  struct Destructor
+  {
+    Destructor *prev;
+    void       *object;
+    void      (*destroy)(void *);
+  };
+
+  alignas(max_align_t) char inline_block_[INLINE_SIZE];
+
+  char  *pos_ = inline_block_;
+  char  *end_ = inline_block_ + INLINE_SIZE;
+  Block *last_block_ = nullptr;
+  Destructor *last_destructor_ = nullptr;
+  size_t next_block_size_ = MIN_BLOCK_SIZE;
+  size_t used_ = 0;
+};
+
+}  // namespace common
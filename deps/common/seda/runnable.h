@@ -0,0 +1,29 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#ifndef __COMMON_SEDA_RUNNABLE_H__
+#define __COMMON_SEDA_RUNNABLE_H__
+
+namespace common {
+
+/**
+ * A unit of work that can be executed by a Threadpool
+ * A scheduled Stage is a Runnable which handles one event of the stage.
+ * Other users, such as parallel query workers, can submit their own
+ * Runnables with Threadpool::execute().  The pool does not own them.
+ */
+class Runnable {
+public:
+  virtual ~Runnable() = default;
+  virtual void run() = 0;
+};
+
+}  // namespace common
+#endif  // __COMMON_SEDA_RUNNABLE_H__
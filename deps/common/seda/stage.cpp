@@ -217,6 +217,44 @@ StageEvent *Stage::remove_event()
   return se;
 }
 
+/**
+ * Handle the first event on the queue. Called only by service thread.
+ */
+void Stage::run()
+{
+  StageEvent *event = remove_event();
+
+  // need to check if this is a rescheduled callback
+  if (event->is_callback()) {
+#ifdef ENABLE_STAGE_LEVEL_TIMEOUT
+    // check if the event has timed out.
+    if (event->has_timed_out()) {
+      event->done_timeout();
+    } else {
+      event->done_immediate();
+    }
+#else
+    event->done_immediate();
+#endif
+  } else {
+    if (get_event_history_flag()) {
+      event->save_stage(this, StageEvent::HANDLE_EV);
+    }
+
+#ifdef ENABLE_STAGE_LEVEL_TIMEOUT
+    // check if the event has timed out
+    if (event->has_timed_out()) {
+      event->done();
+    } else {
+      handle_event(event);
+    }
+#else
+    handle_event(event);
+#endif
+  }
+  release_event();
+}
+
 /**
  * Release event reference on stage.  Called only by service thread.
  *
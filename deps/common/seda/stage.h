@@ -24,6 +24,7 @@ See the Mulan PSL v2 for more details. */
 #include "common/log/log.h"
 
 // seda headers
+#include "common/seda/runnable.h"
 #include "common/seda/stage_event.h"
 namespace common {
 
@@ -85,7 +86,7 @@ class CallbackContext;
  * repeatedly disconnected then re-connected and continue to function
  * properly.
  */
-class Stage {
+class Stage : public Runnable {
 
   // public interface operations
 
@@ -215,6 +216,14 @@ public:
    */
   virtual void handle_event(StageEvent *event) = 0;
 
+  /**
+   * Handle the first event on the queue. Called only by service thread.
+   * The Threadpool runs a stage once for every event scheduled.
+   *
+   * @pre  queue not empty
+   */
+  void run() override;
+
   /**
    * Perform Stage-specific callback processing for an event
    * Implement callback processing according to the requirements of
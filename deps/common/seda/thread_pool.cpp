@@ -22,7 +22,10 @@ See the Mulan PSL v2 for more details. */
 #include "common/seda/stage.h"
 namespace common {
 
-extern bool &get_event_history_flag();
+namespace {
+// the worker slot owned by current thread, used together with the thread pool pointer
+thread_local void *current_worker = nullptr;
+}  // namespace
 
 /**
  * Constructor
@@ -31,17 +34,20 @@ extern bool &get_event_history_flag();
  * @post thread pool has <i>threads</i> threads running
  */
 Threadpool::Threadpool(unsigned int threads, const std::string &name)
-    : run_queue_(),
-      eventhist_(get_event_history_flag()),
+    : nworkers_(0),
+      next_inject_(0),
+      n_wakeups_(0),
+      n_idles_(0),
+      n_searching_(0),
       nthreads_(0),
       threads_to_kill_(0),
-      n_idles_(0),
       killer_("KillThreads"),
       name_(name)
 {
   LOG_TRACE("Enter, thread number:%d", threads);
-  MUTEX_INIT(&run_mutex_, NULL);
-  COND_INIT(&run_cond_, NULL);
+  for (unsigned int i = 0; i < MAX_THREADS; i++) {
+    workers_[i].store(nullptr, std::memory_order_relaxed);
+  }
   MUTEX_INIT(&thread_mutex_, NULL);
   COND_INIT(&thread_cond_, NULL);
   add_threads(threads);
@@ -60,9 +66,10 @@ Threadpool::~Threadpool()
   // kill all the remaining service threads
   kill_threads(nthreads_);
 
-  run_queue_.clear();
-  MUTEX_DESTROY(&run_mutex_);
-  COND_DESTROY(&run_cond_);
+  // remaining work is dropped, all threads are gone
+  for (unsigned int i = 0; i < MAX_THREADS; i++) {
+    delete workers_[i].load(std::memory_order_relaxed);
+  }
   MUTEX_DESTROY(&thread_mutex_);
   COND_DESTROY(&thread_cond_);
   LOG_TRACE("%s", "exit");
@@ -100,6 +107,23 @@ unsigned int Threadpool::add_threads(unsigned int threads)
 
   MUTEX_LOCK(&thread_mutex_);
 
+  // every thread needs a worker slot
+  if (nthreads_ + threads > MAX_THREADS) {
+    LOG_WARN("too many threads in pool %s. current=%d, adding=%d, max=%d",
+             name_.c_str(), nthreads_, threads, MAX_THREADS);
+    threads = MAX_THREADS - nthreads_;
+  }
+
+  // allocate worker slots before starting threads, so work can be scheduled
+  // before the threads are running
+  unsigned int nworkers = nworkers_.load(std::memory_order_relaxed);
+  for (; nworkers < nthreads_ + threads; nworkers++) {
+    Worker *worker = new Worker();
+    worker->index = nworkers;
+    workers_[nworkers].store(worker, std::memory_order_release);
+  }
+  nworkers_.store(nworkers, std::memory_order_release);
+
   // attempt to start the requested number of threads
   for (i = 0; i < threads; i++) {
     int stat = pthread_create(&pthread, &pthread_attrs, Threadpool::run_thread, (void *)this);
@@ -167,8 +191,21 @@ unsigned int Threadpool::kill_threads(unsigned int threads)
  */
 void Threadpool::thread_kill()
 {
+  // called by the thread to be killed, hand over its work to other threads
+  Worker *worker = static_cast<Worker *>(current_worker);
+  bool moved = false;
+  for (Runnable *task = worker->queue.pop(); task != nullptr; task = worker->queue.pop()) {
+    push_injected(worker, task);
+    moved = true;
+  }
+  if (moved) {
+    wakeup_one();
+  }
+  current_worker = nullptr;
+
   MUTEX_LOCK(&thread_mutex_);
 
+  worker->in_use = false;
   nthreads_--;
   threads_to_kill_--;
   if (threads_to_kill_ == 0) {
@@ -220,19 +257,172 @@ unsigned int Threadpool::gen_kill_thread_events(unsigned int to_kill)
 void Threadpool::schedule(Stage *stage)
 {
   assert(!stage->qempty());
+  execute(stage);
+}
 
-  MUTEX_LOCK(&run_mutex_);
-  bool was_empty = run_queue_.empty();
-  run_queue_.push_back(stage);
-  // let current thread continue to run the target stage if there is
-  // only one event and the target stage is in the same thread pool
-  if (was_empty == false || this != get_thread_pool_ptr()) {
-    // wake up if there is idle thread
-    if (n_idles_ > 0) {
-      COND_SIGNAL(&run_cond_);
+/**
+ * Execute a task on one of the threads of the pool
+ * Tasks scheduled by the threads of this pool are pushed to their own
+ * deque, others are spread over the injection queues.
+ */
+void Threadpool::execute(Runnable *task)
+{
+  bool need_wakeup = true;
+  if (this == get_thread_pool_ptr() && current_worker != nullptr) {
+    Worker *worker = static_cast<Worker *>(current_worker);
+    worker->queue.push(task);
+    // let current thread continue to run the task if there is
+    // only one task in its queue
+    need_wakeup = worker->queue.size() > 1;
+  } else {
+    unsigned int nworkers = nworkers_.load(std::memory_order_acquire);
+    if (nworkers == 0) {
+      LOG_ERROR("no thread in pool %s", name_.c_str());
+      return;
     }
+    unsigned int index = next_inject_.fetch_add(1, std::memory_order_relaxed) % nworkers;
+    push_injected(workers_[index].load(std::memory_order_acquire), task);
+  }
+
+  if (need_wakeup) {
+    wakeup_one();
+  }
+}
+
+void Threadpool::wakeup_one()
+{
+  // pairs with the fence in next_task, so either the parking thread sees
+  // the new task, or we see it is idle or searching
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (n_searching_.load(std::memory_order_relaxed) > 0 || n_idles_.load(std::memory_order_relaxed) == 0) {
+    return;
+  }
+
+  // the woken thread is counted as searching, so later tasks will not wake more threads
+  unsigned int expected = 0;
+  if (!n_searching_.compare_exchange_strong(expected, 1)) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> guard(park_mutex_);
+    n_wakeups_++;
+  }
+  park_cond_.notify_one();
+}
+
+void Threadpool::push_injected(Worker *worker, Runnable *task)
+{
+  std::lock_guard<std::mutex> guard(worker->inject_mutex);
+  worker->inject_queue.push_back(task);
+  worker->inject_size.fetch_add(1, std::memory_order_release);
+}
+
+Runnable *Threadpool::pop_injected(Worker *worker)
+{
+  if (worker->inject_size.load(std::memory_order_acquire) == 0) {
+    return nullptr;
+  }
+
+  std::lock_guard<std::mutex> guard(worker->inject_mutex);
+  if (worker->inject_queue.empty()) {
+    return nullptr;
   }
-  MUTEX_UNLOCK(&run_mutex_);
+  Runnable *task = worker->inject_queue.front();
+  worker->inject_queue.pop_front();
+  worker->inject_size.fetch_sub(1, std::memory_order_relaxed);
+  return task;
+}
+
+Runnable *Threadpool::find_task(Worker *worker)
+{
+  Runnable *task = worker->queue.pop();
+  if (task != nullptr) {
+    return task;
+  }
+
+  task = pop_injected(worker);
+  if (task != nullptr) {
+    return task;
+  }
+
+  // steal from others, start from the next slot so that victims are spread
+  const unsigned int nworkers = nworkers_.load(std::memory_order_acquire);
+  const unsigned int start = worker->index + 1;
+  for (unsigned int i = 0; i < nworkers; i++) {
+    Worker *victim = workers_[(start + i) % nworkers].load(std::memory_order_acquire);
+    if (victim == worker) {
+      continue;
+    }
+    // steal may fail because of racing with other threads, retry while there is something
+    while (!victim->queue.empty()) {
+      task = victim->queue.steal();
+      if (task != nullptr) {
+        return task;
+      }
+    }
+    task = pop_injected(victim);
+    if (task != nullptr) {
+      return task;
+    }
+  }
+  return nullptr;
+}
+
+Runnable *Threadpool::next_task(Worker *worker)
+{
+  bool searching = false;  // woken by wakeup_one and counted in n_searching_
+  while (true) {
+    Runnable *task = find_task(worker);
+    if (searching) {
+      searching = false;
+      // the last searching thread found some work. The task may block for a long
+      // time and there may be more work, so let another thread search.
+      if (n_searching_.fetch_sub(1) == 1 && task != nullptr) {
+        wakeup_one();
+      }
+    }
+    if (task != nullptr) {
+      return task;
+    }
+
+    n_idles_.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    // check again, some work may be scheduled before we were counted as idle
+    task = find_task(worker);
+    if (task != nullptr) {
+      n_idles_.fetch_sub(1, std::memory_order_relaxed);
+      return task;
+    }
+
+    {
+      std::unique_lock<std::mutex> lock(park_mutex_);
+      park_cond_.wait(lock, [this]() { return n_wakeups_ > 0; });
+      n_wakeups_--;
+    }
+    n_idles_.fetch_sub(1, std::memory_order_relaxed);
+    searching = true;
+  }
+}
+
+Threadpool::Worker *Threadpool::attach_worker()
+{
+  MUTEX_LOCK(&thread_mutex_);
+  Worker *worker = nullptr;
+  const unsigned int nworkers = nworkers_.load(std::memory_order_relaxed);
+  for (unsigned int i = 0; i < nworkers; i++) {
+    Worker *slot = workers_[i].load(std::memory_order_relaxed);
+    if (!slot->in_use) {
+      worker = slot;
+      break;
+    }
+  }
+
+  // add_threads allocates a slot for every thread
+  ASSERT(worker != nullptr, "no free worker slot in pool %s", name_.c_str());
+  worker->in_use = true;
+  MUTEX_UNLOCK(&thread_mutex_);
+  return worker;
 }
 
 // Get name of thread pool
@@ -262,54 +452,14 @@ void *Threadpool::run_thread(void *pool_ptr)
   pthread_setname_np(pthread_self(), pool->get_name().c_str());
 #endif
 
-  // enter a loop where we continuously look for events from Stages on
-  // the run_queue_ and handle the event.
-  while (1) {
-    MUTEX_LOCK(&(pool->run_mutex_));
+  Worker *worker = pool->attach_worker();
+  current_worker = worker;
 
-    // wait for some stage to be scheduled
-    while (pool->run_queue_.empty()) {
-      (pool->n_idles_)++;
-      COND_WAIT(&(pool->run_cond_), &(pool->run_mutex_));
-      (pool->n_idles_)--;
-    }
-
-    assert(!pool->run_queue_.empty());
-    Stage *run_stage = *(pool->run_queue_.begin());
-    pool->run_queue_.pop_front();
-    MUTEX_UNLOCK(&(pool->run_mutex_));
-
-    StageEvent *event = run_stage->remove_event();
-
-    // need to check if this is a rescheduled callback
-    if (event->is_callback()) {
-#ifdef ENABLE_STAGE_LEVEL_TIMEOUT
-      // check if the event has timed out.
-      if (event->has_timed_out()) {
-        event->done_timeout();
-      } else {
-        event->done_immediate();
-      }
-#else
-      event->done_immediate();
-#endif
-    } else {
-      if (pool->eventhist_) {
-        event->save_stage(run_stage, StageEvent::HANDLE_EV);
-      }
-
-#ifdef ENABLE_STAGE_LEVEL_TIMEOUT
-      // check if the event has timed out
-      if (event->has_timed_out()) {
-        event->done();
-      } else {
-        run_stage->handle_event(event);
-      }
-#else
-      run_stage->handle_event(event);
-#endif
-    }
-    run_stage->release_event();
+  // enter a loop where we continuously look for scheduled stages and
+  // tasks and run them. A killed thread exits inside run().
+  while (1) {
+    Runnable *task = pool->next_task(worker);
+    task->run();
   }
   LOG_TRACE("exit %p", pool_ptr);
   LOG_INFO("Begin to exit, threadid = %llx, threadname = %s", threadid, pool->get_name().c_str());
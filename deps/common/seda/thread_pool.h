@@ -15,25 +15,30 @@ See the Mulan PSL v2 for more details. */
 #ifndef __COMMON_SEDA_THREAD_POOL_H__
 #define __COMMON_SEDA_THREAD_POOL_H__
 
+#include <atomic>
+#include <condition_variable>
 #include <deque>
+#include <mutex>
 
 #include "common/defs.h"
 #include "common/seda/kill_thread.h"
+#include "common/seda/runnable.h"
+#include "common/seda/work_stealing_queue.h"
 namespace common {
 
 class Stage;
 
 /**
- * A thread pool for one or more seda stages
- * The Threadpool class consists of a pool of worker threads and a
- * scheduling queue of active seda Stages that have events that need
- * processing.  Each thread in the thread pool constantly examines the
- * head of the scheduling queue for a scheduled stage.  It then removes
- * the scheduled stage from the queue, and selects an event from the
- * Stage's event queue for processing. The thread then processes the event
- * using the Stage's handle_event() member function before starting the
- * process over.  If the thread finds the scheduling queue empty, it sleeps
- * on a condition waiting for Stages to schedule themselves.
+ * A work stealing thread pool for one or more seda stages
+ * Every worker thread owns a lock-free deque (WorkStealingQueue) of
+ * Runnables and a small injection queue.  Work scheduled by a worker
+ * thread of the pool goes to the bottom of its own deque, so a pipeline of
+ * stages in the same pool runs on one thread without any lock.  Work
+ * scheduled by other threads, such as the network threads, is spread over
+ * the injection queues of all workers round-robin.  A worker takes work
+ * from its own deque first, then from its injection queue, and finally
+ * steals from the other workers.  If it finds nothing, it parks on a
+ * condition variable until new work is scheduled.
  * <p>
  * The number of threads in the pool can be controlled by clients. On
  * creation, the caller provides a parameter indicating the initial number
@@ -106,6 +111,12 @@ public:
    */
   void schedule(Stage *stage);
 
+  /**
+   * Execute a task on one of the threads of the pool
+   * @param[in] task The task to run, must stay alive until it is finished.
+   */
+  void execute(Runnable *task);
+
   // Get name of thread pool
   const std::string &get_name();
 
@@ -130,6 +141,43 @@ protected:
   unsigned int gen_kill_thread_events(unsigned int to_kill);
 
 private:
+  // max number of threads in one pool
+  static const unsigned int MAX_THREADS = 128;
+
+  // per thread scheduling state
+  struct Worker {
+    WorkStealingQueue<Runnable *> queue;  //< work scheduled by the owner thread
+    std::mutex inject_mutex;              //< protects inject_queue
+    std::deque<Runnable *> inject_queue;  //< work scheduled by other threads
+    std::atomic<size_t> inject_size{0};
+    unsigned int index = 0;  //< position in workers_
+    bool in_use = false;     //< a thread owns this worker, protected by thread_mutex_
+  };
+
+  /**
+   * Bind the calling service thread to a free worker slot
+   */
+  Worker *attach_worker();
+
+  /**
+   * Wait for the next task for the worker, park if there is nothing to do
+   */
+  Runnable *next_task(Worker *worker);
+
+  /**
+   * Find a task without waiting: own deque, own injection queue, then steal
+   */
+  Runnable *find_task(Worker *worker);
+
+  // pop a task from the injection queue of the worker
+  static Runnable *pop_injected(Worker *worker);
+
+  // push a task to the injection queue of the worker
+  static void push_injected(Worker *worker, Runnable *task);
+
+  // wake up one parked thread to search for work, unless some thread is searching
+  void wakeup_one();
+
   /**
    * Internal thread control function
    * Function which contains the control loop for each service thread.
@@ -144,17 +192,22 @@ private:
   static const Threadpool *get_thread_pool_ptr();
 
   // run queue state
-  pthread_mutex_t run_mutex_;      //< protects the run queue
-  pthread_cond_t run_cond_;        //< wait here for stage to be scheduled
-  std::deque<Stage *> run_queue_;  //< list of stages with work to do
-  bool eventhist_;                 //< is event history enabled?
+  std::atomic<Worker *> workers_[MAX_THREADS];  //< worker slots, never freed until destroyed
+  std::atomic<unsigned int> nworkers_;          //< number of worker slots allocated
+  std::atomic<unsigned int> next_inject_;       //< round-robin cursor for injection
+
+  // parking state
+  std::mutex park_mutex_;                  //< protects n_wakeups_
+  std::condition_variable park_cond_;      //< wait here for work to be scheduled
+  unsigned int n_wakeups_;                 //< pending wakeups, each one wakes a thread to search
+  std::atomic<unsigned int> n_idles_;      //< number of parked or parking threads
+  std::atomic<unsigned int> n_searching_;  //< number of woken threads looking for work
 
   // thread state
   pthread_mutex_t thread_mutex_;  //< protects thread state
   pthread_cond_t thread_cond_;    //< wait here when killing threads
   unsigned int nthreads_;         //< number of service threads
   unsigned int threads_to_kill_;  //< number of pending kill events
-  unsigned int n_idles_;          //< number of idle threads
   KillThreadStage killer_;        //< used to kill threads
   std::string name_;              //< name of threadpool
 
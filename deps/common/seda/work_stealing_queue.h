@@ -0,0 +1,175 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#ifndef __COMMON_SEDA_WORK_STEALING_QUEUE_H__
+#define __COMMON_SEDA_WORK_STEALING_QUEUE_H__
+
+#include <atomic>
+#include <stdint.h>
+#include <type_traits>
+#include <vector>
+
+namespace common {
+
+/**
+ * A lock-free work stealing deque (Chase-Lev)
+ * The owner thread pushes and pops items at the bottom end, other threads
+ * steal items from the top end.  Only the owner may call push() and pop();
+ * steal(), empty() and size() may be called from any thread.
+ * <p>
+ * The buffer grows when it is full.  Old buffers may still be read by
+ * concurrent thieves, so they are kept until the queue is destroyed.
+ */
+template <typename T>
+class WorkStealingQueue {
+  static_assert(std::is_pointer<T>::value, "items of work stealing queue must be pointers");
+
+public:
+  explicit WorkStealingQueue(int64_t capacity = 256) : top_(0), bottom_(0)
+  {
+    int64_t real_capacity = 1;
+    while (real_capacity < capacity) {
+      real_capacity <<= 1;
+    }
+    array_.store(new Array(real_capacity), std::memory_order_relaxed);
+  }
+
+  ~WorkStealingQueue()
+  {
+    for (Array *array : garbage_) {
+      delete array;
+    }
+    delete array_.load(std::memory_order_relaxed);
+  }
+
+  WorkStealingQueue(const WorkStealingQueue &) = delete;
+  WorkStealingQueue &operator=(const WorkStealingQueue &) = delete;
+
+  /**
+   * Push an item at the bottom. Owner only.
+   */
+  void push(T item)
+  {
+    int64_t b = bottom_.load(std::memory_order_relaxed);
+    int64_t t = top_.load(std::memory_order_acquire);
+    Array *array = array_.load(std::memory_order_relaxed);
+    if (b - t > array->capacity - 1) {
+      array = grow(array, b, t);
+    }
+    array->put(b, item);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(b + 1, std::memory_order_relaxed);
+  }
+
+  /**
+   * Pop the item pushed most recently. Owner only.
+   * @return nullptr if the queue is empty
+   */
+  T pop()
+  {
+    int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+    Array *array = array_.load(std::memory_order_relaxed);
+    bottom_.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top_.load(std::memory_order_relaxed);
+
+    if (t > b) {
+      bottom_.store(b + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+
+    T item = array->get(b);
+    if (t == b) {
+      // the last item, race with thieves
+      if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        item = nullptr;
+      }
+      bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+    return item;
+  }
+
+  /**
+   * Steal the oldest item. Any thread.
+   * @return nullptr if the queue is empty or another thread won the race,
+   *         the caller can check empty() to decide whether to retry
+   */
+  T steal()
+  {
+    int64_t t = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = bottom_.load(std::memory_order_acquire);
+    if (t >= b) {
+      return nullptr;
+    }
+
+    Array *array = array_.load(std::memory_order_acquire);
+    T item = array->get(t);
+    if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+      return nullptr;
+    }
+    return item;
+  }
+
+  int64_t size() const
+  {
+    int64_t b = bottom_.load(std::memory_order_relaxed);
+    int64_t t = top_.load(std::memory_order_relaxed);
+    return b > t ? b - t : 0;
+  }
+
+  bool empty() const
+  {
+    return size() == 0;
+  }
+
+private:
+  struct Array {
+    explicit Array(int64_t cap) : capacity(cap), mask(cap - 1), items(new std::atomic<T>[cap])
+    {}
+    ~Array()
+    {
+      delete[] items;
+    }
+
+    T get(int64_t index) const
+    {
+      return items[index & mask].load(std::memory_order_relaxed);
+    }
+    void put(int64_t index, T item)
+    {
+      items[index & mask].store(item, std::memory_order_relaxed);
+    }
+
+    int64_t capacity;
+    int64_t mask;
+    std::atomic<T> *items;
+  };
+
+  Array *grow(Array *old_array, int64_t bottom, int64_t top)
+  {
+    Array *new_array = new Array(old_array->capacity * 2);
+    for (int64_t i = top; i < bottom; i++) {
+      new_array->put(i, old_array->get(i));
+    }
+    garbage_.push_back(old_array);
+    array_.store(new_array, std::memory_order_release);
+    return new_array;
+  }
+
+private:
+  alignas(64) std::atomic<int64_t> top_;
+  alignas(64) std::atomic<int64_t> bottom_;
+  std::atomic<Array *> array_;
+  std::vector<Array *> garbage_;  //< replaced buffers, only touched by owner
+};
+
+}  // namespace common
+#endif  // __COMMON_SEDA_WORK_STEALING_QUEUE_H__
@@ -17,6 +17,7 @@ See the Mulan PSL v2 for more details. */
 class BufferPoolManager;
 class DefaultHandler;
 class TrxKit;
+class MvccVacuum;
 
 /**
  * @brief 放一些全局对象
@@ -27,6 +28,7 @@ struct GlobalContext
   BufferPoolManager *buffer_pool_manager_ = nullptr;
   DefaultHandler *handler_ = nullptr;
   TrxKit *trx_kit_ = nullptr;
+  MvccVacuum *vacuum_ = nullptr;  ///< 多版本数据的垃圾回收，只有使用MVCC时才有
 
   static GlobalContext &instance();
 };
@@ -21,6 +21,8 @@ See the Mulan PSL v2 for more details. */
 #define MAX_CONNECTION_NUM_DEFAULT 8192
 #define PORT "PORT"
 #define PORT_DEFAULT 6789
+#define REACTOR_NUM "REACTOR_NUM"
+#define REACTOR_NUM_DEFAULT 1
 
 #define SOCKET_BUFFER_SIZE 8192
 
@@ -18,11 +18,13 @@ See the Mulan PSL v2 for more details. */
 #include "common/conf/ini.h"
 #include "common/lang/string.h"
 #include "common/log/log.h"
+#include "common/os/os.h"
 #include "common/os/path.h"
 #include "common/os/pidfile.h"
 #include "common/os/process.h"
 #include "common/os/signal.h"
 #include "common/seda/init.h"
+#include "common/seda/seda_defs.h"
 #include "common/seda/stage_factory.h"
 #include "session/session.h"
 #include "session/session_stage.h"
@@ -35,6 +37,8 @@ See the Mulan PSL v2 for more details. */
 #include "storage/buffer/disk_buffer_pool.h"
 #include "storage/default/default_handler.h"
 #include "storage/trx/trx.h"
+#include "storage/trx/mvcc_trx.h"
+#include "storage/trx/mvcc_vacuum.h"
 #include "global_context.h"
 
 using namespace common;
@@ -151,9 +155,75 @@ int prepare_init_seda()
   return 0;
 }
 
+bool parse_memory_size(const std::string &str, int64_t &size)
+{
+  char   *end   = nullptr;
+  errno         = 0;
+  int64_t value = strtoll(str.c_str(), &end, 10);
+  if (end == str.c_str() || value < 0 || errno == ERANGE) {
+    return false;
+  }
+
+  int shift = 0;
+  switch (toupper(*end)) {
+    case 'T': shift = 40; break;
+    case 'G': shift = 30; break;
+    case 'M': shift = 20; break;
+    case 'K': shift = 10; break;
+    default: break;
+  }
+  if (shift > 0) {
+    end++;
+  }
+  if (toupper(*end) == 'B') {
+    end++;
+  }
+  if (*end != '\0' || value > (INT64_MAX >> shift)) {
+    return false;
+  }
+  size = value << shift;
+  return true;
+}
+
+/**
+ * @brief 执行 SQL 的线程个数，与 SedaConfig 创建 SessionStage 线程池的规则相同
+ * @details 全局对象在 seda 之前初始化，所以直接从配置中读取
+ */
+static int session_thread_num(Ini &properties)
+{
+  std::string thread_pool = properties.get(THREAD_POOL_ID, DEFAULT_THREAD_POOL, "SessionStage");
+  if (thread_pool.empty()) {
+    thread_pool = DEFAULT_THREAD_POOL;
+  }
+
+  const int cpu_num = static_cast<int>(getCpuNum());
+  int thread_num = cpu_num;
+  std::string count_str = properties.get(COUNT, "", thread_pool);
+  if (!count_str.empty()) {
+    str_to_val(count_str, thread_num);
+  }
+  if (thread_num < 1) {
+    thread_num = cpu_num;
+  }
+  return thread_num;
+}
+
 int init_global_objects(ProcessParam *process_param, Ini &properties)
 {
-  GCTX.buffer_pool_manager_ = new BufferPoolManager();
+  int64_t buffer_pool_size = 0;
+  bool    lock_memory      = false;
+  std::map<std::string, std::string> storage_section = properties.get("STORAGE");
+  auto it = storage_section.find("BUFFER_POOL_SIZE");
+  if (it != storage_section.end() && !parse_memory_size(it->second, buffer_pool_size)) {
+    LOG_ERROR("invalid buffer pool size: %s", it->second.c_str());
+    return -1;
+  }
+  it = storage_section.find("BUFFER_POOL_LOCK_MEMORY");
+  if (it != storage_section.end()) {
+    lock_memory = (it->second == "true");
+  }
+
+  GCTX.buffer_pool_manager_ = new BufferPoolManager(buffer_pool_size, lock_memory);
   BufferPoolManager::set_instance(GCTX.buffer_pool_manager_);
 
   GCTX.handler_ = new DefaultHandler();
@@ -173,11 +243,47 @@ int init_global_objects(ProcessParam *process_param, Ini &properties)
     LOG_ERROR("failed to init handler. rc=%s", strrc(rc));
     return -1;
   }
+
+  MvccTrxKit *mvcc_trx_kit = dynamic_cast<MvccTrxKit *>(GCTX.trx_kit_);
+  if (mvcc_trx_kit != nullptr) {
+    int interval_ms = 1000;
+    int io_budget   = 128;
+    std::map<std::string, std::string> vacuum_section = properties.get("VACUUM");
+    it = vacuum_section.find("INTERVAL_MS");
+    if (it != vacuum_section.end()) {
+      str_to_val(it->second, interval_ms);
+    }
+    it = vacuum_section.find("IO_BUDGET");
+    if (it != vacuum_section.end()) {
+      str_to_val(it->second, io_budget);
+    }
+
+    int lock_wait_timeout_ms = LockManager::DEFAULT_WAIT_TIMEOUT_MS;
+    std::map<std::string, std::string> trx_section = properties.get("TRANSACTION");
+    it = trx_section.find("LOCK_WAIT_TIMEOUT_MS");
+    if (it != trx_section.end()) {
+      str_to_val(it->second, lock_wait_timeout_ms);
+    }
+    mvcc_trx_kit->lock_manager().set_wait_timeout_ms(lock_wait_timeout_ms);
+
+    // 至少留一个 SQL 线程不等锁，用来处理持有锁的事务的提交或回滚
+    const int sql_thread_num = session_thread_num(properties);
+    mvcc_trx_kit->lock_manager().set_max_waiters(sql_thread_num - 1);
+
+    GCTX.vacuum_ = new MvccVacuum(*mvcc_trx_kit, *GCTX.handler_);
+    GCTX.vacuum_->start(interval_ms, io_budget);
+  }
   return ret;
 }
 
 int uninit_global_objects()
 {
+  if (GCTX.vacuum_ != nullptr) {
+    GCTX.vacuum_->stop();
+    delete GCTX.vacuum_;
+    GCTX.vacuum_ = nullptr;
+  }
+
   // TODO use global context
   DefaultHandler *default_handler = &DefaultHandler::get_default();
   if (default_handler != nullptr) {
@@ -14,8 +14,17 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <stdint.h>
+#include <string>
+
 #include "common/os/process_param.h"
 #include "common/conf/ini.h"
 
 int init(common::ProcessParam *processParam);
 void cleanup();
+
+/**
+ * @brief 解析配置中的内存大小，可以带单位 K/M/G/T，后面还可以再跟一个 B，比如 512M、8GB
+ * @details 数值不能是负数，也不能超过 int64_t 的范围，否则返回 false
+ */
+bool parse_memory_size(const std::string &str, int64_t &size);
@@ -29,8 +29,7 @@ SQLStageEvent::~SQLStageEvent() noexcept
     session_event_ = nullptr;
   }
 
-  if (stmt_ != nullptr) {
-    delete stmt_;
-    stmt_ = nullptr;
-  }
+  // 语法树和 stmt 都分配在 arena_ 中，随 arena_ 一起析构
+  sql_node_ = nullptr;
+  stmt_ = nullptr;
 }
@@ -16,6 +16,7 @@ See the Mulan PSL v2 for more details. */
 
 #include <string>
 #include <memory>
+#include "common/mm/arena.h"
 #include "common/seda/stage_event.h"
 #include "sql/operator/physical_operator.h"
 
@@ -41,7 +42,15 @@ public:
   {
     return sql_;
   }
-  const std::unique_ptr<ParsedSqlNode> &sql_node() const
+  common::Arena &arena()
+  {
+    return arena_;
+  }
+  const std::string &digest_text() const
+  {
+    return digest_text_;
+  }
+  ParsedSqlNode *sql_node() const
   {
     return sql_node_;
   }
@@ -62,9 +71,13 @@ public:
   {
     sql_ = sql;
   }
-  void set_sql_node(std::unique_ptr<ParsedSqlNode> sql_node)
+  void set_digest_text(std::string digest_text)
+  {
+    digest_text_ = std::move(digest_text);
+  }
+  void set_sql_node(ParsedSqlNode *sql_node)
   {
-    sql_node_ = std::move(sql_node);
+    sql_node_ = sql_node;
   }
   void set_stmt(Stmt *stmt)
   {
@@ -78,7 +91,9 @@ public:
 private:
   SessionEvent *session_event_ = nullptr;
   std::string sql_;  ///< 处理的SQL语句
-  std::unique_ptr<ParsedSqlNode> sql_node_;  ///< 语法解析后的SQL命令
-  Stmt *stmt_ = nullptr;  ///< Resolver之后生成的数据结构
+  common::Arena arena_;  ///< 处理这条语句时使用的临时内存，语法树和Stmt都在这里分配，随事件一起释放
+  std::string digest_text_;  ///< 语句的摘要文本，参考 StatementDigests
+  ParsedSqlNode *sql_node_ = nullptr;  ///< 语法解析后的SQL命令，分配在 arena_ 中
+  Stmt *stmt_ = nullptr;  ///< Resolver之后生成的数据结构，分配在 arena_ 中
   std::unique_ptr<PhysicalOperator> operator_; ///< 生成的执行计划，也可能没有
 };
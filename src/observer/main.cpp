@@ -21,6 +21,7 @@ See the Mulan PSL v2 for more details. */
 
 #include "common/init.h"
 #include "common/ini_setting.h"
+#include "common/os/os.h"
 #include "common/os/process.h"
 #include "common/os/signal.h"
 #include "common/lang/string.h"
@@ -101,6 +102,7 @@ Server *init_server()
   long listen_addr = INADDR_ANY;
   long max_connection_num = MAX_CONNECTION_NUM_DEFAULT;
   int port = PORT_DEFAULT;
+  int reactor_num = REACTOR_NUM_DEFAULT;
 
   std::map<std::string, std::string>::iterator it = net_section.find(CLIENT_ADDRESS);
   if (it != net_section.end()) {
@@ -125,10 +127,20 @@ Server *init_server()
     }
   }
 
+  it = net_section.find(REACTOR_NUM);
+  if (it != net_section.end()) {
+    std::string str = it->second;
+    str_to_val(str, reactor_num);
+    if (reactor_num <= 0) {
+      reactor_num = getCpuNum();
+    }
+  }
+
   ServerParam server_param;
   server_param.listen_addr = listen_addr;
   server_param.max_connection_num = max_connection_num;
   server_param.port = port;
+  server_param.reactor_num = reactor_num;
   if (0 == strcasecmp(process_param->get_protocol().c_str(), "mysql")) {
     server_param.protocol = CommunicateProtocol::MYSQL;
   } else if (0 == strcasecmp(process_param->get_protocol().c_str(), "cli")) {
@@ -12,6 +12,7 @@ See the Mulan PSL v2 for more details. */
 // Created by Wangyunlai on 2023/06/16.
 //
 
+#include <poll.h>
 #include <sys/errno.h>
 #include <unistd.h>
 #include <algorithm>
@@ -118,7 +119,13 @@ RC BufferedWriter::flush_internal(int32_t size)
     while (tmp_write_size == 0) {
       tmp_write_size = ::write(fd_, buf, read_size);
       if (tmp_write_size < 0) {
-        if (errno == EAGAIN || errno == EINTR) {
+        if (errno == EAGAIN) {
+          // socket是非阻塞的，发送缓冲区满了就等到可写再继续，不要空转
+          struct pollfd pfd = {fd_, POLLOUT, 0};
+          (void)::poll(&pfd, 1, -1);
+          tmp_write_size = 0;
+          continue;
+        } else if (errno == EINTR) {
           tmp_write_size = 0;
           continue;
         } else {
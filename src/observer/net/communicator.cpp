@@ -17,6 +17,7 @@ See the Mulan PSL v2 for more details. */
 #include "net/plain_communicator.h"
 #include "net/cli_communicator.h"
 #include "net/buffered_writer.h"
+#include "event/session_event.h"
 #include "session/session.h"
 
 #include "common/lang/mutex.h"
@@ -32,6 +33,11 @@ RC Communicator::init(int fd, Session *session, const std::string &addr)
 
 Communicator::~Communicator()
 {
+  for (SessionEvent *event : waiting_requests_) {
+    delete event;
+  }
+  waiting_requests_.clear();
+
   if (fd_ >= 0) {
     close(fd_);
     fd_ = -1;
@@ -47,6 +53,70 @@ Communicator::~Communicator()
   }
 }
 
+bool Communicator::begin_request(SessionEvent *event)
+{
+  std::lock_guard<std::mutex> guard(close_mutex_);
+  pending_requests_++;
+  if (pending_requests_ > 1) {
+    waiting_requests_.push_back(event);
+    return false;
+  }
+  return true;
+}
+
+bool Communicator::end_request(bool need_disconnect, SessionEvent *&next_event)
+{
+  next_event = nullptr;
+
+  std::deque<SessionEvent *> dropped_requests;
+  bool need_close = false;
+  {
+    std::lock_guard<std::mutex> guard(close_mutex_);
+    pending_requests_--;
+    if (need_disconnect) {
+      closing_ = true;
+      // 连接已经不能用了，后面的请求也不用处理了
+      pending_requests_ -= static_cast<int>(waiting_requests_.size());
+      dropped_requests.swap(waiting_requests_);
+    }
+
+    if (!waiting_requests_.empty()) {
+      // 对端关闭了连接(closing_)时，已经收到的请求还是要处理完
+      next_event = waiting_requests_.front();
+      waiting_requests_.pop_front();
+    } else if (closing_ && pending_requests_ <= 0 && !closed_) {
+      closed_ = true;
+      need_close = true;
+    }
+  }
+
+  for (SessionEvent *event : dropped_requests) {
+    delete event;
+  }
+  return need_close;
+}
+
+bool Communicator::has_waiting_requests()
+{
+  std::lock_guard<std::mutex> guard(close_mutex_);
+  return !waiting_requests_.empty();
+}
+
+bool Communicator::mark_closing()
+{
+  std::lock_guard<std::mutex> guard(close_mutex_);
+  if (closed_) {
+    return false;
+  }
+
+  closing_ = true;
+  if (pending_requests_ > 0) {
+    return false;
+  }
+  closed_ = true;
+  return true;
+}
+
 /////////////////////////////////////////////////////////////////////////////////
 
 Communicator *CommunicatorFactory::create(CommunicateProtocol protocol)
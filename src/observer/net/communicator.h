@@ -14,6 +14,8 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <deque>
+#include <mutex>
 #include <string>
 #include <event.h>
 #include "common/rc.h"
@@ -22,6 +24,7 @@ struct ConnectionContext;
 class SessionEvent;
 class Session;
 class BufferedWriter;
+class Reactor;
 
 /**
  * @defgroup Communicator
@@ -36,7 +39,7 @@ class BufferedWriter;
  * @details 在listener接收到一个新的连接(参考 server.cpp::accept), 就创建一个Communicator对象。
  * 并调用init进行初始化。
  * 在server中监听到某个连接有新的消息，就通过Communicator::read_event接收消息。
-
+ * 客户端可以不等待结果连续发送多个请求(pipeline)，同一个连接上的请求按照接收的顺序一个一个处理。
  */
 class Communicator 
 {
@@ -51,9 +54,16 @@ public:
   /**
    * @brief 监听到有新的数据到达，调用此函数进行接收消息
    * 如果需要创建新的任务来处理，那么就创建一个SessionEvent 对象并通过event参数返回。
+   * 返回SUCCESS但是event为空，表示消息还没有接收完整。
    */
   virtual RC read_event(SessionEvent *&event) = 0;
 
+  /**
+   * @brief 是否还有已经接收完整但是没有通过 read_event 返回的消息
+   * @details 一次读取可能收到多个消息，Server 会一直调用 read_event，直到这里返回false
+   */
+  virtual bool has_buffered_message() const { return false; }
+
   /**
    * @brief 在任务处理完成后，通过此接口将结果返回给客户端
    * @param event 任务数据，包括处理的结果
@@ -88,12 +98,65 @@ public:
     return addr_.c_str();
   }
 
+  int fd() const
+  {
+    return fd_;
+  }
+
+  /**
+   * @brief 负责这个连接读事件的Reactor
+   */
+  Reactor *reactor() const
+  {
+    return reactor_;
+  }
+  void set_reactor(Reactor *reactor)
+  {
+    reactor_ = reactor;
+  }
+
+  /**
+   * @brief 连接上的请求交给其它线程处理之前调用
+   * @details 读事件在Reactor线程中处理，而请求在SQL线程中处理，客户端断开连接时，可能还有请求
+   * 没有处理完，这时不能直接释放这个对象，要等到最后一个请求处理完成。
+   * 同一个连接上同时只处理一个请求，如果前面的请求还没有处理完，这个请求就放到等待队列中。
+   * @return 是否需要调用者把请求交给SQL线程处理。返回false时，请求由前一个请求的 end_request 取出
+   */
+  bool begin_request(SessionEvent *event);
+
+  /**
+   * @brief 请求处理完成
+   * @param need_disconnect 处理请求时发现需要断开连接。这时等待队列中的请求会直接丢弃
+   * @param next_event 等待队列中的下一个请求，调用者需要把它交给SQL线程处理
+   * @return 是否需要由调用者关闭这个连接。返回false时，调用者不能再访问这个对象
+   */
+  bool end_request(bool need_disconnect, SessionEvent *&next_event);
+
+  /**
+   * @brief 是否还有请求在等待处理
+   * @details 返回结果时，如果后面还有请求，可以先不刷新缓存，把多个结果合并在一起发送
+   */
+  bool has_waiting_requests();
+
+  /**
+   * @brief 连接上读取消息失败，需要关闭连接
+   * @return 是否可以立即关闭。如果还有请求在处理，返回false，由最后一个请求的 end_request 来关闭
+   */
+  bool mark_closing();
+
 protected:
   Session *session_ = nullptr;
   struct event read_event_;
   std::string addr_;
   BufferedWriter *writer_ = nullptr;
   int fd_ = -1;
+  Reactor *reactor_ = nullptr;
+
+  std::mutex close_mutex_;     ///< 保护下面几个字段
+  int  pending_requests_ = 0;  ///< 正在处理和等待处理的请求个数
+  std::deque<SessionEvent *> waiting_requests_;  ///< 等待前面的请求处理完成的请求
+  bool closing_ = false;       ///< 连接需要关闭
+  bool closed_  = false;       ///< 已经有线程负责关闭这个连接
 };
 
 /**
@@ -12,6 +12,9 @@ See the Mulan PSL v2 for more details. */
 // Created by Wangyunlai on 2023/06/25.
 //
 
+#include <string.h>
+#include <algorithm>
+
 #include "net/plain_communicator.h"
 #include "net/buffered_writer.h"
 #include "sql/expr/tuple.h"
@@ -19,6 +22,7 @@ See the Mulan PSL v2 for more details. */
 #include "session/session.h"
 #include "common/io/io.h"
 #include "common/log/log.h"
+#include "common/lang/string.h"
 
 PlainCommunicator::PlainCommunicator()
 {
@@ -30,66 +34,123 @@ PlainCommunicator::PlainCommunicator()
 
 RC PlainCommunicator::read_event(SessionEvent *&event)
 {
-  RC rc = RC::SUCCESS;
-
   event = nullptr;
 
-  int data_len = 0;
-  int read_len = 0;
-
-  const int max_packet_size = 8192;
-  std::vector<char> buf(max_packet_size);
-
-  // 持续接收消息，直到遇到'\0'。将'\0'遇到的后续数据直接丢弃没有处理，因为目前仅支持一收一发的模式
+  bool received = false;
   while (true) {
-    read_len = ::read(fd_, buf.data() + data_len, max_packet_size - data_len);
-    if (read_len < 0) {
-      if (errno == EAGAIN) {
+    const char *message     = nullptr;
+    int         message_len = 0;
+    if (fetch_message(message, message_len)) {
+      if (common::is_blank(message)) {
         continue;
       }
-      break;
+
+      LOG_INFO("receive command(size=%d): %s", message_len, message);
+      event = new SessionEvent(this);
+      event->set_query(std::string(message, message_len));
+      return RC::SUCCESS;
     }
-    if (read_len == 0) {
-      break;
+
+    if (peer_closed_) {
+      LOG_INFO("The peer has been closed %s", addr());
+      return RC::IOERR_CLOSE;
     }
 
-    if (read_len + data_len > max_packet_size) {
-      data_len += read_len;
-      break;
+    if (recv_end_ - recv_begin_ >= MAX_RECV_BUFFER_SIZE) {
+      LOG_WARN("The length of sql exceeds the limitation %d", MAX_RECV_BUFFER_SIZE);
+      return RC::IOERR_TOO_LONG;
     }
 
-    bool msg_end = false;
-    for (int i = 0; i < read_len; i++) {
-      if (buf[data_len + i] == 0) {
-        data_len += i + 1;
-        msg_end = true;
-        break;
-      }
+    if (received) {
+      // 消息还没有接收完整，等数据到达时再继续
+      return RC::SUCCESS;
     }
 
-    if (msg_end) {
-      break;
+    RC rc = receive_data();
+    if (OB_FAIL(rc)) {
+      return rc;
     }
+    received = true;
+  }
+}
 
-    data_len += read_len;
+bool PlainCommunicator::has_buffered_message() const
+{
+  if (scan_pos_ >= recv_end_) {
+    return false;
   }
+  return memchr(recv_buffer_.data() + scan_pos_, 0, recv_end_ - scan_pos_) != nullptr;
+}
 
-  if (data_len > max_packet_size) {
-    LOG_WARN("The length of sql exceeds the limitation %d", max_packet_size);
-    return RC::IOERR_TOO_LONG;
+bool PlainCommunicator::fetch_message(const char *&message, int &message_len)
+{
+  if (scan_pos_ >= recv_end_) {
+    return false;
   }
-  if (read_len == 0) {
-    LOG_INFO("The peer has been closed %s", addr());
-    return RC::IOERR_CLOSE;
-  } else if (read_len < 0) {
+
+  const char *end = static_cast<const char *>(memchr(recv_buffer_.data() + scan_pos_, 0, recv_end_ - scan_pos_));
+  if (end == nullptr) {
+    scan_pos_ = recv_end_;
+    return false;
+  }
+
+  message     = recv_buffer_.data() + recv_begin_;
+  message_len = static_cast<int>(end - message);
+  recv_begin_ += message_len + 1;
+  scan_pos_ = recv_begin_;
+  if (recv_begin_ == recv_end_) {
+    // 数据都处理完了，下次从缓存开头接收。message 指向的数据在下次接收之前都是有效的
+    recv_begin_ = recv_end_ = scan_pos_ = 0;
+  }
+  return true;
+}
+
+RC PlainCommunicator::receive_data()
+{
+  while (true) {
+    if (static_cast<int>(recv_buffer_.size()) - recv_end_ < INIT_RECV_BUFFER_SIZE / 2) {
+      // 把没有处理的数据移动到缓存开头，空间还不够就扩大缓存
+      if (recv_begin_ > 0) {
+        memmove(recv_buffer_.data(), recv_buffer_.data() + recv_begin_, recv_end_ - recv_begin_);
+        recv_end_ -= recv_begin_;
+        scan_pos_ -= recv_begin_;
+        recv_begin_ = 0;
+      }
+
+      const int buffer_size = static_cast<int>(recv_buffer_.size());
+      if (buffer_size - recv_end_ < INIT_RECV_BUFFER_SIZE / 2 && buffer_size < MAX_RECV_BUFFER_SIZE) {
+        recv_buffer_.resize(std::min(std::max(buffer_size * 2, INIT_RECV_BUFFER_SIZE), MAX_RECV_BUFFER_SIZE));
+      }
+      if (recv_end_ == static_cast<int>(recv_buffer_.size())) {
+        return RC::SUCCESS;
+      }
+    }
+
+    ssize_t read_len = ::read(fd_, recv_buffer_.data() + recv_end_, recv_buffer_.size() - recv_end_);
+    if (read_len > 0) {
+      const bool msg_end = memchr(recv_buffer_.data() + recv_end_, 0, read_len) != nullptr;
+      recv_end_ += static_cast<int>(read_len);
+      if (msg_end) {
+        return RC::SUCCESS;
+      }
+      continue;
+    }
+
+    if (read_len == 0) {
+      peer_closed_ = true;
+      return RC::SUCCESS;
+    }
+
+    if (errno == EINTR) {
+      continue;
+    }
+    if (errno == EAGAIN || errno == EWOULDBLOCK) {
+      return RC::SUCCESS;
+    }
+
     LOG_ERROR("Failed to read socket of %s, %s", addr(), strerror(errno));
     return RC::IOERR_READ;
   }
-
-  LOG_INFO("receive command(size=%d): %s", data_len, buf.data());
-  event = new SessionEvent(this);
-  event->set_query(std::string(buf.data()));
-  return rc;
 }
 
 RC PlainCommunicator::write_state(SessionEvent *event, bool &need_disconnect)
@@ -161,7 +222,11 @@ RC PlainCommunicator::write_result(SessionEvent *event, bool &need_disconnect)
   if (!need_disconnect) {
     (void)write_debug(event, need_disconnect);
   }
-  writer_->flush(); // TODO handle error
+
+  // 后面还有请求的话，结果先留在缓存中，和后面的结果一起发送
+  if (!has_waiting_requests()) {
+    writer_->flush(); // TODO handle error
+  }
   return rc;
 }
 
@@ -21,7 +21,10 @@ See the Mulan PSL v2 for more details. */
 /**
  * @brief 与客户端进行通讯
  * @ingroup Communicator
- * @details 使用简单的文本通讯协议，每个消息使用'\0'结尾
+ * @details 使用简单的文本通讯协议，每个消息使用'\0'结尾。
+ * 每个连接有一个接收缓存，一次读取可能收到多个消息，也可能只收到消息的一部分，没有处理的数据留在缓存中，
+ * 下次继续解析。客户端可以不等待结果就发送后面的消息，结果按照消息的顺序返回，后面还有消息等待处理时，
+ * 结果先放在发送缓存中，一起发送。
  */
 class PlainCommunicator : public Communicator 
 {
@@ -30,9 +33,22 @@ public:
   virtual ~PlainCommunicator() = default;
 
   RC read_event(SessionEvent *&event) override;
+  bool has_buffered_message() const override;
   RC write_result(SessionEvent *event, bool &need_disconnect) override;
 
 private:
+  /**
+   * @brief 从接收缓存中取出一个完整的消息
+   * @return 是否有完整的消息
+   */
+  bool fetch_message(const char *&message, int &message_len);
+
+  /**
+   * @brief 从socket读取数据放到接收缓存中
+   * @details 读到一个完整的消息、没有数据可读(EAGAIN)或者对端关闭了连接时返回，不会等待数据到达
+   */
+  RC receive_data();
+
   RC write_state(SessionEvent *event, bool &need_disconnect);
   RC write_debug(SessionEvent *event, bool &need_disconnect);
   RC write_result_internal(SessionEvent *event, bool &need_disconnect);
@@ -40,4 +56,14 @@ private:
 protected:
   std::vector<char> send_message_delimiter_; ///< 发送消息分隔符
   std::vector<char> debug_message_prefix_; ///< 调试信息前缀
+
+private:
+  static constexpr int INIT_RECV_BUFFER_SIZE = 8192;
+  static constexpr int MAX_RECV_BUFFER_SIZE  = 16 * 1024 * 1024; ///< 单个消息的最大长度
+
+  std::vector<char> recv_buffer_;      ///< 接收缓存
+  int  recv_begin_  = 0;               ///< 缓存中还没有处理的数据的开始位置
+  int  recv_end_    = 0;               ///< 缓存中数据的结束位置
+  int  scan_pos_    = 0;               ///< 在[recv_begin_, scan_pos_)中已经确认没有消息结束符
+  bool peer_closed_ = false;           ///< 对端已经关闭了连接
 };
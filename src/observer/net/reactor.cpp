@@ -0,0 +1,86 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <errno.h>
+#include <string.h>
+#include <event.h>
+
+#include "net/reactor.h"
+#include "common/log/log.h"
+#include "net/communicator.h"
+
+Reactor::Reactor(int index) : index_(index)
+{}
+
+Reactor::~Reactor()
+{
+  stop();
+}
+
+RC Reactor::start()
+{
+  // Server::serve 中已经调用了 evthread_use_pthreads，其它线程向这个event_base添加事件时会唤醒事件循环
+  event_base_ = event_base_new();
+  if (event_base_ == nullptr) {
+    LOG_ERROR("Failed to create event base for reactor %d, %s.", index_, strerror(errno));
+    return RC::INTERNAL;
+  }
+
+  thread_ = std::thread(&Reactor::thread_func, this);
+  return RC::SUCCESS;
+}
+
+void Reactor::stop()
+{
+  if (event_base_ == nullptr) {
+    return;
+  }
+
+  event_base_loopexit(event_base_, nullptr);
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+
+  event_base_free(event_base_);
+  event_base_ = nullptr;
+}
+
+RC Reactor::add(Communicator *communicator, void (*recv_callback)(int, short, void *))
+{
+  struct event &read_event = communicator->read_event();
+  event_set(&read_event, communicator->fd(), EV_READ | EV_PERSIST, recv_callback, communicator);
+
+  int ret = event_base_set(event_base_, &read_event);
+  if (ret < 0) {
+    LOG_ERROR("Failed to do event_base_set for read event of %s into reactor %d, %s", 
+              communicator->addr(), index_, strerror(errno));
+    return RC::INTERNAL;
+  }
+
+  ret = event_add(&read_event, nullptr);
+  if (ret < 0) {
+    LOG_ERROR("Failed to event_add for read event of %s into reactor %d, %s", 
+              communicator->addr(), index_, strerror(errno));
+    return RC::INTERNAL;
+  }
+
+  communicator->set_reactor(this);
+  connection_count_++;
+  return RC::SUCCESS;
+}
+
+void Reactor::thread_func()
+{
+  LOG_INFO("reactor %d started", index_);
+
+  // 刚启动时还没有连接，事件循环也不能退出
+  event_base_loop(event_base_, EVLOOP_NO_EXIT_ON_EMPTY);
+  LOG_INFO("reactor %d quit", index_);
+}
@@ -0,0 +1,57 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <atomic>
+#include <thread>
+
+#include "common/rc.h"
+
+struct event_base;
+class Communicator;
+
+/**
+ * @brief 一个事件循环线程
+ * @ingroup Communicator
+ * @details 每个Reactor有自己的libevent对象和线程，负责一部分客户端连接上的读事件。
+ * 连接上收到消息后，在Reactor线程中完成消息的接收和解码，再交给SessionStage处理。
+ * 参考 Server。
+ */
+class Reactor
+{
+public:
+  Reactor(int index);
+  ~Reactor();
+
+  RC   start();
+  void stop();
+
+  /**
+   * @brief 让当前Reactor负责这个连接上的读事件
+   * @details 可以在其它线程中调用
+   * @param recv_callback 连接上有消息到达时的回调函数，参数是Communicator对象
+   */
+  RC add(Communicator *communicator, void (*recv_callback)(int, short, void *));
+
+  int  index() const { return index_; }
+  int  connection_count() const { return connection_count_.load(); }
+  void on_connection_closed() { connection_count_--; }
+
+private:
+  void thread_func();
+
+private:
+  int                index_      = 0;
+  struct event_base *event_base_ = nullptr;
+  std::thread        thread_;
+
+  std::atomic<int> connection_count_{0};  ///< 当前负责的连接数，只是用来观察负载
+};
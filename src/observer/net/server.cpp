@@ -26,6 +26,7 @@ See the Mulan PSL v2 for more details. */
 #include <sys/types.h>
 #include <sys/un.h>
 #include <unistd.h>
+#include <algorithm>
 #include <event2/thread.h>
 
 #include "common/lang/mutex.h"
@@ -36,6 +37,7 @@ See the Mulan PSL v2 for more details. */
 #include "session/session.h"
 #include "common/ini_setting.h"
 #include "net/communicator.h"
+#include "net/reactor.h"
 
 using namespace common;
 
@@ -84,6 +86,9 @@ void Server::close_connection(Communicator *communicator)
 {
   LOG_INFO("Close connection of %s.", communicator->addr());
   event_del(&communicator->read_event());
+  if (communicator->reactor() != nullptr) {
+    communicator->reactor()->on_connection_closed();
+  }
   delete communicator;
 }
 
@@ -91,18 +96,29 @@ void Server::recv(int fd, short ev, void *arg)
 {
   Communicator *comm = (Communicator *)arg;
 
-  SessionEvent *event = nullptr;
-  RC rc = comm->read_event(event);
-  if (rc != RC::SUCCESS) {
-    close_connection(comm);
-    return;
-  }
+  // 一次可能收到多个请求，按照顺序交给连接，同一个连接上的请求会一个一个处理
+  do {
+    SessionEvent *event = nullptr;
+    RC rc = comm->read_event(event);
+    if (rc != RC::SUCCESS) {
+      if (comm->mark_closing()) {
+        close_connection(comm);
+      } else {
+        // 还有请求在处理，不再监听这个连接，等请求处理完成后再关闭
+        event_del(&comm->read_event());
+      }
+      return;
+    }
 
-  if (event == nullptr) {
-    LOG_WARN("event is null while read event return success");
-    return;
-  }
-  session_stage_->add_event(event);
+    if (event == nullptr) {
+      // 消息还没有接收完整
+      return;
+    }
+
+    if (comm->begin_request(event)) {
+      session_stage_->add_event(event);
+    }
+  } while (comm->has_buffered_message());
 }
 
 void Server::accept(int fd, short ev, void *arg)
@@ -155,37 +171,62 @@ void Server::accept(int fd, short ev, void *arg)
     return;
   }
 
-  event_set(&communicator->read_event(), client_fd, EV_READ | EV_PERSIST, recv, communicator);
-
-  ret = event_base_set(instance->event_base_, &communicator->read_event());
-  if (ret < 0) {
-    LOG_ERROR("Failed to do event_base_set for read event of %s into libevent, %s", 
-              communicator->addr(), strerror(errno));
-    delete communicator;
-    return;
-  }
+  Reactor *reactor = instance->reactors_[instance->next_reactor_].get();
+  instance->next_reactor_ = (instance->next_reactor_ + 1) % instance->reactors_.size();
 
-  ret = event_add(&communicator->read_event(), nullptr);
-  if (ret < 0) {
-    LOG_ERROR("Failed to event_add for read event of %s into libevent, %s", communicator->addr(), strerror(errno));
+  rc = reactor->add(communicator, recv);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to add connection into reactor. addr=%s, reactor=%d, rc=%s", 
+             communicator->addr(), reactor->index(), strrc(rc));
     delete communicator;
     return;
   }
 
-  LOG_INFO("Accepted connection from %s\n", communicator->addr());
+  LOG_INFO("Accepted connection from %s, reactor=%d, connections of reactor=%d\n", 
+           communicator->addr(), reactor->index(), reactor->connection_count());
 }
 
 int Server::start()
 {
   if (server_param_.use_std_io) {
     return start_stdin_server();
-  } else if (server_param_.use_unix_socket) {
+  }
+
+  int ret = start_reactors();
+  if (ret != 0) {
+    return ret;
+  }
+
+  if (server_param_.use_unix_socket) {
     return start_unix_socket_server();
   } else {
     return start_tcp_server();
   }
 }
 
+int Server::start_reactors()
+{
+  const int reactor_num = std::max(server_param_.reactor_num, 1);
+  for (int i = 0; i < reactor_num; i++) {
+    reactors_.emplace_back(new Reactor(i));
+    RC rc = reactors_.back()->start();
+    if (OB_FAIL(rc)) {
+      LOG_ERROR("failed to start reactor. index=%d, rc=%s", i, strrc(rc));
+      return -1;
+    }
+  }
+  LOG_INFO("start %d reactors", reactor_num);
+  return 0;
+}
+
+void Server::stop_reactors()
+{
+  for (std::unique_ptr<Reactor> &reactor : reactors_) {
+    reactor->stop();
+  }
+  reactors_.clear();
+}
+
 int Server::start_tcp_server()
 {
   int ret = 0;
@@ -332,6 +373,7 @@ int Server::start_stdin_server()
     }
 
     /// 在当前线程立即处理对应的事件
+    communicator->begin_request(event);
     session_stage_->handle_event(event);
   }
 
@@ -365,6 +407,8 @@ int Server::serve()
     listen_ev_ = nullptr;
   }
 
+  stop_reactors();
+
   if (event_base_ != nullptr) {
     event_base_free(event_base_);
     event_base_ = nullptr;
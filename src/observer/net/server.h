@@ -14,17 +14,23 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <memory>
+#include <vector>
+
 #include "common/defs.h"
 #include "common/seda/stage.h"
 #include "net/server_param.h"
 
 class Communicator;
+class Reactor;
 
 /**
  * @brief 负责接收客户端消息并创建任务
  * @ingroup Communicator
  * @details 当前支持网络连接，有TCP和Unix Socket两种方式。通过命令行参数来指定使用哪种方式。
  * 启动后监听端口或unix socket，使用libevent来监听事件，当有新的连接到达时，创建一个Communicator对象进行处理。
+ * 监听套接字在调用 serve 的线程上处理，新的连接按照轮转的方式交给某个 Reactor，之后这个连接上
+ * 消息的接收和解码都在这个Reactor线程上进行，这样连接数很多时，网络处理不会受限于一个线程。
  */
 class Server 
 {
@@ -80,6 +86,12 @@ private:
 
   int start_stdin_server();
 
+  /**
+   * @brief 启动所有的Reactor线程
+   */
+  int start_reactors();
+  void stop_reactors();
+
 private:
   volatile bool started_ = false;
 
@@ -87,6 +99,9 @@ private:
   struct event_base *event_base_ = nullptr; ///< libevent对象
   struct event *listen_ev_ = nullptr;  ///< libevent监听套接字事件
 
+  std::vector<std::unique_ptr<Reactor>> reactors_;  ///< 处理客户端连接的事件循环
+  size_t next_reactor_ = 0;  ///< 下一个新连接交给哪个Reactor，只在accept中访问
+
   ServerParam server_param_;  ///< 服务启动参数
 
   CommunicatorFactory communicator_factory_; ///< 通过这个对象创建新的Communicator对象
@@ -37,6 +37,8 @@ public:
 
   int port; ///< 监听的端口号
 
+  int reactor_num = 1;  ///< 处理客户端连接的事件循环线程数
+
   std::string unix_socket_path; ///< unix socket的路径
 
   bool use_std_io = false;  ///< 是否使用标准输入输出作为通信条件
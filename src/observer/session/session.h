@@ -79,6 +79,12 @@ public:
   void set_sql_debug(bool sql_debug) { sql_debug_ = sql_debug; }
   bool sql_debug_on() const { return sql_debug_; }
 
+  /**
+   * @brief 查询的并行度，参考 ParallelPlanner
+   */
+  void set_parallel_degree(int parallel_degree) { parallel_degree_ = parallel_degree; }
+  int  parallel_degree() const { return parallel_degree_; }
+
   /**
    * @brief 将指定会话设置到线程变量中
    * 
@@ -97,4 +103,5 @@ private:
   SessionEvent *current_request_ = nullptr; ///< 当前正在处理的请求
   bool trx_multi_operation_mode_ = false;   ///< 当前事务的模式，是否多语句模式. 单语句模式自动提交
   bool sql_debug_ = false;                  ///< 是否输出SQL调试信息
+  int  parallel_degree_ = 1;                ///< 查询的并行度，1表示不并行
 };
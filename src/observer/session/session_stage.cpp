@@ -15,7 +15,9 @@ See the Mulan PSL v2 for more details. */
 #include "session_stage.h"
 
 #include <string.h>
+#include <chrono>
 #include <string>
+#include <shared_mutex>
 
 #include "common/conf/ini.h"
 #include "common/log/log.h"
@@ -27,6 +29,9 @@ See the Mulan PSL v2 for more details. */
 #include "net/server.h"
 #include "net/communicator.h"
 #include "session/session.h"
+#include "session/statement_digest.h"
+#include "storage/trx/mvcc_vacuum.h"
+#include "common/global_context.h"
 
 using namespace common;
 
@@ -93,25 +98,48 @@ void SessionStage::handle_request(StageEvent *event)
     return;
   }
 
+  Communicator *communicator = sev->get_communicator();
+  bool need_disconnect = false;
+
   std::string sql = sev->query();
-  if (common::is_blank(sql.c_str())) {
-    return;
+  if (!common::is_blank(sql.c_str())) {
+    Session::set_current_session(sev->session());
+    sev->session()->set_current_request(sev);
+    SQLStageEvent sql_event(sev, sql);
+
+    // 结果是在输出的时候才计算出来的，所以输出结果也在语句执行的范围内
+    std::shared_lock<std::shared_mutex> vacuum_guard;
+    if (GCTX.vacuum_ != nullptr) {
+      vacuum_guard = std::shared_lock<std::shared_mutex>(GCTX.vacuum_->statement_gate());
+    }
+
+    const StatementCounters start_counters = StatementCounters::current();
+    const auto              start_time     = std::chrono::steady_clock::now();
+
+    (void)handle_sql(&sql_event);
+
+    RC rc = communicator->write_result(sev, need_disconnect);
+    LOG_INFO("write result return %s", strrc(rc));
+
+    if (!sql_event.digest_text().empty()) {
+      const auto latency = std::chrono::steady_clock::now() - start_time;
+      StatementDigests::instance().record(sql_event.digest_text(),
+          std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count(),
+          StatementCounters::current() - start_counters);
+    }
+    sev->session()->set_current_request(nullptr);
+    Session::set_current_session(nullptr);
   }
 
-  Session::set_current_session(sev->session());
-  sev->session()->set_current_request(sev);
-  SQLStageEvent sql_event(sev, sql);
-  (void)handle_sql(&sql_event);
-
-  Communicator *communicator = sev->get_communicator();
-  bool need_disconnect = false;
-  RC rc = communicator->write_result(sev, need_disconnect);
-  LOG_INFO("write result return %s", strrc(rc));
-  if (need_disconnect) {
+  // 同一个连接上的下一个请求要等当前请求处理完才能开始
+  // 客户端可能已经断开了连接，由最后一个处理完的请求来关闭
+  SessionEvent *next_event = nullptr;
+  if (communicator->end_request(need_disconnect, next_event)) {
     Server::close_connection(communicator);
   }
-  sev->session()->set_current_request(nullptr);
-  Session::set_current_session(nullptr);
+  if (next_event != nullptr) {
+    add_event(next_event);
+  }
 }
 
 /**
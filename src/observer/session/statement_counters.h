@@ -0,0 +1,46 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief 当前线程上执行语句时消耗的资源
+ * @details 每个线程一份，只会被当前线程修改，所以不需要原子操作。存储层访问页面、写日志、
+ * 扫描记录时累加，SessionStage 在语句开始和结束时各取一次，差值就是这条语句的消耗，参考 StatementDigests。
+ * 并行扫描时工作线程上的消耗不会算到语句上。
+ */
+struct StatementCounters
+{
+  int64_t rows_examined = 0;  ///< 扫描过的记录数，包括不满足条件的
+  int64_t rows_returned = 0;  ///< 返回给客户端的行数
+  int64_t buffer_hits   = 0;  ///< 在 buffer pool 中找到的页面数
+  int64_t buffer_misses = 0;  ///< 需要从磁盘加载的页面数
+  int64_t log_bytes     = 0;  ///< 写入的日志字节数
+
+  static StatementCounters &current() { return current_; }
+
+  StatementCounters operator-(const StatementCounters &other) const
+  {
+    StatementCounters result;
+    result.rows_examined = rows_examined - other.rows_examined;
+    result.rows_returned = rows_returned - other.rows_returned;
+    result.buffer_hits   = buffer_hits - other.buffer_hits;
+    result.buffer_misses = buffer_misses - other.buffer_misses;
+    result.log_bytes     = log_bytes - other.log_bytes;
+    return result;
+  }
+
+private:
+  static thread_local StatementCounters current_;
+};
+
+inline thread_local StatementCounters StatementCounters::current_;
@@ -0,0 +1,198 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <bit>
+#include <mutex>
+
+#include "session/statement_digest.h"
+
+using namespace std;
+
+static void atomic_min(atomic<int64_t> &target, int64_t value)
+{
+  int64_t current = target.load(memory_order_relaxed);
+  while (value < current && !target.compare_exchange_weak(current, value, memory_order_relaxed)) {
+  }
+}
+
+static void atomic_max(atomic<int64_t> &target, int64_t value)
+{
+  int64_t current = target.load(memory_order_relaxed);
+  while (value > current && !target.compare_exchange_weak(current, value, memory_order_relaxed)) {
+  }
+}
+
+/**
+ * @brief 当前线程使用的条带，线程第一次记录时按照轮转的方式分配
+ */
+static int current_stripe()
+{
+  static atomic<int>      next_stripe{0};
+  static thread_local int stripe = next_stripe.fetch_add(1, memory_order_relaxed) % StatementDigestStats::STRIPE_NUM;
+  return stripe;
+}
+
+int StatementDigestStats::latency_bucket(int64_t latency_ns)
+{
+  if (latency_ns < SUB_BUCKET_NUM) {
+    return static_cast<int>(max(latency_ns, int64_t(0)));
+  }
+
+  // 最高位的位置决定在哪个2的幂区间，接下来的 SUB_BUCKET_BITS 位决定区间内的哪个桶
+  const int exponent = bit_width(static_cast<uint64_t>(latency_ns)) - 1;
+  const int bucket   = exponent * SUB_BUCKET_NUM +
+                     static_cast<int>((latency_ns >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKET_NUM - 1));
+  return min(bucket, LATENCY_BUCKET_NUM - 1);
+}
+
+int64_t StatementDigestStats::bucket_upper_bound(int bucket)
+{
+  if (bucket < SUB_BUCKET_NUM) {
+    return bucket;
+  }
+
+  const int exponent = bucket / SUB_BUCKET_NUM;
+  const int sub      = bucket % SUB_BUCKET_NUM;
+  return (int64_t(SUB_BUCKET_NUM + sub + 1) << (exponent - SUB_BUCKET_BITS)) - 1;
+}
+
+void StatementDigestStats::record(int64_t latency_ns, const StatementCounters &counters)
+{
+  Stripe &stripe = stripes_[current_stripe()];
+  stripe.exec_count.fetch_add(1, memory_order_relaxed);
+  stripe.total_latency_ns.fetch_add(latency_ns, memory_order_relaxed);
+  atomic_min(stripe.min_latency_ns, latency_ns);
+  atomic_max(stripe.max_latency_ns, latency_ns);
+  stripe.rows_examined.fetch_add(counters.rows_examined, memory_order_relaxed);
+  stripe.rows_returned.fetch_add(counters.rows_returned, memory_order_relaxed);
+  stripe.buffer_hits.fetch_add(counters.buffer_hits, memory_order_relaxed);
+  stripe.buffer_misses.fetch_add(counters.buffer_misses, memory_order_relaxed);
+  stripe.log_bytes.fetch_add(counters.log_bytes, memory_order_relaxed);
+  stripe.latency_buckets[latency_bucket(latency_ns)].fetch_add(1, memory_order_relaxed);
+}
+
+StatementDigestStats::Snapshot StatementDigestStats::snapshot() const
+{
+  Snapshot snapshot;
+  snapshot.digest      = digest_;
+  snapshot.digest_text = digest_text_;
+  snapshot.min_latency_ns = INT64_MAX;
+
+  int64_t buckets[LATENCY_BUCKET_NUM] = {0};
+  for (const Stripe &stripe : stripes_) {
+    snapshot.exec_count += stripe.exec_count.load(memory_order_relaxed);
+    snapshot.total_latency_ns += stripe.total_latency_ns.load(memory_order_relaxed);
+    snapshot.min_latency_ns = min(snapshot.min_latency_ns, stripe.min_latency_ns.load(memory_order_relaxed));
+    snapshot.max_latency_ns = max(snapshot.max_latency_ns, stripe.max_latency_ns.load(memory_order_relaxed));
+    snapshot.rows_examined += stripe.rows_examined.load(memory_order_relaxed);
+    snapshot.rows_returned += stripe.rows_returned.load(memory_order_relaxed);
+    snapshot.buffer_hits += stripe.buffer_hits.load(memory_order_relaxed);
+    snapshot.buffer_misses += stripe.buffer_misses.load(memory_order_relaxed);
+    snapshot.log_bytes += stripe.log_bytes.load(memory_order_relaxed);
+    for (int i = 0; i < LATENCY_BUCKET_NUM; i++) {
+      buckets[i] += stripe.latency_buckets[i].load(memory_order_relaxed);
+    }
+  }
+
+  if (snapshot.exec_count == 0) {
+    snapshot.min_latency_ns = 0;
+    return snapshot;
+  }
+
+  // 分位数取所在桶的上界，不超过最大值
+  auto percentile = [&](int64_t percent) {
+    const int64_t rank = (snapshot.exec_count * percent + 99) / 100;
+    int64_t       seen = 0;
+    for (int i = 0; i < LATENCY_BUCKET_NUM; i++) {
+      seen += buckets[i];
+      if (seen >= rank) {
+        return min(bucket_upper_bound(i), snapshot.max_latency_ns);
+      }
+    }
+    return snapshot.max_latency_ns;
+  };
+  snapshot.p95_latency_ns = percentile(95);
+  snapshot.p99_latency_ns = percentile(99);
+  return snapshot;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+StatementDigests &StatementDigests::instance()
+{
+  static StatementDigests instance;
+  return instance;
+}
+
+uint64_t StatementDigests::digest_of(string_view digest_text)
+{
+  uint64_t digest = hash<string_view>()(digest_text);
+  return digest == OVERFLOW_DIGEST ? 1 : digest;
+}
+
+bool StatementDigests::record_if_exists(uint64_t digest, int64_t latency_ns, const StatementCounters &counters)
+{
+  Shard &shard = shard_of(digest);
+
+  shared_lock<shared_mutex> guard(shard.lock);
+  auto iter = shard.digests.find(digest);
+  if (iter == shard.digests.end()) {
+    return false;
+  }
+  iter->second->record(latency_ns, counters);
+  return true;
+}
+
+void StatementDigests::record(const string &digest_text, int64_t latency_ns, const StatementCounters &counters)
+{
+  uint64_t digest = digest_of(digest_text);
+  if (record_if_exists(digest, latency_ns, counters)) {
+    return;
+  }
+
+  if (digest_num_.load(memory_order_relaxed) >= MAX_DIGEST_NUM) {
+    digest = OVERFLOW_DIGEST;
+    if (record_if_exists(digest, latency_ns, counters)) {
+      return;
+    }
+  }
+
+  Shard &shard = shard_of(digest);
+
+  unique_lock<shared_mutex> guard(shard.lock);
+  auto [iter, inserted] = shard.digests.try_emplace(digest);
+  if (inserted) {
+    iter->second = make_unique<StatementDigestStats>(digest, digest == OVERFLOW_DIGEST ? string() : digest_text);
+    digest_num_.fetch_add(1, memory_order_relaxed);
+  }
+  iter->second->record(latency_ns, counters);
+}
+
+vector<StatementDigestStats::Snapshot> StatementDigests::snapshot() const
+{
+  vector<StatementDigestStats::Snapshot> snapshots;
+  for (const Shard &shard : shards_) {
+    shared_lock<shared_mutex> guard(shard.lock);
+    for (const auto &[digest, stats] : shard.digests) {
+      snapshots.push_back(stats->snapshot());
+    }
+  }
+  return snapshots;
+}
+
+void StatementDigests::reset()
+{
+  for (Shard &shard : shards_) {
+    unique_lock<shared_mutex> guard(shard.lock);
+    digest_num_.fetch_sub(static_cast<int>(shard.digests.size()), memory_order_relaxed);
+    shard.digests.clear();
+  }
+}
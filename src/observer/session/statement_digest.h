@@ -0,0 +1,133 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "session/statement_counters.h"
+
+/**
+ * @brief 摘要相同的一类语句的累计统计
+ * @details 计数器分成几个条带(stripe)，每个线程固定使用其中一个，减少多个线程执行同一类语句时
+ * 在同一个缓存行上的竞争。计数器都是原子变量，记录时不需要加锁，读取时把所有条带加起来。
+ * 延迟的分布用对数-线性的直方图记录，每个2的幂区间再分成4个桶，估算的分位数误差在25%以内。
+ */
+class StatementDigestStats
+{
+public:
+  static constexpr int STRIPE_NUM         = 4;
+  static constexpr int SUB_BUCKET_BITS    = 2;
+  static constexpr int SUB_BUCKET_NUM     = 1 << SUB_BUCKET_BITS;
+  static constexpr int LATENCY_BUCKET_NUM = 40 * SUB_BUCKET_NUM;  ///< 最大可以区分到 2^40 纳秒，大约18分钟
+
+  /**
+   * @brief 某个时刻的统计值，延迟的单位都是纳秒
+   */
+  struct Snapshot
+  {
+    uint64_t    digest = 0;
+    std::string digest_text;
+    int64_t     exec_count       = 0;
+    int64_t     total_latency_ns = 0;
+    int64_t     min_latency_ns   = 0;
+    int64_t     max_latency_ns   = 0;
+    int64_t     p95_latency_ns   = 0;
+    int64_t     p99_latency_ns   = 0;
+    int64_t     rows_examined    = 0;
+    int64_t     rows_returned    = 0;
+    int64_t     buffer_hits      = 0;
+    int64_t     buffer_misses    = 0;
+    int64_t     log_bytes        = 0;
+  };
+
+public:
+  StatementDigestStats(uint64_t digest, std::string digest_text)
+      : digest_(digest), digest_text_(std::move(digest_text))
+  {}
+
+  void     record(int64_t latency_ns, const StatementCounters &counters);
+  Snapshot snapshot() const;
+
+  static int     latency_bucket(int64_t latency_ns);
+  static int64_t bucket_upper_bound(int bucket);
+
+private:
+  struct alignas(64) Stripe
+  {
+    std::atomic<int64_t>  exec_count{0};
+    std::atomic<int64_t>  total_latency_ns{0};
+    std::atomic<int64_t>  min_latency_ns{INT64_MAX};
+    std::atomic<int64_t>  max_latency_ns{0};
+    std::atomic<int64_t>  rows_examined{0};
+    std::atomic<int64_t>  rows_returned{0};
+    std::atomic<int64_t>  buffer_hits{0};
+    std::atomic<int64_t>  buffer_misses{0};
+    std::atomic<int64_t>  log_bytes{0};
+    std::atomic<uint32_t> latency_buckets[LATENCY_BUCKET_NUM] = {};
+  };
+
+  const uint64_t    digest_;
+  const std::string digest_text_;
+  Stripe            stripes_[STRIPE_NUM];
+};
+
+/**
+ * @brief 按照语句摘要汇总的执行统计
+ * @details 语句的摘要文本由语法解析时生成，常量都替换成了'?'，参考 ParsedSqlResult::digest_text。
+ * 摘要是摘要文本的哈希值，按照摘要分成多个分片，每个分片一把读写锁，已经出现过的语句只需要加读锁，
+ * 然后原子地累加计数器。摘要的个数有上限，达到上限后新出现的语句都算在摘要文本为空的一条统计中。
+ * 统计数据可以通过系统表 statement_digests 查询，通过 RESET statement_digests 清空。
+ */
+class StatementDigests
+{
+public:
+  static constexpr int      SHARD_NUM       = 16;
+  static constexpr int      MAX_DIGEST_NUM  = 1000;
+  static constexpr uint64_t OVERFLOW_DIGEST = 0;  ///< 摘要个数达到上限之后，新的语句都记录在这里
+
+public:
+  static StatementDigests &instance();
+
+  static uint64_t digest_of(std::string_view digest_text);
+
+  /**
+   * @brief 记录一条语句的执行
+   * @param digest_text 语句的摘要文本
+   * @param latency_ns  从开始处理到结果返回给客户端的时间
+   * @param counters    语句执行过程中消耗的资源
+   */
+  void record(const std::string &digest_text, int64_t latency_ns, const StatementCounters &counters);
+
+  std::vector<StatementDigestStats::Snapshot> snapshot() const;
+
+  void reset();
+
+private:
+  struct Shard
+  {
+    mutable std::shared_mutex                                         lock;
+    std::unordered_map<uint64_t, std::unique_ptr<StatementDigestStats>> digests;
+  };
+
+  Shard &shard_of(uint64_t digest) { return shards_[digest % SHARD_NUM]; }
+  bool   record_if_exists(uint64_t digest, int64_t latency_ns, const StatementCounters &counters);
+
+private:
+  Shard            shards_[SHARD_NUM];
+  std::atomic<int> digest_num_{0};
+};
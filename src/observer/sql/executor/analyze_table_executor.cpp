@@ -0,0 +1,51 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "sql/executor/analyze_table_executor.h"
+#include "common/log/log.h"
+#include "event/session_event.h"
+#include "event/sql_event.h"
+#include "session/session.h"
+#include "sql/stmt/analyze_table_stmt.h"
+#include "storage/table/table.h"
+#include "storage/trx/trx.h"
+
+RC AnalyzeTableExecutor::execute(SQLStageEvent *sql_event)
+{
+  Stmt *stmt = sql_event->stmt();
+  Session *session = sql_event->session_event()->session();
+  ASSERT(stmt->type() == StmtType::ANALYZE_TABLE, 
+         "analyze table executor can not run this command: %d", static_cast<int>(stmt->type()));
+
+  AnalyzeTableStmt *analyze_table_stmt = static_cast<AnalyzeTableStmt *>(stmt);
+  Table *table = analyze_table_stmt->table();
+
+  // 只统计对当前事务可见的数据。不在显式事务中时，使用一个只读的事务
+  Trx *trx = session->current_trx();
+  RC rc = trx->start_if_need();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to start trx. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  rc = table->analyze(trx);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to analyze table. table=%s, rc=%s", table->name(), strrc(rc));
+  }
+
+  if (!session->is_trx_multi_operation_mode()) {
+    RC rc2 = trx->commit();
+    if (OB_FAIL(rc2)) {
+      LOG_WARN("failed to commit trx. rc=%s", strrc(rc2));
+      rc = OB_SUCC(rc) ? rc2 : rc;
+    }
+  }
+  return rc;
+}
@@ -34,7 +34,9 @@ RC CreateTableExecutor::execute(SQLStageEvent *sql_event)
   const int attribute_count = static_cast<int>(create_table_stmt->attr_infos().size());
 
   const char *table_name = create_table_stmt->table_name().c_str();
-  RC rc = session->get_current_db()->create_table(table_name, attribute_count, create_table_stmt->attr_infos().data());
+  RC rc = session->get_current_db()->create_table(
+      table_name, attribute_count, create_table_stmt->attr_infos().data(), create_table_stmt->storage_format(),
+      create_table_stmt->page_size());
 
   return rc;
 }
\ No newline at end of file
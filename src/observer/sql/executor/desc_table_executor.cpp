@@ -23,6 +23,7 @@ See the Mulan PSL v2 for more details. */
 #include "storage/table/table.h"
 #include "sql/stmt/desc_table_stmt.h"
 #include "storage/db/db.h"
+#include "storage/table/system_tables.h"
 #include "sql/operator/string_list_physical_operator.h"
 
 using namespace std;
@@ -44,6 +45,9 @@ RC DescTableExecutor::execute(SQLStageEvent *sql_event)
 
   Db *db = session->get_current_db();
   Table *table = db->find_table(table_name);
+  if (table == nullptr) {
+    table = SystemTables::find(table_name);
+  }
   if (table != nullptr) {
 
     TupleSchema tuple_schema;
@@ -57,7 +61,8 @@ RC DescTableExecutor::execute(SQLStageEvent *sql_event)
     const TableMeta &table_meta = table->table_meta();
     for (int i = table_meta.sys_field_num(); i < table_meta.field_num(); i++) {
       const FieldMeta *field_meta = table_meta.field(i);
-      oper->append({field_meta->name(), attr_type_to_string(field_meta->type()), std::to_string(field_meta->len())});
+      const char *type_name = field_meta->var_len() ? "varchars" : attr_type_to_string(field_meta->type());
+      oper->append({field_meta->name(), type_name, std::to_string(field_meta->len())});
     }
 
     sql_result->set_operator(unique_ptr<PhysicalOperator>(oper));
@@ -0,0 +1,27 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "sql/executor/reset_executor.h"
+#include "common/log/log.h"
+#include "event/sql_event.h"
+#include "session/statement_digest.h"
+#include "sql/stmt/reset_stmt.h"
+
+RC ResetExecutor::execute(SQLStageEvent *sql_event)
+{
+  Stmt *stmt = sql_event->stmt();
+  ASSERT(stmt->type() == StmtType::RESET, 
+         "reset executor can not run this command: %d", static_cast<int>(stmt->type()));
+
+  ResetStmt *reset_stmt = static_cast<ResetStmt *>(stmt);
+  StatementDigests::instance().reset();
+  LOG_INFO("%s has been reset", reset_stmt->name().c_str());
+  return RC::SUCCESS;
+}
@@ -21,6 +21,7 @@ See the Mulan PSL v2 for more details. */
 #include "sql/executor/sql_result.h"
 #include "session/session.h"
 #include "sql/stmt/set_variable_stmt.h"
+#include "sql/optimizer/parallel_planner.h"
 
 /**
  * @brief SetVariable语句执行器
@@ -49,6 +50,19 @@ public:
 
       session->set_sql_debug(bool_value);
       LOG_TRACE("set sql_debug to %d", bool_value);
+    } else if (strcasecmp(var_name, "parallel_degree") == 0) {
+      if (var_value.attr_type() != AttrType::INTS || var_value.get_int() < 1 ||
+          var_value.get_int() > ParallelPlanner::MAX_PARALLEL_DEGREE) {
+        return RC::VARIABLE_NOT_VALID;
+      }
+
+      session->set_parallel_degree(var_value.get_int());
+      LOG_TRACE("set parallel_degree to %d", var_value.get_int());
+#ifndef CONCURRENCY
+      if (var_value.get_int() > 1) {
+        LOG_WARN("parallel_degree=%d is ignored because observer is built without CONCURRENCY", var_value.get_int());
+      }
+#endif
     } else {
       rc = RC::VARIABLE_NOT_EXISTS;
     }
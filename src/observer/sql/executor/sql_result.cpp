@@ -15,6 +15,7 @@ See the Mulan PSL v2 for more details. */
 #include "common/rc.h"
 #include "sql/executor/sql_result.h"
 #include "session/session.h"
+#include "session/statement_counters.h"
 #include "storage/trx/trx.h"
 #include "common/log/log.h"
 
@@ -70,6 +71,7 @@ RC SqlResult::next_tuple(Tuple *&tuple)
   }
 
   tuple = operator_->current_tuple();
+  StatementCounters::current().rows_returned++;
   return rc;
 }
 
@@ -21,9 +21,20 @@ using namespace std;
 RC FieldExpr::get_value(const Tuple &tuple, Value &value) const
 {
   DEBUG_PRINT("debug: FieldExpr: get_value\n");
+  if (slot_ >= 0) {
+    return tuple.cell_at(slot_, value);
+  }
   return tuple.find_cell(TupleCellSpec(table_name(), field_name()), value);
 }
 
+unique_ptr<Expression> FieldExpr::copy() const
+{
+  auto expr = make_unique<FieldExpr>(field_);
+  expr->set_slot(slot_);
+  expr->set_name(name());
+  return expr;
+}
+
 RC ValueExpr::get_value(const Tuple &tuple, Value &value) const
 {
   DEBUG_PRINT("debug: ValueExpr: get_value\n");
@@ -31,6 +42,13 @@ RC ValueExpr::get_value(const Tuple &tuple, Value &value) const
   return RC::SUCCESS;
 }
 
+unique_ptr<Expression> ValueExpr::copy() const
+{
+  auto expr = make_unique<ValueExpr>(value_);
+  expr->set_name(name());
+  return expr;
+}
+
 /////////////////////////////////////////////////////////////////////////////////
 CastExpr::CastExpr(unique_ptr<Expression> child, AttrType cast_type)
     : child_(std::move(child)), cast_type_(cast_type)
@@ -39,6 +57,13 @@ CastExpr::CastExpr(unique_ptr<Expression> child, AttrType cast_type)
 CastExpr::~CastExpr()
 {}
 
+unique_ptr<Expression> CastExpr::copy() const
+{
+  auto expr = make_unique<CastExpr>(child_->copy(), cast_type_);
+  expr->set_name(name());
+  return expr;
+}
+
 RC CastExpr::cast(const Value &value, Value &cast_value) const
 {
   RC rc = RC::SUCCESS;
@@ -89,6 +114,13 @@ ComparisonExpr::ComparisonExpr(CompOp comp, unique_ptr<Expression> left, unique_
 ComparisonExpr::~ComparisonExpr()
 {}
 
+unique_ptr<Expression> ComparisonExpr::copy() const
+{
+  auto expr = make_unique<ComparisonExpr>(comp_, left_->copy(), right_->copy());
+  expr->set_name(name());
+  return expr;
+}
+
 RC ComparisonExpr::compare_value(const Value &left, const Value &right, bool &result) const
 {
   DEBUG_PRINT("debug: ComparisonExpr: compare_value\n");
@@ -183,6 +215,18 @@ ConjunctionExpr::ConjunctionExpr(Type type, vector<unique_ptr<Expression>> &chil
     : conjunction_type_(type), children_(std::move(children))
 {}
 
+unique_ptr<Expression> ConjunctionExpr::copy() const
+{
+  vector<unique_ptr<Expression>> children;
+  children.reserve(children_.size());
+  for (const unique_ptr<Expression> &child : children_) {
+    children.emplace_back(child->copy());
+  }
+  auto expr = make_unique<ConjunctionExpr>(conjunction_type_, children);
+  expr->set_name(name());
+  return expr;
+}
+
 RC ConjunctionExpr::get_value(const Tuple &tuple, Value &value) const
 {
   DEBUG_PRINT("debug: ConjunctionExpr: get_value\n");
@@ -220,6 +264,13 @@ ArithmeticExpr::ArithmeticExpr(ArithmeticExpr::Type type, unique_ptr<Expression>
     : arithmetic_type_(type), left_(std::move(left)), right_(std::move(right))
 {}
 
+unique_ptr<Expression> ArithmeticExpr::copy() const
+{
+  auto expr = make_unique<ArithmeticExpr>(arithmetic_type_, left_->copy(), right_ ? right_->copy() : nullptr);
+  expr->set_name(name());
+  return expr;
+}
+
 AttrType ArithmeticExpr::value_type() const
 {
   if (!right_) {
@@ -384,6 +435,14 @@ RC AggregationExpr::get_value(const Tuple &tuple, Value &value) const { return R
 
 RC AggregationExpr::try_get_value(Value &value) const { return RC::SUCCESS; }
 
+unique_ptr<Expression> AggregationExpr::copy() const
+{
+  auto expr = make_unique<AggregationExpr>(field_, aggr_type_);
+  expr->field_expr()->set_slot(field_expr_->slot());
+  expr->set_name(name());
+  return expr;
+}
+
 TupleCellSpec AggregationExpr::cell_spec(bool with_table_name) const
 { 
   std::string alias;
@@ -422,6 +481,7 @@ RC AggregationExpr::begin_aggr()
   //value_->set_type(attr_type_);
   i_val_ = 0;
   f_val_ = 0;
+  value_ = Value();
   return RC::SUCCESS; 
 }
 
@@ -463,6 +523,34 @@ RC AggregationExpr::get_result(Value &value)
   return RC::SUCCESS;
 }
 
+RC AggregationExpr::merge(const AggregationExpr &other)
+{
+  switch (aggr_type_) {
+    case MAX_AGGR_T: {
+      if (other.value_.attr_type() != AttrType::UNDEFINED) {
+        Value value = other.value_;
+        max_aggr_func(value);
+      }
+    } break;
+    case MIN_AGGR_T: {
+      if (other.value_.attr_type() != AttrType::UNDEFINED) {
+        Value value = other.value_;
+        min_aggr_func(value);
+      }
+    } break;
+    case COUNT_AGGR_T:
+    case SUM_AGGR_T:
+    case AVG_AGGR_T: {
+      i_val_ += other.i_val_;
+      f_val_ += other.f_val_;
+    } break;
+    default: {
+      return RC::INTERNAL;
+    }
+  }
+  return RC::SUCCESS;
+}
+
 RC AggregationExpr::max_aggr_func(Value &value) 
 { 
   DEBUG_PRINT("debug: max_aggr_func\n");
@@ -98,6 +98,12 @@ public:
   virtual std::string name() const { return name_; }
   virtual void set_name(std::string name) { name_ = name; }
 
+  /**
+   * @brief 复制一个表达式
+   * @details 并行执行时，每个工作线程都需要有自己的一份算子和表达式
+   */
+  virtual std::unique_ptr<Expression> copy() const = 0;
+
 private:
   std::string  name_;
 };
@@ -138,8 +144,19 @@ public:
 
   RC get_value(const Tuple &tuple, Value &value) const override;
 
+  std::unique_ptr<Expression> copy() const override;
+
+  /**
+   * @brief 绑定字段在元组中的位置
+   * @details 生成物理计划之后，SlotBinder 会计算每个字段在计算表达式时使用的元组中的位置，
+   * 之后直接按照位置取值，而不是每一行都按照表名和字段名查找。-1表示没有绑定。
+   */
+  void set_slot(int slot) { slot_ = slot; }
+  int  slot() const { return slot_; }
+
 private:
   Field field_;
+  int   slot_ = -1;
 };
 
 /**
@@ -158,6 +175,8 @@ public:
   RC get_value(const Tuple &tuple, Value &value) const override;
   RC try_get_value(Value &value) const override { value = value_; return RC::SUCCESS; }
 
+  std::unique_ptr<Expression> copy() const override;
+
   ExprType type() const override { return ExprType::VALUE; }
 
   AttrType value_type() const override { return value_.attr_type(); }
@@ -188,6 +207,8 @@ public:
 
   RC try_get_value(Value &value) const override;
 
+  std::unique_ptr<Expression> copy() const override;
+
   AttrType value_type() const override { return cast_type_; }
 
   std::unique_ptr<Expression> &child() { return child_; }
@@ -214,6 +235,8 @@ public:
 
   RC get_value(const Tuple &tuple, Value &value) const override;
 
+  std::unique_ptr<Expression> copy() const override;
+
   AttrType value_type() const override { return BOOLEANS; }
 
   CompOp comp() const { return comp_; }
@@ -263,6 +286,8 @@ public:
 
   RC get_value(const Tuple &tuple, Value &value) const override;
 
+  std::unique_ptr<Expression> copy() const override;
+
   Type conjunction_type() const { return conjunction_type_; }
 
   std::vector<std::unique_ptr<Expression>> &children() { return children_; }
@@ -299,6 +324,8 @@ public:
   RC get_value(const Tuple &tuple, Value &value) const override;
   RC try_get_value(Value &value) const override;
 
+  std::unique_ptr<Expression> copy() const override;
+
   Type arithmetic_type() const { return arithmetic_type_; }
 
   std::unique_ptr<Expression> &left() { return left_; }
@@ -330,7 +357,9 @@ public:
 public:
   RC get_value(const Tuple &tuple, Value &value) const override;
   RC try_get_value(Value &value) const override;
+  std::unique_ptr<Expression> copy() const override;
   const Field &field() const { return field_; }
+  FieldExpr *field_expr() const { return field_expr_; }
   TupleCellSpec cell_spec(bool with_table_name = false) const;
 
 public:
@@ -341,6 +370,8 @@ public:
   RC aggr_tuple(Tuple *&tuple);
   // 获取聚合结果
   RC get_result(Value &value);
+  // 合并另一个聚合的中间结果，用于并行聚合，参考 GatherPhysicalOperator
+  RC merge(const AggregationExpr &other);
 public:
   RC max_aggr_func(Value &value);
   RC min_aggr_func(Value &value);
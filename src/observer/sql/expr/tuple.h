@@ -152,6 +152,12 @@ public:
 
   void set_schema(const Table *table, const std::vector<FieldMeta> *fields)
   {
+    // 算子可能会被多次打开，每次都会设置schema
+    for (FieldExpr *spec : speces_) {
+      delete spec;
+    }
+    speces_.clear();
+
     table_ = table;
     this->speces_.reserve(fields->size());
     for (const FieldMeta &field : *fields) {
@@ -252,7 +258,22 @@ public:
   void add_cell_spec(TupleCellSpec *spec)
   {
     speces_.push_back(spec);
+    slots_.push_back(-1);
+  }
+
+  const TupleCellSpec &cell_spec(int index) const
+  {
+    return *speces_[index];
   }
+
+  /**
+   * @brief 绑定投影的字段在下层元组中的位置，绑定之后不再需要按照名字查找，参考 SlotBinder
+   */
+  void set_slot(int index, int slot)
+  {
+    slots_[index] = slot;
+  }
+
   int cell_num() const override
   {
     return speces_.size();
@@ -267,6 +288,11 @@ public:
       return RC::INTERNAL;
     }
   
+    const int slot = slots_[index];
+    if (slot >= 0) {
+      return tuple_->cell_at(slot, cell);
+    }
+
     const TupleCellSpec *spec = speces_[index];
     return tuple_->find_cell(*spec, cell);
   }
@@ -288,6 +314,7 @@ public:
 #endif
 private:
   std::vector<TupleCellSpec *> speces_;
+  std::vector<int> slots_;  ///< 每个投影字段在下层元组中的位置，-1表示没有绑定
   Tuple *tuple_ = nullptr;
 };
 
@@ -417,7 +444,7 @@ public:
   RC cell_at(int index, Value &value) const override
   {
     const int left_cell_num = left_->cell_num();
-    if (index > 0 && index < left_cell_num) {
+    if (index >= 0 && index < left_cell_num) {
       return left_->cell_at(index, value);
     }
 
@@ -5,6 +5,7 @@
 #include "aggr_physical_operatior.h"
 #include "storage/table/table.h"
 #include "event/sql_debug.h"
+#include "sql/operator/gather_physical_operator.h"
 
 RC AggrPhysicalOperator::open(Trx *trx) 
 { 
@@ -14,6 +15,17 @@ RC AggrPhysicalOperator::open(Trx *trx)
         return RC::INTERNAL;
     }
     RC rc = RC::SUCCESS;
+    // 只有聚合函数时才能把聚合分给多个工作线程
+    parallel_ = children_[0]->type() == PhysicalOperatorType::GATHER;
+    for (Expression* expr: expressions_) {
+        if (expr->type() != ExprType::AGGREGATION) {
+            parallel_ = false;
+        }
+    }
+    if (parallel_) {
+        trx_ = trx;  // 在 next 中执行
+        return rc;
+    }
     for (int i = 0; i < children_.size(); i++) {
         if ((rc = children_[i]->open(trx)) != RC::SUCCESS) {
             return rc;
@@ -31,6 +43,11 @@ RC AggrPhysicalOperator::next()
         return RC::RECORD_EOF;
     }
 
+    if (parallel_) {
+        index_++;
+        return parallel_aggr();
+    }
+
     PhysicalOperator *oper = children_[index_++].get();
     Tuple *tuple = nullptr;
     // ---begin---
@@ -86,10 +103,60 @@ RC AggrPhysicalOperator::next()
     return rc;
 }
 
+RC AggrPhysicalOperator::parallel_aggr()
+{
+    GatherPhysicalOperator *gather = static_cast<GatherPhysicalOperator *>(children_[0].get());
+    const int worker_num = gather->worker_num();
+
+    // 每个工作线程一份聚合表达式，互不干扰
+    std::vector<std::vector<std::unique_ptr<Expression>>> partials(worker_num);
+    for (std::vector<std::unique_ptr<Expression>> &partial : partials) {
+        for (Expression* expr: expressions_) {
+            partial.emplace_back(expr->copy());
+            static_cast<AggregationExpr *>(partial.back().get())->begin_aggr();
+        }
+    }
+
+    RC rc = gather->run_parallel(trx_, [&partials](int worker_index, RowTuple &row) {
+        Tuple *tuple = &row;
+        for (std::unique_ptr<Expression> &expr : partials[worker_index]) {
+            RC rc = static_cast<AggregationExpr *>(expr.get())->aggr_tuple(tuple);
+            if (rc != RC::SUCCESS) {
+                return rc;
+            }
+        }
+        return RC::SUCCESS;
+    });
+    if (rc != RC::SUCCESS) {
+        LOG_WARN("failed to run parallel aggregation. rc=%s", strrc(rc));
+        return rc;
+    }
+
+    std::vector<Value> results;
+    std::vector<TupleCellSpec> speces;
+    for (size_t i = 0; i < expressions_.size(); i++) {
+        AggregationExpr *aggr_expr = static_cast<AggregationExpr *>(expressions_[i]);
+        aggr_expr->begin_aggr();
+        for (std::vector<std::unique_ptr<Expression>> &partial : partials) {
+            aggr_expr->merge(*static_cast<AggregationExpr *>(partial[i].get()));
+        }
+        Value value;
+        aggr_expr->get_result(value);
+        results.emplace_back(value);
+        speces.emplace_back(aggr_expr->cell_spec());
+    }
+    aggred_tuple_.set_cells(results);
+    aggred_tuple_.set_speces(speces);
+    return RC::SUCCESS;
+}
+
 RC AggrPhysicalOperator::close() 
 { 
     DEBUG_PRINT("debug: 过滤算子: close\n");
     RC rc = RC::SUCCESS;
+    if (parallel_) {  // 工作线程已经关闭了扫描算子
+        return rc;
+    }
     for (int i = 0; i < children_.size(); i++) {
         if (children_[i]->close() != RC::SUCCESS) {
             rc = RC::INTERNAL;
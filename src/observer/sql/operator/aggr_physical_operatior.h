@@ -37,9 +37,16 @@ public:
     RC close() override;
 
     Tuple *current_tuple() override;
+
+    std::vector<Expression*> &expressions() { return expressions_; }
+private:
+    // 子算子是并行扫描时，每个工作线程各自做部分聚合，最后再合并
+    RC parallel_aggr();
 private:
     // 聚合
     std::vector<Expression*> expressions_;  // 多个聚合
     int index_ = 0;
     ValueListTuple aggred_tuple_;
+    bool parallel_ = false;  // 是否并行聚合
+    Trx *trx_ = nullptr;
 };
\ No newline at end of file
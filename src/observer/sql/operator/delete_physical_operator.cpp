@@ -34,6 +34,7 @@ RC DeletePhysicalOperator::open(Trx *trx)
   }
 
   trx_ = trx;
+  child_closed_ = false;
 
   return RC::SUCCESS;
 }
@@ -47,6 +48,8 @@ RC DeletePhysicalOperator::next()
     return RC::RECORD_EOF;
   }
   // DEBUG_PRINT("debug: 删除算子: child->next()\n");
+  // 扫描的时候只记录要删除的记录。索引扫描时边扫描边删除索引项，会跳过下一个索引项
+  rids_.clear();
   PhysicalOperator *child = children_[0].get();
   while (RC::SUCCESS == (rc = child->next())) {
     // DEBUG_PRINT("debug: 删除算子: child->current_tuple()\n");
@@ -58,10 +61,29 @@ RC DeletePhysicalOperator::next()
     }
     // DEBUG_PRINT("debug: 删除算子: 获得成功\n");
     RowTuple *row_tuple = static_cast<RowTuple *>(tuple);
-    Record &record = row_tuple->record();
-    rc = trx_->delete_record(table_, record);
+    rids_.push_back(row_tuple->record().rid());
+  }
+
+  if (rc != RC::RECORD_EOF) {
+    LOG_WARN("failed to get next record to delete: %s", strrc(rc));
+    return rc;
+  }
+
+  // 扫描结束之后再删除，扫描器不再持有页面和索引
+  child->close();
+  child_closed_ = true;
+
+  for (const RID &rid : rids_) {
+    // visit_record 返回的是释放页面的结果，删除的结果要单独保存
+    RC delete_rc = RC::SUCCESS;
+    rc = table_->visit_record(rid, false/*readonly*/, [this, &delete_rc](Record &record) {
+      delete_rc = trx_->delete_record(table_, record);
+    });
+    if (rc == RC::SUCCESS) {
+      rc = delete_rc;
+    }
     if (rc != RC::SUCCESS) {
-      LOG_WARN("failed to delete record: %s", strrc(rc));
+      LOG_WARN("failed to delete record. rid=%s, rc=%s", rid.to_string().c_str(), strrc(rc));
       return rc;
     }
   }
@@ -72,8 +94,9 @@ RC DeletePhysicalOperator::next()
 RC DeletePhysicalOperator::close()
 {
   DEBUG_PRINT("debug: 删除算子: close\n");
-  if (!children_.empty()) {
+  if (!children_.empty() && !child_closed_) {
     children_[0]->close();
   }
+  child_closed_ = true;
   return RC::SUCCESS;
 }
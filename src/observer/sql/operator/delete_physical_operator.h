@@ -14,6 +14,8 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <vector>
+
 #include "sql/operator/physical_operator.h"
 
 class Trx;
@@ -48,4 +50,6 @@ public:
 private:
   Table *table_ = nullptr;
   Trx *trx_ = nullptr;
+  bool child_closed_ = false;
+  std::vector<RID> rids_;  ///< 要删除的记录
 };
@@ -12,6 +12,8 @@ See the Mulan PSL v2 for more details. */
 // Created by WangYunlai on 2022/12/27.
 //
 
+#include <stdio.h>
+#include <algorithm>
 #include <sstream>
 #include "sql/operator/explain_physical_operator.h"
 #include "common/log/log.h"
@@ -99,6 +101,11 @@ void ExplainPhysicalOperator::to_string(
   if (!param.empty()) {
     os << "(" << param << ")";
   }
+  if (oper->has_estimate()) {
+    char estimate[64];
+    snprintf(estimate, sizeof(estimate), " rows=%.0lf cost=%.2lf", oper->estimated_rows(), oper->estimated_cost());
+    os << estimate;
+  }
   os << '\n';
 
   if (static_cast<int>(ends.size()) < level + 2) {
@@ -107,7 +114,11 @@ void ExplainPhysicalOperator::to_string(
   ends[level + 1] = false;
 
   vector<std::unique_ptr<PhysicalOperator>> &children = oper->children();
-  const auto size = static_cast<int>(children.size());
+  auto size = static_cast<int>(children.size());
+  if (oper->type() == PhysicalOperatorType::GATHER) {
+    // 每个工作线程执行的计划都是一样的，只打印一个
+    size = std::min(size, 1);
+  }
   for (auto i = 0; i < size - 1; i++) {
     to_string(os, children[i].get(), level + 1, false /*last_child*/, ends);
   }
@@ -0,0 +1,211 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string.h>
+
+#include "sql/operator/gather_physical_operator.h"
+#include "storage/table/table.h"
+#include "common/log/log.h"
+
+using namespace std;
+
+GatherPhysicalOperator::GatherPhysicalOperator(Table *table)
+    : table_(table), record_size_(table->table_meta().record_size())
+{
+  tuple_.set_schema(table_, table_->table_meta().field_metas());
+}
+
+GatherPhysicalOperator::~GatherPhysicalOperator()
+{
+  close();
+}
+
+string GatherPhysicalOperator::param() const
+{
+  return "workers=" + to_string(children_.size());
+}
+
+RC GatherPhysicalOperator::open(Trx *trx)
+{
+  if (children_.empty()) {
+    LOG_WARN("gather operator should have at least one child");
+    return RC::INTERNAL;
+  }
+
+  RC rc = morsel_queue_.init(*table_->data_buffer_pool());
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to init morsel queue. table=%s, rc=%s", table_->name(), strrc(rc));
+    return rc;
+  }
+
+  batches_.clear();
+  current_batch_.data.clear();
+  current_batch_.rids.clear();
+  current_index_   = 0;
+  cancelled_       = false;
+  worker_rc_       = RC::SUCCESS;
+  running_workers_ = worker_num();
+  local_batches_.assign(worker_num(), Batch());
+
+  Consumer consumer = [this](int worker_index, RowTuple &tuple) { return produce(worker_index, tuple); };
+  for (int i = 0; i < worker_num(); i++) {
+    workers_.emplace_back([this, i, trx, consumer]() {
+      RC rc = run_worker(i, trx, consumer);
+      if (OB_SUCC(rc) && !local_batches_[i].rids.empty()) {
+        rc = push_batch(local_batches_[i]);
+      }
+      worker_done(rc);
+    });
+  }
+  LOG_TRACE("gather started. table=%s, workers=%d", table_->name(), worker_num());
+  return RC::SUCCESS;
+}
+
+RC GatherPhysicalOperator::run_worker(int worker_index, Trx *trx, const Consumer &consumer)
+{
+  PhysicalOperator *child = children_[worker_index].get();
+  RC rc = child->open(trx);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to open child of gather. worker=%d, rc=%s", worker_index, strrc(rc));
+    return rc;
+  }
+
+  while (OB_SUCC(rc = child->next())) {
+    RowTuple *tuple = static_cast<RowTuple *>(child->current_tuple());
+    rc = consumer(worker_index, *tuple);
+    if (OB_FAIL(rc)) {
+      break;
+    }
+  }
+
+  RC close_rc = child->close();
+  if (rc == RC::RECORD_EOF) {
+    rc = close_rc;
+  }
+  return rc;
+}
+
+RC GatherPhysicalOperator::produce(int worker_index, RowTuple &tuple)
+{
+  Batch &batch = local_batches_[worker_index];
+  const char *data = tuple.record().data();
+  batch.data.insert(batch.data.end(), data, data + record_size_);
+  batch.rids.push_back(tuple.record().rid());
+  if (static_cast<int>(batch.rids.size()) < BATCH_ROWS) {
+    return RC::SUCCESS;
+  }
+  return push_batch(batch);
+}
+
+RC GatherPhysicalOperator::push_batch(Batch &batch)
+{
+  unique_lock<mutex> lock(lock_);
+  not_full_.wait(lock, [this]() { return cancelled_ || static_cast<int>(batches_.size()) < MAX_BATCHES; });
+  if (cancelled_) {
+    // 上层算子不再需要数据，提前结束扫描
+    return RC::RECORD_EOF;
+  }
+
+  batches_.emplace_back(std::move(batch));
+  batch = Batch();
+  batch.data.reserve(static_cast<size_t>(record_size_) * BATCH_ROWS);
+  not_empty_.notify_one();
+  return RC::SUCCESS;
+}
+
+void GatherPhysicalOperator::worker_done(RC rc)
+{
+  lock_guard<mutex> guard(lock_);
+  if (OB_FAIL(rc) && rc != RC::RECORD_EOF && OB_SUCC(worker_rc_)) {
+    worker_rc_ = rc;
+  }
+  running_workers_--;
+  not_empty_.notify_all();
+}
+
+RC GatherPhysicalOperator::next()
+{
+  if (current_index_ >= current_batch_.rids.size()) {
+    unique_lock<mutex> lock(lock_);
+    not_empty_.wait(lock, [this]() { return !batches_.empty() || running_workers_ == 0 || OB_FAIL(worker_rc_); });
+    if (OB_FAIL(worker_rc_)) {
+      LOG_WARN("worker of gather failed. rc=%s", strrc(worker_rc_));
+      return worker_rc_;
+    }
+    if (batches_.empty()) {
+      return RC::RECORD_EOF;
+    }
+
+    current_batch_ = std::move(batches_.front());
+    batches_.pop_front();
+    current_index_ = 0;
+    not_full_.notify_one();
+  }
+
+  current_record_.set_data(current_batch_.data.data() + current_index_ * record_size_, record_size_);
+  current_record_.set_rid(current_batch_.rids[current_index_]);
+  current_index_++;
+  return RC::SUCCESS;
+}
+
+RC GatherPhysicalOperator::close()
+{
+  {
+    lock_guard<mutex> guard(lock_);
+    cancelled_ = true;
+    not_full_.notify_all();
+  }
+
+  for (thread &worker : workers_) {
+    worker.join();
+  }
+  workers_.clear();
+  batches_.clear();
+  local_batches_.clear();
+  return RC::SUCCESS;
+}
+
+Tuple *GatherPhysicalOperator::current_tuple()
+{
+  tuple_.set_record(&current_record_);
+  return &tuple_;
+}
+
+RC GatherPhysicalOperator::run_parallel(Trx *trx, const Consumer &consumer)
+{
+  if (children_.empty()) {
+    LOG_WARN("gather operator should have at least one child");
+    return RC::INTERNAL;
+  }
+
+  RC rc = morsel_queue_.init(*table_->data_buffer_pool());
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to init morsel queue. table=%s, rc=%s", table_->name(), strrc(rc));
+    return rc;
+  }
+
+  vector<RC> worker_rcs(worker_num(), RC::SUCCESS);
+  vector<thread> workers;
+  for (int i = 1; i < worker_num(); i++) {
+    workers.emplace_back([this, i, trx, &consumer, &worker_rcs]() { worker_rcs[i] = run_worker(i, trx, consumer); });
+  }
+  worker_rcs[0] = run_worker(0, trx, consumer);
+
+  for (thread &worker : workers) {
+    worker.join();
+  }
+
+  for (RC worker_rc : worker_rcs) {
+    if (OB_FAIL(worker_rc)) {
+      return worker_rc;
+    }
+  }
+  return RC::SUCCESS;
+}
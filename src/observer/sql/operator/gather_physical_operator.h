@@ -0,0 +1,106 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "sql/operator/physical_operator.h"
+#include "storage/record/record_manager.h"
+
+class Table;
+
+/**
+ * @brief 并行扫描一张表，并将多个工作线程的结果汇总起来
+ * @ingroup PhysicalOperator
+ * @details 每个子算子都是同一张表上的扫描算子(参考 ParallelPlanner)，共用一个 MorselQueue，
+ * 每个子算子在自己的线程中执行，从 MorselQueue 中一次取一组页面(morsel)扫描和过滤。
+ * 有两种使用方式：
+ * - 作为普通的算子，open 时启动工作线程，工作线程将满足条件的记录复制出来，按批放到队列中，
+ *   next 从队列中取出记录返回。输出的元组与表扫描算子相同。
+ * - 上层算子调用 run_parallel，每个工作线程直接处理自己扫描出来的记录，比如部分聚合、构建哈希表，
+ *   上层算子再将各个线程的结果合并起来。这时不需要调用 open/next/close。
+ */
+class GatherPhysicalOperator : public PhysicalOperator
+{
+public:
+  /**
+   * @brief 工作线程处理一条记录
+   * @details 不同的工作线程会同时调用，worker_index 表示是第几个工作线程
+   */
+  using Consumer = std::function<RC(int worker_index, RowTuple &tuple)>;
+
+  static constexpr int BATCH_ROWS  = 256;  ///< 工作线程每次放到队列中的记录数
+  static constexpr int MAX_BATCHES = 16;   ///< 队列中最多缓存的批数，避免工作线程比上层算子快太多
+
+public:
+  explicit GatherPhysicalOperator(Table *table);
+  virtual ~GatherPhysicalOperator();
+
+  PhysicalOperatorType type() const override
+  {
+    return PhysicalOperatorType::GATHER;
+  }
+
+  std::string param() const override;
+
+  RC open(Trx *trx) override;
+  RC next() override;
+  RC close() override;
+  Tuple *current_tuple() override;
+
+  Table *table() const { return table_; }
+  MorselQueue *morsel_queue() { return &morsel_queue_; }
+  int worker_num() const { return static_cast<int>(children_.size()); }
+
+  /**
+   * @brief 所有工作线程执行完成后返回
+   * @details 当前线程也作为其中一个工作线程
+   */
+  RC run_parallel(Trx *trx, const Consumer &consumer);
+
+private:
+  struct Batch
+  {
+    std::vector<char> data;  ///< 连续存放的记录
+    std::vector<RID>  rids;
+  };
+
+  RC run_worker(int worker_index, Trx *trx, const Consumer &consumer);
+  RC produce(int worker_index, RowTuple &tuple);
+  RC push_batch(Batch &batch);
+  void worker_done(RC rc);
+
+private:
+  Table      *table_ = nullptr;
+  int         record_size_ = 0;
+  MorselQueue morsel_queue_;
+
+  std::vector<std::thread> workers_;
+  std::vector<Batch>       local_batches_;  ///< 每个工作线程正在填充的一批记录
+
+  std::mutex              lock_;  ///< 保护下面的字段
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
+  std::deque<Batch>       batches_;
+  int                     running_workers_ = 0;
+  bool                    cancelled_       = false;
+  RC                      worker_rc_       = RC::SUCCESS;  ///< 第一个出错的工作线程的返回值
+
+  Batch    current_batch_;      ///< 正在返回的一批记录
+  size_t   current_index_ = 0;  ///< 下一条要返回的记录在 current_batch_ 中的位置
+  Record   current_record_;
+  RowTuple tuple_;
+};
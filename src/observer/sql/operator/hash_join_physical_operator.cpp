@@ -0,0 +1,236 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "sql/operator/hash_join_physical_operator.h"
+#include "common/log/log.h"
+#include "sql/operator/gather_physical_operator.h"
+#include "storage/table/table.h"
+
+using namespace std;
+
+HashJoinPhysicalOperator::HashJoinPhysicalOperator(Table *right_table, 
+                                                   vector<unique_ptr<Expression>> &&left_keys,
+                                                   vector<unique_ptr<Expression>> &&right_keys)
+    : right_table_(right_table), left_keys_(std::move(left_keys)), right_keys_(std::move(right_keys))
+{
+  right_tuple_.set_schema(right_table_, right_table_->table_meta().field_metas());
+  joined_tuple_.set_right(&right_tuple_);
+}
+
+static string key_name(const Expression *expr)
+{
+  if (expr->type() == ExprType::FIELD) {
+    auto field_expr = static_cast<const FieldExpr *>(expr);
+    return string(field_expr->table_name()) + "." + field_expr->field_name();
+  }
+  return expr->name();
+}
+
+string HashJoinPhysicalOperator::param() const
+{
+  string result;
+  for (size_t i = 0; i < left_keys_.size(); i++) {
+    if (i > 0) {
+      result += " AND ";
+    }
+    result += key_name(left_keys_[i].get()) + "=" + key_name(right_keys_[i].get());
+  }
+  return result;
+}
+
+RC HashJoinPhysicalOperator::open(Trx *trx)
+{
+  if (children_.size() != 2) {
+    LOG_WARN("hash join operator should have 2 children");
+    return RC::INTERNAL;
+  }
+
+  RC rc = build(trx);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to build hash table. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  match_iter_ = match_end_ = hash_table_.end();
+
+  left_ = children_[0].get();
+  return left_->open(trx);
+}
+
+RC HashJoinPhysicalOperator::build(Trx *trx)
+{
+  build_records_.clear();
+  hash_table_.clear();
+
+  PhysicalOperator *right = children_[1].get();
+  if (right->type() == PhysicalOperatorType::GATHER) {
+    return parallel_build(trx);
+  }
+
+  RC rc = right->open(trx);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  string key;
+  while (OB_SUCC(rc = right->next())) {
+    RowTuple *tuple = static_cast<RowTuple *>(right->current_tuple());
+    rc = make_key(right_keys_, *tuple, key);
+    if (OB_FAIL(rc)) {
+      break;
+    }
+
+    add_build_record(std::move(key), tuple->record());
+  }
+
+  RC close_rc = right->close();
+  if (rc == RC::RECORD_EOF) {
+    rc = close_rc;
+  }
+  LOG_TRACE("hash join build done. rows=%d", static_cast<int>(build_records_.size()));
+  return rc;
+}
+
+RC HashJoinPhysicalOperator::parallel_build(Trx *trx)
+{
+  struct LocalRecords
+  {
+    vector<string> keys;
+    vector<char *> datas;  ///< 复制出来的记录，合并时交给 build_records_
+    vector<RID>    rids;
+  };
+
+  GatherPhysicalOperator *gather = static_cast<GatherPhysicalOperator *>(children_[1].get());
+  vector<LocalRecords> locals(gather->worker_num());
+  const int record_size = right_table_->table_meta().record_size();
+
+  // 工作线程中只计算键值和复制记录，哈希表只在当前线程中修改
+  RC rc = gather->run_parallel(trx, [this, &locals, record_size](int worker_index, RowTuple &tuple) {
+    LocalRecords &local = locals[worker_index];
+    string key;
+    RC rc = make_key(right_keys_, tuple, key);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    char *data = static_cast<char *>(malloc(record_size));
+    memcpy(data, tuple.record().data(), record_size);
+    local.keys.emplace_back(std::move(key));
+    local.datas.push_back(data);
+    local.rids.push_back(tuple.record().rid());
+    return RC::SUCCESS;
+  });
+
+  for (LocalRecords &local : locals) {
+    for (size_t i = 0; i < local.datas.size(); i++) {
+      build_records_.emplace_back();
+      build_records_.back().set_data_owner(local.datas[i], record_size);
+      build_records_.back().set_rid(local.rids[i]);
+      hash_table_.emplace(std::move(local.keys[i]), build_records_.size() - 1);
+    }
+  }
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to scan build side in parallel. rc=%s", strrc(rc));
+    return rc;
+  }
+  LOG_TRACE("hash join parallel build done. rows=%d, workers=%d",
+            static_cast<int>(build_records_.size()), gather->worker_num());
+  return rc;
+}
+
+void HashJoinPhysicalOperator::add_build_record(string &&key, const Record &record)
+{
+  // 扫描算子返回的记录指向页面或者内部的缓存，需要复制一份
+  const int record_size = right_table_->table_meta().record_size();
+  char *data = static_cast<char *>(malloc(record_size));
+  memcpy(data, record.data(), record_size);
+  build_records_.emplace_back();
+  build_records_.back().set_data_owner(data, record_size);
+  build_records_.back().set_rid(record.rid());
+
+  hash_table_.emplace(std::move(key), build_records_.size() - 1);
+}
+
+RC HashJoinPhysicalOperator::make_key(const vector<unique_ptr<Expression>> &keys, const Tuple &tuple, string &key)
+{
+  key.clear();
+  Value value;
+  for (const unique_ptr<Expression> &expr : keys) {
+    RC rc = expr->get_value(tuple, value);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    key.push_back(static_cast<char>(value.attr_type()));
+    switch (value.attr_type()) {
+      case CHARS: {
+        key.append(value.get_string());
+        key.push_back('\0');
+      } break;
+      case FLOATS: {
+        float f = value.get_float();
+        if (f == 0) {
+          f = 0;  // -0.0 与 0.0 相等
+        }
+        key.append(reinterpret_cast<const char *>(&f), sizeof(f));
+      } break;
+      default: {
+        key.append(value.data(), value.length());
+      } break;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC HashJoinPhysicalOperator::next()
+{
+  RC rc = RC::SUCCESS;
+  string key;
+  while (match_iter_ == match_end_) {
+    rc = left_->next();
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    left_tuple_ = left_->current_tuple();
+    rc = make_key(left_keys_, *left_tuple_, key);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    auto range = hash_table_.equal_range(key);
+    match_iter_ = range.first;
+    match_end_ = range.second;
+  }
+
+  right_tuple_.set_record(&build_records_[match_iter_->second]);
+  joined_tuple_.set_left(left_tuple_);
+  ++match_iter_;
+  return rc;
+}
+
+RC HashJoinPhysicalOperator::close()
+{
+  RC rc = RC::SUCCESS;
+  if (left_ != nullptr) {
+    rc = left_->close();
+    left_ = nullptr;
+  }
+  hash_table_.clear();
+  build_records_.clear();
+  match_iter_ = match_end_ = hash_table_.end();
+  return rc;
+}
+
+Tuple *HashJoinPhysicalOperator::current_tuple()
+{
+  return &joined_tuple_;
+}
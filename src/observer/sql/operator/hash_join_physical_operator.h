@@ -0,0 +1,87 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "sql/operator/physical_operator.h"
+#include "storage/record/record.h"
+
+class Table;
+
+/**
+ * @brief 等值连接的哈希连接算子
+ * @ingroup PhysicalOperator
+ * @details open时读取右表(build side)的所有数据，按照连接字段放入哈希表，然后依次读取左边的每一行，
+ * 在哈希表中查找连接字段相等的行。右边必须是一张表的扫描算子，这样可以直接复制记录保存下来。
+ * 连接字段只用于快速找到可能匹配的行，完整的连接条件仍然由上层的过滤算子检查。
+ */
+class HashJoinPhysicalOperator : public PhysicalOperator
+{
+public:
+  HashJoinPhysicalOperator(Table *right_table, 
+                           std::vector<std::unique_ptr<Expression>> &&left_keys,
+                           std::vector<std::unique_ptr<Expression>> &&right_keys);
+  virtual ~HashJoinPhysicalOperator() = default;
+
+  PhysicalOperatorType type() const override
+  {
+    return PhysicalOperatorType::HASH_JOIN;
+  }
+
+  std::string param() const override;
+
+  RC open(Trx *trx) override;
+  RC next() override;
+  RC close() override;
+  Tuple *current_tuple() override;
+
+  std::vector<std::unique_ptr<Expression>> &left_keys() { return left_keys_; }
+  std::vector<std::unique_ptr<Expression>> &right_keys() { return right_keys_; }
+
+private:
+  RC build(Trx *trx);
+
+  /**
+   * @brief 右边是并行扫描时，每个工作线程先把记录放到自己的缓存中，最后再合并到哈希表
+   */
+  RC parallel_build(Trx *trx);
+
+  /**
+   * @brief 复制一条右表的记录，放到 build_records_ 和哈希表中
+   */
+  void add_build_record(std::string &&key, const Record &record);
+
+  /**
+   * @brief 计算连接字段的哈希键值
+   */
+  static RC make_key(const std::vector<std::unique_ptr<Expression>> &keys, const Tuple &tuple, std::string &key);
+
+private:
+  using HashTable = std::unordered_multimap<std::string, size_t>;
+
+  Table *right_table_ = nullptr;
+  std::vector<std::unique_ptr<Expression>> left_keys_;
+  std::vector<std::unique_ptr<Expression>> right_keys_;
+
+  PhysicalOperator *left_ = nullptr;
+  std::deque<Record>  build_records_;  ///< 右表中的数据，哈希表中保存的是这里的下标
+  HashTable          hash_table_;
+  HashTable::iterator match_iter_;     ///< 当前左边这一行在哈希表中匹配的行
+  HashTable::iterator match_end_;
+
+  Tuple      *left_tuple_ = nullptr;
+  RowTuple    right_tuple_;
+  JoinedTuple joined_tuple_;
+};
@@ -12,9 +12,13 @@ See the Mulan PSL v2 for more details. */
 // Created by Wangyunlai on 2022/07/08.
 //
 
+#include <limits>
+#include <sstream>
+
 #include "sql/operator/index_scan_physical_operator.h"
 #include "storage/index/index.h"
 #include "storage/trx/trx.h"
+#include "session/statement_counters.h"
 
 IndexScanPhysicalOperator::IndexScanPhysicalOperator(
     Table *table, Index *index, bool readonly, 
@@ -27,10 +31,65 @@ IndexScanPhysicalOperator::IndexScanPhysicalOperator(
       right_inclusive_(right_inclusive)
 {
   if (left_value) {
-    left_value_ = *left_value;
+    left_values_.push_back(*left_value);
   }
   if (right_value) {
-    right_value_ = *right_value;
+    right_values_.push_back(*right_value);
+  }
+}
+
+IndexScanPhysicalOperator::IndexScanPhysicalOperator(
+    Table *table, Index *index, bool readonly, 
+    std::vector<Value> left_values, bool left_inclusive, 
+    std::vector<Value> right_values, bool right_inclusive)
+    : table_(table), 
+      index_(index), 
+      readonly_(readonly), 
+      left_values_(std::move(left_values)),
+      right_values_(std::move(right_values)),
+      left_inclusive_(left_inclusive), 
+      right_inclusive_(right_inclusive)
+{}
+
+void IndexScanPhysicalOperator::make_index_key(const std::vector<Value> &values, bool pad_max, std::vector<char> &key) const
+{
+  const std::vector<FieldMeta> &field_metas = index_->field_metas();
+  int key_len = 0;
+  for (const FieldMeta &field_meta : field_metas) {
+    key_len += field_meta.len();
+  }
+  key.assign(key_len, 0);
+
+  int offset = 0;
+  for (size_t i = 0; i < field_metas.size(); i++) {
+    const FieldMeta &field_meta = field_metas[i];
+    char *dst = key.data() + offset;
+    offset += field_meta.len();
+
+    if (i < values.size()) {
+      const Value &value = values[i];
+      const int copy_len = std::min(value.length(), field_meta.len());
+      memcpy(dst, value.data(), copy_len);
+      continue;
+    }
+
+    switch (field_meta.type()) {
+      case INTS: {
+        int v = pad_max ? std::numeric_limits<int>::max() : std::numeric_limits<int>::min();
+        memcpy(dst, &v, sizeof(v));
+      } break;
+      case FLOATS: {
+        float v = pad_max ? std::numeric_limits<float>::infinity() : -std::numeric_limits<float>::infinity();
+        memcpy(dst, &v, sizeof(v));
+      } break;
+      case DATES: {
+        unsigned v = pad_max ? std::numeric_limits<unsigned>::max() : 0;
+        memcpy(dst, &v, sizeof(v));
+      } break;
+      default: {
+        memset(dst, pad_max ? 0xFF : 0, field_meta.len());
+      } break;
+    }
   }
 }
 
@@ -41,11 +100,21 @@ RC IndexScanPhysicalOperator::open(Trx *trx)
     return RC::INTERNAL;
   }
 
-  IndexScanner *index_scanner = index_->create_scanner(left_value_.data(),
-      left_value_.length(),
+  // 左边界包含边界值时，未给出的字段填充最小值，否则填充最大值。右边界相反
+  std::vector<char> left_key;
+  std::vector<char> right_key;
+  if (!left_values_.empty()) {
+    make_index_key(left_values_, !left_inclusive_, left_key);
+  }
+  if (!right_values_.empty()) {
+    make_index_key(right_values_, right_inclusive_, right_key);
+  }
+
+  IndexScanner *index_scanner = index_->create_scanner(left_key.empty() ? nullptr : left_key.data(),
+      static_cast<int>(left_key.size()),
       left_inclusive_,
-      right_value_.data(),
-      right_value_.length(),
+      right_key.empty() ? nullptr : right_key.data(),
+      static_cast<int>(right_key.size()),
       right_inclusive_);
   if (nullptr == index_scanner) {
     LOG_WARN("failed to create index scanner");
@@ -62,6 +131,18 @@ RC IndexScanPhysicalOperator::open(Trx *trx)
 
   tuple_.set_schema(table_, table_->table_meta().field_metas());
 
+  int key_len = 0;
+  for (const FieldMeta &field_meta : index_->field_metas()) {
+    key_len += field_meta.len();
+  }
+  index_key_.assign(key_len, 0);
+
+  if (index_only_) {
+    const TableMeta &table_meta = table_->table_meta();
+    check_visibility_ = table_meta.trx_fields().second > 0;
+    record_data_.assign(table_meta.record_size(), 0);
+  }
+
   trx_ = trx;
   return RC::SUCCESS;
 }
@@ -74,8 +155,14 @@ RC IndexScanPhysicalOperator::next()
 
   record_page_handler_.cleanup();
 
+  if (index_only_) {
+    return next_index_only();
+  }
+
   bool filter_result = false;
-  while (RC::SUCCESS == (rc = index_scanner_->next_entry(&rid))) {
+  while (RC::SUCCESS == (rc = index_scanner_->next_entry(&rid, index_key_.data()))) {
+    StatementCounters::current().rows_examined++;
+    record_page_handler_.cleanup();
     rc = record_handler_->get_record(record_page_handler_, &rid, readonly_, &current_record_);
     if (rc != RC::SUCCESS) {
       return rc;
@@ -87,13 +174,96 @@ RC IndexScanPhysicalOperator::next()
       return rc;
     }
 
+    // 页面上的数据不满足条件，但是对当前事务可见的旧版本可能满足
+    if (!filter_result && !(readonly_ && trx_->has_old_versions(table_, rid.page_num))) {
+      continue;
+    }
+
+    const char *page_data = current_record_.data();
+    rc = trx_->visit_record(table_, current_record_, readonly_);
+    if (rc == RC::RECORD_INVISIBLE) {
+      continue;
+    } else if (rc == RC::LOCKED_NEED_WAIT) {
+      // 拿到行锁之后，索引扫描会再返回这个索引项
+      rc = wait_for_lock();
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+      continue;
+    } else if (rc != RC::SUCCESS) {
+      return rc;
+    }
+
+    if (!entry_matches(current_record_.data())) {
+      continue;
+    }
+
+    if (current_record_.data() != page_data) {
+      rc = filter(tuple_, filter_result);
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+    }
+
+    if (filter_result) {
+      return rc;
+    }
+  }
+
+  return rc;
+}
+
+RC IndexScanPhysicalOperator::next_index_only()
+{
+  RID rid;
+  RC rc = RC::SUCCESS;
+
+  const std::vector<FieldMeta> &field_metas = index_->field_metas();
+  bool filter_result = false;
+  while (RC::SUCCESS == (rc = index_scanner_->next_entry(&rid, index_key_.data()))) {
+    StatementCounters::current().rows_examined++;
+    record_page_handler_.cleanup();
+
+    // 把索引字段的值放到记录中对应的位置上，其它字段不会被访问
+    int key_offset = 0;
+    for (const FieldMeta &field_meta : field_metas) {
+      memcpy(record_data_.data() + field_meta.offset(), index_key_.data() + key_offset, field_meta.len());
+      key_offset += field_meta.len();
+    }
+    current_record_.set_rid(rid);
+    current_record_.set_data(record_data_.data(), static_cast<int>(record_data_.size()));
+
+    tuple_.set_record(&current_record_);
+    rc = filter(tuple_, filter_result);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+
     if (!filter_result) {
       continue;
     }
 
+    if (!need_visibility_check(rid)) {
+      return rc;
+    }
+
+    // 记录所在的页面上可能有对当前事务不可见的数据，需要访问记录来判断
+    rc = record_handler_->get_record(record_page_handler_, &rid, readonly_, &current_record_);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+
     rc = trx_->visit_record(table_, current_record_, readonly_);
     if (rc == RC::RECORD_INVISIBLE) {
       continue;
+    } else if (rc == RC::LOCKED_NEED_WAIT) {
+      rc = wait_for_lock();
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+      continue;
+    } else if (rc == RC::SUCCESS && !entry_matches(current_record_.data())) {
+      continue;
     } else {
       return rc;
     }
@@ -102,11 +272,39 @@ RC IndexScanPhysicalOperator::next()
   return rc;
 }
 
+RC IndexScanPhysicalOperator::wait_for_lock()
+{
+  // 等待行锁时不能持有记录页面和索引页面的锁
+  record_page_handler_.cleanup();
+  RC rc = index_scanner_->suspend();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to suspend index scanner. rc=%s", strrc(rc));
+    return rc;
+  }
+  return trx_->wait_for_lock();
+}
+
+bool IndexScanPhysicalOperator::entry_matches(const char *version_data) const
+{
+  return index_->key_matches(index_key_.data(), version_data);
+}
+
+bool IndexScanPhysicalOperator::need_visibility_check(const RID &rid)
+{
+  if (!check_visibility_) {
+    return false;
+  }
+  return !record_handler_->is_page_all_visible(rid.page_num);
+}
+
 RC IndexScanPhysicalOperator::close()
 {
   DEBUG_PRINT("debug: 索引扫描算子: close\n");
-  index_scanner_->destroy();
-  index_scanner_ = nullptr;
+  // explain 等场景下算子可能没有被打开过
+  if (index_scanner_ != nullptr) {
+    index_scanner_->destroy();
+    index_scanner_ = nullptr;
+  }
   return RC::SUCCESS;
 }
 
@@ -144,5 +342,31 @@ RC IndexScanPhysicalOperator::filter(RowTuple &tuple, bool &result)
 
 std::string IndexScanPhysicalOperator::param() const
 {
-  return std::string(index_->index_meta().name()) + " ON " + table_->name();
+  std::stringstream ss;
+  ss << index_->index_meta().name() << " ON " << table_->name();
+
+  auto print_values = [&ss](const std::vector<Value> &values) {
+    for (size_t i = 0; i < values.size(); i++) {
+      ss << (i == 0 ? "" : ",") << values[i].to_string();
+    }
+  };
+
+  if (left_values_.empty() && right_values_.empty()) {
+    return ss.str();
+  }
+
+  if (left_values_.empty()) {
+    ss << " (-inf";
+  } else {
+    ss << " " << (left_inclusive_ ? "[" : "(");
+    print_values(left_values_);
+  }
+  ss << "; ";
+  if (right_values_.empty()) {
+    ss << "+inf)";
+  } else {
+    print_values(right_values_);
+    ss << (right_inclusive_ ? "]" : ")");
+  }
+  return ss.str();
 }
@@ -21,6 +21,12 @@ See the Mulan PSL v2 for more details. */
 /**
  * @brief 索引扫描物理算子
  * @ingroup PhysicalOperator
+ * @details 扫描范围使用索引字段的前缀来表示，比如索引(a,b,c)，条件 a=1 and b>2，
+ * 左边界是(1,2)，右边界是(1)。没有给出的字段会在构造键值时填充为对应类型的最小或最大值。
+ * 边界为空表示这一侧没有限制。
+ *
+ * 如果索引包含了查询需要的所有字段，可以设置为索引覆盖扫描(index only scan)，这时直接使用
+ * 索引中的键值构造元组，只有在记录所在页面不是全部可见的时候，才会访问表数据判断可见性。
  */
 class IndexScanPhysicalOperator : public PhysicalOperator
 {
@@ -28,12 +34,15 @@ public:
   IndexScanPhysicalOperator(Table *table, Index *index, bool readonly, 
       const Value *left_value, bool left_inclusive,
       const Value *right_value, bool right_inclusive);
+  IndexScanPhysicalOperator(Table *table, Index *index, bool readonly, 
+      std::vector<Value> left_values, bool left_inclusive,
+      std::vector<Value> right_values, bool right_inclusive);
 
   virtual ~IndexScanPhysicalOperator() = default;
 
   PhysicalOperatorType type() const override
   {
-    return PhysicalOperatorType::INDEX_SCAN;
+    return index_only_ ? PhysicalOperatorType::INDEX_ONLY_SCAN : PhysicalOperatorType::INDEX_SCAN;
   }
 
   std::string param() const override;
@@ -45,11 +54,45 @@ public:
   Tuple *current_tuple() override;
 
   void set_predicates(std::vector<std::unique_ptr<Expression>> &&exprs);
+  std::vector<std::unique_ptr<Expression>> &predicates() { return predicates_; }
+
+  Table *table() const { return table_; }
+
+  /**
+   * @brief 设置为索引覆盖扫描
+   * @details 调用者需要保证上层算子和谓词只访问索引中的字段，并且是只读的
+   */
+  void set_index_only(bool index_only) { index_only_ = index_only; }
 
 private:
+  RC next_index_only();
+
+  /**
+   * @brief 索引覆盖扫描时，判断是否需要访问记录来检查可见性
+   */
+  bool need_visibility_check(const RID &rid);
+
+  /**
+   * @brief 当前的索引项是否属于对当前事务可见的版本
+   * @details 更新记录时旧版本的索引项会保留到旧版本清理时(参考 Table::update_record)，
+   * 同一条记录可能有多个索引项，只有键值和可见版本相同的那个返回这条记录
+   */
+  bool entry_matches(const char *version_data) const;
+
+  /**
+   * @brief 释放页面锁，等待当前记录的行锁。之后索引扫描会重新返回当前的索引项
+   */
+  RC wait_for_lock();
+
   // 与TableScanPhysicalOperator代码相同，可以优化
   RC filter(RowTuple &tuple, bool &result);
 
+  /**
+   * @brief 根据边界值构造索引的键值
+   * @param pad_max 没有给出的字段是否填充为最大值
+   */
+  void make_index_key(const std::vector<Value> &values, bool pad_max, std::vector<char> &key) const;
+
 private:
   Trx * trx_ = nullptr;
   Table *table_ = nullptr;
@@ -62,10 +105,15 @@ private:
   Record current_record_;
   RowTuple tuple_;
 
-  Value left_value_;
-  Value right_value_;
+  std::vector<Value> left_values_;
+  std::vector<Value> right_values_;
   bool left_inclusive_ = false;
   bool right_inclusive_ = false;
 
   std::vector<std::unique_ptr<Expression>> predicates_;
+
+  bool index_only_ = false;
+  bool check_visibility_ = false;  ///< 表中是否有事务字段，没有的话所有记录都是可见的
+  std::vector<char> index_key_;    ///< 从索引中读取的当前索引项的键值
+  std::vector<char> record_data_;  ///< 索引覆盖扫描时，使用键值构造的记录，只有索引字段是有效的
 };
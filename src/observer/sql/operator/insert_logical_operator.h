@@ -26,7 +26,7 @@ See the Mulan PSL v2 for more details. */
 class InsertLogicalOperator : public LogicalOperator
 {
 public:
-  InsertLogicalOperator(Table *table, std::vector<Value> values);
+  InsertLogicalOperator(Table *table, std::vector<std::vector<Value>> rows);
   virtual ~InsertLogicalOperator() = default;
 
   LogicalOperatorType type() const override
@@ -35,10 +35,10 @@ public:
   }
 
   Table *table() const { return table_; }
-  const std::vector<Value> &values() const { return values_; }
-  std::vector<Value> &values() { return values_; }
+  const std::vector<std::vector<Value>> &rows() const { return rows_; }
+  std::vector<std::vector<Value>> &rows() { return rows_; }
 
 private:
   Table *table_ = nullptr;
-  std::vector<Value> values_;
+  std::vector<std::vector<Value>> rows_;  ///< 每个元素是一行要插入的数据
 };
\ No newline at end of file
@@ -19,20 +19,29 @@ See the Mulan PSL v2 for more details. */
 
 using namespace std;
 
-InsertPhysicalOperator::InsertPhysicalOperator(Table *table, vector<Value> &&values)
-    : table_(table), values_(std::move(values))
+InsertPhysicalOperator::InsertPhysicalOperator(Table *table, vector<vector<Value>> &&rows)
+    : table_(table), rows_(std::move(rows))
 {}
 
 RC InsertPhysicalOperator::open(Trx *trx)
 {
-  Record record;
-  RC rc = table_->make_record(static_cast<int>(values_.size()), values_.data(), record);
-  if (rc != RC::SUCCESS) {
-    LOG_WARN("failed to make record. rc=%s", strrc(rc));
-    return rc;
+  RC rc = RC::SUCCESS;
+  vector<Record> records(rows_.size());
+  for (size_t i = 0; i < rows_.size(); i++) {
+    vector<Value> &values = rows_[i];
+    rc = table_->make_record(static_cast<int>(values.size()), values.data(), records[i]);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to make record. rc=%s", strrc(rc));
+      return rc;
+    }
   }
 
-  rc = trx->insert_record(table_, record);
+  // 多行插入时整批交给事务，由存储层成批写入记录页、日志和索引
+  if (records.size() == 1) {
+    rc = trx->insert_record(table_, records[0]);
+  } else {
+    rc = trx->insert_records(table_, records);
+  }
   if (rc != RC::SUCCESS) {
     LOG_WARN("failed to insert record by transaction. rc=%s", strrc(rc));
   }
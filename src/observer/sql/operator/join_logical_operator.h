@@ -16,10 +16,21 @@ See the Mulan PSL v2 for more details. */
 
 #include "sql/operator/logical_operator.h"
 
+/**
+ * @brief 连接的实现方法
+ * @ingroup LogicalOperator
+ */
+enum class JoinMethod
+{
+  NESTED_LOOP,  ///< 嵌套循环连接
+  HASH,         ///< 哈希连接，需要有等值连接条件，并且右边是一张表
+};
+
 /**
  * @brief 连接算子
  * @ingroup LogicalOperator
  * @details 连接算子，用于连接两个表。对应的物理算子或者实现，可能有NestedLoopJoin，HashJoin等等。
+ * 默认使用嵌套循环连接，连接顺序和方法由 JoinOrderOptimizer 根据代价选择。
  */
 class JoinLogicalOperator : public LogicalOperator 
 {
@@ -32,5 +43,26 @@ public:
     return LogicalOperatorType::JOIN;
   }
 
+  JoinMethod method() const { return method_; }
+
+  /**
+   * @brief 使用哈希连接
+   * @param left_keys  左边的连接字段
+   * @param right_keys 右边的连接字段，与left_keys一一对应，比较相等
+   */
+  void set_hash_join(std::vector<std::unique_ptr<Expression>> &&left_keys,
+                     std::vector<std::unique_ptr<Expression>> &&right_keys)
+  {
+    method_ = JoinMethod::HASH;
+    left_keys_ = std::move(left_keys);
+    right_keys_ = std::move(right_keys);
+  }
+
+  std::vector<std::unique_ptr<Expression>> &left_keys() { return left_keys_; }
+  std::vector<std::unique_ptr<Expression>> &right_keys() { return right_keys_; }
+
 private:
+  JoinMethod method_ = JoinMethod::NESTED_LOOP;
+  std::vector<std::unique_ptr<Expression>> left_keys_;
+  std::vector<std::unique_ptr<Expression>> right_keys_;
 };
@@ -70,6 +70,11 @@ RC NestedLoopJoinPhysicalOperator::next()
 RC NestedLoopJoinPhysicalOperator::close()
 {
   DEBUG_PRINT("debug: join算子: close\n");
+  // explain 时不会打开子算子，但是会关闭
+  if (left_ == nullptr) {
+    return RC::SUCCESS;
+  }
+
   RC rc = left_->close();
   if (rc != RC::SUCCESS) {
     LOG_WARN("failed to close left oper. rc=%s", strrc(rc));
@@ -21,8 +21,14 @@ std::string physical_operator_type_name(PhysicalOperatorType type)
       return "TABLE_SCAN";
     case PhysicalOperatorType::INDEX_SCAN:
       return "INDEX_SCAN";
+    case PhysicalOperatorType::INDEX_ONLY_SCAN:
+      return "INDEX_ONLY_SCAN";
     case PhysicalOperatorType::NESTED_LOOP_JOIN:
       return "NESTED_LOOP_JOIN";
+    case PhysicalOperatorType::HASH_JOIN:
+      return "HASH_JOIN";
+    case PhysicalOperatorType::GATHER:
+      return "GATHER";
     case PhysicalOperatorType::EXPLAIN:
       return "EXPLAIN";
     case PhysicalOperatorType::PREDICATE:
@@ -39,7 +39,10 @@ enum class PhysicalOperatorType
 {
   TABLE_SCAN,
   INDEX_SCAN,
+  INDEX_ONLY_SCAN,
   NESTED_LOOP_JOIN,
+  HASH_JOIN,
+  GATHER,
   EXPLAIN,
   PREDICATE,
   PROJECT,
@@ -86,6 +89,22 @@ public:
     return children_;
   }
 
+  /**
+   * @brief 优化器估算的输出行数和代价，在explain中展示
+   * @details 代价是累计的，包含所有子算子的代价。没有估算时行数小于0
+   */
+  void set_estimate(double rows, double cost)
+  {
+    estimated_rows_ = rows;
+    estimated_cost_ = cost;
+  }
+  bool   has_estimate() const { return estimated_rows_ >= 0; }
+  double estimated_rows() const { return estimated_rows_; }
+  double estimated_cost() const { return estimated_cost_; }
+
 protected:
   std::vector<std::unique_ptr<PhysicalOperator>> children_;
+
+  double estimated_rows_ = -1;
+  double estimated_cost_ = 0;
 };
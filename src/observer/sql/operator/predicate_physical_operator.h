@@ -42,6 +42,8 @@ public:
 
   Tuple *current_tuple() override;
 
+  std::unique_ptr<Expression> &expression() { return expression_; }
+
 private:
   std::unique_ptr<Expression> expression_;
 };
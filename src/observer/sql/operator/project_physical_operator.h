@@ -51,6 +51,8 @@ public:
 
   Tuple *current_tuple() override;
 
+  ProjectTuple &project_tuple() { return tuple_; }
+
 private:
   ProjectTuple tuple_;
 };
@@ -13,6 +13,7 @@ See the Mulan PSL v2 for more details. */
 //
 
 #include "sql/operator/table_scan_physical_operator.h"
+#include "sql/expr/expression.h"
 #include "storage/table/table.h"
 #include "event/sql_debug.h"
 
@@ -21,17 +22,65 @@ using namespace std;
 RC TableScanPhysicalOperator::open(Trx *trx)
 {
   DEBUG_PRINT("debug: Table扫描算子: open\n");
-  RC rc = table_->get_record_scanner(record_scanner_, trx, readonly_);
+  trx_ = trx;
+  if (table_->is_virtual()) {
+    return open_virtual();
+  }
+
+  compile_predicates();
+  record_scanner_.set_morsel_queue(morsel_queue_);
+  RC rc = table_->get_record_scanner(
+      record_scanner_, trx, readonly_, typed_filter_.empty() ? nullptr : &typed_filter_);
   if (rc == RC::SUCCESS) {
     tuple_.set_schema(table_, table_->table_meta().field_metas());
   }
-  trx_ = trx;
   return rc;
 }
 
+RC TableScanPhysicalOperator::open_virtual()
+{
+  // 虚拟表没有页面，所有的条件都在取出行之后计算
+  residual_predicates_.clear();
+  for (unique_ptr<Expression> &expr : predicates_) {
+    residual_predicates_.push_back(expr.get());
+  }
+
+  virtual_records_.clear();
+  virtual_pos_ = 0;
+  RC rc = table_->scan_virtual_records(virtual_records_);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to scan virtual table. table=%s, rc=%s", table_->name(), strrc(rc));
+    return rc;
+  }
+  tuple_.set_schema(table_, table_->table_meta().field_metas());
+  return rc;
+}
+
+RC TableScanPhysicalOperator::next_virtual()
+{
+  RC rc = RC::SUCCESS;
+  bool filter_result = false;
+  while (virtual_pos_ < virtual_records_.size()) {
+    current_record_ = virtual_records_[virtual_pos_++];
+    tuple_.set_record(&current_record_);
+    rc = filter(tuple_, filter_result);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    if (filter_result) {
+      return rc;
+    }
+  }
+  return RC::RECORD_EOF;
+}
+
 RC TableScanPhysicalOperator::next()
 {
   DEBUG_PRINT("debug: Table扫描算子: next\n");
+  if (table_->is_virtual()) {
+    return next_virtual();
+  }
+
   if (!record_scanner_.has_next()) {
     return RC::RECORD_EOF;
   }
@@ -64,6 +113,10 @@ RC TableScanPhysicalOperator::next()
 RC TableScanPhysicalOperator::close()
 {
   DEBUG_PRINT("debug: Table扫描算子: close\n");
+  if (table_->is_virtual()) {
+    virtual_records_.clear();
+    return RC::SUCCESS;
+  }
   return record_scanner_.close_scan();
 }
 
@@ -83,12 +136,82 @@ void TableScanPhysicalOperator::set_predicates(vector<unique_ptr<Expression>> &&
   predicates_ = std::move(exprs);
 }
 
+void TableScanPhysicalOperator::compile_predicates()
+{
+  typed_filter_.clear();
+  residual_predicates_.clear();
+  for (unique_ptr<Expression> &expr : predicates_) {
+    if (expr->type() == ExprType::COMPARISON && compile_comparison(expr.get())) {
+      continue;
+    }
+
+    if (expr->type() == ExprType::CONJUNCTION) {
+      auto conjunction_expr = static_cast<ConjunctionExpr *>(expr.get());
+      if (conjunction_expr->conjunction_type() == ConjunctionExpr::Type::AND) {
+        // AND 的子条件分别编译，不能编译的子条件还要计算一次，所以整个条件保留下来
+        bool all_compiled = true;
+        for (unique_ptr<Expression> &child : conjunction_expr->children()) {
+          if (child->type() != ExprType::COMPARISON || !compile_comparison(child.get())) {
+            all_compiled = false;
+          }
+        }
+        if (all_compiled) {
+          continue;
+        }
+      }
+    }
+
+    residual_predicates_.push_back(expr.get());
+  }
+}
+
+bool TableScanPhysicalOperator::compile_comparison(Expression *expr)
+{
+  auto comparison_expr = static_cast<ComparisonExpr *>(expr);
+  Expression *left  = comparison_expr->left().get();
+  Expression *right = comparison_expr->right().get();
+  CompOp      comp  = comparison_expr->comp();
+
+  if (left->type() == ExprType::VALUE && right->type() == ExprType::FIELD) {
+    // 常量在左边时，交换左右两边
+    std::swap(left, right);
+    switch (comp) {
+      case LESS_EQUAL: {
+        comp = GREAT_EQUAL;
+      } break;
+      case LESS_THAN: {
+        comp = GREAT_THAN;
+      } break;
+      case GREAT_EQUAL: {
+        comp = LESS_EQUAL;
+      } break;
+      case GREAT_THAN: {
+        comp = LESS_THAN;
+      } break;
+      default: {
+      } break;
+    }
+  }
+
+  if (left->type() != ExprType::FIELD || right->type() != ExprType::VALUE) {
+    return false;
+  }
+
+  const Field &field = static_cast<FieldExpr *>(left)->field();
+  if (field.table() != table_) {
+    return false;
+  }
+
+  const Value &value = static_cast<ValueExpr *>(right)->get_value();
+  return typed_filter_.add_condition(*field.meta(), comp, value) == RC::SUCCESS;
+}
+
 RC TableScanPhysicalOperator::filter(RowTuple &tuple, bool &result)
 {
   DEBUG_PRINT("debug: Table扫描算子: filter\n");
   RC rc = RC::SUCCESS;
   Value value;
-  for (unique_ptr<Expression> &expr : predicates_) {
+  for (Expression *expr : residual_predicates_) {
     rc = expr->get_value(tuple, value);
     if (rc != RC::SUCCESS) {
       return rc;
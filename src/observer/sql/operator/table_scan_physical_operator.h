@@ -16,6 +16,7 @@ See the Mulan PSL v2 for more details. */
 
 #include "sql/operator/physical_operator.h"
 #include "storage/record/record_manager.h"
+#include "storage/common/condition_filter.h"
 #include "common/rc.h"
 
 class Table;
@@ -47,16 +48,40 @@ public:
   Tuple *current_tuple() override;
 
   void set_predicates(std::vector<std::unique_ptr<Expression>> &&exprs);
+  std::vector<std::unique_ptr<Expression>> &predicates() { return predicates_; }
+
+  Table *table() const { return table_; }
+  bool   readonly() const { return readonly_; }
+
+  /**
+   * @brief 并行扫描时，只扫描从 morsel_queue 中取到的页面，参考 GatherPhysicalOperator
+   */
+  void set_morsel_queue(MorselQueue *morsel_queue) { morsel_queue_ = morsel_queue; }
 
 private:
+  /**
+   * @brief 将"字段 比较符 常量"形式的条件编译成 TypedConditionFilter，交给 RecordFileScanner 直接在页面上过滤
+   * @details 其它的条件放在 residual_predicates_ 中，记录从扫描器中取出来之后再计算
+   */
+  void compile_predicates();
+  bool compile_comparison(Expression *expr);
+
   RC filter(RowTuple &tuple, bool &result);
 
+  RC open_virtual();
+  RC next_virtual();
+
 private:
   Table *                                  table_ = nullptr;
   Trx *                                    trx_ = nullptr;
   bool                                     readonly_ = false;
   RecordFileScanner                        record_scanner_;
+  MorselQueue *                            morsel_queue_ = nullptr;
   Record                                   current_record_;
   RowTuple                                 tuple_;
   std::vector<std::unique_ptr<Expression>> predicates_; // TODO chang predicate to table tuple filter
+  TypedConditionFilter                     typed_filter_;         ///< 在页面上直接计算的条件
+  std::vector<Expression *>                residual_predicates_;  ///< 不能在页面上计算的条件
+  std::vector<Record>                      virtual_records_;      ///< 虚拟表在打开时生成的所有行
+  size_t                                   virtual_pos_ = 0;      ///< 下一个要返回的虚拟表中的行
 };
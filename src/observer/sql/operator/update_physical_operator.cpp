@@ -2,6 +2,8 @@
 // Created by NieYang on 2023/10/16.
 //
 
+#include <algorithm>
+
 #include "update_physical_operator.h"
 #include "common/log/log.h"
 #include "sql/operator/update_physical_operator.h"
@@ -9,7 +11,6 @@
 #include "storage/table/table.h"
 #include "storage/trx/trx.h"
 #include "sql/stmt/update_stmt.h"
-#include "common/lang/mutex.h"
 
 RC UpdatePhysicalOperator::open(Trx *trx) 
 { 
@@ -25,6 +26,7 @@ RC UpdatePhysicalOperator::open(Trx *trx)
     }
 
     trx_ = trx;
+    child_closed_ = false;
 
     return RC::SUCCESS; 
 }
@@ -36,6 +38,15 @@ RC UpdatePhysicalOperator::next()
         return RC::RECORD_EOF;
     }
 
+    const TableMeta &table_meta = table_->table_meta();
+    const FieldMeta *field_meta = table_meta.field(field_.c_str());
+    const int record_size = table_meta.record_size();
+    // 字符串比字段短时，后面填充0
+    const int copy_len = std::min(value_->length(), field_meta->len());
+
+    // 扫描的时候只记录要更新的记录和新的数据，不修改表和索引
+    rids_.clear();
+    new_data_.clear();
     PhysicalOperator *child = children_[0].get();
     while (RC::SUCCESS == (rc = child->next())) {
         Tuple *tuple = child->current_tuple();
@@ -44,32 +55,47 @@ RC UpdatePhysicalOperator::next()
             return rc;
         }
         RowTuple *row_tuple = static_cast<RowTuple *>(tuple);
-        // 更新
         Record &record = row_tuple->record();
-        char * data = record.data();
-        const TableMeta table_meta = table_->table_meta();
-        const FieldMeta * field_meta = table_meta.field(field_.c_str());
-        // TODO: 有更新不成功的bug
-        common::Mutex lock_;
-        lock_.lock();
-        const char *value_data = value_->data();
-        memmove(data + field_meta->offset(), value_data, (size_t)value_->length());
-        memmove(data + field_meta->offset(), value_data, (size_t)value_->length());
-        lock_.unlock();
-        // 是否需要手动更新索引?
+
+        rids_.push_back(record.rid());
+        new_data_.insert(new_data_.end(), record.data(), record.data() + record_size);
+        char *new_data = new_data_.data() + new_data_.size() - record_size;
+        memset(new_data + field_meta->offset(), 0, field_meta->len());
+        memcpy(new_data + field_meta->offset(), value_->data(), copy_len);
+    }
+
+    if (rc != RC::RECORD_EOF) {
+        LOG_WARN("failed to get next record to update: %s", strrc(rc));
+        return rc;
+    }
+
+    // 扫描结束之后再更新，扫描器不再持有页面和索引
+    child->close();
+    child_closed_ = true;
+
+    for (size_t i = 0; i < rids_.size(); i++) {
+        const char *new_data = new_data_.data() + i * record_size;
+        // visit_record 返回的是释放页面的结果，更新的结果要单独保存
+        RC update_rc = RC::SUCCESS;
+        rc = table_->visit_record(rids_[i], false/*readonly*/, [this, new_data, &update_rc](Record &record) {
+            update_rc = trx_->update_record(table_, record, new_data);
+        });
+        if (rc == RC::SUCCESS) {
+            rc = update_rc;
+        }
         if (rc != RC::SUCCESS) {
-            LOG_WARN("failed to update record: %s", strrc(rc));
+            LOG_WARN("failed to update record. rid=%s, rc=%s", rids_[i].to_string().c_str(), strrc(rc));
             return rc;
         }
     }
-
     return RC::RECORD_EOF;
 }
 
 RC UpdatePhysicalOperator::close() 
 { 
-    if (!children_.empty()) {
+    if (!children_.empty() && !child_closed_) {
         children_[0]->close();
     }
+    child_closed_ = true;
     return RC::SUCCESS;
 }
@@ -4,14 +4,19 @@
 
 #pragma once
 
+#include <vector>
+
 #include "sql/operator/physical_operator.h"
 
 class Trx;
 class DeleteStmt;
 
 /**
- * @brief 物理算子，删除
+ * @brief 物理算子，更新
  * @ingroup PhysicalOperator
+ * @details 直接修改页面上的记录，旧版本、日志和索引由事务处理，参考 Trx::update_record。
+ * 先扫描出所有要更新的记录和更新之后的数据，关闭扫描之后再逐条更新。否则修改的索引正是下层索引扫描
+ * 使用的索引时，扫描会跳过或者重复访问一些记录(Halloween problem)。
  */
 class UpdatePhysicalOperator : public PhysicalOperator
 {
@@ -40,4 +45,7 @@ private:
   Value *value_ = nullptr;
   std::string field_;
   Trx *trx_ = nullptr;
-};
\ No newline at end of file
+  bool child_closed_ = false;
+  std::vector<RID>  rids_;      ///< 要更新的记录
+  std::vector<char> new_data_;  ///< 更新之后的记录，按照 rids_ 的顺序连续存放
+};
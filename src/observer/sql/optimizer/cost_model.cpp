@@ -0,0 +1,151 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "sql/optimizer/cost_model.h"
+#include "sql/expr/expression.h"
+#include "storage/field/field_meta.h"
+#include "storage/table/table.h"
+
+using namespace std;
+
+double CostModel::table_rows(const Table *table)
+{
+  const int64_t row_count = table->row_count();
+  return row_count >= 0 ? static_cast<double>(row_count) : DEFAULT_TABLE_ROWS;
+}
+
+bool CostModel::has_column_stats(const Table *table, const FieldMeta *field)
+{
+  shared_ptr<const TableStats> stats = table->stats();
+  const ColumnStats *column_stats = stats ? stats->column(field->name()) : nullptr;
+  return column_stats != nullptr && !column_stats->empty();
+}
+
+double CostModel::equal_selectivity(const Table *table, const FieldMeta *field, const Value &value)
+{
+  shared_ptr<const TableStats> stats = table->stats();
+  const ColumnStats *column_stats = stats ? stats->column(field->name()) : nullptr;
+  if (nullptr == column_stats || column_stats->type() != value.attr_type()) {
+    return DEFAULT_EQUAL_SELECTIVITY;
+  }
+  return column_stats->equal_selectivity(value);
+}
+
+double CostModel::range_selectivity(const Table *table, const FieldMeta *field, 
+                                    const Value *lower, bool lower_inclusive, const Value *upper, bool upper_inclusive)
+{
+  shared_ptr<const TableStats> stats = table->stats();
+  const ColumnStats *column_stats = stats ? stats->column(field->name()) : nullptr;
+  if (nullptr == column_stats || (lower != nullptr && column_stats->type() != lower->attr_type()) ||
+      (upper != nullptr && column_stats->type() != upper->attr_type())) {
+    if (lower != nullptr && upper != nullptr) {
+      return DEFAULT_BETWEEN_SELECTIVITY;
+    }
+    return (lower != nullptr || upper != nullptr) ? DEFAULT_RANGE_SELECTIVITY : 1.0;
+  }
+  return column_stats->range_selectivity(lower, lower_inclusive, upper, upper_inclusive);
+}
+
+/**
+ * @brief 字段 = 字段 的选择率
+ * @details 假设取值少的一边的每个值都能在另一边找到，选择率是 1/max(ndv1, ndv2)。
+ * 没有统计信息时，假设字段上的值都是不同的。
+ */
+static double field_equal_selectivity(const Field &left, const Field &right)
+{
+  double max_ndv = 1.0;
+  for (const Field *field : {&left, &right}) {
+    double ndv = CostModel::table_rows(field->table());
+    shared_ptr<const TableStats> stats = field->table()->stats();
+    const ColumnStats *column_stats = stats ? stats->column(field->field_name()) : nullptr;
+    if (column_stats != nullptr) {
+      ndv = column_stats->ndv();
+    }
+    max_ndv = std::max(max_ndv, ndv);
+  }
+  return 1.0 / max_ndv;
+}
+
+static double comparison_selectivity(ComparisonExpr *expr)
+{
+  CompOp comp = expr->comp();
+  Expression *left = expr->left().get();
+  Expression *right = expr->right().get();
+  if (left->type() == ExprType::FIELD && right->type() == ExprType::FIELD) {
+    if (comp == EQUAL_TO) {
+      return field_equal_selectivity(static_cast<FieldExpr *>(left)->field(), static_cast<FieldExpr *>(right)->field());
+    }
+    return comp == NOT_EQUAL ? 1.0 - CostModel::DEFAULT_EQUAL_SELECTIVITY : CostModel::DEFAULT_RANGE_SELECTIVITY;
+  }
+
+  if (left->type() == ExprType::VALUE && right->type() == ExprType::FIELD) {
+    std::swap(left, right);
+    switch (comp) {
+      case LESS_THAN:   comp = GREAT_THAN;  break;
+      case LESS_EQUAL:  comp = GREAT_EQUAL; break;
+      case GREAT_THAN:  comp = LESS_THAN;   break;
+      case GREAT_EQUAL: comp = LESS_EQUAL;  break;
+      default: break;
+    }
+  }
+  if (left->type() != ExprType::FIELD || right->type() != ExprType::VALUE) {
+    return comp == EQUAL_TO ? CostModel::DEFAULT_EQUAL_SELECTIVITY : CostModel::DEFAULT_RANGE_SELECTIVITY;
+  }
+
+  const Field &field = static_cast<FieldExpr *>(left)->field();
+  const Value &value = static_cast<ValueExpr *>(right)->get_value();
+  switch (comp) {
+    case EQUAL_TO:    return CostModel::equal_selectivity(field.table(), field.meta(), value);
+    case NOT_EQUAL:   return 1.0 - CostModel::equal_selectivity(field.table(), field.meta(), value);
+    case LESS_THAN:   return CostModel::range_selectivity(field.table(), field.meta(), nullptr, false, &value, false);
+    case LESS_EQUAL:  return CostModel::range_selectivity(field.table(), field.meta(), nullptr, false, &value, true);
+    case GREAT_THAN:  return CostModel::range_selectivity(field.table(), field.meta(), &value, false, nullptr, false);
+    case GREAT_EQUAL: return CostModel::range_selectivity(field.table(), field.meta(), &value, true, nullptr, false);
+    default:          return CostModel::DEFAULT_RANGE_SELECTIVITY;
+  }
+}
+
+double CostModel::selectivity(Expression *expr)
+{
+  switch (expr->type()) {
+    case ExprType::COMPARISON: {
+      return comparison_selectivity(static_cast<ComparisonExpr *>(expr));
+    }
+    case ExprType::CONJUNCTION: {
+      auto conjunction_expr = static_cast<ConjunctionExpr *>(expr);
+      const bool is_and = conjunction_expr->conjunction_type() == ConjunctionExpr::Type::AND;
+      double result = is_and ? 1.0 : 0.0;
+      for (unique_ptr<Expression> &child : conjunction_expr->children()) {
+        const double child_selectivity = selectivity(child.get());
+        result = is_and ? result * child_selectivity : result + child_selectivity - result * child_selectivity;
+      }
+      return result;
+    }
+    case ExprType::VALUE: {
+      Value value;
+      if (expr->try_get_value(value) == RC::SUCCESS && value.attr_type() == BOOLEANS) {
+        return value.get_boolean() ? 1.0 : 0.0;
+      }
+      return 1.0;
+    }
+    default: {
+      return DEFAULT_RANGE_SELECTIVITY;
+    }
+  }
+}
+
+double CostModel::selectivity(const vector<unique_ptr<Expression>> &exprs)
+{
+  double result = 1.0;
+  for (const unique_ptr<Expression> &expr : exprs) {
+    result *= selectivity(expr.get());
+  }
+  return result;
+}
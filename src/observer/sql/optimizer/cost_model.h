@@ -0,0 +1,118 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+class Table;
+class FieldMeta;
+class Value;
+class Expression;
+
+/**
+ * @brief 一个简单的代价模型
+ * @ingroup PhysicalOperator
+ * @details 代价的单位是"顺序读取并处理一行数据"的代价。
+ * 表分析过(ANALYZE TABLE)时，使用统计信息估算行数和谓词的选择率，否则使用一些经验值。
+ * 范围条件的经验值无法区分选择率高低，没有统计信息时选择索引按照整个表都在范围内估算(参考 has_column_stats)。
+ */
+class CostModel
+{
+public:
+  /// 没有统计信息时，假设表中的行数
+  static constexpr double DEFAULT_TABLE_ROWS = 1000.0;
+
+  /// 等值条件的默认选择率
+  static constexpr double DEFAULT_EQUAL_SELECTIVITY = 0.1;
+  /// 单边范围条件(<, <=, >, >=)的默认选择率
+  static constexpr double DEFAULT_RANGE_SELECTIVITY = 1.0 / 3;
+  /// 双边范围条件(BETWEEN)的默认选择率
+  static constexpr double DEFAULT_BETWEEN_SELECTIVITY = 0.25;
+
+  /// 顺序扫描一行的代价
+  static constexpr double SEQ_ROW_COST = 1.0;
+  /// 通过索引回表，随机读取一行的代价
+  static constexpr double RANDOM_ROW_COST = 2.0;
+  /// 从根节点查找到叶子节点的代价
+  static constexpr double INDEX_LOOKUP_COST = 4.0;
+  /// 索引覆盖扫描时，顺序读取一个索引项的代价。索引项比记录小，一个页面可以放更多
+  static constexpr double INDEX_ENTRY_COST = 0.5;
+  /// 哈希连接时，将一行数据放入哈希表的代价
+  static constexpr double HASH_BUILD_ROW_COST = 1.5;
+  /// 哈希连接时，用一行数据查找哈希表的代价
+  static constexpr double HASH_PROBE_ROW_COST = 1.0;
+
+public:
+  /**
+   * @brief 表中的行数
+   */
+  static double table_rows(const Table *table);
+
+  /**
+   * @brief 字段上是否有统计信息
+   * @details 没有统计信息时，范围条件的选择率只是经验值，可能整个表都在范围内，这时回表的随机读比全表扫描
+   * 慢得多。所以估算索引扫描的代价时不使用这个经验值，只有等值条件或者索引覆盖查询时才会选择索引
+   */
+  static bool has_column_stats(const Table *table, const FieldMeta *field);
+
+  /**
+   * @brief 字段等于某个常量的选择率
+   */
+  static double equal_selectivity(const Table *table, const FieldMeta *field, const Value &value);
+
+  /**
+   * @brief 字段在某个范围内的选择率
+   * @param lower 下界，为空表示没有下界
+   * @param upper 上界，为空表示没有上界
+   */
+  static double range_selectivity(const Table *table, const FieldMeta *field, 
+                                  const Value *lower, bool lower_inclusive, const Value *upper, bool upper_inclusive);
+
+  /**
+   * @brief 谓词的选择率
+   * @details 支持 字段 op 常量、字段 = 字段 的比较，以及它们的AND/OR组合，其它的谓词使用经验值
+   */
+  static double selectivity(Expression *expr);
+  static double selectivity(const std::vector<std::unique_ptr<Expression>> &exprs);
+
+  static double table_scan_cost(double rows)
+  {
+    return rows * SEQ_ROW_COST;
+  }
+
+  static double index_scan_cost(double rows, double selectivity)
+  {
+    return INDEX_LOOKUP_COST + rows * selectivity * RANDOM_ROW_COST;
+  }
+
+  static double index_only_scan_cost(double rows, double selectivity)
+  {
+    return INDEX_LOOKUP_COST + rows * selectivity * INDEX_ENTRY_COST;
+  }
+
+  /**
+   * @brief 嵌套循环连接的代价，左表的每一行都要重新扫描一次右表
+   */
+  static double nested_loop_join_cost(double left_rows, double left_cost, double right_cost)
+  {
+    return left_cost + std::max(left_rows, 1.0) * right_cost;
+  }
+
+  /**
+   * @brief 哈希连接的代价，使用右表构建哈希表，左表的每一行查找一次哈希表
+   */
+  static double hash_join_cost(double left_rows, double left_cost, double right_rows, double right_cost)
+  {
+    return left_cost + right_cost + right_rows * HASH_BUILD_ROW_COST + left_rows * HASH_PROBE_ROW_COST;
+  }
+};
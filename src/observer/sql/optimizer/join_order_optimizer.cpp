@@ -0,0 +1,488 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <bit>
+#include <vector>
+
+#include "sql/optimizer/join_order_optimizer.h"
+#include "sql/optimizer/cost_model.h"
+#include "sql/optimizer/physical_plan_generator.h"
+#include "sql/operator/join_logical_operator.h"
+#include "sql/operator/predicate_logical_operator.h"
+#include "sql/operator/table_get_logical_operator.h"
+#include "sql/expr/expression.h"
+#include "common/log/log.h"
+
+using namespace std;
+
+namespace {
+
+using TableSet = uint64_t;
+
+/**
+ * @brief 连接区域中的一个过滤条件
+ */
+struct JoinPredicate
+{
+  unique_ptr<Expression> expr;
+  TableSet tables = 0;  ///< 条件中引用的表
+  double selectivity = 1.0;
+  bool used = false;
+};
+
+/**
+ * @brief 连接区域中的一张表
+ */
+struct JoinRelation
+{
+  unique_ptr<LogicalOperator> oper;  ///< 取表数据的算子
+  Table *table = nullptr;
+  double rows = 0;
+  double cost = 0;
+};
+
+/**
+ * @brief 一组表连接的最优方案，动态规划时使用
+ * @details 左深树，由 tables 去掉 last 之后的最优方案与 last 连接得到
+ */
+struct JoinPlan
+{
+  bool valid = false;
+  double rows = 0;
+  double cost = 0;
+  int last = -1;
+  JoinMethod method = JoinMethod::NESTED_LOOP;
+};
+
+/**
+ * @brief 一次连接的估算结果
+ */
+struct JoinStep
+{
+  double rows = 0;
+  double cost = 0;
+  JoinMethod method = JoinMethod::NESTED_LOOP;
+  bool connected = false;  ///< 是否有连接条件
+};
+
+}  // namespace
+
+/**
+ * @brief 子树是否只包含连接、过滤和取表数据算子
+ */
+static bool collect_region_tables(LogicalOperator *oper, vector<Table *> &tables)
+{
+  switch (oper->type()) {
+    case LogicalOperatorType::TABLE_GET: {
+      tables.push_back(static_cast<TableGetLogicalOperator *>(oper)->table());
+      return true;
+    }
+    case LogicalOperatorType::JOIN: {
+      return oper->children().size() == 2 &&
+             collect_region_tables(oper->children()[0].get(), tables) &&
+             collect_region_tables(oper->children()[1].get(), tables);
+    }
+    case LogicalOperatorType::PREDICATE: {
+      return oper->children().size() == 1 && oper->expressions().size() == 1 &&
+             collect_region_tables(oper->children()[0].get(), tables);
+    }
+    default: {
+      return false;
+    }
+  }
+}
+
+/**
+ * @brief 将AND连接的条件拆开，去掉恒为真的条件(参考 PredicatePushdownRewriter)
+ */
+static void split_conjunction(unique_ptr<Expression> expr, vector<unique_ptr<Expression>> &exprs)
+{
+  if (expr->type() == ExprType::CONJUNCTION &&
+      static_cast<ConjunctionExpr *>(expr.get())->conjunction_type() == ConjunctionExpr::Type::AND) {
+    for (unique_ptr<Expression> &child : static_cast<ConjunctionExpr *>(expr.get())->children()) {
+      split_conjunction(std::move(child), exprs);
+    }
+    return;
+  }
+
+  Value value;
+  if (expr->type() == ExprType::VALUE && expr->try_get_value(value) == RC::SUCCESS &&
+      value.attr_type() == BOOLEANS && value.get_boolean()) {
+    return;
+  }
+  exprs.push_back(std::move(expr));
+}
+
+static void extract_region(unique_ptr<LogicalOperator> &oper, vector<JoinRelation> &relations,
+                           vector<unique_ptr<Expression>> &exprs)
+{
+  switch (oper->type()) {
+    case LogicalOperatorType::TABLE_GET: {
+      relations.emplace_back();
+      relations.back().table = static_cast<TableGetLogicalOperator *>(oper.get())->table();
+      relations.back().oper = std::move(oper);
+    } break;
+    case LogicalOperatorType::PREDICATE: {
+      split_conjunction(std::move(oper->expressions().front()), exprs);
+      extract_region(oper->children().front(), relations, exprs);
+    } break;
+    default: {
+      for (unique_ptr<LogicalOperator> &child : oper->children()) {
+        extract_region(child, relations, exprs);
+      }
+    } break;
+  }
+}
+
+/**
+ * @brief 表达式中引用了哪些表
+ * @details 无法识别的表达式，认为引用了所有的表，放在最后计算
+ */
+static TableSet referenced_tables(Expression *expr, const vector<JoinRelation> &relations, TableSet all_tables)
+{
+  switch (expr->type()) {
+    case ExprType::FIELD: {
+      const Table *table = static_cast<FieldExpr *>(expr)->field().table();
+      for (size_t i = 0; i < relations.size(); i++) {
+        if (relations[i].table == table) {
+          return TableSet(1) << i;
+        }
+      }
+      return all_tables;
+    }
+    case ExprType::VALUE: {
+      return 0;
+    }
+    case ExprType::CAST: {
+      return referenced_tables(static_cast<CastExpr *>(expr)->child().get(), relations, all_tables);
+    }
+    case ExprType::COMPARISON: {
+      auto comparison_expr = static_cast<ComparisonExpr *>(expr);
+      return referenced_tables(comparison_expr->left().get(), relations, all_tables) |
+             referenced_tables(comparison_expr->right().get(), relations, all_tables);
+    }
+    case ExprType::ARITHMETIC: {
+      auto arithmetic_expr = static_cast<ArithmeticExpr *>(expr);
+      TableSet tables = referenced_tables(arithmetic_expr->left().get(), relations, all_tables);
+      if (arithmetic_expr->right()) {
+        tables |= referenced_tables(arithmetic_expr->right().get(), relations, all_tables);
+      }
+      return tables;
+    }
+    case ExprType::CONJUNCTION: {
+      TableSet tables = 0;
+      for (unique_ptr<Expression> &child : static_cast<ConjunctionExpr *>(expr)->children()) {
+        tables |= referenced_tables(child.get(), relations, all_tables);
+      }
+      return tables;
+    }
+    default: {
+      return all_tables;
+    }
+  }
+}
+
+/**
+ * @brief 条件是否是两张表的字段等值比较，并且可以用作哈希连接的键值
+ * @param left_tables 连接左边的表
+ * @param right       连接右边的表
+ * @param left_field[out]  比较符左边的字段，不一定属于连接左边的表
+ * @param right_field[out] 比较符右边的字段
+ */
+static bool is_hash_join_key(const JoinPredicate &predicate, TableSet left_tables, int right,
+                             FieldExpr *&left_field, FieldExpr *&right_field)
+{
+  if (predicate.expr->type() != ExprType::COMPARISON) {
+    return false;
+  }
+  auto comparison_expr = static_cast<ComparisonExpr *>(predicate.expr.get());
+  if (comparison_expr->comp() != EQUAL_TO || comparison_expr->left()->type() != ExprType::FIELD ||
+      comparison_expr->right()->type() != ExprType::FIELD) {
+    return false;
+  }
+
+  left_field = static_cast<FieldExpr *>(comparison_expr->left().get());
+  right_field = static_cast<FieldExpr *>(comparison_expr->right().get());
+  if (left_field->field().attr_type() != right_field->field().attr_type()) {
+    return false;
+  }
+
+  // 两个字段分别属于左边的某张表和右表
+  const TableSet right_table = TableSet(1) << right;
+  return std::popcount(predicate.tables) == 2 && (predicate.tables & right_table) != 0 &&
+         (predicate.tables & left_tables) == (predicate.tables & ~right_table);
+}
+
+/**
+ * @brief 估算将一张表连接到已有的连接结果上的输出行数和代价
+ */
+static JoinStep estimate_join(double left_rows, double left_cost, TableSet left_tables, int right,
+                              const vector<JoinRelation> &relations, const vector<JoinPredicate> &predicates)
+{
+  const TableSet right_table = TableSet(1) << right;
+  const TableSet tables = left_tables | right_table;
+
+  JoinStep step;
+  double selectivity = 1.0;
+  bool hashable = false;
+  for (const JoinPredicate &predicate : predicates) {
+    // 只计算这次连接刚好可以计算的条件
+    if ((predicate.tables & tables) != predicate.tables || (predicate.tables & right_table) == 0 ||
+        (predicate.tables & left_tables) == 0) {
+      continue;
+    }
+
+    step.connected = true;
+    selectivity *= predicate.selectivity;
+
+    FieldExpr *left_field = nullptr;
+    FieldExpr *right_field = nullptr;
+    hashable = hashable || is_hash_join_key(predicate, left_tables, right, left_field, right_field);
+  }
+
+  const JoinRelation &relation = relations[right];
+  step.rows = left_rows * relation.rows * selectivity;
+  step.cost = CostModel::nested_loop_join_cost(left_rows, left_cost, relation.cost);
+  step.method = JoinMethod::NESTED_LOOP;
+  if (hashable) {
+    const double hash_cost = CostModel::hash_join_cost(left_rows, left_cost, relation.rows, relation.cost);
+    if (hash_cost < step.cost) {
+      step.cost = hash_cost;
+      step.method = JoinMethod::HASH;
+    }
+  }
+  return step;
+}
+
+/**
+ * @brief 使用动态规划枚举左深树的连接顺序
+ */
+static void dp_join_order(const vector<JoinRelation> &relations, const vector<JoinPredicate> &predicates,
+                          vector<int> &order, vector<JoinMethod> &methods)
+{
+  const int relation_num = static_cast<int>(relations.size());
+  const TableSet all_tables = (TableSet(1) << relation_num) - 1;
+
+  vector<JoinPlan> plans(all_tables + 1);
+  for (int i = 0; i < relation_num; i++) {
+    JoinPlan &plan = plans[TableSet(1) << i];
+    plan.valid = true;
+    plan.rows = relations[i].rows;
+    plan.cost = relations[i].cost;
+    plan.last = i;
+  }
+
+  for (TableSet tables = 1; tables <= all_tables; tables++) {
+    if (std::popcount(tables) < 2) {
+      continue;
+    }
+
+    // 先只考虑有连接条件的方案，都没有时才考虑笛卡尔积
+    JoinPlan &plan = plans[tables];
+    for (int pass = 0; pass < 2 && !plan.valid; pass++) {
+      for (int right = 0; right < relation_num; right++) {
+        const TableSet right_table = TableSet(1) << right;
+        if ((tables & right_table) == 0) {
+          continue;
+        }
+        const JoinPlan &left_plan = plans[tables & ~right_table];
+        if (!left_plan.valid) {
+          continue;
+        }
+
+        JoinStep step = estimate_join(left_plan.rows, left_plan.cost, tables & ~right_table, right, relations, predicates);
+        if (pass == 0 && !step.connected) {
+          continue;
+        }
+        if (!plan.valid || step.cost < plan.cost) {
+          plan.valid = true;
+          plan.rows = step.rows;
+          plan.cost = step.cost;
+          plan.last = right;
+          plan.method = step.method;
+        }
+      }
+    }
+  }
+
+  TableSet tables = all_tables;
+  while (tables != 0) {
+    const JoinPlan &plan = plans[tables];
+    order.push_back(plan.last);
+    methods.push_back(plan.method);
+    tables &= ~(TableSet(1) << plan.last);
+  }
+  std::reverse(order.begin(), order.end());
+  std::reverse(methods.begin(), methods.end());
+}
+
+/**
+ * @brief 表比较多时，使用贪心算法选择连接顺序
+ * @details 从行数最少的表开始，每次选择连接代价最小的一张表
+ */
+static void greedy_join_order(const vector<JoinRelation> &relations, const vector<JoinPredicate> &predicates,
+                              vector<int> &order, vector<JoinMethod> &methods)
+{
+  const int relation_num = static_cast<int>(relations.size());
+  int first = 0;
+  for (int i = 1; i < relation_num; i++) {
+    if (relations[i].rows < relations[first].rows) {
+      first = i;
+    }
+  }
+
+  TableSet tables = TableSet(1) << first;
+  double rows = relations[first].rows;
+  double cost = relations[first].cost;
+  order.push_back(first);
+  methods.push_back(JoinMethod::NESTED_LOOP);
+
+  while (static_cast<int>(order.size()) < relation_num) {
+    int best = -1;
+    JoinStep best_step;
+    for (int right = 0; right < relation_num; right++) {
+      if ((tables & (TableSet(1) << right)) != 0) {
+        continue;
+      }
+
+      JoinStep step = estimate_join(rows, cost, tables, right, relations, predicates);
+      if (best < 0 || (step.connected && !best_step.connected) ||
+          (step.connected == best_step.connected && step.cost < best_step.cost)) {
+        best = right;
+        best_step = step;
+      }
+    }
+
+    tables |= TableSet(1) << best;
+    rows = best_step.rows;
+    cost = best_step.cost;
+    order.push_back(best);
+    methods.push_back(best_step.method);
+  }
+}
+
+RC JoinOrderOptimizer::optimize(unique_ptr<LogicalOperator> &oper)
+{
+  if (oper->type() == LogicalOperatorType::JOIN || oper->type() == LogicalOperatorType::PREDICATE) {
+    vector<Table *> tables;
+    if (collect_region_tables(oper.get(), tables) && tables.size() >= 2) {
+      // 同一张表出现多次时，无法根据字段区分属于哪一个，不做优化
+      vector<Table *> sorted_tables(tables);
+      std::sort(sorted_tables.begin(), sorted_tables.end());
+      if (std::adjacent_find(sorted_tables.begin(), sorted_tables.end()) == sorted_tables.end() &&
+          tables.size() <= sizeof(TableSet) * 8) {
+        return reorder(oper);
+      }
+      return RC::SUCCESS;
+    }
+  }
+
+  for (unique_ptr<LogicalOperator> &child : oper->children()) {
+    RC rc = optimize(child);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC JoinOrderOptimizer::reorder(unique_ptr<LogicalOperator> &oper)
+{
+  vector<JoinRelation> relations;
+  vector<unique_ptr<Expression>> exprs;
+  extract_region(oper, relations, exprs);
+
+  const int relation_num = static_cast<int>(relations.size());
+  const TableSet all_tables = relation_num >= static_cast<int>(sizeof(TableSet) * 8)
+                            ? ~TableSet(0) : (TableSet(1) << relation_num) - 1;
+
+  // 只涉及一张表的条件下推到取表数据的算子，其它的作为连接条件
+  vector<JoinPredicate> predicates;
+  for (unique_ptr<Expression> &expr : exprs) {
+    TableSet tables = referenced_tables(expr.get(), relations, all_tables);
+    if (tables == 0) {
+      tables = all_tables;
+    }
+
+    if (std::popcount(tables) == 1) {
+      auto table_get_oper = static_cast<TableGetLogicalOperator *>(relations[std::countr_zero(tables)].oper.get());
+      table_get_oper->predicates().push_back(std::move(expr));
+      continue;
+    }
+
+    predicates.emplace_back();
+    predicates.back().selectivity = CostModel::selectivity(expr.get());
+    predicates.back().expr = std::move(expr);
+    predicates.back().tables = tables;
+  }
+
+  for (JoinRelation &relation : relations) {
+    PhysicalPlanGenerator::estimate(*static_cast<TableGetLogicalOperator *>(relation.oper.get()), relation.rows, relation.cost);
+  }
+
+  vector<int> order;
+  vector<JoinMethod> methods;
+  if (relation_num <= DP_TABLE_LIMIT) {
+    dp_join_order(relations, predicates, order, methods);
+  } else {
+    greedy_join_order(relations, predicates, order, methods);
+  }
+
+  // 按照选择的顺序重新生成左深树
+  unique_ptr<LogicalOperator> result = std::move(relations[order[0]].oper);
+  TableSet tables = TableSet(1) << order[0];
+  for (int i = 1; i < relation_num; i++) {
+    const int right = order[i];
+    const TableSet right_table = TableSet(1) << right;
+
+    unique_ptr<JoinLogicalOperator> join_oper(new JoinLogicalOperator);
+    vector<unique_ptr<Expression>> left_keys;
+    vector<unique_ptr<Expression>> right_keys;
+    vector<unique_ptr<Expression>> join_exprs;
+    for (JoinPredicate &predicate : predicates) {
+      if (predicate.used || (predicate.tables & (tables | right_table)) != predicate.tables) {
+        continue;
+      }
+
+      FieldExpr *left_field = nullptr;
+      FieldExpr *right_field = nullptr;
+      if (methods[i] == JoinMethod::HASH && is_hash_join_key(predicate, tables, right, left_field, right_field)) {
+        if (left_field->field().table() == relations[right].table) {
+          std::swap(left_field, right_field);
+        }
+        left_keys.emplace_back(new FieldExpr(left_field->field()));
+        right_keys.emplace_back(new FieldExpr(right_field->field()));
+      }
+
+      predicate.used = true;
+      join_exprs.push_back(std::move(predicate.expr));
+    }
+
+    if (methods[i] == JoinMethod::HASH && !left_keys.empty()) {
+      join_oper->set_hash_join(std::move(left_keys), std::move(right_keys));
+    }
+    join_oper->add_child(std::move(result));
+    join_oper->add_child(std::move(relations[right].oper));
+    result = std::move(join_oper);
+
+    if (!join_exprs.empty()) {
+      unique_ptr<Expression> conjunction_expr(new ConjunctionExpr(ConjunctionExpr::Type::AND, join_exprs));
+      unique_ptr<LogicalOperator> predicate_oper(new PredicateLogicalOperator(std::move(conjunction_expr)));
+      predicate_oper->add_child(std::move(result));
+      result = std::move(predicate_oper);
+    }
+    tables |= right_table;
+  }
+
+  LOG_TRACE("join order optimized. table num=%d", relation_num);
+  oper = std::move(result);
+  return RC::SUCCESS;
+}
@@ -0,0 +1,43 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <memory>
+
+#include "common/rc.h"
+
+class LogicalOperator;
+
+/**
+ * @brief 基于代价选择多表连接的顺序和方法
+ * @ingroup PhysicalOperator
+ * @details 逻辑计划中，由连接、过滤和取表数据算子组成的子树称为一个连接区域。
+ * 优化时将区域拆成若干张表和一组过滤条件，只涉及一张表的条件下推到取表数据算子，
+ * 然后枚举左深树形式的连接顺序：表的个数不超过 DP_TABLE_LIMIT 时使用动态规划找到代价最小的顺序，
+ * 否则使用贪心算法，每次选择连接代价最小的一张表。枚举时优先选择有连接条件的表，避免笛卡尔积。
+ * 每次连接时根据代价选择嵌套循环连接或者哈希连接，并把刚好可以计算的条件放在这次连接的上面。
+ * 表的行数和条件的选择率参考 CostModel。
+ */
+class JoinOrderOptimizer
+{
+public:
+  /// 使用动态规划枚举连接顺序时，最多有多少张表
+  static constexpr int DP_TABLE_LIMIT = 8;
+
+public:
+  JoinOrderOptimizer() = default;
+  virtual ~JoinOrderOptimizer() = default;
+
+  RC optimize(std::unique_ptr<LogicalOperator> &oper);
+
+private:
+  RC reorder(std::unique_ptr<LogicalOperator> &oper);
+};
@@ -85,6 +85,24 @@ RC LogicalPlanGenerator::create_plan(CalcStmt *calc_stmt, std::unique_ptr<Logica
   return RC::SUCCESS;
 }
 
+/**
+ * @brief 收集过滤条件中属于指定表的字段
+ */
+static void collect_filter_fields(FilterStmt *filter_stmt, Table *table, std::vector<Field> &fields)
+{
+  if (nullptr == filter_stmt) {
+    return;
+  }
+
+  for (const FilterUnit *filter_unit : filter_stmt->filter_units()) {
+    for (const FilterObj *filter_obj : {&filter_unit->left(), &filter_unit->right()}) {
+      if (filter_obj->is_attr && 0 == strcmp(filter_obj->field.table_name(), table->name())) {
+        fields.push_back(filter_obj->field);
+      }
+    }
+  }
+}
+
   // table_scan算子   table_scan算子
   //    where            where
   //                |
@@ -136,6 +154,11 @@ RC LogicalPlanGenerator::create_plan(
         }
       }
     }
+    // 过滤和连接条件中用到的字段也需要从表中读取，物理计划可以据此判断索引是否覆盖了查询
+    collect_filter_fields(filter_stmt, table, fields);
+    for (JoinStmt *join_stmt : join_stmts) {
+      collect_filter_fields(join_stmt->join_condition(), table, fields);
+    }
     // ================== table ================== //
     TableGetLogicalOperator *table_scan_oper = new TableGetLogicalOperator(table, fields, true/*readonly*/);
     #if 1
@@ -154,7 +177,7 @@ RC LogicalPlanGenerator::create_plan(
               ) ||
               (
                 ( !filter_obj_left.is_attr && filter_obj_right.is_attr) &&
-                ( 0 == strcmp(filter_obj_left.field.table_name(), table->name()))
+                ( 0 == strcmp(filter_obj_right.field.table_name(), table->name()))
               ) 
            ) {
           unique_ptr<Expression> left(filter_obj_left.is_attr
@@ -305,9 +328,9 @@ RC LogicalPlanGenerator::create_plan(
     InsertStmt *insert_stmt, unique_ptr<LogicalOperator> &logical_operator)
 {
   Table *table = insert_stmt->table();
-  vector<Value> values(insert_stmt->values(), insert_stmt->values() + insert_stmt->value_amount());
+  vector<vector<Value>> rows = insert_stmt->rows();
 
-  InsertLogicalOperator *insert_operator = new InsertLogicalOperator(table, values);
+  InsertLogicalOperator *insert_operator = new InsertLogicalOperator(table, std::move(rows));
   logical_operator.reset(insert_operator);
   return RC::SUCCESS;
 }
@@ -27,6 +27,7 @@ See the Mulan PSL v2 for more details. */
 #include "sql/stmt/stmt.h"
 #include "event/sql_event.h"
 #include "event/session_event.h"
+#include "session/session.h"
 
 using namespace std;
 using namespace common;
@@ -48,14 +49,15 @@ RC OptimizeStage::handle_request(SQLStageEvent *sql_event)
     return rc;
   }
   // DEBUG_PRINT("debug: 完成重写\n");
-  rc = optimize(logical_operator);  // do nothing
+  rc = optimize(logical_operator);
   if (rc != RC::SUCCESS) {
     LOG_WARN("failed to optimize plan. rc=%s", strrc(rc));
     return rc;
   }
 
   unique_ptr<PhysicalOperator> physical_operator;
-  rc = generate_physical_plan(logical_operator, physical_operator);
+  Session *session = sql_event->session_event()->session();
+  rc = generate_physical_plan(logical_operator, physical_operator, session->parallel_degree());
   if (rc != RC::SUCCESS) {
     LOG_WARN("failed to generate physical plan. rc=%s", strrc(rc));
     return rc;
@@ -68,17 +70,32 @@ RC OptimizeStage::handle_request(SQLStageEvent *sql_event)
 
 RC OptimizeStage::optimize(unique_ptr<LogicalOperator> &oper)
 {
-  // do nothing
-  return RC::SUCCESS;
+  RC rc = join_order_optimizer_.optimize(oper);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to optimize join order. rc=%s", strrc(rc));
+  }
+  return rc;
 }
 
 RC OptimizeStage::generate_physical_plan(
-    unique_ptr<LogicalOperator> &logical_operator, unique_ptr<PhysicalOperator> &physical_operator)
+    unique_ptr<LogicalOperator> &logical_operator, unique_ptr<PhysicalOperator> &physical_operator, int parallel_degree)
 {
   RC rc = RC::SUCCESS;
   rc = physical_plan_generator_.create(*logical_operator, physical_operator);
   if (rc != RC::SUCCESS) {
     LOG_WARN("failed to create physical operator. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  rc = parallel_planner_.parallelize(physical_operator, parallel_degree);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to parallelize physical operator. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  rc = slot_binder_.bind(*physical_operator);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to bind slots of physical operator. rc=%s", strrc(rc));
   }
   return rc;
 }
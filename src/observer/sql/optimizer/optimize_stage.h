@@ -19,9 +19,12 @@ See the Mulan PSL v2 for more details. */
 #include "common/rc.h"
 #include "sql/operator/logical_operator.h"
 #include "sql/operator/physical_operator.h"
+#include "sql/optimizer/join_order_optimizer.h"
 #include "sql/optimizer/logical_plan_generator.h"
+#include "sql/optimizer/parallel_planner.h"
 #include "sql/optimizer/physical_plan_generator.h"
 #include "sql/optimizer/rewriter.h"
+#include "sql/optimizer/slot_binder.h"
 
 class SQLStageEvent;
 class LogicalOperator;
@@ -59,7 +62,7 @@ private:
 
   /**
    * @brief 优化逻辑计划
-   * @details 当前什么都没做。可以增加每个逻辑计划的代价模型，然后根据代价模型进行优化。
+   * @details 根据代价模型选择多表连接的顺序和方法，参考 JoinOrderOptimizer。
    * @param logical_operator 需要优化的逻辑计划
    */
   RC optimize(std::unique_ptr<LogicalOperator> &logical_operator);
@@ -69,13 +72,19 @@ private:
    * @details 生成的物理计划就可以直接让后面的执行器完全按照物理计划执行了。
    * 物理计划与逻辑计划有些不同，逻辑计划描述要干什么，比如从某张表根据什么条件获取什么数据。
    * 而物理计划描述怎么做，比如如何从某张表按照什么条件获取什么数据，是否使用索引，使用哪个索引等。
+   * 生成之后，按照会话的并行度将大表的扫描改成并行扫描(参考 ParallelPlanner)，
+   * 再将计划中引用的字段绑定到元组中的位置，参考 SlotBinder。
    * @param physical_operator 生成的物理计划。通常是一个多叉树的形状，这里就拿着根节点就可以了。
+   * @param parallel_degree   并行度，1表示不并行
    */
-  RC generate_physical_plan(
-      std::unique_ptr<LogicalOperator> &logical_operator, std::unique_ptr<PhysicalOperator> &physical_operator);
+  RC generate_physical_plan(std::unique_ptr<LogicalOperator> &logical_operator,
+      std::unique_ptr<PhysicalOperator> &physical_operator, int parallel_degree);
 
 private:
   LogicalPlanGenerator  logical_plan_generator_;  ///< 根据SQL生成逻辑计划
   PhysicalPlanGenerator physical_plan_generator_; ///< 根据逻辑计划生成物理计划
   Rewriter              rewriter_;                ///< 逻辑计划改写
+  JoinOrderOptimizer    join_order_optimizer_;    ///< 选择连接顺序
+  ParallelPlanner       parallel_planner_;        ///< 将大表扫描改成并行扫描
+  SlotBinder            slot_binder_;             ///< 绑定字段在元组中的位置
 };
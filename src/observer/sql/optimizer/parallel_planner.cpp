@@ -0,0 +1,96 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "sql/optimizer/parallel_planner.h"
+#include "sql/expr/expression.h"
+#include "sql/operator/gather_physical_operator.h"
+#include "sql/operator/table_scan_physical_operator.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/table/table.h"
+#include "common/log/log.h"
+
+using namespace std;
+
+RC ParallelPlanner::parallelize(unique_ptr<PhysicalOperator> &oper, int parallel_degree)
+{
+#ifndef CONCURRENCY
+  // 没有打开 CONCURRENCY 时 buffer pool 等模块的锁都是空操作，多个线程同时扫描会出错
+  if (parallel_degree > 1) {
+    LOG_TRACE("parallel scan is disabled without CONCURRENCY. parallel_degree=%d", parallel_degree);
+    parallel_degree = 1;
+  }
+#endif
+
+  if (parallel_degree <= 1 || !oper) {
+    return RC::SUCCESS;
+  }
+
+  RC rc = RC::SUCCESS;
+  switch (oper->type()) {
+    case PhysicalOperatorType::TABLE_SCAN: {
+      auto &scan_oper = static_cast<TableScanPhysicalOperator &>(*oper);
+      if (scan_oper.table()->is_virtual()) {
+        break;
+      }
+      const int pages = scan_oper.table()->data_buffer_pool()->allocated_pages();
+      if (scan_oper.readonly() && pages >= MIN_PARALLEL_PAGES) {
+        rc = make_gather(scan_oper, parallel_degree, oper);
+      }
+    } break;
+
+    case PhysicalOperatorType::NESTED_LOOP_JOIN: {
+      // 右边会针对左边的每一行重新打开，只处理左边
+      if (!oper->children().empty()) {
+        rc = parallelize(oper->children().front(), parallel_degree);
+      }
+    } break;
+
+    default: {
+      for (unique_ptr<PhysicalOperator> &child : oper->children()) {
+        rc = parallelize(child, parallel_degree);
+        if (OB_FAIL(rc)) {
+          break;
+        }
+      }
+    } break;
+  }
+  return rc;
+}
+
+RC ParallelPlanner::make_gather(TableScanPhysicalOperator &scan_oper, int parallel_degree, unique_ptr<PhysicalOperator> &oper)
+{
+  Table *table = scan_oper.table();
+  auto gather_oper = make_unique<GatherPhysicalOperator>(table);
+
+  const double rows = scan_oper.has_estimate() ? scan_oper.estimated_rows() : 0;
+  const double cost = scan_oper.has_estimate() ? scan_oper.estimated_cost() : 0;
+  for (int i = 0; i < parallel_degree; i++) {
+    auto worker_scan_oper = make_unique<TableScanPhysicalOperator>(table, true/*readonly*/);
+
+    vector<unique_ptr<Expression>> predicates;
+    for (const unique_ptr<Expression> &expr : scan_oper.predicates()) {
+      predicates.emplace_back(expr->copy());
+    }
+    worker_scan_oper->set_predicates(std::move(predicates));
+    worker_scan_oper->set_morsel_queue(gather_oper->morsel_queue());
+    if (scan_oper.has_estimate()) {
+      worker_scan_oper->set_estimate(rows / parallel_degree, cost / parallel_degree);
+    }
+    gather_oper->add_child(std::move(worker_scan_oper));
+  }
+
+  if (scan_oper.has_estimate()) {
+    gather_oper->set_estimate(rows, cost / parallel_degree);
+  }
+
+  LOG_TRACE("parallel scan. table=%s, workers=%d", table->name(), parallel_degree);
+  oper = std::move(gather_oper);
+  return RC::SUCCESS;
+}
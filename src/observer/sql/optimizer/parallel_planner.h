@@ -0,0 +1,45 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <memory>
+
+#include "common/rc.h"
+#include "storage/record/record_manager.h"
+
+class PhysicalOperator;
+class TableScanPhysicalOperator;
+
+/**
+ * @brief 将物理计划中较大的表扫描改成并行扫描
+ * @ingroup PhysicalOperator
+ * @details 并行度由会话变量 parallel_degree 指定(SET parallel_degree=4)，默认为1，即不并行。
+ * 只读的全表扫描，如果表中的页面足够多，就替换成 GatherPhysicalOperator，下面挂 parallel_degree 个
+ * 相同的扫描算子，每个扫描算子在一个工作线程中执行。
+ * 嵌套循环连接的右边每一行都会重新打开一次，不做并行。
+ * 聚合和哈希连接会识别下面的 GatherPhysicalOperator，在工作线程中直接做部分聚合和构建哈希表。
+ * 编译时没有打开 CONCURRENCY 时不做并行，并行度总是当作1。
+ */
+class ParallelPlanner
+{
+public:
+  static constexpr int MAX_PARALLEL_DEGREE = 64;
+  static constexpr int MIN_PARALLEL_PAGES  = 2 * MorselQueue::MORSEL_PAGES;  ///< 页面太少时并行没有意义
+
+public:
+  ParallelPlanner() = default;
+  virtual ~ParallelPlanner() = default;
+
+  RC parallelize(std::unique_ptr<PhysicalOperator> &oper, int parallel_degree);
+
+private:
+  RC make_gather(TableScanPhysicalOperator &scan_oper, int parallel_degree, std::unique_ptr<PhysicalOperator> &oper);
+};
@@ -12,9 +12,11 @@ See the Mulan PSL v2 for more details. */
 // Created by Wangyunlai on 2022/12/14.
 //
 
+#include <algorithm>
 #include <utility>
 
 #include "sql/optimizer/physical_plan_generator.h"
+#include "sql/optimizer/cost_model.h"
 #include "sql/operator/table_get_logical_operator.h"
 #include "sql/operator/table_scan_physical_operator.h"
 #include "sql/operator/index_scan_physical_operator.h"
@@ -34,9 +36,12 @@ See the Mulan PSL v2 for more details. */
 #include "sql/operator/explain_physical_operator.h"
 #include "sql/operator/join_logical_operator.h"
 #include "sql/operator/join_physical_operator.h"
+#include "sql/operator/hash_join_physical_operator.h"
 #include "sql/operator/calc_logical_operator.h"
 #include "sql/operator/calc_physical_operator.h"
 #include "sql/expr/expression.h"
+#include "storage/index/index.h"
+#include "storage/table/table.h"
 #include "common/log/log.h"
 
 using namespace std;
@@ -116,68 +121,282 @@ RC PhysicalPlanGenerator::create_plan(AggregationLogicalOperator &aggr_oper, uni
 
   vector<Expression*> &expressions = aggr_oper.select_exprs();
   oper = unique_ptr<PhysicalOperator>(new AggrPhysicalOperator(expressions));
+  if (child_phy_oper->has_estimate()) {
+    oper->set_estimate(1, child_phy_oper->estimated_cost());
+  }
   oper->add_child(std::move(child_phy_oper));
   return rc;
 }
 
-RC PhysicalPlanGenerator::create_plan(TableGetLogicalOperator &table_get_oper, unique_ptr<PhysicalOperator> &oper)
+/**
+ * @brief 某个字段上可以用于索引扫描的取值范围
+ * @details 由多个 字段 op 常量 的条件合并而来，多个条件之间是AND关系
+ */
+struct ColumnRange
+{
+  const FieldMeta *field = nullptr;
+
+  bool  has_equal = false;
+  Value equal_value;
+
+  bool  has_lower = false;
+  bool  lower_inclusive = false;
+  Value lower_value;
+
+  bool  has_upper = false;
+  bool  upper_inclusive = false;
+  Value upper_value;
+
+  void add_condition(CompOp comp, const Value &value)
+  {
+    switch (comp) {
+      case EQUAL_TO: {
+        has_equal = true;
+        equal_value = value;
+      } break;
+      case GREAT_THAN:
+      case GREAT_EQUAL: {
+        const bool inclusive = (comp == GREAT_EQUAL);
+        const int cmp = has_lower ? value.compare(lower_value) : 1;
+        if (cmp > 0 || (cmp == 0 && !inclusive)) {
+          has_lower = true;
+          lower_value = value;
+          lower_inclusive = inclusive;
+        }
+      } break;
+      case LESS_THAN:
+      case LESS_EQUAL: {
+        const bool inclusive = (comp == LESS_EQUAL);
+        const int cmp = has_upper ? value.compare(upper_value) : -1;
+        if (cmp < 0 || (cmp == 0 && !inclusive)) {
+          has_upper = true;
+          upper_value = value;
+          upper_inclusive = inclusive;
+        }
+      } break;
+      default: {
+      } break;
+    }
+  }
+};
+
+/**
+ * @brief 一个可选的索引扫描方案
+ */
+struct IndexScanCandidate
+{
+  Index *index = nullptr;
+  std::vector<Value> left_values;
+  std::vector<Value> right_values;
+  bool left_inclusive = true;
+  bool right_inclusive = true;
+  double selectivity = 1.0;
+  bool index_only = false;  ///< 索引是否覆盖了查询需要的所有字段
+};
+
+/**
+ * @brief 如果谓词是 字段 op 常量 的形式，就返回字段、常量，以及将字段放在左边时的比较符
+ */
+static bool extract_column_condition(Expression *expr, FieldExpr *&field_expr, ValueExpr *&value_expr, CompOp &comp)
+{
+  if (expr->type() != ExprType::COMPARISON) {
+    return false;
+  }
+
+  auto comparison_expr = static_cast<ComparisonExpr *>(expr);
+  comp = comparison_expr->comp();
+  unique_ptr<Expression> &left_expr = comparison_expr->left();
+  unique_ptr<Expression> &right_expr = comparison_expr->right();
+  if (left_expr->type() == ExprType::FIELD && right_expr->type() == ExprType::VALUE) {
+    field_expr = static_cast<FieldExpr *>(left_expr.get());
+    value_expr = static_cast<ValueExpr *>(right_expr.get());
+  } else if (left_expr->type() == ExprType::VALUE && right_expr->type() == ExprType::FIELD) {
+    field_expr = static_cast<FieldExpr *>(right_expr.get());
+    value_expr = static_cast<ValueExpr *>(left_expr.get());
+    // 常量在左边，需要翻转比较符
+    switch (comp) {
+      case LESS_THAN:   comp = GREAT_THAN;  break;
+      case LESS_EQUAL:  comp = GREAT_EQUAL; break;
+      case GREAT_THAN:  comp = LESS_THAN;   break;
+      case GREAT_EQUAL: comp = LESS_EQUAL;  break;
+      default: break;
+    }
+  } else {
+    return false;
+  }
+
+  switch (comp) {
+    case EQUAL_TO:
+    case LESS_THAN:
+    case LESS_EQUAL:
+    case GREAT_THAN:
+    case GREAT_EQUAL: break;
+    default: return false;
+  }
+
+  // 类型不同的比较需要做类型转换，不能直接用来构造索引键值
+  const Value &value = value_expr->get_value();
+  const FieldMeta *field_meta = field_expr->field().meta();
+  if (value.attr_type() != field_meta->type()) {
+    return false;
+  }
+  if (value.attr_type() == CHARS && value.length() > field_meta->len()) {
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief 使用索引字段的最长前缀匹配谓词，生成扫描范围
+ * @details 前缀中的字段都是等值条件，最后一个字段可以是范围条件
+ */
+static bool match_index(Table *table, Index *index, const std::vector<ColumnRange> &ranges, IndexScanCandidate &candidate)
+{
+  candidate.index = index;
+  for (const FieldMeta &field_meta : index->field_metas()) {
+    const ColumnRange *range = nullptr;
+    for (const ColumnRange &column_range : ranges) {
+      if (0 == strcmp(column_range.field->name(), field_meta.name())) {
+        range = &column_range;
+        break;
+      }
+    }
+    if (nullptr == range) {
+      break;
+    }
+
+    if (range->has_equal) {
+      candidate.left_values.push_back(range->equal_value);
+      candidate.right_values.push_back(range->equal_value);
+      candidate.selectivity *= CostModel::equal_selectivity(table, range->field, range->equal_value);
+      continue;
+    }
+
+    if (range->has_lower) {
+      candidate.left_values.push_back(range->lower_value);
+      candidate.left_inclusive = range->lower_inclusive;
+    }
+    if (range->has_upper) {
+      candidate.right_values.push_back(range->upper_value);
+      candidate.right_inclusive = range->upper_inclusive;
+    }
+    // 没有统计信息时按照整个表都在范围内估算，参考 CostModel::has_column_stats
+    if (CostModel::has_column_stats(table, range->field)) {
+      candidate.selectivity *= CostModel::range_selectivity(table, range->field, 
+          range->has_lower ? &range->lower_value : nullptr, range->lower_inclusive,
+          range->has_upper ? &range->upper_value : nullptr, range->upper_inclusive);
+    }
+    break;
+  }
+
+  return !candidate.left_values.empty() || !candidate.right_values.empty();
+}
+
+/**
+ * @brief 索引是否包含了查询需要从表中读取的所有字段
+ */
+static bool index_covers(Index *index, const std::vector<Field> &fields)
+{
+  const std::vector<FieldMeta> &index_fields = index->field_metas();
+  for (const Field &field : fields) {
+    // count(*) 不需要读取任何字段
+    if (0 == strcmp(field.field_name(), "*")) {
+      continue;
+    }
+
+    auto iter = std::find_if(index_fields.begin(), index_fields.end(), 
+                             [&field](const FieldMeta &field_meta) { return 0 == strcmp(field_meta.name(), field.field_name()); });
+    if (iter == index_fields.end()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief 为表选择访问路径
+ * @details 在所有可用的索引中，选择代价最小的一个，并与全表扫描的代价做比较
+ * @param best_candidate[out] 选中的索引扫描方案，全表扫描时index为空
+ * @param best_cost[out]      选中方案的代价
+ */
+static void choose_access_path(TableGetLogicalOperator &table_get_oper, IndexScanCandidate &best_candidate, double &best_cost)
 {
   vector<unique_ptr<Expression>> &predicates = table_get_oper.predicates();
   // 看看是否有可以用于索引查找的表达式
   Table *table = table_get_oper.table();
 
-  Index *index = nullptr;
-  ValueExpr *value_expr = nullptr;
+  // 收集每个字段上的取值范围
+  std::vector<ColumnRange> ranges;
   for (auto &expr : predicates) {
-    if (expr->type() == ExprType::COMPARISON) {
-      auto comparison_expr = static_cast<ComparisonExpr *>(expr.get());
-      // 简单处理，就找等值查询
-      if (comparison_expr->comp() != EQUAL_TO) {
-        continue;
-      }
-
-      unique_ptr<Expression> &left_expr = comparison_expr->left();
-      unique_ptr<Expression> &right_expr = comparison_expr->right();
-      // 左右比较的一边最少是一个值
-      if (left_expr->type() != ExprType::VALUE && right_expr->type() != ExprType::VALUE) {
-        continue;
-      }
+    FieldExpr *field_expr = nullptr;
+    ValueExpr *value_expr = nullptr;
+    CompOp comp = NO_OP;
+    if (!extract_column_condition(expr.get(), field_expr, value_expr, comp)) {
+      continue;
+    }
 
-      FieldExpr *field_expr = nullptr;
-      if (left_expr->type() == ExprType::FIELD) {
-        ASSERT(right_expr->type() == ExprType::VALUE, "right expr should be a value expr while left is field expr");
-        field_expr = static_cast<FieldExpr *>(left_expr.get());
-        value_expr = static_cast<ValueExpr *>(right_expr.get());
-      } else if (right_expr->type() == ExprType::FIELD) {
-        ASSERT(left_expr->type() == ExprType::VALUE, "left expr should be a value expr while right is a field expr");
-        field_expr = static_cast<FieldExpr *>(right_expr.get());
-        value_expr = static_cast<ValueExpr *>(left_expr.get());
-      }
+    const FieldMeta *field_meta = field_expr->field().meta();
+    auto iter = std::find_if(ranges.begin(), ranges.end(), 
+                             [field_meta](const ColumnRange &range) { return range.field == field_meta; });
+    if (iter == ranges.end()) {
+      ranges.emplace_back();
+      iter = ranges.end() - 1;
+      iter->field = field_meta;
+    }
+    iter->add_condition(comp, value_expr->get_value());
+  }
 
-      if (field_expr == nullptr) {
+  const double rows = CostModel::table_rows(table);
+  best_cost = CostModel::table_scan_cost(rows);
+  if (!ranges.empty()) {
+    const TableMeta &table_meta = table->table_meta();
+    for (int i = 0; i < table_meta.index_num(); i++) {
+      Index *index = table->find_index(table_meta.index(i)->name());
+      IndexScanCandidate candidate;
+      if (nullptr == index || !match_index(table, index, ranges, candidate)) {
         continue;
       }
 
-      const Field &field = field_expr->field();
-      std::vector<const char*> fields_name;
-      fields_name.push_back(field.field_name());
-      index = table->find_index_by_field(fields_name);
-      if (nullptr != index) {
-        break;
+      // 只读查询需要的字段都在索引中时，可以只扫描索引
+      candidate.index_only = table_get_oper.readonly() && index_covers(index, table_get_oper.fields());
+      const double cost = candidate.index_only ? CostModel::index_only_scan_cost(rows, candidate.selectivity)
+                                               : CostModel::index_scan_cost(rows, candidate.selectivity);
+      LOG_TRACE("index scan candidate. index=%s, selectivity=%lf, index only=%d, cost=%lf", 
+                index->index_meta().name(), candidate.selectivity, candidate.index_only, cost);
+      if (cost < best_cost) {
+        best_cost = cost;
+        best_candidate = std::move(candidate);
       }
     }
   }
+}
+
+void PhysicalPlanGenerator::estimate(TableGetLogicalOperator &table_get_oper, double &rows, double &cost)
+{
+  IndexScanCandidate candidate;
+  choose_access_path(table_get_oper, candidate, cost);
+  rows = CostModel::table_rows(table_get_oper.table()) * CostModel::selectivity(table_get_oper.predicates());
+}
+
+RC PhysicalPlanGenerator::create_plan(TableGetLogicalOperator &table_get_oper, unique_ptr<PhysicalOperator> &oper)
+{
+  vector<unique_ptr<Expression>> &predicates = table_get_oper.predicates();
+  Table *table = table_get_oper.table();
 
-  if (index != nullptr) {
-    ASSERT(value_expr != nullptr, "got an index but value expr is null ?");
+  IndexScanCandidate best_candidate;
+  double best_cost = 0;
+  choose_access_path(table_get_oper, best_candidate, best_cost);
+  const double rows = CostModel::table_rows(table) * CostModel::selectivity(predicates);
 
-    const Value &value = value_expr->get_value();
+  if (best_candidate.index != nullptr) {
     IndexScanPhysicalOperator *index_scan_oper = new IndexScanPhysicalOperator(
-          table, index, table_get_oper.readonly(), 
-          &value, true /*left_inclusive*/, 
-          &value, true /*right_inclusive*/);
-          
+          table, best_candidate.index, table_get_oper.readonly(), 
+          std::move(best_candidate.left_values), best_candidate.left_inclusive, 
+          std::move(best_candidate.right_values), best_candidate.right_inclusive);
+
+    // 扫描范围只是用来减少需要访问的数据，仍然需要使用所有的谓词做过滤
     index_scan_oper->set_predicates(std::move(predicates));
+    index_scan_oper->set_index_only(best_candidate.index_only);
     oper = unique_ptr<PhysicalOperator>(index_scan_oper);
     LOG_TRACE("use index scan");
   } else {
@@ -187,6 +406,7 @@ RC PhysicalPlanGenerator::create_plan(TableGetLogicalOperator &table_get_oper, u
     LOG_TRACE("use table scan");
   }
 
+  oper->set_estimate(rows, best_cost);
   return RC::SUCCESS;
 }
 
@@ -208,7 +428,11 @@ RC PhysicalPlanGenerator::create_plan(PredicateLogicalOperator &pred_oper, uniqu
   ASSERT(expressions.size() == 1, "predicate logical operator's children should be 1");
 
   unique_ptr<Expression> expression = std::move(expressions.front());
+  const double selectivity = CostModel::selectivity(expression.get());
   oper = unique_ptr<PhysicalOperator>(new PredicatePhysicalOperator(std::move(expression)));
+  if (child_phy_oper->has_estimate()) {
+    oper->set_estimate(child_phy_oper->estimated_rows() * selectivity, child_phy_oper->estimated_cost());
+  }
   oper->add_child(std::move(child_phy_oper));
   return rc;
 }
@@ -253,6 +477,9 @@ RC PhysicalPlanGenerator::create_plan(ProjectLogicalOperator &project_oper, uniq
   // ---modify--- //
 
   if (child_phy_oper) {
+    if (child_phy_oper->has_estimate()) {
+      project_operator->set_estimate(child_phy_oper->estimated_rows(), child_phy_oper->estimated_cost());
+    }
     project_operator->add_child(std::move(child_phy_oper));
   }
 
@@ -265,8 +492,8 @@ RC PhysicalPlanGenerator::create_plan(ProjectLogicalOperator &project_oper, uniq
 RC PhysicalPlanGenerator::create_plan(InsertLogicalOperator &insert_oper, unique_ptr<PhysicalOperator> &oper)
 {
   Table *table = insert_oper.table();
-  vector<Value> &values = insert_oper.values();
-  InsertPhysicalOperator *insert_phy_oper = new InsertPhysicalOperator(table, std::move(values));
+  vector<vector<Value>> &rows = insert_oper.rows();
+  InsertPhysicalOperator *insert_phy_oper = new InsertPhysicalOperator(table, std::move(rows));
   oper.reset(insert_phy_oper);
   return RC::SUCCESS;
 }
@@ -354,7 +581,15 @@ RC PhysicalPlanGenerator::create_plan(JoinLogicalOperator &join_oper, unique_ptr
     return RC::INTERNAL;
   }
 
-  unique_ptr<PhysicalOperator> join_physical_oper(new NestedLoopJoinPhysicalOperator);
+  unique_ptr<PhysicalOperator> join_physical_oper;
+  if (join_oper.method() == JoinMethod::HASH && child_opers[1]->type() == LogicalOperatorType::TABLE_GET) {
+    Table *right_table = static_cast<TableGetLogicalOperator *>(child_opers[1].get())->table();
+    join_physical_oper.reset(
+        new HashJoinPhysicalOperator(right_table, std::move(join_oper.left_keys()), std::move(join_oper.right_keys())));
+  } else {
+    join_physical_oper.reset(new NestedLoopJoinPhysicalOperator);
+  }
+
   for (auto &child_oper : child_opers) {
     unique_ptr<PhysicalOperator> child_physical_oper;
     rc = create(*child_oper, child_physical_oper);
@@ -366,6 +601,16 @@ RC PhysicalPlanGenerator::create_plan(JoinLogicalOperator &join_oper, unique_ptr
     join_physical_oper->add_child(std::move(child_physical_oper));
   }
 
+  PhysicalOperator *left = join_physical_oper->children()[0].get();
+  PhysicalOperator *right = join_physical_oper->children()[1].get();
+  if (left->has_estimate() && right->has_estimate()) {
+    const double rows = left->estimated_rows() * right->estimated_rows();
+    const double cost = join_physical_oper->type() == PhysicalOperatorType::HASH_JOIN
+        ? CostModel::hash_join_cost(left->estimated_rows(), left->estimated_cost(), right->estimated_rows(), right->estimated_cost())
+        : CostModel::nested_loop_join_cost(left->estimated_rows(), left->estimated_cost(), right->estimated_cost());
+    join_physical_oper->set_estimate(rows, cost);
+  }
+
   oper = std::move(join_physical_oper);
   return rc;
 }
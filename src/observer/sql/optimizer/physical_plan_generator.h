@@ -35,7 +35,9 @@ class AggregationLogicalOperator;
  * @brief 物理计划生成器
  * @ingroup PhysicalOperator
  * @details 根据逻辑计划生成物理计划。
- * 不会做任何优化，完全根据本意生成物理计划。
+ * 除了根据 CostModel 为表选择访问路径(全表扫描或某个索引上的范围扫描)以外，
+ * 不会做其它优化，完全根据本意生成物理计划。连接的顺序和方法由 JoinOrderOptimizer 在逻辑计划上决定。
+ * 生成的物理算子上会记录估算的行数和代价，在explain中展示。
  */
 class PhysicalPlanGenerator 
 {
@@ -45,6 +47,11 @@ public:
 
   RC create(LogicalOperator &logical_operator, std::unique_ptr<PhysicalOperator> &oper);
 
+  /**
+   * @brief 估算从表中获取数据的输出行数和代价，与生成物理计划时选择的访问路径一致
+   */
+  static void estimate(TableGetLogicalOperator &table_get_oper, double &rows, double &cost);
+
 private:
   RC create_plan(TableGetLogicalOperator &logical_oper, std::unique_ptr<PhysicalOperator> &oper);
   RC create_plan(PredicateLogicalOperator &logical_oper, std::unique_ptr<PhysicalOperator> &oper);
@@ -0,0 +1,196 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string.h>
+
+#include "sql/optimizer/slot_binder.h"
+#include "sql/expr/expression.h"
+#include "sql/operator/aggr_physical_operatior.h"
+#include "sql/operator/gather_physical_operator.h"
+#include "sql/operator/hash_join_physical_operator.h"
+#include "sql/operator/index_scan_physical_operator.h"
+#include "sql/operator/predicate_physical_operator.h"
+#include "sql/operator/project_physical_operator.h"
+#include "sql/operator/table_scan_physical_operator.h"
+#include "storage/table/table.h"
+#include "common/log/log.h"
+
+using namespace std;
+
+/**
+ * @brief 扫描算子输出的元组结构，与 RowTuple::set_schema 一致
+ */
+static void table_schema(Table *table, vector<Field> &schema)
+{
+  for (const FieldMeta &field_meta : *table->table_meta().field_metas()) {
+    schema.emplace_back(table, &field_meta);
+  }
+}
+
+RC SlotBinder::bind(PhysicalOperator &oper)
+{
+  vector<Field> schema;
+  bool schema_known = false;
+  return bind_operator(oper, schema, schema_known);
+}
+
+RC SlotBinder::bind_operator(PhysicalOperator &oper, vector<Field> &schema, bool &schema_known)
+{
+  schema.clear();
+  schema_known = false;
+
+  // 先绑定子算子，得到子算子输出的元组结构
+  vector<vector<Field>> child_schemas(oper.children().size());
+  vector<bool> child_known(oper.children().size(), false);
+  for (size_t i = 0; i < oper.children().size(); i++) {
+    bool known = false;
+    RC rc = bind_operator(*oper.children()[i], child_schemas[i], known);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    child_known[i] = known;
+  }
+
+  switch (oper.type()) {
+    case PhysicalOperatorType::TABLE_SCAN: {
+      auto &scan_oper = static_cast<TableScanPhysicalOperator &>(oper);
+      table_schema(scan_oper.table(), schema);
+      for (unique_ptr<Expression> &expr : scan_oper.predicates()) {
+        bind_expression(expr.get(), schema);
+      }
+      schema_known = true;
+    } break;
+
+    case PhysicalOperatorType::INDEX_SCAN:
+    case PhysicalOperatorType::INDEX_ONLY_SCAN: {
+      auto &scan_oper = static_cast<IndexScanPhysicalOperator &>(oper);
+      table_schema(scan_oper.table(), schema);
+      for (unique_ptr<Expression> &expr : scan_oper.predicates()) {
+        bind_expression(expr.get(), schema);
+      }
+      schema_known = true;
+    } break;
+
+    case PhysicalOperatorType::GATHER: {
+      // 输出的是子算子扫描出来的记录
+      table_schema(static_cast<GatherPhysicalOperator &>(oper).table(), schema);
+      schema_known = true;
+    } break;
+
+    case PhysicalOperatorType::NESTED_LOOP_JOIN:
+    case PhysicalOperatorType::HASH_JOIN: {
+      if (child_schemas.size() != 2) {
+        break;
+      }
+      if (oper.type() == PhysicalOperatorType::HASH_JOIN) {
+        auto &join_oper = static_cast<HashJoinPhysicalOperator &>(oper);
+        for (unique_ptr<Expression> &expr : join_oper.left_keys()) {
+          if (child_known[0]) {
+            bind_expression(expr.get(), child_schemas[0]);
+          }
+        }
+        for (unique_ptr<Expression> &expr : join_oper.right_keys()) {
+          if (child_known[1]) {
+            bind_expression(expr.get(), child_schemas[1]);
+          }
+        }
+      }
+
+      // JoinedTuple 中左边的字段在前，右边的字段在后
+      schema_known = child_known[0] && child_known[1];
+      if (schema_known) {
+        schema = std::move(child_schemas[0]);
+        schema.insert(schema.end(), child_schemas[1].begin(), child_schemas[1].end());
+      }
+    } break;
+
+    case PhysicalOperatorType::PREDICATE: {
+      auto &predicate_oper = static_cast<PredicatePhysicalOperator &>(oper);
+      if (child_schemas.size() == 1 && child_known[0]) {
+        bind_expression(predicate_oper.expression().get(), child_schemas[0]);
+        schema = std::move(child_schemas[0]);
+        schema_known = true;
+      }
+    } break;
+
+    case PhysicalOperatorType::PROJECT: {
+      auto &project_oper = static_cast<ProjectPhysicalOperator &>(oper);
+      if (child_schemas.size() == 1 && child_known[0]) {
+        ProjectTuple &tuple = project_oper.project_tuple();
+        for (int i = 0; i < tuple.cell_num(); i++) {
+          const TupleCellSpec &spec = tuple.cell_spec(i);
+          tuple.set_slot(i, find_slot(child_schemas[0], spec.table_name(), spec.field_name()));
+        }
+      }
+    } break;
+
+    case PhysicalOperatorType::AGGR_PHYSICAL_T: {
+      auto &aggr_oper = static_cast<AggrPhysicalOperator &>(oper);
+      if (child_schemas.size() == 1 && child_known[0]) {
+        for (Expression *expr : aggr_oper.expressions()) {
+          bind_expression(expr, child_schemas[0]);
+        }
+      }
+    } break;
+
+    default: {
+    } break;
+  }
+  return RC::SUCCESS;
+}
+
+int SlotBinder::find_slot(const vector<Field> &schema, const char *table_name, const char *field_name)
+{
+  // 与 JoinedTuple::find_cell 一样，有同名字段时使用左边的
+  for (size_t i = 0; i < schema.size(); i++) {
+    const Field &field = schema[i];
+    if (0 == strcmp(field.table_name(), table_name) && 0 == strcmp(field.field_name(), field_name)) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+void SlotBinder::bind_expression(Expression *expr, const vector<Field> &schema)
+{
+  if (nullptr == expr) {
+    return;
+  }
+
+  switch (expr->type()) {
+    case ExprType::FIELD: {
+      auto field_expr = static_cast<FieldExpr *>(expr);
+      field_expr->set_slot(find_slot(schema, field_expr->table_name(), field_expr->field_name()));
+    } break;
+    case ExprType::CAST: {
+      bind_expression(static_cast<CastExpr *>(expr)->child().get(), schema);
+    } break;
+    case ExprType::COMPARISON: {
+      auto comparison_expr = static_cast<ComparisonExpr *>(expr);
+      bind_expression(comparison_expr->left().get(), schema);
+      bind_expression(comparison_expr->right().get(), schema);
+    } break;
+    case ExprType::CONJUNCTION: {
+      for (unique_ptr<Expression> &child : static_cast<ConjunctionExpr *>(expr)->children()) {
+        bind_expression(child.get(), schema);
+      }
+    } break;
+    case ExprType::ARITHMETIC: {
+      auto arithmetic_expr = static_cast<ArithmeticExpr *>(expr);
+      bind_expression(arithmetic_expr->left().get(), schema);
+      bind_expression(arithmetic_expr->right().get(), schema);
+    } break;
+    case ExprType::AGGREGATION: {
+      bind_expression(static_cast<AggregationExpr *>(expr)->field_expr(), schema);
+    } break;
+    default: {
+    } break;
+  }
+}
@@ -0,0 +1,48 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <vector>
+
+#include "common/rc.h"
+#include "storage/field/field.h"
+
+class Expression;
+class PhysicalOperator;
+
+/**
+ * @brief 将物理计划中引用的字段绑定到元组中的位置
+ * @ingroup PhysicalOperator
+ * @details 执行时，表达式中的字段和投影的字段默认按照表名和字段名在元组中查找，每一行每个字段都要做若干次字符串比较。
+ * 生成物理计划后，每个算子输出的元组结构就确定了：扫描算子输出表的所有字段，连接算子输出左边的字段后面跟着右边的字段，
+ * 过滤算子与下层相同。这里自底向上计算每个算子的输出结构，并将字段绑定到位置(FieldExpr::set_slot、ProjectTuple::set_slot)，
+ * 执行时直接使用 Tuple::cell_at 按照位置取值。
+ * 输出结构无法确定的算子(比如聚合)，上层的字段不做绑定，仍然按照名字查找。
+ */
+class SlotBinder
+{
+public:
+  SlotBinder() = default;
+  virtual ~SlotBinder() = default;
+
+  RC bind(PhysicalOperator &oper);
+
+private:
+  /**
+   * @brief 绑定算子及其子算子中的字段
+   * @param schema[out]       算子输出的元组中每个位置的字段
+   * @param schema_known[out] 是否可以确定算子输出的元组结构
+   */
+  RC bind_operator(PhysicalOperator &oper, std::vector<Field> &schema, bool &schema_known);
+
+  static void bind_expression(Expression *expr, const std::vector<Field> &schema);
+  static int  find_slot(const std::vector<Field> &schema, const char *table_name, const char *field_name);
+};
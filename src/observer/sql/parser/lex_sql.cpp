@@ -689,6 +689,7 @@ static const flex_int16_t yy_chk[627] =
 
 #include "sql/parser/parse_defs.h"
 #include "common/log/log.h"
+#include "common/mm/arena.h"
 #include "yacc_sql.hpp"
 
 #ifndef register
@@ -702,7 +703,33 @@ date str_to_date(char * s); // new
 bool is_leap_year(unsigned year);
 
 #define RETURN_TOKEN(token) LOG_DEBUG("%s", #token);return token
-#line 706 "lex_sql.cpp"
+
+/**
+ * @brief 不保留的关键字
+ * @details 这些关键字不单独写规则，匹配 {ID} 之后再识别，这样语法中还可以把它们当作名字使用
+ * (参考 yacc_sql.y 中的 identifier)，所以 yylval 中同样保存了原始的文本
+ */
+static const struct {
+  const char *word;
+  int         token;
+} NON_RESERVED_KEYWORDS[] = {
+  {"ANALYZE", ANALYZE},
+  {"RESET", RESET},
+};
+
+static int id_or_keyword(const char *text, int len, YYSTYPE *yylval, void *arena)
+{
+  yylval->string = static_cast<common::Arena *>(arena)->dup(text, len);
+  for (const auto &keyword : NON_RESERVED_KEYWORDS) {
+    if (0 == strcasecmp(text, keyword.word)) {
+      LOG_DEBUG("%s", keyword.word);
+      return keyword.token;
+    }
+  }
+  LOG_DEBUG("ID");
+  return ID;
+}
+#line 733 "lex_sql.cpp"
 /* Prevent the need for linking with -lfl */
 #define YY_NO_INPUT 1
 /* 不区分大小写 */
@@ -711,7 +738,7 @@ bool is_leap_year(unsigned year);
 /* 1. 匹配的规则长的优先 */
 /* 2. 写在最前面的优先 */
 /* yylval 就可以认为是 yacc 中 %union 定义的结构体(union 结构) */
-#line 715 "lex_sql.cpp"
+#line 742 "lex_sql.cpp"
 
 #define INITIAL 0
 #define STR 1
@@ -994,10 +1021,10 @@ YY_DECL
 		}
 
 	{
-#line 78 "lex_sql.l"
+#line 105 "lex_sql.l"
 
 
-#line 1001 "lex_sql.cpp"
+#line 1028 "lex_sql.cpp"
 
 	while ( /*CONSTCOND*/1 )		/* loops until end-of-file is reached */
 		{
@@ -1056,344 +1083,344 @@ do_action:	/* This label is used only to access EOF actions. */
 
 case 1:
 YY_RULE_SETUP
-#line 80 "lex_sql.l"
+#line 107 "lex_sql.l"
 // ignore whitespace
 	YY_BREAK
 case 2:
 /* rule 2 can match eol */
 YY_RULE_SETUP
-#line 81 "lex_sql.l"
+#line 108 "lex_sql.l"
 ;
 	YY_BREAK
 case 3:
 YY_RULE_SETUP
-#line 83 "lex_sql.l"
+#line 110 "lex_sql.l"
 yylval->number=atoi(yytext); RETURN_TOKEN(NUMBER);
 	YY_BREAK
 case 4:
 YY_RULE_SETUP
-#line 84 "lex_sql.l"
+#line 111 "lex_sql.l"
 yylval->floats=(float)(atof(yytext)); RETURN_TOKEN(FLOAT);
 	YY_BREAK
 case 5:
 YY_RULE_SETUP
-#line 86 "lex_sql.l"
+#line 113 "lex_sql.l"
 RETURN_TOKEN(SEMICOLON);
 	YY_BREAK
 case 6:
 YY_RULE_SETUP
-#line 87 "lex_sql.l"
+#line 114 "lex_sql.l"
 RETURN_TOKEN(DOT);
 	YY_BREAK
 case 7:
 YY_RULE_SETUP
-#line 88 "lex_sql.l"
+#line 115 "lex_sql.l"
 RETURN_TOKEN(EXIT);
 	YY_BREAK
 case 8:
 YY_RULE_SETUP
-#line 89 "lex_sql.l"
+#line 116 "lex_sql.l"
 RETURN_TOKEN(HELP);
 	YY_BREAK
 case 9:
 YY_RULE_SETUP
-#line 90 "lex_sql.l"
+#line 117 "lex_sql.l"
 RETURN_TOKEN(DESC);
 	YY_BREAK
 case 10:
 YY_RULE_SETUP
-#line 91 "lex_sql.l"
+#line 118 "lex_sql.l"
 RETURN_TOKEN(CREATE);
 	YY_BREAK
 case 11:
 YY_RULE_SETUP
-#line 92 "lex_sql.l"
+#line 119 "lex_sql.l"
 RETURN_TOKEN(DROP);
 	YY_BREAK
 case 12:
 YY_RULE_SETUP
-#line 93 "lex_sql.l"
+#line 120 "lex_sql.l"
 RETURN_TOKEN(TABLE);
 	YY_BREAK
 case 13:
 YY_RULE_SETUP
-#line 94 "lex_sql.l"
+#line 121 "lex_sql.l"
 RETURN_TOKEN(TABLES);
 	YY_BREAK
 case 14:
 YY_RULE_SETUP
-#line 95 "lex_sql.l"
+#line 122 "lex_sql.l"
 RETURN_TOKEN(INDEX);
 	YY_BREAK
 case 15:
 YY_RULE_SETUP
-#line 96 "lex_sql.l"
+#line 123 "lex_sql.l"
 RETURN_TOKEN(ON);
 	YY_BREAK
 case 16:
 YY_RULE_SETUP
-#line 97 "lex_sql.l"
+#line 124 "lex_sql.l"
 RETURN_TOKEN(SHOW);
 	YY_BREAK
 case 17:
 YY_RULE_SETUP
-#line 98 "lex_sql.l"
+#line 125 "lex_sql.l"
 RETURN_TOKEN(SYNC);
 	YY_BREAK
 case 18:
 YY_RULE_SETUP
-#line 99 "lex_sql.l"
+#line 126 "lex_sql.l"
 RETURN_TOKEN(SELECT);
 	YY_BREAK
 case 19:
 YY_RULE_SETUP
-#line 100 "lex_sql.l"
+#line 127 "lex_sql.l"
 RETURN_TOKEN(CALC);
 	YY_BREAK
 case 20:
 YY_RULE_SETUP
-#line 101 "lex_sql.l"
+#line 128 "lex_sql.l"
 RETURN_TOKEN(FROM);
 	YY_BREAK
 case 21:
 YY_RULE_SETUP
-#line 102 "lex_sql.l"
+#line 129 "lex_sql.l"
 RETURN_TOKEN(WHERE);
 	YY_BREAK
 case 22:
 YY_RULE_SETUP
-#line 103 "lex_sql.l"
+#line 130 "lex_sql.l"
 RETURN_TOKEN(AND);
 	YY_BREAK
 case 23:
 YY_RULE_SETUP
-#line 104 "lex_sql.l"
+#line 131 "lex_sql.l"
 RETURN_TOKEN(INSERT);
 	YY_BREAK
 case 24:
 YY_RULE_SETUP
-#line 105 "lex_sql.l"
+#line 132 "lex_sql.l"
 RETURN_TOKEN(INTO);
 	YY_BREAK
 case 25:
 YY_RULE_SETUP
-#line 106 "lex_sql.l"
+#line 133 "lex_sql.l"
 RETURN_TOKEN(VALUES);
 	YY_BREAK
 case 26:
 YY_RULE_SETUP
-#line 107 "lex_sql.l"
+#line 134 "lex_sql.l"
 RETURN_TOKEN(DELETE);
 	YY_BREAK
 case 27:
 YY_RULE_SETUP
-#line 108 "lex_sql.l"
+#line 135 "lex_sql.l"
 RETURN_TOKEN(UPDATE);
 	YY_BREAK
 case 28:
 YY_RULE_SETUP
-#line 109 "lex_sql.l"
+#line 136 "lex_sql.l"
 RETURN_TOKEN(SET);
 	YY_BREAK
 case 29:
 YY_RULE_SETUP
-#line 110 "lex_sql.l"
+#line 137 "lex_sql.l"
 RETURN_TOKEN(TRX_BEGIN);
 	YY_BREAK
 case 30:
 YY_RULE_SETUP
-#line 111 "lex_sql.l"
+#line 138 "lex_sql.l"
 RETURN_TOKEN(TRX_COMMIT);
 	YY_BREAK
 case 31:
 YY_RULE_SETUP
-#line 112 "lex_sql.l"
+#line 139 "lex_sql.l"
 RETURN_TOKEN(TRX_ROLLBACK);
 	YY_BREAK
 case 32:
 YY_RULE_SETUP
-#line 113 "lex_sql.l"
+#line 140 "lex_sql.l"
 RETURN_TOKEN(INT_T);
 	YY_BREAK
 case 33:
 YY_RULE_SETUP
-#line 114 "lex_sql.l"
+#line 141 "lex_sql.l"
 RETURN_TOKEN(STRING_T);
 	YY_BREAK
 case 34:
 YY_RULE_SETUP
-#line 115 "lex_sql.l"
+#line 142 "lex_sql.l"
 RETURN_TOKEN(FLOAT_T);
 	YY_BREAK
 case 35:
 YY_RULE_SETUP
-#line 116 "lex_sql.l"
+#line 143 "lex_sql.l"
 RETURN_TOKEN(DATE_T);
 	YY_BREAK
 case 36:
 YY_RULE_SETUP
-#line 117 "lex_sql.l"
+#line 144 "lex_sql.l"
 RETURN_TOKEN(LOAD);
 	YY_BREAK
 case 37:
 YY_RULE_SETUP
-#line 118 "lex_sql.l"
+#line 145 "lex_sql.l"
 RETURN_TOKEN(DATA);
 	YY_BREAK
 case 38:
 YY_RULE_SETUP
-#line 119 "lex_sql.l"
+#line 146 "lex_sql.l"
 RETURN_TOKEN(INFILE);
 	YY_BREAK
 case 39:
 YY_RULE_SETUP
-#line 120 "lex_sql.l"
+#line 147 "lex_sql.l"
 RETURN_TOKEN(EXPLAIN);
 	YY_BREAK
 case 40:
 YY_RULE_SETUP
-#line 121 "lex_sql.l"
+#line 148 "lex_sql.l"
 RETURN_TOKEN(NOT);
 	YY_BREAK
 case 41:
 YY_RULE_SETUP
-#line 122 "lex_sql.l"
+#line 149 "lex_sql.l"
 RETURN_TOKEN(LIKE);
 	YY_BREAK
 case 42:
 YY_RULE_SETUP
-#line 123 "lex_sql.l"
+#line 150 "lex_sql.l"
 RETURN_TOKEN(MAX);
 	YY_BREAK
 case 43:
 YY_RULE_SETUP
-#line 124 "lex_sql.l"
+#line 151 "lex_sql.l"
 RETURN_TOKEN(MIN);
 	YY_BREAK
 case 44:
 YY_RULE_SETUP
-#line 125 "lex_sql.l"
+#line 152 "lex_sql.l"
 RETURN_TOKEN(COUNT);
 	YY_BREAK
 case 45:
 YY_RULE_SETUP
-#line 126 "lex_sql.l"
+#line 153 "lex_sql.l"
 RETURN_TOKEN(AVG);
 	YY_BREAK
 case 46:
 YY_RULE_SETUP
-#line 127 "lex_sql.l"
+#line 154 "lex_sql.l"
 RETURN_TOKEN(SUM);
 	YY_BREAK
 case 47:
 YY_RULE_SETUP
-#line 128 "lex_sql.l"
+#line 155 "lex_sql.l"
 RETURN_TOKEN(INNER);
 	YY_BREAK
 case 48:
 YY_RULE_SETUP
-#line 129 "lex_sql.l"
+#line 156 "lex_sql.l"
 RETURN_TOKEN(JOIN);
 	YY_BREAK
 case 49:
 YY_RULE_SETUP
-#line 130 "lex_sql.l"
-yylval->string=strdup(yytext); RETURN_TOKEN(ID);
+#line 157 "lex_sql.l"
+return id_or_keyword(yytext, yyleng, yylval, yyextra);
 	YY_BREAK
 case 50:
 YY_RULE_SETUP
-#line 131 "lex_sql.l"
+#line 158 "lex_sql.l"
 RETURN_TOKEN(LBRACE);
 	YY_BREAK
 case 51:
 YY_RULE_SETUP
-#line 132 "lex_sql.l"
+#line 159 "lex_sql.l"
 RETURN_TOKEN(RBRACE);
 	YY_BREAK
 case 52:
 YY_RULE_SETUP
-#line 134 "lex_sql.l"
+#line 161 "lex_sql.l"
 RETURN_TOKEN(COMMA);
 	YY_BREAK
 case 53:
 YY_RULE_SETUP
-#line 135 "lex_sql.l"
+#line 162 "lex_sql.l"
 RETURN_TOKEN(EQ);
 	YY_BREAK
 case 54:
 YY_RULE_SETUP
-#line 136 "lex_sql.l"
+#line 163 "lex_sql.l"
 RETURN_TOKEN(LE);
 	YY_BREAK
 case 55:
 YY_RULE_SETUP
-#line 137 "lex_sql.l"
+#line 164 "lex_sql.l"
 RETURN_TOKEN(NE);
 	YY_BREAK
 case 56:
 YY_RULE_SETUP
-#line 138 "lex_sql.l"
+#line 165 "lex_sql.l"
 RETURN_TOKEN(NE);
 	YY_BREAK
 case 57:
 YY_RULE_SETUP
-#line 139 "lex_sql.l"
+#line 166 "lex_sql.l"
 RETURN_TOKEN(LT);
 	YY_BREAK
 case 58:
 YY_RULE_SETUP
-#line 140 "lex_sql.l"
+#line 167 "lex_sql.l"
 RETURN_TOKEN(GE);
 	YY_BREAK
 case 59:
 YY_RULE_SETUP
-#line 141 "lex_sql.l"
+#line 168 "lex_sql.l"
 RETURN_TOKEN(GT);
 	YY_BREAK
 case 60:
-#line 144 "lex_sql.l"
+#line 171 "lex_sql.l"
 case 61:
-#line 145 "lex_sql.l"
+#line 172 "lex_sql.l"
 case 62:
-#line 146 "lex_sql.l"
+#line 173 "lex_sql.l"
 case 63:
 YY_RULE_SETUP
-#line 146 "lex_sql.l"
+#line 173 "lex_sql.l"
 { return yytext[0]; }
 	YY_BREAK
 case 64:
 YY_RULE_SETUP
-#line 148 "lex_sql.l"
+#line 175 "lex_sql.l"
 yylval->dates = str_to_date(yytext); RETURN_TOKEN(DATE);
 	YY_BREAK
 case 65:
 YY_RULE_SETUP
-#line 149 "lex_sql.l"
+#line 176 "lex_sql.l"
 yylval->dates = str_to_date(yytext); RETURN_TOKEN(DATE);
 	YY_BREAK
 case 66:
 /* rule 66 can match eol */
 YY_RULE_SETUP
-#line 151 "lex_sql.l"
-yylval->string = strdup(yytext); RETURN_TOKEN(SSS);
+#line 178 "lex_sql.l"
+yylval->string = static_cast<common::Arena *>(yyextra)->dup(yytext, yyleng); RETURN_TOKEN(SSS);
 	YY_BREAK
 case 67:
 /* rule 67 can match eol */
 YY_RULE_SETUP
-#line 152 "lex_sql.l"
-yylval->string = strdup(yytext); RETURN_TOKEN(SSS);
+#line 179 "lex_sql.l"
+yylval->string = static_cast<common::Arena *>(yyextra)->dup(yytext, yyleng); RETURN_TOKEN(SSS);
 	YY_BREAK
 case 68:
 YY_RULE_SETUP
-#line 154 "lex_sql.l"
+#line 181 "lex_sql.l"
 LOG_DEBUG("Unknown character [%c]",yytext[0]); return yytext[0];
 	YY_BREAK
 case 69:
 YY_RULE_SETUP
-#line 155 "lex_sql.l"
+#line 182 "lex_sql.l"
 ECHO;
 	YY_BREAK
-#line 1397 "lex_sql.cpp"
+#line 1424 "lex_sql.cpp"
 case YY_STATE_EOF(INITIAL):
 case YY_STATE_EOF(STR):
 	yyterminate();
@@ -2549,7 +2576,7 @@ void yyfree (void * ptr , yyscan_t yyscanner)
 
 #define YYTABLES_NAME "yytables"
 
-#line 155 "lex_sql.l"
+#line 182 "lex_sql.l"
 
 
 void scan_string(const char *str, yyscan_t scanner) {
@@ -33,17 +33,17 @@ ParsedSqlNode::ParsedSqlNode() : flag(SCF_ERROR)
 ParsedSqlNode::ParsedSqlNode(SqlCommandFlag _flag) : flag(_flag)
 {}
 
-void ParsedSqlResult::add_sql_node(std::unique_ptr<ParsedSqlNode> sql_node)
+void ParsedSqlResult::add_sql_node(ParsedSqlNode *sql_node)
 {
-  sql_nodes_.emplace_back(std::move(sql_node));
+  sql_nodes_.emplace_back(sql_node);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-int sql_parse(const char *st, ParsedSqlResult *sql_result);
+int sql_parse(const char *st, ParsedSqlResult *sql_result, common::Arena &arena);
 
-RC parse(const char *st, ParsedSqlResult *sql_result)
+RC parse(const char *st, ParsedSqlResult *sql_result, common::Arena &arena)
 {
-  sql_parse(st, sql_result);
+  sql_parse(st, sql_result, arena);
   return RC::SUCCESS;
 }
@@ -15,6 +15,11 @@ See the Mulan PSL v2 for more details. */
 #pragma once
 
 #include "common/rc.h"
+#include "common/mm/arena.h"
 #include "sql/parser/parse_defs.h"
 
-RC parse(const char *st, ParsedSqlResult *sql_result);
+/**
+ * @brief 解析SQL语句
+ * @param arena 词法分析用到的缓冲区、字符串和解析出的语法树都从这里分配，使用解析结果时 arena 不能释放
+ */
+RC parse(const char *st, ParsedSqlResult *sql_result, common::Arena &arena);
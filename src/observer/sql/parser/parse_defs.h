@@ -20,6 +20,7 @@ See the Mulan PSL v2 for more details. */
 #include <string>
 
 #include "sql/parser/value.h"
+#include "storage/buffer/page.h"
 
 class Expression;
 
@@ -154,8 +155,8 @@ struct CalcSqlNode
  */
 struct InsertSqlNode
 {
-  std::string        relation_name;  ///< Relation to insert into
-  std::vector<Value> values;         ///< 要插入的值
+  std::string                     relation_name;  ///< Relation to insert into
+  std::vector<std::vector<Value>> values;         ///< 要插入的值，每一行是一条记录
 };
 
 /**
@@ -192,6 +193,19 @@ struct AttrInfoSqlNode
   AttrType    type;       ///< Type of attribute
   std::string name;       ///< Attribute name
   size_t      length;     ///< Length of attribute
+  bool        var_len = false;  ///< 是否是变长字符串 VARCHAR
+};
+
+/**
+ * @brief 表数据在页面上的存放格式
+ * @ingroup SQLParser
+ * @details 建表时通过 WITH (format=pax) 指定，默认是行存。可以和页面大小一起指定，比如
+ * WITH (format=pax, page_size=16384)
+ */
+enum StorageFormat
+{
+  ROW_FORMAT,  ///< 行存，一条记录的所有字段连续存放
+  PAX_FORMAT,  ///< PAX(Partition Attributes Across)，页面内按列存放，每个字段一个 minipage
 };
 
 /**
@@ -203,6 +217,8 @@ struct CreateTableSqlNode
 {
   std::string                  relation_name;         ///< Relation name
   std::vector<AttrInfoSqlNode> attr_infos;            ///< attributes
+  StorageFormat                storage_format = ROW_FORMAT;  ///< 数据页面的存放格式
+  int                          page_size = BP_PAGE_SIZE;     ///< 数据和索引文件的页面大小，WITH (page_size=N)
 };
 
 /**
@@ -247,6 +263,26 @@ struct DescTableSqlNode
   std::string relation_name;
 };
 
+/**
+ * @brief 描述一个analyze table语句
+ * @ingroup SQLParser
+ * @details 采样计算表的统计信息，供优化器使用
+ */
+struct AnalyzeTableSqlNode
+{
+  std::string relation_name;
+};
+
+/**
+ * @brief 描述一个reset语句
+ * @ingroup SQLParser
+ * @details 清空系统表中的统计数据，比如 RESET statement_digests
+ */
+struct ResetSqlNode
+{
+  std::string name;
+};
+
 /**
  * @brief 描述一个load data语句
  * @ingroup SQLParser
@@ -280,7 +316,7 @@ class ParsedSqlNode;
  */
 struct ExplainSqlNode
 {
-  std::unique_ptr<ParsedSqlNode> sql_node;
+  ParsedSqlNode *sql_node = nullptr;  ///< 和外层的语句一样分配在解析时的 arena 中
 };
 
 /**
@@ -314,6 +350,8 @@ enum SqlCommandFlag
   SCF_SYNC,
   SCF_SHOW_TABLES,
   SCF_DESC_TABLE,
+  SCF_ANALYZE_TABLE,
+  SCF_RESET,
   SCF_BEGIN,        ///< 事务开始语句，可以在这里扩展只读事务
   SCF_COMMIT,
   SCF_CLOG_SYNC,
@@ -343,6 +381,8 @@ public:
   CreateIndexSqlNode        create_index;
   DropIndexSqlNode          drop_index;
   DescTableSqlNode          desc_table;
+  AnalyzeTableSqlNode       analyze_table;
+  ResetSqlNode              reset;
   LoadDataSqlNode           load_data;
   ExplainSqlNode            explain;
   SetVariableSqlNode        set_variable;
@@ -355,16 +395,29 @@ public:
 /**
  * @brief 表示语法解析后的数据
  * @ingroup SQLParser
+ * @details 语法树分配在解析时传入的 arena 中，这里只记录指针，参考 parse
  */
 class ParsedSqlResult
 {
 public:
-  void add_sql_node(std::unique_ptr<ParsedSqlNode> sql_node);
-  std::vector<std::unique_ptr<ParsedSqlNode>> &sql_nodes()
+  void add_sql_node(ParsedSqlNode *sql_node);
+  std::vector<ParsedSqlNode *> &sql_nodes()
   {
     return sql_nodes_;
   }
 
+  /**
+   * @brief 语句的摘要文本
+   * @details 词法分析时生成，常量都替换成了'?'，只有常量不同的语句摘要文本相同，参考 StatementDigests
+   */
+  std::string &digest_text()
+  {
+    return digest_text_;
+  }
+
+  static constexpr size_t MAX_DIGEST_TEXT_LENGTH = 1024;  ///< 摘要文本的最大长度，超出的部分不再记录
+
 private:
-  std::vector<std::unique_ptr<ParsedSqlNode>> sql_nodes_;  ///< 这里记录SQL命令。虽然看起来支持多个，但是当前仅处理一个
+  std::vector<ParsedSqlNode *> sql_nodes_;  ///< 这里记录SQL命令。虽然看起来支持多个，但是当前仅处理一个
+  std::string                  digest_text_;
 };
@@ -43,9 +43,9 @@ RC ResolveStage::handle_request(SQLStageEvent *sql_event)
     return rc;
   }
 
-  ParsedSqlNode *sql_node = sql_event->sql_node().get();
+  ParsedSqlNode *sql_node = sql_event->sql_node();
   Stmt *stmt = nullptr;
-  rc = Stmt::create_stmt(db, *sql_node, stmt);
+  rc = Stmt::create_stmt(db, *sql_node, stmt, sql_event->arena());
   if (rc != RC::SUCCESS && rc != RC::UNIMPLENMENT) {
     LOG_WARN("failed to create stmt. rc=%d:%s", rc, strrc(rc));
     sql_result->set_return_code(rc);
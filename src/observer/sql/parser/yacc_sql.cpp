@@ -1,8 +1,8 @@
-/* A Bison parser, made by GNU Bison 3.5.1.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
 /* Bison implementation for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2020 Free Software Foundation,
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
    Inc.
 
    This program is free software: you can redistribute it and/or modify
@@ -16,7 +16,7 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -34,6 +34,10 @@
 /* C LALR(1) parser skeleton written by Richard Stallman, by
    simplifying the original so-called "semantic" parser.  */
 
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
 /* All symbols defined below should begin with yy or YY, to avoid
    infringing on user name space.  This should be done even for local
    variables, as they might otherwise be expanded by user macros.
@@ -41,14 +45,11 @@
    define necessary library symbols; they are noted "INFRINGES ON
    USER NAME SPACE" below.  */
 
-/* Undocumented macros, especially those whose name start with YY_,
-   are private implementation details.  Do not rely on them.  */
-
-/* Identify Bison output.  */
-#define YYBISON 1
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
 
-/* Bison version.  */
-#define YYBISON_VERSION "3.5.1"
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
 
 /* Skeleton name.  */
 #define YYSKELETON_NAME "yacc.c"
@@ -76,6 +77,7 @@
 
 #include "common/log/log.h"
 #include "common/lang/string.h"
+#include "common/mm/arena.h"
 #include "sql/parser/parse_defs.h"
 #include "sql/parser/yacc_sql.hpp"
 #include "sql/parser/lex_sql.h"
@@ -88,13 +90,24 @@ string token_name(const char *sql_string, YYLTYPE *llocp)
   return string(sql_string + llocp->first_column, llocp->last_column - llocp->first_column + 1);
 }
 
+/**
+ * @brief 在 sql_parse 传入的 arena 中创建语法树的节点
+ * @details 节点随 arena 一起析构和释放，语法错误时 bison 丢弃的节点也不会泄漏。
+ * 表达式会转移到 Stmt 和算子中，生命周期比 arena 长，仍然在堆上分配
+ */
+template <typename T, typename... Args>
+static T *create_node(yyscan_t scanner, Args &&...args)
+{
+  return static_cast<common::Arena *>(yyget_extra(scanner))->create<T>(std::forward<Args>(args)...);
+}
+
 int yyerror(YYLTYPE *llocp, const char *sql_string, ParsedSqlResult *sql_result, yyscan_t scanner, const char *msg)
 {
-  std::unique_ptr<ParsedSqlNode> error_sql_node = std::make_unique<ParsedSqlNode>(SCF_ERROR);
+  ParsedSqlNode *error_sql_node = create_node<ParsedSqlNode>(scanner, SCF_ERROR);
   error_sql_node->error.error_msg = msg;
   error_sql_node->error.line = llocp->first_line;
   error_sql_node->error.column = llocp->first_column;
-  sql_result->add_sql_node(std::move(error_sql_node));
+  sql_result->add_sql_node(error_sql_node);
   return 0;
 }
 
@@ -109,8 +122,100 @@ ArithmeticExpr *create_arithmetic_expression(ArithmeticExpr::Type type,
   return expr;
 }
 
+/**
+ * @brief 设置建表语句 WITH 子句中的一个选项
+ * @details format 的值是标识符 row 或 pax，page_size 的值是数字，页面大小是否合法在建表时检查
+ * @param str_value 标识符形式的值，值是数字时为空
+ * @return 选项名称或者值不认识时返回false
+ */
+static bool set_table_option(CreateTableSqlNode &options, const char *name, const char *str_value, int num_value)
+{
+  if (0 == strcasecmp(name, "format") && str_value != nullptr) {
+    if (0 == strcasecmp(str_value, "row")) {
+      options.storage_format = ROW_FORMAT;
+      return true;
+    }
+    if (0 == strcasecmp(str_value, "pax")) {
+      options.storage_format = PAX_FORMAT;
+      return true;
+    }
+    return false;
+  }
+  if (0 == strcasecmp(name, "page_size") && str_value == nullptr) {
+    options.page_size = num_value;
+    return true;
+  }
+  return false;
+}
+
+/**
+ * @brief 把一个token追加到语句的摘要文本中
+ * @details 常量都替换成'?'，关键字统一成小写，token之间用一个空格分开，所以只有常量或者空白不同的语句，
+ * 摘要文本是相同的。逗号、右括号、点号前面和左括号、点号后面不加空格，结尾的分号不记录。
+ */
+static void append_digest_token(string &digest_text, int token, const char *text, int len)
+{
+  if (token == SEMICOLON || digest_text.size() >= ParsedSqlResult::MAX_DIGEST_TEXT_LENGTH) {
+    return;
+  }
+
+  if (!digest_text.empty() && token != COMMA && token != RBRACE && token != DOT
+      && digest_text.back() != '(' && digest_text.back() != '.') {
+    digest_text.push_back(' ');
+  }
+
+  switch (token) {
+    case NUMBER:
+    case FLOAT:
+    case DATE:
+    case SSS: {
+      digest_text.push_back('?');
+    } break;
+    case ID: {
+      digest_text.append(text, len);
+    } break;
+    default: {
+      const size_t start = digest_text.size();
+      digest_text.append(text, len);
+      for (size_t i = start; i < digest_text.size(); i++) {
+        digest_text[i] = static_cast<char>(tolower(static_cast<unsigned char>(digest_text[i])));
+      }
+    } break;
+  }
+}
+
+/**
+ * @brief 多行的 INSERT 只保留第一行，后面的行用", ..."代替，这样插入行数不同的语句摘要相同
+ * @details 常量已经替换成了'?'，VALUES 中的每一行都不会再有括号
+ */
+static void collapse_insert_rows(string &digest_text)
+{
+  size_t pos = digest_text.find(" values (");
+  if (pos == string::npos) {
+    return;
+  }
+  pos = digest_text.find(')', pos);
+  if (pos != string::npos && digest_text.compare(pos + 1, 2, ", ") == 0) {
+    digest_text.replace(pos + 1, string::npos, ", ...");
+  }
+}
+
+/**
+ * @brief 词法分析，同时生成语句的摘要文本
+ */
+static int digest_lex(YYSTYPE *lvalp, YYLTYPE *llocp, yyscan_t scanner, ParsedSqlResult *sql_result)
+{
+  int token = yylex(lvalp, llocp, scanner);
+  if (token > 0) {
+    append_digest_token(sql_result->digest_text(), token, yyget_text(scanner), yyget_leng(scanner));
+  }
+  return token;
+}
+
+#define yylex(lvalp, llocp, scanner) digest_lex(lvalp, llocp, scanner, sql_result)
+
 
-#line 114 "yacc_sql.cpp"
+#line 219 "yacc_sql.cpp"
 
 # ifndef YY_CAST
 #  ifdef __cplusplus
@@ -133,152 +238,138 @@ ArithmeticExpr *create_arithmetic_expression(ArithmeticExpr::Type type,
 #  endif
 # endif
 
-/* Enabling verbose error messages.  */
-#ifdef YYERROR_VERBOSE
-# undef YYERROR_VERBOSE
-# define YYERROR_VERBOSE 1
-#else
-# define YYERROR_VERBOSE 1
-#endif
-
-/* Use api.header.include to #include this header
-   instead of duplicating it here.  */
-#ifndef YY_YY_YACC_SQL_HPP_INCLUDED
-# define YY_YY_YACC_SQL_HPP_INCLUDED
-/* Debug traces.  */
-#ifndef YYDEBUG
-# define YYDEBUG 0
-#endif
-#if YYDEBUG
-extern int yydebug;
-#endif
-
-/* Token type.  */
-#ifndef YYTOKENTYPE
-# define YYTOKENTYPE
-  enum yytokentype
-  {
-    SEMICOLON = 258,
-    CREATE = 259,
-    DROP = 260,
-    TABLE = 261,
-    TABLES = 262,
-    INDEX = 263,
-    CALC = 264,
-    SELECT = 265,
-    DESC = 266,
-    SHOW = 267,
-    SYNC = 268,
-    INSERT = 269,
-    DELETE = 270,
-    UPDATE = 271,
-    LBRACE = 272,
-    RBRACE = 273,
-    COMMA = 274,
-    TRX_BEGIN = 275,
-    TRX_COMMIT = 276,
-    TRX_ROLLBACK = 277,
-    INT_T = 278,
-    STRING_T = 279,
-    FLOAT_T = 280,
-    DATE_T = 281,
-    HELP = 282,
-    EXIT = 283,
-    DOT = 284,
-    INTO = 285,
-    VALUES = 286,
-    FROM = 287,
-    WHERE = 288,
-    AND = 289,
-    SET = 290,
-    ON = 291,
-    LOAD = 292,
-    DATA = 293,
-    INFILE = 294,
-    EXPLAIN = 295,
-    EQ = 296,
-    LT = 297,
-    GT = 298,
-    LE = 299,
-    GE = 300,
-    NE = 301,
-    LIKE = 302,
-    NOT = 303,
-    MAX = 304,
-    MIN = 305,
-    COUNT = 306,
-    AVG = 307,
-    SUM = 308,
-    INNER = 309,
-    JOIN = 310,
-    NUMBER = 311,
-    FLOAT = 312,
-    DATE = 313,
-    ID = 314,
-    SSS = 315,
-    UMINUS = 316
-  };
-#endif
-
-/* Value type.  */
-#if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
-union YYSTYPE
-{
-#line 113 "yacc_sql.y"
-
-  ParsedSqlNode *                   sql_node;
-  ConditionSqlNode *                condition;
-  Value *                           value;
-  enum CompOp                       comp;
-  RelAttrSqlNode *                  rel_attr;
-  std::vector<AttrInfoSqlNode> *    attr_infos;
-  AttrInfoSqlNode *                 attr_info;
-  Expression *                      expression;
-  std::vector<Expression *> *       expression_list;
-  std::vector<Value> *              value_list;
-  std::vector<ConditionSqlNode> *   condition_list;
-  std::vector<RelAttrSqlNode> *     rel_attr_list;
-  std::vector<std::string> *        relation_list;
-  char *                            string;
-  int                               number;
-  float                             floats;
-  // new
-  date                              dates;
-  AggrFuncType                      aggr_func_type;
-  AggrFuncNode*                     aggr_func_node;
-  SelectExprNode*                   select_expr_node;
-  std::vector<SelectExprNode> *     s_expr_node_list;
-  std::vector<JoinSqlNode>*         join_list;
-  std::vector<std::string>*         id_list;
-
-#line 255 "yacc_sql.cpp"
-
-};
-typedef union YYSTYPE YYSTYPE;
-# define YYSTYPE_IS_TRIVIAL 1
-# define YYSTYPE_IS_DECLARED 1
-#endif
-
-/* Location type.  */
-#if ! defined YYLTYPE && ! defined YYLTYPE_IS_DECLARED
-typedef struct YYLTYPE YYLTYPE;
-struct YYLTYPE
+#include "yacc_sql.hpp"
+/* Symbol kind.  */
+enum yysymbol_kind_t
 {
-  int first_line;
-  int first_column;
-  int last_line;
-  int last_column;
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_SEMICOLON = 3,                  /* SEMICOLON  */
+  YYSYMBOL_CREATE = 4,                     /* CREATE  */
+  YYSYMBOL_DROP = 5,                       /* DROP  */
+  YYSYMBOL_TABLE = 6,                      /* TABLE  */
+  YYSYMBOL_TABLES = 7,                     /* TABLES  */
+  YYSYMBOL_INDEX = 8,                      /* INDEX  */
+  YYSYMBOL_CALC = 9,                       /* CALC  */
+  YYSYMBOL_SELECT = 10,                    /* SELECT  */
+  YYSYMBOL_DESC = 11,                      /* DESC  */
+  YYSYMBOL_SHOW = 12,                      /* SHOW  */
+  YYSYMBOL_SYNC = 13,                      /* SYNC  */
+  YYSYMBOL_INSERT = 14,                    /* INSERT  */
+  YYSYMBOL_DELETE = 15,                    /* DELETE  */
+  YYSYMBOL_UPDATE = 16,                    /* UPDATE  */
+  YYSYMBOL_LBRACE = 17,                    /* LBRACE  */
+  YYSYMBOL_RBRACE = 18,                    /* RBRACE  */
+  YYSYMBOL_COMMA = 19,                     /* COMMA  */
+  YYSYMBOL_TRX_BEGIN = 20,                 /* TRX_BEGIN  */
+  YYSYMBOL_TRX_COMMIT = 21,                /* TRX_COMMIT  */
+  YYSYMBOL_TRX_ROLLBACK = 22,              /* TRX_ROLLBACK  */
+  YYSYMBOL_INT_T = 23,                     /* INT_T  */
+  YYSYMBOL_STRING_T = 24,                  /* STRING_T  */
+  YYSYMBOL_FLOAT_T = 25,                   /* FLOAT_T  */
+  YYSYMBOL_DATE_T = 26,                    /* DATE_T  */
+  YYSYMBOL_HELP = 27,                      /* HELP  */
+  YYSYMBOL_EXIT = 28,                      /* EXIT  */
+  YYSYMBOL_DOT = 29,                       /* DOT  */
+  YYSYMBOL_INTO = 30,                      /* INTO  */
+  YYSYMBOL_VALUES = 31,                    /* VALUES  */
+  YYSYMBOL_FROM = 32,                      /* FROM  */
+  YYSYMBOL_WHERE = 33,                     /* WHERE  */
+  YYSYMBOL_AND = 34,                       /* AND  */
+  YYSYMBOL_SET = 35,                       /* SET  */
+  YYSYMBOL_ON = 36,                        /* ON  */
+  YYSYMBOL_LOAD = 37,                      /* LOAD  */
+  YYSYMBOL_DATA = 38,                      /* DATA  */
+  YYSYMBOL_INFILE = 39,                    /* INFILE  */
+  YYSYMBOL_EXPLAIN = 40,                   /* EXPLAIN  */
+  YYSYMBOL_EQ = 41,                        /* EQ  */
+  YYSYMBOL_LT = 42,                        /* LT  */
+  YYSYMBOL_GT = 43,                        /* GT  */
+  YYSYMBOL_LE = 44,                        /* LE  */
+  YYSYMBOL_GE = 45,                        /* GE  */
+  YYSYMBOL_NE = 46,                        /* NE  */
+  YYSYMBOL_LIKE = 47,                      /* LIKE  */
+  YYSYMBOL_NOT = 48,                       /* NOT  */
+  YYSYMBOL_MAX = 49,                       /* MAX  */
+  YYSYMBOL_MIN = 50,                       /* MIN  */
+  YYSYMBOL_COUNT = 51,                     /* COUNT  */
+  YYSYMBOL_AVG = 52,                       /* AVG  */
+  YYSYMBOL_SUM = 53,                       /* SUM  */
+  YYSYMBOL_INNER = 54,                     /* INNER  */
+  YYSYMBOL_JOIN = 55,                      /* JOIN  */
+  YYSYMBOL_NUMBER = 56,                    /* NUMBER  */
+  YYSYMBOL_FLOAT = 57,                     /* FLOAT  */
+  YYSYMBOL_DATE = 58,                      /* DATE  */
+  YYSYMBOL_ID = 59,                        /* ID  */
+  YYSYMBOL_ANALYZE = 60,                   /* ANALYZE  */
+  YYSYMBOL_RESET = 61,                     /* RESET  */
+  YYSYMBOL_SSS = 62,                       /* SSS  */
+  YYSYMBOL_63_ = 63,                       /* '+'  */
+  YYSYMBOL_64_ = 64,                       /* '-'  */
+  YYSYMBOL_65_ = 65,                       /* '*'  */
+  YYSYMBOL_66_ = 66,                       /* '/'  */
+  YYSYMBOL_UMINUS = 67,                    /* UMINUS  */
+  YYSYMBOL_YYACCEPT = 68,                  /* $accept  */
+  YYSYMBOL_commands = 69,                  /* commands  */
+  YYSYMBOL_command_wrapper = 70,           /* command_wrapper  */
+  YYSYMBOL_exit_stmt = 71,                 /* exit_stmt  */
+  YYSYMBOL_help_stmt = 72,                 /* help_stmt  */
+  YYSYMBOL_sync_stmt = 73,                 /* sync_stmt  */
+  YYSYMBOL_begin_stmt = 74,                /* begin_stmt  */
+  YYSYMBOL_commit_stmt = 75,               /* commit_stmt  */
+  YYSYMBOL_rollback_stmt = 76,             /* rollback_stmt  */
+  YYSYMBOL_drop_table_stmt = 77,           /* drop_table_stmt  */
+  YYSYMBOL_show_tables_stmt = 78,          /* show_tables_stmt  */
+  YYSYMBOL_desc_table_stmt = 79,           /* desc_table_stmt  */
+  YYSYMBOL_analyze_table_stmt = 80,        /* analyze_table_stmt  */
+  YYSYMBOL_reset_stmt = 81,                /* reset_stmt  */
+  YYSYMBOL_create_index_stmt = 82,         /* create_index_stmt  */
+  YYSYMBOL_identifier = 83,                /* identifier  */
+  YYSYMBOL_id_list = 84,                   /* id_list  */
+  YYSYMBOL_drop_index_stmt = 85,           /* drop_index_stmt  */
+  YYSYMBOL_create_table_stmt = 86,         /* create_table_stmt  */
+  YYSYMBOL_table_options = 87,             /* table_options  */
+  YYSYMBOL_table_option_list = 88,         /* table_option_list  */
+  YYSYMBOL_attr_def_list = 89,             /* attr_def_list  */
+  YYSYMBOL_attr_def = 90,                  /* attr_def  */
+  YYSYMBOL_number = 91,                    /* number  */
+  YYSYMBOL_type = 92,                      /* type  */
+  YYSYMBOL_insert_stmt = 93,               /* insert_stmt  */
+  YYSYMBOL_insert_row_list = 94,           /* insert_row_list  */
+  YYSYMBOL_insert_row = 95,                /* insert_row  */
+  YYSYMBOL_value_list = 96,                /* value_list  */
+  YYSYMBOL_value = 97,                     /* value  */
+  YYSYMBOL_delete_stmt = 98,               /* delete_stmt  */
+  YYSYMBOL_update_stmt = 99,               /* update_stmt  */
+  YYSYMBOL_select_stmt = 100,              /* select_stmt  */
+  YYSYMBOL_join_list = 101,                /* join_list  */
+  YYSYMBOL_calc_stmt = 102,                /* calc_stmt  */
+  YYSYMBOL_expression_list = 103,          /* expression_list  */
+  YYSYMBOL_expression = 104,               /* expression  */
+  YYSYMBOL_select_exprs = 105,             /* select_exprs  */
+  YYSYMBOL_select_expr = 106,              /* select_expr  */
+  YYSYMBOL_select_expr_list = 107,         /* select_expr_list  */
+  YYSYMBOL_aggr_func = 108,                /* aggr_func  */
+  YYSYMBOL_aggr_func_name = 109,           /* aggr_func_name  */
+  YYSYMBOL_select_attr = 110,              /* select_attr  */
+  YYSYMBOL_rel_attr = 111,                 /* rel_attr  */
+  YYSYMBOL_attr_list = 112,                /* attr_list  */
+  YYSYMBOL_rel_list = 113,                 /* rel_list  */
+  YYSYMBOL_where = 114,                    /* where  */
+  YYSYMBOL_condition_list = 115,           /* condition_list  */
+  YYSYMBOL_condition = 116,                /* condition  */
+  YYSYMBOL_comp_op = 117,                  /* comp_op  */
+  YYSYMBOL_like_comp_op = 118,             /* like_comp_op  */
+  YYSYMBOL_load_data_stmt = 119,           /* load_data_stmt  */
+  YYSYMBOL_explain_stmt = 120,             /* explain_stmt  */
+  YYSYMBOL_set_variable_stmt = 121,        /* set_variable_stmt  */
+  YYSYMBOL_opt_semicolon = 122             /* opt_semicolon  */
 };
-# define YYLTYPE_IS_DECLARED 1
-# define YYLTYPE_IS_TRIVIAL 1
-#endif
-
+typedef enum yysymbol_kind_t yysymbol_kind_t;
 
 
-int yyparse (const char * sql_string, ParsedSqlResult * sql_result, void * scanner);
-
-#endif /* !YY_YY_YACC_SQL_HPP_INCLUDED  */
-
 
 
 #ifdef short
@@ -318,6 +409,18 @@ typedef int_least16_t yytype_int16;
 typedef short yytype_int16;
 #endif
 
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
+#endif
+
 #if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
 typedef __UINT_LEAST8_TYPE__ yytype_uint8;
 #elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
@@ -377,6 +480,7 @@ typedef int yytype_uint16;
 
 #define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
 
+
 /* Stored state numbers (used for stacks). */
 typedef yytype_uint8 yy_state_t;
 
@@ -395,6 +499,7 @@ typedef int yy_state_fast_t;
 # endif
 #endif
 
+
 #ifndef YY_ATTRIBUTE_PURE
 # if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
 #  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
@@ -413,17 +518,23 @@ typedef int yy_state_fast_t;
 
 /* Suppress unused-variable warnings by "using" E.  */
 #if ! defined lint || defined __GNUC__
-# define YYUSE(E) ((void) (E))
+# define YY_USE(E) ((void) (E))
 #else
-# define YYUSE(E) /* empty */
+# define YY_USE(E) /* empty */
 #endif
 
-#if defined __GNUC__ && ! defined __ICC && 407 <= __GNUC__ * 100 + __GNUC_MINOR__
 /* Suppress an incorrect diagnostic about yylval being uninitialized.  */
-# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                            \
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
     _Pragma ("GCC diagnostic push")                                     \
     _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
     _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+# endif
 # define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
     _Pragma ("GCC diagnostic pop")
 #else
@@ -452,7 +563,7 @@ typedef int yy_state_fast_t;
 
 #define YY_ASSERT(E) ((void) (0 && (E)))
 
-#if ! defined yyoverflow || YYERROR_VERBOSE
+#if 1
 
 /* The parser invokes alloca or malloc; define the necessary symbols.  */
 
@@ -517,8 +628,7 @@ void free (void *); /* INFRINGES ON USER NAME SPACE */
 #   endif
 #  endif
 # endif
-#endif /* ! defined yyoverflow || YYERROR_VERBOSE */
-
+#endif /* 1 */
 
 #if (! defined yyoverflow \
      && (! defined __cplusplus \
@@ -584,27 +694,29 @@ union yyalloc
 #endif /* !YYCOPY_NEEDED */
 
 /* YYFINAL -- State number of the termination state.  */
-#define YYFINAL  74
+#define YYFINAL  83
 /* YYLAST -- Last index in YYTABLE.  */
-#define YYLAST   186
+#define YYLAST   221
 
 /* YYNTOKENS -- Number of terminals.  */
-#define YYNTOKENS  66
+#define YYNTOKENS  68
 /* YYNNTS -- Number of nonterminals.  */
-#define YYNNTS  48
+#define YYNNTS  55
 /* YYNRULES -- Number of rules.  */
-#define YYNRULES  113
+#define YYNRULES  130
 /* YYNSTATES -- Number of states.  */
-#define YYNSTATES  201
+#define YYNSTATES  233
 
-#define YYUNDEFTOK  2
-#define YYMAXUTOK   316
+/* YYMAXUTOK -- Last valid token kind.  */
+#define YYMAXUTOK   318
 
 
 /* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
    as returned by yylex, with out-of-bounds checking.  */
-#define YYTRANSLATE(YYX)                                                \
-  (0 <= (YYX) && (YYX) <= YYMAXUTOK ? yytranslate[YYX] : YYUNDEFTOK)
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
 
 /* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
    as returned by yylex.  */
@@ -614,7 +726,7 @@ static const yytype_int8 yytranslate[] =
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,    63,    61,     2,    62,     2,    64,     2,     2,
+       2,     2,    65,    63,     2,    64,     2,    66,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
@@ -641,71 +753,74 @@ static const yytype_int8 yytranslate[] =
       25,    26,    27,    28,    29,    30,    31,    32,    33,    34,
       35,    36,    37,    38,    39,    40,    41,    42,    43,    44,
       45,    46,    47,    48,    49,    50,    51,    52,    53,    54,
-      55,    56,    57,    58,    59,    60,    65
+      55,    56,    57,    58,    59,    60,    61,    62,    67
 };
 
 #if YYDEBUG
-  /* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
 static const yytype_int16 yyrline[] =
 {
-       0,   204,   204,   212,   213,   214,   215,   216,   217,   218,
-     219,   220,   221,   222,   223,   224,   225,   226,   227,   228,
-     229,   230,   231,   235,   241,   246,   252,   258,   264,   270,
-     277,   283,   291,   306,   312,   323,   333,   352,   355,   368,
-     376,   386,   389,   390,   391,   392,   395,   411,   414,   425,
-     429,   433,   436,   444,   456,   471,   491,   513,   526,   546,
-     556,   561,   572,   575,   578,   581,   584,   588,   591,   599,
-     608,   620,   625,   634,   637,   650,   662,   665,   668,   671,
-     674,   680,   687,   699,   708,   718,   723,   734,   737,   751,
-     754,   767,   770,   776,   779,   784,   791,   803,   815,   827,
-     839,   870,   871,   872,   873,   874,   875,   878,   879,   883,
-     896,   904,   914,   915
+       0,   319,   319,   326,   327,   328,   329,   330,   331,   332,
+     333,   334,   335,   336,   337,   338,   339,   340,   341,   342,
+     343,   344,   345,   346,   347,   351,   357,   362,   368,   374,
+     380,   386,   392,   398,   405,   412,   419,   432,   435,   438,
+     444,   449,   459,   467,   488,   491,   502,   510,   518,   526,
+     537,   540,   552,   559,   566,   581,   584,   585,   586,   587,
+     590,   600,   605,   613,   627,   630,   640,   644,   648,   651,
+     659,   669,   681,   697,   715,   725,   742,   751,   756,   767,
+     770,   773,   776,   779,   783,   786,   793,   802,   813,   818,
+     827,   830,   842,   853,   856,   859,   862,   865,   871,   878,
+     890,   898,   908,   912,   921,   924,   937,   940,   952,   955,
+     961,   964,   968,   974,   983,   992,  1001,  1010,  1037,  1038,
+    1039,  1040,  1041,  1042,  1045,  1046,  1050,  1059,  1067,  1075,
+    1076
 };
 #endif
 
-#if YYDEBUG || YYERROR_VERBOSE || 1
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if 1
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
 /* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
    First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
 static const char *const yytname[] =
 {
-  "$end", "error", "$undefined", "SEMICOLON", "CREATE", "DROP", "TABLE",
-  "TABLES", "INDEX", "CALC", "SELECT", "DESC", "SHOW", "SYNC", "INSERT",
-  "DELETE", "UPDATE", "LBRACE", "RBRACE", "COMMA", "TRX_BEGIN",
-  "TRX_COMMIT", "TRX_ROLLBACK", "INT_T", "STRING_T", "FLOAT_T", "DATE_T",
-  "HELP", "EXIT", "DOT", "INTO", "VALUES", "FROM", "WHERE", "AND", "SET",
-  "ON", "LOAD", "DATA", "INFILE", "EXPLAIN", "EQ", "LT", "GT", "LE", "GE",
-  "NE", "LIKE", "NOT", "MAX", "MIN", "COUNT", "AVG", "SUM", "INNER",
-  "JOIN", "NUMBER", "FLOAT", "DATE", "ID", "SSS", "'+'", "'-'", "'*'",
-  "'/'", "UMINUS", "$accept", "commands", "command_wrapper", "exit_stmt",
-  "help_stmt", "sync_stmt", "begin_stmt", "commit_stmt", "rollback_stmt",
+  "\"end of file\"", "error", "\"invalid token\"", "SEMICOLON", "CREATE",
+  "DROP", "TABLE", "TABLES", "INDEX", "CALC", "SELECT", "DESC", "SHOW",
+  "SYNC", "INSERT", "DELETE", "UPDATE", "LBRACE", "RBRACE", "COMMA",
+  "TRX_BEGIN", "TRX_COMMIT", "TRX_ROLLBACK", "INT_T", "STRING_T",
+  "FLOAT_T", "DATE_T", "HELP", "EXIT", "DOT", "INTO", "VALUES", "FROM",
+  "WHERE", "AND", "SET", "ON", "LOAD", "DATA", "INFILE", "EXPLAIN", "EQ",
+  "LT", "GT", "LE", "GE", "NE", "LIKE", "NOT", "MAX", "MIN", "COUNT",
+  "AVG", "SUM", "INNER", "JOIN", "NUMBER", "FLOAT", "DATE", "ID",
+  "ANALYZE", "RESET", "SSS", "'+'", "'-'", "'*'", "'/'", "UMINUS",
+  "$accept", "commands", "command_wrapper", "exit_stmt", "help_stmt",
+  "sync_stmt", "begin_stmt", "commit_stmt", "rollback_stmt",
   "drop_table_stmt", "show_tables_stmt", "desc_table_stmt",
-  "create_index_stmt", "id_list", "drop_index_stmt", "create_table_stmt",
-  "attr_def_list", "attr_def", "number", "type", "insert_stmt",
-  "value_list", "value", "delete_stmt", "update_stmt", "select_stmt",
-  "join_list", "calc_stmt", "expression_list", "expression",
-  "select_exprs", "select_expr", "select_expr_list", "aggr_func",
-  "aggr_func_name", "select_attr", "rel_attr", "attr_list", "rel_list",
-  "where", "condition_list", "condition", "comp_op", "like_comp_op",
-  "load_data_stmt", "explain_stmt", "set_variable_stmt", "opt_semicolon", YY_NULLPTR
+  "analyze_table_stmt", "reset_stmt", "create_index_stmt", "identifier",
+  "id_list", "drop_index_stmt", "create_table_stmt", "table_options",
+  "table_option_list", "attr_def_list", "attr_def", "number", "type",
+  "insert_stmt", "insert_row_list", "insert_row", "value_list", "value",
+  "delete_stmt", "update_stmt", "select_stmt", "join_list", "calc_stmt",
+  "expression_list", "expression", "select_exprs", "select_expr",
+  "select_expr_list", "aggr_func", "aggr_func_name", "select_attr",
+  "rel_attr", "attr_list", "rel_list", "where", "condition_list",
+  "condition", "comp_op", "like_comp_op", "load_data_stmt", "explain_stmt",
+  "set_variable_stmt", "opt_semicolon", YY_NULLPTR
 };
-#endif
 
-# ifdef YYPRINT
-/* YYTOKNUM[NUM] -- (External) token number corresponding to the
-   (internal) symbol number NUM (which must be that of a token).  */
-static const yytype_int16 yytoknum[] =
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
 {
-       0,   256,   257,   258,   259,   260,   261,   262,   263,   264,
-     265,   266,   267,   268,   269,   270,   271,   272,   273,   274,
-     275,   276,   277,   278,   279,   280,   281,   282,   283,   284,
-     285,   286,   287,   288,   289,   290,   291,   292,   293,   294,
-     295,   296,   297,   298,   299,   300,   301,   302,   303,   304,
-     305,   306,   307,   308,   309,   310,   311,   312,   313,   314,
-     315,    43,    45,    42,    47,   316
-};
-# endif
+  return yytname[yysymbol];
+}
+#endif
 
-#define YYPACT_NINF (-160)
+#define YYPACT_NINF (-176)
 
 #define yypact_value_is_default(Yyn) \
   ((Yyn) == YYPACT_NINF)
@@ -715,200 +830,224 @@ static const yytype_int16 yytoknum[] =
 #define yytable_value_is_error(Yyn) \
   0
 
-  /* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
-     STATE-NUM.  */
+/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
+   STATE-NUM.  */
 static const yytype_int16 yypact[] =
 {
-      80,     7,    12,    -7,   -20,   -42,    31,  -160,    11,    32,
-       8,  -160,  -160,  -160,  -160,  -160,    10,    14,    80,    54,
-      63,  -160,  -160,  -160,  -160,  -160,  -160,  -160,  -160,  -160,
-    -160,  -160,  -160,  -160,  -160,  -160,  -160,  -160,  -160,  -160,
-    -160,    24,    28,    38,    40,    -7,  -160,  -160,  -160,  -160,
-      -7,  -160,  -160,    -5,  -160,  -160,  -160,  -160,  -160,    74,
-    -160,    72,    87,  -160,    88,  -160,  -160,  -160,    57,    59,
-      84,    81,    82,  -160,  -160,  -160,  -160,   106,    89,  -160,
-      99,   -16,  -160,    -7,    -7,    -7,    -7,    -7,    77,    78,
-      22,  -160,   -47,   107,   108,    83,   -49,    79,    85,    90,
-      91,  -160,  -160,   -36,   -36,  -160,  -160,  -160,   -14,    87,
-     121,   125,   126,   129,    20,  -160,   110,  -160,   117,    -1,
-     133,   131,  -160,    94,   100,   108,   108,  -160,    95,  -160,
-      95,  -160,   -49,    68,    86,  -160,   123,   -49,   152,  -160,
-    -160,  -160,  -160,   143,    85,   144,   102,   145,   104,  -160,
-    -160,   126,   126,   146,  -160,  -160,  -160,  -160,  -160,  -160,
-      20,  -160,   119,    20,   109,    20,   108,   111,   112,   133,
-    -160,   148,   153,  -160,   136,  -160,  -160,   -49,   155,  -160,
-    -160,  -160,  -160,  -160,  -160,  -160,  -160,  -160,  -160,   156,
-    -160,   102,  -160,    20,   146,  -160,  -160,  -160,   122,  -160,
-    -160
+      46,    79,   106,    61,    80,    41,    -1,  -176,   -18,     7,
+      41,  -176,  -176,  -176,  -176,  -176,   -33,    31,    46,    66,
+      41,    75,    76,  -176,  -176,  -176,  -176,  -176,  -176,  -176,
+    -176,  -176,  -176,  -176,  -176,  -176,  -176,  -176,  -176,  -176,
+    -176,  -176,  -176,  -176,  -176,    41,    41,    41,    41,    61,
+    -176,  -176,  -176,  -176,    61,  -176,  -176,    25,  -176,  -176,
+    -176,  -176,  -176,  -176,  -176,  -176,  -176,    55,    62,    78,
+    -176,    96,  -176,  -176,  -176,    41,    41,    81,    83,    88,
+    -176,    41,  -176,  -176,  -176,  -176,   117,   100,  -176,   102,
+      45,  -176,    61,    61,    61,    61,    61,    41,    41,   -28,
+    -176,   -31,   113,   120,    41,    64,    93,  -176,    41,    41,
+      41,  -176,  -176,   -30,   -30,  -176,  -176,  -176,   -16,    78,
+     146,   148,   149,   150,   121,  -176,   128,  -176,   140,    -6,
+     153,   156,  -176,    41,   129,   120,   120,  -176,    41,  -176,
+      41,  -176,    64,   166,  -176,   105,   116,  -176,   141,    64,
+     180,  -176,  -176,  -176,  -176,   170,   171,    41,   172,    41,
+     173,    41,  -176,  -176,   149,   149,   174,   150,  -176,  -176,
+    -176,  -176,  -176,  -176,   121,  -176,   142,   121,   132,   121,
+     120,    41,   135,   135,   153,   136,   177,   179,  -176,   162,
+    -176,  -176,    64,   181,  -176,  -176,  -176,  -176,  -176,  -176,
+    -176,  -176,  -176,  -176,  -176,   182,   183,  -176,   185,  -176,
+      41,  -176,   121,   174,  -176,  -176,  -176,   144,  -176,   152,
+    -176,   163,   124,  -176,   -45,  -176,   151,  -176,  -176,   167,
+     -43,  -176,  -176
 };
 
-  /* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
-     Performed when YYTABLE does not specify something else to do.  Zero
-     means the default is an error.  */
-static const yytype_int8 yydefact[] =
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
+   means the default is an error.  */
+static const yytype_uint8 yydefact[] =
 {
-       0,     0,     0,     0,     0,     0,     0,    25,     0,     0,
-       0,    26,    27,    28,    24,    23,     0,     0,     0,     0,
-     112,    22,    21,    14,    15,    16,    17,     9,    10,    11,
-      12,    13,     8,     5,     7,     6,     4,     3,    18,    19,
-      20,     0,     0,     0,     0,     0,    49,    50,    51,    52,
-       0,    68,    59,    60,    76,    77,    78,    79,    80,    85,
-      69,     0,    73,    72,     0,    71,    31,    30,     0,     0,
-       0,     0,     0,   110,     1,   113,     2,     0,     0,    29,
-       0,     0,    67,     0,     0,     0,     0,     0,     0,     0,
-       0,    70,    84,     0,    91,     0,     0,     0,     0,     0,
-       0,    66,    61,    62,    63,    64,    65,    86,    89,    73,
-      81,     0,    87,     0,    93,    53,     0,   111,     0,     0,
-      37,     0,    35,     0,     0,    91,    91,    74,     0,    75,
-       0,    83,     0,     0,     0,    92,    94,     0,     0,    42,
-      43,    44,    45,    40,     0,     0,     0,    89,     0,    56,
-      55,    87,    87,    47,   101,   102,   103,   104,   105,   106,
-       0,   107,     0,     0,     0,    93,    91,     0,     0,    37,
-      36,    33,     0,    90,     0,    82,    88,     0,     0,    97,
-      99,   108,    96,    98,   100,    95,    54,   109,    41,     0,
-      38,     0,    32,    93,    47,    46,    39,    34,    57,    48,
-      58
+       0,     0,     0,     0,     0,     0,     0,    27,     0,     0,
+       0,    28,    29,    30,    26,    25,     0,     0,     0,     0,
+       0,     0,   129,    24,    23,    16,    17,    18,    19,     9,
+      10,    11,    12,    13,    14,    15,     8,     5,     7,     6,
+       4,     3,    20,    21,    22,     0,     0,     0,     0,     0,
+      66,    67,    68,    69,     0,    85,    76,    77,    93,    94,
+      95,    96,    97,    37,    38,    39,    86,   102,     0,    90,
+      89,     0,    88,    33,    32,     0,     0,     0,     0,     0,
+     127,     0,    35,     1,   130,     2,     0,     0,    31,     0,
+       0,    84,     0,     0,     0,     0,     0,     0,     0,     0,
+      87,   101,     0,   108,     0,     0,     0,    34,     0,     0,
+       0,    83,    78,    79,    80,    81,    82,   103,   106,    90,
+      98,     0,   104,     0,   110,    70,     0,   128,     0,     0,
+      50,     0,    42,     0,     0,   108,   108,    91,     0,    92,
+       0,   100,     0,    60,    61,     0,     0,   109,   111,     0,
+       0,    56,    57,    58,    59,     0,    53,     0,     0,     0,
+     106,     0,    73,    72,   104,   104,    64,     0,   118,   119,
+     120,   121,   122,   123,     0,   124,     0,     0,     0,   110,
+     108,     0,     0,     0,    50,    44,    40,     0,   107,     0,
+      99,   105,     0,     0,    62,   114,   116,   125,   113,   115,
+     117,   112,    71,   126,    55,     0,     0,    51,     0,    43,
+       0,    36,   110,    64,    63,    54,    52,     0,    41,    74,
+      65,     0,     0,    75,     0,    45,     0,    47,    46,     0,
+       0,    49,    48
 };
 
-  /* YYPGOTO[NTERM-NUM].  */
+/* YYPGOTO[NTERM-NUM].  */
 static const yytype_int16 yypgoto[] =
 {
-    -160,  -160,   157,  -160,  -160,  -160,  -160,  -160,  -160,  -160,
-    -160,  -160,  -160,   -13,  -160,  -160,    13,    33,  -160,  -160,
-    -160,   -15,   -95,  -160,  -160,  -160,   -18,  -160,    98,   -24,
-    -160,    93,    75,  -160,  -160,  -160,    -4,  -116,    39,  -122,
-    -159,  -160,    51,  -160,  -160,  -160,  -160,  -160
+    -176,  -176,   189,  -176,  -176,  -176,  -176,  -176,  -176,  -176,
+    -176,  -176,  -176,  -176,  -176,    -5,     1,  -176,  -176,  -176,
+    -176,    28,    52,    30,  -176,  -176,  -176,    47,     2,   -97,
+    -176,  -176,  -176,    -2,  -176,   126,   -47,  -176,   122,    97,
+    -176,  -176,  -176,    -3,  -100,    59,  -126,  -175,  -176,    74,
+    -176,  -176,  -176,  -176,  -176
 };
 
-  /* YYDEFGOTO[NTERM-NUM].  */
-static const yytype_int16 yydefgoto[] =
+/* YYDEFGOTO[NTERM-NUM].  */
+static const yytype_uint8 yydefgoto[] =
 {
-      -1,    19,    20,    21,    22,    23,    24,    25,    26,    27,
-      28,    29,    30,   172,    31,    32,   145,   120,   189,   143,
-      33,   178,    51,    34,    35,    36,   125,    37,    52,    53,
-      61,    62,    91,    63,    64,   111,   134,   131,   126,   115,
-     135,   136,   160,   164,    38,    39,    40,    76
+       0,    21,    22,    23,    24,    25,    26,    27,    28,    29,
+      30,    31,    32,    33,    34,    67,   187,    35,    36,   209,
+     222,   158,   130,   205,   156,    37,   143,   144,   193,    55,
+      38,    39,    40,   135,    41,    56,    57,    68,    69,   100,
+      70,    71,   121,   146,   141,   136,   125,   147,   148,   174,
+     178,    42,    43,    44,    85
 };
 
-  /* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
-     positive, shift that token.  If negative, reduce the rule whose
-     number is the opposite.  If YYTABLE_NINF, syntax error.  */
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
 static const yytype_uint8 yytable[] =
 {
-      65,   117,   101,   149,   150,   123,   185,    46,    47,    48,
-      45,    49,    59,    41,    83,    42,   110,    66,    43,   133,
-      44,    81,   139,   140,   141,   142,    82,    86,    87,    54,
-      55,    56,    57,    58,   198,   175,   176,   153,    67,    59,
-     124,    68,   166,    60,   186,    84,    85,    86,    87,    46,
-      47,    48,    72,    49,    74,    50,    84,    85,    86,    87,
-     103,   104,   105,   106,    69,   179,    75,    70,   182,    71,
-     133,    54,    55,    56,    57,    58,    46,    47,    48,    59,
-      49,    59,   194,    77,     1,     2,    65,    78,   112,     3,
-       4,     5,     6,     7,     8,     9,    10,    79,   133,    80,
-      11,    12,    13,    88,    89,    92,    90,    14,    15,   154,
-     155,   156,   157,   158,   159,    16,    93,    17,    94,    95,
-      18,    97,    96,    98,   151,    99,   152,   154,   155,   156,
-     157,   158,   159,   161,   162,   100,   107,   108,   113,   118,
-     128,   114,   116,   129,   119,   130,   132,   138,   146,   121,
-     122,   137,   144,   147,    59,   148,   180,   165,   167,   183,
-     168,   171,   170,   174,   123,   177,   181,   191,   188,   184,
-     187,   192,   193,   195,   196,    73,   124,   169,   197,   199,
-     200,   102,   190,   109,   127,   163,   173
+      73,    72,    90,   133,   201,    77,    74,    91,   127,   162,
+     163,   227,    75,   231,   228,    82,   232,   151,   152,   153,
+     154,    58,    59,    60,    61,    62,    78,   145,    63,    64,
+      65,    63,    64,    65,   120,    95,    96,   219,   134,    76,
+      86,    87,    88,    89,    92,   166,   113,   114,   115,   116,
+       1,     2,   180,   155,   202,     3,     4,     5,     6,     7,
+       8,     9,    10,   111,   190,   191,    11,    12,    13,    79,
+     102,   103,    81,    14,    15,    83,   107,   195,    49,    84,
+     198,    16,   145,    17,    97,    45,    18,    46,    93,    94,
+      95,    96,   117,   118,    98,   213,    72,    99,   122,   126,
+      63,    64,    65,   129,   131,   132,    19,    20,    93,    94,
+      95,    96,    47,   101,    48,   145,   104,    50,    51,    52,
+      50,    51,    52,    53,   105,    54,    53,   106,   160,    58,
+      59,    60,    61,    62,   108,   164,   109,   165,   110,    63,
+      64,    65,   225,   226,   123,    66,   168,   169,   170,   171,
+     172,   173,   129,   124,   186,   128,   189,   168,   169,   170,
+     171,   172,   173,   175,   176,   138,   139,   142,   140,   149,
+     150,   196,   157,   159,   199,   179,   203,    50,    51,    52,
+      63,    64,    65,    53,   161,   167,   181,   182,   183,   197,
+     185,   204,   133,   192,   200,   208,   210,   211,   212,   214,
+     215,   216,   217,   221,   224,   186,   134,    80,   230,   184,
+     229,   218,   207,   206,   194,   220,   137,   223,   112,   188,
+     177,   119
 };
 
 static const yytype_uint8 yycheck[] =
 {
-       4,    96,    18,   125,   126,    19,   165,    56,    57,    58,
-      17,    60,    59,     6,    19,     8,    63,    59,     6,   114,
-       8,    45,    23,    24,    25,    26,    50,    63,    64,    49,
-      50,    51,    52,    53,   193,   151,   152,   132,     7,    59,
-      54,    30,   137,    63,   166,    61,    62,    63,    64,    56,
-      57,    58,    38,    60,     0,    62,    61,    62,    63,    64,
-      84,    85,    86,    87,    32,   160,     3,    59,   163,    59,
-     165,    49,    50,    51,    52,    53,    56,    57,    58,    59,
-      60,    59,   177,    59,     4,     5,    90,    59,    92,     9,
-      10,    11,    12,    13,    14,    15,    16,    59,   193,    59,
-      20,    21,    22,    29,    32,    17,    19,    27,    28,    41,
-      42,    43,    44,    45,    46,    35,    59,    37,    59,    35,
-      40,    39,    41,    17,   128,    36,   130,    41,    42,    43,
-      44,    45,    46,    47,    48,    36,    59,    59,    31,    60,
-      19,    33,    59,    18,    59,    19,    17,    30,    17,    59,
-      59,    41,    19,    59,    59,    55,   160,    34,     6,   163,
-      17,    59,    18,    59,    19,    19,    47,    19,    56,    60,
-      59,    18,    36,    18,    18,    18,    54,   144,   191,   194,
-     198,    83,   169,    90,   109,   134,   147
+       5,     4,    49,    19,   179,    10,     7,    54,   105,   135,
+     136,    56,    30,    56,    59,    20,    59,    23,    24,    25,
+      26,    49,    50,    51,    52,    53,    59,   124,    59,    60,
+      61,    59,    60,    61,    65,    65,    66,   212,    54,    32,
+      45,    46,    47,    48,    19,   142,    93,    94,    95,    96,
+       4,     5,   149,    59,   180,     9,    10,    11,    12,    13,
+      14,    15,    16,    18,   164,   165,    20,    21,    22,    38,
+      75,    76,     6,    27,    28,     0,    81,   174,    17,     3,
+     177,    35,   179,    37,    29,     6,    40,     8,    63,    64,
+      65,    66,    97,    98,    32,   192,    99,    19,   101,   104,
+      59,    60,    61,   108,   109,   110,    60,    61,    63,    64,
+      65,    66,     6,    17,     8,   212,    35,    56,    57,    58,
+      56,    57,    58,    62,    41,    64,    62,    39,   133,    49,
+      50,    51,    52,    53,    17,   138,    36,   140,    36,    59,
+      60,    61,    18,    19,    31,    65,    41,    42,    43,    44,
+      45,    46,   157,    33,   159,    62,   161,    41,    42,    43,
+      44,    45,    46,    47,    48,    19,    18,    17,    19,    41,
+      30,   174,    19,    17,   177,    34,   181,    56,    57,    58,
+      59,    60,    61,    62,    55,    19,     6,    17,    17,    47,
+      18,    56,    19,    19,    62,    59,    19,    18,    36,    18,
+      18,    18,    17,    59,    41,   210,    54,    18,    41,   157,
+      59,   210,   184,   183,   167,   213,   119,   219,    92,   160,
+     146,    99
 };
 
-  /* YYSTOS[STATE-NUM] -- The (internal number of the) accessing
-     symbol of state STATE-NUM.  */
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
 static const yytype_int8 yystos[] =
 {
        0,     4,     5,     9,    10,    11,    12,    13,    14,    15,
-      16,    20,    21,    22,    27,    28,    35,    37,    40,    67,
-      68,    69,    70,    71,    72,    73,    74,    75,    76,    77,
-      78,    80,    81,    86,    89,    90,    91,    93,   110,   111,
-     112,     6,     8,     6,     8,    17,    56,    57,    58,    60,
-      62,    88,    94,    95,    49,    50,    51,    52,    53,    59,
-      63,    96,    97,    99,   100,   102,    59,     7,    30,    32,
-      59,    59,    38,    68,     0,     3,   113,    59,    59,    59,
-      59,    95,    95,    19,    61,    62,    63,    64,    29,    32,
-      19,    98,    17,    59,    59,    35,    41,    39,    17,    36,
-      36,    18,    94,    95,    95,    95,    95,    59,    59,    97,
-      63,   101,   102,    31,    33,   105,    59,    88,    60,    59,
-      83,    59,    59,    19,    54,    92,   104,    98,    19,    18,
-      19,   103,    17,    88,   102,   106,   107,    41,    30,    23,
-      24,    25,    26,    85,    19,    82,    17,    59,    55,   105,
-     105,   102,   102,    88,    41,    42,    43,    44,    45,    46,
-     108,    47,    48,   108,   109,    34,    88,     6,    17,    83,
-      18,    59,    79,   104,    59,   103,   103,    19,    87,    88,
-     102,    47,    88,   102,    60,   106,   105,    59,    56,    84,
-      82,    19,    18,    36,    88,    18,    18,    79,   106,    87,
-      92
+      16,    20,    21,    22,    27,    28,    35,    37,    40,    60,
+      61,    69,    70,    71,    72,    73,    74,    75,    76,    77,
+      78,    79,    80,    81,    82,    85,    86,    93,    98,    99,
+     100,   102,   119,   120,   121,     6,     8,     6,     8,    17,
+      56,    57,    58,    62,    64,    97,   103,   104,    49,    50,
+      51,    52,    53,    59,    60,    61,    65,    83,   105,   106,
+     108,   109,   111,    83,     7,    30,    32,    83,    59,    38,
+      70,     6,    83,     0,     3,   122,    83,    83,    83,    83,
+     104,   104,    19,    63,    64,    65,    66,    29,    32,    19,
+     107,    17,    83,    83,    35,    41,    39,    83,    17,    36,
+      36,    18,   103,   104,   104,   104,   104,    83,    83,   106,
+      65,   110,   111,    31,    33,   114,    83,    97,    62,    83,
+      90,    83,    83,    19,    54,   101,   113,   107,    19,    18,
+      19,   112,    17,    94,    95,    97,   111,   115,   116,    41,
+      30,    23,    24,    25,    26,    59,    92,    19,    89,    17,
+      83,    55,   114,   114,   111,   111,    97,    19,    41,    42,
+      43,    44,    45,    46,   117,    47,    48,   117,   118,    34,
+      97,     6,    17,    17,    90,    18,    83,    84,   113,    83,
+     112,   112,    19,    96,    95,    97,   111,    47,    97,   111,
+      62,   115,   114,    83,    56,    91,    91,    89,    59,    87,
+      19,    18,    36,    97,    18,    18,    18,    17,    84,   115,
+      96,    59,    88,   101,    41,    18,    19,    56,    59,    59,
+      41,    56,    59
 };
 
-  /* YYR1[YYN] -- Symbol number of symbol that rule YYN derives.  */
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
 static const yytype_int8 yyr1[] =
 {
-       0,    66,    67,    68,    68,    68,    68,    68,    68,    68,
-      68,    68,    68,    68,    68,    68,    68,    68,    68,    68,
-      68,    68,    68,    69,    70,    71,    72,    73,    74,    75,
-      76,    77,    78,    79,    79,    80,    81,    82,    82,    83,
-      83,    84,    85,    85,    85,    85,    86,    87,    87,    88,
-      88,    88,    88,    89,    90,    91,    91,    92,    92,    93,
-      94,    94,    95,    95,    95,    95,    95,    95,    95,    96,
-      96,    97,    97,    98,    98,    99,   100,   100,   100,   100,
-     100,   101,   101,   101,   101,   102,   102,   103,   103,   104,
-     104,   105,   105,   106,   106,   106,   107,   107,   107,   107,
-     107,   108,   108,   108,   108,   108,   108,   109,   109,   110,
-     111,   112,   113,   113
+       0,    68,    69,    70,    70,    70,    70,    70,    70,    70,
+      70,    70,    70,    70,    70,    70,    70,    70,    70,    70,
+      70,    70,    70,    70,    70,    71,    72,    73,    74,    75,
+      76,    77,    78,    79,    80,    81,    82,    83,    83,    83,
+      84,    84,    85,    86,    87,    87,    88,    88,    88,    88,
+      89,    89,    90,    90,    90,    91,    92,    92,    92,    92,
+      93,    94,    94,    95,    96,    96,    97,    97,    97,    97,
+      98,    99,   100,   100,   101,   101,   102,   103,   103,   104,
+     104,   104,   104,   104,   104,   104,   105,   105,   106,   106,
+     107,   107,   108,   109,   109,   109,   109,   109,   110,   110,
+     110,   110,   111,   111,   112,   112,   113,   113,   114,   114,
+     115,   115,   115,   116,   116,   116,   116,   116,   117,   117,
+     117,   117,   117,   117,   118,   118,   119,   120,   121,   122,
+     122
 };
 
-  /* YYR2[YYN] -- Number of symbols on the right hand side of rule YYN.  */
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
 static const yytype_int8 yyr2[] =
 {
        0,     2,     2,     1,     1,     1,     1,     1,     1,     1,
        1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
-       1,     1,     1,     1,     1,     1,     1,     1,     1,     3,
-       2,     2,     8,     1,     3,     5,     7,     0,     3,     5,
-       2,     1,     1,     1,     1,     1,     8,     0,     3,     1,
-       1,     1,     1,     4,     7,     6,     6,     5,     6,     2,
-       1,     3,     3,     3,     3,     3,     3,     2,     1,     1,
-       2,     1,     1,     0,     3,     4,     1,     1,     1,     1,
-       1,     1,     4,     2,     0,     1,     3,     0,     3,     0,
-       3,     0,     2,     0,     1,     3,     3,     3,     3,     3,
-       3,     1,     1,     1,     1,     1,     1,     1,     2,     7,
-       2,     4,     0,     1
+       1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
+       1,     3,     2,     2,     3,     2,     8,     1,     1,     1,
+       1,     3,     5,     8,     0,     4,     3,     3,     5,     5,
+       0,     3,     5,     2,     5,     1,     1,     1,     1,     1,
+       5,     1,     3,     4,     0,     3,     1,     1,     1,     1,
+       4,     7,     6,     6,     5,     6,     2,     1,     3,     3,
+       3,     3,     3,     3,     2,     1,     1,     2,     1,     1,
+       0,     3,     4,     1,     1,     1,     1,     1,     1,     4,
+       2,     0,     1,     3,     0,     3,     0,     3,     0,     2,
+       0,     1,     3,     3,     3,     3,     3,     3,     1,     1,
+       1,     1,     1,     1,     1,     2,     7,     2,     4,     0,
+       1
 };
 
 
+enum { YYENOMEM = -2 };
+
 #define yyerrok         (yyerrstatus = 0)
 #define yyclearin       (yychar = YYEMPTY)
-#define YYEMPTY         (-2)
-#define YYEOF           0
 
 #define YYACCEPT        goto yyacceptlab
 #define YYABORT         goto yyabortlab
 #define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
 
 
 #define YYRECOVERING()  (!!yyerrstatus)
@@ -930,10 +1069,9 @@ static const yytype_int8 yyr2[] =
       }                                                           \
   while (0)
 
-/* Error token number */
-#define YYTERROR        1
-#define YYERRCODE       256
-
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
 
 /* YYLLOC_DEFAULT -- Set CURRENT to span from RHS[1] to RHS[N].
    If N is 0, then set CURRENT to the empty location which ends
@@ -977,12 +1115,19 @@ do {                                            \
 } while (0)
 
 
-/* YY_LOCATION_PRINT -- Print the location on the stream.
+/* YYLOCATION_PRINT -- Print the location on the stream.
    This macro was not mandated originally: define only if we know
    we won't break user code: when these are the locations we know.  */
 
-#ifndef YY_LOCATION_PRINT
-# if defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL
+# ifndef YYLOCATION_PRINT
+
+#  if defined YY_LOCATION_PRINT
+
+   /* Temporary convenience wrapper in case some people defined the
+      undocumented and private YY_LOCATION_PRINT macros.  */
+#   define YYLOCATION_PRINT(File, Loc)  YY_LOCATION_PRINT(File, *(Loc))
+
+#  elif defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL
 
 /* Print *YYLOCP on YYO.  Private, do not rely on its existence. */
 
@@ -1010,24 +1155,32 @@ yy_location_print_ (FILE *yyo, YYLTYPE const * const yylocp)
         res += YYFPRINTF (yyo, "-%d", end_col);
     }
   return res;
- }
+}
 
-#  define YY_LOCATION_PRINT(File, Loc)          \
-  yy_location_print_ (File, &(Loc))
+#   define YYLOCATION_PRINT  yy_location_print_
 
-# else
-#  define YY_LOCATION_PRINT(File, Loc) ((void) 0)
-# endif
-#endif
+    /* Temporary convenience wrapper in case some people defined the
+       undocumented and private YY_LOCATION_PRINT macros.  */
+#   define YY_LOCATION_PRINT(File, Loc)  YYLOCATION_PRINT(File, &(Loc))
+
+#  else
+
+#   define YYLOCATION_PRINT(File, Loc) ((void) 0)
+    /* Temporary convenience wrapper in case some people defined the
+       undocumented and private YY_LOCATION_PRINT macros.  */
+#   define YY_LOCATION_PRINT  YYLOCATION_PRINT
 
+#  endif
+# endif /* !defined YYLOCATION_PRINT */
 
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)                    \
+
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
 do {                                                                      \
   if (yydebug)                                                            \
     {                                                                     \
       YYFPRINTF (stderr, "%s ", Title);                                   \
       yy_symbol_print (stderr,                                            \
-                  Type, Value, Location, sql_string, sql_result, scanner); \
+                  Kind, Value, Location, sql_string, sql_result, scanner); \
       YYFPRINTF (stderr, "\n");                                           \
     }                                                                     \
 } while (0)
@@ -1038,22 +1191,19 @@ do {                                                                      \
 `-----------------------------------*/
 
 static void
-yy_symbol_value_print (FILE *yyo, int yytype, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, const char * sql_string, ParsedSqlResult * sql_result, void * scanner)
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, const char * sql_string, ParsedSqlResult * sql_result, void * scanner)
 {
   FILE *yyoutput = yyo;
-  YYUSE (yyoutput);
-  YYUSE (yylocationp);
-  YYUSE (sql_string);
-  YYUSE (sql_result);
-  YYUSE (scanner);
+  YY_USE (yyoutput);
+  YY_USE (yylocationp);
+  YY_USE (sql_string);
+  YY_USE (sql_result);
+  YY_USE (scanner);
   if (!yyvaluep)
     return;
-# ifdef YYPRINT
-  if (yytype < YYNTOKENS)
-    YYPRINT (yyo, yytoknum[yytype], *yyvaluep);
-# endif
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-  YYUSE (yytype);
+  YY_USE (yykind);
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
@@ -1063,14 +1213,15 @@ yy_symbol_value_print (FILE *yyo, int yytype, YYSTYPE const * const yyvaluep, YY
 `---------------------------*/
 
 static void
-yy_symbol_print (FILE *yyo, int yytype, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, const char * sql_string, ParsedSqlResult * sql_result, void * scanner)
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, const char * sql_string, ParsedSqlResult * sql_result, void * scanner)
 {
   YYFPRINTF (yyo, "%s %s (",
-             yytype < YYNTOKENS ? "token" : "nterm", yytname[yytype]);
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
 
-  YY_LOCATION_PRINT (yyo, *yylocationp);
+  YYLOCATION_PRINT (yyo, yylocationp);
   YYFPRINTF (yyo, ": ");
-  yy_symbol_value_print (yyo, yytype, yyvaluep, yylocationp, sql_string, sql_result, scanner);
+  yy_symbol_value_print (yyo, yykind, yyvaluep, yylocationp, sql_string, sql_result, scanner);
   YYFPRINTF (yyo, ")");
 }
 
@@ -1103,7 +1254,8 @@ do {                                                            \
 `------------------------------------------------*/
 
 static void
-yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp, YYLTYPE *yylsp, int yyrule, const char * sql_string, ParsedSqlResult * sql_result, void * scanner)
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp, YYLTYPE *yylsp,
+                 int yyrule, const char * sql_string, ParsedSqlResult * sql_result, void * scanner)
 {
   int yylno = yyrline[yyrule];
   int yynrhs = yyr2[yyrule];
@@ -1115,9 +1267,9 @@ yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp, YYLTYPE *yylsp, int yyrule,
     {
       YYFPRINTF (stderr, "   $%d = ", yyi + 1);
       yy_symbol_print (stderr,
-                       yystos[+yyssp[yyi + 1 - yynrhs]],
-                       &yyvsp[(yyi + 1) - (yynrhs)]
-                       , &(yylsp[(yyi + 1) - (yynrhs)])                       , sql_string, sql_result, scanner);
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)],
+                       &(yylsp[(yyi + 1) - (yynrhs)]), sql_string, sql_result, scanner);
       YYFPRINTF (stderr, "\n");
     }
 }
@@ -1132,8 +1284,8 @@ do {                                    \
    multiple parsers can coexist.  */
 int yydebug;
 #else /* !YYDEBUG */
-# define YYDPRINTF(Args)
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
 # define YY_STACK_PRINT(Bottom, Top)
 # define YY_REDUCE_PRINT(Rule)
 #endif /* !YYDEBUG */
@@ -1156,12 +1308,61 @@ int yydebug;
 #endif
 
 
-#if YYERROR_VERBOSE
+/* Context of a parse error.  */
+typedef struct
+{
+  yy_state_t *yyssp;
+  yysymbol_kind_t yytoken;
+  YYLTYPE *yylloc;
+} yypcontext_t;
+
+/* Put in YYARG at most YYARGN of the expected tokens given the
+   current YYCTX, and return the number of tokens stored in YYARG.  If
+   YYARG is null, return the number of expected tokens (guaranteed to
+   be less than YYNTOKENS).  Return YYENOMEM on memory exhaustion.
+   Return 0 if there are more than YYARGN expected tokens, yet fill
+   YYARG up to YYARGN. */
+static int
+yypcontext_expected_tokens (const yypcontext_t *yyctx,
+                            yysymbol_kind_t yyarg[], int yyargn)
+{
+  /* Actual size of YYARG. */
+  int yycount = 0;
+  int yyn = yypact[+*yyctx->yyssp];
+  if (!yypact_value_is_default (yyn))
+    {
+      /* Start YYX at -YYN if negative to avoid negative indexes in
+         YYCHECK.  In other words, skip the first -YYN actions for
+         this state because they are default actions.  */
+      int yyxbegin = yyn < 0 ? -yyn : 0;
+      /* Stay within bounds of both yycheck and yytname.  */
+      int yychecklim = YYLAST - yyn + 1;
+      int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
+      int yyx;
+      for (yyx = yyxbegin; yyx < yyxend; ++yyx)
+        if (yycheck[yyx + yyn] == yyx && yyx != YYSYMBOL_YYerror
+            && !yytable_value_is_error (yytable[yyx + yyn]))
+          {
+            if (!yyarg)
+              ++yycount;
+            else if (yycount == yyargn)
+              return 0;
+            else
+              yyarg[yycount++] = YY_CAST (yysymbol_kind_t, yyx);
+          }
+    }
+  if (yyarg && yycount == 0 && 0 < yyargn)
+    yyarg[0] = YYSYMBOL_YYEMPTY;
+  return yycount;
+}
+
+
 
-# ifndef yystrlen
-#  if defined __GLIBC__ && defined _STRING_H
-#   define yystrlen(S) (YY_CAST (YYPTRDIFF_T, strlen (S)))
-#  else
+
+#ifndef yystrlen
+# if defined __GLIBC__ && defined _STRING_H
+#  define yystrlen(S) (YY_CAST (YYPTRDIFF_T, strlen (S)))
+# else
 /* Return the length of YYSTR.  */
 static YYPTRDIFF_T
 yystrlen (const char *yystr)
@@ -1171,13 +1372,13 @@ yystrlen (const char *yystr)
     continue;
   return yylen;
 }
-#  endif
 # endif
+#endif
 
-# ifndef yystpcpy
-#  if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
-#   define yystpcpy stpcpy
-#  else
+#ifndef yystpcpy
+# if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
+#  define yystpcpy stpcpy
+# else
 /* Copy YYSRC to YYDEST, returning the address of the terminating '\0' in
    YYDEST.  */
 static char *
@@ -1191,10 +1392,10 @@ yystpcpy (char *yydest, const char *yysrc)
 
   return yyd - 1;
 }
-#  endif
 # endif
+#endif
 
-# ifndef yytnamerr
+#ifndef yytnamerr
 /* Copy to YYRES the contents of YYSTR after stripping away unnecessary
    quotes and backslashes, so that it's suitable for yyerror.  The
    heuristic is that double-quoting is unnecessary unless the string
@@ -1209,7 +1410,6 @@ yytnamerr (char *yyres, const char *yystr)
     {
       YYPTRDIFF_T yyn = 0;
       char const *yyp = yystr;
-
       for (;;)
         switch (*++yyp)
           {
@@ -1243,31 +1443,15 @@ yytnamerr (char *yyres, const char *yystr)
   else
     return yystrlen (yystr);
 }
-# endif
+#endif
 
-/* Copy into *YYMSG, which is of size *YYMSG_ALLOC, an error message
-   about the unexpected token YYTOKEN for the state stack whose top is
-   YYSSP.
 
-   Return 0 if *YYMSG was successfully written.  Return 1 if *YYMSG is
-   not large enough to hold the message.  In that case, also set
-   *YYMSG_ALLOC to the required number of bytes.  Return 2 if the
-   required number of bytes is too large to store.  */
 static int
-yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
-                yy_state_t *yyssp, int yytoken)
+yy_syntax_error_arguments (const yypcontext_t *yyctx,
+                           yysymbol_kind_t yyarg[], int yyargn)
 {
-  enum { YYERROR_VERBOSE_ARGS_MAXIMUM = 5 };
-  /* Internationalized format string. */
-  const char *yyformat = YY_NULLPTR;
-  /* Arguments of yyformat: reported tokens (one for the "unexpected",
-     one per "expected"). */
-  char const *yyarg[YYERROR_VERBOSE_ARGS_MAXIMUM];
   /* Actual size of YYARG. */
   int yycount = 0;
-  /* Cumulated lengths of YYARG.  */
-  YYPTRDIFF_T yysize = 0;
-
   /* There are many possibilities here to consider:
      - If this state is a consistent state with a default action, then
        the only way this function was invoked is if the default action
@@ -1291,52 +1475,54 @@ yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
        one exception: it will still contain any token that will not be
        accepted due to an error action in a later state.
   */
-  if (yytoken != YYEMPTY)
+  if (yyctx->yytoken != YYSYMBOL_YYEMPTY)
     {
-      int yyn = yypact[+*yyssp];
-      YYPTRDIFF_T yysize0 = yytnamerr (YY_NULLPTR, yytname[yytoken]);
-      yysize = yysize0;
-      yyarg[yycount++] = yytname[yytoken];
-      if (!yypact_value_is_default (yyn))
-        {
-          /* Start YYX at -YYN if negative to avoid negative indexes in
-             YYCHECK.  In other words, skip the first -YYN actions for
-             this state because they are default actions.  */
-          int yyxbegin = yyn < 0 ? -yyn : 0;
-          /* Stay within bounds of both yycheck and yytname.  */
-          int yychecklim = YYLAST - yyn + 1;
-          int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
-          int yyx;
-
-          for (yyx = yyxbegin; yyx < yyxend; ++yyx)
-            if (yycheck[yyx + yyn] == yyx && yyx != YYTERROR
-                && !yytable_value_is_error (yytable[yyx + yyn]))
-              {
-                if (yycount == YYERROR_VERBOSE_ARGS_MAXIMUM)
-                  {
-                    yycount = 1;
-                    yysize = yysize0;
-                    break;
-                  }
-                yyarg[yycount++] = yytname[yyx];
-                {
-                  YYPTRDIFF_T yysize1
-                    = yysize + yytnamerr (YY_NULLPTR, yytname[yyx]);
-                  if (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM)
-                    yysize = yysize1;
-                  else
-                    return 2;
-                }
-              }
-        }
+      int yyn;
+      if (yyarg)
+        yyarg[yycount] = yyctx->yytoken;
+      ++yycount;
+      yyn = yypcontext_expected_tokens (yyctx,
+                                        yyarg ? yyarg + 1 : yyarg, yyargn - 1);
+      if (yyn == YYENOMEM)
+        return YYENOMEM;
+      else
+        yycount += yyn;
     }
+  return yycount;
+}
+
+/* Copy into *YYMSG, which is of size *YYMSG_ALLOC, an error message
+   about the unexpected token YYTOKEN for the state stack whose top is
+   YYSSP.
+
+   Return 0 if *YYMSG was successfully written.  Return -1 if *YYMSG is
+   not large enough to hold the message.  In that case, also set
+   *YYMSG_ALLOC to the required number of bytes.  Return YYENOMEM if the
+   required number of bytes is too large to store.  */
+static int
+yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
+                const yypcontext_t *yyctx)
+{
+  enum { YYARGS_MAX = 5 };
+  /* Internationalized format string. */
+  const char *yyformat = YY_NULLPTR;
+  /* Arguments of yyformat: reported tokens (one for the "unexpected",
+     one per "expected"). */
+  yysymbol_kind_t yyarg[YYARGS_MAX];
+  /* Cumulated lengths of YYARG.  */
+  YYPTRDIFF_T yysize = 0;
+
+  /* Actual size of YYARG. */
+  int yycount = yy_syntax_error_arguments (yyctx, yyarg, YYARGS_MAX);
+  if (yycount == YYENOMEM)
+    return YYENOMEM;
 
   switch (yycount)
     {
-# define YYCASE_(N, S)                      \
+#define YYCASE_(N, S)                       \
       case N:                               \
         yyformat = S;                       \
-      break
+        break
     default: /* Avoid compiler warnings. */
       YYCASE_(0, YY_("syntax error"));
       YYCASE_(1, YY_("syntax error, unexpected %s"));
@@ -1344,17 +1530,23 @@ yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
       YYCASE_(3, YY_("syntax error, unexpected %s, expecting %s or %s"));
       YYCASE_(4, YY_("syntax error, unexpected %s, expecting %s or %s or %s"));
       YYCASE_(5, YY_("syntax error, unexpected %s, expecting %s or %s or %s or %s"));
-# undef YYCASE_
+#undef YYCASE_
     }
 
+  /* Compute error message size.  Don't count the "%s"s, but reserve
+     room for the terminator.  */
+  yysize = yystrlen (yyformat) - 2 * yycount + 1;
   {
-    /* Don't count the "%s"s in the final size, but reserve room for
-       the terminator.  */
-    YYPTRDIFF_T yysize1 = yysize + (yystrlen (yyformat) - 2 * yycount) + 1;
-    if (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM)
-      yysize = yysize1;
-    else
-      return 2;
+    int yyi;
+    for (yyi = 0; yyi < yycount; ++yyi)
+      {
+        YYPTRDIFF_T yysize1
+          = yysize + yytnamerr (YY_NULLPTR, yytname[yyarg[yyi]]);
+        if (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM)
+          yysize = yysize1;
+        else
+          return YYENOMEM;
+      }
   }
 
   if (*yymsg_alloc < yysize)
@@ -1363,7 +1555,7 @@ yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
       if (! (yysize <= *yymsg_alloc
              && *yymsg_alloc <= YYSTACK_ALLOC_MAXIMUM))
         *yymsg_alloc = YYSTACK_ALLOC_MAXIMUM;
-      return 1;
+      return -1;
     }
 
   /* Avoid sprintf, as that infringes on the user's name space.
@@ -1375,7 +1567,7 @@ yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
     while ((*yyp = *yyformat) != '\0')
       if (*yyp == '%' && yyformat[1] == 's' && yyi < yycount)
         {
-          yyp += yytnamerr (yyp, yyarg[yyi++]);
+          yyp += yytnamerr (yyp, yytname[yyarg[yyi++]]);
           yyformat += 2;
         }
       else
@@ -1386,32 +1578,35 @@ yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
   }
   return 0;
 }
-#endif /* YYERROR_VERBOSE */
+
 
 /*-----------------------------------------------.
 | Release the memory associated to this symbol.  |
 `-----------------------------------------------*/
 
 static void
-yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep, YYLTYPE *yylocationp, const char * sql_string, ParsedSqlResult * sql_result, void * scanner)
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep, YYLTYPE *yylocationp, const char * sql_string, ParsedSqlResult * sql_result, void * scanner)
 {
-  YYUSE (yyvaluep);
-  YYUSE (yylocationp);
-  YYUSE (sql_string);
-  YYUSE (sql_result);
-  YYUSE (scanner);
+  YY_USE (yyvaluep);
+  YY_USE (yylocationp);
+  YY_USE (sql_string);
+  YY_USE (sql_result);
+  YY_USE (scanner);
   if (!yymsg)
     yymsg = "Deleting";
-  YY_SYMBOL_PRINT (yymsg, yytype, yyvaluep, yylocationp);
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
 
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-  YYUSE (yytype);
+  YY_USE (yykind);
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
 
 
 
+
+
 /*----------.
 | yyparse.  |
 `----------*/
@@ -1419,7 +1614,7 @@ yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep, YYLTYPE *yylocatio
 int
 yyparse (const char * sql_string, ParsedSqlResult * sql_result, void * scanner)
 {
-/* The lookahead symbol.  */
+/* Lookahead token kind.  */
 int yychar;
 
 
@@ -1438,55 +1633,50 @@ static YYLTYPE yyloc_default
 YYLTYPE yylloc = yyloc_default;
 
     /* Number of syntax errors so far.  */
-    int yynerrs;
+    int yynerrs = 0;
 
-    yy_state_fast_t yystate;
+    yy_state_fast_t yystate = 0;
     /* Number of tokens to shift before error messages enabled.  */
-    int yyerrstatus;
+    int yyerrstatus = 0;
 
-    /* The stacks and their tools:
-       'yyss': related to states.
-       'yyvs': related to semantic values.
-       'yyls': related to locations.
-
-       Refer to the stacks through separate pointers, to allow yyoverflow
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
        to reallocate them elsewhere.  */
 
-    /* The state stack.  */
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
+
+    /* The state stack: array, bottom, top.  */
     yy_state_t yyssa[YYINITDEPTH];
-    yy_state_t *yyss;
-    yy_state_t *yyssp;
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
 
-    /* The semantic value stack.  */
+    /* The semantic value stack: array, bottom, top.  */
     YYSTYPE yyvsa[YYINITDEPTH];
-    YYSTYPE *yyvs;
-    YYSTYPE *yyvsp;
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
 
-    /* The location stack.  */
+    /* The location stack: array, bottom, top.  */
     YYLTYPE yylsa[YYINITDEPTH];
-    YYLTYPE *yyls;
-    YYLTYPE *yylsp;
-
-    /* The locations where the error started and ended.  */
-    YYLTYPE yyerror_range[3];
-
-    YYPTRDIFF_T yystacksize;
+    YYLTYPE *yyls = yylsa;
+    YYLTYPE *yylsp = yyls;
 
   int yyn;
+  /* The return value of yyparse.  */
   int yyresult;
-  /* Lookahead token as an internal (translated) token number.  */
-  int yytoken = 0;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
   /* The variables used to return semantic value and location from the
      action routines.  */
   YYSTYPE yyval;
   YYLTYPE yyloc;
 
-#if YYERROR_VERBOSE
+  /* The locations where the error started and ended.  */
+  YYLTYPE yyerror_range[3];
+
   /* Buffer for error messages, and its allocated size.  */
   char yymsgbuf[128];
   char *yymsg = yymsgbuf;
   YYPTRDIFF_T yymsg_alloc = sizeof yymsgbuf;
-#endif
 
 #define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N), yylsp -= (N))
 
@@ -1494,17 +1684,10 @@ YYLTYPE yylloc = yyloc_default;
      Keep to zero when no symbol should be popped.  */
   int yylen = 0;
 
-  yyssp = yyss = yyssa;
-  yyvsp = yyvs = yyvsa;
-  yylsp = yyls = yylsa;
-  yystacksize = YYINITDEPTH;
-
   YYDPRINTF ((stderr, "Starting parse\n"));
 
-  yystate = 0;
-  yyerrstatus = 0;
-  yynerrs = 0;
   yychar = YYEMPTY; /* Cause a token to be read.  */
+
   yylsp[0] = yylloc;
   goto yysetstate;
 
@@ -1527,10 +1710,11 @@ yysetstate:
   YY_IGNORE_USELESS_CAST_BEGIN
   *yyssp = YY_CAST (yy_state_t, yystate);
   YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
 
   if (yyss + yystacksize - 1 <= yyssp)
 #if !defined yyoverflow && !defined YYSTACK_RELOCATE
-    goto yyexhaustedlab;
+    YYNOMEM;
 #else
     {
       /* Get the current used size of the three stacks, in elements.  */
@@ -1561,7 +1745,7 @@ yysetstate:
 # else /* defined YYSTACK_RELOCATE */
       /* Extend the stack our own way.  */
       if (YYMAXDEPTH <= yystacksize)
-        goto yyexhaustedlab;
+        YYNOMEM;
       yystacksize *= 2;
       if (YYMAXDEPTH < yystacksize)
         yystacksize = YYMAXDEPTH;
@@ -1572,11 +1756,11 @@ yysetstate:
           YY_CAST (union yyalloc *,
                    YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
         if (! yyptr)
-          goto yyexhaustedlab;
+          YYNOMEM;
         YYSTACK_RELOCATE (yyss_alloc, yyss);
         YYSTACK_RELOCATE (yyvs_alloc, yyvs);
         YYSTACK_RELOCATE (yyls_alloc, yyls);
-# undef YYSTACK_RELOCATE
+#  undef YYSTACK_RELOCATE
         if (yyss1 != yyssa)
           YYSTACK_FREE (yyss1);
       }
@@ -1596,6 +1780,7 @@ yysetstate:
     }
 #endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
 
+
   if (yystate == YYFINAL)
     YYACCEPT;
 
@@ -1616,18 +1801,30 @@ yybackup:
 
   /* Not known => get a lookahead token if don't already have one.  */
 
-  /* YYCHAR is either YYEMPTY or YYEOF or a valid lookahead symbol.  */
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
   if (yychar == YYEMPTY)
     {
-      YYDPRINTF ((stderr, "Reading a token: "));
+      YYDPRINTF ((stderr, "Reading a token\n"));
       yychar = yylex (&yylval, &yylloc, scanner);
     }
 
   if (yychar <= YYEOF)
     {
-      yychar = yytoken = YYEOF;
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
       YYDPRINTF ((stderr, "Now at end of input.\n"));
     }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      yyerror_range[1] = yylloc;
+      goto yyerrlab1;
+    }
   else
     {
       yytoken = YYTRANSLATE (yychar);
@@ -1699,416 +1896,542 @@ yyreduce:
   YY_REDUCE_PRINT (yyn);
   switch (yyn)
     {
-  case 2:
-#line 205 "yacc_sql.y"
+  case 2: /* commands: command_wrapper opt_semicolon  */
+#line 320 "yacc_sql.y"
   {
-    std::unique_ptr<ParsedSqlNode> sql_node = std::unique_ptr<ParsedSqlNode>((yyvsp[-1].sql_node));
-    sql_result->add_sql_node(std::move(sql_node));
+    sql_result->add_sql_node((yyvsp[-1].sql_node));
   }
-#line 1709 "yacc_sql.cpp"
+#line 1905 "yacc_sql.cpp"
     break;
 
-  case 23:
-#line 235 "yacc_sql.y"
+  case 25: /* exit_stmt: EXIT  */
+#line 351 "yacc_sql.y"
          {
       (void)yynerrs;  // 这么写为了消除yynerrs未使用的告警。如果你有更好的方法欢迎提PR
-      (yyval.sql_node) = new ParsedSqlNode(SCF_EXIT);
+      (yyval.sql_node) = create_node<ParsedSqlNode>(scanner, SCF_EXIT);
     }
-#line 1718 "yacc_sql.cpp"
+#line 1914 "yacc_sql.cpp"
     break;
 
-  case 24:
-#line 241 "yacc_sql.y"
+  case 26: /* help_stmt: HELP  */
+#line 357 "yacc_sql.y"
          {
-      (yyval.sql_node) = new ParsedSqlNode(SCF_HELP);
+      (yyval.sql_node) = create_node<ParsedSqlNode>(scanner, SCF_HELP);
     }
-#line 1726 "yacc_sql.cpp"
+#line 1922 "yacc_sql.cpp"
     break;
 
-  case 25:
-#line 246 "yacc_sql.y"
+  case 27: /* sync_stmt: SYNC  */
+#line 362 "yacc_sql.y"
          {
-      (yyval.sql_node) = new ParsedSqlNode(SCF_SYNC);
+      (yyval.sql_node) = create_node<ParsedSqlNode>(scanner, SCF_SYNC);
     }
-#line 1734 "yacc_sql.cpp"
+#line 1930 "yacc_sql.cpp"
     break;
 
-  case 26:
-#line 252 "yacc_sql.y"
+  case 28: /* begin_stmt: TRX_BEGIN  */
+#line 368 "yacc_sql.y"
                {
-      (yyval.sql_node) = new ParsedSqlNode(SCF_BEGIN);
+      (yyval.sql_node) = create_node<ParsedSqlNode>(scanner, SCF_BEGIN);
     }
-#line 1742 "yacc_sql.cpp"
+#line 1938 "yacc_sql.cpp"
     break;
 
-  case 27:
-#line 258 "yacc_sql.y"
+  case 29: /* commit_stmt: TRX_COMMIT  */
+#line 374 "yacc_sql.y"
                {
-      (yyval.sql_node) = new ParsedSqlNode(SCF_COMMIT);
+      (yyval.sql_node) = create_node<ParsedSqlNode>(scanner, SCF_COMMIT);
     }
-#line 1750 "yacc_sql.cpp"
+#line 1946 "yacc_sql.cpp"
     break;
 
-  case 28:
-#line 264 "yacc_sql.y"
+  case 30: /* rollback_stmt: TRX_ROLLBACK  */
+#line 380 "yacc_sql.y"
                   {
-      (yyval.sql_node) = new ParsedSqlNode(SCF_ROLLBACK);
+      (yyval.sql_node) = create_node<ParsedSqlNode>(scanner, SCF_ROLLBACK);
     }
-#line 1758 "yacc_sql.cpp"
+#line 1954 "yacc_sql.cpp"
     break;
 
-  case 29:
-#line 270 "yacc_sql.y"
-                  {
-      (yyval.sql_node) = new ParsedSqlNode(SCF_DROP_TABLE);
+  case 31: /* drop_table_stmt: DROP TABLE identifier  */
+#line 386 "yacc_sql.y"
+                          {
+      (yyval.sql_node) = create_node<ParsedSqlNode>(scanner, SCF_DROP_TABLE);
       (yyval.sql_node)->drop_table.relation_name = (yyvsp[0].string);
-      free((yyvsp[0].string));
     }
-#line 1768 "yacc_sql.cpp"
+#line 1963 "yacc_sql.cpp"
     break;
 
-  case 30:
-#line 277 "yacc_sql.y"
+  case 32: /* show_tables_stmt: SHOW TABLES  */
+#line 392 "yacc_sql.y"
                 {
-      (yyval.sql_node) = new ParsedSqlNode(SCF_SHOW_TABLES);
+      (yyval.sql_node) = create_node<ParsedSqlNode>(scanner, SCF_SHOW_TABLES);
     }
-#line 1776 "yacc_sql.cpp"
+#line 1971 "yacc_sql.cpp"
     break;
 
-  case 31:
-#line 283 "yacc_sql.y"
-             {
-      (yyval.sql_node) = new ParsedSqlNode(SCF_DESC_TABLE);
+  case 33: /* desc_table_stmt: DESC identifier  */
+#line 398 "yacc_sql.y"
+                     {
+      (yyval.sql_node) = create_node<ParsedSqlNode>(scanner, SCF_DESC_TABLE);
       (yyval.sql_node)->desc_table.relation_name = (yyvsp[0].string);
-      free((yyvsp[0].string));
     }
-#line 1786 "yacc_sql.cpp"
+#line 1980 "yacc_sql.cpp"
+    break;
+
+  case 34: /* analyze_table_stmt: ANALYZE TABLE identifier  */
+#line 405 "yacc_sql.y"
+                             {
+      (yyval.sql_node) = create_node<ParsedSqlNode>(scanner, SCF_ANALYZE_TABLE);
+      (yyval.sql_node)->analyze_table.relation_name = (yyvsp[0].string);
+    }
+#line 1989 "yacc_sql.cpp"
     break;
 
-  case 32:
-#line 292 "yacc_sql.y"
+  case 35: /* reset_stmt: RESET identifier  */
+#line 412 "yacc_sql.y"
+                     {
+      (yyval.sql_node) = create_node<ParsedSqlNode>(scanner, SCF_RESET);
+      (yyval.sql_node)->reset.name = (yyvsp[0].string);
+    }
+#line 1998 "yacc_sql.cpp"
+    break;
+
+  case 36: /* create_index_stmt: CREATE INDEX identifier ON identifier LBRACE id_list RBRACE  */
+#line 420 "yacc_sql.y"
     {
-      (yyval.sql_node) = new ParsedSqlNode(SCF_CREATE_INDEX);
+      (yyval.sql_node) = create_node<ParsedSqlNode>(scanner, SCF_CREATE_INDEX);
       CreateIndexSqlNode &create_index = (yyval.sql_node)->create_index;
       create_index.index_name = (yyvsp[-5].string);
       create_index.relation_name = (yyvsp[-3].string);
       create_index.attribute_names.swap(*(yyvsp[-1].id_list));
       std::reverse(create_index.attribute_names.begin(), create_index.attribute_names.end());
-      free((yyvsp[-5].string));
-      free((yyvsp[-3].string));
-      free((yyvsp[-1].id_list));
     }
-#line 1802 "yacc_sql.cpp"
+#line 2011 "yacc_sql.cpp"
     break;
 
-  case 33:
-#line 306 "yacc_sql.y"
-      {
-      (yyval.id_list) = new std::vector<std::string>;
+  case 37: /* identifier: ID  */
+#line 432 "yacc_sql.y"
+       {
+      (yyval.string) = (yyvsp[0].string);
+    }
+#line 2019 "yacc_sql.cpp"
+    break;
+
+  case 38: /* identifier: ANALYZE  */
+#line 435 "yacc_sql.y"
+              {
+      (yyval.string) = (yyvsp[0].string);
+    }
+#line 2027 "yacc_sql.cpp"
+    break;
+
+  case 39: /* identifier: RESET  */
+#line 438 "yacc_sql.y"
+            {
+      (yyval.string) = (yyvsp[0].string);
+    }
+#line 2035 "yacc_sql.cpp"
+    break;
+
+  case 40: /* id_list: identifier  */
+#line 444 "yacc_sql.y"
+              {
+      (yyval.id_list) = create_node<std::vector<std::string>>(scanner);
       std::string attr_name = (yyvsp[0].string);
       (yyval.id_list)->push_back(attr_name);
-      free((yyvsp[0].string));
     }
-#line 1813 "yacc_sql.cpp"
+#line 2045 "yacc_sql.cpp"
     break;
 
-  case 34:
-#line 313 "yacc_sql.y"
+  case 41: /* id_list: identifier COMMA id_list  */
+#line 450 "yacc_sql.y"
     {
       if ((yyvsp[0].id_list) != nullptr) {
         (yyval.id_list) = (yyvsp[0].id_list);
       }
       std::string attr_name = (yyvsp[-2].string);
       (yyval.id_list)->push_back(attr_name);
-      free((yyvsp[-2].string));
     }
-#line 1826 "yacc_sql.cpp"
+#line 2057 "yacc_sql.cpp"
     break;
 
-  case 35:
-#line 324 "yacc_sql.y"
+  case 42: /* drop_index_stmt: DROP INDEX identifier ON identifier  */
+#line 460 "yacc_sql.y"
     {
-      (yyval.sql_node) = new ParsedSqlNode(SCF_DROP_INDEX);
+      (yyval.sql_node) = create_node<ParsedSqlNode>(scanner, SCF_DROP_INDEX);
       (yyval.sql_node)->drop_index.index_name = (yyvsp[-2].string);
       (yyval.sql_node)->drop_index.relation_name = (yyvsp[0].string);
-      free((yyvsp[-2].string));
-      free((yyvsp[0].string));
     }
-#line 1838 "yacc_sql.cpp"
+#line 2067 "yacc_sql.cpp"
     break;
 
-  case 36:
-#line 334 "yacc_sql.y"
+  case 43: /* create_table_stmt: CREATE TABLE identifier LBRACE attr_def attr_def_list RBRACE table_options  */
+#line 468 "yacc_sql.y"
     {
-      (yyval.sql_node) = new ParsedSqlNode(SCF_CREATE_TABLE);
+      (yyval.sql_node) = create_node<ParsedSqlNode>(scanner, SCF_CREATE_TABLE);
       CreateTableSqlNode &create_table = (yyval.sql_node)->create_table;
-      create_table.relation_name = (yyvsp[-4].string);
-      free((yyvsp[-4].string));
+      create_table.relation_name = (yyvsp[-5].string);
 
-      std::vector<AttrInfoSqlNode> *src_attrs = (yyvsp[-1].attr_infos);
+      std::vector<AttrInfoSqlNode> *src_attrs = (yyvsp[-2].attr_infos);
 
       if (src_attrs != nullptr) {
         create_table.attr_infos.swap(*src_attrs);
       }
-      create_table.attr_infos.emplace_back(*(yyvsp[-2].attr_info));
+      create_table.attr_infos.emplace_back(*(yyvsp[-3].attr_info));
       std::reverse(create_table.attr_infos.begin(), create_table.attr_infos.end());
-      delete (yyvsp[-2].attr_info);
+      if ((yyvsp[0].table_options) != nullptr) {
+        create_table.storage_format = (yyvsp[0].table_options)->storage_format;
+        create_table.page_size = (yyvsp[0].table_options)->page_size;
+      }
+    }
+#line 2089 "yacc_sql.cpp"
+    break;
+
+  case 44: /* table_options: %empty  */
+#line 488 "yacc_sql.y"
+    {
+      (yyval.table_options) = nullptr;
     }
-#line 1858 "yacc_sql.cpp"
+#line 2097 "yacc_sql.cpp"
     break;
 
-  case 37:
-#line 352 "yacc_sql.y"
+  case 45: /* table_options: ID LBRACE table_option_list RBRACE  */
+#line 492 "yacc_sql.y"
+    {
+      // WITH (format=row|pax, page_size=N)。这几个词没有作为关键字，按照标识符解析
+      if (0 != strcasecmp((yyvsp[-3].string), "with")) {
+        yyerror(&(yyloc), sql_string, sql_result, scanner, "syntax error");
+        YYERROR;
+      }
+      (yyval.table_options) = (yyvsp[-1].table_options);
+    }
+#line 2110 "yacc_sql.cpp"
+    break;
+
+  case 46: /* table_option_list: ID EQ ID  */
+#line 503 "yacc_sql.y"
+    {
+      (yyval.table_options) = create_node<CreateTableSqlNode>(scanner);
+      if (!set_table_option(*(yyval.table_options), (yyvsp[-2].string), (yyvsp[0].string), 0)) {
+        yyerror(&(yyloc), sql_string, sql_result, scanner, "syntax error");
+        YYERROR;
+      }
+    }
+#line 2122 "yacc_sql.cpp"
+    break;
+
+  case 47: /* table_option_list: ID EQ NUMBER  */
+#line 511 "yacc_sql.y"
+    {
+      (yyval.table_options) = create_node<CreateTableSqlNode>(scanner);
+      if (!set_table_option(*(yyval.table_options), (yyvsp[-2].string), nullptr, (yyvsp[0].number))) {
+        yyerror(&(yyloc), sql_string, sql_result, scanner, "syntax error");
+        YYERROR;
+      }
+    }
+#line 2134 "yacc_sql.cpp"
+    break;
+
+  case 48: /* table_option_list: table_option_list COMMA ID EQ ID  */
+#line 519 "yacc_sql.y"
+    {
+      (yyval.table_options) = (yyvsp[-4].table_options);
+      if (!set_table_option(*(yyval.table_options), (yyvsp[-2].string), (yyvsp[0].string), 0)) {
+        yyerror(&(yyloc), sql_string, sql_result, scanner, "syntax error");
+        YYERROR;
+      }
+    }
+#line 2146 "yacc_sql.cpp"
+    break;
+
+  case 49: /* table_option_list: table_option_list COMMA ID EQ NUMBER  */
+#line 527 "yacc_sql.y"
+    {
+      (yyval.table_options) = (yyvsp[-4].table_options);
+      if (!set_table_option(*(yyval.table_options), (yyvsp[-2].string), nullptr, (yyvsp[0].number))) {
+        yyerror(&(yyloc), sql_string, sql_result, scanner, "syntax error");
+        YYERROR;
+      }
+    }
+#line 2158 "yacc_sql.cpp"
+    break;
+
+  case 50: /* attr_def_list: %empty  */
+#line 537 "yacc_sql.y"
     {
       (yyval.attr_infos) = nullptr;
     }
-#line 1866 "yacc_sql.cpp"
+#line 2166 "yacc_sql.cpp"
     break;
 
-  case 38:
-#line 356 "yacc_sql.y"
+  case 51: /* attr_def_list: COMMA attr_def attr_def_list  */
+#line 541 "yacc_sql.y"
     {
       if ((yyvsp[0].attr_infos) != nullptr) {
         (yyval.attr_infos) = (yyvsp[0].attr_infos);
       } else {
-        (yyval.attr_infos) = new std::vector<AttrInfoSqlNode>;
+        (yyval.attr_infos) = create_node<std::vector<AttrInfoSqlNode>>(scanner);
       }
       (yyval.attr_infos)->emplace_back(*(yyvsp[-1].attr_info));
-      delete (yyvsp[-1].attr_info);
     }
-#line 1880 "yacc_sql.cpp"
+#line 2179 "yacc_sql.cpp"
     break;
 
-  case 39:
-#line 369 "yacc_sql.y"
+  case 52: /* attr_def: identifier type LBRACE number RBRACE  */
+#line 553 "yacc_sql.y"
     {
-      (yyval.attr_info) = new AttrInfoSqlNode;
+      (yyval.attr_info) = create_node<AttrInfoSqlNode>(scanner);
       (yyval.attr_info)->type = (AttrType)(yyvsp[-3].number);
       (yyval.attr_info)->name = (yyvsp[-4].string);
       (yyval.attr_info)->length = (yyvsp[-1].number);
-      free((yyvsp[-4].string));
     }
-#line 1892 "yacc_sql.cpp"
+#line 2190 "yacc_sql.cpp"
     break;
 
-  case 40:
-#line 377 "yacc_sql.y"
+  case 53: /* attr_def: identifier type  */
+#line 560 "yacc_sql.y"
     {
-      (yyval.attr_info) = new AttrInfoSqlNode;
+      (yyval.attr_info) = create_node<AttrInfoSqlNode>(scanner);
       (yyval.attr_info)->type = (AttrType)(yyvsp[0].number);
       (yyval.attr_info)->name = (yyvsp[-1].string);
       (yyval.attr_info)->length = 4;
-      free((yyvsp[-1].string));
     }
-#line 1904 "yacc_sql.cpp"
+#line 2201 "yacc_sql.cpp"
     break;
 
-  case 41:
-#line 386 "yacc_sql.y"
+  case 54: /* attr_def: identifier ID LBRACE number RBRACE  */
+#line 567 "yacc_sql.y"
+    {
+      // VARCHAR 没有作为关键字，按照标识符解析
+      if (0 != strcasecmp((yyvsp[-3].string), "varchar")) {
+        yyerror(&(yyloc), sql_string, sql_result, scanner, "syntax error");
+        YYERROR;
+      }
+      (yyval.attr_info) = create_node<AttrInfoSqlNode>(scanner);
+      (yyval.attr_info)->type = CHARS;
+      (yyval.attr_info)->name = (yyvsp[-4].string);
+      (yyval.attr_info)->length = (yyvsp[-1].number);
+      (yyval.attr_info)->var_len = true;
+    }
+#line 2218 "yacc_sql.cpp"
+    break;
+
+  case 55: /* number: NUMBER  */
+#line 581 "yacc_sql.y"
            {(yyval.number) = (yyvsp[0].number);}
-#line 1910 "yacc_sql.cpp"
+#line 2224 "yacc_sql.cpp"
     break;
 
-  case 42:
-#line 389 "yacc_sql.y"
+  case 56: /* type: INT_T  */
+#line 584 "yacc_sql.y"
                { (yyval.number)=INTS; }
-#line 1916 "yacc_sql.cpp"
+#line 2230 "yacc_sql.cpp"
     break;
 
-  case 43:
-#line 390 "yacc_sql.y"
+  case 57: /* type: STRING_T  */
+#line 585 "yacc_sql.y"
                { (yyval.number)=CHARS; }
-#line 1922 "yacc_sql.cpp"
+#line 2236 "yacc_sql.cpp"
     break;
 
-  case 44:
-#line 391 "yacc_sql.y"
+  case 58: /* type: FLOAT_T  */
+#line 586 "yacc_sql.y"
                { (yyval.number)=FLOATS; }
-#line 1928 "yacc_sql.cpp"
+#line 2242 "yacc_sql.cpp"
     break;
 
-  case 45:
-#line 392 "yacc_sql.y"
+  case 59: /* type: DATE_T  */
+#line 587 "yacc_sql.y"
                { (yyval.number)=DATES; }
-#line 1934 "yacc_sql.cpp"
+#line 2248 "yacc_sql.cpp"
+    break;
+
+  case 60: /* insert_stmt: INSERT INTO identifier VALUES insert_row_list  */
+#line 591 "yacc_sql.y"
+    {
+      (yyval.sql_node) = create_node<ParsedSqlNode>(scanner, SCF_INSERT);
+      (yyval.sql_node)->insertion.relation_name = (yyvsp[-2].string);
+      (yyval.sql_node)->insertion.values.swap(*(yyvsp[0].insert_rows));
+    }
+#line 2258 "yacc_sql.cpp"
+    break;
+
+  case 61: /* insert_row_list: insert_row  */
+#line 601 "yacc_sql.y"
+    {
+      (yyval.insert_rows) = create_node<std::vector<std::vector<Value>>>(scanner);
+      (yyval.insert_rows)->emplace_back(std::move(*(yyvsp[0].value_list)));
+    }
+#line 2267 "yacc_sql.cpp"
+    break;
+
+  case 62: /* insert_row_list: insert_row_list COMMA insert_row  */
+#line 606 "yacc_sql.y"
+    {
+      (yyval.insert_rows) = (yyvsp[-2].insert_rows);
+      (yyval.insert_rows)->emplace_back(std::move(*(yyvsp[0].value_list)));
+    }
+#line 2276 "yacc_sql.cpp"
     break;
 
-  case 46:
-#line 396 "yacc_sql.y"
+  case 63: /* insert_row: LBRACE value value_list RBRACE  */
+#line 614 "yacc_sql.y"
     {
-      (yyval.sql_node) = new ParsedSqlNode(SCF_INSERT);
-      (yyval.sql_node)->insertion.relation_name = (yyvsp[-5].string);
       if ((yyvsp[-1].value_list) != nullptr) {
-        (yyval.sql_node)->insertion.values.swap(*(yyvsp[-1].value_list));
+        (yyval.value_list) = (yyvsp[-1].value_list);
+      } else {
+        (yyval.value_list) = create_node<std::vector<Value>>(scanner);
       }
-      (yyval.sql_node)->insertion.values.emplace_back(*(yyvsp[-2].value));
-      std::reverse((yyval.sql_node)->insertion.values.begin(), (yyval.sql_node)->insertion.values.end());
-      delete (yyvsp[-2].value);
-      free((yyvsp[-5].string));
+      (yyval.value_list)->emplace_back(*(yyvsp[-2].value));
+      std::reverse((yyval.value_list)->begin(), (yyval.value_list)->end());
     }
-#line 1950 "yacc_sql.cpp"
+#line 2290 "yacc_sql.cpp"
     break;
 
-  case 47:
-#line 411 "yacc_sql.y"
+  case 64: /* value_list: %empty  */
+#line 627 "yacc_sql.y"
     {
       (yyval.value_list) = nullptr;
     }
-#line 1958 "yacc_sql.cpp"
+#line 2298 "yacc_sql.cpp"
     break;
 
-  case 48:
-#line 414 "yacc_sql.y"
+  case 65: /* value_list: COMMA value value_list  */
+#line 630 "yacc_sql.y"
                               { 
       if ((yyvsp[0].value_list) != nullptr) {
         (yyval.value_list) = (yyvsp[0].value_list);
       } else {
-        (yyval.value_list) = new std::vector<Value>;
+        (yyval.value_list) = create_node<std::vector<Value>>(scanner);
       }
       (yyval.value_list)->emplace_back(*(yyvsp[-1].value));
-      delete (yyvsp[-1].value);
     }
-#line 1972 "yacc_sql.cpp"
+#line 2311 "yacc_sql.cpp"
     break;
 
-  case 49:
-#line 425 "yacc_sql.y"
+  case 66: /* value: NUMBER  */
+#line 640 "yacc_sql.y"
            {
-      (yyval.value) = new Value((int)(yyvsp[0].number));
+      (yyval.value) = create_node<Value>(scanner, (int)(yyvsp[0].number));
       (yyloc) = (yylsp[0]);
     }
-#line 1981 "yacc_sql.cpp"
+#line 2320 "yacc_sql.cpp"
     break;
 
-  case 50:
-#line 429 "yacc_sql.y"
+  case 67: /* value: FLOAT  */
+#line 644 "yacc_sql.y"
            {
-      (yyval.value) = new Value((float)(yyvsp[0].floats));
+      (yyval.value) = create_node<Value>(scanner, (float)(yyvsp[0].floats));
       (yyloc) = (yylsp[0]);
     }
-#line 1990 "yacc_sql.cpp"
+#line 2329 "yacc_sql.cpp"
     break;
 
-  case 51:
-#line 433 "yacc_sql.y"
+  case 68: /* value: DATE  */
+#line 648 "yacc_sql.y"
            {
-      (yyval.value) = new Value((date)(yyvsp[0].dates));
+      (yyval.value) = create_node<Value>(scanner, (date)(yyvsp[0].dates));
      }
-#line 1998 "yacc_sql.cpp"
+#line 2337 "yacc_sql.cpp"
     break;
 
-  case 52:
-#line 436 "yacc_sql.y"
+  case 69: /* value: SSS  */
+#line 651 "yacc_sql.y"
          {
-      char *tmp = common::substr((yyvsp[0].string),1,strlen((yyvsp[0].string))-2);
-      (yyval.value) = new Value(tmp);
-      free(tmp);
+      // 词法分析返回的字符串在 arena 中，直接去掉两边的引号
+      (yyvsp[0].string)[strlen((yyvsp[0].string)) - 1] = '\0';
+      (yyval.value) = create_node<Value>(scanner, (yyvsp[0].string) + 1);
     }
-#line 2008 "yacc_sql.cpp"
+#line 2347 "yacc_sql.cpp"
     break;
 
-  case 53:
-#line 445 "yacc_sql.y"
+  case 70: /* delete_stmt: DELETE FROM identifier where  */
+#line 660 "yacc_sql.y"
     {
-      (yyval.sql_node) = new ParsedSqlNode(SCF_DELETE);
+      (yyval.sql_node) = create_node<ParsedSqlNode>(scanner, SCF_DELETE);
       (yyval.sql_node)->deletion.relation_name = (yyvsp[-1].string);
       if ((yyvsp[0].condition_list) != nullptr) {
         (yyval.sql_node)->deletion.conditions.swap(*(yyvsp[0].condition_list));
-        delete (yyvsp[0].condition_list);
       }
-      free((yyvsp[-1].string));
     }
-#line 2022 "yacc_sql.cpp"
+#line 2359 "yacc_sql.cpp"
     break;
 
-  case 54:
-#line 457 "yacc_sql.y"
+  case 71: /* update_stmt: UPDATE identifier SET identifier EQ value where  */
+#line 670 "yacc_sql.y"
     {
-      (yyval.sql_node) = new ParsedSqlNode(SCF_UPDATE);
+      (yyval.sql_node) = create_node<ParsedSqlNode>(scanner, SCF_UPDATE);
       (yyval.sql_node)->update.relation_name = (yyvsp[-5].string);
       (yyval.sql_node)->update.attribute_name = (yyvsp[-3].string);
       (yyval.sql_node)->update.value = *(yyvsp[-1].value);
       if ((yyvsp[0].condition_list) != nullptr) {
         (yyval.sql_node)->update.conditions.swap(*(yyvsp[0].condition_list));
-        delete (yyvsp[0].condition_list);
       }
-      free((yyvsp[-5].string));
-      free((yyvsp[-3].string));
     }
-#line 2039 "yacc_sql.cpp"
+#line 2373 "yacc_sql.cpp"
     break;
 
-  case 55:
-#line 472 "yacc_sql.y"
+  case 72: /* select_stmt: SELECT select_exprs FROM identifier rel_list where  */
+#line 682 "yacc_sql.y"
     {
-      (yyval.sql_node) = new ParsedSqlNode(SCF_SELECT);
+      (yyval.sql_node) = create_node<ParsedSqlNode>(scanner, SCF_SELECT);
       if ((yyvsp[-4].s_expr_node_list) != nullptr) {
         (yyval.sql_node)->selection.select_exprs.swap(*(yyvsp[-4].s_expr_node_list));
-        delete (yyvsp[-4].s_expr_node_list);
       }
       if ((yyvsp[-1].relation_list) != nullptr) {
         (yyval.sql_node)->selection.relations.swap(*(yyvsp[-1].relation_list));
-        delete (yyvsp[-1].relation_list);
       }
       (yyval.sql_node)->selection.relations.push_back((yyvsp[-2].string));
       std::reverse((yyval.sql_node)->selection.relations.begin(), (yyval.sql_node)->selection.relations.end());
       
       if ((yyvsp[0].condition_list) != nullptr) {
         (yyval.sql_node)->selection.conditions.swap(*(yyvsp[0].condition_list));
-        delete (yyvsp[0].condition_list);
       }
-      free((yyvsp[-2].string));
     }
-#line 2063 "yacc_sql.cpp"
+#line 2393 "yacc_sql.cpp"
     break;
 
-  case 56:
-#line 492 "yacc_sql.y"
+  case 73: /* select_stmt: SELECT select_exprs FROM identifier join_list where  */
+#line 698 "yacc_sql.y"
     {
-      (yyval.sql_node) = new ParsedSqlNode(SCF_SELECT);
+      (yyval.sql_node) = create_node<ParsedSqlNode>(scanner, SCF_SELECT);
       if ((yyvsp[-4].s_expr_node_list) != nullptr) {    // 属性、聚合
         (yyval.sql_node)->selection.select_exprs.swap(*(yyvsp[-4].s_expr_node_list));
-        delete (yyvsp[-4].s_expr_node_list);
       }
       if ((yyvsp[-1].join_list) != nullptr) {    // join
         (yyval.sql_node)->selection.joins.swap(*(yyvsp[-1].join_list));
-        delete (yyvsp[-1].join_list);
       }
       std::reverse((yyval.sql_node)->selection.joins.begin(), (yyval.sql_node)->selection.joins.end());
       (yyval.sql_node)->selection.relations.push_back((yyvsp[-2].string));
       if ((yyvsp[0].condition_list) != nullptr) {    // where
         (yyval.sql_node)->selection.conditions.swap(*(yyvsp[0].condition_list));
-        delete (yyvsp[0].condition_list);
       }
-      free((yyvsp[-2].string));
     }
-#line 2086 "yacc_sql.cpp"
+#line 2412 "yacc_sql.cpp"
     break;
 
-  case 57:
-#line 514 "yacc_sql.y"
+  case 74: /* join_list: INNER JOIN identifier ON condition_list  */
+#line 716 "yacc_sql.y"
     {
-      (yyval.join_list) = new std::vector<JoinSqlNode>;
+      (yyval.join_list) = create_node<std::vector<JoinSqlNode>>(scanner);
       JoinSqlNode join_node;
       if ((yyvsp[0].condition_list) != nullptr) {
         join_node.conditions.swap(*(yyvsp[0].condition_list));
       }
       join_node.right_rel = (yyvsp[-2].string);
       (yyval.join_list)->emplace_back(join_node);
-
-      free((yyvsp[-2].string));
-      delete (yyvsp[0].condition_list);
     }
-#line 2103 "yacc_sql.cpp"
+#line 2426 "yacc_sql.cpp"
     break;
 
-  case 58:
-#line 527 "yacc_sql.y"
+  case 75: /* join_list: INNER JOIN identifier ON condition_list join_list  */
+#line 726 "yacc_sql.y"
     {
       if ((yyvsp[0].join_list) != nullptr) {
         (yyval.join_list) = (yyvsp[0].join_list);
       } else {
-        (yyval.join_list) = new std::vector<JoinSqlNode>;
+        (yyval.join_list) = create_node<std::vector<JoinSqlNode>>(scanner);
       }
       JoinSqlNode join_node;
       if ((yyvsp[-1].condition_list) != nullptr) {
@@ -2116,249 +2439,241 @@ yyreduce:
       }
       join_node.right_rel = (yyvsp[-3].string);
       (yyval.join_list)->emplace_back(join_node);
-
-      free((yyvsp[-3].string));
-      delete (yyvsp[-1].condition_list);
     }
-#line 2124 "yacc_sql.cpp"
+#line 2444 "yacc_sql.cpp"
     break;
 
-  case 59:
-#line 547 "yacc_sql.y"
+  case 76: /* calc_stmt: CALC expression_list  */
+#line 743 "yacc_sql.y"
     {
-      (yyval.sql_node) = new ParsedSqlNode(SCF_CALC);
+      (yyval.sql_node) = create_node<ParsedSqlNode>(scanner, SCF_CALC);
       std::reverse((yyvsp[0].expression_list)->begin(), (yyvsp[0].expression_list)->end());
       (yyval.sql_node)->calc.expressions.swap(*(yyvsp[0].expression_list));
-      delete (yyvsp[0].expression_list);
     }
-#line 2135 "yacc_sql.cpp"
+#line 2454 "yacc_sql.cpp"
     break;
 
-  case 60:
-#line 557 "yacc_sql.y"
+  case 77: /* expression_list: expression  */
+#line 752 "yacc_sql.y"
     {
-      (yyval.expression_list) = new std::vector<Expression*>;
+      (yyval.expression_list) = create_node<std::vector<Expression*>>(scanner);
       (yyval.expression_list)->emplace_back((yyvsp[0].expression));
     }
-#line 2144 "yacc_sql.cpp"
+#line 2463 "yacc_sql.cpp"
     break;
 
-  case 61:
-#line 562 "yacc_sql.y"
+  case 78: /* expression_list: expression COMMA expression_list  */
+#line 757 "yacc_sql.y"
     {
       if ((yyvsp[0].expression_list) != nullptr) {
         (yyval.expression_list) = (yyvsp[0].expression_list);
       } else {
-        (yyval.expression_list) = new std::vector<Expression *>;
+        (yyval.expression_list) = create_node<std::vector<Expression *>>(scanner);
       }
       (yyval.expression_list)->emplace_back((yyvsp[-2].expression));
     }
-#line 2157 "yacc_sql.cpp"
+#line 2476 "yacc_sql.cpp"
     break;
 
-  case 62:
-#line 572 "yacc_sql.y"
+  case 79: /* expression: expression '+' expression  */
+#line 767 "yacc_sql.y"
                               {
       (yyval.expression) = create_arithmetic_expression(ArithmeticExpr::Type::ADD, (yyvsp[-2].expression), (yyvsp[0].expression), sql_string, &(yyloc));
     }
-#line 2165 "yacc_sql.cpp"
+#line 2484 "yacc_sql.cpp"
     break;
 
-  case 63:
-#line 575 "yacc_sql.y"
+  case 80: /* expression: expression '-' expression  */
+#line 770 "yacc_sql.y"
                                 {
       (yyval.expression) = create_arithmetic_expression(ArithmeticExpr::Type::SUB, (yyvsp[-2].expression), (yyvsp[0].expression), sql_string, &(yyloc));
     }
-#line 2173 "yacc_sql.cpp"
+#line 2492 "yacc_sql.cpp"
     break;
 
-  case 64:
-#line 578 "yacc_sql.y"
+  case 81: /* expression: expression '*' expression  */
+#line 773 "yacc_sql.y"
                                 {
       (yyval.expression) = create_arithmetic_expression(ArithmeticExpr::Type::MUL, (yyvsp[-2].expression), (yyvsp[0].expression), sql_string, &(yyloc));
     }
-#line 2181 "yacc_sql.cpp"
+#line 2500 "yacc_sql.cpp"
     break;
 
-  case 65:
-#line 581 "yacc_sql.y"
+  case 82: /* expression: expression '/' expression  */
+#line 776 "yacc_sql.y"
                                 {
       (yyval.expression) = create_arithmetic_expression(ArithmeticExpr::Type::DIV, (yyvsp[-2].expression), (yyvsp[0].expression), sql_string, &(yyloc));
     }
-#line 2189 "yacc_sql.cpp"
+#line 2508 "yacc_sql.cpp"
     break;
 
-  case 66:
-#line 584 "yacc_sql.y"
+  case 83: /* expression: LBRACE expression RBRACE  */
+#line 779 "yacc_sql.y"
                                {
       (yyval.expression) = (yyvsp[-1].expression);
       (yyval.expression)->set_name(token_name(sql_string, &(yyloc)));
     }
-#line 2198 "yacc_sql.cpp"
+#line 2517 "yacc_sql.cpp"
     break;
 
-  case 67:
-#line 588 "yacc_sql.y"
+  case 84: /* expression: '-' expression  */
+#line 783 "yacc_sql.y"
                                   {
       (yyval.expression) = create_arithmetic_expression(ArithmeticExpr::Type::NEGATIVE, (yyvsp[0].expression), nullptr, sql_string, &(yyloc));
     }
-#line 2206 "yacc_sql.cpp"
+#line 2525 "yacc_sql.cpp"
     break;
 
-  case 68:
-#line 591 "yacc_sql.y"
+  case 85: /* expression: value  */
+#line 786 "yacc_sql.y"
             {
       (yyval.expression) = new ValueExpr(*(yyvsp[0].value));
       (yyval.expression)->set_name(token_name(sql_string, &(yyloc)));
-      delete (yyvsp[0].value);
     }
-#line 2216 "yacc_sql.cpp"
+#line 2534 "yacc_sql.cpp"
     break;
 
-  case 69:
-#line 599 "yacc_sql.y"
+  case 86: /* select_exprs: '*'  */
+#line 793 "yacc_sql.y"
         {
-      (yyval.s_expr_node_list) = new std::vector<SelectExprNode>;
+      (yyval.s_expr_node_list) = create_node<std::vector<SelectExprNode>>(scanner);
       SelectExprNode expr;
       expr.type = REL_ATTR_SELECT_T;
-      expr.attribute = new RelAttrSqlNode;
+      expr.attribute = create_node<RelAttrSqlNode>(scanner);
       expr.attribute->relation_name  = "";
       expr.attribute->attribute_name = "*";
       (yyval.s_expr_node_list)->emplace_back(expr);
     }
-#line 2230 "yacc_sql.cpp"
+#line 2548 "yacc_sql.cpp"
     break;
 
-  case 70:
-#line 608 "yacc_sql.y"
+  case 87: /* select_exprs: select_expr select_expr_list  */
+#line 802 "yacc_sql.y"
                                    {
       if ((yyvsp[0].s_expr_node_list) != nullptr) {
         (yyval.s_expr_node_list) = (yyvsp[0].s_expr_node_list);
       } else {
-        (yyval.s_expr_node_list) = new std::vector<SelectExprNode>;
+        (yyval.s_expr_node_list) = create_node<std::vector<SelectExprNode>>(scanner);
       }
       (yyval.s_expr_node_list)->emplace_back(*(yyvsp[-1].select_expr_node));
-      delete (yyvsp[-1].select_expr_node);
     }
-#line 2244 "yacc_sql.cpp"
+#line 2561 "yacc_sql.cpp"
     break;
 
-  case 71:
-#line 620 "yacc_sql.y"
+  case 88: /* select_expr: rel_attr  */
+#line 813 "yacc_sql.y"
              {      // 属性
-      (yyval.select_expr_node) = new SelectExprNode;
+      (yyval.select_expr_node) = create_node<SelectExprNode>(scanner);
       (yyval.select_expr_node)->type = REL_ATTR_SELECT_T;
       (yyval.select_expr_node)->attribute = (yyvsp[0].rel_attr);
     }
-#line 2254 "yacc_sql.cpp"
+#line 2571 "yacc_sql.cpp"
     break;
 
-  case 72:
-#line 625 "yacc_sql.y"
+  case 89: /* select_expr: aggr_func  */
+#line 818 "yacc_sql.y"
                 {   // 聚合函数
-      (yyval.select_expr_node) = new SelectExprNode;
+      (yyval.select_expr_node) = create_node<SelectExprNode>(scanner);
       (yyval.select_expr_node)->type = AGGR_FUNC_SELECT_T;
       (yyval.select_expr_node)->aggrfunc = (yyvsp[0].aggr_func_node);
     }
-#line 2264 "yacc_sql.cpp"
+#line 2581 "yacc_sql.cpp"
     break;
 
-  case 73:
-#line 634 "yacc_sql.y"
+  case 90: /* select_expr_list: %empty  */
+#line 827 "yacc_sql.y"
     {
       (yyval.s_expr_node_list) = nullptr;
     }
-#line 2272 "yacc_sql.cpp"
+#line 2589 "yacc_sql.cpp"
     break;
 
-  case 74:
-#line 637 "yacc_sql.y"
+  case 91: /* select_expr_list: COMMA select_expr select_expr_list  */
+#line 830 "yacc_sql.y"
                                          {
       if ((yyvsp[0].s_expr_node_list) != nullptr) {
         (yyval.s_expr_node_list) = (yyvsp[0].s_expr_node_list);
       } else {
-        (yyval.s_expr_node_list) = new std::vector<SelectExprNode>;
+        (yyval.s_expr_node_list) = create_node<std::vector<SelectExprNode>>(scanner);
       }
 
       (yyval.s_expr_node_list)->emplace_back(*(yyvsp[-1].select_expr_node));
-      delete (yyvsp[-1].select_expr_node);
     }
-#line 2287 "yacc_sql.cpp"
+#line 2603 "yacc_sql.cpp"
     break;
 
-  case 75:
-#line 650 "yacc_sql.y"
+  case 92: /* aggr_func: aggr_func_name LBRACE select_attr RBRACE  */
+#line 842 "yacc_sql.y"
                                              {
-      (yyval.aggr_func_node) = new AggrFuncNode;
+      (yyval.aggr_func_node) = create_node<AggrFuncNode>(scanner);
       (yyval.aggr_func_node)->type = (yyvsp[-3].aggr_func_type);
 
       if ((yyvsp[-1].rel_attr_list) != nullptr) {
         (yyval.aggr_func_node)->attributes.swap(*(yyvsp[-1].rel_attr_list));
-        delete (yyvsp[-1].rel_attr_list);
       }
     }
-#line 2301 "yacc_sql.cpp"
+#line 2616 "yacc_sql.cpp"
     break;
 
-  case 76:
-#line 662 "yacc_sql.y"
+  case 93: /* aggr_func_name: MAX  */
+#line 853 "yacc_sql.y"
         {
       (yyval.aggr_func_type) = MAX_AGGR_T;
     }
-#line 2309 "yacc_sql.cpp"
+#line 2624 "yacc_sql.cpp"
     break;
 
-  case 77:
-#line 665 "yacc_sql.y"
+  case 94: /* aggr_func_name: MIN  */
+#line 856 "yacc_sql.y"
           {
       (yyval.aggr_func_type) = MIN_AGGR_T;
     }
-#line 2317 "yacc_sql.cpp"
+#line 2632 "yacc_sql.cpp"
     break;
 
-  case 78:
-#line 668 "yacc_sql.y"
+  case 95: /* aggr_func_name: COUNT  */
+#line 859 "yacc_sql.y"
             {
       (yyval.aggr_func_type) = COUNT_AGGR_T;
     }
-#line 2325 "yacc_sql.cpp"
+#line 2640 "yacc_sql.cpp"
     break;
 
-  case 79:
-#line 671 "yacc_sql.y"
+  case 96: /* aggr_func_name: AVG  */
+#line 862 "yacc_sql.y"
           {
       (yyval.aggr_func_type) = AVG_AGGR_T;
     }
-#line 2333 "yacc_sql.cpp"
+#line 2648 "yacc_sql.cpp"
     break;
 
-  case 80:
-#line 674 "yacc_sql.y"
+  case 97: /* aggr_func_name: SUM  */
+#line 865 "yacc_sql.y"
           {
       (yyval.aggr_func_type) = SUM_AGGR_T;
     }
-#line 2341 "yacc_sql.cpp"
+#line 2656 "yacc_sql.cpp"
     break;
 
-  case 81:
-#line 680 "yacc_sql.y"
+  case 98: /* select_attr: '*'  */
+#line 871 "yacc_sql.y"
         {
-      (yyval.rel_attr_list) = new std::vector<RelAttrSqlNode>;
+      (yyval.rel_attr_list) = create_node<std::vector<RelAttrSqlNode>>(scanner);
       RelAttrSqlNode attr;
       attr.relation_name  = "";
       attr.attribute_name = "*";
       (yyval.rel_attr_list)->emplace_back(attr);
     }
-#line 2353 "yacc_sql.cpp"
+#line 2668 "yacc_sql.cpp"
     break;
 
-  case 82:
-#line 687 "yacc_sql.y"
+  case 99: /* select_attr: '*' COMMA rel_attr attr_list  */
+#line 878 "yacc_sql.y"
                                    {
       if ((yyvsp[0].rel_attr_list) != nullptr) {
         (yyval.rel_attr_list) = (yyvsp[0].rel_attr_list);
       } else {
-        (yyval.rel_attr_list) = new std::vector<RelAttrSqlNode>;
+        (yyval.rel_attr_list) = create_node<std::vector<RelAttrSqlNode>>(scanner);
       }
       (yyval.rel_attr_list)->emplace_back(*(yyvsp[-1].rel_attr));
       RelAttrSqlNode attr;
@@ -2366,215 +2681,195 @@ yyreduce:
       attr.attribute_name = "*";
       (yyval.rel_attr_list)->emplace_back(attr);
     }
-#line 2370 "yacc_sql.cpp"
+#line 2685 "yacc_sql.cpp"
     break;
 
-  case 83:
-#line 699 "yacc_sql.y"
+  case 100: /* select_attr: rel_attr attr_list  */
+#line 890 "yacc_sql.y"
                          {
       if ((yyvsp[0].rel_attr_list) != nullptr) {
         (yyval.rel_attr_list) = (yyvsp[0].rel_attr_list);
       } else {
-        (yyval.rel_attr_list) = new std::vector<RelAttrSqlNode>;
+        (yyval.rel_attr_list) = create_node<std::vector<RelAttrSqlNode>>(scanner);
       }
       (yyval.rel_attr_list)->emplace_back(*(yyvsp[-1].rel_attr));
-      delete (yyvsp[-1].rel_attr);
     }
-#line 2384 "yacc_sql.cpp"
+#line 2698 "yacc_sql.cpp"
     break;
 
-  case 84:
-#line 708 "yacc_sql.y"
+  case 101: /* select_attr: %empty  */
+#line 898 "yacc_sql.y"
                   {
-      (yyval.rel_attr_list) = new std::vector<RelAttrSqlNode>;
+      (yyval.rel_attr_list) = create_node<std::vector<RelAttrSqlNode>>(scanner);
       RelAttrSqlNode attr;
       attr.relation_name  = "";
       attr.attribute_name = "";
       (yyval.rel_attr_list)->emplace_back(attr);
     }
-#line 2396 "yacc_sql.cpp"
+#line 2710 "yacc_sql.cpp"
     break;
 
-  case 85:
-#line 718 "yacc_sql.y"
-       {
-      (yyval.rel_attr) = new RelAttrSqlNode;
+  case 102: /* rel_attr: identifier  */
+#line 908 "yacc_sql.y"
+               {
+      (yyval.rel_attr) = create_node<RelAttrSqlNode>(scanner);
       (yyval.rel_attr)->attribute_name = (yyvsp[0].string);
-      free((yyvsp[0].string));
     }
-#line 2406 "yacc_sql.cpp"
+#line 2719 "yacc_sql.cpp"
     break;
 
-  case 86:
-#line 723 "yacc_sql.y"
-                {
-      (yyval.rel_attr) = new RelAttrSqlNode;
+  case 103: /* rel_attr: identifier DOT identifier  */
+#line 912 "yacc_sql.y"
+                                {
+      (yyval.rel_attr) = create_node<RelAttrSqlNode>(scanner);
       (yyval.rel_attr)->relation_name  = (yyvsp[-2].string);
       (yyval.rel_attr)->attribute_name = (yyvsp[0].string);
-      free((yyvsp[-2].string));
-      free((yyvsp[0].string));
     }
-#line 2418 "yacc_sql.cpp"
+#line 2729 "yacc_sql.cpp"
     break;
 
-  case 87:
-#line 734 "yacc_sql.y"
+  case 104: /* attr_list: %empty  */
+#line 921 "yacc_sql.y"
     {
       (yyval.rel_attr_list) = nullptr;
     }
-#line 2426 "yacc_sql.cpp"
+#line 2737 "yacc_sql.cpp"
     break;
 
-  case 88:
-#line 737 "yacc_sql.y"
+  case 105: /* attr_list: COMMA rel_attr attr_list  */
+#line 924 "yacc_sql.y"
                                {
       if ((yyvsp[0].rel_attr_list) != nullptr) {
         (yyval.rel_attr_list) = (yyvsp[0].rel_attr_list);
       } else {
-        (yyval.rel_attr_list) = new std::vector<RelAttrSqlNode>;
+        (yyval.rel_attr_list) = create_node<std::vector<RelAttrSqlNode>>(scanner);
       }
 
       (yyval.rel_attr_list)->emplace_back(*(yyvsp[-1].rel_attr));
-      delete (yyvsp[-1].rel_attr);
     }
-#line 2441 "yacc_sql.cpp"
+#line 2751 "yacc_sql.cpp"
     break;
 
-  case 89:
-#line 751 "yacc_sql.y"
+  case 106: /* rel_list: %empty  */
+#line 937 "yacc_sql.y"
     {
       (yyval.relation_list) = nullptr;
     }
-#line 2449 "yacc_sql.cpp"
+#line 2759 "yacc_sql.cpp"
     break;
 
-  case 90:
-#line 754 "yacc_sql.y"
-                        {
+  case 107: /* rel_list: COMMA identifier rel_list  */
+#line 940 "yacc_sql.y"
+                                {
       if ((yyvsp[0].relation_list) != nullptr) {
         (yyval.relation_list) = (yyvsp[0].relation_list);
       } else {
-        (yyval.relation_list) = new std::vector<std::string>;
+        (yyval.relation_list) = create_node<std::vector<std::string>>(scanner);
       }
 
       (yyval.relation_list)->push_back((yyvsp[-1].string));
-      free((yyvsp[-1].string));
     }
-#line 2464 "yacc_sql.cpp"
+#line 2773 "yacc_sql.cpp"
     break;
 
-  case 91:
-#line 767 "yacc_sql.y"
+  case 108: /* where: %empty  */
+#line 952 "yacc_sql.y"
     {
       (yyval.condition_list) = nullptr;
     }
-#line 2472 "yacc_sql.cpp"
+#line 2781 "yacc_sql.cpp"
     break;
 
-  case 92:
-#line 770 "yacc_sql.y"
+  case 109: /* where: WHERE condition_list  */
+#line 955 "yacc_sql.y"
                            {
       (yyval.condition_list) = (yyvsp[0].condition_list);  
     }
-#line 2480 "yacc_sql.cpp"
+#line 2789 "yacc_sql.cpp"
     break;
 
-  case 93:
-#line 776 "yacc_sql.y"
+  case 110: /* condition_list: %empty  */
+#line 961 "yacc_sql.y"
     {
       (yyval.condition_list) = nullptr;
     }
-#line 2488 "yacc_sql.cpp"
+#line 2797 "yacc_sql.cpp"
     break;
 
-  case 94:
-#line 779 "yacc_sql.y"
+  case 111: /* condition_list: condition  */
+#line 964 "yacc_sql.y"
                 {
-      (yyval.condition_list) = new std::vector<ConditionSqlNode>;
+      (yyval.condition_list) = create_node<std::vector<ConditionSqlNode>>(scanner);
       (yyval.condition_list)->emplace_back(*(yyvsp[0].condition));
-      delete (yyvsp[0].condition);
     }
-#line 2498 "yacc_sql.cpp"
+#line 2806 "yacc_sql.cpp"
     break;
 
-  case 95:
-#line 784 "yacc_sql.y"
+  case 112: /* condition_list: condition AND condition_list  */
+#line 968 "yacc_sql.y"
                                    {
       (yyval.condition_list) = (yyvsp[0].condition_list);
       (yyval.condition_list)->emplace_back(*(yyvsp[-2].condition));
-      delete (yyvsp[-2].condition);
     }
-#line 2508 "yacc_sql.cpp"
+#line 2815 "yacc_sql.cpp"
     break;
 
-  case 96:
-#line 792 "yacc_sql.y"
+  case 113: /* condition: rel_attr comp_op value  */
+#line 975 "yacc_sql.y"
     {
-      (yyval.condition) = new ConditionSqlNode;
+      (yyval.condition) = create_node<ConditionSqlNode>(scanner);
       (yyval.condition)->left_is_attr = 1;
       (yyval.condition)->left_attr = *(yyvsp[-2].rel_attr);
       (yyval.condition)->right_is_attr = 0;
       (yyval.condition)->right_value = *(yyvsp[0].value);
       (yyval.condition)->comp = (yyvsp[-1].comp);
-
-      delete (yyvsp[-2].rel_attr);
-      delete (yyvsp[0].value);
     }
-#line 2524 "yacc_sql.cpp"
+#line 2828 "yacc_sql.cpp"
     break;
 
-  case 97:
-#line 804 "yacc_sql.y"
+  case 114: /* condition: value comp_op value  */
+#line 984 "yacc_sql.y"
     {
-      (yyval.condition) = new ConditionSqlNode;
+      (yyval.condition) = create_node<ConditionSqlNode>(scanner);
       (yyval.condition)->left_is_attr = 0;
       (yyval.condition)->left_value = *(yyvsp[-2].value);
       (yyval.condition)->right_is_attr = 0;
       (yyval.condition)->right_value = *(yyvsp[0].value);
       (yyval.condition)->comp = (yyvsp[-1].comp);
-
-      delete (yyvsp[-2].value);
-      delete (yyvsp[0].value);
     }
-#line 2540 "yacc_sql.cpp"
+#line 2841 "yacc_sql.cpp"
     break;
 
-  case 98:
-#line 816 "yacc_sql.y"
+  case 115: /* condition: rel_attr comp_op rel_attr  */
+#line 993 "yacc_sql.y"
     {
-      (yyval.condition) = new ConditionSqlNode;
+      (yyval.condition) = create_node<ConditionSqlNode>(scanner);
       (yyval.condition)->left_is_attr = 1;
       (yyval.condition)->left_attr = *(yyvsp[-2].rel_attr);
       (yyval.condition)->right_is_attr = 1;
       (yyval.condition)->right_attr = *(yyvsp[0].rel_attr);
       (yyval.condition)->comp = (yyvsp[-1].comp);
-
-      delete (yyvsp[-2].rel_attr);
-      delete (yyvsp[0].rel_attr);
     }
-#line 2556 "yacc_sql.cpp"
+#line 2854 "yacc_sql.cpp"
     break;
 
-  case 99:
-#line 828 "yacc_sql.y"
+  case 116: /* condition: value comp_op rel_attr  */
+#line 1002 "yacc_sql.y"
     {
-      (yyval.condition) = new ConditionSqlNode;
+      (yyval.condition) = create_node<ConditionSqlNode>(scanner);
       (yyval.condition)->left_is_attr = 0;
       (yyval.condition)->left_value = *(yyvsp[-2].value);
       (yyval.condition)->right_is_attr = 1;
       (yyval.condition)->right_attr = *(yyvsp[0].rel_attr);
       (yyval.condition)->comp = (yyvsp[-1].comp);
-
-      delete (yyvsp[-2].value);
-      delete (yyvsp[0].rel_attr);
     }
-#line 2572 "yacc_sql.cpp"
+#line 2867 "yacc_sql.cpp"
     break;
 
-  case 100:
-#line 840 "yacc_sql.y"
+  case 117: /* condition: rel_attr like_comp_op SSS  */
+#line 1011 "yacc_sql.y"
     {
-      (yyval.condition) = new ConditionSqlNode;
+      (yyval.condition) = create_node<ConditionSqlNode>(scanner);
 
       (yyval.condition)->left_is_attr = 1;
       (yyval.condition)->comp = (yyvsp[-1].comp);
@@ -2582,7 +2877,7 @@ yyreduce:
 
       (yyval.condition)->left_attr = *(yyvsp[-2].rel_attr);
 
-      string regex = common::substr((yyvsp[0].string),1,strlen((yyvsp[0].string))-2);
+      string regex((yyvsp[0].string) + 1, strlen((yyvsp[0].string)) - 2);
       size_t pos = 0;
       while ((pos = regex.find("%", pos)) != string::npos) {
         regex.replace(pos, 1, ".*");
@@ -2594,100 +2889,90 @@ yyreduce:
         pos += 1;
       }
       // cout << regex << endl;
-      Value *value = new Value(regex.c_str());
-      (yyval.condition)->right_value = *value;
-
-      delete (yyvsp[-2].rel_attr);
-      free((yyvsp[0].string));
+      (yyval.condition)->right_value = Value(regex.c_str());
     }
-#line 2604 "yacc_sql.cpp"
+#line 2895 "yacc_sql.cpp"
     break;
 
-  case 101:
-#line 870 "yacc_sql.y"
+  case 118: /* comp_op: EQ  */
+#line 1037 "yacc_sql.y"
          { (yyval.comp) = EQUAL_TO; }
-#line 2610 "yacc_sql.cpp"
+#line 2901 "yacc_sql.cpp"
     break;
 
-  case 102:
-#line 871 "yacc_sql.y"
+  case 119: /* comp_op: LT  */
+#line 1038 "yacc_sql.y"
          { (yyval.comp) = LESS_THAN; }
-#line 2616 "yacc_sql.cpp"
+#line 2907 "yacc_sql.cpp"
     break;
 
-  case 103:
-#line 872 "yacc_sql.y"
+  case 120: /* comp_op: GT  */
+#line 1039 "yacc_sql.y"
          { (yyval.comp) = GREAT_THAN; }
-#line 2622 "yacc_sql.cpp"
+#line 2913 "yacc_sql.cpp"
     break;
 
-  case 104:
-#line 873 "yacc_sql.y"
+  case 121: /* comp_op: LE  */
+#line 1040 "yacc_sql.y"
          { (yyval.comp) = LESS_EQUAL; }
-#line 2628 "yacc_sql.cpp"
+#line 2919 "yacc_sql.cpp"
     break;
 
-  case 105:
-#line 874 "yacc_sql.y"
+  case 122: /* comp_op: GE  */
+#line 1041 "yacc_sql.y"
          { (yyval.comp) = GREAT_EQUAL; }
-#line 2634 "yacc_sql.cpp"
+#line 2925 "yacc_sql.cpp"
     break;
 
-  case 106:
-#line 875 "yacc_sql.y"
+  case 123: /* comp_op: NE  */
+#line 1042 "yacc_sql.y"
          { (yyval.comp) = NOT_EQUAL; }
-#line 2640 "yacc_sql.cpp"
+#line 2931 "yacc_sql.cpp"
     break;
 
-  case 107:
-#line 878 "yacc_sql.y"
+  case 124: /* like_comp_op: LIKE  */
+#line 1045 "yacc_sql.y"
            { (yyval.comp) = LIKE_OP;}
-#line 2646 "yacc_sql.cpp"
+#line 2937 "yacc_sql.cpp"
     break;
 
-  case 108:
-#line 879 "yacc_sql.y"
+  case 125: /* like_comp_op: NOT LIKE  */
+#line 1046 "yacc_sql.y"
                { (yyval.comp) = NOT_LIKE_OP; }
-#line 2652 "yacc_sql.cpp"
+#line 2943 "yacc_sql.cpp"
     break;
 
-  case 109:
-#line 884 "yacc_sql.y"
+  case 126: /* load_data_stmt: LOAD DATA INFILE SSS INTO TABLE identifier  */
+#line 1051 "yacc_sql.y"
     {
-      char *tmp_file_name = common::substr((yyvsp[-3].string), 1, strlen((yyvsp[-3].string)) - 2);
-      
-      (yyval.sql_node) = new ParsedSqlNode(SCF_LOAD_DATA);
+      (yyval.sql_node) = create_node<ParsedSqlNode>(scanner, SCF_LOAD_DATA);
       (yyval.sql_node)->load_data.relation_name = (yyvsp[0].string);
-      (yyval.sql_node)->load_data.file_name = tmp_file_name;
-      free((yyvsp[0].string));
-      free(tmp_file_name);
+      (yyval.sql_node)->load_data.file_name = string((yyvsp[-3].string) + 1, strlen((yyvsp[-3].string)) - 2);
     }
-#line 2666 "yacc_sql.cpp"
+#line 2953 "yacc_sql.cpp"
     break;
 
-  case 110:
-#line 897 "yacc_sql.y"
+  case 127: /* explain_stmt: EXPLAIN command_wrapper  */
+#line 1060 "yacc_sql.y"
     {
-      (yyval.sql_node) = new ParsedSqlNode(SCF_EXPLAIN);
-      (yyval.sql_node)->explain.sql_node = std::unique_ptr<ParsedSqlNode>((yyvsp[0].sql_node));
+      (yyval.sql_node) = create_node<ParsedSqlNode>(scanner, SCF_EXPLAIN);
+      (yyval.sql_node)->explain.sql_node = (yyvsp[0].sql_node);
     }
-#line 2675 "yacc_sql.cpp"
+#line 2962 "yacc_sql.cpp"
     break;
 
-  case 111:
-#line 905 "yacc_sql.y"
+  case 128: /* set_variable_stmt: SET ID EQ value  */
+#line 1068 "yacc_sql.y"
     {
-      (yyval.sql_node) = new ParsedSqlNode(SCF_SET_VARIABLE);
+      (yyval.sql_node) = create_node<ParsedSqlNode>(scanner, SCF_SET_VARIABLE);
       (yyval.sql_node)->set_variable.name  = (yyvsp[-2].string);
       (yyval.sql_node)->set_variable.value = *(yyvsp[0].value);
-      free((yyvsp[-2].string));
-      delete (yyvsp[0].value);
     }
-#line 2687 "yacc_sql.cpp"
+#line 2972 "yacc_sql.cpp"
     break;
 
 
-#line 2691 "yacc_sql.cpp"
+#line 2976 "yacc_sql.cpp"
 
       default: break;
     }
@@ -2702,11 +2987,10 @@ yyreduce:
      case of YYERROR or YYBACKUP, subsequent parser actions might lead
      to an incorrect destructor call or verbose syntax error message
      before the lookahead is translated.  */
-  YY_SYMBOL_PRINT ("-> $$ =", yyr1[yyn], &yyval, &yyloc);
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
 
   YYPOPSTACK (yylen);
   yylen = 0;
-  YY_STACK_PRINT (yyss, yyssp);
 
   *++yyvsp = yyval;
   *++yylsp = yyloc;
@@ -2731,50 +3015,45 @@ yyreduce:
 yyerrlab:
   /* Make sure we have latest lookahead translation.  See comments at
      user semantic actions for why this is necessary.  */
-  yytoken = yychar == YYEMPTY ? YYEMPTY : YYTRANSLATE (yychar);
-
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
   /* If not already recovering from an error, report this error.  */
   if (!yyerrstatus)
     {
       ++yynerrs;
-#if ! YYERROR_VERBOSE
-      yyerror (&yylloc, sql_string, sql_result, scanner, YY_("syntax error"));
-#else
-# define YYSYNTAX_ERROR yysyntax_error (&yymsg_alloc, &yymsg, \
-                                        yyssp, yytoken)
       {
+        yypcontext_t yyctx
+          = {yyssp, yytoken, &yylloc};
         char const *yymsgp = YY_("syntax error");
         int yysyntax_error_status;
-        yysyntax_error_status = YYSYNTAX_ERROR;
+        yysyntax_error_status = yysyntax_error (&yymsg_alloc, &yymsg, &yyctx);
         if (yysyntax_error_status == 0)
           yymsgp = yymsg;
-        else if (yysyntax_error_status == 1)
+        else if (yysyntax_error_status == -1)
           {
             if (yymsg != yymsgbuf)
               YYSTACK_FREE (yymsg);
-            yymsg = YY_CAST (char *, YYSTACK_ALLOC (YY_CAST (YYSIZE_T, yymsg_alloc)));
-            if (!yymsg)
+            yymsg = YY_CAST (char *,
+                             YYSTACK_ALLOC (YY_CAST (YYSIZE_T, yymsg_alloc)));
+            if (yymsg)
               {
-                yymsg = yymsgbuf;
-                yymsg_alloc = sizeof yymsgbuf;
-                yysyntax_error_status = 2;
+                yysyntax_error_status
+                  = yysyntax_error (&yymsg_alloc, &yymsg, &yyctx);
+                yymsgp = yymsg;
               }
             else
               {
-                yysyntax_error_status = YYSYNTAX_ERROR;
-                yymsgp = yymsg;
+                yymsg = yymsgbuf;
+                yymsg_alloc = sizeof yymsgbuf;
+                yysyntax_error_status = YYENOMEM;
               }
           }
         yyerror (&yylloc, sql_string, sql_result, scanner, yymsgp);
-        if (yysyntax_error_status == 2)
-          goto yyexhaustedlab;
+        if (yysyntax_error_status == YYENOMEM)
+          YYNOMEM;
       }
-# undef YYSYNTAX_ERROR
-#endif
     }
 
   yyerror_range[1] = yylloc;
-
   if (yyerrstatus == 3)
     {
       /* If just tried and failed to reuse lookahead token after an
@@ -2807,6 +3086,7 @@ yyerrorlab:
      label yyerrorlab therefore never appears in user code.  */
   if (0)
     YYERROR;
+  ++yynerrs;
 
   /* Do not reclaim the symbols of the rule whose action triggered
      this YYERROR.  */
@@ -2823,13 +3103,14 @@ yyerrorlab:
 yyerrlab1:
   yyerrstatus = 3;      /* Each real token shifted decrements this.  */
 
+  /* Pop stack until we find a state that shifts the error token.  */
   for (;;)
     {
       yyn = yypact[yystate];
       if (!yypact_value_is_default (yyn))
         {
-          yyn += YYTERROR;
-          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYTERROR)
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
             {
               yyn = yytable[yyn];
               if (0 < yyn)
@@ -2843,7 +3124,7 @@ yyerrlab1:
 
       yyerror_range[1] = *yylsp;
       yydestruct ("Error: popping",
-                  yystos[yystate], yyvsp, yylsp, sql_string, sql_result, scanner);
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp, yylsp, sql_string, sql_result, scanner);
       YYPOPSTACK (1);
       yystate = *yyssp;
       YY_STACK_PRINT (yyss, yyssp);
@@ -2854,13 +3135,11 @@ yyerrlab1:
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 
   yyerror_range[2] = yylloc;
-  /* Using YYLLOC is tempting, but would change the location of
-     the lookahead.  YYLOC is available though.  */
-  YYLLOC_DEFAULT (yyloc, yyerror_range, 2);
-  *++yylsp = yyloc;
+  ++yylsp;
+  YYLLOC_DEFAULT (*yylsp, yyerror_range, 2);
 
   /* Shift the error token.  */
-  YY_SYMBOL_PRINT ("Shifting", yystos[yyn], yyvsp, yylsp);
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
 
   yystate = yyn;
   goto yynewstate;
@@ -2871,7 +3150,7 @@ yyerrlab1:
 `-------------------------------------*/
 yyacceptlab:
   yyresult = 0;
-  goto yyreturn;
+  goto yyreturnlab;
 
 
 /*-----------------------------------.
@@ -2879,24 +3158,22 @@ yyacceptlab:
 `-----------------------------------*/
 yyabortlab:
   yyresult = 1;
-  goto yyreturn;
+  goto yyreturnlab;
 
 
-#if !defined yyoverflow || YYERROR_VERBOSE
-/*-------------------------------------------------.
-| yyexhaustedlab -- memory exhaustion comes here.  |
-`-------------------------------------------------*/
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
 yyexhaustedlab:
   yyerror (&yylloc, sql_string, sql_result, scanner, YY_("memory exhausted"));
   yyresult = 2;
-  /* Fall through.  */
-#endif
+  goto yyreturnlab;
 
 
-/*-----------------------------------------------------.
-| yyreturn -- parsing is finished, return the result.  |
-`-----------------------------------------------------*/
-yyreturn:
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
   if (yychar != YYEMPTY)
     {
       /* Make sure we have latest lookahead translation.  See comments at
@@ -2912,29 +3189,62 @@ yyreturn:
   while (yyssp != yyss)
     {
       yydestruct ("Cleanup: popping",
-                  yystos[+*yyssp], yyvsp, yylsp, sql_string, sql_result, scanner);
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp, yylsp, sql_string, sql_result, scanner);
       YYPOPSTACK (1);
     }
 #ifndef yyoverflow
   if (yyss != yyssa)
     YYSTACK_FREE (yyss);
 #endif
-#if YYERROR_VERBOSE
   if (yymsg != yymsgbuf)
     YYSTACK_FREE (yymsg);
-#endif
   return yyresult;
 }
-#line 917 "yacc_sql.y"
+
+#line 1078 "yacc_sql.y"
 
 //_____________________________________________________________________
-extern void scan_string(const char *str, yyscan_t scanner);
+/**
+ * @brief 每个线程复用一个词法分析器，不用每条语句都创建和销毁
+ */
+class ScannerHolder
+{
+public:
+  ScannerHolder() { yylex_init(&scanner_); }
+  ~ScannerHolder() { yylex_destroy(scanner_); }
+
+  yyscan_t scanner() const { return scanner_; }
+
+private:
+  yyscan_t scanner_ = nullptr;
+};
+
+int sql_parse(const char *s, ParsedSqlResult *sql_result, common::Arena &arena) {
+  static thread_local ScannerHolder scanner_holder;
+  yyscan_t scanner = scanner_holder.scanner();
 
-int sql_parse(const char *s, ParsedSqlResult *sql_result) {
-  yyscan_t scanner;
-  yylex_init(&scanner);
-  scan_string(s, scanner);
+  // flex 要求缓冲区以两个'\0'结尾。把SQL复制到 arena 中直接作为词法分析的缓冲区，
+  // 词法分析返回的字符串也从 arena 中分配，随 arena 一起释放
+  const size_t len = strlen(s);
+  char *buffer = static_cast<char *>(arena.alloc(len + 2, 1));
+  memcpy(buffer, s, len);
+  buffer[len] = buffer[len + 1] = '\0';
+
+  sql_result->digest_text().reserve(std::min(len, ParsedSqlResult::MAX_DIGEST_TEXT_LENGTH) + 16);
+
+  yyset_extra(&arena, scanner);
+  YY_BUFFER_STATE buffer_state = yy_scan_buffer(buffer, len + 2, scanner);
+  yyset_lineno(1, scanner);
+  yyset_column(0, scanner);
   int result = yyparse(s, sql_result, scanner);
-  yylex_destroy(scanner);
+  if (result != 0) {
+    // 语法错误时剩下的部分没有做词法分析，摘要文本也要包含完整的语句
+    YYSTYPE yylval;
+    YYLTYPE yylloc;
+    while (digest_lex(&yylval, &yylloc, scanner, sql_result) > 0) {
+    }
+  }
+  collapse_insert_rows(sql_result->digest_text());
+  yy_delete_buffer(buffer_state, scanner);
   return result;
 }
@@ -8,6 +8,7 @@
 
 #include "common/log/log.h"
 #include "common/lang/string.h"
+#include "common/mm/arena.h"
 #include "sql/parser/parse_defs.h"
 #include "sql/parser/yacc_sql.hpp"
 #include "sql/parser/lex_sql.h"
@@ -20,13 +21,24 @@ string token_name(const char *sql_string, YYLTYPE *llocp)
   return string(sql_string + llocp->first_column, llocp->last_column - llocp->first_column + 1);
 }
 
+/**
+ * @brief 在 sql_parse 传入的 arena 中创建语法树的节点
+ * @details 节点随 arena 一起析构和释放，语法错误时 bison 丢弃的节点也不会泄漏。
+ * 表达式会转移到 Stmt 和算子中，生命周期比 arena 长，仍然在堆上分配
+ */
+template <typename T, typename... Args>
+static T *create_node(yyscan_t scanner, Args &&...args)
+{
+  return static_cast<common::Arena *>(yyget_extra(scanner))->create<T>(std::forward<Args>(args)...);
+}
+
 int yyerror(YYLTYPE *llocp, const char *sql_string, ParsedSqlResult *sql_result, yyscan_t scanner, const char *msg)
 {
-  std::unique_ptr<ParsedSqlNode> error_sql_node = std::make_unique<ParsedSqlNode>(SCF_ERROR);
+  ParsedSqlNode *error_sql_node = create_node<ParsedSqlNode>(scanner, SCF_ERROR);
   error_sql_node->error.error_msg = msg;
   error_sql_node->error.line = llocp->first_line;
   error_sql_node->error.column = llocp->first_column;
-  sql_result->add_sql_node(std::move(error_sql_node));
+  sql_result->add_sql_node(error_sql_node);
   return 0;
 }
 
@@ -41,6 +53,98 @@ ArithmeticExpr *create_arithmetic_expression(ArithmeticExpr::Type type,
   return expr;
 }
 
+/**
+ * @brief 设置建表语句 WITH 子句中的一个选项
+ * @details format 的值是标识符 row 或 pax，page_size 的值是数字，页面大小是否合法在建表时检查
+ * @param str_value 标识符形式的值，值是数字时为空
+ * @return 选项名称或者值不认识时返回false
+ */
+static bool set_table_option(CreateTableSqlNode &options, const char *name, const char *str_value, int num_value)
+{
+  if (0 == strcasecmp(name, "format") && str_value != nullptr) {
+    if (0 == strcasecmp(str_value, "row")) {
+      options.storage_format = ROW_FORMAT;
+      return true;
+    }
+    if (0 == strcasecmp(str_value, "pax")) {
+      options.storage_format = PAX_FORMAT;
+      return true;
+    }
+    return false;
+  }
+  if (0 == strcasecmp(name, "page_size") && str_value == nullptr) {
+    options.page_size = num_value;
+    return true;
+  }
+  return false;
+}
+
+/**
+ * @brief 把一个token追加到语句的摘要文本中
+ * @details 常量都替换成'?'，关键字统一成小写，token之间用一个空格分开，所以只有常量或者空白不同的语句，
+ * 摘要文本是相同的。逗号、右括号、点号前面和左括号、点号后面不加空格，结尾的分号不记录。
+ */
+static void append_digest_token(string &digest_text, int token, const char *text, int len)
+{
+  if (token == SEMICOLON || digest_text.size() >= ParsedSqlResult::MAX_DIGEST_TEXT_LENGTH) {
+    return;
+  }
+
+  if (!digest_text.empty() && token != COMMA && token != RBRACE && token != DOT
+      && digest_text.back() != '(' && digest_text.back() != '.') {
+    digest_text.push_back(' ');
+  }
+
+  switch (token) {
+    case NUMBER:
+    case FLOAT:
+    case DATE:
+    case SSS: {
+      digest_text.push_back('?');
+    } break;
+    case ID: {
+      digest_text.append(text, len);
+    } break;
+    default: {
+      const size_t start = digest_text.size();
+      digest_text.append(text, len);
+      for (size_t i = start; i < digest_text.size(); i++) {
+        digest_text[i] = static_cast<char>(tolower(static_cast<unsigned char>(digest_text[i])));
+      }
+    } break;
+  }
+}
+
+/**
+ * @brief 多行的 INSERT 只保留第一行，后面的行用", ..."代替，这样插入行数不同的语句摘要相同
+ * @details 常量已经替换成了'?'，VALUES 中的每一行都不会再有括号
+ */
+static void collapse_insert_rows(string &digest_text)
+{
+  size_t pos = digest_text.find(" values (");
+  if (pos == string::npos) {
+    return;
+  }
+  pos = digest_text.find(')', pos);
+  if (pos != string::npos && digest_text.compare(pos + 1, 2, ", ") == 0) {
+    digest_text.replace(pos + 1, string::npos, ", ...");
+  }
+}
+
+/**
+ * @brief 词法分析，同时生成语句的摘要文本
+ */
+static int digest_lex(YYSTYPE *lvalp, YYLTYPE *llocp, yyscan_t scanner, ParsedSqlResult *sql_result)
+{
+  int token = yylex(lvalp, llocp, scanner);
+  if (token > 0) {
+    append_digest_token(sql_result->digest_text(), token, yyget_text(scanner), yyget_leng(scanner));
+  }
+  return token;
+}
+
+#define yylex(lvalp, llocp, scanner) digest_lex(lvalp, llocp, scanner, sql_result)
+
 %}
 
 %define api.pure full
@@ -121,6 +225,7 @@ ArithmeticExpr *create_arithmetic_expression(ArithmeticExpr::Type type,
   Expression *                      expression;
   std::vector<Expression *> *       expression_list;
   std::vector<Value> *              value_list;
+  std::vector<std::vector<Value>> * insert_rows;
   std::vector<ConditionSqlNode> *   condition_list;
   std::vector<RelAttrSqlNode> *     rel_attr_list;
   std::vector<std::string> *        relation_list;
@@ -135,12 +240,15 @@ ArithmeticExpr *create_arithmetic_expression(ArithmeticExpr::Type type,
   std::vector<SelectExprNode> *     s_expr_node_list;
   std::vector<JoinSqlNode>*         join_list;
   std::vector<std::string>*         id_list;
+  CreateTableSqlNode *              table_options;
 }
 
 %token <number> NUMBER
 %token <floats> FLOAT
 %token <dates>   DATE
 %token <string> ID
+%token <string> ANALYZE
+%token <string> RESET
 %token <string> SSS
 //非终结符
 
@@ -155,6 +263,8 @@ ArithmeticExpr *create_arithmetic_expression(ArithmeticExpr::Type type,
 %type <attr_infos>          attr_def_list
 %type <attr_info>           attr_def
 %type <value_list>          value_list
+%type <value_list>          insert_row
+%type <insert_rows>         insert_row_list
 %type <condition_list>      where
 %type <condition_list>      condition_list
 // 保留select_attr使用在聚合函数中
@@ -169,9 +279,14 @@ ArithmeticExpr *create_arithmetic_expression(ArithmeticExpr::Type type,
 %type <sql_node>            update_stmt
 %type <sql_node>            delete_stmt
 %type <sql_node>            create_table_stmt
+%type <table_options>       table_options
+%type <table_options>       table_option_list
 %type <sql_node>            drop_table_stmt
 %type <sql_node>            show_tables_stmt
 %type <sql_node>            desc_table_stmt
+%type <sql_node>            analyze_table_stmt
+%type <sql_node>            reset_stmt
+%type <string>              identifier
 %type <sql_node>            create_index_stmt
 %type <sql_node>            drop_index_stmt
 %type <sql_node>            sync_stmt
@@ -203,8 +318,7 @@ ArithmeticExpr *create_arithmetic_expression(ArithmeticExpr::Type type,
 
 commands: command_wrapper opt_semicolon  //commands or sqls. parser starts here.
   {
-    std::unique_ptr<ParsedSqlNode> sql_node = std::unique_ptr<ParsedSqlNode>($1);
-    sql_result->add_sql_node(std::move(sql_node));
+    sql_result->add_sql_node($1);
   }
   ;
 
@@ -218,6 +332,8 @@ command_wrapper:
   | drop_table_stmt
   | show_tables_stmt
   | desc_table_stmt
+  | analyze_table_stmt
+  | reset_stmt
   | create_index_stmt
   | drop_index_stmt
   | sync_stmt
@@ -234,108 +350,125 @@ command_wrapper:
 exit_stmt:      
     EXIT {
       (void)yynerrs;  // 这么写为了消除yynerrs未使用的告警。如果你有更好的方法欢迎提PR
-      $$ = new ParsedSqlNode(SCF_EXIT);
+      $$ = create_node<ParsedSqlNode>(scanner, SCF_EXIT);
     };
 
 help_stmt:
     HELP {
-      $$ = new ParsedSqlNode(SCF_HELP);
+      $$ = create_node<ParsedSqlNode>(scanner, SCF_HELP);
     };
 
 sync_stmt:
     SYNC {
-      $$ = new ParsedSqlNode(SCF_SYNC);
+      $$ = create_node<ParsedSqlNode>(scanner, SCF_SYNC);
     }
     ;
 
 begin_stmt:
     TRX_BEGIN  {
-      $$ = new ParsedSqlNode(SCF_BEGIN);
+      $$ = create_node<ParsedSqlNode>(scanner, SCF_BEGIN);
     }
     ;
 
 commit_stmt:
     TRX_COMMIT {
-      $$ = new ParsedSqlNode(SCF_COMMIT);
+      $$ = create_node<ParsedSqlNode>(scanner, SCF_COMMIT);
     }
     ;
 
 rollback_stmt:
     TRX_ROLLBACK  {
-      $$ = new ParsedSqlNode(SCF_ROLLBACK);
+      $$ = create_node<ParsedSqlNode>(scanner, SCF_ROLLBACK);
     }
     ;
 
 drop_table_stmt:    /*drop table 语句的语法解析树*/
-    DROP TABLE ID {
-      $$ = new ParsedSqlNode(SCF_DROP_TABLE);
+    DROP TABLE identifier {
+      $$ = create_node<ParsedSqlNode>(scanner, SCF_DROP_TABLE);
       $$->drop_table.relation_name = $3;
-      free($3);
     };
 
 show_tables_stmt:
     SHOW TABLES {
-      $$ = new ParsedSqlNode(SCF_SHOW_TABLES);
+      $$ = create_node<ParsedSqlNode>(scanner, SCF_SHOW_TABLES);
     }
     ;
 
 desc_table_stmt:
-    DESC ID  {
-      $$ = new ParsedSqlNode(SCF_DESC_TABLE);
+    DESC identifier  {
+      $$ = create_node<ParsedSqlNode>(scanner, SCF_DESC_TABLE);
       $$->desc_table.relation_name = $2;
-      free($2);
+    }
+    ;
+
+analyze_table_stmt:
+    ANALYZE TABLE identifier {
+      $$ = create_node<ParsedSqlNode>(scanner, SCF_ANALYZE_TABLE);
+      $$->analyze_table.relation_name = $3;
+    }
+    ;
+
+reset_stmt:
+    RESET identifier {
+      $$ = create_node<ParsedSqlNode>(scanner, SCF_RESET);
+      $$->reset.name = $2;
     }
     ;
 
 create_index_stmt:    /*create index 语句的语法解析树*/
-    CREATE INDEX ID ON ID LBRACE id_list RBRACE
+    CREATE INDEX identifier ON identifier LBRACE id_list RBRACE
     {
-      $$ = new ParsedSqlNode(SCF_CREATE_INDEX);
+      $$ = create_node<ParsedSqlNode>(scanner, SCF_CREATE_INDEX);
       CreateIndexSqlNode &create_index = $$->create_index;
       create_index.index_name = $3;
       create_index.relation_name = $5;
       create_index.attribute_names.swap(*$7);
       std::reverse(create_index.attribute_names.begin(), create_index.attribute_names.end());
-      free($3);
-      free($5);
-      free($7);
+    }
+    ;
+
+identifier:
+    /* 不保留的关键字也可以作为名字使用，参考 lex_sql.l 中的 id_or_keyword */
+    ID {
+      $$ = $1;
+    }
+    | ANALYZE {
+      $$ = $1;
+    }
+    | RESET {
+      $$ = $1;
     }
     ;
 
 id_list:
-    ID{
-      $$ = new std::vector<std::string>;
+    identifier{
+      $$ = create_node<std::vector<std::string>>(scanner);
       std::string attr_name = $1;
       $$->push_back(attr_name);
-      free($1);
     }
-    | ID COMMA id_list
+    | identifier COMMA id_list
     {
       if ($3 != nullptr) {
         $$ = $3;
       }
       std::string attr_name = $1;
       $$->push_back(attr_name);
-      free($1);
     }
 
 drop_index_stmt:      /*drop index 语句的语法解析树*/
-    DROP INDEX ID ON ID
+    DROP INDEX identifier ON identifier
     {
-      $$ = new ParsedSqlNode(SCF_DROP_INDEX);
+      $$ = create_node<ParsedSqlNode>(scanner, SCF_DROP_INDEX);
       $$->drop_index.index_name = $3;
       $$->drop_index.relation_name = $5;
-      free($3);
-      free($5);
     }
     ;
 create_table_stmt:    /*create table 语句的语法解析树*/
-    CREATE TABLE ID LBRACE attr_def attr_def_list RBRACE
+    CREATE TABLE identifier LBRACE attr_def attr_def_list RBRACE table_options
     {
-      $$ = new ParsedSqlNode(SCF_CREATE_TABLE);
+      $$ = create_node<ParsedSqlNode>(scanner, SCF_CREATE_TABLE);
       CreateTableSqlNode &create_table = $$->create_table;
       create_table.relation_name = $3;
-      free($3);
 
       std::vector<AttrInfoSqlNode> *src_attrs = $6;
 
@@ -344,7 +477,59 @@ create_table_stmt:    /*create table 语句的语法解析树*/
       }
       create_table.attr_infos.emplace_back(*$5);
       std::reverse(create_table.attr_infos.begin(), create_table.attr_infos.end());
-      delete $5;
+      if ($8 != nullptr) {
+        create_table.storage_format = $8->storage_format;
+        create_table.page_size = $8->page_size;
+      }
+    }
+    ;
+table_options:
+    /* empty */
+    {
+      $$ = nullptr;
+    }
+    | ID LBRACE table_option_list RBRACE
+    {
+      // WITH (format=row|pax, page_size=N)。这几个词没有作为关键字，按照标识符解析
+      if (0 != strcasecmp($1, "with")) {
+        yyerror(&@$, sql_string, sql_result, scanner, "syntax error");
+        YYERROR;
+      }
+      $$ = $3;
+    }
+    ;
+table_option_list:
+    ID EQ ID
+    {
+      $$ = create_node<CreateTableSqlNode>(scanner);
+      if (!set_table_option(*$$, $1, $3, 0)) {
+        yyerror(&@$, sql_string, sql_result, scanner, "syntax error");
+        YYERROR;
+      }
+    }
+    | ID EQ NUMBER
+    {
+      $$ = create_node<CreateTableSqlNode>(scanner);
+      if (!set_table_option(*$$, $1, nullptr, $3)) {
+        yyerror(&@$, sql_string, sql_result, scanner, "syntax error");
+        YYERROR;
+      }
+    }
+    | table_option_list COMMA ID EQ ID
+    {
+      $$ = $1;
+      if (!set_table_option(*$$, $3, $5, 0)) {
+        yyerror(&@$, sql_string, sql_result, scanner, "syntax error");
+        YYERROR;
+      }
+    }
+    | table_option_list COMMA ID EQ NUMBER
+    {
+      $$ = $1;
+      if (!set_table_option(*$$, $3, nullptr, $5)) {
+        yyerror(&@$, sql_string, sql_result, scanner, "syntax error");
+        YYERROR;
+      }
     }
     ;
 attr_def_list:
@@ -357,29 +542,39 @@ attr_def_list:
       if ($3 != nullptr) {
         $$ = $3;
       } else {
-        $$ = new std::vector<AttrInfoSqlNode>;
+        $$ = create_node<std::vector<AttrInfoSqlNode>>(scanner);
       }
       $$->emplace_back(*$2);
-      delete $2;
     }
     ;
     
 attr_def:
-    ID type LBRACE number RBRACE 
+    identifier type LBRACE number RBRACE 
     {
-      $$ = new AttrInfoSqlNode;
+      $$ = create_node<AttrInfoSqlNode>(scanner);
       $$->type = (AttrType)$2;
       $$->name = $1;
       $$->length = $4;
-      free($1);
     }
-    | ID type
+    | identifier type
     {
-      $$ = new AttrInfoSqlNode;
+      $$ = create_node<AttrInfoSqlNode>(scanner);
       $$->type = (AttrType)$2;
       $$->name = $1;
       $$->length = 4;
-      free($1);
+    }
+    | identifier ID LBRACE number RBRACE
+    {
+      // VARCHAR 没有作为关键字，按照标识符解析
+      if (0 != strcasecmp($2, "varchar")) {
+        yyerror(&@$, sql_string, sql_result, scanner, "syntax error");
+        YYERROR;
+      }
+      $$ = create_node<AttrInfoSqlNode>(scanner);
+      $$->type = CHARS;
+      $$->name = $1;
+      $$->length = $4;
+      $$->var_len = true;
     }
     ;
 number:
@@ -392,17 +587,38 @@ type:
     | DATE_T   { $$=DATES; }
     ;
 insert_stmt:        /*insert   语句的语法解析树*/
-    INSERT INTO ID VALUES LBRACE value value_list RBRACE 
+    INSERT INTO identifier VALUES insert_row_list
     {
-      $$ = new ParsedSqlNode(SCF_INSERT);
+      $$ = create_node<ParsedSqlNode>(scanner, SCF_INSERT);
       $$->insertion.relation_name = $3;
-      if ($7 != nullptr) {
-        $$->insertion.values.swap(*$7);
+      $$->insertion.values.swap(*$5);
+    }
+    ;
+
+/* 使用左递归，插入很多行时解析栈不会随着行数增长 */
+insert_row_list:
+    insert_row
+    {
+      $$ = create_node<std::vector<std::vector<Value>>>(scanner);
+      $$->emplace_back(std::move(*$1));
+    }
+    | insert_row_list COMMA insert_row
+    {
+      $$ = $1;
+      $$->emplace_back(std::move(*$3));
+    }
+    ;
+
+insert_row:
+    LBRACE value value_list RBRACE
+    {
+      if ($3 != nullptr) {
+        $$ = $3;
+      } else {
+        $$ = create_node<std::vector<Value>>(scanner);
       }
-      $$->insertion.values.emplace_back(*$6);
-      std::reverse($$->insertion.values.begin(), $$->insertion.values.end());
-      delete $6;
-      free($3);
+      $$->emplace_back(*$2);
+      std::reverse($$->begin(), $$->end());
     }
     ;
 
@@ -415,120 +631,103 @@ value_list:
       if ($3 != nullptr) {
         $$ = $3;
       } else {
-        $$ = new std::vector<Value>;
+        $$ = create_node<std::vector<Value>>(scanner);
       }
       $$->emplace_back(*$2);
-      delete $2;
     }
     ;
 value:
     NUMBER {
-      $$ = new Value((int)$1);
+      $$ = create_node<Value>(scanner, (int)$1);
       @$ = @1;
     }
     |FLOAT {
-      $$ = new Value((float)$1);
+      $$ = create_node<Value>(scanner, (float)$1);
       @$ = @1;
     }
     | DATE {
-      $$ = new Value((date)$1);
+      $$ = create_node<Value>(scanner, (date)$1);
      }
     |SSS {
-      char *tmp = common::substr($1,1,strlen($1)-2);
-      $$ = new Value(tmp);
-      free(tmp);
+      // 词法分析返回的字符串在 arena 中，直接去掉两边的引号
+      $1[strlen($1) - 1] = '\0';
+      $$ = create_node<Value>(scanner, $1 + 1);
     }
     ;
     
 delete_stmt:    /*  delete 语句的语法解析树*/
-    DELETE FROM ID where 
+    DELETE FROM identifier where 
     {
-      $$ = new ParsedSqlNode(SCF_DELETE);
+      $$ = create_node<ParsedSqlNode>(scanner, SCF_DELETE);
       $$->deletion.relation_name = $3;
       if ($4 != nullptr) {
         $$->deletion.conditions.swap(*$4);
-        delete $4;
       }
-      free($3);
     }
     ;
 update_stmt:      /*  update 语句的语法解析树*/
-    UPDATE ID SET ID EQ value where 
+    UPDATE identifier SET identifier EQ value where 
     {
-      $$ = new ParsedSqlNode(SCF_UPDATE);
+      $$ = create_node<ParsedSqlNode>(scanner, SCF_UPDATE);
       $$->update.relation_name = $2;
       $$->update.attribute_name = $4;
       $$->update.value = *$6;
       if ($7 != nullptr) {
         $$->update.conditions.swap(*$7);
-        delete $7;
       }
-      free($2);
-      free($4);
     }
     ;
 select_stmt:        /*  select 语句的语法解析树*/
-    SELECT select_exprs FROM ID rel_list where
+    SELECT select_exprs FROM identifier rel_list where
     {
-      $$ = new ParsedSqlNode(SCF_SELECT);
+      $$ = create_node<ParsedSqlNode>(scanner, SCF_SELECT);
       if ($2 != nullptr) {
         $$->selection.select_exprs.swap(*$2);
-        delete $2;
       }
       if ($5 != nullptr) {
         $$->selection.relations.swap(*$5);
-        delete $5;
       }
       $$->selection.relations.push_back($4);
       std::reverse($$->selection.relations.begin(), $$->selection.relations.end());
       
       if ($6 != nullptr) {
         $$->selection.conditions.swap(*$6);
-        delete $6;
       }
-      free($4);
     }
-    | SELECT select_exprs FROM ID join_list where // new
+    | SELECT select_exprs FROM identifier join_list where // new
     {
-      $$ = new ParsedSqlNode(SCF_SELECT);
+      $$ = create_node<ParsedSqlNode>(scanner, SCF_SELECT);
       if ($2 != nullptr) {    // 属性、聚合
         $$->selection.select_exprs.swap(*$2);
-        delete $2;
       }
       if ($5 != nullptr) {    // join
         $$->selection.joins.swap(*$5);
-        delete $5;
       }
       std::reverse($$->selection.joins.begin(), $$->selection.joins.end());
       $$->selection.relations.push_back($4);
       if ($6 != nullptr) {    // where
         $$->selection.conditions.swap(*$6);
-        delete $6;
       }
-      free($4);
     }
     ;
 
 join_list:
-    INNER JOIN ID ON condition_list
+    INNER JOIN identifier ON condition_list
     {
-      $$ = new std::vector<JoinSqlNode>;
+      $$ = create_node<std::vector<JoinSqlNode>>(scanner);
       JoinSqlNode join_node;
       if ($5 != nullptr) {
         join_node.conditions.swap(*$5);
       }
       join_node.right_rel = $3;
       $$->emplace_back(join_node);
-
-      free($3);
-      delete $5;
     }
-    | INNER JOIN ID ON condition_list join_list
+    | INNER JOIN identifier ON condition_list join_list
     {
       if ($6 != nullptr) {
         $$ = $6;
       } else {
-        $$ = new std::vector<JoinSqlNode>;
+        $$ = create_node<std::vector<JoinSqlNode>>(scanner);
       }
       JoinSqlNode join_node;
       if ($5 != nullptr) {
@@ -536,26 +735,22 @@ join_list:
       }
       join_node.right_rel = $3;
       $$->emplace_back(join_node);
-
-      free($3);
-      delete $5;
     }
     ;
 
 calc_stmt:
     CALC expression_list
     {
-      $$ = new ParsedSqlNode(SCF_CALC);
+      $$ = create_node<ParsedSqlNode>(scanner, SCF_CALC);
       std::reverse($2->begin(), $2->end());
       $$->calc.expressions.swap(*$2);
-      delete $2;
     }
     ;
 
 expression_list:
     expression
     {
-      $$ = new std::vector<Expression*>;
+      $$ = create_node<std::vector<Expression*>>(scanner);
       $$->emplace_back($1);
     }
     | expression COMMA expression_list
@@ -563,7 +758,7 @@ expression_list:
       if ($3 != nullptr) {
         $$ = $3;
       } else {
-        $$ = new std::vector<Expression *>;
+        $$ = create_node<std::vector<Expression *>>(scanner);
       }
       $$->emplace_back($1);
     }
@@ -591,16 +786,15 @@ expression:
     | value {
       $$ = new ValueExpr(*$1);
       $$->set_name(token_name(sql_string, &@$));
-      delete $1;
     }
     ;
 
 select_exprs:
     '*' {
-      $$ = new std::vector<SelectExprNode>;
+      $$ = create_node<std::vector<SelectExprNode>>(scanner);
       SelectExprNode expr;
       expr.type = REL_ATTR_SELECT_T;
-      expr.attribute = new RelAttrSqlNode;
+      expr.attribute = create_node<RelAttrSqlNode>(scanner);
       expr.attribute->relation_name  = "";
       expr.attribute->attribute_name = "*";
       $$->emplace_back(expr);
@@ -609,21 +803,20 @@ select_exprs:
       if ($2 != nullptr) {
         $$ = $2;
       } else {
-        $$ = new std::vector<SelectExprNode>;
+        $$ = create_node<std::vector<SelectExprNode>>(scanner);
       }
       $$->emplace_back(*$1);
-      delete $1;
     }
     ;
 
 select_expr:
     rel_attr {      // 属性
-      $$ = new SelectExprNode;
+      $$ = create_node<SelectExprNode>(scanner);
       $$->type = REL_ATTR_SELECT_T;
       $$->attribute = $1;
     }
     | aggr_func {   // 聚合函数
-      $$ = new SelectExprNode;
+      $$ = create_node<SelectExprNode>(scanner);
       $$->type = AGGR_FUNC_SELECT_T;
       $$->aggrfunc = $1;
     }
@@ -638,22 +831,20 @@ select_expr_list:
       if ($3 != nullptr) {
         $$ = $3;
       } else {
-        $$ = new std::vector<SelectExprNode>;
+        $$ = create_node<std::vector<SelectExprNode>>(scanner);
       }
 
       $$->emplace_back(*$2);
-      delete $2;
     }
     ;
 
 aggr_func:
     aggr_func_name LBRACE select_attr RBRACE {
-      $$ = new AggrFuncNode;
+      $$ = create_node<AggrFuncNode>(scanner);
       $$->type = $1;
 
       if ($3 != nullptr) {
         $$->attributes.swap(*$3);
-        delete $3;
       }
     }
     ;
@@ -678,7 +869,7 @@ aggr_func_name:
 
 select_attr:
     '*' {
-      $$ = new std::vector<RelAttrSqlNode>;
+      $$ = create_node<std::vector<RelAttrSqlNode>>(scanner);
       RelAttrSqlNode attr;
       attr.relation_name  = "";
       attr.attribute_name = "*";
@@ -688,7 +879,7 @@ select_attr:
       if ($4 != nullptr) {
         $$ = $4;
       } else {
-        $$ = new std::vector<RelAttrSqlNode>;
+        $$ = create_node<std::vector<RelAttrSqlNode>>(scanner);
       }
       $$->emplace_back(*$3);
       RelAttrSqlNode attr;
@@ -700,13 +891,12 @@ select_attr:
       if ($2 != nullptr) {
         $$ = $2;
       } else {
-        $$ = new std::vector<RelAttrSqlNode>;
+        $$ = create_node<std::vector<RelAttrSqlNode>>(scanner);
       }
       $$->emplace_back(*$1);
-      delete $1;
     }
     | /* empty */ {
-      $$ = new std::vector<RelAttrSqlNode>;
+      $$ = create_node<std::vector<RelAttrSqlNode>>(scanner);
       RelAttrSqlNode attr;
       attr.relation_name  = "";
       attr.attribute_name = "";
@@ -715,17 +905,14 @@ select_attr:
     ;
 
 rel_attr:
-    ID {
-      $$ = new RelAttrSqlNode;
+    identifier {
+      $$ = create_node<RelAttrSqlNode>(scanner);
       $$->attribute_name = $1;
-      free($1);
     }
-    | ID DOT ID {
-      $$ = new RelAttrSqlNode;
+    | identifier DOT identifier {
+      $$ = create_node<RelAttrSqlNode>(scanner);
       $$->relation_name  = $1;
       $$->attribute_name = $3;
-      free($1);
-      free($3);
     }
     ;
 
@@ -738,11 +925,10 @@ attr_list:
       if ($3 != nullptr) {
         $$ = $3;
       } else {
-        $$ = new std::vector<RelAttrSqlNode>;
+        $$ = create_node<std::vector<RelAttrSqlNode>>(scanner);
       }
 
       $$->emplace_back(*$2);
-      delete $2;
     }
     ;
 
@@ -751,15 +937,14 @@ rel_list:
     {
       $$ = nullptr;
     }
-    | COMMA ID rel_list {
+    | COMMA identifier rel_list {
       if ($3 != nullptr) {
         $$ = $3;
       } else {
-        $$ = new std::vector<std::string>;
+        $$ = create_node<std::vector<std::string>>(scanner);
       }
 
       $$->push_back($2);
-      free($2);
     }
     ;
 where:
@@ -777,68 +962,54 @@ condition_list:
       $$ = nullptr;
     }
     | condition {
-      $$ = new std::vector<ConditionSqlNode>;
+      $$ = create_node<std::vector<ConditionSqlNode>>(scanner);
       $$->emplace_back(*$1);
-      delete $1;
     }
     | condition AND condition_list {
       $$ = $3;
       $$->emplace_back(*$1);
-      delete $1;
     }
     ;
 condition:
     rel_attr comp_op value
     {
-      $$ = new ConditionSqlNode;
+      $$ = create_node<ConditionSqlNode>(scanner);
       $$->left_is_attr = 1;
       $$->left_attr = *$1;
       $$->right_is_attr = 0;
       $$->right_value = *$3;
       $$->comp = $2;
-
-      delete $1;
-      delete $3;
     }
     | value comp_op value 
     {
-      $$ = new ConditionSqlNode;
+      $$ = create_node<ConditionSqlNode>(scanner);
       $$->left_is_attr = 0;
       $$->left_value = *$1;
       $$->right_is_attr = 0;
       $$->right_value = *$3;
       $$->comp = $2;
-
-      delete $1;
-      delete $3;
     }
     | rel_attr comp_op rel_attr
     {
-      $$ = new ConditionSqlNode;
+      $$ = create_node<ConditionSqlNode>(scanner);
       $$->left_is_attr = 1;
       $$->left_attr = *$1;
       $$->right_is_attr = 1;
       $$->right_attr = *$3;
       $$->comp = $2;
-
-      delete $1;
-      delete $3;
     }
     | value comp_op rel_attr
     {
-      $$ = new ConditionSqlNode;
+      $$ = create_node<ConditionSqlNode>(scanner);
       $$->left_is_attr = 0;
       $$->left_value = *$1;
       $$->right_is_attr = 1;
       $$->right_attr = *$3;
       $$->comp = $2;
-
-      delete $1;
-      delete $3;
     }
     | rel_attr like_comp_op SSS
     {
-      $$ = new ConditionSqlNode;
+      $$ = create_node<ConditionSqlNode>(scanner);
 
       $$->left_is_attr = 1;
       $$->comp = $2;
@@ -846,7 +1017,7 @@ condition:
 
       $$->left_attr = *$1;
 
-      string regex = common::substr($3,1,strlen($3)-2);
+      string regex($3 + 1, strlen($3) - 2);
       size_t pos = 0;
       while ((pos = regex.find("%", pos)) != string::npos) {
         regex.replace(pos, 1, ".*");
@@ -858,11 +1029,7 @@ condition:
         pos += 1;
       }
       // cout << regex << endl;
-      Value *value = new Value(regex.c_str());
-      $$->right_value = *value;
-
-      delete $1;
-      free($3);
+      $$->right_value = Value(regex.c_str());
     }
     ;
 
@@ -880,34 +1047,28 @@ like_comp_op:
     ;
 
 load_data_stmt:
-    LOAD DATA INFILE SSS INTO TABLE ID 
+    LOAD DATA INFILE SSS INTO TABLE identifier 
     {
-      char *tmp_file_name = common::substr($4, 1, strlen($4) - 2);
-      
-      $$ = new ParsedSqlNode(SCF_LOAD_DATA);
+      $$ = create_node<ParsedSqlNode>(scanner, SCF_LOAD_DATA);
       $$->load_data.relation_name = $7;
-      $$->load_data.file_name = tmp_file_name;
-      free($7);
-      free(tmp_file_name);
+      $$->load_data.file_name = string($4 + 1, strlen($4) - 2);
     }
     ;
 
 explain_stmt:
     EXPLAIN command_wrapper
     {
-      $$ = new ParsedSqlNode(SCF_EXPLAIN);
-      $$->explain.sql_node = std::unique_ptr<ParsedSqlNode>($2);
+      $$ = create_node<ParsedSqlNode>(scanner, SCF_EXPLAIN);
+      $$->explain.sql_node = $2;
     }
     ;
 
 set_variable_stmt:
     SET ID EQ value
     {
-      $$ = new ParsedSqlNode(SCF_SET_VARIABLE);
+      $$ = create_node<ParsedSqlNode>(scanner, SCF_SET_VARIABLE);
       $$->set_variable.name  = $2;
       $$->set_variable.value = *$4;
-      free($2);
-      delete $4;
     }
     ;
 
@@ -916,13 +1077,47 @@ opt_semicolon: /*empty*/
     ;
 %%
 //_____________________________________________________________________
-extern void scan_string(const char *str, yyscan_t scanner);
+/**
+ * @brief 每个线程复用一个词法分析器，不用每条语句都创建和销毁
+ */
+class ScannerHolder
+{
+public:
+  ScannerHolder() { yylex_init(&scanner_); }
+  ~ScannerHolder() { yylex_destroy(scanner_); }
+
+  yyscan_t scanner() const { return scanner_; }
 
-int sql_parse(const char *s, ParsedSqlResult *sql_result) {
-  yyscan_t scanner;
-  yylex_init(&scanner);
-  scan_string(s, scanner);
+private:
+  yyscan_t scanner_ = nullptr;
+};
+
+int sql_parse(const char *s, ParsedSqlResult *sql_result, common::Arena &arena) {
+  static thread_local ScannerHolder scanner_holder;
+  yyscan_t scanner = scanner_holder.scanner();
+
+  // flex 要求缓冲区以两个'\0'结尾。把SQL复制到 arena 中直接作为词法分析的缓冲区，
+  // 词法分析返回的字符串也从 arena 中分配，随 arena 一起释放
+  const size_t len = strlen(s);
+  char *buffer = static_cast<char *>(arena.alloc(len + 2, 1));
+  memcpy(buffer, s, len);
+  buffer[len] = buffer[len + 1] = '\0';
+
+  sql_result->digest_text().reserve(std::min(len, ParsedSqlResult::MAX_DIGEST_TEXT_LENGTH) + 16);
+
+  yyset_extra(&arena, scanner);
+  YY_BUFFER_STATE buffer_state = yy_scan_buffer(buffer, len + 2, scanner);
+  yyset_lineno(1, scanner);
+  yyset_column(0, scanner);
   int result = yyparse(s, sql_result, scanner);
-  yylex_destroy(scanner);
+  if (result != 0) {
+    // 语法错误时剩下的部分没有做词法分析，摘要文本也要包含完整的语句
+    YYSTYPE yylval;
+    YYLTYPE yylloc;
+    while (digest_lex(&yylval, &yylloc, scanner, sql_result) > 0) {
+    }
+  }
+  collapse_insert_rows(sql_result->digest_text());
+  yy_delete_buffer(buffer_state, scanner);
   return result;
 }
@@ -40,9 +40,9 @@ public:
   }
 
 public:
-  static RC create(CalcSqlNode &calc_sql, Stmt *&stmt)
+  static RC create(CalcSqlNode &calc_sql, Stmt *&stmt, common::Arena &arena)
   {
-    CalcStmt *calc_stmt = new CalcStmt();
+    CalcStmt *calc_stmt = arena.create<CalcStmt>();
     for (Expression * const expr : calc_sql.expressions) {
       calc_stmt->expressions_.emplace_back(expr);
     }
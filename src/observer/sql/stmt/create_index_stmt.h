@@ -45,7 +45,7 @@ public:
   std::vector<const FieldMeta *>& fields() { return field_metas_; }
 
 public:
-  static RC create(Db *db, const CreateIndexSqlNode &create_index, Stmt *&stmt);
+  static RC create(Db *db, const CreateIndexSqlNode &create_index, Stmt *&stmt, common::Arena &arena);
 
 private:
   Table *table_ = nullptr;
@@ -15,9 +15,10 @@ See the Mulan PSL v2 for more details. */
 #include "sql/stmt/create_table_stmt.h"
 #include "event/sql_debug.h"
 
-RC CreateTableStmt::create(Db *db, const CreateTableSqlNode &create_table, Stmt *&stmt)
+RC CreateTableStmt::create(Db *db, const CreateTableSqlNode &create_table, Stmt *&stmt, common::Arena &arena)
 {
-  stmt = new CreateTableStmt(create_table.relation_name, create_table.attr_infos);
+  stmt = arena.create<CreateTableStmt>(create_table.relation_name, create_table.attr_infos, create_table.storage_format,
+      create_table.page_size);
   sql_debug("create table statement: table name %s", create_table.relation_name.c_str());
   return RC::SUCCESS;
 }
@@ -29,9 +29,13 @@ class Db;
 class CreateTableStmt : public Stmt
 {
 public:
-  CreateTableStmt(const std::string &table_name, const std::vector<AttrInfoSqlNode> &attr_infos)
+  CreateTableStmt(
+      const std::string &table_name, const std::vector<AttrInfoSqlNode> &attr_infos, StorageFormat storage_format,
+      int page_size)
         : table_name_(table_name),
-          attr_infos_(attr_infos)
+          attr_infos_(attr_infos),
+          storage_format_(storage_format),
+          page_size_(page_size)
   {}
   virtual ~CreateTableStmt() = default;
 
@@ -39,10 +43,14 @@ public:
 
   const std::string &table_name() const { return table_name_; }
   const std::vector<AttrInfoSqlNode> &attr_infos() const { return attr_infos_; }
+  StorageFormat storage_format() const { return storage_format_; }
+  int page_size() const { return page_size_; }
 
-  static RC create(Db *db, const CreateTableSqlNode &create_table, Stmt *&stmt);
+  static RC create(Db *db, const CreateTableSqlNode &create_table, Stmt *&stmt, common::Arena &arena);
 
 private:
   std::string table_name_;
   std::vector<AttrInfoSqlNode> attr_infos_;
+  StorageFormat storage_format_ = ROW_FORMAT;
+  int page_size_ = BP_PAGE_SIZE;
 };
\ No newline at end of file
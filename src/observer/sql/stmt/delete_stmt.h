@@ -28,7 +28,7 @@ class DeleteStmt : public Stmt
 {
 public:
   DeleteStmt(Table *table, FilterStmt *filter_stmt);
-  ~DeleteStmt() override;
+  ~DeleteStmt() override = default;
 
   Table *table() const
   {
@@ -45,9 +45,9 @@ public:
   }
 
 public:
-  static RC create(Db *db, const DeleteSqlNode &delete_sql, Stmt *&stmt);
+  static RC create(Db *db, const DeleteSqlNode &delete_sql, Stmt *&stmt, common::Arena &arena);
 
 private:
   Table *table_ = nullptr;
-  FilterStmt *filter_stmt_ = nullptr;
+  FilterStmt *filter_stmt_ = nullptr;  ///< 和 DeleteStmt 一样分配在 arena 中
 };
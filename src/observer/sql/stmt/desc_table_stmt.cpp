@@ -14,12 +14,14 @@ See the Mulan PSL v2 for more details. */
 
 #include "sql/stmt/desc_table_stmt.h"
 #include "storage/db/db.h"
+#include "storage/table/system_tables.h"
 
-RC DescTableStmt::create(Db *db, const DescTableSqlNode &desc_table, Stmt *&stmt)
+RC DescTableStmt::create(Db *db, const DescTableSqlNode &desc_table, Stmt *&stmt, common::Arena &arena)
 {
-  if (db->find_table(desc_table.relation_name.c_str()) == nullptr) {
+  const char *table_name = desc_table.relation_name.c_str();
+  if (db->find_table(table_name) == nullptr && SystemTables::find(table_name) == nullptr) {
     return RC::SCHEMA_TABLE_NOT_EXIST;
   }
-  stmt = new DescTableStmt(desc_table.relation_name);
+  stmt = arena.create<DescTableStmt>(desc_table.relation_name);
   return RC::SUCCESS;
 }
@@ -38,7 +38,7 @@ public:
 
   const std::string &table_name() const { return table_name_; }
 
-  static RC create(Db *db, const DescTableSqlNode &desc_table, Stmt *&stmt);
+  static RC create(Db *db, const DescTableSqlNode &desc_table, Stmt *&stmt, common::Arena &arena);
 
 private:
   std::string table_name_;
@@ -6,9 +6,9 @@
 #include "drop_table_stmt.h"
 #include "event/sql_debug.h"
 
-RC DropTableStmt::create(Db *db, const DropTableSqlNode &drop_table, Stmt *&stmt) 
+RC DropTableStmt::create(Db *db, const DropTableSqlNode &drop_table, Stmt *&stmt, common::Arena &arena) 
 { 
-    stmt = new DropTableStmt(drop_table.relation_name);
+    stmt = arena.create<DropTableStmt>(drop_table.relation_name);
     sql_debug("drop table statement: table name %s", drop_table.relation_name.c_str());
     return RC::SUCCESS; 
 }
\ No newline at end of file
@@ -26,7 +26,7 @@ StmtType type() const override { return StmtType::DROP_TABLE; }
 
 const std::string &table_name() const { return table_name_; }
 
-static RC create(Db *db, const DropTableSqlNode &drop_table, Stmt *&stmt);
+static RC create(Db *db, const DropTableSqlNode &drop_table, Stmt *&stmt, common::Arena &arena);
 
 private:
     std::string table_name_;
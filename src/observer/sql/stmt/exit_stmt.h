@@ -32,9 +32,9 @@ public:
 
   StmtType type() const override { return StmtType::EXIT; }
 
-  static RC create(Stmt *&stmt)
+  static RC create(Stmt *&stmt, common::Arena &arena)
   {
-    stmt = new ExitStmt();
+    stmt = arena.create<ExitStmt>();
     return RC::SUCCESS;
   }
 };
\ No newline at end of file
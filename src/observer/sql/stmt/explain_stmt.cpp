@@ -16,19 +16,18 @@ See the Mulan PSL v2 for more details. */
 #include "sql/stmt/stmt.h"
 #include "common/log/log.h"
 
-ExplainStmt::ExplainStmt(std::unique_ptr<Stmt> child_stmt) : child_stmt_(std::move(child_stmt))
+ExplainStmt::ExplainStmt(Stmt *child_stmt) : child_stmt_(child_stmt)
 {}
 
-RC ExplainStmt::create(Db *db, const ExplainSqlNode &explain, Stmt *&stmt)
+RC ExplainStmt::create(Db *db, const ExplainSqlNode &explain, Stmt *&stmt, common::Arena &arena)
 {
   Stmt *child_stmt = nullptr;
-  RC rc = Stmt::create_stmt(db, *explain.sql_node, child_stmt);
+  RC rc = Stmt::create_stmt(db, *explain.sql_node, child_stmt, arena);
   if (rc != RC::SUCCESS) {
     LOG_WARN("failed to create explain's child stmt. rc=%s", strrc(rc));
     return rc;
   }
 
-  std::unique_ptr<Stmt> child_stmt_ptr = std::unique_ptr<Stmt>(child_stmt);
-  stmt = new ExplainStmt(std::move(child_stmt_ptr));
+  stmt = arena.create<ExplainStmt>(child_stmt);
   return rc;
 }
@@ -14,7 +14,6 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
-#include <memory>
 #include "sql/stmt/stmt.h"
 
 /**
@@ -24,7 +23,7 @@ See the Mulan PSL v2 for more details. */
 class ExplainStmt : public Stmt 
 {
 public:
-  ExplainStmt(std::unique_ptr<Stmt> child_stmt);
+  explicit ExplainStmt(Stmt *child_stmt);
   virtual ~ExplainStmt() = default;
 
   StmtType type() const override
@@ -34,11 +33,11 @@ public:
 
   Stmt *child() const
   {
-    return child_stmt_.get();
+    return child_stmt_;
   }
 
-  static RC create(Db *db, const ExplainSqlNode &query, Stmt *&stmt);
+  static RC create(Db *db, const ExplainSqlNode &query, Stmt *&stmt, common::Arena &arena);
 
 private:
-  std::unique_ptr<Stmt> child_stmt_;
+  Stmt *child_stmt_ = nullptr;  ///< 和 ExplainStmt 一样分配在 arena 中
 };
@@ -19,26 +19,17 @@ See the Mulan PSL v2 for more details. */
 #include "storage/db/db.h"
 #include "storage/table/table.h"
 
-FilterStmt::~FilterStmt()
-{
-  for (FilterUnit *unit : filter_units_) {
-    delete unit;
-  }
-  filter_units_.clear();
-}
-
 RC FilterStmt::create(Db *db, Table *default_table, std::unordered_map<std::string, Table *> *tables,
-    const ConditionSqlNode *conditions, int condition_num, FilterStmt *&stmt)
+    const ConditionSqlNode *conditions, int condition_num, FilterStmt *&stmt, common::Arena &arena)
 {
   RC rc = RC::SUCCESS;
   stmt = nullptr;
 
-  FilterStmt *tmp_stmt = new FilterStmt();
+  FilterStmt *tmp_stmt = arena.create<FilterStmt>();
   for (int i = 0; i < condition_num; i++) {
     FilterUnit *filter_unit = nullptr;
-    rc = create_filter_unit(db, default_table, tables, conditions[i], filter_unit);
+    rc = create_filter_unit(db, default_table, tables, conditions[i], filter_unit, arena);
     if (rc != RC::SUCCESS) {
-      delete tmp_stmt;
       LOG_WARN("failed to create filter unit. condition index=%d", i);
       return rc;
     }
@@ -78,7 +69,7 @@ RC get_table_and_field(Db *db, Table *default_table, std::unordered_map<std::str
 }
 
 RC FilterStmt::create_filter_unit(Db *db, Table *default_table, std::unordered_map<std::string, Table *> *tables,
-    const ConditionSqlNode &condition, FilterUnit *&filter_unit)
+    const ConditionSqlNode &condition, FilterUnit *&filter_unit, common::Arena &arena)
 {
   RC rc = RC::SUCCESS;
   CompOp comp = condition.comp;
@@ -104,7 +95,7 @@ RC FilterStmt::create_filter_unit(Db *db, Table *default_table, std::unordered_m
       return RC::INTERNAL;
     }
 
-    filter_unit = new FilterUnit;
+    filter_unit = arena.create<FilterUnit>();
     filter_unit->set_comp(comp);
     // 设置左滤子
     FilterObj left_filter_obj;
@@ -123,7 +114,7 @@ RC FilterStmt::create_filter_unit(Db *db, Table *default_table, std::unordered_m
     return RC::INVALID_ARGUMENT;
   }
 
-  filter_unit = new FilterUnit;
+  filter_unit = arena.create<FilterUnit>();
   DEBUG_PRINT("debug: filter_stmt: 算术操作符\n");
   if (condition.left_is_attr) {
     Table *table = nullptr;
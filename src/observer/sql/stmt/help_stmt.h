@@ -32,9 +32,9 @@ public:
 
   StmtType type() const override { return StmtType::HELP; }
 
-  static RC create(Stmt *&stmt)
+  static RC create(Stmt *&stmt, common::Arena &arena)
   {
-    stmt = new HelpStmt();
+    stmt = arena.create<HelpStmt>();
     return RC::SUCCESS;
   }
 };
\ No newline at end of file
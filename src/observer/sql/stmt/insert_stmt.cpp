@@ -17,11 +17,11 @@ See the Mulan PSL v2 for more details. */
 #include "storage/db/db.h"
 #include "storage/table/table.h"
 
-InsertStmt::InsertStmt(Table *table, const Value *values, int value_amount)
-    : table_(table), values_(values), value_amount_(value_amount)
+InsertStmt::InsertStmt(Table *table, const std::vector<std::vector<Value>> *rows)
+    : table_(table), rows_(rows)
 {}
 
-RC InsertStmt::create(Db *db,/*delete*/ InsertSqlNode &inserts, Stmt *&stmt)
+RC InsertStmt::create(Db *db,/*delete*/ InsertSqlNode &inserts, Stmt *&stmt, common::Arena &arena)
 {
   const char *table_name = inserts.relation_name.c_str();
   if (nullptr == db || nullptr == table_name || inserts.values.empty()) {
@@ -37,9 +37,24 @@ RC InsertStmt::create(Db *db,/*delete*/ InsertSqlNode &inserts, Stmt *&stmt)
     return RC::SCHEMA_TABLE_NOT_EXIST;
   }
 
+  for (std::vector<Value> &row : inserts.values) {
+    RC rc = check_row(table, row);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+
+  // everything alright
+  stmt = arena.create<InsertStmt>(table, &inserts.values);
+  return RC::SUCCESS;
+}
+
+RC InsertStmt::check_row(Table *table, std::vector<Value> &row)
+{
   // check the fields number
-  Value *values = inserts.values.data();  // modify
-  const int value_num = static_cast<int>(inserts.values.size());
+  const char *table_name = table->name();
+  Value *values = row.data();  // modify
+  const int value_num = static_cast<int>(row.size());
   const TableMeta &table_meta = table->table_meta();
   const int field_num = table_meta.field_num() - table_meta.sys_field_num();
   if (field_num != value_num) {
@@ -101,8 +116,5 @@ RC InsertStmt::create(Db *db,/*delete*/ InsertSqlNode &inserts, Stmt *&stmt)
       return RC::VARIABLE_NOT_VALID;
     }
   }
-
-  // everything alright
-  stmt = new InsertStmt(table, values, value_num);
   return RC::SUCCESS;
 }
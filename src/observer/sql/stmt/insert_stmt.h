@@ -28,7 +28,7 @@ class InsertStmt : public Stmt
 {
 public:
   InsertStmt() = default;
-  InsertStmt(Table *table, const Value *values, int value_amount);
+  InsertStmt(Table *table, const std::vector<std::vector<Value>> *rows);
 
   StmtType type() const override
   {
@@ -36,24 +36,28 @@ public:
   }
 
 public:
-  static RC create(Db *db, InsertSqlNode &insert_sql, Stmt *&stmt);
+  static RC create(Db *db, InsertSqlNode &insert_sql, Stmt *&stmt, common::Arena &arena);
 
 public:
   Table *table() const
   {
     return table_;
   }
-  const Value *values() const
+  /**
+   * @brief 要插入的所有行，每一行的值都已经转换成了字段的类型
+   */
+  const std::vector<std::vector<Value>> &rows() const
   {
-    return values_;
-  }
-  int value_amount() const
-  {
-    return value_amount_;
+    return *rows_;
   }
 
+private:
+  /**
+   * @brief 检查一行数据与表的字段是否匹配，必要时转换值的类型
+   */
+  static RC check_row(Table *table, std::vector<Value> &values);
+
 private:
   Table *table_ = nullptr;
-  const Value *values_ = nullptr;
-  int value_amount_ = 0;
+  const std::vector<std::vector<Value>> *rows_ = nullptr;
 };
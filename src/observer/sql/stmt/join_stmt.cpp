@@ -1,7 +1,7 @@
 #include "join_stmt.h"
 
 RC JoinStmt::create(Db *db, Table *default_table, std::unordered_map<std::string, Table *> *table_map,
-    const JoinSqlNode &sql_node, JoinStmt *&stmt)
+    const JoinSqlNode &sql_node, JoinStmt *&stmt, common::Arena &arena)
 {
   RC rc = RC::SUCCESS;
   stmt = nullptr;
@@ -10,10 +10,10 @@ RC JoinStmt::create(Db *db, Table *default_table, std::unordered_map<std::string
   if (sql_node.conditions.size() == 0) {
     return RC::INVALID_ARGUMENT;
   }
-  JoinStmt *tmp_stmt = new JoinStmt();
+  JoinStmt *tmp_stmt = arena.create<JoinStmt>();
   // 创建过滤语句
   rc = FilterStmt::create(db, default_table, table_map, sql_node.conditions.data(), 
-    sql_node.conditions.size(), tmp_stmt->filter_);
+    sql_node.conditions.size(), tmp_stmt->filter_, arena);
   if (rc != RC::SUCCESS) {
     LOG_WARN("cannot construct filter stmt");
     return rc;
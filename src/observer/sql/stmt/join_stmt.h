@@ -16,11 +16,6 @@ class JoinStmt
 {
 public:
   JoinStmt() = default;
-  ~JoinStmt() {
-    if (filter_ != nullptr) {
-      delete filter_;
-    }
-  }
 
 public:
   FilterStmt* join_condition() 
@@ -29,7 +24,7 @@ public:
   }
 public:
     static RC create(Db *db, Table *default_table, std::unordered_map<std::string, Table *> *table_map, 
-        const JoinSqlNode &sql_node, JoinStmt*&stmt);
+        const JoinSqlNode &sql_node, JoinStmt*&stmt, common::Arena &arena);
 private:
-  FilterStmt* filter_ = nullptr;
+  FilterStmt* filter_ = nullptr;  // 和 JoinStmt 一样分配在 arena 中
 };
\ No newline at end of file
@@ -21,7 +21,7 @@ See the Mulan PSL v2 for more details. */
 
 using namespace common;
 
-RC LoadDataStmt::create(Db *db, const LoadDataSqlNode &load_data, Stmt *&stmt)
+RC LoadDataStmt::create(Db *db, const LoadDataSqlNode &load_data, Stmt *&stmt, common::Arena &arena)
 {
   RC rc = RC::SUCCESS;
   const char *table_name = load_data.relation_name.c_str();
@@ -43,6 +43,6 @@ RC LoadDataStmt::create(Db *db, const LoadDataSqlNode &load_data, Stmt *&stmt)
     return RC::FILE_NOT_EXIST;
   }
 
-  stmt = new LoadDataStmt(table, load_data.file_name.c_str());
+  stmt = arena.create<LoadDataStmt>(table, load_data.file_name.c_str());
   return rc;
 }
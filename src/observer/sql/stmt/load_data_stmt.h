@@ -33,7 +33,7 @@ public:
   Table *table() const { return table_; }
   const char *filename() const { return filename_.c_str(); }
 
-  static RC create(Db *db, const LoadDataSqlNode &load_data, Stmt *&stmt);
+  static RC create(Db *db, const LoadDataSqlNode &load_data, Stmt *&stmt, common::Arena &arena);
 
 private:
   Table *table_ = nullptr;
@@ -0,0 +1,25 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "sql/stmt/reset_stmt.h"
+#include "common/log/log.h"
+#include "sql/parser/parse_defs.h"
+#include "storage/table/system_tables.h"
+
+RC ResetStmt::create(const ResetSqlNode &reset, Stmt *&stmt, common::Arena &arena)
+{
+  if (reset.name != SystemTables::STATEMENT_DIGESTS) {
+    LOG_WARN("cannot reset %s", reset.name.c_str());
+    return RC::SCHEMA_TABLE_NOT_EXIST;
+  }
+
+  stmt = arena.create<ResetStmt>(reset.name);
+  return RC::SUCCESS;
+}
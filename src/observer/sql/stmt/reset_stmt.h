@@ -0,0 +1,37 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <string>
+
+#include "sql/stmt/stmt.h"
+
+struct ResetSqlNode;
+
+/**
+ * @brief 清空系统表中统计数据的语句，当前只支持 RESET statement_digests
+ * @ingroup Statement
+ */
+class ResetStmt : public Stmt
+{
+public:
+  ResetStmt(const std::string &name) : name_(name) {}
+  virtual ~ResetStmt() = default;
+
+  StmtType type() const override { return StmtType::RESET; }
+
+  const std::string &name() const { return name_; }
+
+  static RC create(const ResetSqlNode &reset, Stmt *&stmt, common::Arena &arena);
+
+private:
+  std::string name_;
+};
@@ -20,20 +20,7 @@ See the Mulan PSL v2 for more details. */
 #include "common/lang/string.h"
 #include "storage/db/db.h"
 #include "storage/table/table.h"
-
-SelectStmt::~SelectStmt()
-{
-  if (nullptr != filter_stmt_) {
-    delete filter_stmt_;
-    filter_stmt_ = nullptr;
-  }
-  for (auto p : join_stmts_) {
-    if (p != nullptr) {
-      delete p;
-    }
-  }
-  join_stmts_.clear();
-}
+#include "storage/table/system_tables.h"
 
 static void wildcard_fields(Table *table, std::vector<Field> &field_metas)
 {
@@ -53,7 +40,7 @@ static void wildcard_query_exprs(Table *table, std::vector<Expression *> &expres
   }
 }
 
-RC SelectStmt::create(Db *db, const SelectSqlNode &select_sql, Stmt *&stmt)
+RC SelectStmt::create(Db *db, const SelectSqlNode &select_sql, Stmt *&stmt, common::Arena &arena)
 {
   if (nullptr == db) {
     LOG_WARN("invalid argument. db is null");
@@ -77,6 +64,9 @@ RC SelectStmt::create(Db *db, const SelectSqlNode &select_sql, Stmt *&stmt)
     }
 
     Table *table = db->find_table(table_name);
+    if (nullptr == table) {
+      table = SystemTables::find(table_name);
+    }
     if (nullptr == table) {
       LOG_WARN("no such table. db=%s, table_name=%s", db->name(), table_name);
       return RC::SCHEMA_TABLE_NOT_EXIST;
@@ -96,6 +86,9 @@ RC SelectStmt::create(Db *db, const SelectSqlNode &select_sql, Stmt *&stmt)
     }
 
     Table *table = db->find_table(table_name.c_str());
+    if (nullptr == table) {
+      table = SystemTables::find(table_name.c_str());
+    }
     if (nullptr == table) {
       LOG_WARN("no such table. db=%s, table_name=%s", db->name(), table_name.c_str());
       return RC::SCHEMA_TABLE_NOT_EXIST;
@@ -222,7 +215,7 @@ RC SelectStmt::create(Db *db, const SelectSqlNode &select_sql, Stmt *&stmt)
   for (size_t i = 0; i < select_sql.joins.size(); i++) {
     RC rc = RC::SUCCESS;
     JoinStmt* join_stmt = nullptr;
-    rc = JoinStmt::create(db, default_table, &table_map, select_sql.joins[i], join_stmt);
+    rc = JoinStmt::create(db, default_table, &table_map, select_sql.joins[i], join_stmt, arena);
     if (rc != RC::SUCCESS) {
       return rc;
     }
@@ -238,14 +231,15 @@ RC SelectStmt::create(Db *db, const SelectSqlNode &select_sql, Stmt *&stmt)
       &table_map,
       select_sql.conditions.data(),
       static_cast<int>(select_sql.conditions.size()),
-      filter_stmt);
+      filter_stmt,
+      arena);
   if (rc != RC::SUCCESS) {
     LOG_WARN("cannot construct filter stmt");
     return rc;
   }
 
   // everything alright
-  SelectStmt *select_stmt = new SelectStmt();
+  SelectStmt *select_stmt = arena.create<SelectStmt>();
   // TODO add expression copy
   select_stmt->tables_.swap(tables);
   select_stmt->filter_stmt_ = filter_stmt;
@@ -36,7 +36,7 @@ class SelectStmt : public Stmt
 {
 public:
   SelectStmt() = default;
-  ~SelectStmt() override;
+  ~SelectStmt() override = default;
 
   StmtType type() const override
   {
@@ -44,7 +44,7 @@ public:
   }
 
 public:
-  static RC create(Db *db, const SelectSqlNode &select_sql, Stmt *&stmt);
+  static RC create(Db *db, const SelectSqlNode &select_sql, Stmt *&stmt, common::Arena &arena);
 
 public:
   const std::vector<Table *> &tables() const
@@ -66,9 +66,9 @@ public:
 
 private:
   std::vector<Table *> tables_;
-  FilterStmt *filter_stmt_ = nullptr;
+  FilterStmt *filter_stmt_ = nullptr;  ///< 和 SelectStmt 一样分配在 arena 中
   std::vector<Expression *> query_exprs_; // new
   // join: 表名，对应的表，join条件
-  std::vector<JoinStmt*> join_stmts_;  // new
+  std::vector<JoinStmt*> join_stmts_;  // new，也分配在 arena 中
   // GOURP BY
 };
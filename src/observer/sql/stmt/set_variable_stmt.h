@@ -35,10 +35,10 @@ public:
   const char *var_name() const { return set_variable_.name.c_str(); }
   const Value &var_value() const { return set_variable_.value; }
   
-  static RC create(const SetVariableSqlNode &set_variable, Stmt *&stmt)
+  static RC create(const SetVariableSqlNode &set_variable, Stmt *&stmt, common::Arena &arena)
   {
     /// 可以校验是否存在某个变量，但是这里忽略
-    stmt = new SetVariableStmt(set_variable);
+    stmt = arena.create<SetVariableStmt>(set_variable);
     return RC::SUCCESS;
   }
 
@@ -34,9 +34,9 @@ public:
 
   StmtType type() const override { return StmtType::SHOW_TABLES; }
 
-  static RC create(Db *db, Stmt *&stmt)
+  static RC create(Db *db, Stmt *&stmt, common::Arena &arena)
   {
-    stmt = new ShowTablesStmt();
+    stmt = arena.create<ShowTablesStmt>();
     return RC::SUCCESS;
   }
 };
\ No newline at end of file
@@ -21,6 +21,8 @@ See the Mulan PSL v2 for more details. */
 #include "sql/stmt/create_index_stmt.h"
 #include "sql/stmt/create_table_stmt.h"
 #include "sql/stmt/desc_table_stmt.h"
+#include "sql/stmt/analyze_table_stmt.h"
+#include "sql/stmt/reset_stmt.h"
 #include "sql/stmt/help_stmt.h"
 #include "sql/stmt/show_tables_stmt.h"
 #include "sql/stmt/trx_begin_stmt.h"
@@ -32,77 +34,85 @@ See the Mulan PSL v2 for more details. */
 #include "sql/stmt/drop_table_stmt.h"   // new
 #include "sql/stmt/update_stmt.h"       // new
 
-RC Stmt::create_stmt(Db *db, ParsedSqlNode &sql_node, Stmt *&stmt)
+RC Stmt::create_stmt(Db *db, ParsedSqlNode &sql_node, Stmt *&stmt, common::Arena &arena)
 {
   stmt = nullptr;
 
   switch (sql_node.flag) {
     case SCF_INSERT: {
-      return InsertStmt::create(db, sql_node.insertion, stmt);
+      return InsertStmt::create(db, sql_node.insertion, stmt, arena);
     }
     case SCF_UPDATE: {    // new
-      return UpdateStmt::create(db, sql_node.update, stmt);
+      return UpdateStmt::create(db, sql_node.update, stmt, arena);
     }
     case SCF_DELETE: {
-      return DeleteStmt::create(db, sql_node.deletion, stmt);
+      return DeleteStmt::create(db, sql_node.deletion, stmt, arena);
     }
     case SCF_SELECT: {
       // DEBUG_PRINT("debug: 创建select语句\n");
-      return SelectStmt::create(db, sql_node.selection, stmt);
+      return SelectStmt::create(db, sql_node.selection, stmt, arena);
     }
 
     case SCF_EXPLAIN: {
-      return ExplainStmt::create(db, sql_node.explain, stmt);
+      return ExplainStmt::create(db, sql_node.explain, stmt, arena);
     }
 
     case SCF_CREATE_INDEX: {
-      return CreateIndexStmt::create(db, sql_node.create_index, stmt);
+      return CreateIndexStmt::create(db, sql_node.create_index, stmt, arena);
     }
 
     case SCF_CREATE_TABLE: {
-      return CreateTableStmt::create(db, sql_node.create_table, stmt);
+      return CreateTableStmt::create(db, sql_node.create_table, stmt, arena);
     }
 
     // new
     case SCF_DROP_TABLE: {
-      return DropTableStmt::create(db, sql_node.drop_table, stmt);
+      return DropTableStmt::create(db, sql_node.drop_table, stmt, arena);
     }
 
     case SCF_DESC_TABLE: {
-      return DescTableStmt::create(db, sql_node.desc_table, stmt);
+      return DescTableStmt::create(db, sql_node.desc_table, stmt, arena);
+    }
+
+    case SCF_ANALYZE_TABLE: {
+      return AnalyzeTableStmt::create(db, sql_node.analyze_table, stmt, arena);
+    }
+
+    case SCF_RESET: {
+      return ResetStmt::create(sql_node.reset, stmt, arena);
     }
 
     case SCF_HELP: {
-      return HelpStmt::create(stmt);
+      return HelpStmt::create(stmt, arena);
     }
 
     case SCF_SHOW_TABLES: {
-      return ShowTablesStmt::create(db, stmt);
+      return ShowTablesStmt::create(db, stmt, arena);
     }
 
     case SCF_BEGIN: {
-      return TrxBeginStmt::create(stmt);
+      return TrxBeginStmt::create(stmt, arena);
     }
 
     case SCF_COMMIT:
     case SCF_ROLLBACK: {
-      return TrxEndStmt::create(sql_node.flag, stmt);
+      return TrxEndStmt::create(sql_node.flag, stmt, arena);
     }
 
     case SCF_EXIT: {
-      return ExitStmt::create(stmt);
+      return ExitStmt::create(stmt, arena);
     }
 
     case SCF_SET_VARIABLE: {
-      return SetVariableStmt::create(sql_node.set_variable, stmt);
+      return SetVariableStmt::create(sql_node.set_variable, stmt, arena);
     }
 
     case SCF_LOAD_DATA: {
-      return LoadDataStmt::create(db, sql_node.load_data, stmt);
+      return LoadDataStmt::create(db, sql_node.load_data, stmt, arena);
     }
 
     case SCF_CALC: {
-      return CalcStmt::create(sql_node.calc, stmt);
+      return CalcStmt::create(sql_node.calc, stmt, arena);
     }
 
     default: {
@@ -15,6 +15,7 @@ See the Mulan PSL v2 for more details. */
 #pragma once
 
 #include "common/rc.h"
+#include "common/mm/arena.h"
 #include "sql/parser/parse_defs.h"
 
 class Db;
@@ -42,6 +43,8 @@ class Db;
   DEFINE_ENUM_ITEM(SYNC)            \
   DEFINE_ENUM_ITEM(SHOW_TABLES)     \
   DEFINE_ENUM_ITEM(DESC_TABLE)      \
+  DEFINE_ENUM_ITEM(ANALYZE_TABLE)   \
+  DEFINE_ENUM_ITEM(RESET)           \
   DEFINE_ENUM_ITEM(BEGIN)           \
   DEFINE_ENUM_ITEM(COMMIT)          \
   DEFINE_ENUM_ITEM(ROLLBACK)        \
@@ -74,6 +77,7 @@ inline const char *stmt_type_name(StmtType type)
  * @ingroup Statement
  * @details SQL解析后的语句，再进一步解析成Stmt，使用内部的数据结构来表示。
  * 比如table_name，解析成具体的 Table对象，attr/field name解析成Field对象。
+ * Stmt 以及它引用的 FilterStmt、JoinStmt 等都分配在语句的 arena 中，随 arena 一起析构，不能 delete。
  */
 class Stmt
 {
@@ -84,7 +88,7 @@ public:
   virtual StmtType type() const = 0;
 
 public:
-  static RC create_stmt(Db *db, ParsedSqlNode &sql_node, Stmt *&stmt);
+  static RC create_stmt(Db *db, ParsedSqlNode &sql_node, Stmt *&stmt, common::Arena &arena);
 
 private:
 };
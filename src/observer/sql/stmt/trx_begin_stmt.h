@@ -32,9 +32,9 @@ public:
 
   StmtType type() const override { return StmtType::BEGIN; }
 
-  static RC create(Stmt *&stmt)
+  static RC create(Stmt *&stmt, common::Arena &arena)
   {
-    stmt = new TrxBeginStmt();
+    stmt = arena.create<TrxBeginStmt>();
     return RC::SUCCESS;
   }
 };
\ No newline at end of file
@@ -33,10 +33,10 @@ public:
 
   StmtType type() const override { return type_; }
 
-  static RC create(SqlCommandFlag flag, Stmt *&stmt)
+  static RC create(SqlCommandFlag flag, Stmt *&stmt, common::Arena &arena)
   {
     StmtType type = flag == SqlCommandFlag::SCF_COMMIT ? StmtType::COMMIT : StmtType::ROLLBACK;
-    stmt = new TrxEndStmt(type);
+    stmt = arena.create<TrxEndStmt>(type);
     return RC::SUCCESS;
   }
 
@@ -22,7 +22,7 @@ UpdateStmt::UpdateStmt(Table *table, Value *value, std::string field_name, Filte
     : table_(table), value_(value), field_name_(field_name), filter_stmt_(filter_stmt)
 {}
 
-RC UpdateStmt::create(Db *db, const UpdateSqlNode &update, Stmt *&stmt)
+RC UpdateStmt::create(Db *db, const UpdateSqlNode &update, Stmt *&stmt, common::Arena &arena)
 {
 
   // 检查合法性
@@ -59,15 +59,15 @@ RC UpdateStmt::create(Db *db, const UpdateSqlNode &update, Stmt *&stmt)
 
   FilterStmt *filter_stmt = nullptr;
   RC rc = FilterStmt::create(
-      db, table, &table_map, update.conditions.data(), static_cast<int>(update.conditions.size()), filter_stmt);
+      db, table, &table_map, update.conditions.data(), static_cast<int>(update.conditions.size()), filter_stmt, arena);
   if (rc != RC::SUCCESS) {
     LOG_WARN("failed to create filter statement. rc=%d:%s", rc, strrc(rc));
     return rc;
   }
   // everything alright
-  Value *value = new Value(update.value);
+  Value *value = arena.create<Value>(update.value);
   std::string field_name = update.attribute_name;
 
-  stmt = new UpdateStmt(table, value, field_name, filter_stmt);
+  stmt = arena.create<UpdateStmt>(table, value, field_name, filter_stmt);
   return rc;
 }
@@ -36,7 +36,7 @@ public:
   }
 
 public:
-  static RC create(Db *db, const UpdateSqlNode &update_sql, Stmt *&stmt);
+  static RC create(Db *db, const UpdateSqlNode &update_sql, Stmt *&stmt, common::Arena &arena);
 
 public:
   Table *table() const
@@ -58,7 +58,7 @@ public:
 
 private:
   Table *table_ = nullptr;
-  Value *value_ = nullptr;
+  Value *value_ = nullptr;  ///< value_ 和 filter_stmt_ 都和 UpdateStmt 一样分配在 arena 中
   std::string field_name_;
   FilterStmt *filter_stmt_ = nullptr;
 };
@@ -13,18 +13,32 @@ See the Mulan PSL v2 for more details. */
 //
 #include <errno.h>
 #include <string.h>
+#include <algorithm>
+#include <shared_mutex>
 
 #include "storage/buffer/disk_buffer_pool.h"
 #include "common/lang/mutex.h"
 #include "common/log/log.h"
 #include "common/os/os.h"
 #include "common/io/io.h"
+#include "storage/common/io_backend.h"
+#include "session/statement_counters.h"
 #include "disk_buffer_pool.h"
 
 using namespace common;
 using namespace std;
 
-static const int MEM_POOL_ITEM_NUM = 20;
+/// 默认的页帧个数(20MB)，至少要有的页帧个数
+static const int64_t DEFAULT_FRAME_NUM = 2560;
+static const int64_t MIN_FRAME_NUM     = 16;
+
+/// 顺序访问时预读页面个数的范围。预读太多会把其它有用的页面挤出内存，所以最多只使用1/4的页帧
+static const int READ_AHEAD_MIN_PAGES = 4;
+static const int READ_AHEAD_MAX_PAGES = 64;
+
+/// 文件每次扩展的页面个数(区的大小)，按照文件当前大小的1/8扩展
+static const int EXTENT_MIN_PAGES = 8;
+static const int EXTENT_MAX_PAGES = 1024;
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -32,22 +46,20 @@ string BPFileHeader::to_string() const
 {
   stringstream ss;
   ss << "pageCount:" << page_count
-     << ", allocatedCount:" << allocated_pages;
+     << ", allocatedCount:" << allocated_pages
+     << ", version:" << version
+     << ", pageSize:" << page_size;
   return ss.str();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-BPFrameManager::BPFrameManager(const char *name) : allocator_(name)
+BPFrameManager::BPFrameManager(const char *name)
 {}
 
-RC BPFrameManager::init(int pool_num)
+RC BPFrameManager::init(int frame_num, bool lock_memory /* = false */, int page_size /* = BP_PAGE_SIZE */)
 {
-  int ret = allocator_.init(false, pool_num);
-  if (ret == 0) {
-    return RC::SUCCESS;
-  }
-  return RC::NOMEM;
+  return arena_.init(frame_num, lock_memory, page_size);
 }
 
 RC BPFrameManager::cleanup()
@@ -57,6 +69,7 @@ RC BPFrameManager::cleanup()
   }
 
   frames_.destroy();
+  arena_.cleanup();
   return RC::SUCCESS;
 }
 
@@ -129,7 +142,7 @@ Frame *BPFrameManager::alloc(int file_desc, PageNum page_num)
     return frame;
   }
 
-  frame = allocator_.alloc();
+  frame = arena_.alloc();
   if (frame != nullptr) {
     ASSERT(frame->pin_count() == 0, "got an invalid frame that pin count is not 0. frame=%s", 
            to_string(*frame).c_str());
@@ -158,7 +171,7 @@ RC BPFrameManager::free_internal(const FrameId &frame_id, Frame *frame)
 
   frame->unpin();
   frames_.remove(frame_id);
-  allocator_.free(frame);
+  arena_.free(frame);
   return RC::SUCCESS;
 }
 
@@ -185,7 +198,7 @@ BufferPoolIterator::~BufferPoolIterator()
 {}
 RC BufferPoolIterator::init(DiskBufferPool &bp, PageNum start_page /* = 0 */)
 {
-  bitmap_.init(bp.file_header_->bitmap, bp.file_header_->page_count);
+  buffer_pool_ = &bp;
   if (start_page <= 0) {
     current_page_num_ = 0;
   } else {
@@ -196,13 +209,13 @@ RC BufferPoolIterator::init(DiskBufferPool &bp, PageNum start_page /* = 0 */)
 
 bool BufferPoolIterator::has_next()
 {
-  return bitmap_.next_setted_bit(current_page_num_ + 1) != -1;
+  return buffer_pool_->next_allocated_page(current_page_num_ + 1) != BP_INVALID_PAGE_NUM;
 }
 
 PageNum BufferPoolIterator::next()
 {
-  PageNum next_page = bitmap_.next_setted_bit(current_page_num_ + 1);
-  if (next_page != -1) {
+  PageNum next_page = buffer_pool_->next_allocated_page(current_page_num_ + 1);
+  if (next_page != BP_INVALID_PAGE_NUM) {
     current_page_num_ = next_page;
   }
   return next_page;
@@ -215,8 +228,8 @@ RC BufferPoolIterator::reset()
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-DiskBufferPool::DiskBufferPool(BufferPoolManager &bp_manager, BPFrameManager &frame_manager)
-    : bp_manager_(bp_manager), frame_manager_(frame_manager)
+DiskBufferPool::DiskBufferPool(BufferPoolManager &bp_manager)
+    : bp_manager_(bp_manager), read_ahead_window_(READ_AHEAD_MIN_PAGES)
 {}
 
 DiskBufferPool::~DiskBufferPool()
@@ -234,10 +247,34 @@ RC DiskBufferPool::open_file(const char *file_name)
   }
   LOG_INFO("Successfully open buffer pool file %s.", file_name);
 
+  // 知道了页面大小才能分配页帧，所以先直接读取文件头
+  Page page;
+  if (readn(fd, &page, sizeof(page)) != 0) {
+    LOG_ERROR("Failed to read header of %s, due to %s.", file_name, strerror(errno));
+    close(fd);
+    return RC::IOERR_READ;
+  }
+
+  const BPFileHeader *header = reinterpret_cast<const BPFileHeader *>(page.data);
+  if (header->magic != BPFileHeader::MAGIC || header->version != BPFileHeader::VERSION) {
+    LOG_ERROR("unsupported file format of %s, it may be created by another version. "
+              "magic=%x, version=%d, expected magic=%x, version=%d",
+              file_name, header->magic, header->version, BPFileHeader::MAGIC, BPFileHeader::VERSION);
+    close(fd);
+    return RC::FILE_VERSION_MISMATCH;
+  }
+
+  RC rc = bp_manager_.frame_manager(header->page_size, frame_manager_);
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("failed to get frame manager for %s. page size=%d, rc=%s", file_name, header->page_size, strrc(rc));
+    close(fd);
+    return rc;
+  }
+
   file_name_ = file_name;
   file_desc_ = fd;
+  page_size_ = header->page_size;
 
-  RC rc = RC::SUCCESS;
   rc = allocate_frame(BP_HEADER_PAGE, &hdr_frame_);
   if (rc != RC::SUCCESS) {
     LOG_ERROR("failed to allocate frame for header. file name %s", file_name_.c_str());
@@ -259,6 +296,18 @@ RC DiskBufferPool::open_file(const char *file_name)
 
   file_header_ = (BPFileHeader *)hdr_frame_->data();
 
+  if (OB_FAIL(rc = load_groups())) {
+    LOG_ERROR("failed to load allocation bitmaps of %s. rc=%s", file_name, strrc(rc));
+    for (Frame *frame : group_frames_) {
+      frame->unpin();
+    }
+    group_frames_.clear();
+    purge_all_pages();
+    close(fd);
+    file_desc_ = -1;
+    return rc;
+  }
+
   LOG_INFO("Successfully open %s. file_desc=%d, hdr_frame=%p, file header=%s",
            file_name, file_desc_, hdr_frame_, file_header_->to_string().c_str());
   return RC::SUCCESS;
@@ -272,6 +321,13 @@ RC DiskBufferPool::close_file()
   }
 
   hdr_frame_->unpin();
+  for (Frame *frame : group_frames_) {
+    frame->unpin();
+  }
+  group_frames_.clear();
+  group_free_pages_.clear();
+  group_free_hint_.clear();
+  first_free_group_ = 0;
 
   // TODO: 理论上是在回放时回滚未提交事务，但目前没有undo log，因此不下刷数据page，只通过redo log回放
   rc = purge_all_pages();
@@ -308,20 +364,41 @@ RC DiskBufferPool::remove_file(const char *table_name)
   return rc;
 }
 
+Frame *DiskBufferPool::get_cached_page(PageNum page_num)
+{
+  return frame_manager_->get(file_desc_, page_num);
+}
+
 RC DiskBufferPool::get_this_page(PageNum page_num, Frame **frame)
 {
   RC rc = RC::SUCCESS;
   *frame = nullptr;
 
-  Frame *used_match_frame = frame_manager_.get(file_desc_, page_num);
+  Frame *used_match_frame = frame_manager_->get(file_desc_, page_num);
   if (used_match_frame != nullptr) {
     used_match_frame->access();
+    if (used_match_frame->clear_prefetched()) {
+      read_ahead_hits_++;
+    }
+    StatementCounters::current().buffer_hits++;
     *frame = used_match_frame;
     return RC::SUCCESS;
   }
 
   std::scoped_lock lock_guard(lock_); // 直接加了一把大锁，其实可以根据访问的页面来细化提高并行度
 
+  // 拿到锁之前，其它线程可能已经把这个页面加载进来了，比如预读
+  used_match_frame = frame_manager_->get(file_desc_, page_num);
+  if (used_match_frame != nullptr) {
+    used_match_frame->access();
+    if (used_match_frame->clear_prefetched()) {
+      read_ahead_hits_++;
+    }
+    StatementCounters::current().buffer_hits++;
+    *frame = used_match_frame;
+    return RC::SUCCESS;
+  }
+
   // Allocate one page and load the data into this page
   Frame *allocated_frame = nullptr;
   rc = allocate_frame(page_num, &allocated_frame);
@@ -333,6 +410,7 @@ RC DiskBufferPool::get_this_page(PageNum page_num, Frame **frame)
   allocated_frame->set_file_desc(file_desc_);
   // allocated_frame->pin(); // pined in manager::get
   allocated_frame->access();
+  StatementCounters::current().buffer_misses++;
 
   if ((rc = load_page(page_num, allocated_frame)) != RC::SUCCESS) {
     LOG_ERROR("Failed to load page %s:%d", file_name_.c_str(), page_num);
@@ -341,72 +419,164 @@ RC DiskBufferPool::get_this_page(PageNum page_num, Frame **frame)
   }
 
   *frame = allocated_frame;
+
+  check_read_ahead(page_num);
   return RC::SUCCESS;
 }
 
+RC DiskBufferPool::read_ahead(PageNum start_page, int page_count)
+{
+  std::scoped_lock lock_guard(lock_);
+  return read_ahead_internal(start_page, page_count);
+}
+
+void DiskBufferPool::check_read_ahead(PageNum page_num)
+{
+  const bool sequential = (last_miss_page_ != BP_INVALID_PAGE_NUM && page_num == last_miss_page_ + 1) ||
+                          page_num == read_ahead_end_;
+  last_miss_page_ = page_num;
+  if (!sequential) {
+    return;
+  }
+
+  // 根据上次预读的页面有多少被访问到了，调整预读窗口
+  if (read_ahead_pages_ > 0) {
+    const int hits = read_ahead_hits_.exchange(0);
+    if (hits * 4 >= read_ahead_pages_ * 3) {
+      read_ahead_window_ = std::min(read_ahead_window_ * 2, READ_AHEAD_MAX_PAGES);
+    } else if (hits * 2 < read_ahead_pages_) {
+      read_ahead_window_ = std::max(read_ahead_window_ / 2, READ_AHEAD_MIN_PAGES);
+    }
+    read_ahead_pages_ = 0;
+  }
+
+  RC rc = read_ahead_internal(page_num + 1, read_ahead_window_);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to read ahead. file=%s, page_num=%d, rc=%s", file_name_.c_str(), page_num + 1, strrc(rc));
+  }
+}
+
+RC DiskBufferPool::read_ahead_internal(PageNum start_page, int page_count)
+{
+  const int     max_pages = std::max(static_cast<int>(frame_manager_->total_frame_num() / 4), 1);
+  const PageNum end_page  = std::min(start_page + std::min(page_count, max_pages), file_header_->page_count);
+
+  read_ahead_end_ = end_page;
+
+  // 找到已经分配但是不在内存中的页面，一起读取
+  std::vector<Frame *> frames;
+  for (PageNum page_num = start_page; page_num < end_page; page_num++) {
+    if (!is_allocated(page_num)) {
+      continue;
+    }
+
+    Frame *frame = frame_manager_->get(file_desc_, page_num);
+    if (frame != nullptr) {
+      frame->unpin();
+      continue;
+    }
+
+    frame = try_allocate_frame(page_num);
+    if (nullptr == frame) {
+      LOG_TRACE("no free frame to read ahead. file=%s, page_num=%d", file_name_.c_str(), page_num);
+      break;
+    }
+
+    // 在数据读出来之前，其它线程拿到这个页帧也不能访问
+    frame->write_latch();
+    frame->set_file_desc(file_desc_);
+    frame->access();
+    frames.push_back(frame);
+  }
+
+  if (frames.empty()) {
+    return RC::SUCCESS;
+  }
+
+  RC rc = load_pages(frames.data(), static_cast<int>(frames.size()));
+  for (Frame *frame : frames) {
+    frame->write_unlatch();
+    if (OB_SUCC(rc)) {
+      frame->set_prefetched();
+      frame->unpin();
+    } else {
+      purge_frame(frame->page_num(), frame);
+    }
+  }
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to read ahead pages. file=%s, pages=[%d,%d), rc=%s",
+             file_name_.c_str(), start_page, end_page, strrc(rc));
+    return rc;
+  }
+
+  read_ahead_pages_ += static_cast<int>(frames.size());
+  LOG_TRACE("read ahead pages. file=%s, pages=[%d,%d), read=%d",
+            file_name_.c_str(), start_page, end_page, static_cast<int>(frames.size()));
+  return rc;
+}
+
 RC DiskBufferPool::allocate_page(Frame **frame)
 {
+  std::scoped_lock lock_guard(lock_);
+
+  // 前面的组都没有空闲页面，从 first_free_group_ 开始找
+  const int group_count = static_cast<int>(group_frames_.size());
+  int       group       = first_free_group_;
+  while (group < group_count && group_free_pages_[group] == 0) {
+    group++;
+  }
+  first_free_group_ = group;
+
   RC rc = RC::SUCCESS;
+  if (group == group_count) {
+    if (file_header_->page_count >= BPFileHeader::MAX_PAGE_NUM) {
+      LOG_WARN("file buffer pool is full. page count %d, max page count %d",
+          file_header_->page_count, BPFileHeader::MAX_PAGE_NUM);
+      return RC::BUFFERPOOL_NOBUF;
+    }
 
-  lock_.lock();
-  
-  int byte = 0, bit = 0;
-  if ((file_header_->allocated_pages) < (file_header_->page_count)) {
-    // There is one free page
-    for (int i = 0; i < file_header_->page_count; i++) {
-      byte = i / 8;
-      bit = i % 8;
-      if (((file_header_->bitmap[byte]) & (1 << bit)) == 0) {
-        (file_header_->allocated_pages)++;
-        file_header_->bitmap[byte] |= (1 << bit);
-        // TODO,  do we need clean the loaded page's data?
-        hdr_frame_->mark_dirty();
-
-        lock_.unlock();
-        return get_this_page(i, frame);
-      }
+    const int extent_pages = std::clamp(file_header_->page_count / 8, EXTENT_MIN_PAGES, EXTENT_MAX_PAGES);
+    rc = extend_file(std::min(file_header_->page_count + extent_pages, BPFileHeader::MAX_PAGE_NUM));
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to extend file. file=%s, rc=%s", file_name_.c_str(), strrc(rc));
+      return rc;
     }
+
+    group             = static_cast<int>(group_frames_.size()) - 1;
+    first_free_group_ = group;
   }
 
-  if (file_header_->page_count >= BPFileHeader::MAX_PAGE_NUM) {
-    LOG_WARN("file buffer pool is full. page count %d, max page count %d",
-        file_header_->page_count, BPFileHeader::MAX_PAGE_NUM);
-    lock_.unlock();
-    return RC::BUFFERPOOL_NOBUF;
+  Bitmap bitmap(group_bitmap(group), group_page_count(group));
+  int    index = bitmap.next_unsetted_bit(group_free_hint_[group]);
+  if (index < 0) {
+    index = bitmap.next_unsetted_bit(0);
   }
+  ASSERT(index >= 0, "cannot find free page in group. file=%s, group=%d, free pages=%d",
+         file_name_.c_str(), group, group_free_pages_[group]);
 
-  PageNum page_num = file_header_->page_count;
+  const PageNum page_num = group_start(group) + index;
   Frame *allocated_frame = nullptr;
   if ((rc = allocate_frame(page_num, &allocated_frame)) != RC::SUCCESS) {
     LOG_ERROR("Failed to allocate frame %s, due to no free page.", file_name_.c_str());
-    lock_.unlock();
     return rc;
   }
 
-  LOG_INFO("allocate new page. file=%s, pageNum=%d, pin=%d",
-           file_name_.c_str(), page_num, allocated_frame->pin_count());
-
+  bitmap.set_bit(index);
+  group_free_pages_[group]--;
+  group_free_hint_[group] = index + 1;
   file_header_->allocated_pages++;
-  file_header_->page_count++;
-
-  byte = page_num / 8;
-  bit = page_num % 8;
-  file_header_->bitmap[byte] |= (1 << bit);
+  group_frames_[group]->mark_dirty();
   hdr_frame_->mark_dirty();
 
+  LOG_TRACE("allocate page. file=%s, pageNum=%d, pin=%d",
+           file_name_.c_str(), page_num, allocated_frame->pin_count());
+
+  // 扩展文件时已经预留了磁盘空间，新分配的页面不需要马上写入磁盘
   allocated_frame->set_file_desc(file_desc_);
   allocated_frame->access();
   allocated_frame->clear_page();
-  allocated_frame->set_page_num(file_header_->page_count - 1);
-
-  // Use flush operation to extension file
-  if ((rc = flush_page_internal(*allocated_frame)) != RC::SUCCESS) {
-    LOG_WARN("Failed to alloc page %s , due to failed to extend one page.", file_name_.c_str());
-    // skip return false, delay flush the extended page
-    // return tmp;
-  }
-
-  lock_.unlock();
+  allocated_frame->set_page_num(page_num);
+  allocated_frame->mark_dirty();
 
   *frame = allocated_frame;
   return RC::SUCCESS;
@@ -415,19 +585,25 @@ RC DiskBufferPool::allocate_page(Frame **frame)
 RC DiskBufferPool::dispose_page(PageNum page_num)
 {
   std::scoped_lock lock_guard(lock_);
-  Frame *used_frame = frame_manager_.get(file_desc_, page_num);
+  Frame *used_frame = frame_manager_->get(file_desc_, page_num);
   if (used_frame != nullptr) {
     ASSERT("the page try to dispose is in use. frame:%s", to_string(*used_frame).c_str());
-    frame_manager_.free(file_desc_, page_num, used_frame);
+    frame_manager_->free(file_desc_, page_num, used_frame);
   } else {
     LOG_WARN("failed to fetch the page while disposing it. pageNum=%d", page_num);
     return RC::NOTFOUND;
   }
 
-  hdr_frame_->mark_dirty();
+  const int group = group_of(page_num);
+  const int index = page_num - group_start(group);
+  Bitmap(group_bitmap(group), group_page_count(group)).clear_bit(index);
+  group_free_pages_[group]++;
+  group_free_hint_[group] = std::min(group_free_hint_[group], index);
+  first_free_group_       = std::min(first_free_group_, group);
+
   file_header_->allocated_pages--;
-  char tmp = 1 << (page_num % 8);
-  file_header_->bitmap[page_num / 8] &= ~tmp;
+  group_frames_[group]->mark_dirty();
+  hdr_frame_->mark_dirty();
   return RC::SUCCESS;
 }
 
@@ -454,14 +630,14 @@ RC DiskBufferPool::purge_frame(PageNum page_num, Frame *buf)
   }
 
   LOG_DEBUG("Successfully purge frame =%p, page %d of %d(file desc)", buf, buf->page_num(), buf->file_desc());
-  frame_manager_.free(file_desc_, page_num, buf);
+  frame_manager_->free(file_desc_, page_num, buf);
   return RC::SUCCESS;
 }
 
 RC DiskBufferPool::purge_page(PageNum page_num)
 {
   std::scoped_lock lock_guard(lock_);
-  Frame *used_frame = frame_manager_.get(file_desc_, page_num);
+  Frame *used_frame = frame_manager_->get(file_desc_, page_num);
   if (used_frame != nullptr) {
     return purge_frame(page_num, used_frame);
   }
@@ -471,7 +647,7 @@ RC DiskBufferPool::purge_page(PageNum page_num)
 
 RC DiskBufferPool::purge_all_pages()
 {
-  std::list<Frame *> used = frame_manager_.find_list(file_desc_);
+  std::list<Frame *> used = frame_manager_->find_list(file_desc_);
 
   std::scoped_lock lock_guard(lock_);
   for (std::list<Frame *>::iterator it = used.begin(); it != used.end(); ++it) {
@@ -484,15 +660,17 @@ RC DiskBufferPool::purge_all_pages()
 
 RC DiskBufferPool::check_all_pages_unpinned()
 {
-  std::list<Frame *> frames = frame_manager_.find_list(file_desc_);
+  std::list<Frame *> frames = frame_manager_->find_list(file_desc_);
 
   std::scoped_lock lock_guard(lock_);
   for (Frame *frame : frames) {
     frame->unpin();
-    if (frame->page_num() == BP_HEADER_PAGE && frame->pin_count() > 1) {
+    // 文件头和位图页一直是pin住的
+    const bool bitmap_page = frame->page_num() == group_start(group_of(frame->page_num()));
+    if (bitmap_page && frame->pin_count() > 1) {
       LOG_WARN("This page has been pinned. file desc=%d, pageNum:%d, pin count=%d",
           file_desc_, frame->page_num(), frame->pin_count());
-    } else if (frame->page_num() != BP_HEADER_PAGE && frame->pin_count() > 0) {
+    } else if (!bitmap_page && frame->pin_count() > 0) {
       LOG_WARN("This page has been pinned. file desc=%d, pageNum:%d, pin count=%d",
           file_desc_, frame->page_num(), frame->pin_count());
     }
@@ -513,15 +691,15 @@ RC DiskBufferPool::flush_page_internal(Frame &frame)
   // so it is easier to flush data to file.
 
   Page &page = frame.page();
-  int64_t offset = ((int64_t)page.page_num) * sizeof(Page);
-  if (lseek(file_desc_, offset, SEEK_SET) == offset - 1) {
-    LOG_ERROR("Failed to flush page %lld of %d due to failed to seek %s.", offset, file_desc_, strerror(errno));
-    return RC::IOERR_SEEK;
-  }
-
-  if (writen(file_desc_, &page, sizeof(Page)) != 0) {
-    LOG_ERROR("Failed to flush page %lld of %d due to %s.", offset, file_desc_, strerror(errno));
-    return RC::IOERR_WRITE;
+  IoRequest request;
+  request.fd     = file_desc_;
+  request.buf    = &page;
+  request.len    = page_size_;
+  request.offset = ((int64_t)page.page_num) * page_size_;
+  RC rc = IoBackend::instance().write(&request, 1);
+  if (rc != RC::SUCCESS) {
+    LOG_ERROR("Failed to flush page %lld of %d. rc=%s", request.offset, file_desc_, strrc(rc));
+    return rc;
   }
   frame.clear_dirty();
   LOG_DEBUG("Flush block. file desc=%d, pageNum=%d, pin count=%d", file_desc_, page.page_num, frame.pin_count());
@@ -531,34 +709,216 @@ RC DiskBufferPool::flush_page_internal(Frame &frame)
 
 RC DiskBufferPool::flush_all_pages()
 {
-  std::list<Frame *> used = frame_manager_.find_list(file_desc_);
+  std::list<Frame *> used = frame_manager_->find_list(file_desc_);
+
+  // 所有的脏页一起提交写入
+  std::vector<Frame *>   dirty_frames;
+  std::vector<IoRequest> requests;
   for (Frame *frame : used) {
-    RC rc = flush_page(*frame);
-    if (rc != RC::SUCCESS) {
-      LOG_WARN("failed to flush all pages");
-      return rc;
+    if (!frame->dirty()) {
+      continue;
     }
+
+    IoRequest request;
+    request.fd     = file_desc_;
+    request.buf    = &frame->page();
+    request.len    = page_size_;
+    request.offset = ((int64_t)frame->page_num()) * page_size_;
+    dirty_frames.push_back(frame);
+    requests.push_back(request);
   }
-  return RC::SUCCESS;
+
+  RC rc = RC::SUCCESS;
+  if (!requests.empty()) {
+    std::scoped_lock lock_guard(lock_);
+    rc = IoBackend::instance().write(requests.data(), static_cast<int>(requests.size()));
+    if (OB_SUCC(rc)) {
+      for (Frame *frame : dirty_frames) {
+        frame->clear_dirty();
+      }
+    } else {
+      LOG_WARN("failed to flush all pages. file=%s, dirty pages=%d, rc=%s",
+               file_name_.c_str(), static_cast<int>(requests.size()), strrc(rc));
+    }
+  }
+
+  for (Frame *frame : used) {
+    frame->unpin();
+  }
+  return rc;
 }
 
 RC DiskBufferPool::recover_page(PageNum page_num)
 {
-  int byte = 0, bit = 0;
-  byte = page_num / 8;
-  bit = page_num % 8;
-
   std::scoped_lock lock_guard(lock_);
-  if (!(file_header_->bitmap[byte] & (1 << bit))) {
-    file_header_->bitmap[byte] |= (1 << bit);
+  RC rc = RC::SUCCESS;
+  if (page_num >= file_header_->page_count && OB_FAIL(rc = extend_file(page_num + 1))) {
+    LOG_WARN("failed to extend file while recovering page. file=%s, page_num=%d, rc=%s",
+             file_name_.c_str(), page_num, strrc(rc));
+    return rc;
+  }
+
+  const int group = group_of(page_num);
+  const int index = page_num - group_start(group);
+  Bitmap bitmap(group_bitmap(group), group_page_count(group));
+  if (!bitmap.get_bit(index)) {
+    bitmap.set_bit(index);
+    group_free_pages_[group]--;
     file_header_->allocated_pages++;
-    file_header_->page_count++;
+    group_frames_[group]->mark_dirty();
     hdr_frame_->mark_dirty();
   }
   return RC::SUCCESS;
 }
 
+RC DiskBufferPool::load_groups()
+{
+  group_frames_.push_back(hdr_frame_);
+  hdr_frame_->pin();  // 和其它位图页一样，关闭文件时unpin
+
+  const int group_count = group_of(file_header_->page_count - 1) + 1;
+  for (int group = 1; group < group_count; group++) {
+    Frame *frame = nullptr;
+    RC rc = get_this_page(group_start(group), &frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to load bitmap page. file=%s, group=%d, rc=%s", file_name_.c_str(), group, strrc(rc));
+      return rc;
+    }
+    group_frames_.push_back(frame);
+  }
+
+  group_free_pages_.assign(group_count, 0);
+  group_free_hint_.assign(group_count, 0);
+  for (int group = 0; group < group_count; group++) {
+    Bitmap bitmap(group_bitmap(group), group_page_count(group));
+    // 位图页自己总是分配的。扩展文件后没有写入位图页就崩溃的话，读出来的是全0
+    if (!bitmap.get_bit(0)) {
+      bitmap.set_bit(0);
+      group_frames_[group]->mark_dirty();
+    }
+    for (int index = bitmap.next_unsetted_bit(0); index >= 0; index = bitmap.next_unsetted_bit(index + 1)) {
+      group_free_pages_[group]++;
+    }
+  }
+  first_free_group_ = 0;
+  return RC::SUCCESS;
+}
+
+RC DiskBufferPool::extend_file(PageNum page_count)
+{
+  RC rc = RC::SUCCESS;
+  const PageNum old_page_count = file_header_->page_count;
+  while (file_header_->page_count < page_count) {
+    const PageNum page_num = file_header_->page_count;
+    int           group    = group_of(page_num);
+    if (group == static_cast<int>(group_frames_.size())) {
+      // 新的组，第一个页面是位图页
+      Frame *frame = nullptr;
+      if (OB_FAIL(rc = allocate_frame(page_num, &frame))) {
+        LOG_WARN("failed to allocate frame for bitmap page. file=%s, page_num=%d", file_name_.c_str(), page_num);
+        break;
+      }
+      frame->set_file_desc(file_desc_);
+      frame->access();
+      frame->clear_page();
+      frame->set_page_num(page_num);
+      Bitmap(frame->data(), 1).set_bit(0);
+      frame->mark_dirty();
+
+      {
+        std::scoped_lock groups_guard(groups_lock_);
+        group_frames_.push_back(frame);
+      }
+      group_free_pages_.push_back(0);
+      group_free_hint_.push_back(1);
+      file_header_->allocated_pages++;
+      file_header_->page_count++;
+    }
+
+    const PageNum end = std::min(page_count, group_start(group) + group_capacity(group));
+    group_free_pages_[group] += end - file_header_->page_count;
+    file_header_->page_count = end;
+  }
+
+  if (file_header_->page_count != old_page_count) {
+    hdr_frame_->mark_dirty();
+
+    // 一次给整个区预留磁盘空间，页面在磁盘上是连续的，读取还没有写过的页面也不会读到文件尾
+    const off_t offset = static_cast<off_t>(old_page_count) * page_size_;
+    const off_t length = static_cast<off_t>(file_header_->page_count - old_page_count) * page_size_;
+    if (fallocate(file_desc_, 0, offset, length) != 0 && ftruncate(file_desc_, offset + length) != 0) {
+      LOG_WARN("failed to extend file. file=%s, page count=%d, error=%s",
+               file_name_.c_str(), file_header_->page_count, strerror(errno));
+      rc = RC::IOERR_WRITE;
+    }
+    LOG_INFO("extend file. file=%s, page count=%d -> %d", file_name_.c_str(), old_page_count, file_header_->page_count);
+  }
+  return rc;
+}
+
+PageNum DiskBufferPool::next_allocated_page(PageNum start_page)
+{
+  std::shared_lock<common::SharedMutex> groups_guard(groups_lock_);
+  const int group_count = static_cast<int>(group_frames_.size());
+  for (int group = group_of(start_page); group < group_count; group++) {
+    // 跳过位图页
+    const int start = std::max(start_page - group_start(group), group == 0 ? 0 : 1);
+    const int index = Bitmap(group_bitmap(group), group_page_count(group)).next_setted_bit(start);
+    if (index >= 0) {
+      return group_start(group) + index;
+    }
+  }
+  return BP_INVALID_PAGE_NUM;
+}
+
+bool DiskBufferPool::is_allocated(PageNum page_num)
+{
+  if (page_num < 0 || page_num >= file_header_->page_count) {
+    return false;
+  }
+  const int group = group_of(page_num);
+  return Bitmap(group_bitmap(group), group_page_count(group)).get_bit(page_num - group_start(group));
+}
+
+int DiskBufferPool::group_page_count(int group) const
+{
+  return std::min(group_capacity(group), file_header_->page_count - group_start(group));
+}
+
+int DiskBufferPool::group_of(PageNum page_num)
+{
+  if (page_num < BPFileHeader::HEADER_GROUP_PAGES) {
+    return 0;
+  }
+  return 1 + (page_num - BPFileHeader::HEADER_GROUP_PAGES) / BPFileHeader::GROUP_PAGES;
+}
+
+PageNum DiskBufferPool::group_start(int group)
+{
+  if (group == 0) {
+    return 0;
+  }
+  return BPFileHeader::HEADER_GROUP_PAGES + (group - 1) * BPFileHeader::GROUP_PAGES;
+}
+
+int DiskBufferPool::group_capacity(int group)
+{
+  return group == 0 ? BPFileHeader::HEADER_GROUP_PAGES : BPFileHeader::GROUP_PAGES;
+}
+
 RC DiskBufferPool::allocate_frame(PageNum page_num, Frame **buffer)
+{
+  while (true) {
+    Frame *frame = try_allocate_frame(page_num);
+    if (frame != nullptr) {
+      *buffer = frame;
+      return RC::SUCCESS;
+    }
+  }
+  return RC::BUFFERPOOL_NOBUF;
+}
+
+Frame *DiskBufferPool::try_allocate_frame(PageNum page_num)
 {
   auto purger = [this](Frame *frame) {
     if (!frame->dirty()) {
@@ -578,17 +938,14 @@ RC DiskBufferPool::allocate_frame(PageNum page_num, Frame **buffer)
     return rc;
   };
 
-  while (true) {
-    Frame *frame = frame_manager_.alloc(file_desc_, page_num);
-    if (frame != nullptr) {
-      *buffer = frame;
-      return RC::SUCCESS;
-    }
-
-    LOG_TRACE("frames are all allocated, so we should purge some frames to get one free frame");
-    (void)frame_manager_.purge_frames(1/*count*/, purger);
+  Frame *frame = frame_manager_->alloc(file_desc_, page_num);
+  if (frame != nullptr) {
+    return frame;
   }
-  return RC::BUFFERPOOL_NOBUF;
+
+  LOG_TRACE("frames are all allocated, so we should purge some frames to get one free frame");
+  (void)frame_manager_->purge_frames(1/*count*/, purger);
+  return frame_manager_->alloc(file_desc_, page_num);
 }
 
 RC DiskBufferPool::check_page_num(PageNum page_num)
@@ -597,7 +954,7 @@ RC DiskBufferPool::check_page_num(PageNum page_num)
     LOG_ERROR("Invalid pageNum:%d, file's name:%s", page_num, file_name_.c_str());
     return RC::BUFFERPOOL_INVALID_PAGE_NUM;
   }
-  if ((file_header_->bitmap[page_num / 8] & (1 << (page_num % 8))) == 0) {
+  if (!is_allocated(page_num)) {
     LOG_ERROR("Invalid pageNum:%d, file's name:%s", page_num, file_name_.c_str());
     return RC::BUFFERPOOL_INVALID_PAGE_NUM;
   }
@@ -606,21 +963,25 @@ RC DiskBufferPool::check_page_num(PageNum page_num)
 
 RC DiskBufferPool::load_page(PageNum page_num, Frame *frame)
 {
-  int64_t offset = ((int64_t)page_num) * BP_PAGE_SIZE;
-  if (lseek(file_desc_, offset, SEEK_SET) == -1) {
-    LOG_ERROR("Failed to load page %s:%d, due to failed to lseek:%s.", file_name_.c_str(), page_num, strerror(errno));
+  return load_pages(&frame, 1);
+}
 
-    return RC::IOERR_SEEK;
+RC DiskBufferPool::load_pages(Frame **frames, int page_count)
+{
+  std::vector<IoRequest> requests(page_count);
+  for (int i = 0; i < page_count; i++) {
+    requests[i].fd     = file_desc_;
+    requests[i].buf    = &frames[i]->page();
+    requests[i].len    = page_size_;
+    requests[i].offset = ((int64_t)frames[i]->page_num()) * page_size_;
   }
 
-  Page &page = frame->page();
-  int ret = readn(file_desc_, &page, BP_PAGE_SIZE);
-  if (ret != 0) {
-    LOG_ERROR("Failed to load page %s, file_desc:%d, page num:%d, due to failed to read data:%s, ret=%d, page count=%d",
-              file_name_.c_str(), file_desc_, page_num, strerror(errno), ret, file_header_->allocated_pages);
-    return RC::IOERR_READ;
+  RC rc = IoBackend::instance().read(requests.data(), page_count);
+  if (rc != RC::SUCCESS) {
+    LOG_ERROR("Failed to load pages %s, file_desc:%d, first page:%d, page count:%d, rc=%s, allocated pages=%d",
+              file_name_.c_str(), file_desc_, frames[0]->page_num(), page_count, strrc(rc), file_header_->allocated_pages);
   }
-  return RC::SUCCESS;
+  return rc;
 }
 
 int DiskBufferPool::file_desc() const
@@ -628,15 +989,20 @@ int DiskBufferPool::file_desc() const
   return file_desc_;
 }
 ////////////////////////////////////////////////////////////////////////////////
-BufferPoolManager::BufferPoolManager(int memory_size /* = 0 */)
+BufferPoolManager::BufferPoolManager(int64_t memory_size /* = 0 */, bool lock_memory /* = false */)
 {
   if (memory_size <= 0) {
-    memory_size = MEM_POOL_ITEM_NUM * DEFAULT_ITEM_NUM_PER_POOL * BP_PAGE_SIZE;
+    memory_size = DEFAULT_FRAME_NUM * BP_PAGE_SIZE;
   }
-  const int pool_num = std::max(memory_size / BP_PAGE_SIZE / DEFAULT_ITEM_NUM_PER_POOL, 1);
-  frame_manager_.init(pool_num);
-  LOG_INFO("buffer pool manager init with memory size %d, page num: %d, pool num: %d",
-           memory_size, pool_num * DEFAULT_ITEM_NUM_PER_POOL, pool_num);
+  memory_size_ = memory_size;
+  lock_memory_ = lock_memory;
+
+  BPFrameManager *frame_manager = nullptr;
+  RC rc = this->frame_manager(BP_PAGE_SIZE, frame_manager);
+  if (OB_FAIL(rc)) {
+    return;
+  }
+  LOG_INFO("buffer pool manager init with memory size %ld, frame num: %lu", memory_size, frame_manager->total_frame_num());
 }
 
 BufferPoolManager::~BufferPoolManager()
@@ -649,8 +1015,42 @@ BufferPoolManager::~BufferPoolManager()
   }
 }
 
-RC BufferPoolManager::create_file(const char *file_name)
+RC BufferPoolManager::frame_manager(int page_size, BPFrameManager *&frame_manager)
+{
+  if (!bp_valid_page_size(page_size)) {
+    LOG_WARN("invalid page size. page_size=%d", page_size);
+    return RC::INVALID_ARGUMENT;
+  }
+
+  std::lock_guard<std::mutex> guard(frame_managers_lock_);
+  auto iter = frame_managers_.find(page_size);
+  if (iter != frame_managers_.end()) {
+    frame_manager = iter->second.get();
+    return RC::SUCCESS;
+  }
+
+  const int frame_num = static_cast<int>(std::clamp<int64_t>(memory_size_ / page_size, MIN_FRAME_NUM, INT32_MAX));
+  auto new_frame_manager = std::make_unique<BPFrameManager>("BufPool");
+  RC rc = new_frame_manager->init(frame_num, lock_memory_, page_size);
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("failed to init frame manager. memory size=%ld, page size=%d, frame num=%d, rc=%s",
+              memory_size_, page_size, frame_num, strrc(rc));
+    return rc;
+  }
+  LOG_INFO("frame manager created. page size=%d, frame num=%d", page_size, frame_num);
+
+  frame_manager = new_frame_manager.get();
+  frame_managers_.emplace(page_size, std::move(new_frame_manager));
+  return RC::SUCCESS;
+}
+
+RC BufferPoolManager::create_file(const char *file_name, int page_size /* = BP_PAGE_SIZE */)
 {
+  if (!bp_valid_page_size(page_size)) {
+    LOG_WARN("invalid page size. file=%s, page_size=%d", file_name, page_size);
+    return RC::INVALID_ARGUMENT;
+  }
+
   int fd = open(file_name, O_RDWR | O_CREAT | O_EXCL, S_IREAD | S_IWRITE);
   if (fd < 0) {
     LOG_ERROR("Failed to create %s, due to %s.", file_name, strerror(errno));
@@ -668,12 +1068,15 @@ RC BufferPoolManager::create_file(const char *file_name)
     return RC::IOERR_ACCESS;
   }
 
-  Page page;
-  memset(&page, 0, BP_PAGE_SIZE);
+  std::vector<char> page_data(page_size, 0);
+  Page &page = *reinterpret_cast<Page *>(page_data.data());
 
   BPFileHeader *file_header = (BPFileHeader *)page.data;
   file_header->allocated_pages = 1;
   file_header->page_count = 1;
+  file_header->magic = BPFileHeader::MAGIC;
+  file_header->version = BPFileHeader::VERSION;
+  file_header->page_size = page_size;
 
   char *bitmap = file_header->bitmap;
   bitmap[0] |= 0x01;
@@ -683,7 +1086,7 @@ RC BufferPoolManager::create_file(const char *file_name)
     return RC::IOERR_SEEK;
   }
 
-  if (writen(fd, (char *)&page, BP_PAGE_SIZE) != 0) {
+  if (writen(fd, page_data.data(), page_size) != 0) {
     LOG_ERROR("Failed to write header to file %s, due to %s.", file_name, strerror(errno));
     close(fd);
     return RC::IOERR_WRITE;
@@ -704,7 +1107,7 @@ RC BufferPoolManager::open_file(const char *_file_name, DiskBufferPool *&_bp)
     return RC::BUFFERPOOL_OPEN;
   }
 
-  DiskBufferPool *bp = new DiskBufferPool(*this, frame_manager_);
+  DiskBufferPool *bp = new DiskBufferPool(*this);
   RC rc = bp->open_file(_file_name);
   if (rc != RC::SUCCESS) {
     LOG_WARN("failed to open file name");
@@ -23,7 +23,10 @@ See the Mulan PSL v2 for more details. */
 #include <string>
 #include <mutex>
 #include <unordered_map>
+#include <vector>
 #include <functional>
+#include <atomic>
+#include <memory>
 
 #include "common/rc.h"
 #include "common/types.h"
@@ -33,6 +36,7 @@ See the Mulan PSL v2 for more details. */
 #include "common/lang/bitmap.h"
 #include "storage/buffer/page.h"
 #include "storage/buffer/frame.h"
+#include "storage/buffer/frame_arena.h"
 
 class BufferPoolManager;
 class DiskBufferPool;
@@ -47,24 +51,37 @@ class DiskBufferPool;
 /**
  * @brief BufferPool的文件第一个页面，存放一些元数据信息，包括了后面每页的分配信息。
  * @ingroup BufferPool
- * @details
+ * @details 参考 Linux ext(n) 的块组，文件中的页面分成多个组(group)，每个组有自己的分配位图：
  * @code
- * TODO 1. 当前的做法，只能分配比较少的页面，你可以扩展一下，支持更多的页面或无限多的页面吗？
- *         可以参考Linux ext(n)和Windows NTFS等文件系统
- *      2. 当前使用bitmap存放页面分配情况，但是这种方法在页面非常多的时候，查找空闲页面的
- *         效率非常低，你有办法优化吗？
+ * | header(group 0 的位图) | group 0 的页面 ... | group 1 的位图页 | group 1 的页面 ... | group 2 的位图页 | ...
  * @endcode
+ * 第0个组的位图在文件头页面中，有 HEADER_GROUP_PAGES 个页面；之后每个组的第一个页面是这个组的位图页，
+ * 一个组有 GROUP_PAGES 个页面。文件按照区(extent)扩展，每次扩展一批连续的页面，文件越大一次扩展得越多。
+ * page_count 是已经扩展出来的页面个数，其中没有分配的页面是空闲页面。
+ * 页面大小在创建文件时确定，保存在 page_size 中。无论页面多大，位图都只使用页面的前 BP_PAGE_DATA_SIZE
+ * 个字节，所以每个组的页面个数是固定的。
+ * 文件头的布局或者页面的分配方式变化时要修改 VERSION，打开版本不同的文件会返回 FILE_VERSION_MISMATCH。
  */
 struct BPFileHeader 
 {
-  int32_t page_count;       //! 当前文件一共有多少个页面
-  int32_t allocated_pages;  //! 已经分配了多少个页面
-  char bitmap[0];           //! 页面分配位图, 第0个页面(就是当前页面)，总是1
-
-  /**
-   * 能够分配的最大的页面个数，即bitmap的字节数 乘以8
-   */
-  static const int MAX_PAGE_NUM = (BP_PAGE_DATA_SIZE - sizeof(page_count) - sizeof(allocated_pages)) * 8;
+  int32_t page_count;       //! 当前文件一共有多少个页面，包括还没有分配的页面
+  int32_t allocated_pages;  //! 已经分配了多少个页面，包括文件头和位图页
+  int32_t magic;            //! 固定为 MAGIC，用来识别文件
+  int32_t version;          //! 创建文件时的文件格式版本
+  int32_t page_size;        //! 页面大小，参考 bp_valid_page_size
+  char bitmap[0];           //! 第0个组的页面分配位图, 第0个页面(就是当前页面)，总是1
+
+  static constexpr int32_t MAGIC   = 0x4D425046;  // "FPBM"
+  static constexpr int32_t VERSION = 2;
+
+  /// 第0个组的页面个数，即文件头中bitmap的字节数乘以8
+  static constexpr int HEADER_GROUP_PAGES = (BP_PAGE_DATA_SIZE - 5 * sizeof(int32_t)) * 8;
+  /// 其它组的页面个数，包括位图页自己
+  static constexpr int GROUP_PAGES = BP_PAGE_DATA_SIZE * 8;
+  /// 页面号是 int32_t，最多能有这么多个组
+  static constexpr int MAX_GROUP_NUM = 32768;
+  /// 能够分配的最大的页面个数
+  static constexpr int MAX_PAGE_NUM = HEADER_GROUP_PAGES + (MAX_GROUP_NUM - 1) * GROUP_PAGES;
 
   std::string to_string() const;
 };
@@ -76,13 +93,19 @@ struct BPFileHeader
  * 当内存中的页帧不够用时，需要从内存中淘汰一些页帧，以便为新的页帧腾出空间。
  * 这个管理器负责为所有的BufferPool提供页帧管理服务，也就是所有的BufferPool磁盘文件
  * 在访问时都使用这个管理器映射到内存。
+ * 页帧的个数在初始化时确定，全部从 FrameArena 中分配。一个管理器中的页面大小都是一样的。
  */
 class BPFrameManager 
 {
 public:
   BPFrameManager(const char *tag);
 
-  RC init(int pool_num);
+  /**
+   * @param frame_num   页帧个数
+   * @param lock_memory 是否将页帧的内存锁住(mlock)
+   * @param page_size   页面大小
+   */
+  RC init(int frame_num, bool lock_memory = false, int page_size = BP_PAGE_SIZE);
   RC cleanup();
 
   /**
@@ -132,13 +155,20 @@ public:
   }
 
   /**
-   * 测试使用。返回已经从内存申请的个数
+   * 页帧的总个数
    */
   size_t total_frame_num() const
   {
-    return allocator_.get_size();
+    return arena_.frame_num();
   }
 
+  int page_size() const { return arena_.page_size(); }
+
+  /**
+   * @brief 根据页面数据中的地址找到页帧，不需要加锁，参考 FrameArena::frame_of
+   */
+  Frame *frame_of(const void *address) { return arena_.frame_of(address); }
+
 private:
   Frame *get_internal(const FrameId &frame_id);
   RC     free_internal(const FrameId &frame_id, Frame *frame);
@@ -153,11 +183,10 @@ private:
   };
 
   using FrameLruCache = common::LruCache<FrameId, Frame *, BPFrameIdHasher>;
-  using FrameAllocator = common::MemPoolSimple<Frame>;
 
   std::mutex lock_;
   FrameLruCache  frames_;
-  FrameAllocator allocator_;
+  FrameArena     arena_;
 };
 
 /**
@@ -176,18 +205,26 @@ public:
   RC reset();
 
 private:
-  common::Bitmap bitmap_;
+  DiskBufferPool *buffer_pool_ = nullptr;
   PageNum current_page_num_ = -1;
 };
 
 /**
  * @brief BufferPool的实现
  * @ingroup BufferPool
+ * @details 顺序访问时会预读(read ahead)。如果连续两次缺页的页面号是相邻的，或者缺页的页面正好是
+ * 上次预读的下一个页面，就认为是在顺序访问，一次从磁盘读取后面 read_ahead_window_ 个页面，放到空闲
+ * 的页帧中。预读的窗口大小根据命中率调整：预读的页面大部分都被访问了就扩大窗口，否则缩小。
+ * 扫描器也可以通过 read_ahead 明确告诉 buffer pool 接下来要访问哪些页面，比如并行扫描时，多个线程
+ * 交替访问不同的页面，就不容易识别出顺序访问。
+ *
+ * 页面的分配情况记录在文件头和每个组的位图页中(参考 BPFileHeader)，位图页在文件打开期间一直
+ * 驻留内存。内存中记录每个组的空闲页面个数和下一次查找的位置，分配页面时不需要从头扫描位图。
  */
 class DiskBufferPool 
 {
 public:
-  DiskBufferPool(BufferPoolManager &bp_manager, BPFrameManager &frame_manager);
+  DiskBufferPool(BufferPoolManager &bp_manager);
   ~DiskBufferPool();
 
   /**
@@ -197,6 +234,7 @@ public:
 
   /**
    * 根据文件名打开一个分页文件
+   * @details 根据文件头中的页面大小，使用对应页面大小的页帧(参考 BufferPoolManager::frame_manager)
    */
   RC open_file(const char *file_name);
 
@@ -213,6 +251,25 @@ public:
    */
   RC get_this_page(PageNum page_num, Frame **frame);
 
+  /**
+   * @brief 获取已经在内存中的页面，不会从磁盘加载
+   * @details 用来读取页帧上的提示信息，比如 Frame::all_visible，不计入命中统计
+   * @return 页面在内存中时返回pin住的页帧，否则返回nullptr
+   */
+  Frame *get_cached_page(PageNum page_num);
+
+  /**
+   * @brief 预读从 start_page 开始的 page_count 个页面
+   * @details 已经在内存中或者没有分配的页面会跳过，连续的页面一次读取。
+   * 预读的页面不会被pin住，空闲页帧不够时会停止预读。
+   */
+  RC read_ahead(PageNum start_page, int page_count);
+
+  /**
+   * @brief 当前顺序访问时预读的页面个数
+   */
+  int read_ahead_window() const { return read_ahead_window_; }
+
   /**
    * 在指定文件中分配一个新的页面，并将其放入缓冲区，返回页面句柄指针。
    * 分配页面时，如果文件中有空闲页，就直接分配一个空闲页；
@@ -251,13 +308,32 @@ public:
 
   int file_desc() const;
 
+  /**
+   * @brief 文件中已经分配的页面个数，包括文件头页面和位图页
+   */
+  int allocated_pages() const { return file_header_->allocated_pages; }
+
+  /**
+   * @brief 文件中的页面个数，包括已经扩展出来但是还没有分配的页面
+   */
+  int page_count() const { return file_header_->page_count; }
+
+  /**
+   * @brief 页面大小，创建文件时确定
+   */
+  int page_size() const { return page_size_; }
+  /**
+   * @brief 页面中可以存放数据的长度，即 Frame::data 的长度
+   */
+  int page_data_size() const { return bp_page_data_size(page_size_); }
+
   /**
    * 如果页面是脏的，就将数据刷新到磁盘
    */
   RC flush_page(Frame &frame);
 
   /**
-   * 刷新所有页面到磁盘，即使pin count不是0
+   * 刷新所有页面到磁盘，即使pin count不是0。所有的脏页一起提交写入
    */
   RC flush_all_pages();
 
@@ -269,6 +345,11 @@ public:
 protected:
   RC allocate_frame(PageNum page_num, Frame **buf);
 
+  /**
+   * @brief 尝试分配一个页帧，最多淘汰一次页面，分配不到就返回nullptr
+   */
+  Frame *try_allocate_frame(PageNum page_num);
+
   /**
    * 刷新指定页面到磁盘(flush)，并且释放关联的Frame
    */
@@ -280,21 +361,74 @@ protected:
    */
   RC load_page(PageNum page_num, Frame *frame);
 
+  /**
+   * @brief 一次从磁盘读取多个页面，页面号就是页帧的页面号
+   */
+  RC load_pages(Frame **frames, int page_count);
+
+  /**
+   * @brief 页面缺失时，检查是否在顺序访问，需要的话调整预读窗口并预读后面的页面
+   * @note 需要加着 lock_ 调用
+   */
+  void check_read_ahead(PageNum page_num);
+  RC   read_ahead_internal(PageNum start_page, int page_count);
+
   /**
    * 如果页面是脏的，就将数据刷新到磁盘
    */
   RC flush_page_internal(Frame &frame);
 
+  /**
+   * @brief 打开文件时加载所有位图页，统计每个组的空闲页面
+   */
+  RC load_groups();
+
+  /**
+   * @brief 扩展文件，直到有 page_count 个页面。需要的话会创建新的组
+   * @note 需要加着 lock_ 调用
+   */
+  RC extend_file(PageNum page_count);
+
+  /**
+   * @brief 从 start_page 开始(包含)，查找下一个已经分配的页面，位图页不算在内
+   * @return 没有的话返回 BP_INVALID_PAGE_NUM
+   */
+  PageNum next_allocated_page(PageNum start_page);
+
+  bool is_allocated(PageNum page_num);
+
+  /// 每个组的位图，第0个组的位图在文件头中
+  char *group_bitmap(int group) { return group == 0 ? file_header_->bitmap : group_frames_[group]->data(); }
+  /// 这个组已经扩展出来的页面个数
+  int group_page_count(int group) const;
+
+  static int     group_of(PageNum page_num);
+  static PageNum group_start(int group);
+  static int     group_capacity(int group);
+
 private:
   BufferPoolManager &  bp_manager_;
-  BPFrameManager &     frame_manager_;
+  BPFrameManager *     frame_manager_ = nullptr;  ///< 与文件的页面大小相同的页帧管理器，打开文件时确定
 
   std::string          file_name_;
   int                  file_desc_ = -1;
+  int                  page_size_ = BP_PAGE_SIZE;
   Frame *              hdr_frame_ = nullptr;
   BPFileHeader *       file_header_ = nullptr;
   std::set<PageNum>    disposed_pages_;
 
+  std::vector<Frame *> group_frames_;         ///< 每个组的位图页面，第0个是文件头
+  std::vector<int>     group_free_pages_;     ///< 每个组中空闲的页面个数
+  std::vector<int>     group_free_hint_;      ///< 每个组中从哪个位置开始找空闲页面，前面的都已经分配
+  int                  first_free_group_ = 0; ///< 前面的组都没有空闲页面了
+  common::SharedMutex  groups_lock_;          ///< 保护 group_frames_，遍历页面时会读取
+
+  PageNum              last_miss_page_    = BP_INVALID_PAGE_NUM;  ///< 上一个缺页的页面
+  PageNum              read_ahead_end_    = BP_INVALID_PAGE_NUM;  ///< 上次预读的最后一个页面的下一个页面
+  int                  read_ahead_window_;                        ///< 顺序访问时预读多少个页面
+  int                  read_ahead_pages_  = 0;                    ///< 当前窗口下预读了多少个页面
+  std::atomic<int>     read_ahead_hits_{0};                       ///< 当前窗口下预读的页面被访问了多少个
+
   common::Mutex        lock_;
 private:
   friend class BufferPoolIterator;
@@ -307,21 +441,39 @@ private:
 class BufferPoolManager 
 {
 public:
-  BufferPoolManager(int memory_size = 0);
+  /**
+   * @param memory_size 所有页帧使用的内存大小，0表示使用默认大小
+   * @param lock_memory 是否将页帧的内存锁住(mlock)
+   */
+  BufferPoolManager(int64_t memory_size = 0, bool lock_memory = false);
   ~BufferPoolManager();
 
-  RC create_file(const char *file_name);
+  /**
+   * @brief 创建一个分页文件
+   * @param page_size 文件的页面大小，参考 bp_valid_page_size
+   */
+  RC create_file(const char *file_name, int page_size = BP_PAGE_SIZE);
   RC open_file(const char *file_name, DiskBufferPool *&bp);
   RC close_file(const char *file_name);
 
   RC flush_page(Frame &frame);
 
+  /**
+   * @brief 获取页面大小是 page_size 的页帧管理器
+   * @details 默认页面大小的页帧在创建时就分配好了。其它页面大小的页帧在第一次打开这种页面大小的文件时
+   * 分配，使用相同大小的内存。
+   */
+  RC frame_manager(int page_size, BPFrameManager *&frame_manager);
+
 public:
   static void set_instance(BufferPoolManager *bpm); // TODO 优化全局变量的表示方法
   static BufferPoolManager &instance();
 
 private:
-  BPFrameManager frame_manager_{"BufPool"};
+  int64_t        memory_size_ = 0;
+  bool           lock_memory_ = false;
+  std::mutex     frame_managers_lock_;
+  std::unordered_map<int, std::unique_ptr<BPFrameManager>> frame_managers_;  ///< 页面大小到页帧管理器的映射
 
   common::Mutex  lock_;
   std::unordered_map<std::string, DiskBufferPool *> buffer_pools_;
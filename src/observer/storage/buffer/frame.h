@@ -57,8 +57,11 @@ private:
  * 
  * 为了防止在使用过程中页面被淘汰，这里使用了pin count，当页面被使用时，pin count会增加，
  * 当页面不再使用时，pin count会减少。当pin count为0时，页面可以被淘汰。
+ *
+ * 页帧对象只保存元数据，页面数据在 FrameArena 预先分配的一整块内存中，两者一一对应。
+ * 页帧对象按照cache line对齐，避免不同页帧的pin count、锁等落在同一个cache line上。
  */
-class Frame
+class alignas(64) Frame
 {
 public:
   ~Frame()
@@ -67,28 +70,40 @@ public:
   }
 
   /**
-   * @brief reinit 和 reset 在 MemPoolSimple 中使用
-   * @details 在 MemPoolSimple 分配和释放一个Frame对象时，不会调用构造函数和析构函数，
+   * @brief reinit 和 reset 在 FrameArena 中使用
+   * @details 在 FrameArena 分配和释放一个Frame对象时，不会调用构造函数和析构函数，
    * 而是调用reinit和reset。
    */
   void reinit()
-  {}
+  {
+    all_visible_.store(false);
+    prefetched_.store(false);
+  }
   void reset()
   {}
   
   void clear_page()
   {
-    memset(&page_, 0, sizeof(page_));
+    memset(page_, 0, page_size_);
+  }
+
+  /**
+   * @brief 设置页帧使用的页面内存和页面大小，FrameArena 初始化时设置，之后不再变化
+   */
+  void    set_page(Page *page, int page_size = BP_PAGE_SIZE)
+  {
+    page_      = page;
+    page_size_ = page_size;
   }
 
   int     file_desc() const { return file_desc_; }
   void    set_file_desc(int fd) { file_desc_ = fd; }
-  Page &  page() { return page_; }
-  PageNum page_num() const { return page_.page_num; }
-  void    set_page_num(PageNum page_num) { page_.page_num = page_num; }
-  FrameId frame_id() const { return FrameId(file_desc_, page_.page_num); }
-  LSN     lsn() const { return page_.lsn; }
-  void    set_lsn(LSN lsn) { page_.lsn = lsn; }
+  Page &  page() { return *page_; }
+  PageNum page_num() const { return page_->page_num; }
+  void    set_page_num(PageNum page_num) { page_->page_num = page_num; }
+  FrameId frame_id() const { return FrameId(file_desc_, page_->page_num); }
+  LSN     lsn() const { return page_->lsn; }
+  void    set_lsn(LSN lsn) { page_->lsn = lsn; }
 
   /// 刷新访问时间 TODO touch is better?
   void access();
@@ -101,7 +116,29 @@ public:
   void clear_dirty() { dirty_ = false; }
   bool dirty() const { return dirty_; }
 
-  char *data() { return page_.data; }
+  char *data() { return page_->data; }
+
+  int page_size() const { return page_size_; }
+  /// 页面中可以存放数据的长度，参考 Page
+  int data_size() const { return bp_page_data_size(page_size_); }
+
+  /**
+   * @brief 页面上所有的记录是否对所有事务都可见
+   * @details 这是一个只存在于内存中的提示信息，页面被淘汰后会丢失，重新加载时认为不是全部可见。
+   * 读取到页面的全部记录后可以设置，任何以写模式访问页面的操作都会清除它。
+   * 索引覆盖扫描时，如果记录所在的页面是全部可见的，就不需要再访问记录判断可见性。
+   */
+  bool all_visible() const { return all_visible_.load(); }
+  void set_all_visible() { all_visible_.store(true); }
+  void clear_all_visible() { all_visible_.store(false); }
+
+  /**
+   * @brief 页面是否是预读进来的，并且还没有被访问过
+   * @details 用于统计预读的命中率，参考 DiskBufferPool::read_ahead。
+   * 第一次访问时清除，返回之前的值。
+   */
+  void set_prefetched() { prefetched_.store(true); }
+  bool clear_prefetched() { return prefetched_.exchange(false); }
 
   bool can_purge() { return pin_count_.load() == 0; }
 
@@ -137,10 +174,13 @@ private:
   friend class  BufferPool;
 
   bool              dirty_     = false;
+  std::atomic<bool> all_visible_{false};
+  std::atomic<bool> prefetched_{false};
   std::atomic<int>  pin_count_{0};
   unsigned long     acc_time_  = 0;
   int               file_desc_ = -1;
-  Page              page_;
+  Page             *page_      = nullptr;
+  int               page_size_ = BP_PAGE_SIZE;
 
   /// 在非并发编译时，加锁解锁动作将什么都不做
   common::RecursiveSharedMutex     lock_;
@@ -0,0 +1,134 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <errno.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "storage/buffer/frame_arena.h"
+#include "common/log/log.h"
+
+using namespace common;
+
+/// 透明大页的大小
+static const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+FrameArena::~FrameArena()
+{
+  cleanup();
+}
+
+RC FrameArena::init(int frame_num, bool lock_memory /* = false */, int page_size /* = BP_PAGE_SIZE */)
+{
+  if (memory_ != nullptr) {
+    LOG_WARN("frame arena has been initialized");
+    return RC::INTERNAL;
+  }
+  if (frame_num <= 0) {
+    LOG_WARN("invalid frame number. frame_num=%d", frame_num);
+    return RC::INVALID_ARGUMENT;
+  }
+  if (!bp_valid_page_size(page_size)) {
+    LOG_WARN("invalid page size. page_size=%d", page_size);
+    return RC::INVALID_ARGUMENT;
+  }
+
+  // 多映射一个大页，将页面的起始地址对齐到大页
+  const size_t pages_size = static_cast<size_t>(frame_num) * page_size;
+  memory_size_ = pages_size + HUGE_PAGE_SIZE;
+  void *memory = mmap(nullptr, memory_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (memory == MAP_FAILED) {
+    LOG_ERROR("failed to map memory for frames. size=%lu, error=%s", memory_size_, strerror(errno));
+    memory_size_ = 0;
+    return RC::NOMEM;
+  }
+  memory_ = static_cast<char *>(memory);
+
+  const uintptr_t aligned = (reinterpret_cast<uintptr_t>(memory_) + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+  pages_ = reinterpret_cast<char *>(aligned);
+
+#ifdef MADV_HUGEPAGE
+  huge_page_ = madvise(pages_, pages_size, MADV_HUGEPAGE) == 0;
+  if (!huge_page_) {
+    LOG_INFO("transparent huge page is not available. error=%s", strerror(errno));
+  }
+#endif
+
+  if (lock_memory) {
+    memory_locked_ = mlock(pages_, pages_size) == 0;
+    if (!memory_locked_) {
+      LOG_WARN("failed to lock frame memory, check RLIMIT_MEMLOCK. size=%lu, error=%s", pages_size, strerror(errno));
+    }
+  }
+
+  frames_    = new Frame[frame_num];
+  frame_num_ = frame_num;
+  page_size_ = page_size;
+  free_frames_.reserve(frame_num);
+  for (int i = frame_num - 1; i >= 0; i--) {
+    frames_[i].set_page(reinterpret_cast<Page *>(pages_ + static_cast<size_t>(i) * page_size), page_size);
+    free_frames_.push_back(i);
+  }
+
+  LOG_INFO("frame arena initialized. frame num=%d, page size=%d, memory size=%lu, huge page=%d, memory locked=%d",
+           frame_num, page_size, pages_size, huge_page_, memory_locked_);
+  return RC::SUCCESS;
+}
+
+void FrameArena::cleanup()
+{
+  if (memory_ == nullptr) {
+    return;
+  }
+
+  delete[] frames_;
+  frames_ = nullptr;
+  free_frames_.clear();
+
+  if (memory_locked_) {
+    munlock(pages_, static_cast<size_t>(frame_num_) * page_size_);
+    memory_locked_ = false;
+  }
+  munmap(memory_, memory_size_);
+  memory_      = nullptr;
+  memory_size_ = 0;
+  pages_       = nullptr;
+  frame_num_   = 0;
+  page_size_   = BP_PAGE_SIZE;
+  huge_page_   = false;
+}
+
+Frame *FrameArena::alloc()
+{
+  if (free_frames_.empty()) {
+    return nullptr;
+  }
+
+  Frame *frame = &frames_[free_frames_.back()];
+  free_frames_.pop_back();
+  frame->reinit();
+  return frame;
+}
+
+void FrameArena::free(Frame *frame)
+{
+  ASSERT(frame >= frames_ && frame < frames_ + frame_num_, "frame does not belong to this arena. frame=%p", frame);
+  frame->reset();
+  free_frames_.push_back(static_cast<int>(frame - frames_));
+}
+
+Frame *FrameArena::frame_of(const void *address)
+{
+  const char *addr = static_cast<const char *>(address);
+  if (pages_ == nullptr || addr < pages_ || addr >= pages_ + static_cast<size_t>(frame_num_) * page_size_) {
+    return nullptr;
+  }
+  return &frames_[(addr - pages_) / page_size_];
+}
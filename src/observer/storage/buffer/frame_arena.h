@@ -0,0 +1,74 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+#include "common/rc.h"
+#include "storage/buffer/frame.h"
+
+/**
+ * @brief 预先分配好的所有页帧
+ * @ingroup BufferPool
+ * @details 初始化时一次性映射一整块连续的匿名内存存放所有页面的数据，按照大页(2MB)对齐，并通过
+ * MADV_HUGEPAGE 建议操作系统使用透明大页，减少TLB缺失。可以选择使用 mlock 将内存锁住，避免被交换出去。
+ * 页帧的元数据(Frame对象)放在另外一个数组中，第i个页帧使用第i个页面，根据页面数据的地址就可以算出页帧。
+ * 一个 FrameArena 中的页面大小都是一样的，不同页面大小的文件使用不同的 FrameArena。
+ * 页帧个数是固定的，分配和释放只是从空闲列表中取出和放回，不会再申请内存。
+ * @note 不是线程安全的，由 BPFrameManager 加锁访问
+ */
+class FrameArena
+{
+public:
+  FrameArena() = default;
+  ~FrameArena();
+
+  /**
+   * @brief 分配内存
+   * @param frame_num   页帧的个数
+   * @param lock_memory 是否使用 mlock 锁住内存。失败时只打印日志，依然可以使用
+   * @param page_size   页面大小，参考 bp_valid_page_size
+   */
+  RC   init(int frame_num, bool lock_memory = false, int page_size = BP_PAGE_SIZE);
+  void cleanup();
+
+  /**
+   * @brief 分配一个页帧，没有空闲的页帧时返回 nullptr
+   */
+  Frame *alloc();
+  void   free(Frame *frame);
+
+  /**
+   * @brief 根据页面数据的地址找到所在的页帧
+   * @details 地址可以是页面中的任意位置，比如 Frame::data() 返回的地址或者某条记录的地址。
+   * 只是根据地址相对于页面数组的偏移计算，不需要查找哈希表，也不需要加锁。不在页面数组中的地址返回 nullptr
+   */
+  Frame *frame_of(const void *address);
+
+  int frame_num() const { return frame_num_; }
+  int page_size() const { return page_size_; }
+  int used_num() const { return frame_num_ - static_cast<int>(free_frames_.size()); }
+
+  bool huge_page() const { return huge_page_; }
+  bool memory_locked() const { return memory_locked_; }
+
+private:
+  char            *memory_        = nullptr;  ///< mmap 返回的地址
+  size_t           memory_size_   = 0;
+  char            *pages_         = nullptr;  ///< 按照大页对齐的页面数据
+  Frame           *frames_        = nullptr;
+  int              frame_num_     = 0;
+  int              page_size_     = BP_PAGE_SIZE;
+  std::vector<int> free_frames_;              ///< 空闲的页帧编号，后进先出，最近释放的页帧更可能还在CPU缓存中
+  bool             huge_page_     = false;
+  bool             memory_locked_ = false;
+};
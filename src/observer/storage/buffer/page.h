@@ -23,12 +23,33 @@ static constexpr int BP_INVALID_PAGE_NUM = -1;
 
 static constexpr PageNum BP_HEADER_PAGE   = 0;
 
+/// 默认的也是最小的页面大小
 static constexpr const int BP_PAGE_SIZE = (1 << 13);
 static constexpr const int BP_PAGE_DATA_SIZE = (BP_PAGE_SIZE - sizeof(PageNum) - sizeof(LSN));
+/// 最大的页面大小
+static constexpr const int BP_MAX_PAGE_SIZE = (1 << 16);
+
+/**
+ * @brief 创建文件时可以使用的页面大小：8KB、16KB、32KB或64KB
+ */
+inline bool bp_valid_page_size(int page_size)
+{
+  return page_size >= BP_PAGE_SIZE && page_size <= BP_MAX_PAGE_SIZE && (page_size & (page_size - 1)) == 0;
+}
+
+/**
+ * @brief 页面大小是 page_size 时，页面中可以存放数据的长度
+ */
+inline constexpr int bp_page_data_size(int page_size)
+{
+  return page_size - (BP_PAGE_SIZE - BP_PAGE_DATA_SIZE);
+}
 
 /**
  * @brief 表示一个页面，可能放在内存或磁盘上
  * @ingroup BufferPool
+ * @details 页面大小由文件决定(参考 BPFileHeader::page_size)。大于 BP_PAGE_SIZE 的页面，data 后面
+ * 紧跟着剩下的数据，数据的长度使用 Frame::data_size 获取。
  */
 struct Page
 {
@@ -20,6 +20,8 @@ See the Mulan PSL v2 for more details. */
 #include "common/global_context.h"
 #include "storage/trx/trx.h"
 #include "common/io/io.h"
+#include "storage/common/io_backend.h"
+#include "session/statement_counters.h"
 
 using namespace std;
 using namespace common;
@@ -29,6 +31,9 @@ using namespace common;
  */
 const char *CLOG_FILE_NAME = "clog";
 
+/// 日志文件写入前缓存的数据超过这个大小，就先写入文件
+static const size_t CLOG_WRITE_BUFFER_SIZE = 1024 * 1024;
+
 const char *clog_type_name(CLogType type)
 {
   #define DEFINE_CLOG_TYPE(name)  case CLogType::name: return #name;
@@ -215,7 +220,7 @@ RC CLogBuffer::append_log_record(CLogRecord *log_record)
     return RC::LOGBUF_FULL;
   }
 
-  lock_guard<Mutex> lock_guard(lock_);
+  lock_guard<std::mutex> guard(lock_);
   log_records_.emplace_back(log_record);
   total_size_ += log_record->logrec_len();
   LOG_DEBUG("append log. log_record={%s}", log_record->to_string().c_str());
@@ -226,11 +231,12 @@ RC CLogBuffer::flush_buffer(CLogFile &log_file)
 {
   RC rc = RC::SUCCESS;
   int count = 0;
-  while (!log_records_.empty()) {
+  while (true) {
     lock_.lock();
     if (log_records_.empty()) {
+      // 其它线程可能取走了当前线程的日志，它们已经写入了 log_file 的缓存，sync 时会一起提交
       lock_.unlock();
-      return RC::SUCCESS;
+      break;
     }
 
     // log buffer 需要支持并发，所以要考虑加锁
@@ -314,6 +320,7 @@ RC CLogFile::init(const char *path)
 CLogFile::~CLogFile()
 {
   if (fd_ >= 0) {
+    flush_write_buffer();
     LOG_INFO("close clog file. file=%s, fd=%d", filename_.c_str(), fd_);
     ::close(fd_);
     fd_ = -1;
@@ -322,10 +329,52 @@ CLogFile::~CLogFile()
 
 RC CLogFile::write(const char *data, int len)
 {
-  int ret = writen(fd_, data, len);
-  if (0 != ret) {
-    LOG_WARN("failed to write data to file. filename=%s, data len=%d, error=%s", filename_.c_str(), len, strerror(ret));
-    return RC::IOERR_WRITE;
+  bool need_flush = false;
+  {
+    lock_guard<std::mutex> guard(buffer_lock_);
+    write_buffer_.append(data, len);
+    need_flush = write_buffer_.size() >= CLOG_WRITE_BUFFER_SIZE;
+  }
+
+  if (need_flush) {
+    return flush_write_buffer();
+  }
+  return RC::SUCCESS;
+}
+
+void CLogFile::take_write_buffer(std::string &data)
+{
+  lock_guard<std::mutex> guard(buffer_lock_);
+  data.clear();
+  data.swap(write_buffer_);
+}
+
+void CLogFile::restore_write_buffer(std::string &data)
+{
+  lock_guard<std::mutex> guard(buffer_lock_);
+  data.append(write_buffer_);
+  write_buffer_.swap(data);
+}
+
+RC CLogFile::flush_write_buffer()
+{
+  lock_guard<std::mutex> io_guard(io_lock_);
+  std::string data;
+  take_write_buffer(data);
+  if (data.empty()) {
+    return RC::SUCCESS;
+  }
+
+  IoRequest request;
+  request.fd  = fd_;
+  request.buf = data.data();
+  request.len = data.size();
+  RC rc = IoBackend::instance().write(&request, 1);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to write data to file. filename=%s, data len=%d, rc=%s",
+             filename_.c_str(), static_cast<int>(data.size()), strrc(rc));
+    restore_write_buffer(data);
+    return rc;
   }
   return RC::SUCCESS;
 }
@@ -347,10 +396,23 @@ RC CLogFile::read(char *data, int len)
 
 RC CLogFile::sync()
 {
-  int ret = fsync(fd_);
-  if (ret != 0) {
-    LOG_WARN("failed to sync file. file=%s, error=%s", filename_.c_str(), strerror(errno));
-    return RC::IOERR_SYNC;
+  lock_guard<std::mutex> io_guard(io_lock_);
+  std::string data;
+  take_write_buffer(data);
+  if (data.empty()) {
+    return IoBackend::instance().sync(fd_);
+  }
+
+  IoRequest request;
+  request.fd  = fd_;
+  request.buf = data.data();
+  request.len = data.size();
+  RC rc = IoBackend::instance().write_and_sync(request);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to write and sync file. file=%s, data len=%d, rc=%s",
+             filename_.c_str(), static_cast<int>(data.size()), strrc(rc));
+    restore_write_buffer(data);
+    return rc;
   }
   return RC::SUCCESS;
 }
@@ -487,7 +549,22 @@ RC CLogManager::append_log(CLogRecord *log_record)
   if (nullptr == log_record) {
     return RC::INVALID_ARGUMENT;
   }
-  return log_buffer_->append_log_record(log_record);
+  const int log_bytes = log_record->logrec_len();
+  RC rc = log_buffer_->append_log_record(log_record);
+  if (rc == RC::LOGBUF_FULL) {
+    // 日志缓冲区满了就先把缓冲区中的日志写到文件中再重试
+    rc = sync();
+    if (OB_SUCC(rc)) {
+      rc = log_buffer_->append_log_record(log_record);
+    }
+  }
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to append log record. log_record=%s, rc=%s", log_record->to_string().c_str(), strrc(rc));
+    delete log_record;
+    return rc;
+  }
+  StatementCounters::current().log_bytes += log_bytes;
+  return rc;
 }
 
 RC CLogManager::sync()
@@ -21,6 +21,7 @@ See the Mulan PSL v2 for more details. */
 #include <unordered_map>
 #include <deque>
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include "storage/record/record.h"
@@ -48,6 +49,8 @@ class Db;
  * @details 除了事务操作相关的类型，比如MTR_BEGIN/MTR_COMMIT等，都是需要事务自己去处理的。
  * 也就是说，像INSERT、DELETE等是事务自己处理的，其实这种类型的日志不需要在这里定义，而是在各个
  * 事务模型中定义，由各个事务模型自行处理。
+ * BATCH_INSERT 是一条语句插入多条记录时的日志，每个页面一条，rid 是第一条记录的位置，数据部分依次存放
+ * 每条记录的RID和记录数据。UPDATE 的数据部分依次存放修改前和修改后的数据，各占一半。新的类型只能加在最后，日志文件中保存的是类型的数值。
  */
 #define DEFINE_CLOG_TYPE_ENUM         \
   DEFINE_CLOG_TYPE(ERROR)             \
@@ -55,7 +58,9 @@ class Db;
   DEFINE_CLOG_TYPE(MTR_COMMIT)        \
   DEFINE_CLOG_TYPE(MTR_ROLLBACK)      \
   DEFINE_CLOG_TYPE(INSERT)            \
-  DEFINE_CLOG_TYPE(DELETE)
+  DEFINE_CLOG_TYPE(DELETE)            \
+  DEFINE_CLOG_TYPE(UPDATE)            \
+  DEFINE_CLOG_TYPE(BATCH_INSERT)
 
 enum class CLogType 
 { 
@@ -248,7 +253,8 @@ public:
 
   /**
    * @brief 将当前的日志都刷新到日志文件中
-   * @details 因为多线程访问与日志管理的问题，只能有一个线程调用此函数
+   * @details 多个线程可以同时调用。日志记录按照取出的顺序写入文件，
+   * 返回时当前线程调用前追加的日志都已经同步到磁盘
    * @param log_file 日志文件
    */
   RC flush_buffer(CLogFile &log_file);
@@ -263,7 +269,7 @@ private:
   RC write_log_record(CLogFile &log_file, CLogRecord *log_record);
 
 private:
-  common::Mutex lock_;  ///< 加锁支持多线程并发写入
+  std::mutex lock_;  ///< 加锁支持多线程并发写入
   std::deque<std::unique_ptr<CLogRecord>> log_records_;  ///< 当前等待刷数据的日志记录
   std::atomic_int32_t total_size_;  ///< 当前缓存中的日志记录的总大小
 };
@@ -290,6 +296,8 @@ public:
   /**
    * @brief 写入指定数据，全部写入成功返回成功，否则返回失败
    * @details 作为日志文件读写的类，实现一个write_log_record可能更合适。
+   * 数据先放到 write_buffer_ 中，在 sync 时与fsync一起提交，缓存的数据太多时也会先写入文件。
+   * 可以与 sync 并发执行，参考 take_write_buffer
    * @note  如果日志文件写入一半失败了，应该做特殊处理，但是这里什么都没管。
    * @param data 写入的数据
    * @param len  数据的长度
@@ -306,6 +314,7 @@ public:
 
   /**
    * @brief 将当前写的文件执行sync同步数据到磁盘
+   * @details 缓存的数据与fsync一起提交，参考 IoBackend::write_and_sync
    */
   RC sync();
 
@@ -319,10 +328,31 @@ public:
    */
   bool eof() const { return eof_; }
 
+protected:
+  /**
+   * @brief 将缓存的数据写入文件，不做sync
+   */
+  RC flush_write_buffer();
+
+  /**
+   * @brief 取出缓存的数据用来提交IO
+   * @details 在 buffer_lock_ 的保护下与一个空的缓存交换，IO进行时其它线程可以继续写入新的缓存，
+   * 不会修改或清空正在写入文件的数据。调用者需要持有 io_lock_，保证数据按照写入的顺序落盘
+   */
+  void take_write_buffer(std::string &data);
+
+  /**
+   * @brief IO失败时把取出的数据放回缓存的最前面，这些数据没有写入文件，不能丢弃
+   */
+  void restore_write_buffer(std::string &data);
+
 protected:
   std::string filename_;  ///< 日志文件名。总是init函数参数path路径下的clog文件
   int fd_ = -1;           ///< 操作的文件描述符
   bool eof_ = false;      ///< 是否已经读取到文件尾
+  std::string write_buffer_;  ///< 还没有写入文件的数据
+  std::mutex  buffer_lock_;  ///< 保护 write_buffer_。多个会话会同时写日志，不依赖 CONCURRENCY 选项
+  std::mutex  io_lock_;      ///< 同一时间只有一个线程提交缓存的数据
 };
 
 /**
@@ -19,12 +19,26 @@ See the Mulan PSL v2 for more details. */
 #include "common/log/log.h"
 #include "storage/table/table.h"
 #include "sql/parser/value.h"
+#include "storage/field/field_meta.h"
+#include "common/lang/comparator.h"
 
 using namespace common;
 
 ConditionFilter::~ConditionFilter()
 {}
 
+bool ConditionFilter::filter(RecordPageHandler &page_handler, SlotNum slot_num) const
+{
+  Record record;
+  RID    rid(page_handler.get_page_num(), slot_num);
+  RC     rc = page_handler.get_record(&rid, &record);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to get record from page. rid=%s, rc=%s", rid.to_string().c_str(), strrc(rc));
+    return false;
+  }
+  return filter(record);
+}
+
 DefaultConditionFilter::DefaultConditionFilter()
 {
   left_.is_attr = false;
@@ -227,3 +241,106 @@ bool CompositeConditionFilter::filter(const Record &rec) const
   }
   return true;
 }
+
+RC TypedConditionFilter::add_condition(const FieldMeta &field, CompOp comp, const Value &value)
+{
+  if (comp < EQUAL_TO || comp > GREAT_THAN) {
+    return RC::UNIMPLENMENT;
+  }
+
+  if (field.type() != value.attr_type()) {
+    return RC::UNIMPLENMENT;
+  }
+
+  Condition condition;
+  condition.offset = field.offset();
+  condition.len    = field.len();
+  condition.type   = field.type();
+  condition.comp   = comp;
+  switch (field.type()) {
+    case INTS: {
+      condition.int_value = value.get_int();
+    } break;
+    case FLOATS: {
+      condition.float_value = value.get_float();
+    } break;
+    case DATES: {
+      condition.date_value = value.get_date();
+    } break;
+    case CHARS: {
+      condition.str_value = value.get_string();
+    } break;
+    default: {
+      return RC::UNIMPLENMENT;
+    }
+  }
+
+  conditions_.push_back(std::move(condition));
+  return RC::SUCCESS;
+}
+
+bool TypedConditionFilter::match(const Condition &condition, const char *field_data)
+{
+  int cmp_result = 0;
+  switch (condition.type) {
+    case INTS: {
+      int v = *(const int *)field_data;
+      cmp_result = v > condition.int_value ? 1 : (v < condition.int_value ? -1 : 0);
+    } break;
+    case FLOATS: {
+      cmp_result = compare_float((void *)field_data, (void *)&condition.float_value);
+    } break;
+    case DATES: {
+      unsigned v = *(const unsigned *)field_data;
+      cmp_result = v > condition.date_value ? 1 : (v < condition.date_value ? -1 : 0);
+    } break;
+    case CHARS: {
+      // 与 Value::set_string 一样，字段中的字符串以'\0'或者字段长度结束
+      const int len = strnlen(field_data, condition.len);
+      cmp_result = compare_string(
+          (void *)field_data, len, (void *)condition.str_value.c_str(), condition.str_value.length());
+    } break;
+    default: {
+      return true;
+    }
+  }
+
+  switch (condition.comp) {
+    case EQUAL_TO:
+      return 0 == cmp_result;
+    case LESS_EQUAL:
+      return cmp_result <= 0;
+    case NOT_EQUAL:
+      return cmp_result != 0;
+    case LESS_THAN:
+      return cmp_result < 0;
+    case GREAT_EQUAL:
+      return cmp_result >= 0;
+    case GREAT_THAN:
+      return cmp_result > 0;
+    default:
+      break;
+  }
+  return true;
+}
+
+bool TypedConditionFilter::filter(const Record &rec) const
+{
+  const char *data = rec.data();
+  for (const Condition &condition : conditions_) {
+    if (!match(condition, data + condition.offset)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool TypedConditionFilter::filter(RecordPageHandler &page_handler, SlotNum slot_num) const
+{
+  for (const Condition &condition : conditions_) {
+    if (!match(condition, page_handler.field_data(slot_num, condition.offset))) {
+      return false;
+    }
+  }
+  return true;
+}
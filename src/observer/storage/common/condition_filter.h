@@ -14,10 +14,16 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <string>
+#include <vector>
+
+#include "common/types.h"
 #include "sql/parser/parse.h"
 
 class Record;
+class RecordPageHandler;
 class Table;
+class FieldMeta;
 
 struct ConDesc 
 {
@@ -38,6 +44,14 @@ public:
    * @return true means match condition, false means failed to match.
    */
   virtual bool filter(const Record &rec) const = 0;
+
+  /**
+   * @brief 过滤还在页面上的某条记录
+   * @details 默认先取出整条记录再过滤。在PAX页面上，只用到个别字段的过滤条件可以只读取这几个字段
+   * @param page_handler 记录所在的页面
+   * @param slot_num     记录的槽位
+   */
+  virtual bool filter(RecordPageHandler &page_handler, SlotNum slot_num) const;
 };
 
 class DefaultConditionFilter : public ConditionFilter 
@@ -107,3 +121,65 @@ private:
   int filter_num_ = 0;
   bool memory_owner_ = false;  // filters_的内存是否由自己来控制
 };
+
+/**
+ * @brief 按照字段类型直接比较记录数据的过滤器
+ * @details 由若干个"字段 比较符 常量"的条件组成，条件之间是AND的关系。
+ * 过滤时直接读取记录中字段所在位置的数据，按照字段的类型与常量比较，不需要构造 Value。
+ * 在 RecordFileScanner 中，记录还在页面上，没有做可见性检查和拷贝时就可以过滤掉不满足条件的记录。
+ * 比较的结果与 Value::compare 一致。
+ */
+class TypedConditionFilter : public ConditionFilter 
+{
+public:
+  TypedConditionFilter() = default;
+  virtual ~TypedConditionFilter() = default;
+
+  /**
+   * @brief 增加一个条件 field comp value
+   * @details 仅支持类型相同的字段和常量做大小比较，其它情况返回 RC::UNIMPLENMENT，由调用者自己处理
+   */
+  RC add_condition(const FieldMeta &field, CompOp comp, const Value &value);
+
+  void clear()
+  {
+    conditions_.clear();
+  }
+
+  bool empty() const
+  {
+    return conditions_.empty();
+  }
+
+  int condition_num() const
+  {
+    return static_cast<int>(conditions_.size());
+  }
+
+  bool filter(const Record &rec) const override;
+  bool filter(RecordPageHandler &page_handler, SlotNum slot_num) const override;
+
+private:
+  struct Condition
+  {
+    int         offset = 0;  ///< 字段在记录中的偏移量
+    int         len    = 0;  ///< 字段的长度
+    AttrType    type   = UNDEFINED;
+    CompOp      comp   = NO_OP;
+    union
+    {
+      int      int_value = 0;
+      float    float_value;
+      unsigned date_value;
+    };
+    std::string str_value;  ///< CHARS 类型的常量
+  };
+
+  /**
+   * @param field_data 条件中字段的数据
+   */
+  static bool match(const Condition &condition, const char *field_data);
+
+private:
+  std::vector<Condition> conditions_;
+};
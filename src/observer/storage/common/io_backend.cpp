@@ -0,0 +1,440 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <errno.h>
+#include <limits.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define HAVE_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+#include "storage/common/io_backend.h"
+#include "common/log/log.h"
+
+using namespace std;
+
+RC IoBackend::write_and_sync(IoRequest &request)
+{
+  RC rc = write(&request, 1);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+  return sync(request.fd);
+}
+
+IoBackend &IoBackend::instance()
+{
+  static PosixIoBackend posix_backend;
+  static IoUringBackend io_uring_backend;
+  static IoBackend     *backend = IoUringBackend::available() ? static_cast<IoBackend *>(&io_uring_backend)
+                                                                : static_cast<IoBackend *>(&posix_backend);
+  return *backend;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief 使用 preadv/pwritev 读写一组地址连续的数据，处理读写了一部分的情况
+ * @return 0 表示成功，-1 表示读到了文件尾，其它是错误码
+ */
+static int vector_io(bool is_read, int fd, struct iovec *iovs, int iov_count, int64_t offset)
+{
+  while (iov_count > 0) {
+    ssize_t ret = 0;
+    if (offset >= 0) {
+      ret = is_read ? preadv(fd, iovs, iov_count, offset) : pwritev(fd, iovs, iov_count, offset);
+    } else {
+      ret = is_read ? readv(fd, iovs, iov_count) : writev(fd, iovs, iov_count);
+    }
+
+    if (ret < 0) {
+      const int err = errno;
+      if (EAGAIN != err && EINTR != err) {
+        return err;
+      }
+      continue;
+    }
+    if (0 == ret && is_read) {
+      return -1;
+    }
+
+    if (offset >= 0) {
+      offset += ret;
+    }
+    while (iov_count > 0 && static_cast<size_t>(ret) >= iovs->iov_len) {
+      ret -= iovs->iov_len;
+      iovs++;
+      iov_count--;
+    }
+    if (iov_count > 0) {
+      iovs->iov_base = static_cast<char *>(iovs->iov_base) + ret;
+      iovs->iov_len -= ret;
+    }
+  }
+  return 0;
+}
+
+static RC posix_io(bool is_read, IoRequest *requests, int count)
+{
+  vector<struct iovec> iovs;
+  for (int i = 0; i < count;) {
+    // 合并文件中连续的请求
+    int end = i + 1;
+    while (end < count && end - i < IOV_MAX && requests[end].fd == requests[i].fd && requests[i].offset >= 0 &&
+           requests[end].offset == requests[end - 1].offset + requests[end - 1].len) {
+      end++;
+    }
+
+    iovs.resize(end - i);
+    for (int j = i; j < end; j++) {
+      iovs[j - i].iov_base = requests[j].buf;
+      iovs[j - i].iov_len  = requests[j].len;
+    }
+
+    const int ret = vector_io(is_read, requests[i].fd, iovs.data(), end - i, requests[i].offset);
+    if (ret != 0) {
+      LOG_WARN("failed to %s file. fd=%d, offset=%ld, request num=%d, error=%s",
+               is_read ? "read" : "write", requests[i].fd, requests[i].offset, end - i,
+               ret == -1 ? "end of file" : strerror(ret));
+      return is_read ? RC::IOERR_READ : RC::IOERR_WRITE;
+    }
+    i = end;
+  }
+  return RC::SUCCESS;
+}
+
+RC PosixIoBackend::read(IoRequest *requests, int count) { return posix_io(true /*is_read*/, requests, count); }
+
+RC PosixIoBackend::write(IoRequest *requests, int count) { return posix_io(false /*is_read*/, requests, count); }
+
+RC PosixIoBackend::sync(int fd)
+{
+  if (fsync(fd) != 0) {
+    LOG_WARN("failed to sync file. fd=%d, error=%s", fd, strerror(errno));
+    return RC::IOERR_SYNC;
+  }
+  return RC::SUCCESS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_IO_URING
+
+/**
+ * @brief 一个 io_uring 实例，包括提交队列和完成队列
+ */
+class IoUring
+{
+public:
+  ~IoUring()
+  {
+    if (sqes_ != nullptr) {
+      munmap(sqes_, sqes_size_);
+    }
+    if (cq_ptr_ != nullptr && cq_ptr_ != sq_ptr_) {
+      munmap(cq_ptr_, cq_size_);
+    }
+    if (sq_ptr_ != nullptr) {
+      munmap(sq_ptr_, sq_size_);
+    }
+    if (ring_fd_ >= 0) {
+      ::close(ring_fd_);
+    }
+  }
+
+  int init(unsigned entries)
+  {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    ring_fd_ = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+    if (ring_fd_ < 0) {
+      return errno;
+    }
+
+    // 需要 IORING_OP_READ/WRITE 使用文件当前位置的能力(5.6)
+    if (!(params.features & IORING_FEAT_RW_CUR_POS)) {
+      return ENOTSUP;
+    }
+
+    sq_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_size_ = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+      sq_size_ = cq_size_ = std::max(sq_size_, cq_size_);
+    }
+
+    sq_ptr_ = mmap(nullptr, sq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+    if (MAP_FAILED == sq_ptr_) {
+      sq_ptr_ = nullptr;
+      return errno;
+    }
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+      cq_ptr_ = sq_ptr_;
+    } else {
+      cq_ptr_ = mmap(nullptr, cq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+      if (MAP_FAILED == cq_ptr_) {
+        cq_ptr_ = nullptr;
+        return errno;
+      }
+    }
+
+    sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+    void *sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+    if (MAP_FAILED == sqes) {
+      return errno;
+    }
+    sqes_ = static_cast<struct io_uring_sqe *>(sqes);
+
+    char *sq = static_cast<char *>(sq_ptr_);
+    sq_tail_    = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    sq_mask_    = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    sq_array_   = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    sq_entries_ = params.sq_entries;
+
+    char *cq = static_cast<char *>(cq_ptr_);
+    cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    cqes_    = reinterpret_cast<struct io_uring_cqe *>(cq + params.cq_off.cqes);
+    return 0;
+  }
+
+  unsigned sq_entries() const { return sq_entries_; }
+
+  /**
+   * @brief 获取一个提交项，提交前最多获取 sq_entries 个
+   */
+  struct io_uring_sqe *next_sqe()
+  {
+    const unsigned index = (*sq_tail_ + pending_) & sq_mask_;
+    struct io_uring_sqe *sqe = &sqes_[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sq_array_[index] = index;
+    pending_++;
+    return sqe;
+  }
+
+  /**
+   * @brief 提交所有的提交项，等待它们全部完成
+   * @param handler 处理每个完成项
+   */
+  template <typename Handler>
+  int submit_and_wait(Handler handler)
+  {
+    const unsigned count = pending_;
+    __atomic_store_n(sq_tail_, *sq_tail_ + pending_, __ATOMIC_RELEASE);
+    pending_ = 0;
+
+    unsigned submitted = 0;
+    unsigned completed = 0;
+    while (completed < count) {
+      const unsigned to_submit = count - submitted;
+      const int ret = static_cast<int>(syscall(__NR_io_uring_enter, ring_fd_, to_submit, 1, IORING_ENTER_GETEVENTS,
+                                               nullptr, 0));
+      if (ret < 0) {
+        if (EINTR == errno || EAGAIN == errno || EBUSY == errno) {
+          continue;
+        }
+        return errno;
+      }
+      submitted += std::min(static_cast<unsigned>(ret), to_submit);
+
+      unsigned       head = *cq_head_;
+      const unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+      for (; head != tail; head++) {
+        handler(cqes_[head & cq_mask_]);
+        completed++;
+      }
+      __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    }
+    return 0;
+  }
+
+private:
+  int    ring_fd_   = -1;
+  void  *sq_ptr_    = nullptr;
+  void  *cq_ptr_    = nullptr;
+  size_t sq_size_   = 0;
+  size_t cq_size_   = 0;
+  size_t sqes_size_ = 0;
+
+  struct io_uring_sqe *sqes_       = nullptr;
+  unsigned            *sq_tail_    = nullptr;
+  unsigned            *sq_array_   = nullptr;
+  unsigned             sq_mask_    = 0;
+  unsigned             sq_entries_ = 0;
+  unsigned             pending_    = 0;  ///< 已经获取还没有提交的提交项个数
+
+  unsigned            *cq_head_ = nullptr;
+  unsigned            *cq_tail_ = nullptr;
+  unsigned             cq_mask_ = 0;
+  struct io_uring_cqe *cqes_    = nullptr;
+};
+
+static const unsigned IO_URING_ENTRIES = 64;
+
+/**
+ * @brief 当前线程的 io_uring。创建失败返回 nullptr，之后不再尝试
+ */
+static IoUring *thread_io_uring()
+{
+  static thread_local unique_ptr<IoUring> ring;
+  static thread_local bool                failed = false;
+  if (ring == nullptr && !failed) {
+    unique_ptr<IoUring> new_ring = make_unique<IoUring>();
+    const int           ret      = new_ring->init(IO_URING_ENTRIES);
+    if (ret != 0) {
+      LOG_WARN("failed to create io_uring, use posix io instead. error=%s", strerror(ret));
+      failed = true;
+    } else {
+      ring = std::move(new_ring);
+    }
+  }
+  return ring.get();
+}
+
+static void prep_rw(struct io_uring_sqe *sqe, int opcode, const IoRequest &request)
+{
+  sqe->opcode = opcode;
+  sqe->fd     = request.fd;
+  sqe->addr   = reinterpret_cast<uint64_t>(request.buf);
+  sqe->len    = static_cast<uint32_t>(request.len);
+  sqe->off    = request.offset >= 0 ? static_cast<uint64_t>(request.offset) : static_cast<uint64_t>(-1);
+}
+
+bool IoUringBackend::available()
+{
+  IoUring ring;
+  const int ret = ring.init(2);
+  if (ret != 0) {
+    LOG_INFO("io_uring is not available, use posix io. error=%s", strerror(ret));
+    return false;
+  }
+  return true;
+}
+
+RC IoUringBackend::submit(int opcode, IoRequest *requests, int count)
+{
+  IoUring *ring = thread_io_uring();
+  if (nullptr == ring) {
+    return opcode == IORING_OP_READ ? posix_backend_.read(requests, count) : posix_backend_.write(requests, count);
+  }
+
+  const bool is_read = opcode == IORING_OP_READ;
+  RC         rc      = RC::SUCCESS;
+  for (int base = 0; base < count; base += ring->sq_entries()) {
+    const int batch = std::min(count - base, static_cast<int>(ring->sq_entries()));
+    for (int i = base; i < base + batch; i++) {
+      struct io_uring_sqe *sqe = ring->next_sqe();
+      prep_rw(sqe, opcode, requests[i]);
+      sqe->user_data = i;
+    }
+
+    const int ret = ring->submit_and_wait([&](const struct io_uring_cqe &cqe) {
+      IoRequest &request = requests[cqe.user_data];
+      if (cqe.res < 0) {
+        LOG_WARN("failed to %s file. fd=%d, offset=%ld, len=%ld, error=%s",
+                 is_read ? "read" : "write", request.fd, request.offset, request.len, strerror(-cqe.res));
+        rc = is_read ? RC::IOERR_READ : RC::IOERR_WRITE;
+      } else if (cqe.res < request.len) {
+        // 只完成了一部分，剩下的同步完成
+        IoRequest rest = request;
+        rest.buf       = static_cast<char *>(request.buf) + cqe.res;
+        rest.len       = request.len - cqe.res;
+        rest.offset    = request.offset >= 0 ? request.offset + cqe.res : -1;
+        RC ret         = is_read ? posix_backend_.read(&rest, 1) : posix_backend_.write(&rest, 1);
+        if (OB_FAIL(ret)) {
+          rc = ret;
+        }
+      }
+    });
+    if (ret != 0) {
+      LOG_WARN("failed to submit io requests to io_uring. error=%s", strerror(ret));
+      return is_read ? RC::IOERR_READ : RC::IOERR_WRITE;
+    }
+  }
+  return rc;
+}
+
+RC IoUringBackend::read(IoRequest *requests, int count) { return submit(IORING_OP_READ, requests, count); }
+
+RC IoUringBackend::write(IoRequest *requests, int count) { return submit(IORING_OP_WRITE, requests, count); }
+
+RC IoUringBackend::sync(int fd) { return posix_backend_.sync(fd); }
+
+RC IoUringBackend::write_and_sync(IoRequest &request)
+{
+  IoUring *ring = thread_io_uring();
+  if (nullptr == ring) {
+    return posix_backend_.write_and_sync(request);
+  }
+
+  // 写入完成后才会执行fsync。写入失败或者只写了一部分时，fsync会被取消
+  struct io_uring_sqe *write_sqe = ring->next_sqe();
+  prep_rw(write_sqe, IORING_OP_WRITE, request);
+  write_sqe->flags |= IOSQE_IO_LINK;
+  write_sqe->user_data = 0;
+
+  struct io_uring_sqe *sync_sqe = ring->next_sqe();
+  sync_sqe->opcode    = IORING_OP_FSYNC;
+  sync_sqe->fd        = request.fd;
+  sync_sqe->user_data = 1;
+
+  int write_res = 0;
+  int sync_res  = 0;
+  const int ret = ring->submit_and_wait([&](const struct io_uring_cqe &cqe) {
+    (cqe.user_data == 0 ? write_res : sync_res) = cqe.res;
+  });
+  if (ret != 0) {
+    LOG_WARN("failed to submit io requests to io_uring. error=%s", strerror(ret));
+    return RC::IOERR_WRITE;
+  }
+
+  if (write_res < 0) {
+    LOG_WARN("failed to write file. fd=%d, len=%ld, error=%s", request.fd, request.len, strerror(-write_res));
+    return RC::IOERR_WRITE;
+  }
+  if (write_res < request.len) {
+    IoRequest rest = request;
+    rest.buf       = static_cast<char *>(request.buf) + write_res;
+    rest.len       = request.len - write_res;
+    rest.offset    = request.offset >= 0 ? request.offset + write_res : -1;
+    return posix_backend_.write_and_sync(rest);
+  }
+  if (sync_res < 0) {
+    LOG_WARN("failed to sync file. fd=%d, error=%s", request.fd, strerror(-sync_res));
+    return RC::IOERR_SYNC;
+  }
+  return RC::SUCCESS;
+}
+
+#else  // HAVE_IO_URING
+
+bool IoUringBackend::available() { return false; }
+
+RC IoUringBackend::submit(int opcode, IoRequest *requests, int count) { return RC::UNIMPLENMENT; }
+
+RC IoUringBackend::read(IoRequest *requests, int count) { return posix_backend_.read(requests, count); }
+
+RC IoUringBackend::write(IoRequest *requests, int count) { return posix_backend_.write(requests, count); }
+
+RC IoUringBackend::sync(int fd) { return posix_backend_.sync(fd); }
+
+RC IoUringBackend::write_and_sync(IoRequest &request) { return posix_backend_.write_and_sync(request); }
+
+#endif  // HAVE_IO_URING
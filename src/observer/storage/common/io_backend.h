@@ -0,0 +1,109 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "common/rc.h"
+
+/**
+ * @brief 一次读写请求
+ * @details offset 小于0时，从文件当前的位置读写。以 O_APPEND 打开的文件，写入总是追加到文件尾。
+ */
+struct IoRequest
+{
+  int     fd     = -1;
+  void   *buf    = nullptr;
+  int64_t len    = 0;
+  int64_t offset = -1;
+};
+
+/**
+ * @brief 文件读写的接口
+ * @details buffer pool 和日志文件都通过这个接口读写文件。一批请求会一起提交，全部完成后才返回，
+ * 这样支持异步IO的实现可以同时有多个IO在进行，比如预读多个页面、刷新多个脏页。
+ * 默认使用 io_uring(参考 IoUringBackend)，系统不支持时使用 pread/pwrite(参考 PosixIoBackend)。
+ */
+class IoBackend
+{
+public:
+  virtual ~IoBackend() = default;
+
+  virtual const char *name() const = 0;
+
+  /**
+   * @brief 执行一批读请求，全部读取完成才返回成功。读到文件尾也认为是失败
+   */
+  virtual RC read(IoRequest *requests, int count) = 0;
+
+  /**
+   * @brief 执行一批写请求，全部写入完成才返回成功
+   */
+  virtual RC write(IoRequest *requests, int count) = 0;
+
+  /**
+   * @brief 将文件的数据同步到磁盘
+   */
+  virtual RC sync(int fd) = 0;
+
+  /**
+   * @brief 写入数据，然后同步到磁盘。用于提交事务时写日志
+   */
+  virtual RC write_and_sync(IoRequest &request);
+
+  /**
+   * @brief 当前使用的读写接口
+   * @details 第一次调用时检测是否支持 io_uring
+   */
+  static IoBackend &instance();
+};
+
+/**
+ * @brief 使用 pread/pwrite 等同步接口读写文件
+ * @details 同一批中地址连续的请求会合并成一次 preadv/pwritev。
+ */
+class PosixIoBackend : public IoBackend
+{
+public:
+  const char *name() const override { return "posix"; }
+
+  RC read(IoRequest *requests, int count) override;
+  RC write(IoRequest *requests, int count) override;
+  RC sync(int fd) override;
+};
+
+/**
+ * @brief 使用 io_uring 读写文件
+ * @details 直接使用系统调用，不依赖 liburing。每个线程使用自己的 ring，提交时不需要加锁。
+ * 一批请求一次提交，然后等待全部完成。写日志时，写入和fsync链接(IOSQE_IO_LINK)在一起提交。
+ * 创建 ring 失败时(比如内核不支持或者被禁用)，使用 PosixIoBackend 完成请求。
+ */
+class IoUringBackend : public IoBackend
+{
+public:
+  const char *name() const override { return "io_uring"; }
+
+  RC read(IoRequest *requests, int count) override;
+  RC write(IoRequest *requests, int count) override;
+  RC sync(int fd) override;
+  RC write_and_sync(IoRequest &request) override;
+
+  /**
+   * @brief 当前系统是否可以使用 io_uring
+   */
+  static bool available();
+
+private:
+  RC submit(int opcode, IoRequest *requests, int count);
+
+private:
+  PosixIoBackend posix_backend_;
+};
@@ -45,7 +45,8 @@ public:
    */
   RC init(const char *name, const char *dbpath);
 
-  RC create_table(const char *table_name, int attribute_count, const AttrInfoSqlNode *attributes);
+  RC create_table(const char *table_name, int attribute_count, const AttrInfoSqlNode *attributes,
+      StorageFormat storage_format = ROW_FORMAT, int page_size = BP_PAGE_SIZE);
   RC drop_table(const char *table_name);    // new
 
   Table *find_table(const char *table_name) const;
@@ -148,6 +148,13 @@ RC DefaultHandler::open_db(const char *dbname)
   return ret;
 }
 
+void DefaultHandler::all_dbs(std::vector<std::string> &db_names) const
+{
+  for (const auto &db_item : opened_dbs_) {
+    db_names.emplace_back(db_item.first);
+  }
+}
+
 RC DefaultHandler::close_db(const char *dbname)
 {
   return RC::UNIMPLENMENT;
@@ -92,6 +92,7 @@ public:
 public:
   Db *find_db(const char *dbname) const;
   Table *find_table(const char *dbname, const char *table_name) const;
+  void all_dbs(std::vector<std::string> &db_names) const;
 
   RC sync();
 
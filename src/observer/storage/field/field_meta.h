@@ -31,10 +31,10 @@ class FieldMeta
 {
 public:
   FieldMeta();
-  FieldMeta(const char *name, AttrType attr_type, int attr_offset, int attr_len, bool visible);
+  FieldMeta(const char *name, AttrType attr_type, int attr_offset, int attr_len, bool visible, bool var_len = false);
   ~FieldMeta() = default;
 
-  RC init(const char *name, AttrType attr_type, int attr_offset, int attr_len, bool visible);
+  RC init(const char *name, AttrType attr_type, int attr_offset, int attr_len, bool visible, bool var_len = false);
 
 public:
   const char *name() const;
@@ -43,6 +43,12 @@ public:
   int len() const;
   bool visible() const;
 
+  /**
+   * @brief 是否是变长字段(VARCHAR)
+   * @details 变长字段在记录中与CHARS一样占用 len 个字节，只是在页面上按照实际长度存放
+   */
+  bool var_len() const;
+
 public:
   void desc(std::ostream &os) const;
 
@@ -56,4 +62,5 @@ protected:
   int attr_offset_;
   int attr_len_;
   bool visible_;
+  bool var_len_;
 };
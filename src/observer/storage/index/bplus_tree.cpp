@@ -12,6 +12,9 @@ See the Mulan PSL v2 for more details. */
 // Created by Xie Meiyi
 // Rewritten by Longda & Wangyunlai
 //
+#include <algorithm>
+#include <numeric>
+
 #include "storage/index/bplus_tree.h"
 #include "storage/buffer/disk_buffer_pool.h"
 #include "common/log/log.h"
@@ -23,18 +26,114 @@ using namespace common;
 
 #define FIRST_INDEX_PAGE 1
 
-int calc_internal_page_capacity(int attr_length)
+/////////////////////////////////////////////////////////////////////////////////
+static void store_big_endian(uint32_t value, char *dst)
+{
+  dst[0] = static_cast<char>(value >> 24);
+  dst[1] = static_cast<char>(value >> 16);
+  dst[2] = static_cast<char>(value >> 8);
+  dst[3] = static_cast<char>(value);
+}
+
+static uint32_t load_big_endian(const char *src)
+{
+  const unsigned char *p = reinterpret_cast<const unsigned char *>(src);
+  return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+         (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+void KeyNormalizer::init(const std::vector<AttrType> &types, const std::vector<int32_t> &lengths, bool enabled)
+{
+  enabled_    = enabled;
+  attr_types_ = types;
+  attr_lens_  = lengths;
+}
+
+void KeyNormalizer::normalize(const char *user_key, char *key) const
+{
+  int offset = 0;
+  for (size_t i = 0; i < attr_types_.size(); i++) {
+    const int attr_len = attr_lens_[i];
+    const char *src = user_key + offset;
+    char *dst = key + offset;
+    switch (attr_types_[i]) {
+      case INTS: {
+        int32_t value;
+        memcpy(&value, src, sizeof(value));
+        store_big_endian(static_cast<uint32_t>(value) ^ 0x80000000u, dst);
+      } break;
+      case DATES: {
+        uint32_t value;
+        memcpy(&value, src, sizeof(value));
+        store_big_endian(value, dst);
+      } break;
+      case FLOATS: {
+        float value;
+        memcpy(&value, src, sizeof(value));
+        if (value == 0.0f) {
+          value = 0.0f;  // -0.0 与 0.0 编码成同一个值
+        }
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        // 负数翻转所有位，正数只翻转符号位
+        bits = (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+        store_big_endian(bits, dst);
+      } break;
+      case CHARS: {
+        // 记录中字符串结束符之后的内容是未定义的，编码时统一填充为0
+        const int str_len = static_cast<int>(strnlen(src, attr_len));
+        memcpy(dst, src, str_len);
+        memset(dst + str_len, 0, attr_len - str_len);
+      } break;
+      default: {
+        memcpy(dst, src, attr_len);
+      } break;
+    }
+    offset += attr_len;
+  }
+}
+
+void KeyNormalizer::denormalize(const char *key, char *user_key) const
+{
+  int offset = 0;
+  for (size_t i = 0; i < attr_types_.size(); i++) {
+    const int attr_len = attr_lens_[i];
+    const char *src = key + offset;
+    char *dst = user_key + offset;
+    switch (attr_types_[i]) {
+      case INTS: {
+        int32_t value = static_cast<int32_t>(load_big_endian(src) ^ 0x80000000u);
+        memcpy(dst, &value, sizeof(value));
+      } break;
+      case DATES: {
+        uint32_t value = load_big_endian(src);
+        memcpy(dst, &value, sizeof(value));
+      } break;
+      case FLOATS: {
+        uint32_t bits = load_big_endian(src);
+        bits = (bits & 0x80000000u) ? (bits & ~0x80000000u) : ~bits;
+        memcpy(dst, &bits, sizeof(bits));
+      } break;
+      default: {
+        memcpy(dst, src, attr_len);
+      } break;
+    }
+    offset += attr_len;
+  }
+}
+
+int calc_internal_page_capacity(int attr_length, int page_data_size)
 {
   int item_size = attr_length + sizeof(RID) + sizeof(PageNum);
 
-  int capacity = ((int)BP_PAGE_DATA_SIZE - InternalIndexNode::HEADER_SIZE) / item_size;
+  int capacity = (page_data_size - InternalIndexNode::HEADER_SIZE) / item_size;
   return capacity;
 }
 
-int calc_leaf_page_capacity(int attr_length)
+int calc_leaf_page_capacity(int attr_length, int page_data_size)
 {
   int item_size = attr_length + sizeof(RID) + sizeof(RID);
-  int capacity = ((int)BP_PAGE_DATA_SIZE - LeafIndexNode::HEADER_SIZE) / item_size;
+  int capacity = (page_data_size - LeafIndexNode::HEADER_SIZE) / item_size;
   return capacity;
 }
 
@@ -204,8 +303,10 @@ int LeafIndexNodeHandler::lookup(const KeyComparator &comparator, const char *ke
   const int size = this->size();
   common::BinaryIterator<char> iter_begin(item_size(), __key_at(0));
   common::BinaryIterator<char> iter_end(item_size(), __key_at(size));
-  common::BinaryIterator<char> iter = lower_bound(iter_begin, iter_end, key, comparator, found);
-  return iter - iter_begin;
+  return comparator.dispatch([&](const auto &typed_comparator) {
+    common::BinaryIterator<char> iter = lower_bound(iter_begin, iter_end, key, typed_comparator, found);
+    return static_cast<int>(iter - iter_begin);
+  });
 }
 
 void LeafIndexNodeHandler::insert(int index, const char *key, const char *value)
@@ -482,8 +583,10 @@ int InternalIndexNodeHandler::lookup(const KeyComparator &comparator, const char
 
   common::BinaryIterator<char> iter_begin(item_size(), __key_at(1));
   common::BinaryIterator<char> iter_end(item_size(), __key_at(size));
-  common::BinaryIterator<char> iter = lower_bound(iter_begin, iter_end, key, comparator, found);
-  int ret = static_cast<int>(iter - iter_begin) + 1;
+  int ret = comparator.dispatch([&](const auto &typed_comparator) {
+    common::BinaryIterator<char> iter = lower_bound(iter_begin, iter_end, key, typed_comparator, found);
+    return static_cast<int>(iter - iter_begin) + 1;
+  });
   if (insert_position) {
     *insert_position = ret;
   }
@@ -762,7 +865,7 @@ RC BplusTreeHandler::sync()
 }
 
 RC BplusTreeHandler::create(const char *file_name,std::vector<AttrType> &attr_types,std::vector<int32_t> &attr_lens, int internal_max_size /* = -1*/,
-    int leaf_max_size /* = -1 */)
+    int leaf_max_size /* = -1 */, int page_size /* = BP_PAGE_SIZE */)
 {
   DEBUG_PRINT("debug: 创建B+树索引句柄...\n");
   if (attr_types.size() != attr_lens.size()) {
@@ -770,7 +873,7 @@ RC BplusTreeHandler::create(const char *file_name,std::vector<AttrType> &attr_ty
   }
 
   BufferPoolManager &bpm = BufferPoolManager::instance();
-  RC rc = bpm.create_file(file_name);
+  RC rc = bpm.create_file(file_name, page_size);
   if (rc != RC::SUCCESS) {
     DEBUG_PRINT("debug: 创建索引文件失败！\n");
     LOG_WARN("Failed to create file. file name=%s, rc=%d:%s", file_name, rc, strrc(rc));
@@ -809,27 +912,29 @@ RC BplusTreeHandler::create(const char *file_name,std::vector<AttrType> &attr_ty
     lens += attr_len;
   }
   if (internal_max_size < 0) {
-    internal_max_size = calc_internal_page_capacity(lens);
+    internal_max_size = calc_internal_page_capacity(lens, bp->page_data_size());
   }
   if (leaf_max_size < 0) {
-    leaf_max_size = calc_leaf_page_capacity(lens);
+    leaf_max_size = calc_leaf_page_capacity(lens, bp->page_data_size());
   }
 
   char *pdata = header_frame->data();
   IndexFileHeader *file_header = (IndexFileHeader *)pdata;
+  file_header->magic = IndexFileHeader::MAGIC;
+  file_header->version = IndexFileHeader::VERSION;
   file_header->attrs_num = attr_lens.size();
   file_header->attrs_length = lens;
   file_header->key_length = lens + sizeof(RID);   // 总长加rid
   file_header->internal_max_size = internal_max_size;
   file_header->leaf_max_size = leaf_max_size;
   file_header->root_page = BP_INVALID_PAGE_NUM;
-  // 对好位置
-  file_header->attrs_lens = (int32_t*)(&file_header[1]);
-  file_header->attrs_type = (AttrType*)(&file_header[1] + file_header->attrs_num * sizeof(int32_t));
+  // 属性的长度和类型紧跟在文件头后面存放
+  int32_t *attrs_lens = (int32_t *)(pdata + sizeof(IndexFileHeader));
+  AttrType *attrs_type = (AttrType *)(pdata + sizeof(IndexFileHeader) + file_header->attrs_num * sizeof(int32_t));
   for (int i = 0; i < file_header->attrs_num; i++)
   {
-    file_header->attrs_lens[i] = attr_lens[i];
-    file_header->attrs_type[i] = attr_types[i];
+    attrs_lens[i] = attr_lens[i];
+    attrs_type[i] = attr_types[i];
   }
 
   header_frame->mark_dirty();
@@ -847,8 +952,7 @@ RC BplusTreeHandler::create(const char *file_name,std::vector<AttrType> &attr_ty
     return RC::NOMEM;
   }
 
-  key_comparator_.init(attr_types, attr_lens);
-  key_printer_.init(attr_types, attr_lens);
+  init_key_handlers(attr_types, attr_lens);
   this->sync();
 
   LOG_INFO("Successfully create index %s", file_name);
@@ -880,9 +984,18 @@ RC BplusTreeHandler::open(const char *file_name)
 
   char *pdata = frame->data();
   memcpy(&file_header_, pdata, sizeof(IndexFileHeader));
-  IndexFileHeader *f_header = (IndexFileHeader *)pdata;
-  file_header_.attrs_lens = (int32_t *)&f_header[0];  // 指向柔性数组对应位置
-  file_header_.attrs_type = (AttrType *)(&f_header[0] + file_header_.attrs_num * sizeof(int32_t));
+  if (file_header_.magic != IndexFileHeader::MAGIC || file_header_.version != IndexFileHeader::VERSION) {
+    LOG_ERROR("unsupported index file format of %s, it may be created by another version. "
+              "magic=%x, version=%d, expected magic=%x, version=%d",
+              file_name, file_header_.magic, file_header_.version, IndexFileHeader::MAGIC, IndexFileHeader::VERSION);
+    disk_buffer_pool->unpin_page(frame);
+    bpm.close_file(file_name);
+    return RC::FILE_VERSION_MISMATCH;
+  }
+  const int32_t *attrs_lens_data = (const int32_t *)(pdata + sizeof(IndexFileHeader));
+  const AttrType *attrs_type_data = (const AttrType *)(pdata + sizeof(IndexFileHeader) + file_header_.attrs_num * sizeof(int32_t));
+  std::vector<AttrType> attrs_type(attrs_type_data, attrs_type_data + file_header_.attrs_num);
+  std::vector<int32_t>  attrs_lens(attrs_lens_data, attrs_lens_data + file_header_.attrs_num);
   header_dirty_ = false;
   disk_buffer_pool_ = disk_buffer_pool;
 
@@ -895,20 +1008,24 @@ RC BplusTreeHandler::open(const char *file_name)
 
   // close old page_handle
   disk_buffer_pool->unpin_page(frame);
-  std::vector<AttrType> attrs_type;
-  std::vector<int32_t>  attrs_lens;
-  for (int i = 0; i < file_header_.attrs_num; i++)
-  {
-    attrs_type.emplace_back(file_header_.attrs_type[i]);
-    attrs_lens.emplace_back(file_header_.attrs_lens[i]);
-  }
 
-  key_comparator_.init(attrs_type, attrs_lens);
-  key_printer_.init(attrs_type, attrs_lens);
+  init_key_handlers(attrs_type, attrs_lens);
   LOG_INFO("Successfully open index %s", file_name);
   return RC::SUCCESS;
 }
 
+void BplusTreeHandler::init_key_handlers(const std::vector<AttrType> &attr_types, const std::vector<int32_t> &attr_lens)
+{
+  attr_types_ = attr_types;
+  attr_lens_  = attr_lens;
+  file_header_.attrs_type = attr_types_.data();
+  file_header_.attrs_lens = attr_lens_.data();
+
+  key_comparator_.init(attr_types_, attr_lens_);
+  key_normalizer_.init(attr_types_, attr_lens_, key_comparator_.kind() == KeyComparator::Kind::NORMALIZED);
+  key_printer_.init(attr_types_, attr_lens_, key_normalizer_);
+}
+
 RC BplusTreeHandler::close()
 {
   if (disk_buffer_pool_ != nullptr) {
@@ -1402,7 +1519,11 @@ MemPoolItem::unique_ptr BplusTreeHandler::make_key(const char *user_key, const R
     LOG_WARN("Failed to alloc memory for key.");
     return nullptr;
   }
-  memcpy(static_cast<char *>(key.get()), user_key, file_header_.attrs_length);
+  if (key_normalizer_.enabled()) {
+    key_normalizer_.normalize(user_key, static_cast<char *>(key.get()));
+  } else {
+    memcpy(static_cast<char *>(key.get()), user_key, file_header_.attrs_length);
+  }
   memcpy(static_cast<char *>(key.get()) + file_header_.attrs_length, &rid, sizeof(rid));
   return key;
 }
@@ -1457,6 +1578,85 @@ RC BplusTreeHandler::insert_entry(const char *user_key, const RID *rid)
   return RC::SUCCESS;
 }
 
+RC BplusTreeHandler::insert_entries(const std::vector<const char *> &user_keys, const std::vector<RID> &rids)
+{
+  const int entry_num = static_cast<int>(user_keys.size());
+  std::vector<MemPoolItem::unique_ptr> keys;
+  keys.reserve(entry_num);
+  for (int i = 0; i < entry_num; i++) {
+    keys.emplace_back(make_key(user_keys[i], rids[i]));
+    if (keys.back() == nullptr) {
+      LOG_WARN("Failed to alloc memory for key.");
+      return RC::NOMEM;
+    }
+  }
+
+  // 键值中包含RID，不会有相同的键值
+  std::vector<int> order(entry_num);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [this, &keys](int left, int right) {
+    return key_comparator_(static_cast<const char *>(keys[left].get()), static_cast<const char *>(keys[right].get())) < 0;
+  });
+
+  RC rc = RC::SUCCESS;
+  int i = 0;
+  while (i < entry_num) {
+    const char *key = static_cast<const char *>(keys[order[i]].get());
+    const RID  *rid = &rids[order[i]];
+    if (is_empty()) {
+      rc = insert_entry(user_keys[order[i]], rid);
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+      i++;
+      continue;
+    }
+
+    LatchMemo latch_memo(disk_buffer_pool_);
+    Frame *frame = nullptr;
+    rc = find_leaf(latch_memo, BplusTreeOperationType::INSERT, key, frame);
+    if (rc == RC::EMPTY) {
+      continue;
+    }
+    if (OB_FAIL(rc)) {
+      LOG_WARN("Failed to find leaf %s. rc=%d:%s", rid->to_string().c_str(), rc, strrc(rc));
+      return rc;
+    }
+
+    LeafIndexNodeHandler leaf_node(file_header_, frame);
+    const bool will_split = leaf_node.size() >= leaf_node.max_size();
+    rc = insert_entry_into_leaf_node(latch_memo, frame, key, rid);
+    if (OB_FAIL(rc)) {
+      LOG_TRACE("Failed to insert into leaf of index, rid:%s. rc=%s", rid->to_string().c_str(), strrc(rc));
+      return rc;
+    }
+    i++;
+    if (will_split) {
+      continue;
+    }
+
+    // 后面的键值更大。只要比叶子节点中最大的键值小(最右边的叶子节点没有上界)，就还属于这个叶子节点
+    for (; i < entry_num && leaf_node.size() < leaf_node.max_size(); i++) {
+      key = static_cast<const char *>(keys[order[i]].get());
+      rid = &rids[order[i]];
+      if (leaf_node.next_page() != BP_INVALID_PAGE_NUM &&
+          key_comparator_(key, leaf_node.key_at(leaf_node.size() - 1)) >= 0) {
+        break;
+      }
+
+      bool exists = false;
+      int insert_position = leaf_node.lookup(key_comparator_, key, &exists);
+      if (exists) {
+        LOG_TRACE("entry exists");
+        return RC::RECORD_DUPLICATE_KEY;
+      }
+      leaf_node.insert(insert_position, key, reinterpret_cast<const char *>(rid));
+      frame->mark_dirty();
+    }
+  }
+  return RC::SUCCESS;
+}
+
 RC BplusTreeHandler::get_entry(const char *user_key, int key_len, std::list<RID> &rids)
 {
   BplusTreeScanner scanner(*this);
@@ -1673,16 +1873,14 @@ RC BplusTreeHandler::delete_entry_internal(LatchMemo &latch_memo, Frame *leaf_fr
 
 RC BplusTreeHandler::delete_entry(const char *user_key, const RID *rid)
 {
-  MemPoolItem::unique_ptr pkey = mem_pool_item_->alloc_unique_ptr();
+  // 和插入时一样编码键值，否则多字段索引找不到要删除的条目
+  MemPoolItem::unique_ptr pkey = make_key(user_key, *rid);
   if (nullptr == pkey) {
     LOG_WARN("Failed to alloc memory for key. size=%d", file_header_.key_length);
     return RC::NOMEM;
   }
   char *key = static_cast<char *>(pkey.get());
 
-  memcpy(key, user_key, file_header_.attrs_length);
-  memcpy(key + file_header_.attrs_length, rid, sizeof(*rid));
-
   BplusTreeOperationType op = BplusTreeOperationType::DELETE;
   LatchMemo latch_memo(disk_buffer_pool_);
 
@@ -1742,7 +1940,10 @@ RC BplusTreeScanner::open(const char *left_user_key, int left_len, bool left_inc
     if (result > 0 ||  // left < right
                        // left == right but is (left,right)/[left,right) or (left,right]
         (result == 0 && (left_inclusive == false || right_inclusive == false))) {
-      return RC::INVALID_ARGUMENT;
+      // 空的扫描范围，比如 a > 5 and a < 3，直接返回空结果
+      LOG_TRACE("empty scan range");
+      current_frame_ = nullptr;
+      return RC::SUCCESS;
     }
   }
 
@@ -1870,10 +2071,19 @@ RC BplusTreeScanner::open(const char *left_user_key, int left_len, bool left_inc
   return RC::SUCCESS;
 }
 
-void BplusTreeScanner::fetch_item(RID &rid)
+void BplusTreeScanner::fetch_item(RID &rid, char *user_key)
 {
   LeafIndexNodeHandler node(tree_handler_.file_header_, current_frame_);
   memcpy(&rid, node.value_at(iter_index_), sizeof(rid));
+
+  if (user_key != nullptr) {
+    const char *key = node.key_at(iter_index_);
+    if (tree_handler_.key_normalizer_.enabled()) {
+      tree_handler_.key_normalizer_.denormalize(key, user_key);
+    } else {
+      memcpy(user_key, key, tree_handler_.file_header_.attrs_length);
+    }
+  }
 }
 
 bool BplusTreeScanner::touch_end()
@@ -1888,14 +2098,21 @@ bool BplusTreeScanner::touch_end()
   return compare_result > 0;
 }
 
-RC BplusTreeScanner::next_entry(RID &rid)
+RC BplusTreeScanner::next_entry(RID &rid, char *user_key /*= nullptr*/)
 {
+  if (suspended_) {
+    RC rc = resume();
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+
   if (nullptr == current_frame_) {
     return RC::RECORD_EOF;
   }
 
   if (!first_emitted_) {
-    fetch_item(rid);
+    fetch_item(rid, user_key);
     first_emitted_ = true;
     return RC::SUCCESS;
   }
@@ -1908,7 +2125,7 @@ RC BplusTreeScanner::next_entry(RID &rid)
       return RC::RECORD_EOF;
     }
 
-    fetch_item(rid);
+    fetch_item(rid, user_key);
     return RC::SUCCESS;
   }
 
@@ -1937,7 +2154,41 @@ RC BplusTreeScanner::next_entry(RID &rid)
 
   latch_memo_.release_to(memo_point);
   iter_index_ = -1; // `next` will add 1
-  return next_entry(rid);
+  return next_entry(rid, user_key);
+}
+
+RC BplusTreeScanner::suspend()
+{
+  if (nullptr == current_frame_ || !first_emitted_) {
+    return RC::SUCCESS;
+  }
+
+  LeafIndexNodeHandler node(tree_handler_.file_header_, current_frame_);
+  const char *key = node.key_at(iter_index_);
+  suspended_key_.assign(key, key + tree_handler_.file_header_.key_length);
+  latch_memo_.release();
+  current_frame_ = nullptr;
+  suspended_ = true;
+  return RC::SUCCESS;
+}
+
+RC BplusTreeScanner::resume()
+{
+  suspended_ = false;
+  RC rc = tree_handler_.find_leaf(latch_memo_, BplusTreeOperationType::READ, suspended_key_.data(), current_frame_);
+  if (rc == RC::EMPTY) {
+    current_frame_ = nullptr;
+    return RC::SUCCESS;
+  } else if (OB_FAIL(rc)) {
+    LOG_WARN("failed to find leaf page while resuming scan. rc=%s", strrc(rc));
+    current_frame_ = nullptr;
+    return rc;
+  }
+
+  // next_entry 会先把位置加1，所以这里定位到目标位置的前一个
+  LeafIndexNodeHandler node(tree_handler_.file_header_, current_frame_);
+  iter_index_ = node.lookup(tree_handler_.key_comparator_, suspended_key_.data()) - 1;
+  return RC::SUCCESS;
 }
 
 RC BplusTreeScanner::close()
@@ -1957,34 +2208,37 @@ RC BplusTreeScanner::fix_user_key(
 
   // 这里很粗暴，变长字段才需要做调整，其它默认都不需要做调整
   // assert(tree_handler_.file_header_.attr_type == CHARS);
-  assert(strlen(user_key) >= static_cast<size_t>(key_len));
-
   *should_inclusive = false;
 
-  int32_t attrs_length = tree_handler_.file_header_.attrs_length;
+  const IndexFileHeader &file_header = tree_handler_.file_header_;
+  int32_t attrs_length = file_header.attrs_length;
   char *key_buf = new (std::nothrow) char[attrs_length];
   if (nullptr == key_buf) {
     return RC::NOMEM;
   }
 
-  if (key_len <= attrs_length) {
+  if (file_header.attrs_num > 1) {
+    // 多列索引的键值已经按照各个属性的长度拼接好，只需要把字符串结束符之后的内容填充为0
     int offset = 0;
-    for (int i = 0; i < tree_handler_.file_header_.attrs_num; i++) {
-      int attr_len = tree_handler_.file_header_.attrs_lens[i];
-      if (tree_handler_.file_header_.attrs_type[i] != CHARS) {
-        memcpy(key_buf, user_key + offset, attr_len);
-        user_key += attr_len;
+    for (int i = 0; i < file_header.attrs_num; i++) {
+      const int attr_len = file_header.attrs_lens[i];
+      if (file_header.attrs_type[i] == CHARS) {
+        const int s_len = static_cast<int>(strnlen(user_key + offset, attr_len));
+        memcpy(key_buf + offset, user_key + offset, s_len);
+        memset(key_buf + offset + s_len, 0, attr_len - s_len);
       } else {
-        int s_len = strlen(user_key + offset);
-        memcpy(key_buf, user_key + offset, s_len);
-        memset(key_buf + s_len, 0, attr_len - s_len);
-        user_key += s_len;
+        memcpy(key_buf + offset, user_key + offset, attr_len);
       }
-      key_buf += attr_len;
+      offset += attr_len;
     }
-    // memcpy(key_buf, user_key, key_len);
-    // memset(key_buf + key_len, 0, attr_length - key_len);
+    *fixed_key = key_buf;
+    return RC::SUCCESS;
+  }
 
+  if (key_len <= attrs_length) {
+    const int s_len = static_cast<int>(strnlen(user_key, key_len));
+    memcpy(key_buf, user_key, s_len);
+    memset(key_buf + s_len, 0, attrs_length - s_len);
     *fixed_key = key_buf;
     return RC::SUCCESS;
   }
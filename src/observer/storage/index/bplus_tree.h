@@ -21,6 +21,7 @@ See the Mulan PSL v2 for more details. */
 #include <sstream>
 #include <functional>
 #include <memory>
+#include <vector>
 
 #include "storage/record/record_manager.h"
 #include "storage/buffer/disk_buffer_pool.h"
@@ -90,47 +91,169 @@ private:
   int attr_length_;
 };
 
+/**
+ * @brief 键值规范化(BplusTree)
+ * @details 写入B+树的键值会被编码成可以直接使用memcmp比较的格式：
+ * 整数按大端序存放并翻转符号位，浮点数转换为保序的无符号整数位模式，
+ * 字符串在第一个'\0'之后全部填充为0。这样节点内的二分查找不再需要按属性类型分派。
+ * 单列INTS/DATES的索引不做编码，直接使用模板特化的比较器。
+ * @ingroup BPlusTree
+ */
+class KeyNormalizer 
+{
+public:
+  void init(const std::vector<AttrType> &types, const std::vector<int32_t> &lengths, bool enabled);
+
+  bool enabled() const
+  {
+    return enabled_;
+  }
+
+  /**
+   * @brief 将用户键值(多个属性拼接而成)编码到key中
+   * @details key 与 user_key 的长度相同，都是所有属性长度之和
+   */
+  void normalize(const char *user_key, char *key) const;
+
+  /**
+   * @brief normalize 的逆操作，将编码后的键值还原成用户键值
+   */
+  void denormalize(const char *key, char *user_key) const;
+
+private:
+  bool enabled_ = false;
+  std::vector<AttrType> attr_types_;
+  std::vector<int32_t>  attr_lens_;
+};
+
+/**
+ * @brief 单列定长键值的比较(BplusTree)
+ * @details 用于单列INTS/DATES索引，直接按照数值比较，再比较RID
+ * @ingroup BPlusTree
+ */
+template <typename T>
+class FixedKeyComparator 
+{
+public:
+  int operator()(const char *v1, const char *v2) const
+  {
+    T left;
+    T right;
+    memcpy(&left, v1, sizeof(T));
+    memcpy(&right, v2, sizeof(T));
+    if (left < right) {
+      return -1;
+    }
+    if (left > right) {
+      return 1;
+    }
+    return RID::compare((const RID *)(v1 + sizeof(T)), (const RID *)(v2 + sizeof(T)));
+  }
+};
+
+/**
+ * @brief 规范化键值的比较(BplusTree)
+ * @details 属性部分使用一次memcmp比较，再比较RID
+ * @ingroup BPlusTree
+ */
+class MemcmpKeyComparator 
+{
+public:
+  explicit MemcmpKeyComparator(int attrs_length = 0) : attrs_length_(attrs_length)
+  {}
+
+  int operator()(const char *v1, const char *v2) const
+  {
+    int result = memcmp(v1, v2, attrs_length_);
+    if (result != 0) {
+      return result;
+    }
+    return RID::compare((const RID *)(v1 + attrs_length_), (const RID *)(v2 + attrs_length_));
+  }
+
+private:
+  int attrs_length_;
+};
+
 /**
  * @brief 键值比较(BplusTree)
  * @details BplusTree的键值除了字段属性，还有RID，是为了避免属性值重复而增加的。
+ * 根据索引的属性类型选择具体的比较器，热点路径(比如节点内的二分查找)可以通过 dispatch
+ * 拿到具体类型的比较器，避免每次比较都做类型分派。
  * @ingroup BPlusTree
  */
 class KeyComparator 
 {
+public:
+  enum class Kind
+  {
+    INT,         ///< 单列INTS，未编码
+    DATE,        ///< 单列DATES，未编码
+    NORMALIZED,  ///< 其它情况，键值经过 KeyNormalizer 编码
+  };
+
 public:
   void init(std::vector<AttrType> &types, std::vector<int32_t> lengths)
   {
-    for (int i = 0; i < types.size(); i++) {
+    attr_cmptors_.clear();
+    int attrs_length = 0;
+    for (size_t i = 0; i < types.size(); i++) {
       AttrComparator attr_cmptor;
       attr_cmptor.init(types[i], lengths[i]);
       attr_cmptors_.emplace_back(attr_cmptor);
+      attrs_length += lengths[i];
     }
+
+    if (types.size() == 1 && types[0] == INTS) {
+      kind_ = Kind::INT;
+    } else if (types.size() == 1 && types[0] == DATES) {
+      kind_ = Kind::DATE;
+    } else {
+      kind_ = Kind::NORMALIZED;
+    }
+    memcmp_cmptor_ = MemcmpKeyComparator(attrs_length);
   }
 
+  Kind kind() const
+  {
+    return kind_;
+  }
+
+  /**
+   * @brief 比较用户键值(未编码)时使用的属性比较器
+   */
   const std::vector<AttrComparator> &attr_comparators() const
   {
     return attr_cmptors_;
   }
 
-  // TODO
-  int operator()(const char *v1, const char *v2) const    // ?
+  /**
+   * @brief 使用具体类型的比较器调用func
+   */
+  template <typename Func>
+  decltype(auto) dispatch(Func &&func) const
   {
-    int result =  0;
-    int offset = 0;
-    for (const AttrComparator &attr_comparator : attr_cmptors_) {
-      result = attr_comparator(v1 + offset, v2 + offset);
-      if (result != 0) {
-        return result;
+    switch (kind_) {
+      case Kind::INT: {
+        return func(FixedKeyComparator<int32_t>());
+      }
+      case Kind::DATE: {
+        return func(FixedKeyComparator<uint32_t>());
+      }
+      default: {
+        return func(memcmp_cmptor_);
       }
-      offset += attr_comparator.attr_length();
     }
+  }
 
-    const RID *rid1 = (const RID *)(v1 + offset);
-    const RID *rid2 = (const RID *)(v2 + offset);
-    return RID::compare(rid1, rid2);
+  int operator()(const char *v1, const char *v2) const
+  {
+    return dispatch([v1, v2](const auto &comparator) { return comparator(v1, v2); });
   }
 
 private:
+  Kind kind_ = Kind::NORMALIZED;
+  MemcmpKeyComparator memcmp_cmptor_;
   std::vector<AttrComparator> attr_cmptors_;
 };
 
@@ -161,6 +284,9 @@ public:
       case FLOATS: {
         return std::to_string(*(float *)v);
       }
+      case DATES: {
+        return std::to_string(*(uint32_t *)v);
+      }
       case CHARS: {
         std::string str;
         for (int i = 0; i < attr_length_; i++) {
@@ -194,14 +320,18 @@ public:
   // {
   //   attr_printer_.init(type, length);
   // }
-  void init(std::vector<AttrType> &types, std::vector<int32_t> lengths)
+  void init(std::vector<AttrType> &types, std::vector<int32_t> lengths, const KeyNormalizer &normalizer)
   {
-    for (int i = 0; i < types.size(); i++) 
+    attr_printers_.clear();
+    attrs_length_ = 0;
+    for (size_t i = 0; i < types.size(); i++) 
     {
       AttrPrinter attr_printer;
       attr_printer.init(types[i], lengths[i]);
       attr_printers_.emplace_back(attr_printer);
+      attrs_length_ += lengths[i];
     }
+    normalizer_ = normalizer;
   }
 
   // const AttrPrinter &attr_printer() const
@@ -219,10 +349,16 @@ public:
   {
     std::stringstream ss;
     ss << "{key:";
-    
+
+    // 编码过的键值需要先还原才能打印
+    std::vector<char> user_key(v, v + attrs_length_);
+    if (normalizer_.enabled()) {
+      normalizer_.denormalize(v, user_key.data());
+    }
+
     int offset = 0;
     for (const AttrPrinter& attr_printer : attr_printers_) {
-      ss << attr_printer(v + offset) << ",";
+      ss << attr_printer(user_key.data() + offset) << ",";
       offset += attr_printer.attr_length();
     }
 
@@ -234,6 +370,8 @@ public:
 private:
   // AttrPrinter attr_printer_;
   std::vector<AttrPrinter>  attr_printers_;
+  int attrs_length_ = 0;
+  KeyNormalizer normalizer_;
 };
 
 /**
@@ -241,14 +379,21 @@ private:
  * @ingroup BPlusTree
  * @details this is the first page of bplus tree.
  * only one field can be supported, can you extend it to multi-fields?
+ * 节点的布局或者键值的编码方式(参考 KeyNormalizer)变化时要修改 VERSION，
+ * 打开版本不同的索引文件会返回 FILE_VERSION_MISMATCH。
  */
 struct IndexFileHeader 
 {
+  static constexpr int32_t MAGIC   = 0x58444E49;  // "INDX"
+  static constexpr int32_t VERSION = 1;
+
   IndexFileHeader()
   {
     memset(this, 0, sizeof(IndexFileHeader));
     root_page = BP_INVALID_PAGE_NUM;
   }
+  int32_t magic;              ///< 固定为 MAGIC，用来识别索引文件
+  int32_t version;            ///< 创建索引时节点和键值格式的版本
   PageNum root_page;          ///< 根节点在磁盘中的页号
   int32_t internal_max_size;  ///< 内部节点最大的键值对数
   int32_t leaf_max_size;      ///< 叶子节点最大的键值对数
@@ -263,7 +408,8 @@ struct IndexFileHeader
   {
     std::stringstream ss;
 
-    ss << "attr_length:" << attrs_length << ","
+    ss << "version:" << version << ","
+       << "attr_length:" << attrs_length << ","
        << "key_length:" << key_length << ",";
 
     ss << "attr_type:";
@@ -504,12 +650,14 @@ public:
   /**
    * 此函数创建一个名为fileName的索引。
    * attrType描述被索引属性的类型，attrLength描述被索引属性的长度
+   * page_size是索引文件的页面大小，没有指定节点最多的键值对数时，按照页面大小计算
    */
   RC create(const char *file_name, 
             std::vector<AttrType> & attr_type, 
             std::vector<int32_t> & attr_length, 
             int internal_max_size = -1, 
-            int leaf_max_size = -1);
+            int leaf_max_size = -1,
+            int page_size = BP_PAGE_SIZE);
 
   /**
    * 打开名为fileName的索引文件。
@@ -531,6 +679,15 @@ public:
    */
   RC insert_entry(const char *user_key, const RID *rid);
 
+  /**
+   * @brief 插入多个索引项
+   * @details 先按照键值排序再插入。相邻的键值通常在同一个叶子节点上，如果叶子节点不需要分裂，
+   * 就在持有叶子节点锁的时候直接插入，不再从根节点查找。失败时已经插入的索引项不会删除
+   * @param user_keys 每个索引项的属性值
+   * @param rids      每个索引项对应的记录，与 user_keys 一一对应
+   */
+  RC insert_entries(const std::vector<const char *> &user_keys, const std::vector<RID> &rids);
+
   /**
    * 从IndexHandle句柄对应的索引中删除一个值为（*pData，rid）的索引项
    * @return RECORD_INVALID_KEY 指定值不存在
@@ -606,6 +763,12 @@ protected:
   RC adjust_root(LatchMemo &latch_memo, Frame *root_frame);
 
 private:
+  void init_key_handlers(const std::vector<AttrType> &attr_types, const std::vector<int32_t> &attr_lens);
+
+  /**
+   * @brief 使用用户键值与RID生成B+树中的键值
+   * @details 如果需要，属性部分会经过 KeyNormalizer 编码
+   */
   common::MemPoolItem::unique_ptr make_key(const char *user_key, const RID &rid);
   void free_key(char *key);
 
@@ -618,7 +781,11 @@ protected:
   // 这个锁可以使用递归读写锁，但是这里偷懒先不改
   common::SharedMutex   root_lock_;
 
+  std::vector<AttrType> attr_types_;  ///< 各个属性的类型，file_header_.attrs_type 指向这里
+  std::vector<int32_t>  attr_lens_;   ///< 各个属性的长度，file_header_.attrs_lens 指向这里
+
   KeyComparator   key_comparator_;
+  KeyNormalizer   key_normalizer_;
   // std::vector<KeyComparator> key_cmptors_;
   KeyPrinter      key_printer_;
   // std::vector<KeyPrinter> key_printers_;
@@ -652,17 +819,32 @@ public:
   RC open(const char *left_user_key, int left_len, bool left_inclusive, 
           const char *right_user_key, int right_len, bool right_inclusive);
 
-  RC next_entry(RID &rid);
+  /**
+   * @brief 获取下一条索引项
+   * @param rid      返回索引项对应的记录
+   * @param user_key 如果不为空，同时返回索引项的键值，也就是按照索引字段顺序拼接的字段原始值，
+   *                 可以用来在不访问表数据的情况下获取索引字段的值
+   */
+  RC next_entry(RID &rid, char *user_key = nullptr);
+
+  /**
+   * @brief 释放扫描时持有的页面锁，下次调用 next_entry 时重新返回最近一次返回的索引项
+   * @details 用于等待行锁。暂停期间树可能被修改(比如叶子节点分裂)，所以恢复时按照最近一次返回的
+   * 索引项的键值(包含RID)重新查找叶子节点，如果这一项已经被删除，就从它之后的索引项继续
+   */
+  RC suspend();
 
   RC close();
 
 private:
+  RC resume();
+
   /**
    * 如果key的类型是CHARS, 扩展或缩减user_key的大小刚好是schema中定义的大小
    */
   RC fix_user_key(const char *user_key, int key_len, bool want_greater, char **fixed_key, bool *should_inclusive);
 
-  void fetch_item(RID &rid);
+  void fetch_item(RID &rid, char *user_key);
   bool touch_end();
 
 private:
@@ -678,4 +860,7 @@ private:
   common::MemPoolItem::unique_ptr right_key_;
   int iter_index_ = -1;
   bool first_emitted_ = false;
+
+  bool              suspended_ = false;
+  std::vector<char> suspended_key_;  ///< 暂停时最近一次返回的索引项的键值
 };
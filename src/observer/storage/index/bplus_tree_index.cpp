@@ -20,7 +20,8 @@ BplusTreeIndex::~BplusTreeIndex() noexcept
   close();
 }
 
-RC BplusTreeIndex::create(const char *file_name, const IndexMeta &index_meta, std::vector<const FieldMeta *> &field_metas)
+RC BplusTreeIndex::create(const char *file_name, const IndexMeta &index_meta, std::vector<const FieldMeta *> &field_metas,
+    int page_size /* = BP_PAGE_SIZE */)
 {
   DEBUG_PRINT("debug: 创建B+树索引...\n");
   if (inited_) {
@@ -43,7 +44,7 @@ RC BplusTreeIndex::create(const char *file_name, const IndexMeta &index_meta, st
     attr_types.emplace_back(p->type());
     attr_lens.emplace_back(p->len());
   }
-  RC rc = index_handler_.create(file_name, attr_types, attr_lens);
+  RC rc = index_handler_.create(file_name, attr_types, attr_lens, -1 /*internal_max_size*/, -1 /*leaf_max_size*/, page_size);
   if (RC::SUCCESS != rc) {
     LOG_WARN("Failed to create index_handler, file_name:%s, index:%s, field:%s, rc:%s",
         file_name,
@@ -118,6 +119,27 @@ RC BplusTreeIndex::insert_entry(const char *record, const RID *rid)
   return index_handler_.insert_entry(key, rid);
 }
 
+RC BplusTreeIndex::insert_entries(const std::vector<const char *> &records, const std::vector<RID> &rids)
+{
+  if (attrs_lens_ <= 0) {
+    return RC::INTERNAL;
+  }
+
+  std::vector<char>         key_buffer(static_cast<size_t>(attrs_lens_) * records.size());
+  std::vector<const char *> keys(records.size());
+  for (size_t i = 0; i < records.size(); i++) {
+    char *key = key_buffer.data() + i * attrs_lens_;
+    int offset = 0;
+    for (FieldMeta &field_meta : field_metas_) {
+      memcpy(key + offset, records[i] + field_meta.offset(), field_meta.len());
+      offset += field_meta.len();
+    }
+    keys[i] = key;
+  }
+
+  return index_handler_.insert_entries(keys, rids);
+}
+
 RC BplusTreeIndex::delete_entry(const char *record, const RID *rid)
 {
   if (attrs_lens_ <= 0) {
@@ -172,6 +194,16 @@ RC BplusTreeIndexScanner::next_entry(RID *rid)
   return tree_scanner_.next_entry(*rid);
 }
 
+RC BplusTreeIndexScanner::next_entry(RID *rid, char *key)
+{
+  return tree_scanner_.next_entry(*rid, key);
+}
+
+RC BplusTreeIndexScanner::suspend()
+{
+  return tree_scanner_.suspend();
+}
+
 RC BplusTreeIndexScanner::destroy()
 {
   delete this;
@@ -27,11 +27,16 @@ public:
   BplusTreeIndex() = default;
   virtual ~BplusTreeIndex() noexcept;
 
-  RC create(const char *file_name, const IndexMeta &index_meta, std::vector<const FieldMeta *> &field_metas);
+  /**
+   * @param page_size 索引文件的页面大小，与表的数据文件相同
+   */
+  RC create(const char *file_name, const IndexMeta &index_meta, std::vector<const FieldMeta *> &field_metas,
+      int page_size = BP_PAGE_SIZE);
   RC open(const char *file_name, const IndexMeta &index_meta, std::vector<const FieldMeta *> &field_meta);
   RC close();
 
   RC insert_entry(const char *record, const RID *rid) override;
+  RC insert_entries(const std::vector<const char *> &records, const std::vector<RID> &rids) override;
   RC delete_entry(const char *record, const RID *rid) override;
 
   /**
@@ -58,6 +63,8 @@ public:
   ~BplusTreeIndexScanner() noexcept override;
 
   RC next_entry(RID *rid) override;
+  RC next_entry(RID *rid, char *key) override;
+  RC suspend() override;
   RC destroy() override;
 
   RC open(const char *left_key, int left_len, bool left_inclusive, const char *right_key, int right_len,
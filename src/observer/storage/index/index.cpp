@@ -12,8 +12,32 @@ See the Mulan PSL v2 for more details. */
 // Created by wangyunlai.wyl on 2021/5/19.
 //
 
+#include <string.h>
+
 #include "storage/index/index.h"
 
+/**
+ * @brief 字段值在索引中是否被当作相同的值
+ */
+static bool same_field_value(const FieldMeta &field_meta, const char *value1, const char *value2)
+{
+  switch (field_meta.type()) {
+    case CHARS: {
+      return 0 == strncmp(value1, value2, field_meta.len());
+    }
+    case FLOATS: {
+      float float1;
+      float float2;
+      memcpy(&float1, value1, sizeof(float1));
+      memcpy(&float2, value2, sizeof(float2));
+      return float1 == float2 || 0 == memcmp(value1, value2, sizeof(float1));
+    }
+    default: {
+      return 0 == memcmp(value1, value2, field_meta.len());
+    }
+  }
+}
+
 RC Index::init(const IndexMeta &index_meta, std::vector<const FieldMeta*> &field_metas)
 {
   index_meta_ = index_meta;
@@ -24,3 +48,36 @@ RC Index::init(const IndexMeta &index_meta, std::vector<const FieldMeta*> &field
   }
   return RC::SUCCESS;
 }
+
+bool Index::same_key(const char *record1, const char *record2) const
+{
+  for (const FieldMeta &field_meta : field_metas_) {
+    if (!same_field_value(field_meta, record1 + field_meta.offset(), record2 + field_meta.offset())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool Index::key_matches(const char *key, const char *record) const
+{
+  int key_offset = 0;
+  for (const FieldMeta &field_meta : field_metas_) {
+    if (!same_field_value(field_meta, key + key_offset, record + field_meta.offset())) {
+      return false;
+    }
+    key_offset += field_meta.len();
+  }
+  return true;
+}
+
+RC Index::insert_entries(const std::vector<const char *> &records, const std::vector<RID> &rids)
+{
+  for (size_t i = 0; i < records.size(); i++) {
+    RC rc = insert_entry(records[i], &rids[i]);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
@@ -45,6 +45,14 @@ public:
     return index_meta_;
   }
 
+  /**
+   * @brief 索引包含的字段，按照索引中的顺序排列
+   */
+  const std::vector<FieldMeta> &field_metas() const
+  {
+    return field_metas_;
+  }
+
   /**
    * @brief 插入一条数据
    * 
@@ -53,6 +61,14 @@ public:
    */
   virtual RC insert_entry(const char *record, const RID *rid) = 0;
 
+  /**
+   * @brief 插入多条数据
+   * @details 默认一条一条插入。失败时已经插入的数据不会删除
+   * @param records 插入的记录
+   * @param rids    每条记录的位置，与 records 一一对应
+   */
+  virtual RC insert_entries(const std::vector<const char *> &records, const std::vector<RID> &rids);
+
   /**
    * @brief 删除一条数据
    * 
@@ -61,6 +77,17 @@ public:
    */
   virtual RC delete_entry(const char *record, const RID *rid) = 0;
 
+  /**
+   * @brief 两条记录在这个索引上的键值是否相同
+   * @details 与索引中键值的比较方式一致：字符串只比较结束符之前的内容，浮点数 0.0 与 -0.0 相同
+   */
+  bool same_key(const char *record1, const char *record2) const;
+
+  /**
+   * @brief 索引的键值(参考 IndexScanner::next_entry)是否就是这条记录的键值
+   */
+  bool key_matches(const char *key, const char *record) const;
+
   /**
    * @brief 创建一个索引数据的扫描器
    * 
@@ -86,7 +113,7 @@ protected:
 protected:
   IndexMeta index_meta_;  ///< 索引的元数据
   std::vector<FieldMeta> field_metas_;  // 多个字段
-  int attrs_lens_;   // TODO
+  int attrs_lens_ = 0;   // 所有索引字段长度之和
   // FieldMeta field_meta_;  ///< 当前实现仅考虑一个字段的索引
 };
 
@@ -105,5 +132,18 @@ public:
    * 如果没有更多的元素，返回RECORD_EOF
    */
   virtual RC next_entry(RID *rid) = 0;
+
+  /**
+   * @brief 遍历元素数据，同时返回索引的键值
+   * @details 键值是按照索引字段顺序拼接的各个字段的原始值，长度是所有索引字段长度之和。
+   * 索引覆盖了查询需要的所有字段时，可以直接使用键值而不需要再访问表数据
+   */
+  virtual RC next_entry(RID *rid, char *key) = 0;
+
+  /**
+   * @brief 释放扫描过程中持有的页面锁，下次遍历时重新返回最近一次返回的元素
+   * @details 在等待行锁之前调用，参考 LockManager
+   */
+  virtual RC suspend() = 0;
   virtual RC destroy() = 0;
 };
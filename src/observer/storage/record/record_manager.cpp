@@ -16,6 +16,7 @@ See the Mulan PSL v2 for more details. */
 #include "common/lang/bitmap.h"
 #include "storage/common/condition_filter.h"
 #include "storage/trx/trx.h"
+#include "session/statement_counters.h"
 
 using namespace common;
 
@@ -50,6 +51,41 @@ int page_record_capacity(int page_size, int record_size)
  */
 int page_bitmap_size(int record_capacity) { return (record_capacity + 7) / 8; }
 
+/**
+ * @brief 按照指定的记录个数，计算PAX页面上每个minipage的位置
+ * @details 每个minipage都从8字节对齐的位置开始
+ *
+ * @param columns         每个字段的描述，这里会设置 minipage_offset
+ * @param record_capacity 页面上存放的记录个数
+ * @return 最后一个minipage的结束位置
+ */
+int pax_page_layout(PaxColumn *columns, int column_num, int record_capacity)
+{
+  int offset = PAGE_HEADER_SIZE + column_num * sizeof(PaxColumn) + page_bitmap_size(record_capacity);
+  for (int i = 0; i < column_num; i++) {
+    offset                     = align8(offset);
+    columns[i].minipage_offset = offset;
+    offset += columns[i].len * record_capacity;
+  }
+  return offset;
+}
+
+/**
+ * @brief 页面上bitmap的位置，前面是页头和字段的描述
+ */
+int page_bitmap_offset(const PageHeader *page_header)
+{
+  switch (page_header->page_format) {
+    case VARLEN_PAGE:
+    case OVERFLOW_PAGE: {
+      return PAGE_HEADER_SIZE + sizeof(VarlenPageHeader) + page_header->column_num * sizeof(VarcharColumn);
+    } break;
+    default: {
+      return PAGE_HEADER_SIZE + page_header->column_num * sizeof(PaxColumn);
+    } break;
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 RecordPageIterator::RecordPageIterator() {}
 RecordPageIterator::~RecordPageIterator() {}
@@ -60,6 +96,10 @@ void RecordPageIterator::init(RecordPageHandler &record_page_handler, SlotNum st
   page_num_            = record_page_handler.get_page_num();
   bitmap_.init(record_page_handler.bitmap_, record_page_handler.page_header_->record_capacity);
   next_slot_num_ = bitmap_.next_setted_bit(start_slot_num);
+  if (record_page_handler.page_format() == OVERFLOW_PAGE) {
+    // 溢出页面上的记录通过原来页面上的RID访问
+    next_slot_num_ = -1;
+  }
 }
 
 bool RecordPageIterator::has_next() { return -1 != next_slot_num_; }
@@ -67,12 +107,20 @@ bool RecordPageIterator::has_next() { return -1 != next_slot_num_; }
 RC RecordPageIterator::next(Record &record)
 {
   record.set_rid(page_num_, next_slot_num_);
-  record.set_data(record_page_handler_->get_record_data(record.rid().slot_num));
+  if (next_slot_num_ < 0) {
+    return RC::RECORD_EOF;
+  }
+
+  record.set_data(record_page_handler_->load_record(next_slot_num_));
+  next_slot_num_ = bitmap_.next_setted_bit(next_slot_num_ + 1);
+  return RC::SUCCESS;
+}
 
+void RecordPageIterator::skip()
+{
   if (next_slot_num_ >= 0) {
     next_slot_num_ = bitmap_.next_setted_bit(next_slot_num_ + 1);
   }
-  return record.rid().slot_num != -1 ? RC::SUCCESS : RC::RECORD_EOF;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -80,6 +128,17 @@ RC RecordPageIterator::next(Record &record)
 RecordPageHandler::~RecordPageHandler() { cleanup(); }
 
 RC RecordPageHandler::init(DiskBufferPool &buffer_pool, PageNum page_num, bool readonly)
+{
+  return init_page(buffer_pool, page_num, readonly, true /*latch*/, true /*check_version*/);
+}
+
+RC RecordPageHandler::init_latched(DiskBufferPool &buffer_pool, PageNum page_num)
+{
+  return init_page(buffer_pool, page_num, false /*readonly*/, false /*latch*/, true /*check_version*/);
+}
+
+RC RecordPageHandler::init_page(
+    DiskBufferPool &buffer_pool, PageNum page_num, bool readonly, bool latch, bool check_version)
 {
   if (disk_buffer_pool_ != nullptr) {
     LOG_WARN("Disk buffer pool has been opened for page_num %d.", page_num);
@@ -95,15 +154,34 @@ RC RecordPageHandler::init(DiskBufferPool &buffer_pool, PageNum page_num, bool r
   char *data = frame_->data();
 
   if (readonly) {
-    frame_->read_latch();
+    if (latch) {
+      frame_->read_latch();
+    }
   } else {
-    frame_->write_latch();
+    if (latch) {
+      frame_->write_latch();
+    }
+    // 以写模式访问页面，记录可能会被修改，不能再认为是全部可见的
+    frame_->clear_all_visible();
   }
   disk_buffer_pool_ = &buffer_pool;
   readonly_         = readonly;
+  latched_          = latch;
   page_header_      = (PageHeader *)(data);
-  bitmap_           = data + PAGE_HEADER_SIZE;
-  
+  pax_columns_      = (PaxColumn *)(data + PAGE_HEADER_SIZE);
+  varlen_header_    = (VarlenPageHeader *)(data + PAGE_HEADER_SIZE);
+  varchar_columns_  = (VarcharColumn *)(data + PAGE_HEADER_SIZE + sizeof(VarlenPageHeader));
+  bitmap_           = data + page_bitmap_offset(page_header_);
+  row_buffer_slot_  = -1;
+
+  if (check_version && (page_header_->magic != PageHeader::MAGIC || page_header_->version != PageHeader::VERSION)) {
+    LOG_ERROR("unsupported record page format, it may be written by another version. "
+              "page_num=%d, magic=%x, version=%d, expected magic=%x, version=%d",
+              page_num, page_header_->magic, page_header_->version, PageHeader::MAGIC, PageHeader::VERSION);
+    cleanup();
+    return RC::FILE_VERSION_MISMATCH;
+  }
+
   LOG_TRACE("Successfully init page_num %d.", page_num);
   return ret;
 }
@@ -124,10 +202,16 @@ RC RecordPageHandler::recover_init(DiskBufferPool &buffer_pool, PageNum page_num
   char *data = frame_->data();
 
   frame_->write_latch();
+  frame_->clear_all_visible();
   disk_buffer_pool_ = &buffer_pool;
   readonly_         = false;
+  latched_          = true;
   page_header_      = (PageHeader *)(data);
-  bitmap_           = data + PAGE_HEADER_SIZE;
+  pax_columns_      = (PaxColumn *)(data + PAGE_HEADER_SIZE);
+  varlen_header_    = (VarlenPageHeader *)(data + PAGE_HEADER_SIZE);
+  varchar_columns_  = (VarcharColumn *)(data + PAGE_HEADER_SIZE + sizeof(VarlenPageHeader));
+  bitmap_           = data + page_bitmap_offset(page_header_);
+  row_buffer_slot_  = -1;
 
   buffer_pool.recover_page(page_num);
 
@@ -137,20 +221,24 @@ RC RecordPageHandler::recover_init(DiskBufferPool &buffer_pool, PageNum page_num
 
 RC RecordPageHandler::init_empty_page(DiskBufferPool &buffer_pool, PageNum page_num, int record_size)
 {
-  RC ret = init(buffer_pool, page_num, false /*readonly*/);
+  RC ret = init_page(buffer_pool, page_num, false /*readonly*/, true /*latch*/, false /*check_version*/);
   if (ret != RC::SUCCESS) {
     LOG_ERROR("Failed to init empty page page_num:record_size %d:%d.", page_num, record_size);
     return ret;
   }
 
+  page_header_->magic               = PageHeader::MAGIC;
+  page_header_->version             = PageHeader::VERSION;
   page_header_->record_num          = 0;
   page_header_->record_real_size    = record_size;
   page_header_->record_size         = align8(record_size);
-  page_header_->record_capacity     = page_record_capacity(BP_PAGE_DATA_SIZE, page_header_->record_size);
+  page_header_->record_capacity     = page_record_capacity(frame_->data_size(), page_header_->record_size);
   page_header_->first_record_offset = align8(PAGE_HEADER_SIZE + page_bitmap_size(page_header_->record_capacity));
+  page_header_->page_format         = ROW_PAGE;
+  page_header_->column_num          = 0;
   this->fix_record_capacity();
   ASSERT(page_header_->first_record_offset + 
-         page_header_->record_capacity * page_header_->record_size <= BP_PAGE_DATA_SIZE, "Record overflow the page size");
+         page_header_->record_capacity * page_header_->record_size <= frame_->data_size(), "Record overflow the page size");
 
   bitmap_ = frame_->data() + PAGE_HEADER_SIZE;
   memset(bitmap_, 0, page_bitmap_size(page_header_->record_capacity));
@@ -163,10 +251,122 @@ RC RecordPageHandler::init_empty_page(DiskBufferPool &buffer_pool, PageNum page_
   return RC::SUCCESS;
 }
 
+RC RecordPageHandler::init_empty_pax_page(
+    DiskBufferPool &buffer_pool, PageNum page_num, const std::vector<PaxColumn> &columns)
+{
+  int record_size = 0;
+  for (const PaxColumn &column : columns) {
+    record_size += column.len;
+  }
+
+  RC ret = init_page(buffer_pool, page_num, false /*readonly*/, true /*latch*/, false /*check_version*/);
+  if (ret != RC::SUCCESS) {
+    LOG_ERROR("Failed to init empty pax page page_num:record_size %d:%d.", page_num, record_size);
+    return ret;
+  }
+
+  const int column_num = static_cast<int>(columns.size());
+  pax_columns_         = (PaxColumn *)(frame_->data() + PAGE_HEADER_SIZE);
+  memcpy(pax_columns_, columns.data(), column_num * sizeof(PaxColumn));
+
+  // 与行存一样估算可以容纳的记录个数，再扣掉minipage对齐浪费的空间
+  const int fix_size  = column_num * sizeof(PaxColumn) + column_num * 7;
+  int record_capacity = page_record_capacity(frame_->data_size() - fix_size, record_size);
+  while (pax_page_layout(pax_columns_, column_num, record_capacity) > frame_->data_size()) {
+    record_capacity--;
+  }
+  ASSERT(record_capacity > 0, "Record overflow the page size");
+
+  page_header_->magic               = PageHeader::MAGIC;
+  page_header_->version             = PageHeader::VERSION;
+  page_header_->record_num          = 0;
+  page_header_->record_real_size    = record_size;
+  page_header_->record_size         = record_size;
+  page_header_->record_capacity     = record_capacity;
+  page_header_->first_record_offset = column_num > 0 ? pax_columns_[0].minipage_offset : 0;
+  page_header_->page_format         = PAX_PAGE;
+  page_header_->column_num          = column_num;
+
+  bitmap_ = frame_->data() + PAGE_HEADER_SIZE + column_num * sizeof(PaxColumn);
+  memset(bitmap_, 0, page_bitmap_size(page_header_->record_capacity));
+
+  if ((ret = buffer_pool.flush_page(*frame_)) != RC::SUCCESS) {
+    LOG_ERROR("Failed to flush page header %d:%d.", buffer_pool.file_desc(), page_num);
+    return ret;
+  }
+
+  return RC::SUCCESS;
+}
+
+RC RecordPageHandler::init_empty_varlen_page(
+    DiskBufferPool &buffer_pool, PageNum page_num, int record_size, const std::vector<VarcharColumn> &columns)
+{
+  return init_empty_slotted_page(buffer_pool, page_num, VARLEN_PAGE, record_size, columns);
+}
+
+RC RecordPageHandler::init_empty_slotted_page(DiskBufferPool &buffer_pool, PageNum page_num, PageFormat page_format,
+    int record_size, const std::vector<VarcharColumn> &columns)
+{
+  RC ret = init_page(buffer_pool, page_num, false /*readonly*/, true /*latch*/, false /*check_version*/);
+  if (ret != RC::SUCCESS) {
+    LOG_ERROR("Failed to init empty varlen page page_num:record_size %d:%d.", page_num, record_size);
+    return ret;
+  }
+
+  // 记录最短和最长时占用的空间。搬到溢出页面的记录在原来的位置存放RID，所以至少要有一个RID的大小
+  const int column_num = static_cast<int>(columns.size());
+  int       min_size   = record_size;
+  for (const VarcharColumn &column : columns) {
+    min_size -= column.len - (int)sizeof(uint16_t);
+  }
+  min_size = std::max(min_size, (int)sizeof(RID));
+  const int max_size = std::max(record_size + column_num * (int)sizeof(uint16_t), (int)sizeof(RID));
+
+  page_header_->magic       = PageHeader::MAGIC;
+  page_header_->version     = PageHeader::VERSION;
+  page_header_->page_format = page_format;
+  page_header_->column_num  = column_num;
+  memcpy(varchar_columns_, columns.data(), column_num * sizeof(VarcharColumn));
+
+  const int bitmap_offset = page_bitmap_offset(page_header_);
+  // (record_capacity * (min_size + slot_size)) + record_capacity/8 + 1 <= (page_size - bitmap_offset)
+  const int record_capacity = (int)((frame_->data_size() - bitmap_offset - 1) / (min_size + sizeof(RecordSlot) + 0.125));
+
+  page_header_->record_num          = 0;
+  page_header_->record_real_size    = record_size;
+  page_header_->record_size         = max_size;
+  page_header_->record_capacity     = record_capacity;
+  page_header_->first_record_offset = align8(bitmap_offset + page_bitmap_size(record_capacity));
+  ASSERT(page_header_->first_record_offset + (int)sizeof(RecordSlot) + max_size <= frame_->data_size(),
+         "Record overflow the page size");
+
+  varlen_header_->slot_num      = 0;
+  varlen_header_->free_offset   = frame_->data_size();
+  varlen_header_->fragment_size = 0;
+  varlen_header_->overflow_page = BP_INVALID_PAGE_NUM;
+
+  bitmap_ = frame_->data() + bitmap_offset;
+  memset(bitmap_, 0, page_bitmap_size(page_header_->record_capacity));
+
+  if ((ret = buffer_pool.flush_page(*frame_)) != RC::SUCCESS) {
+    LOG_ERROR("Failed to flush page header %d:%d.", buffer_pool.file_desc(), page_num);
+    return ret;
+  }
+
+  return RC::SUCCESS;
+}
+
 RC RecordPageHandler::cleanup()
 {
+  RC rc = RC::SUCCESS;
   if (disk_buffer_pool_ != nullptr) {
-    if (readonly_) {
+    rc = flush_row_buffer();
+    if (OB_FAIL(rc)) {
+      LOG_ERROR("failed to write back record. page_num=%d, rc=%s", frame_->page_num(), strrc(rc));
+    }
+    if (!latched_) {
+      // 页面的锁由调用者持有
+    } else if (readonly_) {
       frame_->read_unlatch();
     } else {
       frame_->write_unlatch();
@@ -175,7 +375,7 @@ RC RecordPageHandler::cleanup()
     disk_buffer_pool_ = nullptr;
   }
 
-  return RC::SUCCESS;
+  return rc;
 }
 
 RC RecordPageHandler::insert_record(const char *data, RID *rid)
@@ -187,6 +387,23 @@ RC RecordPageHandler::insert_record(const char *data, RID *rid)
     return RC::RECORD_NOMEM;
   }
 
+  if (page_header_->page_format == VARLEN_PAGE) {
+    encode_buffer_.resize(page_header_->record_size);
+    const int len   = encode_record(data, encode_buffer_.data());
+    SlotNum   index = -1;
+    RC        rc    = insert_slot_data(encode_buffer_.data(), len, &index);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("Page is full, page_num %d:%d.", disk_buffer_pool_->file_desc(), frame_->page_num());
+      return rc;
+    }
+
+    if (rid) {
+      rid->page_num = get_page_num();
+      rid->slot_num = index;
+    }
+    return RC::SUCCESS;
+  }
+
   // 找到空闲位置
   Bitmap bitmap(bitmap_, page_header_->record_capacity);
   int    index = bitmap.next_unsetted_bit(0);
@@ -194,8 +411,12 @@ RC RecordPageHandler::insert_record(const char *data, RID *rid)
   page_header_->record_num++;
 
   // assert index < page_header_->record_capacity
-  char *record_data = get_record_data(index);
-  memcpy(record_data, data, page_header_->record_real_size);
+  if (page_header_->page_format == PAX_PAGE) {
+    scatter_record(index, data);
+  } else {
+    char *record_data = get_record_data(index);
+    memcpy(record_data, data, page_header_->record_real_size);
+  }
 
   frame_->mark_dirty();
 
@@ -215,16 +436,51 @@ RC RecordPageHandler::recover_insert_record(const char *data, const RID &rid)
     return RC::RECORD_INVALID_RID;
   }
 
-  // 更新位图
   Bitmap bitmap(bitmap_, page_header_->record_capacity);
+  if (page_header_->page_format == VARLEN_PAGE) {
+    if (bitmap.get_bit(rid.slot_num)) {
+      return store_record(rid.slot_num, data);
+    }
+
+    // slot directory 中还没有这个槽位时，先补上空闲的槽位
+    const int new_slots = std::max(rid.slot_num + 1 - varlen_header_->slot_num, 0);
+    encode_buffer_.resize(page_header_->record_size);
+    const int len    = encode_record(data, encode_buffer_.data());
+    const int size   = std::max(len, (int)sizeof(RID));
+    const int offset = allocate_space(size, new_slots * sizeof(RecordSlot));
+    if (offset < 0) {
+      LOG_WARN("no space to recover record. rid=%s", rid.to_string().c_str());
+      return RC::RECORD_NOMEM;
+    }
+    for (int i = 0; i < new_slots; i++) {
+      RecordSlot *slot = record_slot(varlen_header_->slot_num++);
+      memset(slot, 0, sizeof(RecordSlot));
+    }
+
+    RecordSlot *slot = record_slot(rid.slot_num);
+    slot->offset     = offset;
+    slot->len        = size;
+    slot->flags      = 0;
+    memcpy(frame_->data() + offset, encode_buffer_.data(), len);
+    bitmap.set_bit(rid.slot_num);
+    page_header_->record_num++;
+    frame_->mark_dirty();
+    return RC::SUCCESS;
+  }
+
+  // 更新位图
   if (!bitmap.get_bit(rid.slot_num)) {
     bitmap.set_bit(rid.slot_num);
     page_header_->record_num++;
   }
 
   // 恢复数据
-  char *record_data = get_record_data(rid.slot_num);
-  memcpy(record_data, data, page_header_->record_real_size);
+  if (page_header_->page_format == PAX_PAGE) {
+    scatter_record(rid.slot_num, data);
+  } else {
+    char *record_data = get_record_data(rid.slot_num);
+    memcpy(record_data, data, page_header_->record_real_size);
+  }
 
   frame_->mark_dirty();
 
@@ -242,6 +498,28 @@ RC RecordPageHandler::delete_record(const RID *rid)
 
   Bitmap bitmap(bitmap_, page_header_->record_capacity);
   if (bitmap.get_bit(rid->slot_num)) {
+    if (rid->slot_num == row_buffer_slot_) {
+      row_buffer_slot_ = -1;
+    }
+
+    if (page_header_->page_format == VARLEN_PAGE || page_header_->page_format == OVERFLOW_PAGE) {
+      RecordSlot *slot = record_slot(rid->slot_num);
+      if (slot->flags & RecordSlot::MOVED) {
+        RID overflow_rid;
+        memcpy(&overflow_rid, frame_->data() + slot->offset, sizeof(RID));
+        RecordPageHandler overflow_page_handler;
+        RC rc = overflow_page_handler.init(*disk_buffer_pool_, overflow_rid.page_num, false /*readonly*/);
+        if (OB_SUCC(rc)) {
+          rc = overflow_page_handler.delete_record(&overflow_rid);
+        }
+        if (OB_FAIL(rc)) {
+          LOG_WARN("failed to delete overflow record. rid=%s, overflow rid=%s, rc=%s",
+                   rid->to_string().c_str(), overflow_rid.to_string().c_str(), strrc(rc));
+        }
+      }
+      free_slot_data(rid->slot_num);
+    }
+
     bitmap.clear_bit(rid->slot_num);
     page_header_->record_num--;
     frame_->mark_dirty();
@@ -257,6 +535,32 @@ RC RecordPageHandler::delete_record(const RID *rid)
   }
 }
 
+RC RecordPageHandler::update_record(SlotNum slot_num, const char *data)
+{
+  ASSERT(readonly_ == false, "cannot update record while the page is readonly");
+
+  RC rc = RC::SUCCESS;
+  switch (page_header_->page_format) {
+    case VARLEN_PAGE: {
+      rc = store_record(slot_num, data);
+    } break;
+    case PAX_PAGE: {
+      scatter_record(slot_num, data);
+    } break;
+    default: {
+      char *record_data = get_record_data(slot_num);
+      if (record_data != data) {
+        memcpy(record_data, data, page_header_->record_real_size);
+      }
+    } break;
+  }
+
+  if (OB_SUCC(rc)) {
+    frame_->mark_dirty();
+  }
+  return rc;
+}
+
 RC RecordPageHandler::get_record(const RID *rid, Record *rec)
 {
   if (rid->slot_num >= page_header_->record_capacity) {
@@ -271,7 +575,358 @@ RC RecordPageHandler::get_record(const RID *rid, Record *rec)
   }
 
   rec->set_rid(*rid);
-  rec->set_data(get_record_data(rid->slot_num), page_header_->record_real_size);
+  rec->set_data(load_record(rid->slot_num), page_header_->record_real_size);
+  return RC::SUCCESS;
+}
+
+const char *RecordPageHandler::field_data(SlotNum slot_num, int offset)
+{
+  switch (page_header_->page_format) {
+    case PAX_PAGE: {
+      if (slot_num == row_buffer_slot_) {
+        // 记录可能已经被修改过，还没有写回页面
+        return row_buffer_.data() + offset;
+      }
+
+      for (int i = 0; i < page_header_->column_num; i++) {
+        const PaxColumn &column = pax_columns_[i];
+        if (offset >= column.offset && offset < column.offset + column.len) {
+          return frame_->data() + column.minipage_offset + column.len * slot_num + (offset - column.offset);
+        }
+      }
+      ASSERT(false, "cannot find field in pax page. offset=%d, page_num=%d", offset, frame_->page_num());
+      return nullptr;
+    } break;
+    case VARLEN_PAGE: {
+      if (slot_num == row_buffer_slot_) {
+        return row_buffer_.data() + offset;
+      }
+      return load_record(slot_num) + offset;
+    } break;
+    default: {
+      return get_record_data(slot_num) + offset;
+    } break;
+  }
+}
+
+char *RecordPageHandler::load_record(SlotNum slot_num)
+{
+  if (page_header_->page_format != PAX_PAGE && page_header_->page_format != VARLEN_PAGE) {
+    return get_record_data(slot_num);
+  }
+
+  RC rc = flush_row_buffer();
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("failed to write back record. page_num=%d, rc=%s", frame_->page_num(), strrc(rc));
+  }
+
+  row_buffer_.resize(page_header_->record_real_size);
+  const char *data = frame_->data();
+  if (page_header_->page_format == PAX_PAGE) {
+    for (int i = 0; i < page_header_->column_num; i++) {
+      const PaxColumn &column = pax_columns_[i];
+      memcpy(row_buffer_.data() + column.offset, data + column.minipage_offset + column.len * slot_num, column.len);
+    }
+  } else {
+    const RecordSlot *slot = record_slot(slot_num);
+    if (slot->flags & RecordSlot::MOVED) {
+      // 溢出页面只会在拿着原来页面的锁时访问，所以不会死锁
+      RID overflow_rid;
+      memcpy(&overflow_rid, data + slot->offset, sizeof(RID));
+      RecordPageHandler overflow_page_handler;
+      rc = overflow_page_handler.init(*disk_buffer_pool_, overflow_rid.page_num, true /*readonly*/);
+      ASSERT(OB_SUCC(rc), "failed to open overflow page. rid=%s, rc=%s", overflow_rid.to_string().c_str(), strrc(rc));
+      const RecordSlot *overflow_slot = overflow_page_handler.record_slot(overflow_rid.slot_num);
+      decode_record(overflow_page_handler.frame_->data() + overflow_slot->offset, row_buffer_.data());
+    } else {
+      decode_record(data + slot->offset, row_buffer_.data());
+    }
+  }
+
+  if (!readonly_) {
+    row_buffer_slot_ = slot_num;
+  }
+  return row_buffer_.data();
+}
+
+bool RecordPageHandler::scatter_record(SlotNum slot_num, const char *data)
+{
+  bool changed = false;
+  for (int i = 0; i < page_header_->column_num; i++) {
+    const PaxColumn &column     = pax_columns_[i];
+    char            *field_data = frame_->data() + column.minipage_offset + column.len * slot_num;
+    if (0 != memcmp(field_data, data + column.offset, column.len)) {
+      memcpy(field_data, data + column.offset, column.len);
+      changed = true;
+    }
+  }
+  return changed;
+}
+
+RC RecordPageHandler::flush_row_buffer()
+{
+  if (row_buffer_slot_ < 0) {
+    return RC::SUCCESS;
+  }
+
+  const SlotNum slot_num = row_buffer_slot_;
+  row_buffer_slot_       = -1;
+  if (page_header_->page_format == VARLEN_PAGE) {
+    return store_record(slot_num, row_buffer_.data());
+  }
+  if (scatter_record(slot_num, row_buffer_.data())) {
+    frame_->mark_dirty();
+  }
+  return RC::SUCCESS;
+}
+
+int RecordPageHandler::encode_record(const char *data, char *buf) const
+{
+  int pos = 0;
+  int len = 0;
+  for (int i = 0; i < page_header_->column_num; i++) {
+    const VarcharColumn &column = varchar_columns_[i];
+    memcpy(buf + len, data + pos, column.offset - pos);
+    len += column.offset - pos;
+
+    const uint16_t str_len = strnlen(data + column.offset, column.len);
+    memcpy(buf + len, &str_len, sizeof(str_len));
+    memcpy(buf + len + sizeof(str_len), data + column.offset, str_len);
+    len += sizeof(str_len) + str_len;
+    pos = column.offset + column.len;
+  }
+  memcpy(buf + len, data + pos, page_header_->record_real_size - pos);
+  return len + page_header_->record_real_size - pos;
+}
+
+void RecordPageHandler::decode_record(const char *buf, char *data) const
+{
+  int pos = 0;
+  for (int i = 0; i < page_header_->column_num; i++) {
+    const VarcharColumn &column = varchar_columns_[i];
+    memcpy(data + pos, buf, column.offset - pos);
+    buf += column.offset - pos;
+
+    uint16_t str_len = 0;
+    memcpy(&str_len, buf, sizeof(str_len));
+    memcpy(data + column.offset, buf + sizeof(str_len), str_len);
+    memset(data + column.offset + str_len, 0, column.len - str_len);
+    buf += sizeof(str_len) + str_len;
+    pos = column.offset + column.len;
+  }
+  memcpy(data + pos, buf, page_header_->record_real_size - pos);
+}
+
+int RecordPageHandler::free_space() const
+{
+  const int slot_end = page_header_->first_record_offset + varlen_header_->slot_num * sizeof(RecordSlot);
+  return varlen_header_->free_offset - slot_end + varlen_header_->fragment_size;
+}
+
+int RecordPageHandler::allocate_space(int size, int slot_size)
+{
+  const int slot_end = page_header_->first_record_offset + varlen_header_->slot_num * sizeof(RecordSlot);
+  if (varlen_header_->free_offset - slot_end < size + slot_size) {
+    if (free_space() < size + slot_size) {
+      return -1;
+    }
+    compact();
+  }
+
+  varlen_header_->free_offset -= size;
+  return varlen_header_->free_offset;
+}
+
+void RecordPageHandler::compact()
+{
+  char             *data        = frame_->data();
+  const int         free_offset = varlen_header_->free_offset;
+  std::vector<char> records(data + free_offset, data + frame_->data_size());
+
+  int offset = frame_->data_size();
+  for (SlotNum i = 0; i < varlen_header_->slot_num; i++) {
+    RecordSlot *slot = record_slot(i);
+    if (slot->len == 0) {
+      continue;
+    }
+    offset -= slot->len;
+    memcpy(data + offset, records.data() + (slot->offset - free_offset), slot->len);
+    slot->offset = offset;
+  }
+
+  varlen_header_->free_offset   = offset;
+  varlen_header_->fragment_size = 0;
+  frame_->mark_dirty();
+  LOG_TRACE("compact varlen page. page_num=%d, free space=%d", frame_->page_num(), free_space());
+}
+
+RC RecordPageHandler::insert_slot_data(const char *buf, int len, SlotNum *slot_num)
+{
+  if (page_header_->record_num >= page_header_->record_capacity) {
+    return RC::RECORD_NOMEM;
+  }
+
+  Bitmap    bitmap(bitmap_, page_header_->record_capacity);
+  const int index    = bitmap.next_unsetted_bit(0);
+  const int new_slot = index >= varlen_header_->slot_num ? 1 : 0;
+  const int size     = std::max(len, (int)sizeof(RID));
+  const int offset   = allocate_space(size, new_slot * sizeof(RecordSlot));
+  if (offset < 0) {
+    return RC::RECORD_NOMEM;
+  }
+  if (new_slot) {
+    varlen_header_->slot_num = index + 1;
+  }
+
+  RecordSlot *slot = record_slot(index);
+  slot->offset     = offset;
+  slot->len        = size;
+  slot->flags      = 0;
+  memcpy(frame_->data() + offset, buf, len);
+
+  bitmap.set_bit(index);
+  page_header_->record_num++;
+  frame_->mark_dirty();
+
+  *slot_num = index;
+  return RC::SUCCESS;
+}
+
+bool RecordPageHandler::update_slot_data(SlotNum slot_num, const char *buf, int len)
+{
+  RecordSlot *slot = record_slot(slot_num);
+  const int   size = std::max(len, (int)sizeof(RID));
+  if (size <= slot->len) {
+    char *slot_data = frame_->data() + slot->offset;
+    if (size == slot->len && 0 == memcmp(slot_data, buf, len)) {
+      return true;
+    }
+
+    memcpy(slot_data, buf, len);
+    varlen_header_->fragment_size += slot->len - size;
+    slot->len = size;
+    frame_->mark_dirty();
+    return true;
+  }
+
+  if (free_space() + slot->len < size) {
+    return false;
+  }
+
+  // 先释放原来的空间，整理页面时就可以回收
+  free_slot_data(slot_num);
+  const int offset = allocate_space(size, 0);
+  ASSERT(offset >= 0, "failed to allocate space in varlen page. page_num=%d", frame_->page_num());
+  slot->offset = offset;
+  slot->len    = size;
+  memcpy(frame_->data() + offset, buf, len);
+  frame_->mark_dirty();
+  return true;
+}
+
+void RecordPageHandler::free_slot_data(SlotNum slot_num)
+{
+  RecordSlot *slot = record_slot(slot_num);
+  varlen_header_->fragment_size += slot->len;
+  slot->len   = 0;
+  slot->flags = 0;
+}
+
+RC RecordPageHandler::store_record(SlotNum slot_num, const char *data)
+{
+  encode_buffer_.resize(page_header_->record_size);
+  const int len = encode_record(data, encode_buffer_.data());
+
+  RecordSlot *slot  = record_slot(slot_num);
+  const bool  moved = (slot->flags & RecordSlot::MOVED) != 0;
+  RID         old_overflow_rid;
+  if (moved) {
+    memcpy(&old_overflow_rid, frame_->data() + slot->offset, sizeof(RID));
+    RecordPageHandler overflow_page_handler;
+    RC rc = overflow_page_handler.init(*disk_buffer_pool_, old_overflow_rid.page_num, false /*readonly*/);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to open overflow page. rid=%s, rc=%s", old_overflow_rid.to_string().c_str(), strrc(rc));
+      return rc;
+    }
+    if (overflow_page_handler.update_slot_data(old_overflow_rid.slot_num, encode_buffer_.data(), len)) {
+      return RC::SUCCESS;
+    }
+    // 溢出页面上也放不下了，换一个溢出页面。新的溢出记录可能也放在这个页面上，先释放页面锁
+  } else if (update_slot_data(slot_num, encode_buffer_.data(), len)) {
+    return RC::SUCCESS;
+  }
+
+  // 页面上放不下，搬到溢出页面上，原来的位置存放溢出记录的RID。
+  // 先写入新的溢出记录再删除原来的，失败时原来的记录保持不变
+  RID overflow_rid;
+  RC  rc = insert_overflow_record(encode_buffer_.data(), len, &overflow_rid);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to move record to overflow page. page_num=%d, slot_num=%d, rc=%s",
+              frame_->page_num(), slot_num, strrc(rc));
+    return rc;
+  }
+
+  if (moved) {
+    RecordPageHandler overflow_page_handler;
+    rc = overflow_page_handler.init(*disk_buffer_pool_, old_overflow_rid.page_num, false /*readonly*/);
+    if (OB_SUCC(rc)) {
+      rc = overflow_page_handler.delete_record(&old_overflow_rid);
+    }
+    if (OB_FAIL(rc)) {
+      // 只是浪费了溢出页面上的一点空间
+      LOG_WARN("failed to delete overflow record. rid=%s, rc=%s", old_overflow_rid.to_string().c_str(), strrc(rc));
+    }
+  }
+
+  // 原来的位置至少有一个RID的大小
+  [[maybe_unused]] bool updated = update_slot_data(slot_num, (const char *)&overflow_rid, sizeof(RID));
+  ASSERT(updated, "no space for overflow rid. page_num=%d, slot_num=%d", frame_->page_num(), slot_num);
+  slot->flags |= RecordSlot::MOVED;
+  LOG_TRACE("move record to overflow page. page_num=%d, slot_num=%d, overflow rid=%s",
+            frame_->page_num(), slot_num, overflow_rid.to_string().c_str());
+  return RC::SUCCESS;
+}
+
+RC RecordPageHandler::insert_overflow_record(const char *buf, int len, RID *rid)
+{
+  RC rc = RC::SUCCESS;
+  RecordPageHandler overflow_page_handler;
+  const PageNum     last_overflow_page = varlen_header_->overflow_page;
+  if (last_overflow_page != BP_INVALID_PAGE_NUM) {
+    rc = overflow_page_handler.init(*disk_buffer_pool_, last_overflow_page, false /*readonly*/);
+    if (OB_SUCC(rc) && overflow_page_handler.page_format() == OVERFLOW_PAGE &&
+        OB_SUCC(overflow_page_handler.insert_slot_data(buf, len, &rid->slot_num))) {
+      rid->page_num = last_overflow_page;
+      return RC::SUCCESS;
+    }
+    overflow_page_handler.cleanup();
+  }
+
+  Frame *frame = nullptr;
+  rc = disk_buffer_pool_->allocate_page(&frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to allocate overflow page. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  const PageNum page_num = frame->page_num();
+  rc = overflow_page_handler.init_empty_slotted_page(*disk_buffer_pool_, page_num, OVERFLOW_PAGE, sizeof(RID), {});
+  // 与 RecordFileHandler::insert_record 一样，释放 allocate_page 时的 pin
+  frame->unpin();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to init overflow page. page_num=%d, rc=%s", page_num, strrc(rc));
+    return rc;
+  }
+
+  rc = overflow_page_handler.insert_slot_data(buf, len, &rid->slot_num);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to insert record into overflow page. page_num=%d, rc=%s", page_num, strrc(rc));
+    return rc;
+  }
+
+  rid->page_num                = page_num;
+  varlen_header_->overflow_page = page_num;
+  frame_->mark_dirty();
   return RC::SUCCESS;
 }
 
@@ -283,25 +938,71 @@ PageNum RecordPageHandler::get_page_num() const
   return frame_->page_num();
 }
 
-bool RecordPageHandler::is_full() const { return page_header_->record_num >= page_header_->record_capacity; }
+bool RecordPageHandler::is_full() const
+{
+  switch (page_header_->page_format) {
+    case OVERFLOW_PAGE: {
+      // 溢出页面只存放从其它页面搬过来的记录，不能插入新记录
+      return true;
+    } break;
+    case VARLEN_PAGE: {
+      return page_header_->record_num >= page_header_->record_capacity ||
+             free_space() < page_header_->record_size + (int)sizeof(RecordSlot);
+    } break;
+    default: {
+      return page_header_->record_num >= page_header_->record_capacity;
+    } break;
+  }
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 
 RecordFileHandler::~RecordFileHandler() { this->close(); }
 
-RC RecordFileHandler::init(DiskBufferPool *buffer_pool)
+RC RecordFileHandler::init(DiskBufferPool *buffer_pool, StorageFormat storage_format, const std::vector<FieldMeta> *fields)
 {
   if (disk_buffer_pool_ != nullptr) {
     LOG_ERROR("record file handler has been openned.");
     return RC::RECORD_OPENNED;
   }
 
+  page_format_ = ROW_PAGE;
+  pax_columns_.clear();
+  varchar_columns_.clear();
+  if (storage_format == PAX_FORMAT) {
+    if (nullptr == fields || fields->empty()) {
+      LOG_ERROR("fields are required by pax storage format.");
+      return RC::INVALID_ARGUMENT;
+    }
+
+    page_format_ = PAX_PAGE;
+    for (const FieldMeta &field : *fields) {
+      pax_columns_.push_back(PaxColumn{field.offset(), field.len(), 0});
+    }
+  } else if (fields != nullptr) {
+    for (const FieldMeta &field : *fields) {
+      if (field.var_len()) {
+        varchar_columns_.push_back(VarcharColumn{field.offset(), field.len()});
+      }
+    }
+    if (!varchar_columns_.empty()) {
+      page_format_ = VARLEN_PAGE;
+    }
+  }
+
   disk_buffer_pool_ = buffer_pool;
 
   RC rc = init_free_pages();
+  if (OB_FAIL(rc)) {
+    // 比如页面是其它版本写入的，这时不能打开文件
+    LOG_WARN("failed to init free pages. rc=%s", strrc(rc));
+    disk_buffer_pool_ = nullptr;
+    free_pages_.clear();
+    return rc;
+  }
 
   LOG_INFO("open record file handle done. rc=%s", strrc(rc));
-  return RC::SUCCESS;
+  return rc;
 }
 
 void RecordFileHandler::close()
@@ -344,10 +1045,50 @@ RC RecordFileHandler::init_free_pages()
 }
 
 RC RecordFileHandler::insert_record(const char *data, int record_size, RID *rid)
+{
+  RecordPageHandler record_page_handler;
+  RC ret = get_free_page(record_size, record_page_handler);
+  if (OB_FAIL(ret)) {
+    return ret;
+  }
+
+  // 找到空闲位置
+  return record_page_handler.insert_record(data, rid);
+}
+
+RC RecordFileHandler::insert_records(
+    const std::vector<const char *> &datas, int record_size, std::vector<RID> &rids, int &inserted)
+{
+  RC rc = RC::SUCCESS;
+  inserted = 0;
+  rids.resize(datas.size());
+
+  const int record_num = static_cast<int>(datas.size());
+  while (inserted < record_num) {
+    RecordPageHandler record_page_handler;
+    rc = get_free_page(record_size, record_page_handler);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    // 页面锁只加一次，页面满了再去找下一个页面
+    do {
+      rc = record_page_handler.insert_record(datas[inserted], &rids[inserted]);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to insert record into page. page num=%d, rc=%s",
+                 record_page_handler.get_page_num(), strrc(rc));
+        return rc;
+      }
+      inserted++;
+    } while (inserted < record_num && !record_page_handler.is_full());
+  }
+  return rc;
+}
+
+RC RecordFileHandler::get_free_page(int record_size, RecordPageHandler &record_page_handler)
 {
   RC ret = RC::SUCCESS;
 
-  RecordPageHandler record_page_handler;
   bool              page_found       = false;
   PageNum           current_page_num = 0;
 
@@ -384,7 +1125,18 @@ RC RecordFileHandler::insert_record(const char *data, int record_size, RID *rid)
 
     current_page_num = frame->page_num();
 
-    ret = record_page_handler.init_empty_page(*disk_buffer_pool_, current_page_num, record_size);
+    switch (page_format_) {
+      case PAX_PAGE: {
+        ret = record_page_handler.init_empty_pax_page(*disk_buffer_pool_, current_page_num, pax_columns_);
+      } break;
+      case VARLEN_PAGE: {
+        ret = record_page_handler.init_empty_varlen_page(
+            *disk_buffer_pool_, current_page_num, record_size, varchar_columns_);
+      } break;
+      default: {
+        ret = record_page_handler.init_empty_page(*disk_buffer_pool_, current_page_num, record_size);
+      } break;
+    }
     if (ret != RC::SUCCESS) {
       frame->unpin();
       LOG_ERROR("Failed to init empty page. ret:%d", ret);
@@ -404,8 +1156,7 @@ RC RecordFileHandler::insert_record(const char *data, int record_size, RID *rid)
     lock_.unlock();
   }
 
-  // 找到空闲位置
-  return record_page_handler.insert_record(data, rid);
+  return RC::SUCCESS;
 }
 
 RC RecordFileHandler::recover_insert_record(const char *data, int record_size, const RID &rid)
@@ -483,11 +1234,58 @@ RC RecordFileHandler::visit_record(const RID &rid, bool readonly, std::function<
   }
 
   visitor(record);
+  return page_handler.cleanup();
+}
+
+RC RecordFileHandler::update_record(const Record &record)
+{
+  // 调用者已经以写模式持有页面的锁
+  RecordPageHandler page_handler;
+  RC rc = page_handler.init_latched(*disk_buffer_pool_, record.rid().page_num);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to get page. page_num=%d, rc=%s", record.rid().page_num, strrc(rc));
+    return rc;
+  }
+
+  rc = page_handler.update_record(record.rid().slot_num, record.data());
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to update record. rid=%s, rc=%s", record.rid().to_string().c_str(), strrc(rc));
+  }
   return rc;
 }
 
+bool RecordFileHandler::is_page_all_visible(PageNum page_num)
+{
+  // 提示信息只保存在页帧上，不在内存中的页面一定没有设置，不需要为了检查而加载
+  Frame *frame = disk_buffer_pool_->get_cached_page(page_num);
+  if (frame == nullptr) {
+    return false;
+  }
+
+  const bool all_visible = frame->all_visible();
+  disk_buffer_pool_->unpin_page(frame);
+  return all_visible;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
+RC MorselQueue::init(DiskBufferPool &buffer_pool)
+{
+  std::lock_guard<std::mutex> guard(lock_);
+  return bp_iterator_.init(buffer_pool);
+}
+
+bool MorselQueue::next(std::vector<PageNum> &pages)
+{
+  pages.clear();
+  std::lock_guard<std::mutex> guard(lock_);
+  while (static_cast<int>(pages.size()) < MORSEL_PAGES && bp_iterator_.has_next()) {
+    pages.push_back(bp_iterator_.next());
+  }
+  return !pages.empty();
+}
+
+////////////////////////////////////////////////////////////////////////////////
 RecordFileScanner::~RecordFileScanner() { close_scan(); }
 
 RC RecordFileScanner::open_scan(
@@ -500,6 +1298,11 @@ RC RecordFileScanner::open_scan(
   trx_              = trx;
   readonly_         = readonly;
 
+  page_index_       = 0;
+  sampled_pages_    = 0;
+  morsel_pages_.clear();
+  morsel_index_     = 0;
+
   RC rc = bp_iterator_.init(buffer_pool);
   if (rc != RC::SUCCESS) {
     LOG_WARN("failed to init bp iterator. rc=%d:%s", rc, strrc(rc));
@@ -507,10 +1310,9 @@ RC RecordFileScanner::open_scan(
   }
   condition_filter_ = condition_filter;
 
-  rc = fetch_next_record();
-  if (rc == RC::RECORD_EOF) {
-    rc = RC::SUCCESS;
-  }
+  // 第一条记录在 has_next 时才去获取
+  fetched_  = false;
+  fetch_rc_ = RC::SUCCESS;
   return rc;
 }
 
@@ -535,9 +1337,12 @@ RC RecordFileScanner::fetch_next_record()
   }
 
   // 上个页面遍历完了，或者还没有开始遍历某个页面，那么就从一个新的页面开始遍历查找
-  while (bp_iterator_.has_next()) {
-    PageNum page_num = bp_iterator_.next();
-    record_page_handler_.cleanup();
+  PageNum page_num = BP_INVALID_PAGE_NUM;
+  while (next_page(page_num)) {
+    rc = record_page_handler_.cleanup();
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
     rc = record_page_handler_.init(*disk_buffer_pool_, page_num, readonly_);
     if (OB_FAIL(rc)) {
       LOG_WARN("failed to init record page handler. page_num=%d, rc=%s", page_num, strrc(rc));
@@ -545,6 +1350,10 @@ RC RecordFileScanner::fetch_next_record()
     }
 
     record_page_iterator_.init(record_page_handler_);
+    // 只读遍历时顺便检查页面上的记录是否都对所有事务可见，如果是就设置页面的提示信息。
+    // 有旧版本时索引中还有旧版本的索引项，只读索引的扫描需要访问记录来判断，参考 Table::update_record
+    page_has_old_versions_ = readonly_ && trx_ != nullptr && trx_->has_old_versions(table_, page_num);
+    page_all_visible_ = readonly_ && trx_ != nullptr && !record_page_handler_.is_all_visible() && !page_has_old_versions_;
     rc = fetch_next_record_in_page();
     if (rc == RC::SUCCESS || rc != RC::RECORD_EOF) {
       // 有有效记录：RC::SUCCESS
@@ -556,8 +1365,8 @@ RC RecordFileScanner::fetch_next_record()
 
   // 所有的页面都遍历完了，没有数据了
   next_record_.rid().slot_num = -1;
-  record_page_handler_.cleanup();
-  return RC::RECORD_EOF;
+  rc = record_page_handler_.cleanup();
+  return OB_FAIL(rc) ? rc : RC::RECORD_EOF;
 }
 
 /**
@@ -566,7 +1375,23 @@ RC RecordFileScanner::fetch_next_record()
 RC RecordFileScanner::fetch_next_record_in_page()
 {
   RC rc = RC::SUCCESS;
+  const bool filter_on_page = condition_filter_ != nullptr && record_page_handler_.page_format() == PAX_PAGE;
   while (record_page_iterator_.has_next()) {
+    StatementCounters::current().rows_examined++;
+    bool filtered = false;
+    if (filter_on_page) {
+      // PAX页面上先只读取过滤条件用到的字段，不满足条件的记录就不用拼接了
+      if (!condition_filter_->filter(record_page_handler_, record_page_iterator_.next_slot_num())) {
+        if (!page_has_old_versions_) {
+          record_page_iterator_.skip();
+          // 没有读取事务字段，不知道这条记录是否对所有事务可见
+          page_all_visible_ = false;
+          continue;
+        }
+        filtered = true;
+      }
+    }
+
     rc = record_page_iterator_.next(next_record_);
     if (rc != RC::SUCCESS) {
       const auto page_num = record_page_handler_.get_page_num();
@@ -574,8 +1399,19 @@ RC RecordFileScanner::fetch_next_record_in_page()
       return rc;
     }
 
+    if (page_all_visible_ && !trx_->visible_to_all(table_, next_record_)) {
+      page_all_visible_ = false;
+    }
+
     // 如果有过滤条件，就用过滤条件过滤一下
-    if (condition_filter_ != nullptr && !condition_filter_->filter(next_record_)) {
+    if (!filter_on_page && condition_filter_ != nullptr && !condition_filter_->filter(next_record_)) {
+      filtered = true;
+    }
+
+    if (filtered) {
+      if (page_has_old_versions_ && old_version_matches()) {
+        return RC::SUCCESS;
+      }
       continue;
     }
 
@@ -585,19 +1421,96 @@ RC RecordFileScanner::fetch_next_record_in_page()
     }
 
     // 让当前事务探测一下是否访问冲突，或者需要加锁、等锁等操作，由事务自己决定
+    const char *data = next_record_.data();
     rc = trx_->visit_record(table_, next_record_, readonly_);
     if (rc == RC::RECORD_INVISIBLE) {
       // 可以参考MvccTrx，表示当前记录不可见
       // 这种模式仅在 readonly 事务下是有效的
       continue;
     }
+    if (rc == RC::LOCKED_NEED_WAIT) {
+      // 拿到行锁之后从这条记录开始重新访问，记录可能已经被修改或删除了
+      rc = wait_for_lock();
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+      continue;
+    }
+    if (rc == RC::SUCCESS && next_record_.data() != data && condition_filter_ != nullptr &&
+        !condition_filter_->filter(next_record_)) {
+      // 访问到的是对当前事务可见的旧版本，它不满足过滤条件
+      continue;
+    }
     return rc;
   }
 
+  if (page_all_visible_) {
+    record_page_handler_.mark_all_visible();
+    page_all_visible_ = false;
+    LOG_TRACE("page is all visible. page_num=%d", record_page_handler_.get_page_num());
+  }
+
   next_record_.rid().slot_num = -1;
   return RC::RECORD_EOF;
 }
 
+RC RecordFileScanner::wait_for_lock()
+{
+  // 等待行锁时不能持有页面锁，持有行锁的事务回滚时需要修改这个页面
+  const PageNum page_num = record_page_handler_.get_page_num();
+  const SlotNum slot_num = next_record_.rid().slot_num;
+  record_page_handler_.cleanup();
+
+  RC rc = trx_->wait_for_lock();
+
+  RC rc2 = record_page_handler_.init(*disk_buffer_pool_, page_num, readonly_);
+  if (OB_FAIL(rc2)) {
+    LOG_WARN("failed to init record page handler. page_num=%d, rc=%s", page_num, strrc(rc2));
+    return rc2;
+  }
+  record_page_iterator_.init(record_page_handler_, slot_num);
+  return rc;
+}
+
+bool RecordFileScanner::old_version_matches()
+{
+  const char *data = next_record_.data();
+  RC rc = trx_->visit_record(table_, next_record_, readonly_);
+  return rc == RC::SUCCESS && next_record_.data() != data && condition_filter_->filter(next_record_);
+}
+
+bool RecordFileScanner::next_page(PageNum &page_num)
+{
+  if (morsel_queue_ != nullptr) {
+    if (morsel_index_ >= morsel_pages_.size()) {
+      morsel_index_ = 0;
+      if (!morsel_queue_->next(morsel_pages_)) {
+        return false;
+      }
+
+      // 多个线程交替扫描不同的morsel，buffer pool 识别不出顺序访问，这里直接告诉它要读哪些页面
+      const PageNum first_page = morsel_pages_.front();
+      RC rc = disk_buffer_pool_->read_ahead(first_page, morsel_pages_.back() - first_page + 1);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to read ahead morsel pages. first page=%d, rc=%s", first_page, strrc(rc));
+      }
+    }
+    page_num = morsel_pages_[morsel_index_++];
+    sampled_pages_++;
+    return true;
+  }
+
+  while (bp_iterator_.has_next()) {
+    page_num = bp_iterator_.next();
+    if (page_index_++ % sample_step_ != 0) {
+      continue;
+    }
+    sampled_pages_++;
+    return true;
+  }
+  return false;
+}
+
 RC RecordFileScanner::close_scan()
 {
   if (disk_buffer_pool_ != nullptr) {
@@ -609,19 +1522,33 @@ RC RecordFileScanner::close_scan()
   }
 
   record_page_handler_.cleanup();
+  record_page_iterator_ = RecordPageIterator();
+  fetched_              = true;
+  fetch_rc_             = RC::RECORD_EOF;
 
   return RC::SUCCESS;
 }
 
-bool RecordFileScanner::has_next() { return next_record_.rid().slot_num != -1; }
+bool RecordFileScanner::has_next()
+{
+  if (!fetched_) {
+    fetch_rc_ = fetch_next_record();
+    fetched_  = true;
+  }
+  return fetch_rc_ != RC::RECORD_EOF;
+}
 
 RC RecordFileScanner::next(Record &record)
 {
-  record = next_record_;
+  if (!has_next()) {
+    return RC::RECORD_EOF;
+  }
 
-  RC rc = fetch_next_record();
-  if (rc == RC::RECORD_EOF) {
-    rc = RC::SUCCESS;
+  fetched_ = false;
+  if (OB_FAIL(fetch_rc_)) {
+    return fetch_rc_;
   }
-  return rc;
+
+  record = next_record_;
+  return RC::SUCCESS;
 }
@@ -16,9 +16,12 @@ See the Mulan PSL v2 for more details. */
 
 #include <sstream>
 #include <limits>
+#include <mutex>
+#include <vector>
 #include "storage/buffer/disk_buffer_pool.h"
 #include "storage/trx/latch_memo.h"
 #include "storage/record/record.h"
+#include "storage/field/field_meta.h"
 #include "common/lang/bitmap.h"
 
 class ConditionFilter;
@@ -38,12 +41,16 @@ class Table;
  * PageHeader，这虽然有点浪费但是做起来简单。
  *
  * 对单个页面来说，最开始是一个页头，然后接着就是一行行记录（会对齐）。
+ * 建表时也可以指定PAX格式，这时页面上的记录按列存放，每个字段的数据集中放在一起，叫做minipage。
+ * 只访问少数几个字段的扫描在PAX页面上可以少读很多数据，参考 RecordPageHandler 的说明。
+ * 包含VARCHAR字段的表使用变长页面，记录按照实际长度存放在页面的尾部，页面前面是记录每个槽位位置的slot directory。
  * 如何标识一个记录，或者定位一个记录？
  * 使用RID，即record identifier。使用 page num 表示所在的页面，slot num 表示当前在页面中的位置。因为这里的
  * 记录都是定长的，所以根据slot num 可以直接计算出记录的起始位置。
  * 问题1：那么如果记录不是定长的，还能使用 slot num 吗？
  * 问题2：如何更有效地存放不定长数据呢？
  * 问题3：如果一个页面不能存放一个记录，那么怎么组织记录存放效果更好呢？
+ * 变长页面是对前两个问题的一种回答：slot num 指向 slot directory 中的一项，再由它找到记录的位置。
  *
  * 按照上面的描述，这里提供了几个类，分别是：
  * - RecordFileHandler：管理整个文件/表的记录增删改查
@@ -57,16 +64,84 @@ class Table;
  * @brief 数据文件，按照页面来组织，每一页都存放一些记录/数据行
  * @ingroup RecordManager
  * @details 每一页都有一个这样的页头，虽然看起来浪费，但是现在就简单的这么做
- * 从这个页头描述的信息来看，当前仅支持定长行/记录。如果要支持变长记录，
- * 或者超长（超出一页）的记录，这么做是不合适的。
+ * 这个页头描述的是定长行/记录，变长页面在后面再跟一个 VarlenPageHeader。
+ * 超长（超出一页）的记录现在还不支持。
+ * 页头或者页面的布局变化时要修改 VERSION，访问版本不同的页面会返回 FILE_VERSION_MISMATCH。
  */
 struct PageHeader
 {
+  static constexpr int32_t MAGIC   = 0x47505252;  // "RRPG"
+  static constexpr int32_t VERSION = 1;
+
+  int32_t magic;                ///< 固定为 MAGIC，用来识别记录页面
+  int32_t version;              ///< 初始化页面时的页面格式版本
   int32_t record_num;           ///< 当前页面记录的个数
   int32_t record_real_size;     ///< 每条记录的实际大小
   int32_t record_size;          ///< 每条记录占用实际空间大小(可能对齐)
   int32_t record_capacity;      ///< 最大记录个数
-  int32_t first_record_offset;  ///< 第一条记录的偏移量
+  int32_t first_record_offset;  ///< 第一条记录的偏移量。PAX页面上是第一个minipage的偏移量，变长页面上是slot directory的偏移量
+  int32_t page_format;          ///< 页面的存放格式，参考 PageFormat
+  int32_t column_num;           ///< PAX页面上的字段个数，或者变长页面上的变长字段个数。行存页面上是0
+};
+
+/**
+ * @brief 页面上记录的存放格式
+ * @ingroup RecordManager
+ */
+enum PageFormat
+{
+  ROW_PAGE,       ///< 定长记录连续存放
+  PAX_PAGE,       ///< 按列存放，参考 PaxColumn
+  VARLEN_PAGE,    ///< 变长记录，参考 VarlenPageHeader
+  OVERFLOW_PAGE,  ///< 存放在原页面上放不下的变长记录，格式与变长页面一样，但是遍历时会跳过
+};
+
+/**
+ * @brief PAX页面上一个字段(列)的描述
+ * @ingroup RecordManager
+ */
+struct PaxColumn
+{
+  int32_t offset;           ///< 字段在记录中的偏移量
+  int32_t len;              ///< 字段的长度
+  int32_t minipage_offset;  ///< 该字段的minipage在页面中的偏移量
+};
+
+/**
+ * @brief 变长页面(包括溢出页面)在 PageHeader 之后的页头
+ * @ingroup RecordManager
+ * @details 变长页面的 record_size 是一条记录最多占用的空间，record_capacity 是最多能有多少个槽位。
+ */
+struct VarlenPageHeader
+{
+  int32_t slot_num;       ///< slot directory 中的槽位个数
+  int32_t free_offset;    ///< 记录从页面尾部向前存放，这是最前面一条记录的位置
+  int32_t fragment_size;  ///< 删除的或者变短的记录留下的空间，整理页面后可以使用
+  PageNum overflow_page;  ///< 最近一次存放溢出记录的页面
+};
+
+/**
+ * @brief 变长页面上一个变长字段的描述
+ * @ingroup RecordManager
+ * @details 变长字段在页面上存放为2字节的长度和实际的字符串，读取出来的记录中还是占用 len 个字节，后面补0
+ */
+struct VarcharColumn
+{
+  int32_t offset;  ///< 字段在记录中的偏移量
+  int32_t len;     ///< 字段最大长度
+};
+
+/**
+ * @brief 变长页面 slot directory 中的一项
+ * @ingroup RecordManager
+ */
+struct RecordSlot
+{
+  static constexpr uint16_t MOVED = 1;  ///< 记录搬到了溢出页面，这里存放的是溢出记录的RID
+
+  uint16_t offset;  ///< 记录在页面中的偏移量
+  uint16_t len;     ///< 记录占用的空间，空闲的槽位是0
+  uint16_t flags;
 };
 
 /**
@@ -99,6 +174,16 @@ public:
    */
   RC   next(Record &record);
 
+  /**
+   * @brief 跳过下一个记录，不读取记录数据
+   */
+  void skip();
+
+  /**
+   * @brief 下一个记录的槽位
+   */
+  SlotNum next_slot_num() const { return next_slot_num_; }
+
   /**
    * 该迭代器是否有效
    */
@@ -120,6 +205,26 @@ private:
  * |------------|------------------------|
  * | record1 | record2 | ..... | recordN |
  * @endcode
+ * PAX格式的页面槽位与行存一样，但是同一个字段的数据放在一起：
+ * @code
+ * | PageHeader | PaxColumn1 ... PaxColumnM | record allocate bitmap |
+ * |------------|---------------------------|------------------------|
+ * | minipage1: field1 of record1 | field1 of record2 | ... | field1 of recordN |
+ * | ...                                                                      |
+ * | minipageM: fieldM of record1 | fieldM of record2 | ... | fieldM of recordN |
+ * @endcode
+ * 变长页面上的记录按照实际长度从页面尾部向前存放，slot directory 记录每个槽位上记录的位置：
+ * @code
+ * | PageHeader | VarlenPageHeader | VarcharColumn1 ... VarcharColumnM | record allocate bitmap |
+ * |------------|------------------|-----------------------------------|------------------------|
+ * | slot1 | slot2 | ... | slotN | --> free space <-- | recordX | ... | record2 | record1 |
+ * @endcode
+ * 删除记录和记录变短留下的空间在空闲空间不够时通过整理页面回收。记录变长以后页面上放不下时，会搬到溢出页面，
+ * 原来的位置存放溢出记录的RID，这样记录的RID不会变化。
+ *
+ * PAX页面和变长页面上的记录不是按照原样存放的，读取记录时会拼到 RecordPageHandler 自己的缓存中，返回的记录
+ * 指向这个缓存，再读取下一条记录前有效。以写模式访问页面时，对记录的修改会在读取下一条记录或者 cleanup 时写回页面。
+ * 只需要个别字段的时候，可以使用 field_data 直接访问页面上的字段。
  */
 class RecordPageHandler
 {
@@ -144,6 +249,11 @@ public:
    */
   RC recover_init(DiskBufferPool &buffer_pool, PageNum page_num);
 
+  /**
+   * @brief 以写模式访问调用者已经加了写锁的页面，不再加锁，cleanup 时也不会解锁
+   */
+  RC init_latched(DiskBufferPool &buffer_pool, PageNum page_num);
+
   /**
    * @brief 对一个新的页面做初始化，初始化关于该页面记录信息的页头PageHeader
    *
@@ -153,6 +263,26 @@ public:
    */
   RC init_empty_page(DiskBufferPool &buffer_pool, PageNum page_num, int record_size);
 
+  /**
+   * @brief 对一个新的页面做初始化，使用PAX格式存放记录
+   *
+   * @param buffer_pool 关联某个文件时，都通过buffer pool来做读写文件
+   * @param page_num    当前处理哪个页面
+   * @param columns     记录中每个字段的偏移量和长度，minipage_offset 不需要设置
+   */
+  RC init_empty_pax_page(DiskBufferPool &buffer_pool, PageNum page_num, const std::vector<PaxColumn> &columns);
+
+  /**
+   * @brief 对一个新的页面做初始化，按照实际长度存放变长记录
+   *
+   * @param buffer_pool 关联某个文件时，都通过buffer pool来做读写文件
+   * @param page_num    当前处理哪个页面
+   * @param record_size 记录的大小，变长字段按照最大长度计算
+   * @param columns     记录中的变长字段
+   */
+  RC init_empty_varlen_page(
+      DiskBufferPool &buffer_pool, PageNum page_num, int record_size, const std::vector<VarcharColumn> &columns);
+
   /**
    * @brief 操作结束后做的清理工作，比如释放页面、解锁
    */
@@ -181,6 +311,14 @@ public:
    */
   RC delete_record(const RID *rid);
 
+  /**
+   * @brief 把修改后的记录写回页面
+   * @details 变长页面上放不下时会把记录搬到溢出页面，失败时页面上的记录保持不变
+   * @param slot_num 记录的槽位
+   * @param data     修改后的完整记录
+   */
+  RC update_record(SlotNum slot_num, const char *data);
+
   /**
    * @brief 获取指定位置的记录数据
    *
@@ -189,6 +327,19 @@ public:
    */
   RC get_record(const RID *rid, Record *rec);
 
+  /**
+   * @brief 获取指定槽位上记录的某个字段
+   * @details 不会拼接整条记录，在PAX页面上只访问这个字段所在的minipage
+   * @param slot_num 记录的槽位，调用者保证槽位上有记录
+   * @param offset   字段在记录中的偏移量
+   */
+  const char *field_data(SlotNum slot_num, int offset);
+
+  /**
+   * @brief 页面的存放格式
+   */
+  PageFormat page_format() const { return static_cast<PageFormat>(page_header_->page_format); }
+
   /**
    * @brief 返回该记录页的页号
    */
@@ -199,6 +350,16 @@ public:
    */
   bool is_full() const;
 
+  /**
+   * @brief 页面上的记录是否对所有事务都可见，参考 Frame::all_visible
+   */
+  bool is_all_visible() const { return frame_->all_visible(); }
+
+  /**
+   * @brief 设置页面全部可见的提示。调用者需要保证页面上的每条记录都对所有事务可见
+   */
+  void mark_all_visible() { frame_->set_all_visible(); }
+
 protected:
   /**
    * @details 
@@ -209,7 +370,7 @@ protected:
   void fix_record_capacity() {
     int32_t last_record_offset = page_header_->first_record_offset + 
                                  page_header_->record_capacity * page_header_->record_size;
-    while(last_record_offset > BP_PAGE_DATA_SIZE) {
+    while(last_record_offset > frame_->data_size()) {
       page_header_->record_capacity -= 1;
       last_record_offset -= page_header_->record_size;
     }
@@ -225,12 +386,104 @@ protected:
     return frame_->data() + page_header_->first_record_offset + (page_header_->record_size * slot_num);
   }
 
+  /**
+   * @brief 获取指定槽位的一条完整的记录
+   * @details 行存页面直接返回页面上的数据，PAX页面和变长页面会将记录拼接到 row_buffer_ 中
+   */
+  char *load_record(SlotNum slot_num);
+
+  /**
+   * @brief 将一条记录拆分到PAX页面的各个minipage中
+   * @return 页面上的数据是否有变化
+   */
+  bool scatter_record(SlotNum slot_num, const char *data);
+
+  /**
+   * @brief 获取页面并解析页头，参考 init 和 init_latched
+   * @param latch         是否对页面加锁
+   * @param check_version 是否检查页面格式的版本，初始化新页面时不检查
+   */
+  RC init_page(DiskBufferPool &buffer_pool, PageNum page_num, bool readonly, bool latch, bool check_version);
+
+  /**
+   * @brief 以写模式访问PAX页面或变长页面时，将 row_buffer_ 中可能被修改的记录写回页面
+   */
+  RC flush_row_buffer();
+
+  /**
+   * @brief 初始化变长页面或者溢出页面
+   */
+  RC init_empty_slotted_page(DiskBufferPool &buffer_pool, PageNum page_num, PageFormat page_format, int record_size,
+      const std::vector<VarcharColumn> &columns);
+
+  VarlenPageHeader *varlen_header() const { return varlen_header_; }
+  RecordSlot *record_slot(SlotNum slot_num) const
+  {
+    return (RecordSlot *)(frame_->data() + page_header_->first_record_offset) + slot_num;
+  }
+
+  /**
+   * @brief 按照实际长度编码一条记录，返回编码后的长度
+   */
+  int encode_record(const char *data, char *buf) const;
+  void decode_record(const char *buf, char *data) const;
+
+  /**
+   * @brief 变长页面上的空闲空间，包括需要整理页面才能使用的空间
+   */
+  int free_space() const;
+
+  /**
+   * @brief 从空闲空间中分配 size 个字节存放记录，同时给 slot directory 预留 slot_size 个字节
+   * @details 连续的空闲空间不够时会整理页面
+   * @return 分配的空间在页面中的偏移量。空间不够时返回-1
+   */
+  int allocate_space(int size, int slot_size);
+
+  /**
+   * @brief 整理页面，将所有记录移动到页面尾部，回收碎片空间
+   */
+  void compact();
+
+  /**
+   * @brief 在变长页面上存放一条编码后的记录
+   */
+  RC insert_slot_data(const char *buf, int len, SlotNum *slot_num);
+
+  /**
+   * @brief 修改变长页面上一个槽位的数据，必要时在页面内移动记录
+   * @return 页面上放不下时返回false，原来的数据不变
+   */
+  bool update_slot_data(SlotNum slot_num, const char *buf, int len);
+
+  /**
+   * @brief 释放变长页面上一个槽位的空间
+   */
+  void free_slot_data(SlotNum slot_num);
+
+  /**
+   * @brief 将一条变长记录写回页面，放不下时搬到溢出页面
+   */
+  RC store_record(SlotNum slot_num, const char *data);
+
+  /**
+   * @brief 将编码后的记录存放到溢出页面上，需要时分配新的溢出页面
+   */
+  RC insert_overflow_record(const char *buf, int len, RID *rid);
+
 protected:
   DiskBufferPool *disk_buffer_pool_ = nullptr;  ///< 当前操作的buffer pool(文件)
   Frame          *frame_            = nullptr;  ///< 当前操作页面关联的frame(frame的更多概念可以参考buffer pool和frame)
   bool            readonly_         = false;    ///< 当前的操作是否都是只读的
+  bool            latched_          = true;     ///< 页面锁是否由当前对象加的，参考 init_latched
   PageHeader     *page_header_      = nullptr;  ///< 当前页面上页面头
   char           *bitmap_           = nullptr;  ///< 当前页面上record分配状态信息bitmap内存起始位置
+  PaxColumn      *pax_columns_      = nullptr;  ///< PAX页面上每个字段的描述
+  VarlenPageHeader *varlen_header_  = nullptr;  ///< 变长页面的页头
+  VarcharColumn  *varchar_columns_  = nullptr;  ///< 变长页面上每个变长字段的描述
+  std::vector<char> row_buffer_;               ///< PAX页面和变长页面上拼接出来的记录
+  std::vector<char> encode_buffer_;            ///< 变长页面上编码记录使用的缓存
+  SlotNum         row_buffer_slot_  = -1;       ///< row_buffer_ 中是哪个槽位的记录，只在写模式下需要写回时记录
 
 private:
   friend class RecordPageIterator;
@@ -250,9 +503,12 @@ public:
   /**
    * @brief 初始化
    *
-   * @param buffer_pool 当前操作的是哪个文件
+   * @param buffer_pool    当前操作的是哪个文件
+   * @param storage_format 新分配的页面使用什么格式存放记录。已有的页面按照页面自己的格式访问
+   * @param fields         记录的字段，PAX格式时按照字段划分minipage。有变长字段的行存表使用变长页面
    */
-  RC init(DiskBufferPool *buffer_pool);
+  RC init(DiskBufferPool *buffer_pool, StorageFormat storage_format = ROW_FORMAT,
+      const std::vector<FieldMeta> *fields = nullptr);
 
   /**
    * @brief 关闭，做一些资源清理的工作
@@ -275,6 +531,17 @@ public:
    */
   RC insert_record(const char *data, int record_size, RID *rid);
 
+  /**
+   * @brief 插入多条记录
+   * @details 每拿到一个没有填满的页面，就在持有页面锁期间尽量多的插入记录，页面满了再找下一个页面。
+   * 中间失败时，已经插入的记录不会删除，rids 中前面的位置就是已经插入的记录
+   * @param datas       所有记录的内容
+   * @param record_size 记录大小
+   * @param rids        返回每个记录的标识符，与 datas 一一对应
+   * @param inserted    返回插入成功的记录数
+   */
+  RC insert_records(const std::vector<const char *> &datas, int record_size, std::vector<RID> &rids, int &inserted);
+
    /**
    * @brief 数据库恢复时，在指定文件指定位置插入数据
    * 
@@ -305,18 +572,66 @@ public:
    */
   RC visit_record(const RID &rid, bool readonly, std::function<void(Record &)> visitor);
 
+  /**
+   * @brief 把直接修改过的记录写回页面
+   * @details 修改了以读写方式获取的记录数据之后调用，调用者持有页面的写锁，参考 Table::update_record
+   */
+  RC update_record(const Record &record);
+
+  /**
+   * @brief 指定页面上的记录是否对所有事务都可见
+   * @details 只检查已经在内存中的页面，不在内存中的页面认为不是全部可见的，不会从磁盘加载
+   * @param page_num 页面编号
+   */
+  bool is_page_all_visible(PageNum page_num);
+
 private:
   /**
    * @brief 初始化当前没有填满记录的页面，初始化free_pages_成员
    */
   RC init_free_pages();
 
+  /**
+   * @brief 找一个没有填满的页面，没有就分配一个新页面，返回时已经拿到了页面的写锁
+   */
+  RC get_free_page(int record_size, RecordPageHandler &record_page_handler);
+
 private:
   DiskBufferPool             *disk_buffer_pool_ = nullptr;
+  PageFormat                  page_format_      = ROW_PAGE;  ///< 新页面的存放格式
+  std::vector<PaxColumn>      pax_columns_;  ///< PAX格式时每个字段的偏移量和长度
+  std::vector<VarcharColumn>  varchar_columns_;  ///< 变长页面上的变长字段
   std::unordered_set<PageNum> free_pages_;  ///< 没有填充满的页面集合
   common::Mutex               lock_;        ///< 当编译时增加-DCONCURRENCY=ON 选项时，才会真正的支持并发
 };
 
+/**
+ * @brief 并行扫描时给多个扫描器分配页面
+ * @ingroup RecordManager
+ * @details 文件中的页面按照 MORSEL_PAGES 个一组(morsel)分配出去，扫描器扫描完一组页面再来取下一组。
+ * 多个线程各自使用一个 RecordFileScanner 扫描同一个文件，处理快的线程会多取一些页面，工作量自动均衡。
+ */
+class MorselQueue
+{
+public:
+  static constexpr int MORSEL_PAGES = 8;
+
+  MorselQueue() = default;
+  ~MorselQueue() = default;
+
+  RC init(DiskBufferPool &buffer_pool);
+
+  /**
+   * @brief 取下一组页面，线程安全
+   * @return 没有页面时返回false
+   */
+  bool next(std::vector<PageNum> &pages);
+
+private:
+  std::mutex         lock_;
+  BufferPoolIterator bp_iterator_;
+};
+
 /**
  * @brief 遍历某个文件中所有记录
  * @ingroup RecordManager
@@ -335,10 +650,27 @@ public:
    * @param buffer_pool      访问的文件
    * @param readonly         当前是否只读操作。访问数据时，需要对页面加锁。比如
    *                         删除时也需要遍历找到数据，然后删除，这时就需要加写锁
-   * @param condition_filter 做一些初步过滤操作
+   * @param condition_filter 做一些初步过滤操作。记录还在页面上时过滤，早于事务的可见性检查和记录的拷贝
    */
   RC open_scan(Table *table, DiskBufferPool &buffer_pool, Trx *trx, bool readonly, ConditionFilter *condition_filter);
 
+  /**
+   * @brief 按照固定的间隔采样页面，每 step 个页面只访问第一个
+   * @details 需要在 open_scan 之前调用，用于统计信息的收集
+   */
+  void set_sample_step(int step) { sample_step_ = step > 0 ? step : 1; }
+
+  /**
+   * @brief 已经访问过的页面个数
+   */
+  int sampled_pages() const { return sampled_pages_; }
+
+  /**
+   * @brief 只扫描从 morsel_queue 中取到的页面，用于并行扫描
+   * @details 需要在 open_scan 之前调用
+   */
+  void set_morsel_queue(MorselQueue *morsel_queue) { morsel_queue_ = morsel_queue; }
+
   /**
    * @brief 关闭一个文件扫描，释放相应的资源
    */
@@ -346,7 +678,9 @@ public:
 
   /** 
    * @brief 判断是否还有数据
-   * @details 判断完成后调用next获取下一条数据
+   * @details 判断完成后调用next获取下一条数据。
+   * 下一条记录在这里才去获取，获取时可能会离开上一条记录所在的页面，或者覆盖PAX页面上拼接记录的缓存，
+   * 所以调用之前要用完上一条记录。
    */
   bool has_next();
 
@@ -370,6 +704,22 @@ private:
    */
   RC fetch_next_record_in_page();
 
+  /**
+   * @brief 下一个要扫描的页面
+   */
+  bool next_page(PageNum &page_num);
+
+  /**
+   * @brief 页面上的记录不满足过滤条件时，检查对当前事务可见的旧版本是否满足
+   * @details 参考 Trx::has_old_versions，满足时 next_record_ 指向这个旧版本
+   */
+  bool old_version_matches();
+
+  /**
+   * @brief 释放页面锁，等待当前记录的行锁，然后重新定位到当前记录
+   */
+  RC wait_for_lock();
+
 private:
   // TODO 对于一个纯粹的record遍历器来说，不应该关心表和事务
   Table             *table_            = nullptr;  ///< 当前遍历的是哪张表。这个字段仅供事务函数使用，如果设计合适，可以去掉
@@ -378,8 +728,18 @@ private:
   bool               readonly_         = false;    ///< 遍历出来的数据，是否可能对它做修改
 
   BufferPoolIterator bp_iterator_;                 ///< 遍历buffer pool的所有页面
-  ConditionFilter   *condition_filter_ = nullptr;  ///< 过滤record
+  ConditionFilter   *condition_filter_ = nullptr;  ///< 过滤record，在可见性检查之前直接作用在页面上的记录
   RecordPageHandler  record_page_handler_;         ///< 处理文件某页面的记录
   RecordPageIterator record_page_iterator_;        ///< 遍历某个页面上的所有record
   Record             next_record_;                 ///< 获取的记录放在这里缓存起来
+  bool               fetched_          = false;    ///< next_record_ 是否已经获取了
+  RC                 fetch_rc_         = RC::SUCCESS;  ///< 获取 next_record_ 的结果
+  bool               page_all_visible_ = false;    ///< 当前页面已经遍历过的记录是否都对所有事务可见
+  bool               page_has_old_versions_ = false;  ///< 当前页面上是否有记录需要通过旧版本判断可见性
+  int                sample_step_      = 1;        ///< 采样页面的间隔，1表示访问所有页面
+  int                page_index_       = 0;        ///< 当前是第几个页面，用于采样
+  int                sampled_pages_    = 0;        ///< 访问过的页面个数
+  MorselQueue       *morsel_queue_     = nullptr;  ///< 并行扫描时从这里获取页面
+  std::vector<PageNum> morsel_pages_;              ///< 当前这一组页面
+  size_t             morsel_index_     = 0;        ///< 下一个要扫描的页面在 morsel_pages_ 中的位置
 };
\ No newline at end of file
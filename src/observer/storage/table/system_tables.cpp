@@ -0,0 +1,117 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+
+#include "storage/table/system_tables.h"
+#include "common/log/log.h"
+#include "session/statement_digest.h"
+#include "sql/parser/parse_defs.h"
+#include "storage/record/record.h"
+#include "storage/table/table.h"
+
+using namespace std;
+
+static int clamp_to_int(int64_t value)
+{
+  return static_cast<int>(min<int64_t>(value, INT32_MAX));
+}
+
+static float to_us(int64_t latency_ns)
+{
+  return static_cast<float>(latency_ns) / 1000.0f;
+}
+
+static RC statement_digest_rows(Table &table, vector<Record> &records)
+{
+  vector<StatementDigestStats::Snapshot> snapshots = StatementDigests::instance().snapshot();
+  records.reserve(snapshots.size());
+  for (const StatementDigestStats::Snapshot &snapshot : snapshots) {
+    char digest[17];
+    snprintf(digest, sizeof(digest), "%016" PRIx64, snapshot.digest);
+
+    const int64_t avg_latency_ns = snapshot.exec_count == 0 ? 0 : snapshot.total_latency_ns / snapshot.exec_count;
+    Value values[] = {
+        Value(digest),
+        Value(snapshot.digest_text.c_str()),
+        Value(clamp_to_int(snapshot.exec_count)),
+        Value(to_us(snapshot.total_latency_ns)),
+        Value(to_us(avg_latency_ns)),
+        Value(to_us(snapshot.min_latency_ns)),
+        Value(to_us(snapshot.max_latency_ns)),
+        Value(to_us(snapshot.p95_latency_ns)),
+        Value(to_us(snapshot.p99_latency_ns)),
+        Value(clamp_to_int(snapshot.rows_examined)),
+        Value(clamp_to_int(snapshot.rows_returned)),
+        Value(clamp_to_int(snapshot.buffer_hits)),
+        Value(clamp_to_int(snapshot.buffer_misses)),
+        Value(clamp_to_int(snapshot.log_bytes)),
+    };
+
+    Record record;
+    RC rc = table.make_record(sizeof(values) / sizeof(values[0]), values, record);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to make record of statement digest. rc=%s", strrc(rc));
+      return rc;
+    }
+    records.push_back(std::move(record));
+  }
+  return RC::SUCCESS;
+}
+
+/**
+ * @brief 初始化 statement_digests 系统表，延迟的单位是微秒
+ */
+static Table *create_statement_digests_table()
+{
+  const AttrInfoSqlNode attributes[] = {
+      {CHARS, "digest", 16},
+      {CHARS, "digest_text", ParsedSqlResult::MAX_DIGEST_TEXT_LENGTH},
+      {INTS, "exec_count", sizeof(int)},
+      {FLOATS, "total_latency_us", sizeof(float)},
+      {FLOATS, "avg_latency_us", sizeof(float)},
+      {FLOATS, "min_latency_us", sizeof(float)},
+      {FLOATS, "max_latency_us", sizeof(float)},
+      {FLOATS, "p95_latency_us", sizeof(float)},
+      {FLOATS, "p99_latency_us", sizeof(float)},
+      {INTS, "rows_examined", sizeof(int)},
+      {INTS, "rows_returned", sizeof(int)},
+      {INTS, "buffer_hits", sizeof(int)},
+      {INTS, "buffer_misses", sizeof(int)},
+      {INTS, "log_bytes", sizeof(int)},
+  };
+
+  Table *table = new Table();
+  RC rc = table->init_virtual(-1 /*table_id*/,
+      SystemTables::STATEMENT_DIGESTS,
+      sizeof(attributes) / sizeof(attributes[0]),
+      attributes,
+      statement_digest_rows);
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("failed to init system table %s. rc=%s", SystemTables::STATEMENT_DIGESTS, strrc(rc));
+    delete table;
+    return nullptr;
+  }
+  return table;
+}
+
+Table *SystemTables::find(const char *table_name)
+{
+  if (table_name == nullptr || strcmp(table_name, STATEMENT_DIGESTS) != 0) {
+    return nullptr;
+  }
+
+  // 表的字段中有事务使用的隐藏字段，要在事务模块初始化之后再创建
+  static Table *statement_digests = create_statement_digests_table();
+  return statement_digests;
+}
@@ -0,0 +1,30 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+class Table;
+
+/**
+ * @brief 系统表
+ * @details 系统表是只读的虚拟表，数据在查询时从内存中的统计信息生成，不属于任何一个 Db，
+ * 查询和 desc 在当前 Db 中找不到表时会再查找系统表。当前只有一个系统表：
+ * statement_digests 按照语句摘要汇总的执行统计，参考 StatementDigests
+ */
+class SystemTables
+{
+public:
+  static constexpr const char *STATEMENT_DIGESTS = "statement_digests";
+
+  /**
+   * @brief 根据名字查找系统表，没有时返回空
+   */
+  static Table *find(const char *table_name);
+};
@@ -14,7 +14,9 @@ See the Mulan PSL v2 for more details. */
 
 #include <limits.h>
 #include <string.h>
+#include <unistd.h>
 #include <algorithm>
+#include <fstream>
 
 #include "common/defs.h"
 #include "storage/table/table.h"
@@ -58,7 +60,9 @@ RC Table::create(int32_t table_id,
                  const char *name, 
                  const char *base_dir, 
                  int attribute_count, 
-                 const AttrInfoSqlNode attributes[])
+                 const AttrInfoSqlNode attributes[],
+                 StorageFormat storage_format,
+                 int page_size)
 {
   if (table_id < 0) {
     LOG_WARN("invalid table id. table_id=%d, table_name=%s", table_id, name);
@@ -76,6 +80,11 @@ RC Table::create(int32_t table_id,
     return RC::INVALID_ARGUMENT;
   }
 
+  if (!bp_valid_page_size(page_size)) {
+    LOG_WARN("Invalid page size. table_name=%s, page_size=%d", name, page_size);
+    return RC::INVALID_ARGUMENT;
+  }
+
   RC rc = RC::SUCCESS;
 
   // 使用 table_name.table记录一个表的元数据
@@ -93,7 +102,7 @@ RC Table::create(int32_t table_id,
   close(fd);
 
   // 创建文件
-  if ((rc = table_meta_.init(table_id, name, attribute_count, attributes)) != RC::SUCCESS) {
+  if ((rc = table_meta_.init(table_id, name, attribute_count, attributes, storage_format)) != RC::SUCCESS) {
     LOG_ERROR("Failed to init table meta. name:%s, ret:%d", name, rc);
     return rc;  // delete table file
   }
@@ -111,7 +120,7 @@ RC Table::create(int32_t table_id,
 
   std::string data_file = table_data_file(base_dir, name);
   BufferPoolManager &bpm = BufferPoolManager::instance();
-  rc = bpm.create_file(data_file.c_str());
+  rc = bpm.create_file(data_file.c_str(), page_size);
   if (rc != RC::SUCCESS) {
     LOG_ERROR("Failed to create disk buffer pool of data file. file name=%s", data_file.c_str());
     return rc;
@@ -146,6 +155,14 @@ RC Table::drop(const char *table_name)
   if (rc != RC::SUCCESS) {
     return rc;
   }
+  // 统计信息文件只有分析过的表才有
+  std::string stats_file = table_stats_file(base_dir_.c_str(), table_name);
+  if (0 == access(stats_file.c_str(), F_OK)) {
+    rc = persistHandler.remove_file(stats_file.c_str());
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+  }
   // 删除索引
   for (auto index : indexes_) {
     std::string index_file = base_dir_ + "/" + table_name + "-" + index->index_meta().name() + ".index";
@@ -223,6 +240,7 @@ RC Table::open(const char *meta_file, const char *base_dir)
     indexes_.push_back(index);
   }
 
+  rc = load_stats();
   return rc;
 }
 
@@ -247,7 +265,54 @@ RC Table::insert_record(Record &record)
       LOG_PANIC("Failed to rollback record data when insert index entries failed. table name=%s, rc=%d:%s",
                 name(), rc2, strrc(rc2));
     }
+  } else {
+    row_count_delta_++;
+  }
+  return rc;
+}
+
+RC Table::insert_records(std::vector<Record> &records)
+{
+  std::vector<const char *> datas(records.size());
+  for (size_t i = 0; i < records.size(); i++) {
+    datas[i] = records[i].data();
+  }
+
+  std::vector<RID> rids;
+  int inserted = 0;
+  RC rc = record_handler_->insert_records(datas, table_meta_.record_size(), rids, inserted);
+  if (OB_SUCC(rc)) {
+    for (Index *index : indexes_) {
+      rc = index->insert_entries(datas, rids);
+      if (OB_FAIL(rc)) { // 可能出现了键值重复
+        break;
+      }
+    }
+  }
+
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to insert records. table name=%s, record num=%d, rc=%s",
+             name(), static_cast<int>(records.size()), strrc(rc));
+    // 每个索引插入了多少项不确定，不存在的索引项直接忽略
+    for (Index *index : indexes_) {
+      for (int i = 0; i < inserted; i++) {
+        (void)index->delete_entry(datas[i], &rids[i]);
+      }
+    }
+    for (int i = 0; i < inserted; i++) {
+      RC rc2 = record_handler_->delete_record(&rids[i]);
+      if (rc2 != RC::SUCCESS) {
+        LOG_PANIC("Failed to rollback record data when insert records failed. table name=%s, rc=%d:%s",
+                  name(), rc2, strrc(rc2));
+      }
+    }
+    return rc;
+  }
+
+  for (size_t i = 0; i < records.size(); i++) {
+    records[i].set_rid(rids[i]);
   }
+  row_count_delta_ += static_cast<int64_t>(records.size());
   return rc;
 }
 
@@ -302,6 +367,29 @@ RC Table::recover_insert_record(Record &record)
   return rc;
 }
 
+RC Table::init_virtual(int32_t table_id,
+                       const char *name,
+                       int attribute_count,
+                       const AttrInfoSqlNode attributes[],
+                       VirtualRowsSource rows_source)
+{
+  RC rc = table_meta_.init(table_id, name, attribute_count, attributes);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to init virtual table meta. name=%s, rc=%s", name, strrc(rc));
+    return rc;
+  }
+
+  virtual_rows_source_ = std::move(rows_source);
+  LOG_INFO("Successfully init virtual table %s", name);
+  return rc;
+}
+
+RC Table::scan_virtual_records(std::vector<Record> &records)
+{
+  ASSERT(is_virtual(), "cannot scan a normal table as virtual table. name=%s", name());
+  return virtual_rows_source_(*this, records);
+}
+
 const char *Table::name() const
 {
   return table_meta_.name();
@@ -363,7 +451,7 @@ RC Table::init_record_handler(const char *base_dir)
   }
 
   record_handler_ = new RecordFileHandler();
-  rc = record_handler_->init(data_buffer_pool_);
+  rc = record_handler_->init(data_buffer_pool_, table_meta_.storage_format(), table_meta_.field_metas());
   if (rc != RC::SUCCESS) {
     LOG_ERROR("Failed to init record handler. rc=%s", strrc(rc));
     data_buffer_pool_->close_file();
@@ -376,9 +464,122 @@ RC Table::init_record_handler(const char *base_dir)
   return rc;
 }
 
-RC Table::get_record_scanner(RecordFileScanner &scanner, Trx *trx, bool readonly)
+RC Table::analyze(Trx *trx)
+{
+  std::vector<const FieldMeta *> fields;
+  const std::vector<FieldMeta> &field_metas = *table_meta_.field_metas();
+  for (int i = table_meta_.sys_field_num(); i < table_meta_.field_num(); i++) {
+    fields.push_back(&field_metas[i]);
+  }
+
+  // 第0个页面是文件头，不存放数据
+  const int total_pages = std::max(data_buffer_pool_->allocated_pages() - 1, 0);
+  const int sample_step = std::max((total_pages + TableStats::MAX_SAMPLE_PAGES - 1) / TableStats::MAX_SAMPLE_PAGES, 1);
+
+  TableStatsCollector collector(fields);
+  RecordFileScanner scanner;
+  scanner.set_sample_step(sample_step);
+  RC rc = scanner.open_scan(this, *data_buffer_pool_, trx, true/*readonly*/, nullptr);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to open scanner to analyze table. table=%s, rc=%s", name(), strrc(rc));
+    return rc;
+  }
+
+  Record record;
+  while (scanner.has_next()) {
+    rc = scanner.next(record);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to read record while analyzing table. table=%s, rc=%s", name(), strrc(rc));
+      scanner.close_scan();
+      return rc;
+    }
+    collector.add(record);
+  }
+  const int sampled_pages = scanner.sampled_pages();
+  scanner.close_scan();
+
+  std::shared_ptr<TableStats> table_stats = collector.finish(total_pages, sampled_pages);
+  rc = save_stats(*table_stats);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(stats_lock_);
+    stats_ = table_stats;
+    row_count_delta_ = 0;
+  }
+  LOG_INFO("analyze table done. table=%s, total pages=%d, sampled pages=%d, rows=%ld",
+           name(), total_pages, sampled_pages, table_stats->row_count());
+  return RC::SUCCESS;
+}
+
+std::shared_ptr<const TableStats> Table::stats() const
 {
-  RC rc = scanner.open_scan(this, *data_buffer_pool_, trx, readonly, nullptr);
+  std::lock_guard<std::mutex> guard(stats_lock_);
+  return stats_;
+}
+
+int64_t Table::row_count() const
+{
+  std::shared_ptr<const TableStats> table_stats = stats();
+  if (!table_stats) {
+    return -1;
+  }
+  return std::max<int64_t>(table_stats->row_count() + row_count_delta_.load(), 0);
+}
+
+RC Table::load_stats()
+{
+  std::string stats_file = table_stats_file(base_dir_.c_str(), name());
+  std::ifstream fs(stats_file, std::ios_base::in | std::ios_base::binary);
+  if (!fs.is_open()) {
+    // 没有分析过的表
+    return RC::SUCCESS;
+  }
+
+  std::shared_ptr<TableStats> table_stats(new TableStats);
+  if (table_stats->deserialize(fs) < 0) {
+    // 统计信息只影响执行计划的选择，出错时忽略
+    LOG_WARN("failed to load table stats, ignore it. file=%s", stats_file.c_str());
+    return RC::SUCCESS;
+  }
+
+  std::lock_guard<std::mutex> guard(stats_lock_);
+  stats_ = table_stats;
+  row_count_delta_ = 0;
+  return RC::SUCCESS;
+}
+
+RC Table::save_stats(const TableStats &table_stats)
+{
+  // 与元数据文件一样，先写临时文件再rename，防止文件内容不完整
+  std::string stats_file = table_stats_file(base_dir_.c_str(), name());
+  std::string tmp_file = stats_file + ".tmp";
+  std::fstream fs;
+  fs.open(tmp_file, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+  if (!fs.is_open()) {
+    LOG_ERROR("Failed to open file for write. file name=%s, errmsg=%s", tmp_file.c_str(), strerror(errno));
+    return RC::IOERR_OPEN;
+  }
+  if (table_stats.serialize(fs) < 0) {
+    LOG_ERROR("Failed to dump table stats to file: %s. sys err=%d:%s", tmp_file.c_str(), errno, strerror(errno));
+    return RC::IOERR_WRITE;
+  }
+  fs.close();
+
+  int ret = rename(tmp_file.c_str(), stats_file.c_str());
+  if (ret != 0) {
+    LOG_ERROR("Failed to rename tmp stats file (%s) to normal stats file (%s). system error=%d:%s",
+              tmp_file.c_str(), stats_file.c_str(), errno, strerror(errno));
+    return RC::IOERR_WRITE;
+  }
+  return RC::SUCCESS;
+}
+
+RC Table::get_record_scanner(RecordFileScanner &scanner, Trx *trx, bool readonly, ConditionFilter *condition_filter)
+{
+  RC rc = scanner.open_scan(this, *data_buffer_pool_, trx, readonly, condition_filter);
   if (rc != RC::SUCCESS) {
     LOG_ERROR("failed to open scanner. rc=%s", strrc(rc));
   }
@@ -405,7 +606,8 @@ RC Table::create_index(Trx *trx, std::vector<const FieldMeta *> &field_metas, co
   // 创建索引相关数据
   BplusTreeIndex *index = new BplusTreeIndex(); // DONE
   std::string index_file = table_index_file(base_dir_.c_str(), name(), index_name);
-  rc = index->create(index_file.c_str(), new_index_meta, field_metas);  // modify
+  // 索引文件使用与数据文件相同的页面大小
+  rc = index->create(index_file.c_str(), new_index_meta, field_metas, data_buffer_pool_->page_size());  // modify
   if (rc != RC::SUCCESS) {
     delete index;
     LOG_ERROR("Failed to create bplus tree index. file name=%s, rc=%d:%s", index_file.c_str(), rc, strrc(rc));
@@ -495,9 +697,170 @@ RC Table::delete_record(const Record &record)
            name(), index->index_meta().name(), record.rid().to_string().c_str(), strrc(rc));
   }
   rc = record_handler_->delete_record(&record.rid());
+  if (OB_SUCC(rc)) {
+    row_count_delta_--;
+  }
+  return rc;
+}
+
+/**
+ * @brief 这些版本中是否有和 data 索引键值相同的
+ */
+static bool index_key_used(const Index *index, const char *data, const std::vector<const char *> &versions)
+{
+  for (const char *version : versions) {
+    if (index->same_key(data, version)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+RC Table::update_record(Record &record, const char *new_data, const std::vector<const char *> &other_versions)
+{
+  // 原来的数据也可能还被其它版本用到，新的键值可能已经有其它版本插入过了
+  std::vector<const char *> old_versions(other_versions);
+  old_versions.push_back(record.data());
+  std::vector<const char *> new_versions(other_versions);
+  new_versions.push_back(new_data);
+
+  RC rc = RC::SUCCESS;
+  size_t inserted_num = 0;
+  for (; inserted_num < indexes_.size(); inserted_num++) {
+    Index *index = indexes_[inserted_num];
+    if (index_key_used(index, new_data, old_versions)) {
+      continue;
+    }
+
+    rc = index->insert_entry(new_data, &record.rid());
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to insert entry into index. table name=%s, index name=%s, rid=%s, rc=%s",
+               name(), index->index_meta().name(), record.rid().to_string().c_str(), strrc(rc));
+      break;
+    }
+  }
+
+  if (OB_SUCC(rc)) {
+    // 写回页面失败时(比如变长记录放不下，又没有空间分配溢出页面)，页面上还是原来的记录
+    const int record_size = table_meta_.record_size();
+    std::vector<char> old_data(record.data(), record.data() + record_size);
+    memcpy(record.data(), new_data, record_size);
+    rc = record_handler_->update_record(record);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to write back record. table name=%s, rid=%s, rc=%s",
+               name(), record.rid().to_string().c_str(), strrc(rc));
+      memcpy(record.data(), old_data.data(), record_size);
+    } else {
+      // 记录已经更新了，没有版本再用到的原来的索引项才能删除
+      rc = remove_version_entries(old_data.data(), record.rid(), new_versions);
+      ASSERT(RC::SUCCESS == rc, "failed to delete entry from index. table name=%s, rid=%s, rc=%s",
+             name(), record.rid().to_string().c_str(), strrc(rc));
+      return rc;
+    }
+  }
+
+  // 删除已经插入的索引项
+  for (size_t i = 0; i < inserted_num; i++) {
+    Index *index = indexes_[i];
+    if (!index_key_used(index, new_data, old_versions)) {
+      index->delete_entry(new_data, &record.rid());
+    }
+  }
   return rc;
 }
 
+RC Table::remove_version_entries(const char *data, const RID &rid, const std::vector<const char *> &live_versions)
+{
+  for (Index *index : indexes_) {
+    if (index_key_used(index, data, live_versions)) {
+      continue;
+    }
+
+    RC rc = index->delete_entry(data, &rid);
+    if (OB_FAIL(rc) && rc != RC::RECORD_NOT_EXIST) {
+      LOG_WARN("failed to delete entry from index. table name=%s, index name=%s, rid=%s, rc=%s",
+               name(), index->index_meta().name(), rid.to_string().c_str(), strrc(rc));
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC Table::vacuum(PageNum &start_page, int &io_budget, const std::function<bool(const Record &)> &is_dead, int &reclaimed)
+{
+  RC rc = RC::SUCCESS;
+  reclaimed = 0;
+
+  // BufferPoolIterator 返回的是比初始页面号大的页面
+  BufferPoolIterator bp_iterator;
+  bp_iterator.init(*data_buffer_pool_, start_page - 1);
+
+  const int record_size = table_meta_.record_size();
+  std::vector<Record> dead_records;
+  while (io_budget > 0 && bp_iterator.has_next()) {
+    const PageNum page_num = bp_iterator.next();
+    io_budget--;
+
+    // 先以只读的方式找到失效的记录，删除的时候需要使用记录中的数据来删除索引，所以复制出来
+    dead_records.clear();
+    RecordPageHandler page_handler;
+    rc = page_handler.init(*data_buffer_pool_, page_num, true/*readonly*/);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to init record page handler. table=%s, page_num=%d, rc=%s", name(), page_num, strrc(rc));
+      return rc;
+    }
+
+    RecordPageIterator page_iterator;
+    page_iterator.init(page_handler);
+    Record record;
+    while (page_iterator.has_next()) {
+      rc = page_iterator.next(record);
+      if (OB_FAIL(rc)) {
+        break;
+      }
+      if (!is_dead(record)) {
+        continue;
+      }
+
+      char *data = (char *)malloc(record_size);
+      ASSERT(nullptr != data, "failed to malloc memory. record data size=%d", record_size);
+      memcpy(data, record.data(), record_size);
+      dead_records.emplace_back();
+      dead_records.back().set_rid(record.rid());
+      dead_records.back().set_data_owner(data, record_size);
+    }
+    page_handler.cleanup();
+
+    for (const Record &dead_record : dead_records) {
+      // 创建索引时只会插入可见的记录，所以失效记录的索引项可能不存在
+      for (Index *index : indexes_) {
+        rc = index->delete_entry(dead_record.data(), &dead_record.rid());
+        if (OB_FAIL(rc) && rc != RC::RECORD_NOT_EXIST) {
+          LOG_WARN("failed to delete index entry while vacuum. table=%s, index=%s, rid=%s, rc=%s", 
+                   name(), index->index_meta().name(), dead_record.rid().to_string().c_str(), strrc(rc));
+          return rc;
+        }
+      }
+      rc = record_handler_->delete_record(&dead_record.rid());
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to delete record while vacuum. table=%s, rid=%s, rc=%s", 
+                 name(), dead_record.rid().to_string().c_str(), strrc(rc));
+        return rc;
+      }
+      reclaimed++;
+      io_budget--;
+      row_count_delta_--;
+    }
+
+    start_page = page_num + 1;
+  }
+
+  if (!bp_iterator.has_next()) {
+    start_page = BP_INVALID_PAGE_NUM;
+  }
+  return RC::SUCCESS;
+}
+
 RC Table::insert_entry_of_indexes(const char *record, const RID &rid)
 {
   DEBUG_PRINT("debug: table开始从索引中插入一条记录...\n");
@@ -562,6 +925,18 @@ RC Table::sync()
       return rc;
     }
   }
+
+  // 把增量维护的行数也保存下来
+  std::shared_ptr<const TableStats> table_stats = stats();
+  if (table_stats) {
+    TableStats current_stats(*table_stats);
+    current_stats.set_row_count(row_count());
+    rc = save_stats(current_stats);
+    if (OB_FAIL(rc)) {
+      LOG_ERROR("Failed to save table stats. table=%s, rc=%s", name(), strrc(rc));
+      return rc;
+    }
+  }
   LOG_INFO("Sync table over. table=%s", name());
   return rc;
 }
@@ -14,8 +14,13 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <atomic>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include "common/types.h"
 #include "storage/table/table_meta.h"
+#include "storage/table/table_stats.h"
 
 struct RID;
 class Record;
@@ -35,6 +40,12 @@ class Trx;
  */
 class Table 
 {
+public:
+  /**
+   * @brief 虚拟表的数据来源，每次扫描时生成表中所有的行
+   */
+  using VirtualRowsSource = std::function<RC(Table &table, std::vector<Record> &records)>;
+
 public:
   Table() = default;
   ~Table();
@@ -46,13 +57,17 @@ public:
    * @param base_dir 表数据存放的路径
    * @param attribute_count 字段个数
    * @param attributes 字段
+   * @param storage_format 数据页面的存放格式，行存或者PAX
+   * @param page_size 数据文件和索引文件的页面大小，记录在文件头中，打开时从文件头读取
    */
   RC create(int32_t table_id, 
             const char *path, 
             const char *name, 
             const char *base_dir, 
             int attribute_count, 
-            const AttrInfoSqlNode attributes[]);
+            const AttrInfoSqlNode attributes[],
+            StorageFormat storage_format = ROW_FORMAT,
+            int page_size = BP_PAGE_SIZE);
 
   /**
    * 删除本表
@@ -66,6 +81,23 @@ public:
    */
   RC open(const char *meta_file, const char *base_dir);
 
+  /**
+   * @brief 初始化一个虚拟表，比如系统表
+   * @details 虚拟表没有数据文件和索引，只能查询，扫描时通过 rows_source 生成所有的行。参考 SystemTables
+   */
+  RC init_virtual(int32_t table_id,
+                  const char *name,
+                  int attribute_count,
+                  const AttrInfoSqlNode attributes[],
+                  VirtualRowsSource rows_source);
+
+  bool is_virtual() const { return virtual_rows_source_ != nullptr; }
+
+  /**
+   * @brief 生成虚拟表中所有的行
+   */
+  RC scan_virtual_records(std::vector<Record> &records);
+
   /**
    * @brief 根据给定的字段生成一个记录/行
    * @details 通常是由用户传过来的字段，按照schema信息组装成一个record。
@@ -81,7 +113,33 @@ public:
    * @param record[in/out] 传入的数据包含具体的数据，插入成功会通过此字段返回RID
    */
   RC insert_record(Record &record);
+
+  /**
+   * @brief 在当前的表中插入多条记录
+   * @details 记录按页面成批插入，索引项按照键值排序后插入。中间失败时，已经插入的数据都会删掉。
+   * @param records[in/out] 传入的数据包含具体的数据，插入成功会通过每条记录返回RID
+   */
+  RC insert_records(std::vector<Record> &records);
   RC delete_record(const Record &record);
+
+  /**
+   * @brief 原地更新一条记录
+   * @details 只有索引包含的字段发生了变化，才修改这个索引。新的数据直接写到 record 指向的内存中，
+   * 所以 record 需要是以读写方式从页面上获取的。这里只管更新表中的数据，不关心事务相关操作。
+   * 多版本时，旧版本还可能通过索引访问，它们的索引项要保留到旧版本清理时再删除，参考 remove_version_entries。
+   * @param record         要更新的记录
+   * @param new_data       更新之后完整的记录数据
+   * @param other_versions 更新之后这条记录其它还可能被访问的版本，它们用到的索引项不删除
+   */
+  RC update_record(Record &record, const char *new_data, const std::vector<const char *> &other_versions = {});
+
+  /**
+   * @brief 删除一个不再需要的版本的索引项
+   * @details 其它还可能被访问的版本用到的索引项保留。索引项已经不存在时忽略
+   * @param data          不再需要的版本
+   * @param live_versions 这条记录其它还可能被访问的版本，包括页面上的记录
+   */
+  RC remove_version_entries(const char *data, const RID &rid, const std::vector<const char *> &live_versions);
   RC visit_record(const RID &rid, bool readonly, std::function<void(Record &)> visitor);
   RC get_record(const RID &rid, Record &record);
 
@@ -90,13 +148,51 @@ public:
   // TODO refactor
   RC create_index(Trx *trx, std::vector<const FieldMeta *> &field_meta, const char *index_name);
 
-  RC get_record_scanner(RecordFileScanner &scanner, Trx *trx, bool readonly);
+  /**
+   * @brief 打开表的记录扫描器
+   * @param condition_filter 可选的过滤条件，在页面上直接过滤记录，参考 TypedConditionFilter
+   */
+  RC get_record_scanner(RecordFileScanner &scanner, Trx *trx, bool readonly, ConditionFilter *condition_filter = nullptr);
+
+  /**
+   * @brief 清理表中已经失效的记录，参考 MvccVacuum
+   * @details 从 start_page 开始逐页检查，is_dead 判断为失效的记录会从索引和数据文件中删除，
+   * 删除记录后的页面会回到空闲页面集合中。每访问一个页面或者删除一条记录，消耗一个单位的 io_budget，
+   * 预算用完时返回。
+   * @param start_page[in/out] 从哪个页面开始检查，返回下次应该开始的页面，所有页面都检查完时返回 BP_INVALID_PAGE_NUM
+   * @param io_budget[in/out]  可以使用的I/O预算，返回剩余的预算
+   * @param is_dead            判断记录是否已经失效，即对所有事务都不可见
+   * @param reclaimed[out]     清理的记录数
+   */
+  RC vacuum(PageNum &start_page, int &io_budget, const std::function<bool(const Record &)> &is_dead, int &reclaimed);
 
   RecordFileHandler *record_handler() const
   {
     return record_handler_;
   }
 
+  DiskBufferPool *data_buffer_pool() const
+  {
+    return data_buffer_pool_;
+  }
+
+  /**
+   * @brief 采样计算表的统计信息，并保存到文件中
+   * @details 最多采样 TableStats::MAX_SAMPLE_PAGES 个页面，只统计对当前事务可见的记录
+   */
+  RC analyze(Trx *trx);
+
+  /**
+   * @brief 表的统计信息，没有分析过时返回空
+   */
+  std::shared_ptr<const TableStats> stats() const;
+
+  /**
+   * @brief 估算的表中的行数
+   * @details 以最近一次分析的结果为基础，插入删除记录时增量维护，没有分析过时返回-1
+   */
+  int64_t row_count() const;
+
 public:
   int32_t table_id() const { return table_meta_.table_id(); }
   const char *name() const;
@@ -111,6 +207,8 @@ private:
 
 private:
   RC init_record_handler(const char *base_dir);
+  RC load_stats();
+  RC save_stats(const TableStats &table_stats);
 
 public:
   Index *find_index(const char *index_name) const;
@@ -122,4 +220,9 @@ private:
   DiskBufferPool *data_buffer_pool_ = nullptr;   /// 数据文件关联的buffer pool
   RecordFileHandler *record_handler_ = nullptr;  /// 记录操作
   std::vector<Index *> indexes_;
+  VirtualRowsSource    virtual_rows_source_;  ///< 虚拟表的数据来源，普通表为空
+
+  mutable std::mutex                stats_lock_;  ///< 保护 stats_，分析表时会替换
+  std::shared_ptr<const TableStats> stats_;
+  std::atomic<int64_t>              row_count_delta_{0};  ///< 最近一次分析之后，插入的行数减去删除的行数
 };
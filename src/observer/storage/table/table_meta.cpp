@@ -26,12 +26,14 @@ static const Json::StaticString FIELD_TABLE_ID("table_id");
 static const Json::StaticString FIELD_TABLE_NAME("table_name");
 static const Json::StaticString FIELD_FIELDS("fields");
 static const Json::StaticString FIELD_INDEXES("indexes");
+static const Json::StaticString FIELD_STORAGE_FORMAT("storage_format");
 
 TableMeta::TableMeta(const TableMeta &other)
     : table_id_(other.table_id_),
     name_(other.name_),
     fields_(other.fields_),
     indexes_(other.indexes_),
+    storage_format_(other.storage_format_),
     record_size_(other.record_size_)
 {}
 
@@ -40,10 +42,12 @@ void TableMeta::swap(TableMeta &other) noexcept
   name_.swap(other.name_);
   fields_.swap(other.fields_);
   indexes_.swap(other.indexes_);
+  std::swap(storage_format_, other.storage_format_);
   std::swap(record_size_, other.record_size_);
 }
 
-RC TableMeta::init(int32_t table_id, const char *name, int field_num, const AttrInfoSqlNode attributes[])
+RC TableMeta::init(int32_t table_id, const char *name, int field_num, const AttrInfoSqlNode attributes[],
+    StorageFormat storage_format)
 {
   if (common::is_blank(name)) {
     LOG_ERROR("Name cannot be empty");
@@ -77,7 +81,7 @@ RC TableMeta::init(int32_t table_id, const char *name, int field_num, const Attr
   for (int i = 0; i < field_num; i++) {
     const AttrInfoSqlNode &attr_info = attributes[i];
     rc = fields_[i + trx_field_num].init(attr_info.name.c_str(), 
-            attr_info.type, field_offset, attr_info.length, true/*visible*/);
+            attr_info.type, field_offset, attr_info.length, true/*visible*/, attr_info.var_len);
     if (rc != RC::SUCCESS) {
       LOG_ERROR("Failed to init field meta. table name=%s, field name: %s", name, attr_info.name.c_str());
       return rc;
@@ -88,8 +92,9 @@ RC TableMeta::init(int32_t table_id, const char *name, int field_num, const Attr
 
   record_size_ = field_offset;
 
-  table_id_ = table_id;
-  name_     = name;
+  table_id_       = table_id;
+  name_           = name;
+  storage_format_ = storage_format;
   LOG_INFO("Sussessfully initialized table meta. table id=%d, name=%s", table_id, name);
   return RC::SUCCESS;
 }
@@ -209,6 +214,7 @@ int TableMeta::serialize(std::ostream &ss) const    //TODO
   Json::Value table_value;
   table_value[FIELD_TABLE_ID]   = table_id_;
   table_value[FIELD_TABLE_NAME] = name_;
+  table_value[FIELD_STORAGE_FORMAT] = storage_format_ == PAX_FORMAT ? "pax" : "row";
 
   Json::Value fields_value;
   for (const FieldMeta &field : fields_) {
@@ -266,6 +272,22 @@ int TableMeta::deserialize(std::istream &is)  // TODO
 
   std::string table_name = table_name_value.asString();
 
+  // 没有这个字段的是早期创建的表，都是行存
+  StorageFormat storage_format = ROW_FORMAT;
+  const Json::Value &storage_format_value = table_value[FIELD_STORAGE_FORMAT];
+  if (!storage_format_value.isNull()) {
+    if (!storage_format_value.isString()) {
+      LOG_ERROR("Invalid storage format. json value=%s", storage_format_value.toStyledString().c_str());
+      return -1;
+    }
+    if (storage_format_value.asString() == "pax") {
+      storage_format = PAX_FORMAT;
+    } else if (storage_format_value.asString() != "row") {
+      LOG_ERROR("Unknown storage format. json value=%s", storage_format_value.toStyledString().c_str());
+      return -1;
+    }
+  }
+
   const Json::Value &fields_value = table_value[FIELD_FIELDS];
   if (!fields_value.isArray() || fields_value.size() <= 0) {
     LOG_ERROR("Invalid table meta. fields is not array, json value=%s", fields_value.toStyledString().c_str());
@@ -292,6 +314,7 @@ int TableMeta::deserialize(std::istream &is)  // TODO
   table_id_ = table_id;
   name_.swap(table_name);
   fields_.swap(fields);
+  storage_format_ = storage_format;
   record_size_ = fields_.back().offset() + fields_.back().len() - fields_.begin()->offset();
 
   const Json::Value &indexes_value = table_value[FIELD_INDEXES];
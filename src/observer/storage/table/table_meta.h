@@ -36,13 +36,15 @@ public:
 
   void swap(TableMeta &other) noexcept;
 
-  RC init(int32_t table_id, const char *name, int field_num, const AttrInfoSqlNode attributes[]);
+  RC init(int32_t table_id, const char *name, int field_num, const AttrInfoSqlNode attributes[],
+      StorageFormat storage_format = ROW_FORMAT);
 
   RC add_index(const IndexMeta &index);
 
 public:
   int32_t table_id() const { return table_id_; }
   const char *name() const;
+  StorageFormat storage_format() const { return storage_format_; }
   const FieldMeta *trx_field() const;
   const FieldMeta *field(int index) const;
   const FieldMeta *field(const char *name) const;
@@ -75,6 +77,7 @@ protected:
   std::string name_;
   std::vector<FieldMeta> fields_;  // 包含sys_fields
   std::vector<IndexMeta> indexes_;
+  StorageFormat storage_format_ = ROW_FORMAT;  ///< 数据页面的存放格式
 
   int record_size_ = 0;
 };
@@ -0,0 +1,339 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string.h>
+#include <algorithm>
+
+#include "storage/table/table_stats.h"
+#include "common/log/log.h"
+#include "json/json.h"
+#include "storage/field/field_meta.h"
+#include "storage/record/record.h"
+
+using namespace std;
+
+static const Json::StaticString FIELD_ROW_COUNT("row_count");
+static const Json::StaticString FIELD_COLUMNS("columns");
+static const Json::StaticString FIELD_NAME("name");
+static const Json::StaticString FIELD_TYPE("type");
+static const Json::StaticString FIELD_NDV("ndv");
+static const Json::StaticString FIELD_BOUNDS("bounds");
+
+static void value_to_json(const Value &value, Json::Value &json_value)
+{
+  switch (value.attr_type()) {
+    case INTS: json_value = value.get_int(); break;
+    case FLOATS: json_value = value.get_float(); break;
+    case DATES: json_value = value.get_date(); break;
+    default: json_value = value.get_string(); break;
+  }
+}
+
+static bool value_from_json(AttrType type, const Json::Value &json_value, Value &value)
+{
+  switch (type) {
+    case INTS: {
+      if (!json_value.isInt()) {
+        return false;
+      }
+      value.set_int(json_value.asInt());
+    } break;
+    case FLOATS: {
+      if (!json_value.isDouble()) {
+        return false;
+      }
+      value.set_float(json_value.asFloat());
+    } break;
+    case DATES: {
+      if (!json_value.isUInt()) {
+        return false;
+      }
+      value.set_date(json_value.asUInt());
+    } break;
+    case CHARS: {
+      if (!json_value.isString()) {
+        return false;
+      }
+      value.set_string(json_value.asCString());
+    } break;
+    default: return false;
+  }
+  return true;
+}
+
+/**
+ * @brief 数值类型转换成double，用来在直方图的桶内做线性插值
+ */
+static bool value_to_double(const Value &value, double &result)
+{
+  switch (value.attr_type()) {
+    case INTS: result = value.get_int(); return true;
+    case FLOATS: result = value.get_float(); return true;
+    case DATES: result = value.get_date(); return true;
+    default: return false;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ColumnStats::init(const char *name, AttrType type, vector<Value> &values, double ndv, int bucket_num)
+{
+  name_ = name;
+  type_ = type;
+  ndv_  = ndv;
+  bounds_.clear();
+  if (values.empty()) {
+    return;
+  }
+
+  sort(values.begin(), values.end(), [](const Value &v1, const Value &v2) { return v1.compare(v2) < 0; });
+
+  const size_t n = values.size();
+  bucket_num = static_cast<int>(min<size_t>(bucket_num, n));
+  bounds_.reserve(bucket_num + 1);
+  bounds_.push_back(values.front());
+  for (int i = 1; i <= bucket_num; i++) {
+    bounds_.push_back(values[(n * i + bucket_num - 1) / bucket_num - 1]);
+  }
+}
+
+double ColumnStats::less_equal_fraction(const Value &value) const
+{
+  const int bucket_num = static_cast<int>(bounds_.size()) - 1;
+  if (value.compare(bounds_.front()) < 0) {
+    return 0;
+  }
+  if (bucket_num == 0 || value.compare(bounds_.back()) >= 0) {
+    return 1;
+  }
+
+  // 找到 value 所在的桶 (bounds_[i - 1], bounds_[i]]
+  auto iter = lower_bound(bounds_.begin() + 1, bounds_.end(), value, 
+                          [](const Value &bound, const Value &v) { return bound.compare(v) < 0; });
+  const int i = static_cast<int>(iter - bounds_.begin());
+  double in_bucket = 0.5;
+  double lower = 0;
+  double upper = 0;
+  double v = 0;
+  if (value_to_double(bounds_[i - 1], lower) && value_to_double(bounds_[i], upper) && value_to_double(value, v) &&
+      upper > lower) {
+    in_bucket = (v - lower) / (upper - lower);
+  }
+  return (i - 1 + in_bucket) / bucket_num;
+}
+
+double ColumnStats::equal_selectivity(const Value &value) const
+{
+  if (bounds_.empty()) {
+    return 0;
+  }
+  if (value.compare(bounds_.front()) < 0 || value.compare(bounds_.back()) > 0) {
+    return 0;
+  }
+
+  double selectivity = ndv_ >= 1 ? 1.0 / ndv_ : 1.0;
+
+  // 出现次数很多的值会占据多个桶的边界，按照占据的桶的个数来估算
+  const int bucket_num = static_cast<int>(bounds_.size()) - 1;
+  int equal_bounds = 0;
+  for (int i = 1; i <= bucket_num; i++) {
+    if (bounds_[i].compare(value) == 0) {
+      equal_bounds++;
+    }
+  }
+  if (bucket_num > 0 && equal_bounds > 1) {
+    selectivity = max(selectivity, static_cast<double>(equal_bounds - 1) / bucket_num);
+  }
+  return min(selectivity, 1.0);
+}
+
+double ColumnStats::range_selectivity(
+    const Value *lower, bool lower_inclusive, const Value *upper, bool upper_inclusive) const
+{
+  if (bounds_.empty()) {
+    return 0;
+  }
+
+  double upper_fraction = 1;
+  if (upper != nullptr) {
+    upper_fraction = less_equal_fraction(*upper);
+    if (!upper_inclusive) {
+      upper_fraction -= equal_selectivity(*upper);
+    }
+  }
+
+  double lower_fraction = 0;
+  if (lower != nullptr) {
+    lower_fraction = less_equal_fraction(*lower);
+    if (lower_inclusive) {
+      lower_fraction -= equal_selectivity(*lower);
+    }
+  }
+  return clamp(upper_fraction - lower_fraction, 0.0, 1.0);
+}
+
+void ColumnStats::to_json(Json::Value &json_value) const
+{
+  json_value[FIELD_NAME] = name_;
+  json_value[FIELD_TYPE] = attr_type_to_string(type_);
+  json_value[FIELD_NDV]  = ndv_;
+
+  Json::Value bounds_value(Json::arrayValue);
+  for (const Value &bound : bounds_) {
+    Json::Value bound_value;
+    value_to_json(bound, bound_value);
+    bounds_value.append(std::move(bound_value));
+  }
+  json_value[FIELD_BOUNDS] = std::move(bounds_value);
+}
+
+RC ColumnStats::from_json(const Json::Value &json_value, ColumnStats &column_stats)
+{
+  const Json::Value &name_value = json_value[FIELD_NAME];
+  const Json::Value &type_value = json_value[FIELD_TYPE];
+  const Json::Value &ndv_value = json_value[FIELD_NDV];
+  const Json::Value &bounds_value = json_value[FIELD_BOUNDS];
+  if (!name_value.isString() || !type_value.isString() || !ndv_value.isNumeric() || !bounds_value.isArray()) {
+    LOG_ERROR("Invalid column stats. json value=%s", json_value.toStyledString().c_str());
+    return RC::INTERNAL;
+  }
+
+  column_stats.name_ = name_value.asString();
+  column_stats.type_ = attr_type_from_string(type_value.asCString());
+  column_stats.ndv_  = ndv_value.asDouble();
+  column_stats.bounds_.clear();
+  for (Json::ArrayIndex i = 0; i < bounds_value.size(); i++) {
+    Value bound;
+    if (!value_from_json(column_stats.type_, bounds_value[i], bound)) {
+      LOG_ERROR("Invalid histogram bound of column stats. column=%s", column_stats.name_.c_str());
+      return RC::INTERNAL;
+    }
+    column_stats.bounds_.push_back(bound);
+  }
+  return RC::SUCCESS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const ColumnStats *TableStats::column(const char *name) const
+{
+  for (const ColumnStats &column_stats : columns_) {
+    if (0 == strcmp(column_stats.name().c_str(), name)) {
+      return column_stats.empty() ? nullptr : &column_stats;
+    }
+  }
+  return nullptr;
+}
+
+int TableStats::serialize(std::ostream &os) const
+{
+  Json::Value table_value;
+  table_value[FIELD_ROW_COUNT] = static_cast<Json::Int64>(row_count_);
+
+  Json::Value columns_value(Json::arrayValue);
+  for (const ColumnStats &column_stats : columns_) {
+    Json::Value column_value;
+    column_stats.to_json(column_value);
+    columns_value.append(std::move(column_value));
+  }
+  table_value[FIELD_COLUMNS] = std::move(columns_value);
+
+  Json::StreamWriterBuilder builder;
+  Json::StreamWriter *writer = builder.newStreamWriter();
+
+  std::streampos old_pos = os.tellp();
+  writer->write(table_value, &os);
+  int ret = (int)(os.tellp() - old_pos);
+
+  delete writer;
+  return ret;
+}
+
+int TableStats::deserialize(std::istream &is)
+{
+  Json::Value table_value;
+  Json::CharReaderBuilder builder;
+  std::string errors;
+
+  std::streampos old_pos = is.tellg();
+  if (!Json::parseFromStream(builder, is, &table_value, &errors)) {
+    LOG_ERROR("Failed to deserialize table stats. error=%s", errors.c_str());
+    return -1;
+  }
+
+  const Json::Value &row_count_value = table_value[FIELD_ROW_COUNT];
+  const Json::Value &columns_value = table_value[FIELD_COLUMNS];
+  if (!row_count_value.isIntegral() || !columns_value.isArray()) {
+    LOG_ERROR("Invalid table stats. json value=%s", table_value.toStyledString().c_str());
+    return -1;
+  }
+
+  std::vector<ColumnStats> columns(columns_value.size());
+  for (Json::ArrayIndex i = 0; i < columns_value.size(); i++) {
+    RC rc = ColumnStats::from_json(columns_value[i], columns[i]);
+    if (OB_FAIL(rc)) {
+      return -1;
+    }
+  }
+
+  row_count_ = row_count_value.asInt64();
+  columns_.swap(columns);
+  return (int)(is.tellg() - old_pos);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TableStatsCollector::TableStatsCollector(const vector<const FieldMeta *> &fields)
+{
+  columns_.resize(fields.size());
+  for (size_t i = 0; i < fields.size(); i++) {
+    columns_[i].field = fields[i];
+  }
+}
+
+void TableStatsCollector::add(const Record &record)
+{
+  sampled_rows_++;
+  for (ColumnCollector &column : columns_) {
+    const FieldMeta *field = column.field;
+    const char *data = record.data() + field->offset();
+    int len = field->len();
+    if (field->type() == CHARS) {
+      len = static_cast<int>(strnlen(data, len));
+    }
+
+    column.hll.add(data, len);
+    column.values.emplace_back(field->type(), const_cast<char *>(data), len);
+  }
+}
+
+unique_ptr<TableStats> TableStatsCollector::finish(int total_pages, int sampled_pages)
+{
+  unique_ptr<TableStats> table_stats(new TableStats);
+
+  double row_count = static_cast<double>(sampled_rows_);
+  if (sampled_pages > 0 && sampled_pages < total_pages) {
+    row_count = row_count * total_pages / sampled_pages;
+  }
+  table_stats->row_count_ = static_cast<int64_t>(row_count + 0.5);
+
+  table_stats->columns_.resize(columns_.size());
+  for (size_t i = 0; i < columns_.size(); i++) {
+    ColumnCollector &column = columns_[i];
+
+    // 采样中几乎没有重复值时，认为整张表也是这样，按比例放大；否则认为采样已经看到了大部分不同的值
+    double ndv = min(column.hll.estimate(), static_cast<double>(sampled_rows_));
+    if (sampled_rows_ > 0 && row_count > sampled_rows_ && ndv >= 0.9 * sampled_rows_) {
+      ndv = ndv * row_count / sampled_rows_;
+    }
+
+    table_stats->columns_[i].init(
+        column.field->name(), column.field->type(), column.values, ndv, TableStats::HISTOGRAM_BUCKETS);
+    column.values.clear();
+  }
+  return table_stats;
+}
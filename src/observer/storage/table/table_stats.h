@@ -0,0 +1,147 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/rc.h"
+#include "common/math/hyperloglog.h"
+#include "sql/parser/value.h"
+
+namespace Json {
+class Value;
+}  // namespace Json
+
+class FieldMeta;
+class Record;
+
+/**
+ * @brief 一个字段的统计信息
+ * @ingroup Table
+ * @details 包括不同值的个数(NDV)、最小值、最大值以及等深直方图。
+ * 等深直方图使用 bounds_ 记录桶的边界，bounds_[0] 是最小值，bounds_[i] 是第 i 个桶的上界，
+ * 每个桶中的行数大致相同。
+ */
+class ColumnStats
+{
+public:
+  ColumnStats() = default;
+  ~ColumnStats() = default;
+
+  /**
+   * @brief 根据采样的数据计算统计信息
+   * @param values     采样得到的字段值，会被排序
+   * @param ndv        估算的不同值个数
+   * @param bucket_num 直方图桶的个数
+   */
+  void init(const char *name, AttrType type, std::vector<Value> &values, double ndv, int bucket_num);
+
+  const std::string &name() const { return name_; }
+  AttrType type() const { return type_; }
+  double ndv() const { return ndv_; }
+  const Value &min_value() const { return bounds_.front(); }
+  const Value &max_value() const { return bounds_.back(); }
+  bool empty() const { return bounds_.empty(); }
+
+  /**
+   * @brief 等值条件的选择率
+   */
+  double equal_selectivity(const Value &value) const;
+
+  /**
+   * @brief 范围条件的选择率
+   * @param lower 下界，为空表示没有下界
+   * @param upper 上界，为空表示没有上界
+   */
+  double range_selectivity(const Value *lower, bool lower_inclusive, const Value *upper, bool upper_inclusive) const;
+
+  void to_json(Json::Value &json_value) const;
+  static RC from_json(const Json::Value &json_value, ColumnStats &column_stats);
+
+private:
+  /**
+   * @brief 小于等于value的行所占的比例
+   */
+  double less_equal_fraction(const Value &value) const;
+
+private:
+  std::string        name_;
+  AttrType           type_ = UNDEFINED;
+  double             ndv_  = 0;
+  std::vector<Value> bounds_;
+};
+
+/**
+ * @brief 表的统计信息
+ * @ingroup Table
+ * @details 通过 ANALYZE TABLE 采样计算，保存在表元数据文件旁边的 .stats 文件中。
+ * 分析完成后，插入和删除记录时会增量地维护行数(参考 Table::row_count)，其它信息只在再次分析时更新。
+ */
+class TableStats
+{
+public:
+  /// 最多采样多少个页面
+  static constexpr int MAX_SAMPLE_PAGES = 256;
+  /// 直方图中桶的个数
+  static constexpr int HISTOGRAM_BUCKETS = 32;
+
+public:
+  TableStats() = default;
+  ~TableStats() = default;
+
+  int64_t row_count() const { return row_count_; }
+  void    set_row_count(int64_t row_count) { row_count_ = row_count; }
+
+  const ColumnStats *column(const char *name) const;
+  const std::vector<ColumnStats> &columns() const { return columns_; }
+
+  int  serialize(std::ostream &os) const;
+  int  deserialize(std::istream &is);
+
+private:
+  friend class TableStatsCollector;
+
+  int64_t                  row_count_ = 0;
+  std::vector<ColumnStats> columns_;
+};
+
+/**
+ * @brief 根据采样的记录计算表的统计信息
+ * @ingroup Table
+ */
+class TableStatsCollector
+{
+public:
+  TableStatsCollector(const std::vector<const FieldMeta *> &fields);
+
+  void add(const Record &record);
+
+  /**
+   * @brief 采样结束，生成统计信息
+   * @param total_pages   数据页面的总数
+   * @param sampled_pages 采样了其中多少个页面
+   */
+  std::unique_ptr<TableStats> finish(int total_pages, int sampled_pages);
+
+private:
+  struct ColumnCollector
+  {
+    const FieldMeta   *field = nullptr;
+    common::HyperLogLog hll;
+    std::vector<Value>  values;
+  };
+
+  std::vector<ColumnCollector> columns_;
+  int64_t                      sampled_rows_ = 0;
+};
@@ -0,0 +1,167 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <thread>
+
+#include "storage/trx/active_trx_registry.h"
+
+using namespace std;
+
+ActiveTrxRegistry::~ActiveTrxRegistry()
+{
+  Block *block = head_.next.load();
+  while (block != nullptr) {
+    Block *next = block->next.load();
+    delete block;
+    block = next;
+  }
+}
+
+ActiveTrxRegistry::Slot *ActiveTrxRegistry::attach(Trx *trx)
+{
+  Block *block = &head_;
+  while (true) {
+    for (Slot &slot : block->slots) {
+      Trx *expected = nullptr;
+      if (slot.trx.load(memory_order_relaxed) == nullptr && slot.trx.compare_exchange_strong(expected, trx)) {
+        return &slot;
+      }
+    }
+
+    Block *next = block->next.load();
+    if (next == nullptr) {
+      // 所有的槽位都被占用了，追加一个新的块。其它线程已经追加了的话，就使用它追加的块
+      Block *new_block = new Block;
+      if (block->next.compare_exchange_strong(next, new_block)) {
+        next = new_block;
+      } else {
+        delete new_block;
+      }
+    }
+    block = next;
+  }
+}
+
+void ActiveTrxRegistry::detach(Slot *slot)
+{
+  slot->commit_xid.store(NONE);
+  slot->trx_id.store(NONE);
+  slot->trx.store(nullptr);
+}
+
+int32_t ActiveTrxRegistry::start(Slot *slot)
+{
+  slot->trx_id.store(ASSIGNING);
+  const int32_t trx_id = ++current_xid_;
+  slot->trx_id.store(trx_id);
+  return trx_id;
+}
+
+void ActiveTrxRegistry::start_recovered(Slot *slot, int32_t trx_id)
+{
+  advance_xid(trx_id);
+  slot->trx_id.store(trx_id);
+}
+
+void ActiveTrxRegistry::advance_xid(int32_t xid)
+{
+  int32_t current = current_xid_.load();
+  while (current < xid && !current_xid_.compare_exchange_weak(current, xid)) {
+  }
+}
+
+int32_t ActiveTrxRegistry::begin_commit(Slot *slot)
+{
+  slot->commit_xid.store(ASSIGNING);
+  const int32_t commit_xid = ++current_xid_;
+  slot->commit_xid.store(commit_xid);
+  return commit_xid;
+}
+
+void ActiveTrxRegistry::finish(Slot *slot)
+{
+  slot->commit_xid.store(NONE);
+  slot->trx_id.store(NONE);
+}
+
+int32_t ActiveTrxRegistry::load_xid(const atomic<int32_t> &xid)
+{
+  // 分配事务号只需要一次原子加，不会等很久
+  int32_t value = xid.load();
+  while (value == ASSIGNING) {
+    this_thread::yield();
+    value = xid.load();
+  }
+  return value;
+}
+
+void ActiveTrxRegistry::create_read_view(int32_t high_xid, ReadView &read_view) const
+{
+  read_view.high_xid_ = high_xid;
+  read_view.low_xid_  = high_xid;
+  read_view.committing_.clear();
+
+  for (const Block *block = &head_; block != nullptr; block = block->next.load()) {
+    for (const Slot &slot : block->slots) {
+      // 先读取提交事务号，再读取事务号。事务结束时按照相反的顺序清理
+      const int32_t commit_xid = load_xid(slot.commit_xid);
+      const int32_t trx_id     = load_xid(slot.trx_id);
+      if (trx_id != NONE && trx_id < read_view.low_xid_) {
+        read_view.low_xid_ = trx_id;
+      }
+      // 提交事务号比 high_xid 大的事务，根据事务号就可以判断出不可见
+      if (commit_xid != NONE && commit_xid < high_xid) {
+        read_view.committing_.push_back(commit_xid);
+      }
+    }
+  }
+  sort(read_view.committing_.begin(), read_view.committing_.end());
+}
+
+int32_t ActiveTrxRegistry::oldest_active_trx_id() const
+{
+  // 先读取计数器，之后开始的事务的事务号一定比它大
+  int32_t oldest_trx_id = current_xid_.load() + 1;
+  for (const Block *block = &head_; block != nullptr; block = block->next.load()) {
+    for (const Slot &slot : block->slots) {
+      const int32_t trx_id = load_xid(slot.trx_id);
+      if (trx_id != NONE && trx_id < oldest_trx_id) {
+        oldest_trx_id = trx_id;
+      }
+    }
+  }
+  return oldest_trx_id;
+}
+
+Trx *ActiveTrxRegistry::find_trx(int32_t trx_id) const
+{
+  for (const Block *block = &head_; block != nullptr; block = block->next.load()) {
+    for (const Slot &slot : block->slots) {
+      if (slot.trx_id.load() == trx_id) {
+        return slot.trx.load();
+      }
+    }
+  }
+  return nullptr;
+}
+
+void ActiveTrxRegistry::all_trxes(vector<Trx *> &trxes) const
+{
+  trxes.clear();
+  for (const Block *block = &head_; block != nullptr; block = block->next.load()) {
+    for (const Slot &slot : block->slots) {
+      Trx *trx = slot.trx.load();
+      if (trx != nullptr) {
+        trxes.push_back(trx);
+      }
+    }
+  }
+}
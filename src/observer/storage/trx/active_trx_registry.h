@@ -0,0 +1,152 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <vector>
+
+class Trx;
+
+/**
+ * @brief 事务的读视图(快照)
+ * @ingroup Transaction
+ * @details 事务开始时创建。事务号和提交事务号从同一个计数器分配，提交事务号小于 high_xid 的事务是在创建
+ * 快照之前提交的，但是有些事务在创建快照时已经拿到了提交事务号，还没有写完提交日志、修改事务状态，
+ * 它们的提交事务号记录在 committing_ 中，对这个快照始终不可见，这样同一个快照多次读取的结果是一样的。
+ */
+class ReadView
+{
+public:
+  /**
+   * @brief 提交事务号为 commit_xid 的事务写入的数据对这个快照是否可见
+   */
+  bool visible(int32_t commit_xid) const
+  {
+    if (commit_xid >= high_xid_) {
+      return false;
+    }
+    if (committing_.empty() || commit_xid < committing_.front()) {
+      return true;
+    }
+    for (int32_t xid : committing_) {
+      if (xid == commit_xid) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /// 创建快照的事务号，之后提交的事务都不可见
+  int32_t high_xid() const { return high_xid_; }
+  /// 创建快照时最老的活跃事务号，之前提交的数据对所有活跃事务都可见
+  int32_t low_xid() const { return low_xid_; }
+
+private:
+  friend class ActiveTrxRegistry;
+
+  int32_t              high_xid_ = 0;
+  int32_t              low_xid_  = 0;
+  std::vector<int32_t> committing_;  ///< 正在提交的事务的提交事务号，从小到大排序
+};
+
+/**
+ * @brief 活跃事务表
+ * @ingroup Transaction
+ * @details 每个事务对象占用一个槽位(Slot)，记录事务号和正在提交时的提交事务号。槽位按块(Block)分配，
+ * 不够用时无锁地追加新的块，块在活跃事务表销毁之前不会释放，槽位在事务对象销毁后可以给其它事务使用。
+ * 读取者只读取槽位上的原子变量，不会访问事务对象，所以不需要延迟回收(epoch)之类的机制，
+ * 创建快照、计算最老的活跃事务都不加锁。
+ *
+ * 事务号和提交事务号也在这里分配。分配之前先把槽位标记为 ASSIGNING，扫描槽位时遇到这种状态
+ * 需要等待，这样扫描到的事务号一定完整，不会漏掉已经拿到事务号但是还没有写到槽位上的事务。
+ */
+class ActiveTrxRegistry
+{
+public:
+  struct Slot
+  {
+    std::atomic<Trx *>   trx{nullptr};
+    std::atomic<int32_t> trx_id{NONE};      ///< 活跃事务的事务号
+    std::atomic<int32_t> commit_xid{NONE};  ///< 正在提交时的提交事务号
+  };
+
+  static constexpr int32_t NONE      = 0;
+  static constexpr int32_t ASSIGNING = -1;  ///< 正在分配事务号
+
+public:
+  ActiveTrxRegistry() = default;
+  ~ActiveTrxRegistry();
+
+  /**
+   * @brief 为事务对象分配一个槽位，事务对象销毁时调用 detach
+   */
+  Slot *attach(Trx *trx);
+  void  detach(Slot *slot);
+
+  /**
+   * @brief 事务开始，分配事务号
+   */
+  int32_t start(Slot *slot);
+
+  /**
+   * @brief 重放日志时恢复的事务，使用日志中的事务号
+   */
+  void start_recovered(Slot *slot, int32_t trx_id);
+
+  /**
+   * @brief 重放日志时，保证之后分配的事务号比日志中出现过的事务号(包括提交事务号)大
+   */
+  void advance_xid(int32_t xid);
+
+  /**
+   * @brief 开始提交，分配提交事务号。事务状态修改完成后调用 finish
+   */
+  int32_t begin_commit(Slot *slot);
+
+  /**
+   * @brief 事务提交或者回滚结束
+   */
+  void finish(Slot *slot);
+
+  /**
+   * @brief 创建快照
+   * @param high_xid 创建快照的事务的事务号，需要已经调用过 start
+   */
+  void create_read_view(int32_t high_xid, ReadView &read_view) const;
+
+  /**
+   * @brief 当前活跃事务中最小的事务号
+   * @details 如果没有活跃的事务，就返回下一个将要分配的事务号
+   */
+  int32_t oldest_active_trx_id() const;
+
+  int32_t current_xid() const { return current_xid_.load(); }
+
+  Trx *find_trx(int32_t trx_id) const;
+  void all_trxes(std::vector<Trx *> &trxes) const;
+
+private:
+  static constexpr int BLOCK_SLOTS = 64;
+
+  struct Block
+  {
+    Slot                 slots[BLOCK_SLOTS];
+    std::atomic<Block *> next{nullptr};
+  };
+
+  /// 读取一个事务号，正在分配时等待分配完成
+  static int32_t load_xid(const std::atomic<int32_t> &xid);
+
+private:
+  Block                head_;
+  std::atomic<int32_t> current_xid_{0};
+};
@@ -0,0 +1,152 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <chrono>
+
+#include "storage/trx/lock_manager.h"
+#include "common/log/log.h"
+
+using namespace std;
+
+RC LockManager::try_lock(int32_t trx_id, const RowLockKey &key)
+{
+  Partition &part = partition(key);
+  lock_guard<mutex> guard(part.mutex);
+
+  auto ret = part.locks.try_emplace(key);
+  LockEntry &entry = ret.first->second;
+  if (ret.second) {
+    entry.owner = trx_id;
+    lock_count_.fetch_add(1, memory_order_relaxed);
+    return RC::SUCCESS;
+  }
+  return entry.owner == trx_id ? RC::SUCCESS : RC::LOCKED_NEED_WAIT;
+}
+
+RC LockManager::lock(int32_t trx_id, const RowLockKey &key)
+{
+  Partition &part = partition(key);
+  unique_lock<mutex> guard(part.mutex);
+
+  auto ret = part.locks.try_emplace(key);
+  LockEntry &entry = ret.first->second;
+  if (ret.second) {
+    entry.owner = trx_id;
+    lock_count_.fetch_add(1, memory_order_relaxed);
+    return RC::SUCCESS;
+  }
+  if (entry.owner == trx_id) {
+    return RC::SUCCESS;
+  }
+
+  if (!reserve_waiter()) {
+    LOG_INFO("too many threads waiting for row locks. trx id=%d, owner=%d, table id=%d, rid=%s, max waiters=%d",
+             trx_id, entry.owner, key.table_id, key.rid.to_string().c_str(), max_waiters_);
+    return RC::LOCKED_CONCURRENCY_CONFLICT;
+  }
+
+  if (!add_wait_edge(trx_id, entry.owner)) {
+    waiting_count_.fetch_sub(1, memory_order_relaxed);
+    deadlock_count_.fetch_add(1, memory_order_relaxed);
+    LOG_INFO("deadlock detected. trx id=%d, owner=%d, table id=%d, rid=%s",
+             trx_id, entry.owner, key.table_id, key.rid.to_string().c_str());
+    return RC::LOCKED_DEADLOCK;
+  }
+
+  LOG_TRACE("wait for row lock. trx id=%d, owner=%d, table id=%d, rid=%s",
+            trx_id, entry.owner, key.table_id, key.rid.to_string().c_str());
+  entry.waiters.push_back(trx_id);
+
+  // 锁交给当前事务时，释放锁的事务已经把等待图中的边删掉了
+  const auto deadline = chrono::steady_clock::now() + chrono::milliseconds(wait_timeout_ms_);
+  const bool granted =
+      entry.cond.wait_until(guard, deadline, [&entry, trx_id]() { return entry.owner == trx_id; });
+  waiting_count_.fetch_sub(1, memory_order_relaxed);
+  if (granted) {
+    return RC::SUCCESS;
+  }
+
+  entry.waiters.erase(find(entry.waiters.begin(), entry.waiters.end(), trx_id));
+  remove_wait_edge(trx_id);
+  LOG_INFO("row lock wait timeout. trx id=%d, owner=%d, table id=%d, rid=%s",
+           trx_id, entry.owner, key.table_id, key.rid.to_string().c_str());
+  return RC::LOCKED_WAIT_TIMEOUT;
+}
+
+void LockManager::unlock(int32_t trx_id, const RowLockKey &key)
+{
+  Partition &part = partition(key);
+  lock_guard<mutex> guard(part.mutex);
+
+  auto iter = part.locks.find(key);
+  if (iter == part.locks.end() || iter->second.owner != trx_id) {
+    LOG_WARN("try to unlock a row lock not owned. trx id=%d, table id=%d, rid=%s",
+             trx_id, key.table_id, key.rid.to_string().c_str());
+    return;
+  }
+
+  LockEntry &entry = iter->second;
+  if (entry.waiters.empty()) {
+    part.locks.erase(iter);
+    lock_count_.fetch_sub(1, memory_order_relaxed);
+    return;
+  }
+
+  entry.owner = entry.waiters.front();
+  entry.waiters.pop_front();
+  {
+    lock_guard<mutex> graph_guard(graph_mutex_);
+    waits_for_.erase(entry.owner);
+    for (int32_t waiter : entry.waiters) {
+      waits_for_[waiter] = entry.owner;
+    }
+  }
+  entry.cond.notify_all();
+}
+
+bool LockManager::reserve_waiter()
+{
+  // 不同分区的等待者并发地占用名额，用 CAS 保证不会超过上限
+  int64_t waiting = waiting_count_.load(memory_order_relaxed);
+  do {
+    if (max_waiters_ >= 0 && waiting >= max_waiters_) {
+      return false;
+    }
+  } while (!waiting_count_.compare_exchange_weak(waiting, waiting + 1, memory_order_relaxed));
+  return true;
+}
+
+bool LockManager::add_wait_edge(int32_t waiter, int32_t owner)
+{
+  lock_guard<mutex> guard(graph_mutex_);
+
+  // 每个事务只有一条出边，最多走过所有的边就能确定有没有回到 waiter
+  int32_t current = owner;
+  for (size_t i = 0; i <= waits_for_.size(); i++) {
+    if (current == waiter) {
+      return false;
+    }
+    auto iter = waits_for_.find(current);
+    if (iter == waits_for_.end()) {
+      break;
+    }
+    current = iter->second;
+  }
+
+  waits_for_[waiter] = owner;
+  return true;
+}
+
+void LockManager::remove_wait_edge(int32_t waiter)
+{
+  lock_guard<mutex> guard(graph_mutex_);
+  waits_for_.erase(waiter);
+}
@@ -0,0 +1,155 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+#include "common/rc.h"
+#include "storage/record/record.h"
+
+/**
+ * @brief 行锁的键值
+ * @ingroup Transaction
+ */
+struct RowLockKey
+{
+  int32_t table_id = -1;
+  RID     rid;
+
+  bool operator==(const RowLockKey &other) const { return table_id == other.table_id && rid == other.rid; }
+};
+
+struct RowLockKeyHash
+{
+  size_t operator()(const RowLockKey &key) const
+  {
+    uint64_t value = (static_cast<uint64_t>(static_cast<uint32_t>(key.rid.page_num)) << 32) |
+                     static_cast<uint32_t>(key.rid.slot_num);
+    value ^= static_cast<uint64_t>(static_cast<uint32_t>(key.table_id)) * 0x9E3779B97F4A7C15ULL;
+    return static_cast<size_t>(value ^ (value >> 29));
+  }
+};
+
+/**
+ * @brief 行锁管理器
+ * @ingroup Transaction
+ * @details 只有排他锁。写事务修改记录之前加锁，事务结束时释放，只读访问走多版本，不加锁。
+ * 锁表按照键值的哈希分成多个分区，每个分区一个互斥锁。每个锁记录持有者和按照请求顺序排队的等待者，
+ * 释放时直接交给队列中的第一个等待者。等待者在锁自己的条件变量上等待，释放一个锁只会唤醒这个锁的等待者。
+ *
+ * 开始等待之前检查等待图(waits-for graph)。一个事务同时最多等待一个锁，所以每个事务在等待图中
+ * 只有一条出边，指向它等待的锁的持有者，锁交给下一个等待者时会更新其它等待者的出边。
+ * 从持有者出发沿着出边能找到请求锁的事务，就说明出现了死锁，由请求锁的事务放弃等待。
+ *
+ * 等待行锁时不能持有页面锁(latch)，否则持有行锁的事务可能因为拿不到页面锁而无法结束。
+ * 所以访问记录时先调用 try_lock，需要等待时由调用者释放页面锁，再调用 lock 等待。
+ *
+ * 等待锁的是执行 SQL 的工作线程，线程个数是固定的。如果所有的工作线程都在等锁，持有锁的事务
+ * 提交的请求就没有线程处理，只能等到超时。所以同时等待的线程个数有上限(max_waiters)，
+ * 一般设置为工作线程数减一，超过上限时不再等待，直接返回 LOCKED_CONCURRENCY_CONFLICT。
+ */
+class LockManager
+{
+public:
+  static constexpr int DEFAULT_WAIT_TIMEOUT_MS = 10000;
+
+public:
+  LockManager() = default;
+  ~LockManager() = default;
+
+  void set_wait_timeout_ms(int timeout_ms) { wait_timeout_ms_ = timeout_ms; }
+  int  wait_timeout_ms() const { return wait_timeout_ms_; }
+
+  /**
+   * @brief 设置同时等待锁的线程个数上限，0表示不允许等待，小于0表示不限制
+   */
+  void set_max_waiters(int max_waiters) { max_waiters_ = max_waiters; }
+  int  max_waiters() const { return max_waiters_; }
+
+  /**
+   * @brief 尝试加锁，不会等待
+   * @return SUCCESS 加锁成功或者已经持有这个锁；LOCKED_NEED_WAIT 锁被其它事务持有
+   */
+  RC try_lock(int32_t trx_id, const RowLockKey &key);
+
+  /**
+   * @brief 加锁，锁被其它事务持有时排队等待
+   * @return SUCCESS 加锁成功；LOCKED_DEADLOCK 等待会造成死锁；LOCKED_WAIT_TIMEOUT 等待超时；
+   *         LOCKED_CONCURRENCY_CONFLICT 等待的线程个数已经达到上限
+   */
+  RC lock(int32_t trx_id, const RowLockKey &key);
+
+  /**
+   * @brief 释放锁，如果有等待者就交给第一个等待者
+   */
+  void unlock(int32_t trx_id, const RowLockKey &key);
+
+  /**
+   * @brief 当前有事务持有或者等待的锁的个数
+   */
+  int64_t lock_count() const { return lock_count_.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief 正在等待锁的事务个数
+   */
+  int64_t waiting_count() const { return waiting_count_.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief 检测到死锁的次数
+   */
+  int64_t deadlock_count() const { return deadlock_count_.load(std::memory_order_relaxed); }
+
+private:
+  struct LockEntry
+  {
+    int32_t                 owner = 0;
+    std::deque<int32_t>     waiters;
+    std::condition_variable cond;
+  };
+
+  struct Partition
+  {
+    std::mutex                                                   mutex;
+    std::unordered_map<RowLockKey, LockEntry, RowLockKeyHash>    locks;
+  };
+
+  Partition &partition(const RowLockKey &key) { return partitions_[RowLockKeyHash()(key) % PARTITION_NUM]; }
+
+  /**
+   * @brief 在等待图中增加一条 waiter 等待 owner 的边，如果会形成环就不增加并返回 false
+   */
+  bool add_wait_edge(int32_t waiter, int32_t owner);
+  void remove_wait_edge(int32_t waiter);
+
+  /**
+   * @brief 占用一个等待的名额，等待的线程个数已经达到上限时返回 false
+   */
+  bool reserve_waiter();
+
+private:
+  static constexpr int PARTITION_NUM = 64;
+
+  Partition partitions_[PARTITION_NUM];
+
+  std::mutex                           graph_mutex_;  ///< 保护 waits_for_，总是在分区的互斥锁之后获取
+  std::unordered_map<int32_t, int32_t> waits_for_;    ///< 等待者 -> 它等待的锁的持有者
+
+  int                  wait_timeout_ms_ = DEFAULT_WAIT_TIMEOUT_MS;
+  int                  max_waiters_     = -1;
+  std::atomic<int64_t> lock_count_{0};
+  std::atomic<int64_t> waiting_count_{0};
+  std::atomic<int64_t> deadlock_count_{0};
+};
@@ -24,7 +24,7 @@ using namespace std;
 MvccTrxKit::~MvccTrxKit()
 {
   vector<Trx *> tmp_trxes;
-  tmp_trxes.swap(trxes_);
+  active_trxes_.all_trxes(tmp_trxes);
   
   for (Trx *trx : tmp_trxes) {
     delete trx;
@@ -47,11 +47,6 @@ const vector<FieldMeta> *MvccTrxKit::trx_fields() const
   return &fields_;
 }
 
-int32_t MvccTrxKit::next_trx_id()
-{
-  return ++current_trx_id_;
-}
-
 int32_t MvccTrxKit::max_trx_id() const
 {
   return numeric_limits<int32_t>::max();
@@ -59,77 +54,62 @@ int32_t MvccTrxKit::max_trx_id() const
 
 Trx *MvccTrxKit::create_trx(CLogManager *log_manager)
 {
-  Trx *trx = new MvccTrx(*this, log_manager);
-  if (trx != nullptr) {
-    lock_.lock();
-    trxes_.push_back(trx);
-    lock_.unlock();
-  }
-  return trx;
+  return new MvccTrx(*this, log_manager);
 }
 
 Trx *MvccTrxKit::create_trx(int32_t trx_id)
 {
-  Trx *trx = new MvccTrx(*this, trx_id);
-  if (trx != nullptr) {
-    lock_.lock();
-    trxes_.push_back(trx);
-    if (current_trx_id_ < trx_id) {
-      current_trx_id_ = trx_id;
-    }
-    lock_.unlock();
-  }
-  return trx;
+  return new MvccTrx(*this, trx_id);
 }
 
 void MvccTrxKit::destroy_trx(Trx *trx)
 {
-  lock_.lock();
-  for (auto iter = trxes_.begin(), itend = trxes_.end(); iter != itend; ++iter) {
-    if (*iter == trx) {
-      trxes_.erase(iter);
-      break;
-    }
-  }
-  lock_.unlock();
-
   delete trx;
 }
 
 Trx *MvccTrxKit::find_trx(int32_t trx_id)
 {
-  lock_.lock();
-  for (Trx *trx : trxes_) {
-    if (trx->id() == trx_id) {
-      lock_.unlock();
-      return trx;
-    }
+  return active_trxes_.find_trx(trx_id);
+}
+
+int32_t MvccTrxKit::oldest_active_trx_id()
+{
+  return active_trxes_.oldest_active_trx_id();
+}
+
+int32_t MvccTrxKit::resolve_xid(int32_t xid) const
+{
+  if (xid >= 0) {
+    return xid;
   }
-  lock_.unlock();
 
-  return nullptr;
+  const int32_t commit_xid = trx_status_.commit_xid(-xid);
+  return commit_xid > 0 ? commit_xid : xid;
 }
 
 void MvccTrxKit::all_trxes(std::vector<Trx *> &trxes)
 {
-  lock_.lock();
-  trxes = trxes_;
-  lock_.unlock();
+  active_trxes_.all_trxes(trxes);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 MvccTrx::MvccTrx(MvccTrxKit &kit, CLogManager *log_manager) : trx_kit_(kit), log_manager_(log_manager)
-{}
+{
+  slot_ = trx_kit_.active_trxes().attach(this);
+}
 
 MvccTrx::MvccTrx(MvccTrxKit &kit, int32_t trx_id) : trx_kit_(kit), trx_id_(trx_id)
 {
+  slot_ = trx_kit_.active_trxes().attach(this);
+  trx_kit_.active_trxes().start_recovered(slot_, trx_id);
   started_ = true;
   recovering_ = true;
 }
 
 MvccTrx::~MvccTrx()
 {
+  trx_kit_.active_trxes().detach(slot_);
 }
 
 RC MvccTrx::insert_record(Table *table, Record &record)
@@ -147,15 +127,90 @@ RC MvccTrx::insert_record(Table *table, Record &record)
     return rc;
   }
 
-  rc = log_manager_->append_log(CLogType::INSERT, trx_id_, table->table_id(), record.rid(), record.len(), 0/*offset*/, record.data());
-  ASSERT(rc == RC::SUCCESS, "failed to append insert record log. trx id=%d, table id=%d, rid=%s, record len=%d, rc=%s",
-      trx_id_, table->table_id(), record.rid().to_string().c_str(), record.len(), strrc(rc));
-
   pair<OperationSet::iterator, bool> ret = 
         operations_.insert(Operation(Operation::Type::INSERT, table, record.rid()));
   if (!ret.second) {
-    rc = RC::INTERNAL;
     LOG_WARN("failed to insert operation(insertion) into operation set: duplicate");
+    RC rc2 = table->delete_record(record);
+    ASSERT(OB_SUCC(rc2), "failed to delete record while undoing insert. rid=%s, rc=%s",
+           record.rid().to_string().c_str(), strrc(rc2));
+    return RC::INTERNAL;
+  }
+
+  rc = log_manager_->append_log(CLogType::INSERT, trx_id_, table->table_id(), record.rid(), record.len(), 0/*offset*/, record.data());
+  ASSERT(rc == RC::SUCCESS, "failed to append insert record log. trx id=%d, table id=%d, rid=%s, record len=%d, rc=%s",
+      trx_id_, table->table_id(), record.rid().to_string().c_str(), record.len(), strrc(rc));
+
+  return lock_inserted_record(table, record.rid());
+}
+
+RC MvccTrx::insert_records(Table *table, vector<Record> &records)
+{
+  if (records.empty()) {
+    return RC::SUCCESS;
+  }
+
+  Field begin_field;
+  Field end_field;
+  trx_fields(table, begin_field, end_field);
+
+  for (Record &record : records) {
+    begin_field.set_int(record, -trx_id_);
+    end_field.set_int(record, trx_kit_.max_trx_id());
+  }
+
+  RC rc = table->insert_records(records);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to insert records into table. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  // 在写日志之前记录操作，出错时删除这一批记录，不会留下没有回滚信息的记录和日志
+  for (size_t i = 0; i < records.size(); i++) {
+    pair<OperationSet::iterator, bool> ret =
+        operations_.insert(Operation(Operation::Type::INSERT, table, records[i].rid()));
+    if (!ret.second) {
+      LOG_WARN("failed to insert operation(insertion) into operation set: duplicate. rid=%s",
+               records[i].rid().to_string().c_str());
+      for (size_t j = 0; j < i; j++) {
+        operations_.erase(Operation(Operation::Type::INSERT, table, records[j].rid()));
+      }
+      for (Record &record : records) {
+        RC rc2 = table->delete_record(record);
+        ASSERT(OB_SUCC(rc2), "failed to delete record while undoing batch insert. rid=%s, rc=%s",
+               record.rid().to_string().c_str(), strrc(rc2));
+      }
+      return RC::INTERNAL;
+    }
+  }
+
+  // 日志数据依次是每条记录的RID和数据。插入很多记录时日志可能超过日志缓冲区的大小，
+  // 所以每个页面上的记录写一条日志
+  const int record_len = records.front().len();
+  vector<char> log_data;
+  for (size_t begin = 0, end = 0; begin < records.size(); begin = end) {
+    const PageNum page_num = records[begin].rid().page_num;
+    for (end = begin + 1; end < records.size() && records[end].rid().page_num == page_num; end++) {
+    }
+
+    log_data.resize((end - begin) * (sizeof(RID) + record_len));
+    char *log_pos = log_data.data();
+    for (size_t i = begin; i < end; i++) {
+      memcpy(log_pos, &records[i].rid(), sizeof(RID));
+      memcpy(log_pos + sizeof(RID), records[i].data(), record_len);
+      log_pos += sizeof(RID) + record_len;
+    }
+    rc = log_manager_->append_log(CLogType::BATCH_INSERT, trx_id_, table->table_id(), records[begin].rid(),
+                                  static_cast<int32_t>(log_data.size()), 0/*offset*/, log_data.data());
+    ASSERT(rc == RC::SUCCESS, "failed to append batch insert log. trx id=%d, table id=%d, record num=%d, rc=%s",
+        trx_id_, table->table_id(), static_cast<int>(end - begin), strrc(rc));
+  }
+
+  for (const Record &record : records) {
+    rc = lock_inserted_record(table, record.rid());
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
   }
   return rc;
 }
@@ -167,7 +222,7 @@ RC MvccTrx::delete_record(Table * table, Record &record)
   trx_fields(table, begin_field, end_field);
 
   [[maybe_unused]] int32_t end_xid = end_field.get_int(record);
-  /// 在删除之前，第一次获取record时，就已经对record做了对应的检查，并且保证不会有其它的事务来访问这条数据
+  /// 在删除之前，第一次获取record时，就已经对record做了对应的检查并加了行锁，不会有其它的事务来修改这条数据
   ASSERT(end_xid > 0, "concurrency conflit: other transaction is updating this record. end_xid=%d, current trx id=%d, rid=%s",
          end_xid, trx_id_, record.rid().to_string().c_str());
   if (end_xid != trx_kit_.max_trx_id()) {
@@ -185,8 +240,90 @@ RC MvccTrx::delete_record(Table * table, Record &record)
   return RC::SUCCESS;
 }
 
+RC MvccTrx::update_record(Table *table, Record &record, const char *new_data)
+{
+  Field begin_field;
+  Field end_field;
+  trx_fields(table, begin_field, end_field);
+
+  // 事务字段在记录的最前面，由事务自己处理，只比较后面的用户字段
+  const TableMeta &table_meta = table->table_meta();
+  const int record_size = table_meta.record_size();
+  const char *old_data = record.data();
+  int first = table_meta.field(table_meta.sys_field_num())->offset();
+  while (first < record_size && old_data[first] == new_data[first]) {
+    first++;
+  }
+  if (first == record_size) {
+    return RC::SUCCESS;
+  }
+  int last = record_size;
+  while (old_data[last - 1] == new_data[last - 1]) {
+    last--;
+  }
+
+  update_buffer_.assign(new_data, new_data + record_size);
+  Record new_record;
+  new_record.set_data(update_buffer_.data(), record_size);
+  begin_field.set_int(new_record, -trx_id_);
+  end_field.set_int(new_record, end_field.get_int(record));
+
+  // 日志中依次存放修改前和修改后的数据。当前事务第一次修改这条记录时记录完整的记录，
+  // 旧版本只保存在内存中，页面在事务结束前刷盘后如果宕机，恢复时要用日志中的旧版本重建 undo 记录。
+  // 之后的修改只记录变化的部分，参考 redo
+  const bool first_update = begin_field.get_int(record) != -trx_id_;
+  if (first_update) {
+    first = 0;
+    last  = record_size;
+  }
+  const int len = last - first;
+  log_buffer_.resize(2 * len);
+  memcpy(log_buffer_.data(), old_data + first, len);
+  memcpy(log_buffer_.data() + len, update_buffer_.data() + first, len);
+
+  RC rc = update_record_with_undo(table, record, first_update ? old_data : nullptr, update_buffer_.data());
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  rc = log_manager_->append_log(CLogType::UPDATE, trx_id_, table->table_id(), record.rid(), 2 * len, first, log_buffer_.data());
+  ASSERT(rc == RC::SUCCESS, "failed to append update record log. trx id=%d, table id=%d, rid=%s, rc=%s",
+      trx_id_, table->table_id(), record.rid().to_string().c_str(), strrc(rc));
+  return rc;
+}
+
+RC MvccTrx::update_record_with_undo(Table *table, Record &record, const char *old_data, const char *new_data)
+{
+  UndoRecord *undo = nullptr;
+  if (old_data != nullptr) {
+    undo = trx_kit_.undo_log().append(table, record.rid(), trx_id_, old_data, table->table_meta().record_size());
+  }
+
+  // 旧版本还可能通过索引访问，它们的索引项要保留
+  std::vector<const char *> old_versions;
+  UndoLog::collect_versions(trx_kit_.undo_log().newest(table, record.rid()), old_versions);
+  RC rc = table->update_record(record, new_data, old_versions);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to update record. table=%s, rid=%s, rc=%s", table->name(), record.rid().to_string().c_str(), strrc(rc));
+    if (undo != nullptr) {
+      trx_kit_.undo_log().remove(undo);
+    }
+    return rc;
+  }
+
+  if (undo != nullptr) {
+    undo_records_.push_back(undo);
+    operations_.insert(Operation(Operation::Type::UPDATE, table, record.rid()));
+  }
+  return rc;
+}
+
 RC MvccTrx::visit_record(Table *table, Record &record, bool readonly)
 {
+  if (!readonly) {
+    return visit_record_for_write(table, record);
+  }
+
   Field begin_field;
   Field end_field;
   trx_fields(table, begin_field, end_field);
@@ -194,9 +331,28 @@ RC MvccTrx::visit_record(Table *table, Record &record, bool readonly)
   int32_t begin_xid = begin_field.get_int(record);
   int32_t end_xid = end_field.get_int(record);
 
+  // 事务提交时没有修改记录，如果写入记录的事务已经提交，就把提交事务号写回记录，下次访问就不需要再查询事务状态了。
+  // 只读访问时这里可能修改的是页面上的数据，不过所有事务写入的值都是相同的，也不会标记为脏页，
+  // 页面淘汰后丢失也没有关系
+  if (begin_xid < 0) {
+    const int32_t commit_xid = trx_kit_.resolve_xid(begin_xid);
+    if (commit_xid > 0) {
+      begin_field.set_int(record, commit_xid);
+      begin_xid = commit_xid;
+    }
+  }
+  if (end_xid < 0) {
+    const int32_t commit_xid = trx_kit_.resolve_xid(end_xid);
+    if (commit_xid > 0) {
+      end_field.set_int(record, commit_xid);
+      end_xid = commit_xid;
+    }
+  }
+
   RC rc = RC::SUCCESS;
   if (begin_xid > 0 && end_xid > 0) {
-    if (trx_id_ >= begin_xid && trx_id_ <= end_xid) {
+    // 插入对快照可见，删除对快照不可见
+    if (read_view_.visible(begin_xid) && !read_view_.visible(end_xid)) {
       rc = RC::SUCCESS;
     } else {
       rc = RC::RECORD_INVISIBLE;
@@ -204,21 +360,157 @@ RC MvccTrx::visit_record(Table *table, Record &record, bool readonly)
   } else if (begin_xid < 0) {
     // begin xid 小于0说明是刚插入而且没有提交的数据
     rc = (-begin_xid == trx_id_) ? RC::SUCCESS : RC::RECORD_INVISIBLE;
+  } else if (!read_view_.visible(begin_xid)) {
+    // 快照创建之后才提交的数据
+    rc = RC::RECORD_INVISIBLE;
   } else if (end_xid < 0) {
     // end xid 小于0 说明是正在删除但是还没有提交的数据
-    if (readonly) {
-      // 如果 -end_xid 就是当前事务的事务号，说明是当前事务删除的
-      rc = (-end_xid != trx_id_) ? RC::SUCCESS : RC::RECORD_INVISIBLE;
-    } else {
-      // 如果当前想要修改此条数据，并且不是当前事务删除的，简单的报错
-      // 这是事务并发处理的一种方式，非常简单粗暴。其它的并发处理方法，可以等待，或者让客户端重试
-      // 或者等事务结束后，再检测修改的数据是否有冲突
-      rc = (-end_xid != trx_id_) ? RC::LOCKED_CONCURRENCY_CONFLICT : RC::RECORD_INVISIBLE;
+    // 如果 -end_xid 就是当前事务的事务号，说明是当前事务删除的
+    rc = (-end_xid != trx_id_) ? RC::SUCCESS : RC::RECORD_INVISIBLE;
+  }
+
+  if (rc == RC::RECORD_INVISIBLE && (begin_xid < 0 ? -begin_xid != trx_id_ : !read_view_.visible(begin_xid))) {
+    // 这个版本是其它事务还没有提交，或者在当前事务开始之后才提交的。如果是原地更新的记录，旧版本可能是可见的
+    rc = visit_old_version(table, record);
+  }
+  return rc;
+}
+
+RC MvccTrx::visit_record_for_write(Table *table, Record &record)
+{
+  Field begin_field;
+  Field end_field;
+  trx_fields(table, begin_field, end_field);
+
+  const int32_t max_trx_id = trx_kit_.max_trx_id();
+  int32_t begin_xid = begin_field.get_int(record);
+  int32_t end_xid   = end_field.get_int(record);
+
+  // 已经提交的删除和当前事务自己的删除，都不需要再加锁。当前事务插入或修改过的记录已经持有行锁
+  if ((end_xid > 0 && end_xid != max_trx_id) || end_xid == -trx_id_) {
+    return RC::RECORD_INVISIBLE;
+  }
+  if (begin_xid != -trx_id_) {
+    RC rc = lock_record(table, record.rid());
+    if (OB_FAIL(rc)) {
+      return rc;
     }
   }
+
+  // 拿到行锁时，修改过这条记录的其它事务都已经结束，回滚的事务在释放锁之前已经恢复了数据，
+  // 所以这里看到的是最新提交的版本。记录上的事务号要在加锁之后再确定
+  begin_xid = trx_kit_.resolve_xid(begin_xid);
+  end_xid   = trx_kit_.resolve_xid(end_xid);
+  if ((begin_xid < 0 && begin_xid != -trx_id_) || (end_xid < 0 && end_xid != -trx_id_)) {
+    LOG_WARN("record is modified by other trx without row lock. trx id=%d, rid=%s, begin xid=%d, end xid=%d",
+             trx_id_, record.rid().to_string().c_str(), begin_xid, end_xid);
+    return RC::LOCKED_CONCURRENCY_CONFLICT;
+  }
+  if (end_xid != max_trx_id) {
+    // 等锁期间被其它事务删除了
+    return RC::RECORD_INVISIBLE;
+  }
+  return RC::SUCCESS;
+}
+
+RC MvccTrx::lock_record(Table *table, const RID &rid)
+{
+  RowLockKey key;
+  key.table_id = table->table_id();
+  key.rid      = rid;
+  if (locks_.count(key) > 0) {
+    return RC::SUCCESS;
+  }
+
+  RC rc = trx_kit_.lock_manager().try_lock(trx_id_, key);
+  if (OB_SUCC(rc)) {
+    locks_.insert(key);
+  } else if (rc == RC::LOCKED_NEED_WAIT) {
+    waiting_lock_ = key;
+  }
+  return rc;
+}
+
+RC MvccTrx::lock_inserted_record(Table *table, const RID &rid)
+{
+  // 新插入的记录也要加锁，其它事务想修改这条记录时，要等到当前事务结束。
+  // 这里没有持有页面锁，可以直接等待(记录的位置可能被已经结束的事务用过，还有事务在等待这个位置上的锁)
+  if (recovering_) {
+    return RC::SUCCESS;
+  }
+
+  RowLockKey key;
+  key.table_id = table->table_id();
+  key.rid      = rid;
+  RC rc = trx_kit_.lock_manager().lock(trx_id_, key);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to lock inserted record. trx id=%d, rid=%s, rc=%s",
+             trx_id_, rid.to_string().c_str(), strrc(rc));
+    return rc;
+  }
+  locks_.insert(key);
+  return rc;
+}
+
+RC MvccTrx::wait_for_lock()
+{
+  RC rc = trx_kit_.lock_manager().lock(trx_id_, waiting_lock_);
+  if (OB_SUCC(rc)) {
+    locks_.insert(waiting_lock_);
+  } else {
+    LOG_WARN("failed to wait for row lock. trx id=%d, table id=%d, rid=%s, rc=%s",
+             trx_id_, waiting_lock_.table_id, waiting_lock_.rid.to_string().c_str(), strrc(rc));
+  }
   return rc;
 }
 
+void MvccTrx::release_locks()
+{
+  LockManager &lock_manager = trx_kit_.lock_manager();
+  for (const RowLockKey &key : locks_) {
+    lock_manager.unlock(trx_id_, key);
+  }
+  locks_.clear();
+}
+
+RC MvccTrx::visit_old_version(Table *table, Record &record)
+{
+  Field begin_field;
+  Field end_field;
+  trx_fields(table, begin_field, end_field);
+
+  // 更新旧版本的事务持有页面的写锁，当前访问页面时持有页面锁，所以版本链不会同时被修改
+  const UndoRecord *undo = trx_kit_.undo_log().newest(table, record.rid());
+  for (; undo != nullptr; undo = undo->older) {
+    Record old_record;
+    old_record.set_data(const_cast<char *>(undo->data.data()), static_cast<int>(undo->data.size()));
+    const int32_t begin_xid = trx_kit_.resolve_xid(begin_field.get_int(old_record));
+    if (begin_xid < 0 || !read_view_.visible(begin_xid)) {
+      continue;
+    }
+
+    record.set_data(old_record.data(), old_record.len());
+    return RC::SUCCESS;
+  }
+  return RC::RECORD_INVISIBLE;
+}
+
+bool MvccTrx::visible_to_all(Table *table, const Record &record)
+{
+  Field begin_field;
+  Field end_field;
+  trx_fields(table, begin_field, end_field);
+
+  const int32_t begin_xid = trx_kit_.resolve_xid(begin_field.get_int(record));
+  const int32_t end_xid = end_field.get_int(record);
+  return begin_xid > 0 && begin_xid < read_view_.low_xid() && end_xid == trx_kit_.max_trx_id();
+}
+
+bool MvccTrx::has_old_versions(Table *table, PageNum page_num)
+{
+  return trx_kit_.undo_log().has_versions(table, page_num);
+}
+
 /**
  * @brief 获取指定表上的事务使用的字段
  * 
@@ -242,7 +534,9 @@ RC MvccTrx::start_if_need()
 {
   if (!started_) {
     ASSERT(operations_.empty(), "try to start a new trx while operations is not empty");
-    trx_id_ = trx_kit_.next_trx_id();
+    ActiveTrxRegistry &active_trxes = trx_kit_.active_trxes();
+    trx_id_ = active_trxes.start(slot_);
+    active_trxes.create_read_view(trx_id_, read_view_);
     LOG_DEBUG("current thread change to new trx with %d", trx_id_);
     RC rc = log_manager_->begin_trx(trx_id_);
     ASSERT(rc == RC::SUCCESS, "failed to append log to clog. rc=%s", strrc(rc));
@@ -253,78 +547,50 @@ RC MvccTrx::start_if_need()
 
 RC MvccTrx::commit()
 {
-  int32_t commit_id = trx_kit_.next_trx_id();
+  if (!started_) {
+    return RC::SUCCESS;
+  }
+
+  // 拿到提交事务号之后，事务结束之前，新创建的快照会把当前事务当作没有提交
+  int32_t commit_id = trx_kit_.active_trxes().begin_commit(slot_);
   return commit_with_trx_id(commit_id);
 }
 
 RC MvccTrx::commit_with_trx_id(int32_t commit_xid)
 {
-  // TODO 这里存在一个很大的问题，不能让其他事务一次性看到当前事务更新到的数据或同时看不到
   RC rc = RC::SUCCESS;
   started_ = false;
-  
-  for (const Operation &operation : operations_) {
-    switch (operation.type()) {
-      case Operation::Type::INSERT: {
-        RID rid(operation.page_num(), operation.slot_num());
-        Table *table = operation.table();
-        Field begin_xid_field, end_xid_field;
-        trx_fields(table, begin_xid_field, end_xid_field);
-
-        auto record_updater = [ this, &begin_xid_field, commit_xid](Record &record) {
-          LOG_DEBUG("before commit insert record. trx id=%d, begin xid=%d, commit xid=%d, lbt=%s",
-                    trx_id_, begin_xid_field.get_int(record), commit_xid, lbt());
-          ASSERT(begin_xid_field.get_int(record) == -this->trx_id_, 
-                 "got an invalid record while committing. begin xid=%d, this trx id=%d", 
-                 begin_xid_field.get_int(record), trx_id_);
-
-          begin_xid_field.set_int(record, commit_xid);
-        };
-
-        rc = operation.table()->visit_record(rid, false/*readonly*/, record_updater);
-        ASSERT(rc == RC::SUCCESS, "failed to get record while committing. rid=%s, rc=%s",
-               rid.to_string().c_str(), strrc(rc));
-      } break;
-
-      case Operation::Type::DELETE: {
-        Table *table = operation.table();
-        RID rid(operation.page_num(), operation.slot_num());
-        
-        Field begin_xid_field, end_xid_field;
-        trx_fields(table, begin_xid_field, end_xid_field);
-
-        auto record_updater = [this, &end_xid_field, commit_xid](Record &record) {
-          (void)this;
-          ASSERT(end_xid_field.get_int(record) == -trx_id_, 
-                 "got an invalid record while committing. end xid=%d, this trx id=%d", 
-                 end_xid_field.get_int(record), trx_id_);
-                
-          end_xid_field.set_int(record, commit_xid);
-        };
-
-        rc = operation.table()->visit_record(rid, false/*readonly*/, record_updater);
-        ASSERT(rc == RC::SUCCESS, "failed to get record while committing. rid=%s, rc=%s",
-               rid.to_string().c_str(), strrc(rc));
-      } break;
-
-      default: {
-        ASSERT(false, "unsupported operation. type=%d", static_cast<int>(operation.type()));
-      }
-    }
-  }
-
   operations_.clear();
+  // 旧版本留在 UndoLog 中，由 MvccVacuum 在没有事务需要时释放
+  undo_records_.clear();
 
+  // 先写提交日志，再修改事务状态。修改状态之后，其它事务就能同时看到当前事务写入的所有数据
   if (!recovering_) {
     rc = log_manager_->commit_trx(trx_id_, commit_xid);
+  } else {
+    trx_kit_.active_trxes().advance_xid(commit_xid);
   }
   LOG_TRACE("append trx commit log. trx id=%d, commit_xid=%d, rc=%s", trx_id_, commit_xid, strrc(rc));
+  if (OB_FAIL(rc)) {
+    // 事务状态仍然是没有提交，写入的数据对其它事务不可见，之后由 MvccVacuum 清理
+    LOG_WARN("failed to append trx commit log. trx id=%d, rc=%s", trx_id_, strrc(rc));
+    trx_kit_.active_trxes().finish(slot_);
+    release_locks();
+    return rc;
+  }
+
+  // 先修改事务状态再释放行锁，等锁的事务拿到锁时就能看到当前事务提交的数据
+  trx_kit_.trx_status().set_committed(trx_id_, commit_xid);
+  trx_kit_.active_trxes().finish(slot_);
+  release_locks();
   return rc;
 }
 
 RC MvccTrx::rollback()
 {
   RC rc = RC::SUCCESS;
+  // 重放日志结束后，会对所有恢复出来的事务(包括已经提交的)执行回滚，不能修改已经结束的事务的状态
+  const bool started = started_;
   started_ = false;
   
   for (const Operation &operation : operations_) {
@@ -369,13 +635,39 @@ RC MvccTrx::rollback()
                rid.to_string().c_str(), strrc(rc));
       } break;
 
+      case Operation::Type::UPDATE: {
+        // 使用 undo_records_ 恢复
+      } break;
+
       default: {
         ASSERT(false, "unsupported operation. type=%d", static_cast<int>(operation.type()));
       }
     }
   }
 
+  // 按照相反的顺序用旧版本恢复更新过的记录
+  for (auto iter = undo_records_.rbegin(); iter != undo_records_.rend(); ++iter) {
+    UndoRecord *undo = *iter;
+    auto record_restorer = [this, undo, &rc](Record &record) {
+      // undo 自己的版本的索引项更新时保留了下来，恢复时不需要重新插入
+      std::vector<const char *> old_versions;
+      UndoLog::collect_versions(undo, old_versions);
+      rc = undo->table->update_record(record, undo->data.data(), old_versions);
+      // 持有页面锁时修改版本链，参考 visit_old_version
+      trx_kit_.undo_log().remove(undo);
+    };
+    RC rc2 = undo->table->visit_record(undo->rid, false/*readonly*/, record_restorer);
+    ASSERT(OB_SUCC(rc2) && OB_SUCC(rc), "failed to restore record while rollback. rid=%s, rc=%s, rc2=%s",
+           undo->rid.to_string().c_str(), strrc(rc), strrc(rc2));
+  }
+
   operations_.clear();
+  undo_records_.clear();
+  if (started) {
+    trx_kit_.trx_status().set_aborted(trx_id_);
+    trx_kit_.active_trxes().finish(slot_);
+  }
+  release_locks();
 
   if (!recovering_) {
     rc = log_manager_->rollback_trx(trx_id_);
@@ -388,7 +680,9 @@ RC find_table(Db *db, const CLogRecord &log_record, Table *&table)
 {
   switch (clog_type_from_integer(log_record.header().type_)) {
     case CLogType::INSERT:
-    case CLogType::DELETE: {
+    case CLogType::DELETE:
+    case CLogType::UPDATE:
+    case CLogType::BATCH_INSERT: {
       const CLogRecordData &data_record = log_record.data_record();
       table = db->find_table(data_record.table_id_);
       if (nullptr == table) {
@@ -427,6 +721,29 @@ RC MvccTrx::redo(Db *db, const CLogRecord &log_record)
       operations_.insert(Operation(Operation::Type::INSERT, table, record.rid()));
     } break;
 
+    case CLogType::BATCH_INSERT: {
+      const CLogRecordData &data_record = log_record.data_record();
+      const int record_len = table->table_meta().record_size();
+      const int entry_len  = static_cast<int>(sizeof(RID)) + record_len;
+      ASSERT(data_record.data_len_ % entry_len == 0, "invalid batch insert log. record len=%d, log record=%s",
+             record_len, log_record.to_string().c_str());
+
+      for (int offset = 0; offset < data_record.data_len_; offset += entry_len) {
+        RID rid;
+        memcpy(&rid, data_record.data_ + offset, sizeof(RID));
+        Record record;
+        record.set_data(data_record.data_ + offset + sizeof(RID), record_len);
+        record.set_rid(rid);
+        RC rc = table->recover_insert_record(record);
+        if (OB_FAIL(rc)) {
+          LOG_WARN("failed to recover batch insert. table=%s, rid=%s, log record=%s, rc=%s",
+                   table->name(), rid.to_string().c_str(), log_record.to_string().c_str(), strrc(rc));
+          return rc;
+        }
+        operations_.insert(Operation(Operation::Type::INSERT, table, rid));
+      }
+    } break;
+
     case CLogType::DELETE: {
       const CLogRecordData &data_record = log_record.data_record();
       Field begin_field;
@@ -449,6 +766,26 @@ RC MvccTrx::redo(Db *db, const CLogRecord &log_record)
       operations_.insert(Operation(Operation::Type::DELETE, table, data_record.rid_));
     } break;
 
+    case CLogType::UPDATE: {
+      const CLogRecordData &data_record = log_record.data_record();
+      // 偏移量为0时是当前事务第一次修改这条记录，日志中有完整的旧版本，参考 update_record。
+      // 页面可能已经是修改之后的数据，所以旧版本只能从日志中取
+      const int  len          = data_record.data_len_ / 2;
+      const bool first_update = data_record.data_offset_ == 0;
+      auto record_updater = [this, table, &data_record, len, first_update, &rc](Record &record) {
+        vector<char> new_data(record.data(), record.data() + table->table_meta().record_size());
+        memcpy(new_data.data() + data_record.data_offset_, data_record.data_ + len, len);
+        rc = update_record_with_undo(table, record, first_update ? data_record.data_ : nullptr, new_data.data());
+      };
+
+      RC rc2 = table->visit_record(data_record.rid_, false/*readonly*/, record_updater);
+      if (OB_FAIL(rc2) || OB_FAIL(rc)) {
+        LOG_WARN("failed to recover update. table=%s, log record=%s, rc=%s, rc2=%s",
+                 table->name(), log_record.to_string().c_str(), strrc(rc), strrc(rc2));
+        return OB_FAIL(rc2) ? rc2 : rc;
+      }
+    } break;
+
     case CLogType::MTR_COMMIT: {
       const CLogRecordCommitData &commit_record = log_record.commit_record();
       commit_with_trx_id(commit_record.commit_xid_);
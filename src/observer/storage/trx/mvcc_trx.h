@@ -17,9 +17,18 @@ See the Mulan PSL v2 for more details. */
 #include <vector>
 
 #include "storage/trx/trx.h"
+#include "storage/trx/active_trx_registry.h"
+#include "storage/trx/lock_manager.h"
+#include "storage/trx/trx_status_table.h"
+#include "storage/trx/undo_log.h"
 
 class CLogManager;
 
+/**
+ * @brief 多版本并发事务的管理
+ * @ingroup Transaction
+ * @details 活跃的事务记录在 ActiveTrxRegistry 中，创建、销毁事务和创建快照都不加锁
+ */
 class MvccTrxKit : public TrxKit
 {
 public:
@@ -33,31 +42,51 @@ public:
   void destroy_trx(Trx *trx) override;
 
   /**
-   * @brief 找到对应事务号的事务
+   * @brief 找到对应事务号的活跃事务
    * @details 当前仅在recover场景下使用
    */
   Trx *find_trx(int32_t trx_id) override;
   void all_trxes(std::vector<Trx *> &trxes) override;
 
-public:
-  int32_t next_trx_id();
-
 public:
   int32_t max_trx_id() const;
 
+  /**
+   * @brief 当前活跃事务中最小的事务号
+   * @details 如果没有活跃的事务，就返回下一个将要分配的事务号。
+   * 提交事务号小于这个值的数据，对当前以及以后的所有事务都是可见的
+   */
+  int32_t oldest_active_trx_id();
+
+  ActiveTrxRegistry &active_trxes() { return active_trxes_; }
+  TrxStatusTable    &trx_status() { return trx_status_; }
+  UndoLog           &undo_log() { return undo_log_; }
+  LockManager       &lock_manager() { return lock_manager_; }
+
+  /**
+   * @brief 确定记录上的事务号
+   * @details 记录上的事务号小于0时，表示写入这条记录的事务在写入时还没有提交。如果这个事务现在已经提交了，
+   * 就返回它的提交事务号，否则原样返回
+   */
+  int32_t resolve_xid(int32_t xid) const;
+
 private:
   std::vector<FieldMeta> fields_; // 存储事务数据需要用到的字段元数据，所有表结构都需要带的
 
-  std::atomic<int32_t> current_trx_id_{0};
-
-  common::Mutex      lock_;
-  std::vector<Trx *> trxes_;
+  ActiveTrxRegistry active_trxes_;
+  TrxStatusTable    trx_status_;
+  UndoLog           undo_log_;
+  LockManager       lock_manager_;
 };
 
 /**
  * @brief 多版本并发事务
  * @ingroup Transaction
- * TODO 没有垃圾回收
+ * @details 旧版本由 MvccVacuum 在后台回收。
+ * 事务开始时创建快照(ReadView)，根据记录上的提交事务号和快照判断可见性。
+ * 提交时只在 TrxStatusTable 中修改事务的状态，不修改事务写过的记录，访问记录时再查询事务是否已经提交。
+ * 更新记录时直接修改页面上的数据，原来的数据保存在 UndoLog 中，用于回滚和读取旧版本。
+ * 插入、修改和删除记录之前都要加行锁(参考 LockManager)，事务结束时释放。
  */
 class MvccTrx : public Trx
 {
@@ -67,19 +96,41 @@ public:
   virtual ~MvccTrx();
 
   RC insert_record(Table *table, Record &record) override;
+
+  /**
+   * @brief 插入多条记录
+   * @details 所有记录只写一条 BATCH_INSERT 日志
+   */
+  RC insert_records(Table *table, std::vector<Record> &records) override;
   RC delete_record(Table *table, Record &record) override;
 
+  /**
+   * @brief 原地更新一条记录
+   * @details 第一次修改某条记录时，把原来的数据写到 UndoLog 中，日志中只记录变化的部分。
+   * 当前事务插入的或者已经修改过的记录，不需要再保存旧版本
+   */
+  RC update_record(Table *table, Record &record, const char *new_data) override;
+
   /**
    * @brief 当访问到某条数据时，使用此函数来判断是否可见，或者是否有访问冲突
+   * @details 只读访问按照快照判断可见性。以修改为目的访问时先加行锁，拿到锁之后访问的是最新提交的版本
+   * (当前读)，这样等待其它事务结束后可以继续修改，不需要回滚
    * 
    * @param table    要访问的数据属于哪张表
    * @param record   要访问哪条数据
    * @param readonly 是否只读访问
    * @return RC      - SUCCESS 成功
    *                 - RECORD_INVISIBLE 此数据对当前事务不可见，应该跳过
-   *                 - LOCKED_CONCURRENCY_CONFLICT 与其它事务有冲突
+   *                 - LOCKED_NEED_WAIT 行锁被其它事务持有，释放页面锁之后调用 wait_for_lock，再重新访问
    */
   RC visit_record(Table *table, Record &record, bool readonly) override;
+  RC wait_for_lock() override;
+
+  /**
+   * @brief 记录已经提交、没有被删除，并且提交事务号比快照中最老的活跃事务还要小，就对所有事务可见
+   */
+  bool visible_to_all(Table *table, const Record &record) override;
+  bool has_old_versions(Table *table, PageNum page_num) override;
 
   RC start_if_need() override;
   RC commit() override;
@@ -89,8 +140,42 @@ public:
 
   int32_t id() const override { return trx_id_; }
 
+  /**
+   * @brief 事务是否已经开始并且还没有结束
+   * @details 事务对象会在会话中复用，结束后 trx_id_ 仍然保留着上一个事务的事务号
+   */
+  bool started() const { return started_; }
+
 private:
   RC commit_with_trx_id(int32_t commit_id);
+
+  /**
+   * @brief 页面上的记录对当前事务不可见时，从旧版本中找可见的版本
+   * @details 找到时 record 会指向可见的旧版本。只用于只读访问
+   */
+  RC visit_old_version(Table *table, Record &record);
+
+  /**
+   * @brief 以修改为目的访问记录，参考 visit_record
+   */
+  RC visit_record_for_write(Table *table, Record &record);
+
+  /**
+   * @brief 对记录加行锁，不等待。已经持有的锁直接返回成功
+   */
+  RC lock_record(Table *table, const RID &rid);
+
+  /**
+   * @brief 用新的数据修改记录，不写日志
+   * @param old_data 不为空时先把它保存为旧版本，回滚时恢复
+   */
+  RC update_record_with_undo(Table *table, Record &record, const char *old_data, const char *new_data);
+
+  /**
+   * @brief 对新插入的记录加行锁，需要时等待
+   */
+  RC lock_inserted_record(Table *table, const RID &rid);
+  void release_locks();
   void trx_fields(Table *table, Field &begin_xid_field, Field &end_xid_field) const;
 
 private:
@@ -100,8 +185,16 @@ private:
   using OperationSet = std::unordered_set<Operation, OperationHasher, OperationEqualer>;
   MvccTrxKit & trx_kit_;
   CLogManager *log_manager_ = nullptr;
+  ActiveTrxRegistry::Slot *slot_ = nullptr;  ///< 在活跃事务表中的位置
   int32_t      trx_id_ = -1;
+  ReadView     read_view_;  ///< 事务开始时创建的快照
   bool         started_ = false;
   bool         recovering_ = false;
   OperationSet operations_;
+  std::vector<UndoRecord *> undo_records_;  ///< 当前事务保存的旧版本，回滚时按照相反的顺序恢复
+  std::vector<char>         update_buffer_;
+  std::vector<char>         log_buffer_;  ///< UPDATE 日志的数据
+
+  std::unordered_set<RowLockKey, RowLockKeyHash> locks_;         ///< 当前事务持有的行锁
+  RowLockKey                                     waiting_lock_;  ///< 需要等待的行锁
 };
@@ -0,0 +1,251 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "storage/trx/mvcc_vacuum.h"
+#include "common/log/log.h"
+#include "storage/default/default_handler.h"
+#include "storage/field/field.h"
+#include "storage/record/record.h"
+#include "storage/table/table.h"
+#include "storage/trx/mvcc_trx.h"
+
+using namespace std;
+
+MvccVacuum::MvccVacuum(MvccTrxKit &trx_kit, DefaultHandler &handler) : trx_kit_(trx_kit), handler_(handler)
+{}
+
+MvccVacuum::~MvccVacuum()
+{
+  stop();
+}
+
+void MvccVacuum::start(int interval_ms, int io_budget)
+{
+  if (!stopped_) {
+    return;
+  }
+
+  interval_ms_ = max(interval_ms, 1);
+  io_budget_   = max(io_budget, 1);
+  stopped_     = false;
+  thread_      = thread(&MvccVacuum::thread_func, this);
+  LOG_INFO("mvcc vacuum started. interval=%dms, io budget=%d", interval_ms_, io_budget_);
+}
+
+void MvccVacuum::stop()
+{
+  {
+    lock_guard<mutex> guard(mutex_);
+    if (stopped_) {
+      return;
+    }
+    stopped_ = true;
+  }
+
+  cond_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  LOG_INFO("mvcc vacuum stopped. rounds=%ld, scanned pages=%ld, reclaimed rows=%ld, purged versions=%ld",
+           stats_.rounds.load(), stats_.scanned_pages.load(), stats_.reclaimed_rows.load(),
+           stats_.purged_versions.load());
+}
+
+void MvccVacuum::thread_func()
+{
+  unique_lock<mutex> lock(mutex_);
+  while (!stopped_) {
+    cond_.wait_for(lock, chrono::milliseconds(interval_ms_), [this]() { return stopped_; });
+    if (stopped_) {
+      break;
+    }
+
+    lock.unlock();
+    RC rc = run_once(io_budget_);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to run mvcc vacuum. rc=%s", strrc(rc));
+    }
+    lock.lock();
+  }
+}
+
+RC MvccVacuum::run_once(int io_budget)
+{
+  unique_lock<shared_mutex> gate_guard(statement_gate_);
+
+  // 所有活跃事务的事务号都不会比这个小，新开始的事务号更大
+  const int32_t oldest_active_trx_id = trx_kit_.oldest_active_trx_id();
+
+  purge_undo(oldest_active_trx_id);
+
+  RC  rc              = RC::SUCCESS;
+  int reclaimed_rows  = 0;
+  int finished_tables = 0;
+  int table_num       = 0;
+  Table *table        = nullptr;
+  // 每张表在一轮中最多检查一遍
+  while (io_budget > 0 && (table = next_table(table_num)) != nullptr && finished_tables < table_num) {
+    const int io_budget_before = io_budget;
+    int       reclaimed        = 0;
+    rc = table->vacuum(cursor_page_, io_budget, [this, table, oldest_active_trx_id](const Record &record) {
+      return is_dead(table, record, oldest_active_trx_id);
+    }, reclaimed);
+    if (OB_FAIL(rc)) {
+      // 跳过这张表，下一轮从下一张表开始
+      LOG_WARN("failed to vacuum table. table=%s, rc=%s", table->name(), strrc(rc));
+      cursor_page_ = BP_INVALID_PAGE_NUM;
+      break;
+    }
+
+    stats_.scanned_pages += io_budget_before - io_budget - reclaimed;
+    reclaimed_rows += reclaimed;
+    if (cursor_page_ == BP_INVALID_PAGE_NUM) {
+      finished_tables++;
+    }
+  }
+
+  stats_.rounds++;
+  stats_.reclaimed_rows += reclaimed_rows;
+  if (reclaimed_rows > 0) {
+    LOG_INFO("mvcc vacuum reclaimed %d rows. oldest active trx id=%d", reclaimed_rows, oldest_active_trx_id);
+  }
+  return rc;
+}
+
+Table *MvccVacuum::next_table(int &table_num)
+{
+  vector<pair<string, string>> tables;
+  vector<string> db_names;
+  handler_.all_dbs(db_names);
+  for (const string &db_name : db_names) {
+    vector<string> table_names;
+    handler_.find_db(db_name.c_str())->all_tables(table_names);
+    for (string &table_name : table_names) {
+      tables.emplace_back(db_name, std::move(table_name));
+    }
+  }
+  table_num = static_cast<int>(tables.size());
+  if (tables.empty()) {
+    return nullptr;
+  }
+
+  // 上次的表还没有清理完，继续清理
+  if (cursor_page_ != BP_INVALID_PAGE_NUM) {
+    Table *table = handler_.find_table(cursor_db_.c_str(), cursor_table_.c_str());
+    if (table != nullptr) {
+      return table;
+    }
+  }
+
+  sort(tables.begin(), tables.end());
+  auto iter = upper_bound(tables.begin(), tables.end(), make_pair(cursor_db_, cursor_table_));
+  if (iter == tables.end()) {
+    iter = tables.begin();
+  }
+
+  cursor_db_    = iter->first;
+  cursor_table_ = iter->second;
+  cursor_page_  = BP_HEADER_PAGE;  // 从头开始，数据页面在文件头之后
+  return handler_.find_table(cursor_db_.c_str(), cursor_table_.c_str());
+}
+
+void MvccVacuum::purge_undo(int32_t oldest_active_trx_id)
+{
+  UndoLog        &undo_log   = trx_kit_.undo_log();
+  TrxStatusTable &trx_status = trx_kit_.trx_status();
+
+  // 事务没有提交也没有回滚就被销毁了(比如连接断开)，它更新的记录一定是版本链中最新的
+  vector<UndoRecord *> abandoned;
+  undo_log.find_newest([&trx_status, oldest_active_trx_id](const UndoRecord &undo) {
+    return undo.trx_id < oldest_active_trx_id && trx_status.commit_xid(undo.trx_id) <= 0;
+  }, abandoned);
+
+  for (UndoRecord *undo : abandoned) {
+    RC rc = RC::SUCCESS;
+    auto record_restorer = [&undo_log, undo, &rc](Record &record) {
+      vector<const char *> old_versions;
+      UndoLog::collect_versions(undo, old_versions);
+      rc = undo->table->update_record(record, undo->data.data(), old_versions);
+      undo_log.remove(undo);
+    };
+    RC rc2 = undo->table->visit_record(undo->rid, false/*readonly*/, record_restorer);
+    if (OB_FAIL(rc2) || OB_FAIL(rc)) {
+      LOG_WARN("failed to restore record updated by abandoned trx. table=%s, rid=%s, trx id=%d, rc=%s, rc2=%s",
+               undo->table->name(), undo->rid.to_string().c_str(), undo->trx_id, strrc(rc), strrc(rc2));
+    }
+  }
+
+  // 所有活跃事务都是在更新提交之后开始的，不会再访问更新之前的版本
+  const int purged = undo_log.purge([&trx_status, oldest_active_trx_id](const UndoRecord &undo) {
+    const int32_t commit_xid = trx_status.commit_xid(undo.trx_id);
+    return commit_xid > 0 && commit_xid < oldest_active_trx_id;
+  }, [this](const UndoRecord &undo) {
+    remove_index_entries(undo);
+  });
+  stats_.purged_versions += purged;
+  if (!abandoned.empty() || purged > 0) {
+    LOG_INFO("mvcc vacuum purged %d old versions, restored %d records. oldest active trx id=%d",
+             purged, static_cast<int>(abandoned.size()), oldest_active_trx_id);
+  }
+}
+
+void MvccVacuum::remove_index_entries(const UndoRecord &undo)
+{
+  // 页面上的记录和还没有释放的旧版本用到的索引项要保留
+  vector<char> current_data;
+  RC rc = undo.table->visit_record(undo.rid, true/*readonly*/, [&current_data](Record &record) {
+    current_data.assign(record.data(), record.data() + record.len());
+  });
+  if (OB_FAIL(rc) && rc != RC::RECORD_NOT_EXIST) {
+    LOG_WARN("failed to get record to remove index entries of old version. table=%s, rid=%s, rc=%s",
+             undo.table->name(), undo.rid.to_string().c_str(), strrc(rc));
+    return;
+  }
+
+  vector<const char *> live_versions;
+  if (!current_data.empty()) {
+    live_versions.push_back(current_data.data());
+  }
+  UndoLog::collect_versions(trx_kit_.undo_log().newest(undo.table, undo.rid), live_versions);
+  rc = undo.table->remove_version_entries(undo.data.data(), undo.rid, live_versions);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to remove index entries of old version. table=%s, rid=%s, rc=%s",
+             undo.table->name(), undo.rid.to_string().c_str(), strrc(rc));
+  }
+}
+
+bool MvccVacuum::is_dead(Table *table, const Record &record, int32_t oldest_active_trx_id) const
+{
+  const pair<const FieldMeta *, int> trx_fields = table->table_meta().trx_fields();
+  if (trx_fields.second < 2) {
+    return false;
+  }
+
+  Field begin_field(table, &trx_fields.first[0]);
+  Field end_field(table, &trx_fields.first[1]);
+  // 事务提交时没有修改记录，记录上可能还是负的事务号，需要查询事务是否已经提交
+  const int32_t begin_xid = trx_kit_.resolve_xid(begin_field.get_int(record));
+  const int32_t end_xid   = trx_kit_.resolve_xid(end_field.get_int(record));
+
+  // 删除已经提交，所有活跃事务的事务号都比删除的提交事务号大，看不到这条记录
+  if (end_xid > 0 && end_xid != trx_kit_.max_trx_id() && end_xid < oldest_active_trx_id) {
+    return true;
+  }
+
+  // 插入记录的事务已经结束了，但是没有提交
+  if (begin_xid < 0 && -begin_xid < oldest_active_trx_id) {
+    return true;
+  }
+  return false;
+}
@@ -0,0 +1,120 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+
+#include "common/rc.h"
+#include "storage/buffer/page.h"
+
+class MvccTrxKit;
+class DefaultHandler;
+class Table;
+class Record;
+struct UndoRecord;
+
+/**
+ * @brief 多版本数据的垃圾回收
+ * @ingroup Transaction
+ * @details MVCC 中删除记录只是设置了记录的 end_xid，数据仍然留在数据文件和索引中，
+ * 扫描时需要跳过，页面也不能重新使用。
+ * 这里在后台周期性地清理对所有事务都不可见的记录：
+ * - 删除已经提交，并且提交事务号比最老的活跃事务还要小；
+ * - 插入的事务已经结束但没有提交。正常回滚时会直接删除插入的记录，这里清理的是
+ *   事务没有结束就被销毁(比如连接断开)留下来的数据。
+ * 原地更新保存在 UndoLog 中的旧版本，在提交事务号比最老的活跃事务还要小时释放；没有结束就被销毁的事务，
+ * 用旧版本恢复它更新过的记录。
+ * 每一轮清理有I/O预算限制，按表逐页推进，下一轮从上次停下的位置继续，避免一次占用太长时间。
+ *
+ * 当前的存储层没有完善的并发控制(CONCURRENCY 默认关闭)，所以清理时需要独占 statement_gate，
+ * 执行SQL请求时持有它的共享锁，这样清理不会和任何语句同时进行。
+ */
+class MvccVacuum
+{
+public:
+  struct Stats
+  {
+    std::atomic<int64_t> rounds{0};          ///< 执行了多少轮清理
+    std::atomic<int64_t> scanned_pages{0};   ///< 检查过的页面数
+    std::atomic<int64_t> reclaimed_rows{0};  ///< 清理的记录数
+    std::atomic<int64_t> purged_versions{0}; ///< 释放的旧版本数
+  };
+
+public:
+  MvccVacuum(MvccTrxKit &trx_kit, DefaultHandler &handler);
+  ~MvccVacuum();
+
+  /**
+   * @brief 启动后台清理线程
+   * @param interval_ms 两轮清理之间的间隔
+   * @param io_budget   每一轮清理的I/O预算，参考 Table::vacuum
+   */
+  void start(int interval_ms, int io_budget);
+  void stop();
+
+  /**
+   * @brief 执行一轮清理
+   */
+  RC run_once(int io_budget);
+
+  std::shared_mutex &statement_gate() { return statement_gate_; }
+  const Stats &stats() const { return stats_; }
+
+private:
+  void thread_func();
+
+  /**
+   * @brief 找到下一个需要清理的表
+   * @details 按照数据库名和表名排序，找到当前游标之后的第一个表，所有表都清理过一遍后从头开始
+   * @param table_num[out] 当前所有表的个数
+   */
+  Table *next_table(int &table_num);
+
+  bool is_dead(Table *table, const Record &record, int32_t oldest_active_trx_id) const;
+
+  /**
+   * @brief 删除释放的旧版本的索引项
+   * @details 更新记录时旧版本的索引项没有删除，它们还可能通过索引访问，参考 Table::update_record
+   */
+  void remove_index_entries(const UndoRecord &undo);
+
+  /**
+   * @brief 释放不再需要的旧版本，恢复没有结束的事务更新过的记录
+   * @details 需要在清理表之前执行，否则恢复之前的记录会被当作没有提交的插入删除掉
+   */
+  void purge_undo(int32_t oldest_active_trx_id);
+
+private:
+  MvccTrxKit     &trx_kit_;
+  DefaultHandler &handler_;
+
+  std::shared_mutex statement_gate_;
+
+  /// 清理的游标，即当前正在清理的表和下一个要检查的页面
+  std::string cursor_db_;
+  std::string cursor_table_;
+  PageNum     cursor_page_ = BP_INVALID_PAGE_NUM;
+
+  int interval_ms_ = 1000;
+  int io_budget_   = 128;
+
+  std::thread            thread_;
+  std::mutex             mutex_;
+  std::condition_variable cond_;
+  bool                   stopped_ = true;
+
+  Stats stats_;
+};
@@ -145,9 +145,42 @@ public:
   virtual ~Trx() = default;
 
   virtual RC insert_record(Table *table, Record &record) = 0;
+
+  /**
+   * @brief 插入多条记录
+   * @details 一条语句插入的多条记录成批写入表、索引和日志，插入成功后每条记录中有对应的RID
+   */
+  virtual RC insert_records(Table *table, std::vector<Record> &records) = 0;
   virtual RC delete_record(Table *table, Record &record) = 0;
+
+  /**
+   * @brief 原地更新一条记录
+   * @param record   以读写方式访问到的记录，并且已经通过 visit_record 检查过
+   * @param new_data 更新之后完整的记录数据，事务字段由事务自己处理
+   */
+  virtual RC update_record(Table *table, Record &record, const char *new_data) = 0;
   virtual RC visit_record(Table *table, Record &record, bool readonly) = 0;
 
+  /**
+   * @brief 等待 visit_record 返回 LOCKED_NEED_WAIT 时需要的锁
+   * @details 调用之前需要释放持有的页面锁，拿到锁之后重新访问记录
+   */
+  virtual RC wait_for_lock() = 0;
+
+  /**
+   * @brief 页面上是否可能有记录需要通过旧版本判断可见性
+   * @details 如果有，页面上的数据不满足过滤条件时，还需要检查对当前事务可见的旧版本是否满足。
+   * 返回 true 总是安全的
+   */
+  virtual bool has_old_versions(Table *table, PageNum page_num) = 0;
+
+  /**
+   * @brief 判断记录是否对所有事务(包括以后才开始的事务)都可见
+   * @details 用来设置页面全部可见的提示信息，参考 Frame::all_visible。
+   * 返回 false 总是安全的，只是会让索引覆盖扫描多访问一次表数据
+   */
+  virtual bool visible_to_all(Table *table, const Record &record) = 0;
+
   virtual RC start_if_need() = 0;
   virtual RC commit() = 0;
   virtual RC rollback() = 0;
@@ -0,0 +1,81 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "storage/trx/trx_status_table.h"
+#include "common/log/log.h"
+
+using namespace std;
+
+TrxStatusTable::TrxStatusTable() : segments_(new atomic<atomic<int32_t> *>[MAX_SEGMENTS])
+{
+  for (int32_t i = 0; i < MAX_SEGMENTS; i++) {
+    segments_[i].store(nullptr, memory_order_relaxed);
+  }
+}
+
+TrxStatusTable::~TrxStatusTable()
+{
+  for (int32_t i = 0; i < MAX_SEGMENTS; i++) {
+    delete[] segments_[i].load(memory_order_relaxed);
+  }
+}
+
+void TrxStatusTable::set_committed(int32_t trx_id, int32_t commit_xid)
+{
+  ASSERT(commit_xid > 0, "invalid commit xid. trx id=%d, commit xid=%d", trx_id, commit_xid);
+  atomic<int32_t> *slot = status_slot(trx_id);
+  if (slot != nullptr) {
+    slot->store(commit_xid, memory_order_release);
+  }
+}
+
+void TrxStatusTable::set_aborted(int32_t trx_id)
+{
+  atomic<int32_t> *slot = status_slot(trx_id);
+  if (slot != nullptr) {
+    slot->store(ABORTED, memory_order_release);
+  }
+}
+
+int32_t TrxStatusTable::commit_xid(int32_t trx_id) const
+{
+  if (trx_id <= 0) {
+    return IN_PROGRESS;
+  }
+
+  const atomic<int32_t> *segment = segments_[trx_id >> SEGMENT_BITS].load(memory_order_acquire);
+  if (segment == nullptr) {
+    return IN_PROGRESS;
+  }
+  return segment[trx_id & (SEGMENT_SIZE - 1)].load(memory_order_acquire);
+}
+
+atomic<int32_t> *TrxStatusTable::status_slot(int32_t trx_id)
+{
+  if (trx_id <= 0) {
+    LOG_WARN("invalid trx id. trx id=%d", trx_id);
+    return nullptr;
+  }
+
+  atomic<atomic<int32_t> *> &segment_ptr = segments_[trx_id >> SEGMENT_BITS];
+  atomic<int32_t> *segment = segment_ptr.load(memory_order_acquire);
+  if (segment == nullptr) {
+    lock_guard<mutex> guard(lock_);
+    segment = segment_ptr.load(memory_order_relaxed);
+    if (segment == nullptr) {
+      segment = new atomic<int32_t>[SEGMENT_SIZE];
+      for (int32_t i = 0; i < SEGMENT_SIZE; i++) {
+        segment[i].store(IN_PROGRESS, memory_order_relaxed);
+      }
+      segment_ptr.store(segment, memory_order_release);
+    }
+  }
+  return &segment[trx_id & (SEGMENT_SIZE - 1)];
+}
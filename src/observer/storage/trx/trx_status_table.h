@@ -0,0 +1,58 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+/**
+ * @brief 事务状态表
+ * @ingroup Transaction
+ * @details 记录每个事务是否已经提交，以及提交时的事务号，类似 PostgreSQL 的 clog。
+ * MvccTrx 提交时只修改这里的状态，不再逐条修改事务写过的记录，记录上仍然保存着负的事务号。
+ * 其它事务访问到这些记录时查询这张表，发现已经提交就把提交事务号写回记录(hint)，之后就不用再查表了。
+ *
+ * 事务号是连续分配的，按照事务号分段存放，每段 SEGMENT_SIZE 个事务，第一次用到时再分配。
+ * 读取不加锁，每个事务占用4个字节。
+ * 状态只保存在内存中，重启后重放日志时根据 MTR_COMMIT 重建。
+ */
+class TrxStatusTable
+{
+public:
+  static constexpr int32_t IN_PROGRESS = 0;   ///< 事务还没有结束，或者没有正常结束(比如连接断开)
+  static constexpr int32_t ABORTED     = -1;  ///< 事务已经回滚
+
+public:
+  TrxStatusTable();
+  ~TrxStatusTable();
+
+  void set_committed(int32_t trx_id, int32_t commit_xid);
+  void set_aborted(int32_t trx_id);
+
+  /**
+   * @brief 查询事务的状态
+   * @return 已经提交时返回提交事务号(大于0)，否则返回 IN_PROGRESS 或 ABORTED
+   */
+  int32_t commit_xid(int32_t trx_id) const;
+
+private:
+  std::atomic<int32_t> *status_slot(int32_t trx_id);
+
+private:
+  static constexpr int     SEGMENT_BITS = 16;
+  static constexpr int32_t SEGMENT_SIZE = 1 << SEGMENT_BITS;
+  static constexpr int32_t MAX_SEGMENTS = (INT32_MAX >> SEGMENT_BITS) + 1;
+
+  std::mutex                                           lock_;  ///< 分配新的段时使用
+  std::unique_ptr<std::atomic<std::atomic<int32_t> *>[]> segments_;
+};
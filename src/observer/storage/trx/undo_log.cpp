@@ -0,0 +1,163 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "storage/trx/undo_log.h"
+#include "common/log/log.h"
+
+using namespace std;
+
+UndoLog::~UndoLog()
+{
+  for (auto &item : versions_) {
+    free_versions(item.second);
+  }
+  for (UndoRecord *undo : removed_) {
+    delete undo;
+  }
+}
+
+UndoRecord *UndoLog::append(Table *table, const RID &rid, int32_t trx_id, const char *data, int len)
+{
+  UndoRecord *undo = new UndoRecord;
+  undo->table  = table;
+  undo->rid    = rid;
+  undo->trx_id = trx_id;
+  undo->data.assign(data, data + len);
+
+  lock_guard<mutex> guard(lock_);
+  UndoRecord *&newest = versions_[VersionKey{table, rid}];
+  if (newest == nullptr) {
+    page_versions_[PageKey{table, rid.page_num}]++;
+  }
+  undo->older = newest;
+  newest      = undo;
+  return undo;
+}
+
+const UndoRecord *UndoLog::newest(Table *table, const RID &rid)
+{
+  lock_guard<mutex> guard(lock_);
+  auto iter = versions_.find(VersionKey{table, rid});
+  return iter == versions_.end() ? nullptr : iter->second;
+}
+
+bool UndoLog::has_versions(Table *table, PageNum page_num)
+{
+  lock_guard<mutex> guard(lock_);
+  return page_versions_.find(PageKey{table, page_num}) != page_versions_.end();
+}
+
+void UndoLog::remove(UndoRecord *undo)
+{
+  lock_guard<mutex> guard(lock_);
+  const VersionKey key{undo->table, undo->rid};
+  auto iter = versions_.find(key);
+  ASSERT(iter != versions_.end() && iter->second == undo,
+         "only the newest version can be removed. rid=%s, trx id=%d", undo->rid.to_string().c_str(), undo->trx_id);
+
+  if (undo->older != nullptr) {
+    iter->second = undo->older;
+  } else {
+    remove_version(key);
+  }
+  undo->older = nullptr;
+  removed_.push_back(undo);
+}
+
+void UndoLog::find_newest(const function<bool(const UndoRecord &)> &predicate, vector<UndoRecord *> &undos)
+{
+  lock_guard<mutex> guard(lock_);
+  for (auto &item : versions_) {
+    if (predicate(*item.second)) {
+      undos.push_back(item.second);
+    }
+  }
+}
+
+int UndoLog::purge(const function<bool(const UndoRecord &)> &is_obsolete,
+                   const function<void(const UndoRecord &)> &on_purge)
+{
+  int purged = 0;
+  vector<UndoRecord *> obsolete;  // 从版本链中摘下来的部分
+  {
+    lock_guard<mutex> guard(lock_);
+    purged = static_cast<int>(removed_.size());
+    for (UndoRecord *undo : removed_) {
+      delete undo;
+    }
+    removed_.clear();
+    purge_locked(is_obsolete, obsolete);
+  }
+
+  for (UndoRecord *undo : obsolete) {
+    for (const UndoRecord *version = undo; on_purge && version != nullptr; version = version->older) {
+      on_purge(*version);
+    }
+    purged += free_versions(undo);
+  }
+  return purged;
+}
+
+void UndoLog::collect_versions(const UndoRecord *undo, vector<const char *> &versions)
+{
+  for (; undo != nullptr; undo = undo->older) {
+    versions.push_back(undo->data.data());
+  }
+}
+
+void UndoLog::purge_locked(const function<bool(const UndoRecord &)> &is_obsolete, vector<UndoRecord *> &obsolete)
+{
+  for (auto iter = versions_.begin(); iter != versions_.end();) {
+    UndoRecord *newer = nullptr;
+    UndoRecord *undo  = iter->second;
+    while (undo != nullptr && !is_obsolete(*undo)) {
+      newer = undo;
+      undo  = undo->older;
+    }
+
+    if (undo == nullptr) {
+      ++iter;
+      continue;
+    }
+
+    obsolete.push_back(undo);
+    if (newer != nullptr) {
+      newer->older = nullptr;
+      ++iter;
+    } else {
+      auto page_iter = page_versions_.find(PageKey{iter->first.table, iter->first.rid.page_num});
+      if (--page_iter->second == 0) {
+        page_versions_.erase(page_iter);
+      }
+      iter = versions_.erase(iter);
+    }
+  }
+}
+
+void UndoLog::remove_version(const VersionKey &key)
+{
+  versions_.erase(key);
+  auto page_iter = page_versions_.find(PageKey{key.table, key.rid.page_num});
+  if (--page_iter->second == 0) {
+    page_versions_.erase(page_iter);
+  }
+}
+
+int UndoLog::free_versions(UndoRecord *undo)
+{
+  int count = 0;
+  while (undo != nullptr) {
+    UndoRecord *older = undo->older;
+    delete undo;
+    undo = older;
+    count++;
+  }
+  return count;
+}
@@ -0,0 +1,129 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "storage/record/record.h"
+
+class Table;
+
+/**
+ * @brief 一条undo记录，保存记录被原地更新之前的数据
+ * @ingroup Transaction
+ */
+struct UndoRecord
+{
+  Table            *table  = nullptr;
+  RID               rid;
+  int32_t           trx_id = -1;       ///< 更新这条记录的事务
+  std::vector<char> data;              ///< 更新之前的完整记录，包括事务字段
+  UndoRecord       *older  = nullptr;  ///< 同一条记录更早的版本
+};
+
+/**
+ * @brief 原地更新的记录的旧版本
+ * @ingroup Transaction
+ * @details MvccTrx 原地更新记录之前，把原来的数据放到这里，同一条记录的多个旧版本从新到旧链接在一起。
+ * 回滚时用旧版本恢复记录，数据页面上的版本对事务不可见时，从这里找可见的旧版本。
+ * 每个事务自己也会记录写过的 undo 记录，参考 MvccTrx::undo_records_。
+ *
+ * 旧版本的内存只在 purge 时释放，由 MvccVacuum 持有 statement_gate 时调用，这时没有SQL在执行，
+ * 所以其它事务可以直接引用旧版本的数据，不需要复制出来。
+ */
+class UndoLog
+{
+public:
+  UndoLog() = default;
+  ~UndoLog();
+
+  /**
+   * @brief 记录一个旧版本，放在版本链的最前面
+   */
+  UndoRecord *append(Table *table, const RID &rid, int32_t trx_id, const char *data, int len);
+
+  /**
+   * @brief 记录最新的旧版本，没有时返回空
+   */
+  const UndoRecord *newest(Table *table, const RID &rid);
+
+  /**
+   * @brief 页面上是否有记录存在旧版本
+   */
+  bool has_versions(Table *table, PageNum page_num);
+
+  /**
+   * @brief 把最新的旧版本从版本链中去掉，用于回滚
+   * @details 内存在下次 purge 时释放，其它事务可能还在访问
+   */
+  void remove(UndoRecord *undo);
+
+  /**
+   * @brief 找到满足条件的最新的旧版本
+   */
+  void find_newest(const std::function<bool(const UndoRecord &)> &predicate, std::vector<UndoRecord *> &undos);
+
+  /**
+   * @brief 释放不再需要的旧版本
+   * @details 从新到旧检查每个版本链，第一个 is_obsolete 返回 true 的版本以及更早的版本都会释放。
+   * 释放之前对每个版本调用 on_purge(不持有锁)，这时它们已经不在版本链中了，可以用来删除旧版本的索引项。
+   * 只能在没有其它事务访问旧版本时调用
+   * @return 释放的旧版本个数
+   */
+  int purge(const std::function<bool(const UndoRecord &)> &is_obsolete,
+            const std::function<void(const UndoRecord &)> &on_purge = nullptr);
+
+  /**
+   * @brief 取出 undo 以及更早的各个版本的数据，从新到旧
+   */
+  static void collect_versions(const UndoRecord *undo, std::vector<const char *> &versions);
+
+private:
+  struct VersionKey
+  {
+    Table  *table;
+    RID     rid;
+    bool operator==(const VersionKey &other) const { return table == other.table && rid == other.rid; }
+  };
+  struct VersionKeyHasher
+  {
+    size_t operator()(const VersionKey &key) const
+    {
+      return std::hash<const void *>()(key.table) ^ ((static_cast<size_t>(key.rid.page_num) << 32) | key.rid.slot_num);
+    }
+  };
+  struct PageKey
+  {
+    Table  *table;
+    PageNum page_num;
+    bool operator==(const PageKey &other) const { return table == other.table && page_num == other.page_num; }
+  };
+  struct PageKeyHasher
+  {
+    size_t operator()(const PageKey &key) const
+    {
+      return std::hash<const void *>()(key.table) ^ static_cast<size_t>(key.page_num);
+    }
+  };
+
+  void remove_version(const VersionKey &key);
+  void purge_locked(const std::function<bool(const UndoRecord &)> &is_obsolete, std::vector<UndoRecord *> &obsolete);
+  static int free_versions(UndoRecord *undo);
+
+private:
+  std::mutex lock_;
+  std::unordered_map<VersionKey, UndoRecord *, VersionKeyHasher> versions_;       ///< 每条记录最新的旧版本
+  std::unordered_map<PageKey, int, PageKeyHasher>                page_versions_;  ///< 每个页面上有几条记录存在旧版本
+  std::vector<UndoRecord *>                                      removed_;        ///< 回滚时去掉的旧版本
+};
@@ -56,16 +56,41 @@ RC VacuousTrx::insert_record(Table *table, Record &record)
   return table->insert_record(record);
 }
 
+RC VacuousTrx::insert_records(Table *table, std::vector<Record> &records)
+{
+  return table->insert_records(records);
+}
+
 RC VacuousTrx::delete_record(Table *table, Record &record)
 {
   return table->delete_record(record);
 }
 
+RC VacuousTrx::update_record(Table *table, Record &record, const char *new_data)
+{
+  return table->update_record(record, new_data);
+}
+
 RC VacuousTrx::visit_record(Table *table, Record &record, bool readonly)
 {
   return RC::SUCCESS;
 }
 
+RC VacuousTrx::wait_for_lock()
+{
+  return RC::SUCCESS;
+}
+
+bool VacuousTrx::visible_to_all(Table *table, const Record &record)
+{
+  return true;
+}
+
+bool VacuousTrx::has_old_versions(Table *table, PageNum page_num)
+{
+  return false;
+}
+
 RC VacuousTrx::start_if_need()
 {
   return RC::SUCCESS;
@@ -42,8 +42,13 @@ public:
   virtual ~VacuousTrx() = default;
 
   RC insert_record(Table *table, Record &record) override;
+  RC insert_records(Table *table, std::vector<Record> &records) override;
   RC delete_record(Table *table, Record &record) override;
+  RC update_record(Table *table, Record &record, const char *new_data) override;
   RC visit_record(Table *table, Record &record, bool readonly) override;
+  RC wait_for_lock() override;
+  bool visible_to_all(Table *table, const Record &record) override;
+  bool has_old_versions(Table *table, PageNum page_num) override;
   RC start_if_need() override;
   RC commit() override;
   RC rollback() override;
@@ -16,39 +16,61 @@ See the Mulan PSL v2 for more details. */
 #include <errno.h>
 #include <netdb.h>
 #include <netinet/in.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/socket.h>
 #include <sys/time.h>
 #include <sys/types.h>
+#include <sys/un.h>
 #include <unistd.h>
+#include <atomic>
+#include <iostream>
+#include <vector>
 
 #include "common/defs.h"
-#include "common/metrics/metrics.h"
-#include "common/metrics/metrics_registry.h"
-#include "common/metrics/console_reporter.h"
 
 #define MAX_MEM_BUFFER_SIZE 8192
 #define PORT_DEFAULT 6789
 
-using namespace common;
+/**
+ * 压测服务端网络层的吞吐
+ * 启动多个连接，每个连接循环发送同一个SQL请求，统计每秒完成的请求数(QPS)。
+ * 服务端的事件循环线程数由配置文件中 [NET] REACTOR_NUM 指定，分别使用不同的 REACTOR_NUM
+ * 启动observer，用相同的参数运行这个程序，就可以对比QPS随Reactor个数的变化，比如：
+ *   client_performance_test -s /tmp/miniob.sock -c 64 -d 10 -r 4
+ * -r 只是用来在输出中标识服务端的Reactor个数。
+ */
 
 char *server_host = (char *)"localhost";
 int server_port = PORT_DEFAULT;
+const char *unix_socket_path = nullptr;
+const char *sql = "select count(*) from test";
 
-void *test_server(void *param)
+std::atomic<bool> running{true};
+std::atomic<int64_t> request_count{0};
+
+int connect_server()
 {
-  Meter *tps_meter = (Meter *)param;
+  int sockfd = -1;
+  if (unix_socket_path != nullptr) {
+    if ((sockfd = socket(PF_UNIX, SOCK_STREAM, 0)) == -1) {
+      perror("socket error \n");
+      exit(1);
+    }
 
-  std::cout << "Begin to connect server. " << std::endl;
-  int sockfd, sendbytes;
-  // char send[MAXLINE];
+    struct sockaddr_un sockaddr;
+    memset(&sockaddr, 0, sizeof(sockaddr));
+    sockaddr.sun_family = PF_UNIX;
+    snprintf(sockaddr.sun_path, sizeof(sockaddr.sun_path), "%s", unix_socket_path);
+    if (connect(sockfd, (struct sockaddr *)&sockaddr, sizeof(sockaddr)) == -1) {
+      perror("Failed to connect \n");
+      exit(1);
+    }
+    return sockfd;
+  }
 
-  char send_buf[MAX_MEM_BUFFER_SIZE] = {0};
-  char recv_buf[MAX_MEM_BUFFER_SIZE] = {0};
-  snprintf(send_buf, sizeof(send_buf), "%s", "select count(*) from test");
-  // char buf[MAXDATASIZE];
   struct hostent *host;
   struct sockaddr_in serv_addr;
 
@@ -70,26 +92,39 @@ void *test_server(void *param)
     perror("Failed to connect \n");
     exit(1);
   }
+  return sockfd;
+}
+
+void *test_server(void *param)
+{
+  int sockfd = connect_server();
+  char recv_buf[MAX_MEM_BUFFER_SIZE] = {0};
+  const size_t send_len = strlen(sql) + 1;
 
-  while (true) {
-    if ((sendbytes = send(sockfd, send_buf, strlen(send_buf) + 1, 0)) == -1) {
+  while (running) {
+    if (send(sockfd, sql, send_len, 0) == -1) {
       perror("send error \n");
       exit(1);
     }
 
-    memset(recv_buf, 0, sizeof(recv_buf));
-
-    int len = recv(sockfd, recv_buf, sizeof(recv_buf), 0);
-    if (len < 0) {
-      printf("connection exception\n");
-      break;
-    }
-    if (len == 0) {
-      printf("Connection has been closed\n");
-      break;
+    // 普通文本协议的结果以'\0'结尾
+    bool finished = false;
+    while (!finished) {
+      int len = recv(sockfd, recv_buf, sizeof(recv_buf), 0);
+      if (len < 0) {
+        printf("connection exception\n");
+        close(sockfd);
+        return NULL;
+      }
+      if (len == 0) {
+        printf("Connection has been closed\n");
+        close(sockfd);
+        return NULL;
+      }
+      finished = (recv_buf[len - 1] == '\0');
     }
 
-    tps_meter->inc();
+    request_count++;
   }
   close(sockfd);
   return NULL;
@@ -97,9 +132,13 @@ void *test_server(void *param)
 
 int main(int argc, char *argv[])
 {
+  int connection_num = 8;
+  int duration = 10;
+  int reactor_num = 0;
+
   int opt;
   extern char *optarg;
-  while ((opt = getopt(argc, argv, "h:p:")) > 0) {
+  while ((opt = getopt(argc, argv, "h:p:s:c:d:r:q:")) > 0) {
     switch (opt) {
       case 'p':
         server_port = atoi(optarg);
@@ -107,26 +146,44 @@ int main(int argc, char *argv[])
       case 'h':
         server_host = optarg;
         break;
+      case 's':
+        unix_socket_path = optarg;
+        break;
+      case 'c':
+        connection_num = atoi(optarg);
+        break;
+      case 'd':
+        duration = atoi(optarg);
+        break;
+      case 'r':
+        reactor_num = atoi(optarg);
+        break;
+      case 'q':
+        sql = optarg;
+        break;
     }
   }
 
-  MetricsRegistry &metric_registry = get_metrics_registry();
-  ConsoleReporter *console_reporter = get_console_reporter();
-  metric_registry.add_reporter(console_reporter);
-
-  Meter *tps_meter = new Meter();
-
-  metric_registry.register_metric("client.sendtps", tps_meter);
+  std::cout << "Begin to connect server. connections=" << connection_num << std::endl;
+  std::vector<pthread_t> threads(connection_num);
+  for (int i = 0; i < connection_num; i++) {
+    pthread_create(&threads[i], NULL, test_server, nullptr);
+  }
 
-  for (int i = 0; i < 8; i++) {
-    pthread_t pid;
-    pthread_create(&pid, NULL, test_server, tps_meter);
+  int64_t last_count = 0;
+  for (int i = 0; i < duration; i++) {
+    sleep(1);
+    int64_t count = request_count.load();
+    printf("second %d: qps=%ld\n", i + 1, count - last_count);
+    last_count = count;
   }
 
-  while (1) {
-    sleep(60);
-    metric_registry.snapshot();
-    metric_registry.report();
+  running = false;
+  for (pthread_t &thread : threads) {
+    pthread_join(thread, nullptr);
   }
+
+  printf("reactors=%d connections=%d duration=%ds requests=%ld qps=%.1f\n",
+         reactor_num, connection_num, duration, request_count.load(), (double)request_count.load() / duration);
   return 0;
 }
@@ -0,0 +1,141 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// 活跃事务表(ActiveTrxRegistry)和快照(ReadView)的测试
+//
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "storage/trx/active_trx_registry.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+static Trx *fake_trx(intptr_t i)
+{
+  return reinterpret_cast<Trx *>((i + 1) * 16);  // 只作为指针比较
+}
+
+TEST(active_trx_registry, attach_detach)
+{
+  ActiveTrxRegistry registry;
+
+  const int count = 200;  // 超过一个块的槽位数
+  vector<ActiveTrxRegistry::Slot *> slots;
+  for (int i = 0; i < count; i++) {
+    ActiveTrxRegistry::Slot *slot = registry.attach(fake_trx(i));
+    ASSERT_NE(nullptr, slot);
+    ASSERT_EQ(i + 1, registry.start(slot));
+    slots.push_back(slot);
+  }
+
+  vector<Trx *> trxes;
+  registry.all_trxes(trxes);
+  ASSERT_EQ(count, static_cast<int>(trxes.size()));
+  ASSERT_EQ(fake_trx(150), registry.find_trx(151));
+
+  registry.finish(slots[150]);
+  registry.detach(slots[150]);
+  ASSERT_EQ(nullptr, registry.find_trx(151));
+
+  // 释放的槽位会被重新使用
+  ASSERT_EQ(slots[150], registry.attach(fake_trx(1000)));
+}
+
+TEST(active_trx_registry, read_view)
+{
+  ActiveTrxRegistry registry;
+  ActiveTrxRegistry::Slot *t1 = registry.attach(fake_trx(1));
+  ActiveTrxRegistry::Slot *t2 = registry.attach(fake_trx(2));
+  ActiveTrxRegistry::Slot *t3 = registry.attach(fake_trx(3));
+
+  const int32_t id1 = registry.start(t1);
+  const int32_t id2 = registry.start(t2);
+  ASSERT_EQ(id1, registry.oldest_active_trx_id());
+
+  // t1 已经提交
+  const int32_t commit1 = registry.begin_commit(t1);
+  registry.finish(t1);
+  ASSERT_EQ(id2, registry.oldest_active_trx_id());
+
+  // t2 拿到了提交事务号，还没有结束
+  const int32_t commit2 = registry.begin_commit(t2);
+
+  const int32_t id3 = registry.start(t3);
+  ReadView view;
+  registry.create_read_view(id3, view);
+  ASSERT_EQ(id3, view.high_xid());
+  ASSERT_EQ(id2, view.low_xid());
+  ASSERT_TRUE(view.visible(commit1));
+  ASSERT_FALSE(view.visible(commit2));
+
+  // t2 结束之后，之前创建的快照仍然看不到它
+  registry.finish(t2);
+  ASSERT_FALSE(view.visible(commit2));
+
+  // 快照创建之后提交的事务不可见
+  ActiveTrxRegistry::Slot *t4 = registry.attach(fake_trx(4));
+  registry.start(t4);
+  const int32_t commit4 = registry.begin_commit(t4);
+  registry.finish(t4);
+  ASSERT_FALSE(view.visible(commit4));
+
+  ReadView view2;
+  ActiveTrxRegistry::Slot *t5 = registry.attach(fake_trx(5));
+  registry.create_read_view(registry.start(t5), view2);
+  ASSERT_EQ(id3, view2.low_xid());
+  ASSERT_TRUE(view2.visible(commit2));
+  ASSERT_TRUE(view2.visible(commit4));
+}
+
+TEST(active_trx_registry, concurrency)
+{
+  ActiveTrxRegistry registry;
+
+  const int thread_num = 4;
+  const int loops      = 10000;
+  atomic<bool> failed{false};
+  vector<thread> threads;
+  for (int t = 0; t < thread_num; t++) {
+    threads.emplace_back([&registry, &failed, t]() {
+      ActiveTrxRegistry::Slot *slot = registry.attach(fake_trx(t));
+      ReadView view;
+      for (int i = 0; i < loops; i++) {
+        const int32_t trx_id = registry.start(slot);
+        registry.create_read_view(trx_id, view);
+        if (view.low_xid() > trx_id || registry.oldest_active_trx_id() > trx_id) {
+          failed = true;
+        }
+        const int32_t commit_xid = registry.begin_commit(slot);
+        if (commit_xid <= trx_id || view.visible(commit_xid)) {
+          failed = true;
+        }
+        registry.finish(slot);
+      }
+      registry.detach(slot);
+    });
+  }
+  for (thread &t : threads) {
+    t.join();
+  }
+
+  ASSERT_FALSE(failed.load());
+  ASSERT_EQ(thread_num * loops * 2, registry.current_xid());
+  ASSERT_EQ(registry.current_xid() + 1, registry.oldest_active_trx_id());
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,100 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "common/mm/arena.h"
+
+using namespace common;
+
+TEST(test_arena, alloc_and_align)
+{
+  Arena arena;
+  char *c = static_cast<char *>(arena.alloc(1, 1));
+  int64_t *i = static_cast<int64_t *>(arena.alloc(sizeof(int64_t), alignof(int64_t)));
+  void *page = arena.alloc(100, 256);
+  ASSERT_EQ(0, reinterpret_cast<uintptr_t>(i) % alignof(int64_t));
+  ASSERT_EQ(0, reinterpret_cast<uintptr_t>(page) % 256);
+  ASSERT_LT(static_cast<void *>(c), static_cast<void *>(i));
+
+  char *s = arena.dup("hello world", 5);
+  ASSERT_STREQ("hello", s);
+}
+
+TEST(test_arena, grow_and_reset)
+{
+  Arena arena;
+
+  // 超过自带内存和普通内存块大小的申请
+  std::vector<char *> ptrs;
+  for (int i = 0; i < 100; i++) {
+    char *ptr = static_cast<char *>(arena.alloc(1000, 1));
+    memset(ptr, i, 1000);
+    ptrs.push_back(ptr);
+  }
+  char *big = static_cast<char *>(arena.alloc(Arena::MAX_BLOCK_SIZE * 2, 1));
+  memset(big, 0xff, Arena::MAX_BLOCK_SIZE * 2);
+
+  for (int i = 0; i < 100; i++) {
+    ASSERT_EQ(static_cast<char>(i), ptrs[i][0]);
+    ASSERT_EQ(static_cast<char>(i), ptrs[i][999]);
+  }
+  ASSERT_GE(arena.used(), 100 * 1000 + Arena::MAX_BLOCK_SIZE * 2);
+
+  arena.reset();
+  ASSERT_EQ(0, arena.used());
+  arena.alloc(16, 1);
+  ASSERT_EQ(16, arena.used());
+}
+
+struct Tracked
+{
+  Tracked(std::vector<int> &destroyed, int id) : destroyed(destroyed), id(id) {}
+  ~Tracked() { destroyed.push_back(id); }
+
+  std::vector<int> &destroyed;
+  int               id;
+  std::string       name = std::string(100, 'x');  // 析构时需要释放堆上的内存
+};
+
+TEST(test_arena, create_and_destroy)
+{
+  std::vector<int> destroyed;
+  {
+    Arena arena;
+    Tracked *first = arena.create<Tracked>(destroyed, 1);
+    int *number = arena.create<int>(10);
+    arena.create<Tracked>(destroyed, 2);
+    ASSERT_EQ(1, first->id);
+    ASSERT_EQ(10, *number);
+    ASSERT_EQ(0, reinterpret_cast<uintptr_t>(first) % alignof(Tracked));
+
+    // reset 时按照构造的逆序析构，之后 arena 还可以继续使用
+    arena.reset();
+    ASSERT_EQ((std::vector<int>{2, 1}), destroyed);
+
+    for (int i = 3; i < 100; i++) {
+      arena.create<Tracked>(destroyed, i);
+    }
+  }
+  ASSERT_EQ(99, static_cast<int>(destroyed.size()));
+  ASSERT_EQ(99, destroyed[2]);
+  ASSERT_EQ(3, destroyed.back());
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -12,6 +12,11 @@ See the Mulan PSL v2 for more details. */
 // Created by wangyunlai.wyl on 2021
 //
 
+#include <fcntl.h>
+#include <stddef.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include "storage/buffer/disk_buffer_pool.h"
 #include "gtest/gtest.h"
 
@@ -116,7 +121,7 @@ void test_alloc(BPFrameManager &frame_manager)
 TEST(test_frame_manager, test_frame_manager_simple_lru)
 {
   BPFrameManager frame_manager("Test");
-  frame_manager.init(2);
+  frame_manager.init(256);
 
   test_get(frame_manager);
 
@@ -125,6 +130,217 @@ TEST(test_frame_manager, test_frame_manager_simple_lru)
   frame_manager.cleanup();
 }
 
+TEST(test_disk_buffer_pool, test_read_ahead)
+{
+  const char *file_name = "bp_manager_read_ahead.bp";
+  ::remove(file_name);
+
+  const int page_count = 300;
+  {
+    BufferPoolManager bpm;
+    DiskBufferPool *bp = nullptr;
+    ASSERT_EQ(RC::SUCCESS, bpm.create_file(file_name));
+    ASSERT_EQ(RC::SUCCESS, bpm.open_file(file_name, bp));
+    for (int i = 1; i < page_count; i++) {
+      Frame *frame = nullptr;
+      ASSERT_EQ(RC::SUCCESS, bp->allocate_page(&frame));
+      ASSERT_EQ(i, frame->page_num());
+      memcpy(frame->data(), &i, sizeof(i));
+      frame->mark_dirty();
+      frame->unpin();
+    }
+    ASSERT_EQ(RC::SUCCESS, bpm.close_file(file_name));
+  }
+
+  BufferPoolManager bpm;
+  DiskBufferPool *bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(file_name, bp));
+  const int initial_window = bp->read_ahead_window();
+
+  // 顺序访问时预读后面的页面，预读的页面都被访问到了，窗口会变大
+  for (int i = 1; i < page_count; i++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, bp->get_this_page(i, &frame));
+    ASSERT_EQ(i, frame->page_num());
+    ASSERT_EQ(i, *(const int *)frame->data());
+    frame->unpin();
+  }
+  ASSERT_GT(bp->read_ahead_window(), initial_window);
+
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(file_name));
+
+  // 只取内存中的页面时不会从磁盘加载
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(file_name, bp));
+  ASSERT_EQ(nullptr, bp->get_cached_page(10));
+  Frame *cached_frame = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bp->get_this_page(10, &cached_frame));
+  cached_frame->unpin();
+  ASSERT_EQ(cached_frame, bp->get_cached_page(10));
+  cached_frame->unpin();
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(file_name));
+
+  // 扫描器明确要求预读的页面，倒序访问也能读到
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(file_name, bp));
+  ASSERT_EQ(RC::SUCCESS, bp->read_ahead(100, 50));
+  for (int i = 150; i > 0; i--) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, bp->get_this_page(i, &frame));
+    ASSERT_EQ(i, *(const int *)frame->data());
+    frame->unpin();
+  }
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(file_name));
+}
+
+TEST(test_disk_buffer_pool, test_allocate_pages)
+{
+  const char *file_name = "bp_manager_allocate.bp";
+  ::remove(file_name);
+
+  BufferPoolManager bpm;
+  DiskBufferPool *bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(file_name));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(file_name, bp));
+
+  // 按照区扩展文件，分配的页面是连续的
+  for (int i = 1; i < 100; i++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, bp->allocate_page(&frame));
+    ASSERT_EQ(i, frame->page_num());
+    frame->unpin();
+  }
+  ASSERT_EQ(100, bp->allocated_pages());
+  ASSERT_GE(bp->page_count(), 100);
+
+  // 释放的页面优先重新分配
+  for (int i = 10; i < 20; i++) {
+    ASSERT_EQ(RC::SUCCESS, bp->purge_page(i));
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, bp->get_this_page(i, &frame));
+    ASSERT_EQ(RC::SUCCESS, bp->dispose_page(i));
+  }
+  ASSERT_EQ(90, bp->allocated_pages());
+  for (int i = 10; i < 20; i++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, bp->allocate_page(&frame));
+    ASSERT_EQ(i, frame->page_num());
+    frame->unpin();
+  }
+  ASSERT_EQ(100, bp->allocated_pages());
+
+  // 回放日志时用到后面组的页面，文件扩展到后面的组，位图页不会被遍历到
+  const PageNum group_page = BPFileHeader::HEADER_GROUP_PAGES + 10;
+  ASSERT_EQ(RC::SUCCESS, bp->recover_page(group_page));
+  ASSERT_EQ(102, bp->allocated_pages());
+  ASSERT_EQ(group_page + 1, bp->page_count());
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(file_name));
+
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(file_name, bp));
+  ASSERT_EQ(102, bp->allocated_pages());
+  BufferPoolIterator iterator;
+  iterator.init(*bp);
+  int count = 0;
+  PageNum last_page = BP_INVALID_PAGE_NUM;
+  while (iterator.has_next()) {
+    last_page = iterator.next();
+    count++;
+  }
+  ASSERT_EQ(100, count);
+  ASSERT_EQ(group_page, last_page);
+
+  // 第0个组还有空闲页面
+  Frame *frame = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bp->allocate_page(&frame));
+  ASSERT_EQ(100, frame->page_num());
+  frame->unpin();
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(file_name));
+  ::remove(file_name);
+}
+
+TEST(test_disk_buffer_pool, test_file_version)
+{
+  const char *file_name = "bp_manager_version.bp";
+  ::remove(file_name);
+
+  BufferPoolManager bpm;
+  DiskBufferPool *bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(file_name));
+
+  // 模拟其它版本创建的文件
+  const off_t version_offset = offsetof(Page, data) + offsetof(BPFileHeader, version);
+  int fd = ::open(file_name, O_RDWR);
+  ASSERT_GE(fd, 0);
+  const int32_t old_version = BPFileHeader::VERSION - 1;
+  ASSERT_EQ((ssize_t)sizeof(old_version), ::pwrite(fd, &old_version, sizeof(old_version), version_offset));
+  ::close(fd);
+  ASSERT_EQ(RC::FILE_VERSION_MISMATCH, bpm.open_file(file_name, bp));
+
+  fd = ::open(file_name, O_RDWR);
+  ASSERT_GE(fd, 0);
+  const int32_t version = BPFileHeader::VERSION;
+  ASSERT_EQ((ssize_t)sizeof(version), ::pwrite(fd, &version, sizeof(version), version_offset));
+  ::close(fd);
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(file_name, bp));
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(file_name));
+  ::remove(file_name);
+}
+
+TEST(test_disk_buffer_pool, test_page_size)
+{
+  const char *file_name = "bp_manager_page_size.bp";
+  ::remove(file_name);
+
+  BufferPoolManager bpm;
+  DiskBufferPool *bp = nullptr;
+  ASSERT_EQ(RC::INVALID_ARGUMENT, bpm.create_file(file_name, BP_PAGE_SIZE + 1024));
+  ASSERT_EQ(RC::INVALID_ARGUMENT, bpm.create_file(file_name, BP_MAX_PAGE_SIZE * 2));
+
+  // 同时打开不同页面大小的文件
+  const char *default_file_name = "bp_manager_default_page_size.bp";
+  ::remove(default_file_name);
+  DiskBufferPool *default_bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(default_file_name));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(default_file_name, default_bp));
+  ASSERT_EQ(BP_PAGE_SIZE, default_bp->page_size());
+
+  const int page_size  = 4 * BP_PAGE_SIZE;
+  const int page_count = 50;
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(file_name, page_size));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(file_name, bp));
+  ASSERT_EQ(page_size, bp->page_size());
+  ASSERT_EQ(bp_page_data_size(page_size), bp->page_data_size());
+  for (int i = 1; i < page_count; i++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, bp->allocate_page(&frame));
+    ASSERT_EQ(bp->page_data_size(), frame->data_size());
+    // 页面的开头和结尾都写入数据，检查整个页面都写到了文件中
+    memset(frame->data(), i, frame->data_size());
+    frame->mark_dirty();
+    frame->unpin();
+  }
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(file_name));
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(default_file_name));
+
+  struct stat st;
+  ASSERT_EQ(0, ::stat(file_name, &st));
+  ASSERT_EQ(0, st.st_size % page_size);
+
+  // 页面大小从文件头中读取
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(file_name, bp));
+  ASSERT_EQ(page_size, bp->page_size());
+  ASSERT_EQ(page_count, bp->allocated_pages());
+  for (int i = 1; i < page_count; i++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, bp->get_this_page(i, &frame));
+    ASSERT_EQ(i, frame->page_num());
+    ASSERT_EQ((char)i, frame->data()[0]);
+    ASSERT_EQ((char)i, frame->data()[frame->data_size() - 1]);
+    frame->unpin();
+  }
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(file_name));
+  ::remove(file_name);
+  ::remove(default_file_name);
+}
+
 int main(int argc, char **argv)
 {
 
@@ -0,0 +1,358 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// B+树键值编码与比较的测试
+//
+
+#include <fcntl.h>
+#include <stddef.h>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+#include <list>
+#include <random>
+#include <vector>
+
+#include "storage/index/bplus_tree.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "gtest/gtest.h"
+
+using namespace common;
+
+BufferPoolManager bpm;
+
+static std::vector<char> normalize(const KeyNormalizer &normalizer, const void *user_key, int len)
+{
+  std::vector<char> key(len);
+  normalizer.normalize((const char *)user_key, key.data());
+  return key;
+}
+
+TEST(test_bplus_tree_key, test_normalize_ints)
+{
+  std::vector<AttrType> types{INTS};
+  std::vector<int32_t>  lens{4};
+  KeyNormalizer normalizer;
+  normalizer.init(types, lens, true);
+
+  std::vector<int> values{INT32_MIN, -100, -1, 0, 1, 7, 100, INT32_MAX};
+  for (size_t i = 1; i < values.size(); i++) {
+    std::vector<char> prev = normalize(normalizer, &values[i - 1], 4);
+    std::vector<char> curr = normalize(normalizer, &values[i], 4);
+    ASSERT_LT(memcmp(prev.data(), curr.data(), 4), 0);
+
+    int restored = 0;
+    normalizer.denormalize(curr.data(), (char *)&restored);
+    ASSERT_EQ(values[i], restored);
+  }
+}
+
+TEST(test_bplus_tree_key, test_normalize_floats)
+{
+  std::vector<AttrType> types{FLOATS};
+  std::vector<int32_t>  lens{4};
+  KeyNormalizer normalizer;
+  normalizer.init(types, lens, true);
+
+  std::vector<float> values{-1e30f, -2.5f, -1.0f, -0.0001f, 0.0f, 0.0001f, 1.0f, 2.5f, 1e30f};
+  for (size_t i = 1; i < values.size(); i++) {
+    std::vector<char> prev = normalize(normalizer, &values[i - 1], 4);
+    std::vector<char> curr = normalize(normalizer, &values[i], 4);
+    ASSERT_LT(memcmp(prev.data(), curr.data(), 4), 0);
+
+    float restored = 0;
+    normalizer.denormalize(curr.data(), (char *)&restored);
+    ASSERT_EQ(values[i], restored);
+  }
+
+  float negative_zero = -0.0f;
+  float zero = 0.0f;
+  ASSERT_EQ(0, memcmp(normalize(normalizer, &negative_zero, 4).data(), normalize(normalizer, &zero, 4).data(), 4));
+}
+
+TEST(test_bplus_tree_key, test_normalize_chars)
+{
+  std::vector<AttrType> types{CHARS, INTS};
+  std::vector<int32_t>  lens{8, 4};
+  KeyNormalizer normalizer;
+  normalizer.init(types, lens, true);
+
+  // 字符串结束符之后的内容不应该影响比较结果
+  char key1[12];
+  char key2[12];
+  memset(key1, 'x', sizeof(key1));
+  memset(key2, 'y', sizeof(key2));
+  strcpy(key1, "abc");
+  strcpy(key2, "abc");
+  int v = 5;
+  memcpy(key1 + 8, &v, 4);
+  memcpy(key2 + 8, &v, 4);
+  ASSERT_EQ(0, memcmp(normalize(normalizer, key1, 12).data(), normalize(normalizer, key2, 12).data(), 12));
+
+  strcpy(key2, "abd");
+  ASSERT_LT(memcmp(normalize(normalizer, key1, 12).data(), normalize(normalizer, key2, 12).data(), 12), 0);
+
+  strcpy(key2, "abc");
+  v = -5;
+  memcpy(key2 + 8, &v, 4);
+  ASSERT_GT(memcmp(normalize(normalizer, key1, 12).data(), normalize(normalizer, key2, 12).data(), 12), 0);
+}
+
+TEST(test_bplus_tree_key, test_key_comparator_kind)
+{
+  KeyComparator comparator;
+  std::vector<AttrType> int_types{INTS};
+  comparator.init(int_types, {4});
+  ASSERT_EQ(KeyComparator::Kind::INT, comparator.kind());
+
+  char key1[4 + sizeof(RID)];
+  char key2[4 + sizeof(RID)];
+  int v1 = -3;
+  int v2 = 2;
+  RID rid(1, 1);
+  memcpy(key1, &v1, 4);
+  memcpy(key2, &v2, 4);
+  memcpy(key1 + 4, &rid, sizeof(rid));
+  memcpy(key2 + 4, &rid, sizeof(rid));
+  ASSERT_LT(comparator(key1, key2), 0);
+  ASSERT_GT(comparator(key2, key1), 0);
+  ASSERT_EQ(0, comparator(key1, key1));
+
+  std::vector<AttrType> date_types{DATES};
+  comparator.init(date_types, {4});
+  ASSERT_EQ(KeyComparator::Kind::DATE, comparator.kind());
+
+  std::vector<AttrType> multi_types{INTS, INTS};
+  comparator.init(multi_types, {4, 4});
+  ASSERT_EQ(KeyComparator::Kind::NORMALIZED, comparator.kind());
+}
+
+TEST(test_bplus_tree_key, test_composite_index_scan)
+{
+  const char *index_name = "bplus_tree_key_test.btree";
+  ::unlink(index_name);
+
+  std::vector<AttrType> types{FLOATS, CHARS};
+  std::vector<int32_t>  lens{4, 4};
+
+  BplusTreeHandler handler;
+  ASSERT_EQ(RC::SUCCESS, handler.create(index_name, types, lens, 4, 4));
+
+  const int count = 200;
+  for (int i = 0; i < count; i++) {
+    char user_key[8];
+    float f = static_cast<float>(i - count / 2) / 2;
+    memcpy(user_key, &f, 4);
+    memset(user_key + 4, 'z', 4);  // 字符串之后的垃圾数据
+    snprintf(user_key + 4, 4, "%c", 'a' + i % 3);
+    RID rid(i + 1, 0);
+    ASSERT_EQ(RC::SUCCESS, handler.insert_entry(user_key, &rid));
+  }
+  ASSERT_TRUE(handler.validate_tree());
+
+  // 扫描 [(-10.0, "a"), (10.0, "c")]
+  char left_key[8];
+  char right_key[8];
+  float left = -10.0f;
+  float right = 10.0f;
+  memcpy(left_key, &left, 4);
+  memcpy(right_key, &right, 4);
+  memset(left_key + 4, 0, 4);
+  memset(right_key + 4, 0, 4);
+  left_key[4] = 'a';
+  right_key[4] = 'c';
+
+  BplusTreeScanner scanner(handler);
+  ASSERT_EQ(RC::SUCCESS, scanner.open(left_key, 8, true, right_key, 8, true));
+  RID rid;
+  char user_key[8];
+  std::vector<int> found;
+  while (scanner.next_entry(rid, user_key) == RC::SUCCESS) {
+    const int i = rid.page_num - 1;
+    found.push_back(i);
+
+    // 返回的键值是原始的字段值，而不是编码后的值
+    float f = 0;
+    memcpy(&f, user_key, 4);
+    ASSERT_EQ(static_cast<float>(i - count / 2) / 2, f);
+    ASSERT_EQ('a' + i % 3, user_key[4]);
+    ASSERT_EQ(0, user_key[5]);
+  }
+  scanner.close();
+
+  std::vector<int> expected;
+  for (int i = 0; i < count; i++) {
+    float f = static_cast<float>(i - count / 2) / 2;
+    if (f >= left && f <= right) {
+      expected.push_back(i);
+    }
+  }
+  ASSERT_EQ(expected, found);
+
+  handler.close();
+  ::unlink(index_name);
+}
+
+TEST(test_bplus_tree_key, test_composite_delete)
+{
+  const char *index_name = "bplus_tree_key_test.btree";
+  ::unlink(index_name);
+
+  // 多字段的索引使用编码后的键值，删除时也要按照同样的方式编码
+  std::vector<AttrType> types{INTS, INTS};
+  std::vector<int32_t>  lens{4, 4};
+
+  BplusTreeHandler handler;
+  ASSERT_EQ(RC::SUCCESS, handler.create(index_name, types, lens, 4, 4));
+
+  const int count = 300;
+  auto make_user_key = [](int i, char *user_key) {
+    int a = i / 10 - count / 20;
+    int b = i % 10 - 5;
+    memcpy(user_key, &a, 4);
+    memcpy(user_key + 4, &b, 4);
+  };
+
+  char user_key[8];
+  for (int i = 0; i < count; i++) {
+    make_user_key(i, user_key);
+    RID rid(i + 1, 0);
+    ASSERT_EQ(RC::SUCCESS, handler.insert_entry(user_key, &rid));
+  }
+
+  for (int i = 0; i < count; i += 2) {
+    make_user_key(i, user_key);
+    RID rid(i + 1, 0);
+    ASSERT_EQ(RC::SUCCESS, handler.delete_entry(user_key, &rid));
+  }
+  ASSERT_TRUE(handler.validate_tree());
+
+  for (int i = 0; i < count; i++) {
+    make_user_key(i, user_key);
+    std::list<RID> rids;
+    ASSERT_EQ(RC::SUCCESS, handler.get_entry(user_key, 8, rids));
+    if (i % 2 == 0) {
+      ASSERT_TRUE(rids.empty());
+    } else {
+      ASSERT_EQ(1, static_cast<int>(rids.size()));
+      ASSERT_EQ(i + 1, rids.front().page_num);
+    }
+  }
+
+  make_user_key(0, user_key);
+  RID rid(1, 0);
+  ASSERT_EQ(RC::RECORD_NOT_EXIST, handler.delete_entry(user_key, &rid));
+
+  handler.close();
+  ::unlink(index_name);
+}
+
+TEST(test_bplus_tree_key, test_insert_entries)
+{
+  const char *index_name = "bplus_tree_key_test.btree";
+  ::unlink(index_name);
+
+  std::vector<AttrType> types{INTS};
+  std::vector<int32_t>  lens{4};
+
+  BplusTreeHandler handler;
+  ASSERT_EQ(RC::SUCCESS, handler.create(index_name, types, lens, 4, 4));
+
+  const int batch_num = 10;
+  const int batch_size = 50;
+  std::vector<int> all_keys(batch_num * batch_size);
+  for (size_t i = 0; i < all_keys.size(); i++) {
+    all_keys[i] = static_cast<int>(i);
+  }
+  std::shuffle(all_keys.begin(), all_keys.end(), std::mt19937(0));
+
+  // 每批键值都是乱序的，并且和其它批次的键值交错
+  for (int batch = 0; batch < batch_num; batch++) {
+    std::vector<const char *> keys;
+    std::vector<RID>          rids;
+    for (int i = batch * batch_size; i < (batch + 1) * batch_size; i++) {
+      keys.push_back(reinterpret_cast<const char *>(&all_keys[i]));
+      rids.push_back(RID(all_keys[i] + 1, 0));
+    }
+    ASSERT_EQ(RC::SUCCESS, handler.insert_entries(keys, rids));
+    ASSERT_TRUE(handler.validate_tree());
+  }
+
+  for (int key : all_keys) {
+    std::list<RID> rids;
+    ASSERT_EQ(RC::SUCCESS, handler.get_entry(reinterpret_cast<const char *>(&key), 4, rids));
+    ASSERT_EQ(1, static_cast<int>(rids.size()));
+    ASSERT_EQ(key + 1, rids.front().page_num);
+  }
+
+  // 键值和RID都相同的条目已经存在
+  std::vector<const char *> keys{reinterpret_cast<const char *>(&all_keys[0])};
+  std::vector<RID>          rids{RID(all_keys[0] + 1, 0)};
+  ASSERT_EQ(RC::RECORD_DUPLICATE_KEY, handler.insert_entries(keys, rids));
+
+  handler.close();
+  ::unlink(index_name);
+}
+
+TEST(test_bplus_tree_key, test_file_version)
+{
+  const char *index_name = "bplus_tree_key_version.btree";
+  ::unlink(index_name);
+
+  std::vector<AttrType> types{INTS};
+  std::vector<int32_t>  lens{4};
+  {
+    BplusTreeHandler handler;
+    ASSERT_EQ(RC::SUCCESS, handler.create(index_name, types, lens, 4, 4));
+    handler.close();
+  }
+
+  // 模拟其它版本创建的索引文件，键值的编码可能不同，不能打开
+  // 第0个页面是 buffer pool 的文件头，索引的文件头在第1个页面
+  const off_t version_offset = 1 * BP_PAGE_SIZE + offsetof(Page, data) + offsetof(IndexFileHeader, version);
+  int fd = ::open(index_name, O_RDWR);
+  ASSERT_GE(fd, 0);
+  int32_t version = 0;
+  ASSERT_EQ((ssize_t)sizeof(version), ::pread(fd, &version, sizeof(version), version_offset));
+  ASSERT_EQ(IndexFileHeader::VERSION, version);
+  version = IndexFileHeader::VERSION - 1;
+  ASSERT_EQ((ssize_t)sizeof(version), ::pwrite(fd, &version, sizeof(version), version_offset));
+  ::close(fd);
+
+  {
+    BplusTreeHandler handler;
+    ASSERT_EQ(RC::FILE_VERSION_MISMATCH, handler.open(index_name));
+  }
+
+  fd = ::open(index_name, O_RDWR);
+  ASSERT_GE(fd, 0);
+  version = IndexFileHeader::VERSION;
+  ASSERT_EQ((ssize_t)sizeof(version), ::pwrite(fd, &version, sizeof(version), version_offset));
+  ::close(fd);
+
+  BplusTreeHandler handler;
+  ASSERT_EQ(RC::SUCCESS, handler.open(index_name));
+  handler.close();
+  ::unlink(index_name);
+}
+
+int main(int argc, char **argv)
+{
+  // 默认的缓冲池管理器只能设置一次，所有用例共用
+  BufferPoolManager::set_instance(&bpm);
+
+  // 分析gtest程序的命令行参数
+  testing::InitGoogleTest(&argc, argv);
+
+  // 调用RUN_ALL_TESTS()运行所有测试用例
+  // main函数返回RUN_ALL_TESTS()的运行结果
+  return RUN_ALL_TESTS();
+}
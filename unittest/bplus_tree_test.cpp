@@ -322,7 +322,9 @@ TEST(test_bplus_tree, test_leaf_index_node_handle)
   index_file_header.key_length = 4 + sizeof(RID);
   index_file_header.attr_type = INTS;
 
+  Page  page;
   Frame frame;
+  frame.set_page(&page);
 
   KeyComparator key_comparator;
   key_comparator.init(INTS, 4);
@@ -379,7 +381,9 @@ TEST(test_bplus_tree, test_internal_index_node_handle)
   index_file_header.key_length = 4 + sizeof(RID);
   index_file_header.attr_type = INTS;
 
+  Page  page;
   Frame frame;
+  frame.set_page(&page);
 
   KeyComparator key_comparator;
   key_comparator.init(INTS, 4);
@@ -13,6 +13,8 @@ See the Mulan PSL v2 for more details. */
 //
 
 #include <string.h>
+#include <thread>
+#include <vector>
 
 #include "common/log/log.h"
 #include "storage/clog/clog.h"
@@ -45,6 +47,62 @@ TEST(test_clog, test_clog)
   */
 }
 
+/**
+ * @brief 多个线程写入日志的同时执行 sync，所有数据都要完整地写入文件
+ */
+TEST(test_clog, concurrent_write_and_sync)
+{
+  const char *clog_file = "./clog";
+  remove(clog_file);
+
+  const int thread_num = 4;
+  const int chunk_num  = 20000;
+  const int chunk_size = 100;
+  {
+    CLogFile log_file;
+    ASSERT_EQ(RC::SUCCESS, log_file.init("."));
+
+    std::vector<std::thread> writers;
+    for (int t = 0; t < thread_num; t++) {
+      writers.emplace_back([&log_file, t]() {
+        char chunk[chunk_size];
+        for (int i = 0; i < chunk_num; i++) {
+          memset(chunk, 'a' + t, sizeof(chunk));
+          memcpy(chunk, &i, sizeof(i));
+          ASSERT_EQ(RC::SUCCESS, log_file.write(chunk, sizeof(chunk)));
+        }
+      });
+    }
+    for (int i = 0; i < 200; i++) {
+      ASSERT_EQ(RC::SUCCESS, log_file.sync());
+    }
+    for (std::thread &writer : writers) {
+      writer.join();
+    }
+    ASSERT_EQ(RC::SUCCESS, log_file.sync());
+  }
+
+  CLogFile log_file;
+  ASSERT_EQ(RC::SUCCESS, log_file.init("."));
+  int next_index[thread_num] = {0};
+  char chunk[chunk_size];
+  while (log_file.read(chunk, sizeof(chunk)) == RC::SUCCESS) {
+    const int t = chunk[chunk_size - 1] - 'a';
+    ASSERT_TRUE(t >= 0 && t < thread_num);
+    int index = -1;
+    memcpy(&index, chunk, sizeof(index));
+    ASSERT_EQ(next_index[t], index);
+    for (int i = sizeof(index); i < chunk_size; i++) {
+      ASSERT_EQ('a' + t, chunk[i]);
+    }
+    next_index[t]++;
+  }
+  ASSERT_TRUE(log_file.eof());
+  for (int t = 0; t < thread_num; t++) {
+    ASSERT_EQ(chunk_num, next_index[t]);
+  }
+}
+
 int main(int argc, char **argv)
 {
   // 分析gtest程序的命令行参数
@@ -0,0 +1,214 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// 页帧内存(FrameArena)的测试
+//
+
+#include <string.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <algorithm>
+#include <set>
+#include <vector>
+
+#include "storage/buffer/frame_arena.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+static const uintptr_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+TEST(frame_arena, init)
+{
+  FrameArena arena;
+  ASSERT_EQ(RC::INVALID_ARGUMENT, arena.init(0));
+  ASSERT_EQ(RC::SUCCESS, arena.init(4));
+  ASSERT_EQ(RC::INTERNAL, arena.init(4));
+  ASSERT_EQ(4, arena.frame_num());
+  ASSERT_EQ(0, arena.used_num());
+
+  arena.cleanup();
+  ASSERT_EQ(0, arena.frame_num());
+  ASSERT_EQ(RC::SUCCESS, arena.init(2));
+  ASSERT_EQ(2, arena.frame_num());
+}
+
+TEST(frame_arena, exhaustion)
+{
+  const int frame_num = 8;
+  FrameArena arena;
+  ASSERT_EQ(RC::SUCCESS, arena.init(frame_num));
+
+  vector<Frame *> frames;
+  set<char *>     pages;
+  for (int i = 0; i < frame_num; i++) {
+    Frame *frame = arena.alloc();
+    ASSERT_NE(nullptr, frame);
+    ASSERT_EQ(0, frame->pin_count());
+    frames.push_back(frame);
+    pages.insert(frame->data());
+  }
+  ASSERT_EQ(frame_num, static_cast<int>(pages.size()));
+  ASSERT_EQ(frame_num, arena.used_num());
+
+  // 页帧用完之后不会再申请内存
+  ASSERT_EQ(nullptr, arena.alloc());
+  ASSERT_EQ(nullptr, arena.alloc());
+
+  // 最近释放的页帧最先被重新分配
+  arena.free(frames[3]);
+  arena.free(frames[5]);
+  ASSERT_EQ(frame_num - 2, arena.used_num());
+  ASSERT_EQ(frames[5], arena.alloc());
+  ASSERT_EQ(frames[3], arena.alloc());
+  ASSERT_EQ(nullptr, arena.alloc());
+
+  for (Frame *frame : frames) {
+    arena.free(frame);
+  }
+  ASSERT_EQ(0, arena.used_num());
+}
+
+TEST(frame_arena, frame_of)
+{
+  const int frame_num = 4;
+  FrameArena arena;
+  ASSERT_EQ(nullptr, arena.frame_of(&arena));
+  ASSERT_EQ(RC::SUCCESS, arena.init(frame_num));
+
+  vector<Frame *> frames;
+  for (int i = 0; i < frame_num; i++) {
+    frames.push_back(arena.alloc());
+  }
+
+  // 页面中的任意地址都能算出所在的页帧
+  for (Frame *frame : frames) {
+    ASSERT_EQ(frame, arena.frame_of(frame->data()));
+    ASSERT_EQ(frame, arena.frame_of(frame->data() + BP_PAGE_DATA_SIZE - 1));
+    ASSERT_EQ(frame, arena.frame_of(&frame->page()));
+  }
+
+  // 页面数组之外的地址
+  char *first = frames[0]->data();
+  char *last  = frames[0]->data();
+  for (Frame *frame : frames) {
+    first = std::min(first, reinterpret_cast<char *>(&frame->page()));
+    last  = std::max(last, reinterpret_cast<char *>(&frame->page()));
+  }
+  ASSERT_EQ(nullptr, arena.frame_of(first - 1));
+  ASSERT_EQ(nullptr, arena.frame_of(last + sizeof(Page)));
+  ASSERT_EQ(nullptr, arena.frame_of(frames[0]));
+
+  for (Frame *frame : frames) {
+    arena.free(frame);
+  }
+}
+
+TEST(frame_arena, page_size)
+{
+  FrameArena arena;
+  ASSERT_EQ(RC::INVALID_ARGUMENT, arena.init(4, false, BP_PAGE_SIZE / 2));
+  ASSERT_EQ(RC::INVALID_ARGUMENT, arena.init(4, false, BP_PAGE_SIZE * 3));
+  ASSERT_EQ(RC::INVALID_ARGUMENT, arena.init(4, false, BP_MAX_PAGE_SIZE * 2));
+
+  const int page_size = BP_MAX_PAGE_SIZE;
+  const int frame_num = 4;
+  ASSERT_EQ(RC::SUCCESS, arena.init(frame_num, false, page_size));
+  ASSERT_EQ(page_size, arena.page_size());
+
+  vector<Frame *> frames;
+  for (int i = 0; i < frame_num; i++) {
+    Frame *frame = arena.alloc();
+    ASSERT_EQ(page_size, frame->page_size());
+    ASSERT_EQ(bp_page_data_size(page_size), frame->data_size());
+    frames.push_back(frame);
+  }
+
+  // 页面按照文件的页面大小排列，页面后半部分的地址也属于这个页帧
+  for (Frame *frame : frames) {
+    ASSERT_EQ(frame, arena.frame_of(frame->data() + BP_PAGE_DATA_SIZE));
+    ASSERT_EQ(frame, arena.frame_of(frame->data() + frame->data_size() - 1));
+    ASSERT_EQ(frame, arena.frame_of(reinterpret_cast<char *>(&frame->page()) + page_size - 1));
+  }
+
+  for (Frame *frame : frames) {
+    arena.free(frame);
+  }
+
+  // 重新初始化后恢复默认的页面大小
+  arena.cleanup();
+  ASSERT_EQ(RC::SUCCESS, arena.init(frame_num));
+  ASSERT_EQ(BP_PAGE_SIZE, arena.page_size());
+}
+
+TEST(frame_arena, huge_page_fallback)
+{
+  // 没有透明大页时 madvise 会失败，页帧依然可以使用，只是 huge_page() 是 false
+  const int frame_num = static_cast<int>(HUGE_PAGE_SIZE / sizeof(Page)) * 2 + 3;
+  FrameArena arena;
+  ASSERT_EQ(RC::SUCCESS, arena.init(frame_num));
+
+  // 无论是否使用大页，页面都按照大页对齐并且连续存放
+  Frame *first = arena.alloc();
+  ASSERT_NE(nullptr, first);
+  ASSERT_EQ(0u, reinterpret_cast<uintptr_t>(&first->page()) % HUGE_PAGE_SIZE);
+
+  vector<Frame *> frames{first};
+  for (int i = 1; i < frame_num; i++) {
+    Frame *frame = arena.alloc();
+    ASSERT_NE(nullptr, frame);
+    ASSERT_EQ(&first->page() + i, &frame->page());
+    frames.push_back(frame);
+  }
+  for (int i = 0; i < frame_num; i++) {
+    memset(frames[i]->data(), i & 0xFF, BP_PAGE_DATA_SIZE);
+  }
+  for (int i = 0; i < frame_num; i++) {
+    ASSERT_EQ(static_cast<char>(i & 0xFF), frames[i]->data()[BP_PAGE_DATA_SIZE - 1]);
+  }
+  for (Frame *frame : frames) {
+    arena.free(frame);
+  }
+}
+
+TEST(frame_arena, lock_memory_fallback)
+{
+  struct rlimit old_limit;
+  ASSERT_EQ(0, getrlimit(RLIMIT_MEMLOCK, &old_limit));
+
+  // 不允许锁住内存时 mlock 会失败，只打印日志，页帧依然可以使用
+  struct rlimit limit = old_limit;
+  limit.rlim_cur      = 0;
+  ASSERT_EQ(0, setrlimit(RLIMIT_MEMLOCK, &limit));
+
+  FrameArena arena;
+  RC rc = arena.init(16, true /*lock_memory*/);
+  const bool memory_locked = arena.memory_locked();
+  ASSERT_EQ(0, setrlimit(RLIMIT_MEMLOCK, &old_limit));
+  ASSERT_EQ(RC::SUCCESS, rc);
+  if (geteuid() != 0) {
+    // root 有 CAP_IPC_LOCK，不受 RLIMIT_MEMLOCK 限制
+    ASSERT_FALSE(memory_locked);
+  }
+
+  Frame *frame = arena.alloc();
+  ASSERT_NE(nullptr, frame);
+  memset(frame->data(), 1, BP_PAGE_DATA_SIZE);
+  arena.free(frame);
+  arena.cleanup();
+  ASSERT_FALSE(arena.memory_locked());
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,355 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// 索引覆盖扫描(index only scan)在多版本下的测试，结果与全表扫描比较
+//
+
+#include <algorithm>
+#include <filesystem>
+
+#include "common/global_context.h"
+#include "common/log/log.h"
+#include "sql/expr/tuple.h"
+#include "sql/operator/index_scan_physical_operator.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/db/db.h"
+#include "storage/default/default_handler.h"
+#include "storage/index/index.h"
+#include "storage/record/record_manager.h"
+#include "storage/table/table.h"
+#include "storage/trx/mvcc_trx.h"
+#include "storage/trx/mvcc_vacuum.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+using namespace common;
+
+static const char *BASE_DIR   = "index_only_scan_test_dir";
+static const char *DB_NAME    = "sys";
+
+static BufferPoolManager bpm;
+
+static int record_id(Table *table, const Record &record)
+{
+  return *reinterpret_cast<const int *>(record.data() + table->table_meta().field("id")->offset());
+}
+
+/**
+ * @brief 使用全表扫描获取对事务可见的、id 在 [low, high] 之间的记录
+ */
+static vector<int> table_scan_ids(Table *table, Trx *trx, int low, int high)
+{
+  RecordFileScanner scanner;
+  EXPECT_EQ(RC::SUCCESS, table->get_record_scanner(scanner, trx, true /*readonly*/));
+  vector<int> ids;
+  Record      record;
+  while (scanner.has_next()) {
+    EXPECT_EQ(RC::SUCCESS, scanner.next(record));
+    const int id = record_id(table, record);
+    if (id >= low && id <= high) {
+      ids.push_back(id);
+    }
+  }
+  scanner.close_scan();
+  sort(ids.begin(), ids.end());
+  return ids;
+}
+
+/**
+ * @brief 使用索引覆盖扫描获取对事务可见的、id 在 [low, high] 之间的记录
+ */
+static vector<int> index_only_ids(Table *table, Index *index, Trx *trx, int low, int high)
+{
+  Value left(low);
+  Value right(high);
+  IndexScanPhysicalOperator oper(table, index, true /*readonly*/, &left, true, &right, true);
+  oper.set_index_only(true);
+  EXPECT_EQ(PhysicalOperatorType::INDEX_ONLY_SCAN, oper.type());
+
+  vector<int> ids;
+  EXPECT_EQ(RC::SUCCESS, oper.open(trx));
+  const TupleCellSpec spec(table->name(), "id");
+  RC rc = RC::SUCCESS;
+  while (RC::SUCCESS == (rc = oper.next())) {
+    Value value;
+    EXPECT_EQ(RC::SUCCESS, oper.current_tuple()->find_cell(spec, value));
+    ids.push_back(value.get_int());
+  }
+  EXPECT_EQ(RC::RECORD_EOF, rc);
+  EXPECT_EQ(RC::SUCCESS, oper.close());
+  sort(ids.begin(), ids.end());
+  return ids;
+}
+
+static vector<int> range_ids(int begin, int end)
+{
+  vector<int> ids;
+  for (int i = begin; i < end; i++) {
+    ids.push_back(i);
+  }
+  return ids;
+}
+
+static void insert_rows(Table *table, Trx *trx, int begin, int end)
+{
+  for (int i = begin; i < end; i++) {
+    Value  values[] = {Value(i), Value(i * 10)};
+    Record record;
+    ASSERT_EQ(RC::SUCCESS, table->make_record(2, values, record));
+    ASSERT_EQ(RC::SUCCESS, trx->insert_record(table, record));
+  }
+}
+
+/**
+ * @brief 找到 id 是 id 的记录的位置
+ */
+static RID find_rid(Table *table, Trx *trx, int id)
+{
+  RecordFileScanner scanner;
+  EXPECT_EQ(RC::SUCCESS, table->get_record_scanner(scanner, trx, true /*readonly*/));
+  RID    rid;
+  Record record;
+  while (scanner.has_next()) {
+    EXPECT_EQ(RC::SUCCESS, scanner.next(record));
+    if (record_id(table, record) == id) {
+      rid = record.rid();
+      break;
+    }
+  }
+  scanner.close_scan();
+  return rid;
+}
+
+static void delete_id(Table *table, Trx *trx, int id)
+{
+  const RID rid = find_rid(table, trx, id);
+  RC        rc  = RC::SUCCESS;
+  ASSERT_EQ(RC::SUCCESS, table->visit_record(rid, false /*readonly*/, [trx, table, &rc](Record &record) {
+    rc = trx->delete_record(table, record);
+  }));
+  ASSERT_EQ(RC::SUCCESS, rc);
+}
+
+/**
+ * @brief 把 id 是 old_id 的记录的 id 修改为 new_id
+ */
+static void update_id(Table *table, Trx *trx, int old_id, int new_id)
+{
+  const RID rid    = find_rid(table, trx, old_id);
+  const int offset = table->table_meta().field("id")->offset();
+  RC        rc     = RC::SUCCESS;
+  ASSERT_EQ(RC::SUCCESS, table->visit_record(rid, false /*readonly*/, [trx, table, offset, new_id, &rc](Record &record) {
+    vector<char> new_data(record.data(), record.data() + table->table_meta().record_size());
+    memcpy(new_data.data() + offset, &new_id, sizeof(new_id));
+    rc = trx->update_record(table, record, new_data.data());
+  }));
+  ASSERT_EQ(RC::SUCCESS, rc);
+}
+
+/**
+ * @brief 所有用例共用一个数据库，每个用例创建自己的表
+ * @details 默认的 DefaultHandler 和 TrxKit 都只能设置一次
+ */
+class IndexOnlyScanTest : public testing::Test
+{
+protected:
+  static void SetUpTestSuite()
+  {
+    ASSERT_EQ(RC::SUCCESS, TrxKit::init_global("mvcc"));
+    // 打开数据库时恢复日志需要用到
+    GCTX.trx_kit_ = TrxKit::instance();
+
+    filesystem::remove_all(BASE_DIR);
+    handler_ = new DefaultHandler();
+    DefaultHandler::set_default(handler_);
+    ASSERT_EQ(RC::SUCCESS, handler_->init(BASE_DIR));
+  }
+
+  static void TearDownTestSuite()
+  {
+    handler_->destroy();
+    delete handler_;
+    handler_ = nullptr;
+    filesystem::remove_all(BASE_DIR);
+  }
+
+  void SetUp() override
+  {
+    const char *table_name = testing::UnitTest::GetInstance()->current_test_info()->name();
+    const AttrInfoSqlNode attributes[] = {
+        {INTS, "id", sizeof(int)},
+        {INTS, "num", sizeof(int)},
+    };
+    ASSERT_EQ(RC::SUCCESS, handler_->create_table(DB_NAME, table_name, 2, attributes));
+    db_    = handler_->find_db(DB_NAME);
+    table_ = handler_->find_table(DB_NAME, table_name);
+    ASSERT_NE(nullptr, table_);
+
+    trx_kit_ = static_cast<MvccTrxKit *>(TrxKit::instance());
+    Trx *trx = start_trx();
+    vector<const FieldMeta *> fields{table_->table_meta().field("id")};
+    ASSERT_EQ(RC::SUCCESS, table_->create_index(trx, fields, "id_index"));
+    ASSERT_EQ(RC::SUCCESS, trx->commit());
+    trx_kit_->destroy_trx(trx);
+    index_ = table_->find_index("id_index");
+    ASSERT_NE(nullptr, index_);
+  }
+
+  Trx *start_trx()
+  {
+    Trx *trx = trx_kit_->create_trx(db_->clog_manager());
+    trx->start_if_need();
+    return trx;
+  }
+
+  void end_trx(Trx *trx)
+  {
+    ASSERT_EQ(RC::SUCCESS, trx->commit());
+    trx_kit_->destroy_trx(trx);
+  }
+
+  /**
+   * @brief 索引覆盖扫描与全表扫描对事务 trx 返回相同的记录
+   */
+  void expect_same_as_table_scan(Trx *trx, int low, int high)
+  {
+    EXPECT_EQ(table_scan_ids(table_, trx, low, high), index_only_ids(table_, index_, trx, low, high));
+  }
+
+protected:
+  static DefaultHandler *handler_;
+
+  MvccTrxKit *trx_kit_ = nullptr;
+  Db         *db_      = nullptr;
+  Table      *table_   = nullptr;
+  Index      *index_   = nullptr;
+};
+
+DefaultHandler *IndexOnlyScanTest::handler_ = nullptr;
+
+TEST_F(IndexOnlyScanTest, concurrent_delete_and_update)
+{
+  Trx *insert_trx = start_trx();
+  insert_rows(table_, insert_trx, 0, 100);
+  end_trx(insert_trx);
+
+  Trx *reader_trx = start_trx();
+  ASSERT_EQ(range_ids(0, 100), index_only_ids(table_, index_, reader_trx, 0, 1000));
+
+  // 没有提交的修改对其它事务不可见
+  Trx *writer_trx = start_trx();
+  delete_id(table_, writer_trx, 10);
+  delete_id(table_, writer_trx, 11);
+  update_id(table_, writer_trx, 20, 500);
+  update_id(table_, writer_trx, 21, 5);
+  insert_rows(table_, writer_trx, 600, 601);
+  expect_same_as_table_scan(reader_trx, 0, 1000);
+  ASSERT_EQ(range_ids(0, 100), index_only_ids(table_, index_, reader_trx, 0, 1000));
+
+  // 修改的事务看到自己的修改，键值 5 有两条记录
+  expect_same_as_table_scan(writer_trx, 0, 1000);
+  ASSERT_EQ(99, static_cast<int>(index_only_ids(table_, index_, writer_trx, 0, 1000).size()));
+  ASSERT_EQ((vector<int>{5, 5}), index_only_ids(table_, index_, writer_trx, 5, 5));
+  end_trx(writer_trx);
+
+  // 提交之后，之前开始的事务还是看到旧版本
+  expect_same_as_table_scan(reader_trx, 0, 1000);
+  ASSERT_EQ(range_ids(0, 100), index_only_ids(table_, index_, reader_trx, 0, 1000));
+  ASSERT_EQ((vector<int>{5}), index_only_ids(table_, index_, reader_trx, 5, 5));
+  ASSERT_EQ((vector<int>{20, 21}), index_only_ids(table_, index_, reader_trx, 20, 21));
+  ASSERT_TRUE(index_only_ids(table_, index_, reader_trx, 500, 600).empty());
+
+  // 新的事务看到修改之后的数据
+  Trx *check_trx = start_trx();
+  expect_same_as_table_scan(check_trx, 0, 1000);
+  expect_same_as_table_scan(check_trx, 5, 21);
+  ASSERT_EQ((vector<int>{5, 5}), index_only_ids(table_, index_, check_trx, 5, 5));
+  ASSERT_TRUE(index_only_ids(table_, index_, check_trx, 10, 11).empty());
+  ASSERT_TRUE(index_only_ids(table_, index_, check_trx, 20, 21).empty());
+  ASSERT_EQ((vector<int>{500, 600}), index_only_ids(table_, index_, check_trx, 500, 600));
+  end_trx(check_trx);
+  end_trx(reader_trx);
+}
+
+TEST_F(IndexOnlyScanTest, all_visible_hint)
+{
+  MvccVacuum vacuum(*trx_kit_, *handler_);
+  RecordFileHandler *record_handler = table_->record_handler();
+  // 先清理掉之前的用例留下的旧版本
+  ASSERT_EQ(RC::SUCCESS, vacuum.run_once(10000));
+  const int64_t purged_versions = vacuum.stats().purged_versions.load();
+
+  Trx *insert_trx = start_trx();
+  insert_rows(table_, insert_trx, 0, 100);
+  end_trx(insert_trx);
+
+  Trx *check_trx = start_trx();
+  const PageNum page_num = find_rid(table_, check_trx, 0).page_num;
+  end_trx(check_trx);
+
+  // 只读的全表扫描发现页面上的记录对所有事务可见，设置提示信息，之后索引覆盖扫描不需要访问记录
+  Trx *scan_trx = start_trx();
+  ASSERT_EQ(range_ids(0, 100), table_scan_ids(table_, scan_trx, 0, 1000));
+  ASSERT_TRUE(record_handler->is_page_all_visible(page_num));
+  expect_same_as_table_scan(scan_trx, 0, 1000);
+  end_trx(scan_trx);
+
+  Trx *reader_trx = start_trx();
+
+  // 修改页面会清除提示信息
+  Trx *writer_trx = start_trx();
+  delete_id(table_, writer_trx, 30);
+  ASSERT_FALSE(record_handler->is_page_all_visible(page_num));
+  update_id(table_, writer_trx, 40, 400);
+  end_trx(writer_trx);
+
+  // 页面上有旧版本时，旧版本的索引项还在，全表扫描不能设置提示信息
+  Trx *new_trx = start_trx();
+  expect_same_as_table_scan(new_trx, 0, 1000);
+  ASSERT_FALSE(record_handler->is_page_all_visible(page_num));
+  ASSERT_TRUE(index_only_ids(table_, index_, new_trx, 30, 30).empty());
+  ASSERT_TRUE(index_only_ids(table_, index_, new_trx, 40, 40).empty());
+  ASSERT_EQ((vector<int>{400}), index_only_ids(table_, index_, new_trx, 400, 400));
+
+  // 删除之前开始的事务还是看到删除和更新之前的数据
+  expect_same_as_table_scan(reader_trx, 0, 1000);
+  ASSERT_EQ(range_ids(0, 100), index_only_ids(table_, index_, reader_trx, 0, 1000));
+  end_trx(reader_trx);
+  end_trx(new_trx);
+
+  // 清理掉旧版本之后，全表扫描可以重新设置提示信息，结果与访问记录时相同
+  ASSERT_EQ(RC::SUCCESS, vacuum.run_once(10000));
+  ASSERT_EQ(purged_versions + 1, vacuum.stats().purged_versions.load());
+  Trx *last_trx = start_trx();
+  vector<int> expected = table_scan_ids(table_, last_trx, 0, 1000);
+  ASSERT_TRUE(record_handler->is_page_all_visible(page_num));
+  ASSERT_EQ(99, static_cast<int>(expected.size()));
+  ASSERT_EQ(expected, index_only_ids(table_, index_, last_trx, 0, 1000));
+  ASSERT_TRUE(index_only_ids(table_, index_, last_trx, 30, 30).empty());
+  ASSERT_TRUE(index_only_ids(table_, index_, last_trx, 40, 40).empty());
+
+  // 在设置了提示信息之后提交的插入对之前开始的事务不可见
+  Trx *late_trx = start_trx();
+  insert_rows(table_, late_trx, 700, 701);
+  end_trx(late_trx);
+  ASSERT_EQ(expected, index_only_ids(table_, index_, last_trx, 0, 1000));
+  end_trx(last_trx);
+}
+
+int main(int argc, char **argv)
+{
+  // 默认的缓冲池管理器只能设置一次，所有用例共用
+  BufferPoolManager::set_instance(&bpm);
+
+  testing::InitGoogleTest(&argc, argv);
+  LoggerFactory::init_default("index_only_scan_test.log", LOG_LEVEL_INFO);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,58 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// 启动配置解析的测试
+//
+
+#include "common/init.h"
+#include "gtest/gtest.h"
+
+static int64_t memory_size(const char *str)
+{
+  int64_t size = -1;
+  return parse_memory_size(str, size) ? size : -1;
+}
+
+TEST(parse_memory_size, units)
+{
+  ASSERT_EQ(0, memory_size("0"));
+  ASSERT_EQ(4096, memory_size("4096"));
+  ASSERT_EQ(256LL * 1024, memory_size("256K"));
+  ASSERT_EQ(512LL * 1024 * 1024, memory_size("512M"));
+  ASSERT_EQ(512LL * 1024 * 1024, memory_size("512m"));
+  ASSERT_EQ(8LL * 1024 * 1024 * 1024, memory_size("8G"));
+  ASSERT_EQ(8LL * 1024 * 1024 * 1024, memory_size("8GB"));
+  ASSERT_EQ(2LL * 1024 * 1024 * 1024 * 1024, memory_size("2T"));
+  ASSERT_EQ(100, memory_size("100B"));
+}
+
+TEST(parse_memory_size, invalid)
+{
+  ASSERT_EQ(-1, memory_size(""));
+  ASSERT_EQ(-1, memory_size("M"));
+  ASSERT_EQ(-1, memory_size("-1"));
+  ASSERT_EQ(-1, memory_size("-8G"));
+  ASSERT_EQ(-1, memory_size("1.5G"));
+  ASSERT_EQ(-1, memory_size("8X"));
+  ASSERT_EQ(-1, memory_size("8GG"));
+  ASSERT_EQ(-1, memory_size("8 G"));
+
+  // 超出 int64_t 的范围
+  ASSERT_EQ(-1, memory_size("99999999999999999999"));
+  ASSERT_EQ(-1, memory_size("9000000T"));
+  ASSERT_EQ(8388607LL << 40, memory_size("8388607T"));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
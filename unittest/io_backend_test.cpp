@@ -0,0 +1,103 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// 文件读写接口(pread/pwrite、io_uring)的测试
+//
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+
+#include "storage/common/io_backend.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+static void test_backend(IoBackend &backend)
+{
+  const char *file_name = "io_backend_test.data";
+  ::remove(file_name);
+  int fd = ::open(file_name, O_RDWR | O_CREAT, S_IRUSR | S_IWUSR);
+  ASSERT_GE(fd, 0);
+
+  // 一批写入，中间有连续的也有不连续的
+  const int page_size = 4096;
+  const int page_num  = 100;
+  vector<vector<char>> pages(page_num, vector<char>(page_size));
+  vector<IoRequest>    requests(page_num);
+  for (int i = 0; i < page_num; i++) {
+    memset(pages[i].data(), i, page_size);
+    requests[i].fd     = fd;
+    requests[i].buf    = pages[i].data();
+    requests[i].len    = page_size;
+    requests[i].offset = static_cast<int64_t>(i % 3 == 0 ? page_num - 1 - i : i) * page_size;
+  }
+  ASSERT_EQ(RC::SUCCESS, backend.write(requests.data(), page_num));
+
+  vector<vector<char>> read_pages(page_num, vector<char>(page_size));
+  for (int i = 0; i < page_num; i++) {
+    requests[i].buf = read_pages[i].data();
+  }
+  ASSERT_EQ(RC::SUCCESS, backend.read(requests.data(), page_num));
+  for (int i = 0; i < page_num; i++) {
+    ASSERT_EQ(pages[i], read_pages[i]);
+  }
+
+  // 读到文件尾认为是失败
+  IoRequest eof_request;
+  eof_request.fd     = fd;
+  eof_request.buf    = read_pages[0].data();
+  eof_request.len    = page_size;
+  eof_request.offset = static_cast<int64_t>(page_num) * page_size;
+  ASSERT_NE(RC::SUCCESS, backend.read(&eof_request, 1));
+
+  // 不指定位置时从文件当前位置写入
+  ASSERT_EQ(static_cast<off_t>(page_num) * page_size, lseek(fd, 0, SEEK_END));
+  const char data[] = "append data";
+  IoRequest append_request;
+  append_request.fd  = fd;
+  append_request.buf = const_cast<char *>(data);
+  append_request.len = sizeof(data);
+  ASSERT_EQ(RC::SUCCESS, backend.write_and_sync(append_request));
+  ASSERT_EQ(static_cast<off_t>(page_num) * page_size + static_cast<off_t>(sizeof(data)), lseek(fd, 0, SEEK_END));
+
+  char buf[sizeof(data)];
+  ASSERT_EQ(static_cast<ssize_t>(sizeof(buf)), pread(fd, buf, sizeof(buf), static_cast<off_t>(page_num) * page_size));
+  ASSERT_STREQ(data, buf);
+
+  ::close(fd);
+  ::remove(file_name);
+}
+
+TEST(test_io_backend, test_posix)
+{
+  PosixIoBackend backend;
+  test_backend(backend);
+}
+
+TEST(test_io_backend, test_io_uring)
+{
+  // 不支持 io_uring 时使用 pread/pwrite 完成
+  IoUringBackend backend;
+  test_backend(backend);
+}
+
+int main(int argc, char **argv)
+{
+  // 分析gtest程序的命令行参数
+  testing::InitGoogleTest(&argc, argv);
+
+  // 调用RUN_ALL_TESTS()运行所有测试用例
+  // main函数返回RUN_ALL_TESTS()的运行结果
+  return RUN_ALL_TESTS();
+}
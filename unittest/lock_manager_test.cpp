@@ -0,0 +1,236 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// 行锁管理器(LockManager)的测试
+//
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "storage/trx/lock_manager.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+static RowLockKey make_key(int32_t table_id, PageNum page_num, SlotNum slot_num)
+{
+  RowLockKey key;
+  key.table_id = table_id;
+  key.rid      = RID(page_num, slot_num);
+  return key;
+}
+
+static void wait_until_waiting(LockManager &lock_manager, int64_t count)
+{
+  while (lock_manager.waiting_count() < count) {
+    this_thread::yield();
+  }
+}
+
+TEST(lock_manager, try_lock)
+{
+  LockManager lock_manager;
+  const RowLockKey key1 = make_key(1, 1, 0);
+  const RowLockKey key2 = make_key(2, 1, 0);
+
+  ASSERT_EQ(RC::SUCCESS, lock_manager.try_lock(10, key1));
+  ASSERT_EQ(RC::SUCCESS, lock_manager.try_lock(10, key1));
+  ASSERT_EQ(RC::LOCKED_NEED_WAIT, lock_manager.try_lock(11, key1));
+  ASSERT_EQ(RC::SUCCESS, lock_manager.try_lock(11, key2));
+  ASSERT_EQ(2, lock_manager.lock_count());
+
+  lock_manager.unlock(10, key1);
+  ASSERT_EQ(RC::SUCCESS, lock_manager.try_lock(11, key1));
+  lock_manager.unlock(11, key1);
+  lock_manager.unlock(11, key2);
+  ASSERT_EQ(0, lock_manager.lock_count());
+}
+
+TEST(lock_manager, fifo_wait)
+{
+  LockManager lock_manager;
+  const RowLockKey key = make_key(1, 2, 3);
+  ASSERT_EQ(RC::SUCCESS, lock_manager.lock(1, key));
+
+  mutex          order_mutex;
+  vector<int32_t> order;
+  vector<thread>  threads;
+  for (int32_t trx_id = 2; trx_id <= 4; trx_id++) {
+    threads.emplace_back([&, trx_id]() {
+      ASSERT_EQ(RC::SUCCESS, lock_manager.lock(trx_id, key));
+      {
+        lock_guard<mutex> guard(order_mutex);
+        order.push_back(trx_id);
+      }
+      lock_manager.unlock(trx_id, key);
+    });
+    wait_until_waiting(lock_manager, trx_id - 1);
+  }
+
+  lock_manager.unlock(1, key);
+  for (thread &t : threads) {
+    t.join();
+  }
+  ASSERT_EQ((vector<int32_t>{2, 3, 4}), order);
+  ASSERT_EQ(0, lock_manager.lock_count());
+}
+
+TEST(lock_manager, timeout)
+{
+  LockManager lock_manager;
+  lock_manager.set_wait_timeout_ms(50);
+  const RowLockKey key = make_key(1, 1, 1);
+
+  ASSERT_EQ(RC::SUCCESS, lock_manager.lock(1, key));
+  ASSERT_EQ(RC::LOCKED_WAIT_TIMEOUT, lock_manager.lock(2, key));
+
+  // 超时的等待者已经离开队列，释放后锁就没有了
+  lock_manager.unlock(1, key);
+  ASSERT_EQ(0, lock_manager.lock_count());
+}
+
+TEST(lock_manager, deadlock)
+{
+  LockManager lock_manager;
+  const RowLockKey key1 = make_key(1, 1, 1);
+  const RowLockKey key2 = make_key(1, 1, 2);
+
+  ASSERT_EQ(RC::SUCCESS, lock_manager.lock(1, key1));
+  ASSERT_EQ(RC::SUCCESS, lock_manager.lock(2, key2));
+
+  RC rc1 = RC::SUCCESS;
+  thread t1([&]() {
+    rc1 = lock_manager.lock(1, key2);
+  });
+  wait_until_waiting(lock_manager, 1);
+
+  // 事务2 等待事务1 会形成环
+  ASSERT_EQ(RC::LOCKED_DEADLOCK, lock_manager.lock(2, key1));
+  ASSERT_EQ(1, lock_manager.deadlock_count());
+
+  lock_manager.unlock(2, key2);
+  t1.join();
+  ASSERT_EQ(RC::SUCCESS, rc1);
+  lock_manager.unlock(1, key1);
+  lock_manager.unlock(1, key2);
+  ASSERT_EQ(0, lock_manager.lock_count());
+}
+
+TEST(lock_manager, deadlock_after_handoff)
+{
+  LockManager lock_manager;
+  const RowLockKey key1 = make_key(1, 1, 1);
+  const RowLockKey key2 = make_key(1, 1, 2);
+
+  // 事务2和事务3 依次等待事务1 持有的 key1，事务3 持有 key2
+  ASSERT_EQ(RC::SUCCESS, lock_manager.lock(1, key1));
+  ASSERT_EQ(RC::SUCCESS, lock_manager.lock(3, key2));
+  thread t2([&]() {
+    ASSERT_EQ(RC::SUCCESS, lock_manager.lock(2, key1));
+    // 事务3 现在等待事务2，事务2 再等待事务3 持有的锁就是死锁
+    ASSERT_EQ(RC::LOCKED_DEADLOCK, lock_manager.lock(2, key2));
+    lock_manager.unlock(2, key1);
+  });
+  wait_until_waiting(lock_manager, 1);
+  RC rc3 = RC::SUCCESS;
+  thread t3([&]() {
+    rc3 = lock_manager.lock(3, key1);
+  });
+  wait_until_waiting(lock_manager, 2);
+
+  lock_manager.unlock(1, key1);
+  t2.join();
+  t3.join();
+  ASSERT_EQ(RC::SUCCESS, rc3);
+  lock_manager.unlock(3, key1);
+  lock_manager.unlock(3, key2);
+  ASSERT_EQ(0, lock_manager.lock_count());
+}
+
+TEST(lock_manager, max_waiters)
+{
+  // 模拟 3 个 SQL 线程，最多 2 个等锁，第三个请求不能再占用线程
+  LockManager lock_manager;
+  lock_manager.set_max_waiters(2);
+  const RowLockKey key = make_key(1, 1, 1);
+  ASSERT_EQ(RC::SUCCESS, lock_manager.lock(1, key));
+
+  vector<thread> threads;
+  for (int32_t trx_id = 2; trx_id <= 3; trx_id++) {
+    threads.emplace_back([&, trx_id]() {
+      ASSERT_EQ(RC::SUCCESS, lock_manager.lock(trx_id, key));
+      lock_manager.unlock(trx_id, key);
+    });
+  }
+  wait_until_waiting(lock_manager, 2);
+
+  // 超过上限的等待者立即返回，不会等到超时
+  const auto begin = chrono::steady_clock::now();
+  ASSERT_EQ(RC::LOCKED_CONCURRENCY_CONFLICT, lock_manager.lock(4, key));
+  ASSERT_EQ(RC::LOCKED_CONCURRENCY_CONFLICT, lock_manager.lock(5, key));
+  ASSERT_LT(chrono::steady_clock::now() - begin, chrono::milliseconds(lock_manager.wait_timeout_ms()));
+  ASSERT_EQ(2, lock_manager.waiting_count());
+
+  // 剩下的线程可以让持有者结束，等待者依次拿到锁
+  lock_manager.unlock(1, key);
+  for (thread &t : threads) {
+    t.join();
+  }
+  ASSERT_EQ(0, lock_manager.waiting_count());
+  ASSERT_EQ(0, lock_manager.lock_count());
+
+  // 上限为0时不等待
+  lock_manager.set_max_waiters(0);
+  ASSERT_EQ(RC::SUCCESS, lock_manager.lock(1, key));
+  ASSERT_EQ(RC::LOCKED_CONCURRENCY_CONFLICT, lock_manager.lock(2, key));
+  lock_manager.unlock(1, key);
+  ASSERT_EQ(0, lock_manager.lock_count());
+}
+
+TEST(lock_manager, hot_row)
+{
+  LockManager lock_manager;
+  const RowLockKey key = make_key(1, 1, 1);
+
+  const int    thread_num = 8;
+  const int    loops      = 1000;
+  int64_t      counter    = 0;  // 只在持有锁时修改
+  atomic<int>  failed{0};
+  vector<thread> threads;
+  for (int t = 0; t < thread_num; t++) {
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < loops; i++) {
+        const int32_t trx_id = t * loops + i + 1;
+        if (lock_manager.lock(trx_id, key) != RC::SUCCESS) {
+          failed++;
+          continue;
+        }
+        counter++;
+        lock_manager.unlock(trx_id, key);
+      }
+    });
+  }
+  for (thread &t : threads) {
+    t.join();
+  }
+  ASSERT_EQ(0, failed.load());
+  ASSERT_EQ(thread_num * loops, counter);
+  ASSERT_EQ(0, lock_manager.lock_count());
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,385 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// 多版本数据垃圾回收(MvccVacuum)的测试
+//
+
+#include <filesystem>
+
+#include "common/global_context.h"
+#include "common/log/log.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/db/db.h"
+#include "storage/default/default_handler.h"
+#include "storage/index/index.h"
+#include "storage/record/record_manager.h"
+#include "storage/table/table.h"
+#include "storage/trx/mvcc_trx.h"
+#include "storage/trx/mvcc_vacuum.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+using namespace common;
+
+static const char *BASE_DIR   = "mvcc_vacuum_test_dir";
+static const char *DB_NAME    = "sys";
+
+static BufferPoolManager bpm;
+
+/**
+ * @brief 数据文件中的记录数，包括已经删除但是还没有清理的记录
+ */
+static int physical_rows(Table *table)
+{
+  RecordFileScanner scanner;
+  EXPECT_EQ(RC::SUCCESS, table->get_record_scanner(scanner, nullptr /*trx*/, true /*readonly*/));
+  int    count = 0;
+  Record record;
+  while (scanner.has_next()) {
+    EXPECT_EQ(RC::SUCCESS, scanner.next(record));
+    count++;
+  }
+  scanner.close_scan();
+  return count;
+}
+
+/**
+ * @brief 对事务可见的记录数
+ */
+static int visible_rows(Table *table, Trx *trx)
+{
+  RecordFileScanner scanner;
+  EXPECT_EQ(RC::SUCCESS, table->get_record_scanner(scanner, trx, true /*readonly*/));
+  int    count = 0;
+  Record record;
+  while (scanner.has_next()) {
+    EXPECT_EQ(RC::SUCCESS, scanner.next(record));
+    count++;
+  }
+  scanner.close_scan();
+  return count;
+}
+
+static int index_entries(Index *index)
+{
+  IndexScanner *scanner = index->create_scanner(nullptr, 0, false, nullptr, 0, false);
+  EXPECT_NE(nullptr, scanner);
+  int count = 0;
+  RID rid;
+  while (scanner->next_entry(&rid) == RC::SUCCESS) {
+    count++;
+  }
+  scanner->destroy();
+  return count;
+}
+
+/**
+ * @brief 索引中键值是 id 的索引项个数
+ */
+static int index_entries(Index *index, int id)
+{
+  IndexScanner *scanner = index->create_scanner(reinterpret_cast<const char *>(&id), sizeof(id), true,
+                                                reinterpret_cast<const char *>(&id), sizeof(id), true);
+  EXPECT_NE(nullptr, scanner);
+  int count = 0;
+  RID rid;
+  while (scanner->next_entry(&rid) == RC::SUCCESS) {
+    count++;
+  }
+  scanner->destroy();
+  return count;
+}
+
+static void insert_rows(Table *table, Trx *trx, int begin, int end)
+{
+  for (int i = begin; i < end; i++) {
+    Value  values[] = {Value(i), Value(i * 10)};
+    Record record;
+    ASSERT_EQ(RC::SUCCESS, table->make_record(2, values, record));
+    ASSERT_EQ(RC::SUCCESS, trx->insert_record(table, record));
+  }
+}
+
+/**
+ * @brief 删除 id 是偶数的记录
+ */
+static void delete_even_rows(Table *table, Trx *trx)
+{
+  RecordFileScanner scanner;
+  ASSERT_EQ(RC::SUCCESS, table->get_record_scanner(scanner, trx, false /*readonly*/));
+  vector<Record> records;
+  Record         record;
+  while (scanner.has_next()) {
+    ASSERT_EQ(RC::SUCCESS, scanner.next(record));
+    const int id = *reinterpret_cast<const int *>(record.data() + table->table_meta().field("id")->offset());
+    if (id % 2 == 0) {
+      records.push_back(record);
+    }
+  }
+  scanner.close_scan();
+
+  for (Record &deleted : records) {
+    ASSERT_EQ(RC::SUCCESS, trx->delete_record(table, deleted));
+  }
+}
+
+/**
+ * @brief 把 id 是 old_id 的记录的 id 修改为 new_id
+ */
+static void update_id(Table *table, Trx *trx, int old_id, int new_id)
+{
+  RecordFileScanner scanner;
+  ASSERT_EQ(RC::SUCCESS, table->get_record_scanner(scanner, trx, true /*readonly*/));
+  const int offset = table->table_meta().field("id")->offset();
+  RID    rid;
+  bool   found = false;
+  Record record;
+  while (!found && scanner.has_next()) {
+    ASSERT_EQ(RC::SUCCESS, scanner.next(record));
+    found = *reinterpret_cast<const int *>(record.data() + offset) == old_id;
+    rid   = record.rid();
+  }
+  scanner.close_scan();
+  ASSERT_TRUE(found);
+
+  RC rc = RC::SUCCESS;
+  ASSERT_EQ(RC::SUCCESS, table->visit_record(rid, false /*readonly*/, [trx, table, offset, new_id, &rc](Record &record) {
+    vector<char> new_data(record.data(), record.data() + table->table_meta().record_size());
+    memcpy(new_data.data() + offset, &new_id, sizeof(new_id));
+    rc = trx->update_record(table, record, new_data.data());
+  }));
+  ASSERT_EQ(RC::SUCCESS, rc);
+}
+
+/**
+ * @brief 所有用例共用一个数据库，每个用例创建自己的表
+ * @details 默认的 DefaultHandler 和 TrxKit 都只能设置一次
+ */
+class MvccVacuumTest : public testing::Test
+{
+protected:
+  static void SetUpTestSuite()
+  {
+    ASSERT_EQ(RC::SUCCESS, TrxKit::init_global("mvcc"));
+    // 打开数据库时恢复日志需要用到
+    GCTX.trx_kit_ = TrxKit::instance();
+
+    filesystem::remove_all(BASE_DIR);
+    handler_ = new DefaultHandler();
+    DefaultHandler::set_default(handler_);
+    ASSERT_EQ(RC::SUCCESS, handler_->init(BASE_DIR));
+  }
+
+  static void TearDownTestSuite()
+  {
+    handler_->destroy();
+    delete handler_;
+    handler_ = nullptr;
+    filesystem::remove_all(BASE_DIR);
+  }
+
+  void SetUp() override
+  {
+    const char *table_name = testing::UnitTest::GetInstance()->current_test_info()->name();
+    const AttrInfoSqlNode attributes[] = {
+        {INTS, "id", sizeof(int)},
+        {INTS, "num", sizeof(int)},
+    };
+    ASSERT_EQ(RC::SUCCESS, handler_->create_table(DB_NAME, table_name, 2, attributes));
+    db_    = handler_->find_db(DB_NAME);
+    table_ = handler_->find_table(DB_NAME, table_name);
+    ASSERT_NE(nullptr, table_);
+
+    trx_kit_ = static_cast<MvccTrxKit *>(TrxKit::instance());
+    Trx *trx = start_trx();
+    vector<const FieldMeta *> fields{table_->table_meta().field("id")};
+    ASSERT_EQ(RC::SUCCESS, table_->create_index(trx, fields, "id_index"));
+    ASSERT_EQ(RC::SUCCESS, trx->commit());
+    trx_kit_->destroy_trx(trx);
+    index_ = table_->find_index("id_index");
+    ASSERT_NE(nullptr, index_);
+  }
+
+  Trx *start_trx()
+  {
+    Trx *trx = trx_kit_->create_trx(db_->clog_manager());
+    trx->start_if_need();
+    return trx;
+  }
+
+protected:
+  static DefaultHandler *handler_;
+
+  MvccTrxKit *trx_kit_ = nullptr;
+  Db         *db_      = nullptr;
+  Table      *table_   = nullptr;
+  Index      *index_   = nullptr;
+};
+
+DefaultHandler *MvccVacuumTest::handler_ = nullptr;
+
+TEST_F(MvccVacuumTest, reclaim_committed_deletes)
+{
+  MvccVacuum vacuum(*trx_kit_, *handler_);
+
+  Trx *insert_trx = start_trx();
+  insert_rows(table_, insert_trx, 0, 1000);
+  ASSERT_EQ(RC::SUCCESS, insert_trx->commit());
+  trx_kit_->destroy_trx(insert_trx);
+
+  // 没有可以清理的记录
+  ASSERT_EQ(RC::SUCCESS, vacuum.run_once(10000));
+  ASSERT_EQ(0, vacuum.stats().reclaimed_rows.load());
+  ASSERT_EQ(1000, physical_rows(table_));
+
+  // 在删除提交之前开始的事务还能看到删除的记录，不能清理
+  Trx *reader_trx = start_trx();
+
+  Trx *delete_trx = start_trx();
+  delete_even_rows(table_, delete_trx);
+  ASSERT_EQ(RC::SUCCESS, delete_trx->commit());
+  trx_kit_->destroy_trx(delete_trx);
+
+  ASSERT_EQ(RC::SUCCESS, vacuum.run_once(10000));
+  ASSERT_EQ(0, vacuum.stats().reclaimed_rows.load());
+  ASSERT_EQ(1000, physical_rows(table_));
+  ASSERT_EQ(1000, visible_rows(table_, reader_trx));
+  ASSERT_EQ(1000, index_entries(index_));
+
+  ASSERT_EQ(RC::SUCCESS, reader_trx->commit());
+  trx_kit_->destroy_trx(reader_trx);
+
+  // 每一轮的预算很小，需要多轮才能清理完
+  for (int i = 0; i < 100 && vacuum.stats().reclaimed_rows.load() < 500; i++) {
+    ASSERT_EQ(RC::SUCCESS, vacuum.run_once(8));
+  }
+  ASSERT_EQ(500, vacuum.stats().reclaimed_rows.load());
+  ASSERT_GT(vacuum.stats().rounds.load(), 1);
+  ASSERT_EQ(500, physical_rows(table_));
+  ASSERT_EQ(500, index_entries(index_));
+
+  Trx *check_trx = start_trx();
+  ASSERT_EQ(500, visible_rows(table_, check_trx));
+  trx_kit_->destroy_trx(check_trx);
+
+  // 再清理一遍不会有变化
+  ASSERT_EQ(RC::SUCCESS, vacuum.run_once(10000));
+  ASSERT_EQ(500, vacuum.stats().reclaimed_rows.load());
+  ASSERT_EQ(500, physical_rows(table_));
+}
+
+TEST_F(MvccVacuumTest, reclaim_abandoned_inserts)
+{
+  MvccVacuum vacuum(*trx_kit_, *handler_);
+
+  Trx *insert_trx = start_trx();
+  insert_rows(table_, insert_trx, 0, 100);
+  ASSERT_EQ(RC::SUCCESS, insert_trx->commit());
+  trx_kit_->destroy_trx(insert_trx);
+
+  // 事务正在进行时插入的记录不能清理
+  Trx *abandoned_trx = start_trx();
+  insert_rows(table_, abandoned_trx, 100, 150);
+  ASSERT_EQ(RC::SUCCESS, vacuum.run_once(10000));
+  ASSERT_EQ(0, vacuum.stats().reclaimed_rows.load());
+  ASSERT_EQ(150, physical_rows(table_));
+
+  // 事务没有提交也没有回滚就被销毁了
+  trx_kit_->destroy_trx(abandoned_trx);
+  ASSERT_EQ(RC::SUCCESS, vacuum.run_once(10000));
+  ASSERT_EQ(50, vacuum.stats().reclaimed_rows.load());
+  ASSERT_EQ(100, physical_rows(table_));
+  ASSERT_EQ(100, index_entries(index_));
+
+  Trx *check_trx = start_trx();
+  ASSERT_EQ(100, visible_rows(table_, check_trx));
+  trx_kit_->destroy_trx(check_trx);
+}
+
+TEST_F(MvccVacuumTest, keep_index_entries_of_old_versions)
+{
+  MvccVacuum vacuum(*trx_kit_, *handler_);
+
+  Trx *insert_trx = start_trx();
+  insert_rows(table_, insert_trx, 0, 10);
+  ASSERT_EQ(RC::SUCCESS, insert_trx->commit());
+  trx_kit_->destroy_trx(insert_trx);
+
+  Trx *reader_trx = start_trx();
+
+  // 更新之后旧版本的索引项还在，更新之前开始的事务还能通过它找到旧版本
+  Trx *update_trx = start_trx();
+  update_id(table_, update_trx, 3, 100);
+  ASSERT_EQ(11, index_entries(index_));
+  ASSERT_EQ(1, index_entries(index_, 3));
+  ASSERT_EQ(1, index_entries(index_, 100));
+
+  // 同一个事务再次更新，中间的版本对其它事务不可见，它的索引项直接删除
+  update_id(table_, update_trx, 100, 200);
+  ASSERT_EQ(11, index_entries(index_));
+  ASSERT_EQ(0, index_entries(index_, 100));
+  ASSERT_EQ(RC::SUCCESS, update_trx->commit());
+  trx_kit_->destroy_trx(update_trx);
+
+  ASSERT_EQ(RC::SUCCESS, vacuum.run_once(10000));
+  ASSERT_EQ(0, vacuum.stats().purged_versions.load());
+  ASSERT_EQ(1, index_entries(index_, 3));
+  ASSERT_EQ(10, visible_rows(table_, reader_trx));
+
+  ASSERT_EQ(RC::SUCCESS, reader_trx->commit());
+  trx_kit_->destroy_trx(reader_trx);
+
+  // 没有事务再访问旧版本，清理旧版本时删除它的索引项
+  ASSERT_EQ(RC::SUCCESS, vacuum.run_once(10000));
+  ASSERT_EQ(1, vacuum.stats().purged_versions.load());
+  ASSERT_EQ(10, index_entries(index_));
+  ASSERT_EQ(0, index_entries(index_, 3));
+  ASSERT_EQ(1, index_entries(index_, 200));
+}
+
+TEST_F(MvccVacuumTest, rollback_update_after_key_reused)
+{
+  Trx *insert_trx = start_trx();
+  insert_rows(table_, insert_trx, 0, 10);
+  ASSERT_EQ(RC::SUCCESS, insert_trx->commit());
+  trx_kit_->destroy_trx(insert_trx);
+
+  Trx *update_trx = start_trx();
+  update_id(table_, update_trx, 5, 500);
+
+  // 其它事务插入了更新之前的键值
+  Trx *other_trx = start_trx();
+  insert_rows(table_, other_trx, 5, 6);
+  ASSERT_EQ(RC::SUCCESS, other_trx->commit());
+  trx_kit_->destroy_trx(other_trx);
+  ASSERT_EQ(2, index_entries(index_, 5));
+
+  // 回滚时原来的索引项还在，只需要删除更新之后插入的索引项
+  ASSERT_EQ(RC::SUCCESS, update_trx->rollback());
+  trx_kit_->destroy_trx(update_trx);
+  ASSERT_EQ(11, index_entries(index_));
+  ASSERT_EQ(2, index_entries(index_, 5));
+  ASSERT_EQ(0, index_entries(index_, 500));
+
+  Trx *check_trx = start_trx();
+  ASSERT_EQ(11, visible_rows(table_, check_trx));
+  trx_kit_->destroy_trx(check_trx);
+}
+
+int main(int argc, char **argv)
+{
+  // 默认的缓冲池管理器只能设置一次，所有用例共用
+  BufferPoolManager::set_instance(&bpm);
+
+  testing::InitGoogleTest(&argc, argv);
+  LoggerFactory::init_default("mvcc_vacuum_test.log", LOG_LEVEL_INFO);
+  return RUN_ALL_TESTS();
+}
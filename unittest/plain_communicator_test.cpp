@@ -0,0 +1,127 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// 文本协议(PlainCommunicator)接收消息的测试
+//
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "event/session_event.h"
+#include "net/plain_communicator.h"
+#include "session/session.h"
+
+using namespace std;
+
+class PlainCommunicatorTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    int fds[2];
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+    ASSERT_EQ(0, fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK));
+    peer_fd_ = fds[1];
+    ASSERT_EQ(RC::SUCCESS, communicator_.init(fds[0], new Session(), "test"));
+  }
+
+  void TearDown() override
+  {
+    if (peer_fd_ >= 0) {
+      close(peer_fd_);
+    }
+  }
+
+  void send(const string &data) { ASSERT_EQ(static_cast<ssize_t>(data.size()), write(peer_fd_, data.data(), data.size())); }
+
+  /**
+   * @brief 读取一个消息，返回消息内容，没有完整的消息时返回空字符串
+   */
+  string read_query()
+  {
+    SessionEvent *event = nullptr;
+    EXPECT_EQ(RC::SUCCESS, communicator_.read_event(event));
+    if (event == nullptr) {
+      return "";
+    }
+    string query = event->query();
+    delete event;
+    return query;
+  }
+
+protected:
+  PlainCommunicator communicator_;
+  int               peer_fd_ = -1;
+};
+
+TEST_F(PlainCommunicatorTest, pipelined_messages)
+{
+  send(string("select 1;\0select 2;\0sel", 23));
+  ASSERT_EQ("select 1;", read_query());
+  ASSERT_TRUE(communicator_.has_buffered_message());
+  ASSERT_EQ("select 2;", read_query());
+  ASSERT_FALSE(communicator_.has_buffered_message());
+
+  // 最后一个消息还不完整
+  ASSERT_EQ("", read_query());
+
+  send(string("ect 3;\0", 7));
+  ASSERT_EQ("select 3;", read_query());
+  ASSERT_EQ("", read_query());
+}
+
+TEST_F(PlainCommunicatorTest, blank_messages)
+{
+  send(string("\0  \0select 1;\0", 14));
+  ASSERT_EQ("select 1;", read_query());
+  ASSERT_EQ("", read_query());
+}
+
+TEST_F(PlainCommunicatorTest, long_message)
+{
+  string query = "select * from t where ";
+  while (query.size() < 100000) {
+    query += "id = 1 and ";
+  }
+  query += "id = 1;";
+
+  // 分成很多次发送，接收缓存需要不断扩大
+  for (size_t i = 0; i < query.size(); i += 3000) {
+    send(query.substr(i, 3000));
+    ASSERT_EQ("", read_query());
+  }
+  send(string(1, '\0'));
+  ASSERT_EQ(query, read_query());
+}
+
+TEST_F(PlainCommunicatorTest, peer_closed)
+{
+  send(string("select 1;\0select 2;\0", 20));
+  close(peer_fd_);
+  peer_fd_ = -1;
+
+  // 对端关闭之前发送的消息还是可以读到
+  ASSERT_EQ("select 1;", read_query());
+  ASSERT_EQ("select 2;", read_query());
+
+  SessionEvent *event = nullptr;
+  ASSERT_EQ(RC::IOERR_CLOSE, communicator_.read_event(event));
+  ASSERT_EQ(nullptr, event);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,262 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// 多个事件循环线程(Reactor)接收消息，以及连接关闭时等待请求处理完成的测试
+//
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <event2/thread.h>
+
+#include "gtest/gtest.h"
+#include "event/session_event.h"
+#include "net/plain_communicator.h"
+#include "net/reactor.h"
+#include "session/session.h"
+
+using namespace std;
+
+/**
+ * @brief 一个连接，记录在 Reactor 线程中收到的消息
+ */
+class Connection : public PlainCommunicator
+{
+public:
+  int peer_fd = -1;
+
+  mutex          lock;
+  vector<string> queries;
+  thread::id     reactor_thread;
+};
+
+/**
+ * @brief 类似 Server::recv，只是把收到的消息记录下来，不交给 SessionStage 处理
+ */
+static void on_readable(int fd, short ev, void *arg)
+{
+  Connection *connection = static_cast<Connection *>(static_cast<Communicator *>(arg));
+  do {
+    SessionEvent *event = nullptr;
+    if (connection->read_event(event) != RC::SUCCESS || event == nullptr) {
+      return;
+    }
+
+    lock_guard<mutex> guard(connection->lock);
+    connection->queries.push_back(event->query());
+    connection->reactor_thread = this_thread::get_id();
+    delete event;
+  } while (connection->has_buffered_message());
+}
+
+static unique_ptr<Connection> create_connection()
+{
+  int fds[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+    return nullptr;
+  }
+  fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+
+  unique_ptr<Connection> connection(new Connection);
+  connection->init(fds[0], new Session(), "test");
+  connection->peer_fd = fds[1];
+  return connection;
+}
+
+static bool wait_for(const function<bool()> &condition)
+{
+  for (int i = 0; i < 500; i++) {
+    if (condition()) {
+      return true;
+    }
+    this_thread::sleep_for(chrono::milliseconds(10));
+  }
+  return false;
+}
+
+TEST(reactor, connections_served_by_reactor_threads)
+{
+  const int reactor_num    = 2;
+  const int connection_num = 6;
+  const int query_num      = 20;
+
+  vector<unique_ptr<Reactor>> reactors;
+  for (int i = 0; i < reactor_num; i++) {
+    reactors.emplace_back(new Reactor(i));
+    ASSERT_EQ(RC::SUCCESS, reactors.back()->start());
+  }
+
+  // 和 Server::accept 一样轮流分配给各个 Reactor
+  vector<unique_ptr<Connection>> connections;
+  for (int i = 0; i < connection_num; i++) {
+    connections.push_back(create_connection());
+    ASSERT_NE(nullptr, connections.back());
+    ASSERT_EQ(RC::SUCCESS, reactors[i % reactor_num]->add(connections.back().get(), on_readable));
+    ASSERT_EQ(reactors[i % reactor_num].get(), connections.back()->reactor());
+  }
+  for (unique_ptr<Reactor> &reactor : reactors) {
+    ASSERT_EQ(connection_num / reactor_num, reactor->connection_count());
+  }
+
+  // 多个连接交替发送消息
+  for (int q = 0; q < query_num; q++) {
+    for (int i = 0; i < connection_num; i++) {
+      string query = "select " + to_string(i) + ", " + to_string(q) + ";";
+      query.push_back('\0');
+      ASSERT_EQ(static_cast<ssize_t>(query.size()), write(connections[i]->peer_fd, query.data(), query.size()));
+    }
+  }
+
+  ASSERT_TRUE(wait_for([&connections, query_num]() {
+    for (unique_ptr<Connection> &connection : connections) {
+      lock_guard<mutex> guard(connection->lock);
+      if (static_cast<int>(connection->queries.size()) < query_num) {
+        return false;
+      }
+    }
+    return true;
+  }));
+
+  // 每个连接上的消息都按照顺序收到，由负责它的 Reactor 线程接收
+  map<Reactor *, thread::id> reactor_threads;
+  for (int i = 0; i < connection_num; i++) {
+    Connection &connection = *connections[i];
+    lock_guard<mutex> guard(connection.lock);
+    ASSERT_EQ(query_num, static_cast<int>(connection.queries.size()));
+    for (int q = 0; q < query_num; q++) {
+      ASSERT_EQ("select " + to_string(i) + ", " + to_string(q) + ";", connection.queries[q]);
+    }
+
+    ASSERT_NE(this_thread::get_id(), connection.reactor_thread);
+    auto iter = reactor_threads.emplace(connection.reactor(), connection.reactor_thread).first;
+    ASSERT_EQ(iter->second, connection.reactor_thread);
+  }
+  ASSERT_EQ(reactor_num, static_cast<int>(reactor_threads.size()));
+  ASSERT_NE(reactor_threads.begin()->second, reactor_threads.rbegin()->second);
+
+  for (unique_ptr<Connection> &connection : connections) {
+    event_del(&connection->Communicator::read_event());
+    connection->reactor()->on_connection_closed();
+    close(connection->peer_fd);
+  }
+  for (unique_ptr<Reactor> &reactor : reactors) {
+    ASSERT_EQ(0, reactor->connection_count());
+    reactor->stop();
+  }
+}
+
+/**
+ * @brief 读取连接上已经到达的所有请求
+ */
+static vector<SessionEvent *> read_requests(Connection &connection, int count)
+{
+  vector<SessionEvent *> events;
+  while (static_cast<int>(events.size()) < count) {
+    SessionEvent *event = nullptr;
+    EXPECT_EQ(RC::SUCCESS, connection.read_event(event));
+    if (event == nullptr) {
+      break;
+    }
+    events.push_back(event);
+  }
+  return events;
+}
+
+TEST(reactor, close_after_pending_requests)
+{
+  unique_ptr<Connection> connection = create_connection();
+  ASSERT_NE(nullptr, connection);
+  Communicator &communicator = *connection;
+
+  const string queries("select 1;\0select 2;\0", 20);
+  ASSERT_EQ(static_cast<ssize_t>(queries.size()), write(connection->peer_fd, queries.data(), queries.size()));
+  vector<SessionEvent *> events = read_requests(*connection, 2);
+  ASSERT_EQ(2, static_cast<int>(events.size()));
+
+  // 同一个连接上同时只处理一个请求，第二个请求等待第一个处理完成
+  ASSERT_TRUE(communicator.begin_request(events[0]));
+  ASSERT_FALSE(communicator.begin_request(events[1]));
+  ASSERT_TRUE(communicator.has_waiting_requests());
+
+  // 客户端断开了连接，但是还有请求在处理，不能关闭
+  close(connection->peer_fd);
+  ASSERT_FALSE(communicator.mark_closing());
+
+  // 已经收到的请求还是要处理完
+  SessionEvent *next_event = nullptr;
+  ASSERT_FALSE(communicator.end_request(false, next_event));
+  ASSERT_EQ(events[1], next_event);
+  ASSERT_FALSE(communicator.has_waiting_requests());
+  delete events[0];
+
+  // 最后一个请求处理完成后，由它负责关闭连接
+  ASSERT_TRUE(communicator.end_request(false, next_event));
+  ASSERT_EQ(nullptr, next_event);
+  delete events[1];
+
+  // 只能关闭一次
+  ASSERT_FALSE(communicator.mark_closing());
+}
+
+TEST(reactor, disconnect_drops_waiting_requests)
+{
+  unique_ptr<Connection> connection = create_connection();
+  ASSERT_NE(nullptr, connection);
+  Communicator &communicator = *connection;
+
+  const string queries("select 1;\0select 2;\0select 3;\0", 30);
+  ASSERT_EQ(static_cast<ssize_t>(queries.size()), write(connection->peer_fd, queries.data(), queries.size()));
+  vector<SessionEvent *> events = read_requests(*connection, 3);
+  ASSERT_EQ(3, static_cast<int>(events.size()));
+
+  ASSERT_TRUE(communicator.begin_request(events[0]));
+  ASSERT_FALSE(communicator.begin_request(events[1]));
+  ASSERT_FALSE(communicator.begin_request(events[2]));
+
+  // 处理请求时发现需要断开连接，等待的请求直接丢弃(由 end_request 释放)，调用者负责关闭连接
+  SessionEvent *next_event = nullptr;
+  ASSERT_TRUE(communicator.end_request(true, next_event));
+  ASSERT_EQ(nullptr, next_event);
+  ASSERT_FALSE(communicator.has_waiting_requests());
+  ASSERT_FALSE(communicator.mark_closing());
+  delete events[0];
+
+  close(connection->peer_fd);
+}
+
+TEST(reactor, close_idle_connection)
+{
+  unique_ptr<Connection> connection = create_connection();
+  ASSERT_NE(nullptr, connection);
+
+  // 没有请求在处理，读取失败时可以立即关闭
+  close(connection->peer_fd);
+  SessionEvent *event = nullptr;
+  ASSERT_EQ(RC::IOERR_CLOSE, connection->read_event(event));
+  ASSERT_TRUE(connection->mark_closing());
+  ASSERT_FALSE(connection->mark_closing());
+}
+
+int main(int argc, char **argv)
+{
+  // 其它线程向 Reactor 的 event_base 添加事件时需要唤醒事件循环，参考 Server::serve
+  evthread_use_pthreads();
+
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
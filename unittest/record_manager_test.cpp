@@ -18,6 +18,8 @@ See the Mulan PSL v2 for more details. */
 #include "gtest/gtest.h"
 #include "storage/buffer/disk_buffer_pool.h"
 #include "storage/record/record_manager.h"
+#include "storage/common/condition_filter.h"
+#include "storage/field/field_meta.h"
 #include "storage/trx/vacuous_trx.h"
 
 using namespace common;
@@ -104,7 +106,20 @@ TEST(test_record_page_handler, test_record_page_handler)
   }
   ASSERT_EQ(count, 6);
 
+  const PageNum page_num = frame->page_num();
   record_page_handle.cleanup();
+
+  // 其它版本写入的页面不能访问
+  PageHeader *page_header = reinterpret_cast<PageHeader *>(frame->data());
+  ASSERT_EQ(PageHeader::MAGIC, page_header->magic);
+  ASSERT_EQ(PageHeader::VERSION, page_header->version);
+  page_header->version = PageHeader::VERSION - 1;
+  ASSERT_EQ(RC::FILE_VERSION_MISMATCH, record_page_handle.init(*bp, page_num, true /*readonly*/));
+  ASSERT_EQ(RC::FILE_VERSION_MISMATCH, record_page_handle.init(*bp, page_num, false /*readonly*/));
+  page_header->version = PageHeader::VERSION;
+  ASSERT_EQ(RC::SUCCESS, record_page_handle.init(*bp, page_num, true /*readonly*/));
+  record_page_handle.cleanup();
+
   bpm->close_file(record_manager_file);
   delete bpm;
 }
@@ -184,6 +199,347 @@ TEST(test_record_page_handler, test_record_file_iterator)
   delete bpm;
 }
 
+TEST(test_record_page_handler, test_stale_page_version)
+{
+  const char *record_manager_file = "record_manager.bp";
+  ::remove(record_manager_file);
+
+  BufferPoolManager *bpm = new BufferPoolManager();
+  DiskBufferPool *bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm->create_file(record_manager_file));
+  ASSERT_EQ(RC::SUCCESS, bpm->open_file(record_manager_file, bp));
+
+  RecordFileHandler file_handler;
+  ASSERT_EQ(RC::SUCCESS, file_handler.init(bp));
+  char record_data[20];
+  memset(record_data, 0, sizeof(record_data));
+  RID rid;
+  ASSERT_EQ(RC::SUCCESS, file_handler.insert_record(record_data, sizeof(record_data), &rid));
+  file_handler.close();
+
+  // 模拟其它版本写入的页面
+  Frame *frame = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bp->get_this_page(rid.page_num, &frame));
+  PageHeader *page_header = reinterpret_cast<PageHeader *>(frame->data());
+  page_header->version = PageHeader::VERSION + 1;
+  frame->mark_dirty();
+  ASSERT_EQ(RC::SUCCESS, bp->unpin_page(frame));
+  ASSERT_EQ(RC::SUCCESS, bpm->close_file(record_manager_file));
+
+  ASSERT_EQ(RC::SUCCESS, bpm->open_file(record_manager_file, bp));
+  RecordFileHandler stale_handler;
+  ASSERT_EQ(RC::FILE_VERSION_MISMATCH, stale_handler.init(bp));
+
+  bpm->close_file(record_manager_file);
+  delete bpm;
+}
+
+TEST(test_record_page_handler, test_typed_condition_filter)
+{
+  const char *record_manager_file = "record_manager_filter.bp";
+  ::remove(record_manager_file);
+
+  BufferPoolManager *bpm = new BufferPoolManager();
+  DiskBufferPool *bp = nullptr;
+  RC rc = bpm->create_file(record_manager_file);
+  ASSERT_EQ(rc, RC::SUCCESS);
+  
+  rc = bpm->open_file(record_manager_file, bp);
+  ASSERT_EQ(rc, RC::SUCCESS);
+
+  RecordFileHandler file_handler;
+  rc = file_handler.init(bp);
+  ASSERT_EQ(rc, RC::SUCCESS);
+
+  // 记录格式: int id, float score, char name[8]
+  const int record_insert_num = 1000;
+  char record_data[16];
+  for (int i = 0; i < record_insert_num; i++) {
+    memset(record_data, 0, sizeof(record_data));
+    float score = i / 10.0f;
+    memcpy(record_data, &i, sizeof(i));
+    memcpy(record_data + 4, &score, sizeof(score));
+    snprintf(record_data + 8, 8, "n%d", i % 10);
+
+    RID rid;
+    rc = file_handler.insert_record(record_data, sizeof(record_data), &rid);
+    ASSERT_EQ(rc, RC::SUCCESS);
+  }
+
+  FieldMeta id_field("id", INTS, 0, 4, true);
+  FieldMeta score_field("score", FLOATS, 4, 4, true);
+  FieldMeta name_field("name", CHARS, 8, 8, true);
+
+  auto count_records = [&](TypedConditionFilter &filter) {
+    VacuousTrx trx;
+    RecordFileScanner file_scanner;
+    RC rc = file_scanner.open_scan(nullptr/*table*/, *bp, &trx, true/*readonly*/, &filter);
+    EXPECT_EQ(rc, RC::SUCCESS);
+
+    int count = 0;
+    Record record;
+    while (file_scanner.has_next()) {
+      rc = file_scanner.next(record);
+      EXPECT_EQ(rc, RC::SUCCESS);
+      count++;
+    }
+    file_scanner.close_scan();
+    return count;
+  };
+
+  TypedConditionFilter filter;
+  ASSERT_EQ(RC::SUCCESS, filter.add_condition(id_field, GREAT_EQUAL, Value(100)));
+  ASSERT_EQ(RC::SUCCESS, filter.add_condition(id_field, LESS_THAN, Value(200)));
+  ASSERT_EQ(count_records(filter), 100);
+
+  ASSERT_EQ(RC::SUCCESS, filter.add_condition(name_field, EQUAL_TO, Value("n3")));
+  ASSERT_EQ(count_records(filter), 10);
+
+  filter.clear();
+  ASSERT_EQ(RC::SUCCESS, filter.add_condition(score_field, GREAT_THAN, Value(90.0f)));
+  ASSERT_EQ(RC::SUCCESS, filter.add_condition(name_field, NOT_EQUAL, Value("n1")));
+  ASSERT_EQ(count_records(filter), 89);
+
+  // 类型不同和 LIKE 不在页面上计算
+  ASSERT_NE(RC::SUCCESS, filter.add_condition(id_field, EQUAL_TO, Value(1.0f)));
+  ASSERT_NE(RC::SUCCESS, filter.add_condition(name_field, LIKE_OP, Value("n%")));
+  ASSERT_EQ(filter.condition_num(), 2);
+
+  bpm->close_file(record_manager_file);
+  delete bpm;
+}
+
+TEST(test_record_page_handler, test_pax_record_file)
+{
+  const char *record_manager_file = "record_manager_pax.bp";
+  ::remove(record_manager_file);
+
+  BufferPoolManager *bpm = new BufferPoolManager();
+  DiskBufferPool *bp = nullptr;
+  RC rc = bpm->create_file(record_manager_file);
+  ASSERT_EQ(rc, RC::SUCCESS);
+  
+  rc = bpm->open_file(record_manager_file, bp);
+  ASSERT_EQ(rc, RC::SUCCESS);
+
+  // 记录格式: int id, float score, char name[8]
+  std::vector<FieldMeta> fields;
+  fields.emplace_back("id", INTS, 0, 4, true);
+  fields.emplace_back("score", FLOATS, 4, 4, true);
+  fields.emplace_back("name", CHARS, 8, 8, true);
+
+  RecordFileHandler file_handler;
+  rc = file_handler.init(bp, PAX_FORMAT, &fields);
+  ASSERT_EQ(rc, RC::SUCCESS);
+
+  auto make_record = [](int i, char *record_data) {
+    memset(record_data, 0, 16);
+    float score = i / 10.0f;
+    memcpy(record_data, &i, sizeof(i));
+    memcpy(record_data + 4, &score, sizeof(score));
+    snprintf(record_data + 8, 8, "n%d", i % 10);
+  };
+
+  const int record_insert_num = 1000;
+  char record_data[16];
+  std::vector<RID> rids;
+  for (int i = 0; i < record_insert_num; i++) {
+    make_record(i, record_data);
+    RID rid;
+    rc = file_handler.insert_record(record_data, sizeof(record_data), &rid);
+    ASSERT_EQ(rc, RC::SUCCESS);
+    rids.push_back(rid);
+  }
+
+  // 按照RID读取的记录与插入的一样
+  for (int i = 0; i < record_insert_num; i++) {
+    make_record(i, record_data);
+    RecordPageHandler page_handler;
+    Record record;
+    rc = file_handler.get_record(page_handler, &rids[i], true/*readonly*/, &record);
+    ASSERT_EQ(rc, RC::SUCCESS);
+    ASSERT_EQ(0, memcmp(record.data(), record_data, sizeof(record_data)));
+  }
+
+  auto count_records = [&](ConditionFilter *filter) {
+    VacuousTrx trx;
+    RecordFileScanner file_scanner;
+    RC rc = file_scanner.open_scan(nullptr/*table*/, *bp, &trx, true/*readonly*/, filter);
+    EXPECT_EQ(rc, RC::SUCCESS);
+
+    int count = 0;
+    Record record;
+    while (file_scanner.has_next()) {
+      rc = file_scanner.next(record);
+      EXPECT_EQ(rc, RC::SUCCESS);
+      int id = *(const int *)record.data();
+      char expected[16];
+      make_record(id, expected);
+      EXPECT_EQ(0, memcmp(record.data(), expected, sizeof(expected)));
+      count++;
+    }
+    file_scanner.close_scan();
+    return count;
+  };
+
+  ASSERT_EQ(count_records(nullptr), record_insert_num);
+
+  TypedConditionFilter filter;
+  ASSERT_EQ(RC::SUCCESS, filter.add_condition(fields[0], GREAT_EQUAL, Value(100)));
+  ASSERT_EQ(RC::SUCCESS, filter.add_condition(fields[0], LESS_THAN, Value(200)));
+  ASSERT_EQ(count_records(&filter), 100);
+  ASSERT_EQ(RC::SUCCESS, filter.add_condition(fields[2], EQUAL_TO, Value("n3")));
+  ASSERT_EQ(count_records(&filter), 10);
+
+  for (int i = 0; i < record_insert_num; i += 2) {
+    rc = file_handler.delete_record(&rids[i]);
+    ASSERT_EQ(rc, RC::SUCCESS);
+  }
+  ASSERT_EQ(count_records(nullptr), record_insert_num / 2);
+
+  // 以写模式访问的记录，修改后会写回页面
+  rc = file_handler.visit_record(rids[1], false/*readonly*/, [](Record &record) {
+    snprintf(record.data() + 8, 8, "x");
+  });
+  ASSERT_EQ(rc, RC::SUCCESS);
+  rc = file_handler.visit_record(rids[1], true/*readonly*/, [](Record &record) {
+    EXPECT_STREQ(record.data() + 8, "x");
+    EXPECT_EQ(*(const int *)record.data(), 1);
+  });
+  ASSERT_EQ(rc, RC::SUCCESS);
+
+  bpm->close_file(record_manager_file);
+  delete bpm;
+}
+
+TEST(test_record_page_handler, test_varlen_record_file)
+{
+  const char *record_manager_file = "record_manager_varlen.bp";
+  ::remove(record_manager_file);
+
+  BufferPoolManager *bpm = new BufferPoolManager();
+  DiskBufferPool *bp = nullptr;
+  RC rc = bpm->create_file(record_manager_file);
+  ASSERT_EQ(rc, RC::SUCCESS);
+
+  rc = bpm->open_file(record_manager_file, bp);
+  ASSERT_EQ(rc, RC::SUCCESS);
+
+  // 记录格式: int id, varchar name(200)
+  const int record_size = 204;
+  std::vector<FieldMeta> fields;
+  fields.emplace_back("id", INTS, 0, 4, true);
+  fields.emplace_back("name", CHARS, 4, 200, true, true /*var_len*/);
+
+  RecordFileHandler file_handler;
+  rc = file_handler.init(bp, ROW_FORMAT, &fields);
+  ASSERT_EQ(rc, RC::SUCCESS);
+
+  auto make_record = [](int i, int name_len, char *record_data) {
+    memset(record_data, 0, record_size);
+    memcpy(record_data, &i, sizeof(i));
+    memset(record_data + 4, 'a' + i % 26, name_len);
+  };
+
+  const int record_insert_num = 1000;
+  char record_data[record_size];
+  std::vector<RID> rids;
+  for (int i = 0; i < record_insert_num; i++) {
+    make_record(i, i % 8, record_data);
+    RID rid;
+    rc = file_handler.insert_record(record_data, sizeof(record_data), &rid);
+    ASSERT_EQ(rc, RC::SUCCESS);
+    rids.push_back(rid);
+  }
+
+  // 短记录按照实际长度存放，一个页面可以放下远多于定长时的记录数
+  SlotNum max_slot_num = 0;
+  for (const RID &rid : rids) {
+    max_slot_num = std::max(max_slot_num, rid.slot_num);
+  }
+  ASSERT_GT(max_slot_num, BP_PAGE_DATA_SIZE / record_size);
+
+  auto check_record = [&](int i, int name_len) {
+    char expected[record_size];
+    make_record(i, name_len, expected);
+    RecordPageHandler page_handler;
+    Record record;
+    RC rc = file_handler.get_record(page_handler, &rids[i], true/*readonly*/, &record);
+    EXPECT_EQ(rc, RC::SUCCESS);
+    EXPECT_EQ(0, memcmp(record.data(), expected, record_size));
+  };
+
+  for (int i = 0; i < record_insert_num; i++) {
+    check_record(i, i % 8);
+  }
+
+  auto count_records = [&]() {
+    VacuousTrx trx;
+    RecordFileScanner file_scanner;
+    RC rc = file_scanner.open_scan(nullptr/*table*/, *bp, &trx, true/*readonly*/, nullptr);
+    EXPECT_EQ(rc, RC::SUCCESS);
+
+    int count = 0;
+    Record record;
+    while (file_scanner.has_next()) {
+      rc = file_scanner.next(record);
+      EXPECT_EQ(rc, RC::SUCCESS);
+      count++;
+    }
+    file_scanner.close_scan();
+    return count;
+  };
+
+  ASSERT_EQ(count_records(), record_insert_num);
+
+  // 记录变长以后，页面放不下的会搬到溢出页面，RID保持不变
+  for (int i = 0; i < record_insert_num; i += 3) {
+    rc = file_handler.visit_record(rids[i], false/*readonly*/, [i, &make_record](Record &record) {
+      make_record(i, 199, record.data());
+    });
+    ASSERT_EQ(rc, RC::SUCCESS);
+  }
+  for (int i = 0; i < record_insert_num; i++) {
+    check_record(i, i % 3 == 0 ? 199 : i % 8);
+  }
+  ASSERT_EQ(count_records(), record_insert_num);
+
+  // 持有页面写锁时用 update_record 立即写回，参考 Table::update_record
+  auto name_len_of = [](int i) { return i % 3 == 0 ? 199 : (i % 3 == 1 ? 150 : i % 8); };
+  for (int i = 1; i < record_insert_num; i += 3) {
+    RC update_rc = RC::INTERNAL;
+    rc = file_handler.visit_record(rids[i], false/*readonly*/, [&, i](Record &record) {
+      make_record(i, 150, record.data());
+      update_rc = file_handler.update_record(record);
+    });
+    ASSERT_EQ(rc, RC::SUCCESS);
+    ASSERT_EQ(update_rc, RC::SUCCESS);
+  }
+  for (int i = 0; i < record_insert_num; i++) {
+    check_record(i, name_len_of(i));
+  }
+  ASSERT_EQ(count_records(), record_insert_num);
+
+  // 再变短，并删除一部分记录
+  for (int i = 0; i < record_insert_num; i += 3) {
+    rc = file_handler.visit_record(rids[i], false/*readonly*/, [i, &make_record](Record &record) {
+      make_record(i, 1, record.data());
+    });
+    ASSERT_EQ(rc, RC::SUCCESS);
+  }
+  for (int i = 0; i < record_insert_num; i += 2) {
+    rc = file_handler.delete_record(&rids[i]);
+    ASSERT_EQ(rc, RC::SUCCESS);
+  }
+  for (int i = 1; i < record_insert_num; i += 2) {
+    check_record(i, i % 3 == 0 ? 1 : name_len_of(i));
+  }
+  ASSERT_EQ(count_records(), record_insert_num / 2);
+
+  bpm->close_file(record_manager_file);
+  delete bpm;
+}
+
 int main(int argc, char **argv)
 {
   // 分析gtest程序的命令行参数
@@ -0,0 +1,135 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// 语句摘要文本的生成和按照摘要汇总统计(StatementDigests)的测试
+//
+
+#include <thread>
+#include <vector>
+
+#include "common/mm/arena.h"
+#include "session/statement_digest.h"
+#include "sql/parser/parse.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+static string digest_text_of(const char *sql)
+{
+  common::Arena   arena;
+  ParsedSqlResult result;
+  parse(sql, &result, arena);
+  return result.digest_text();
+}
+
+TEST(statement_digest, digest_text)
+{
+  ASSERT_EQ("select * from t where id = ?", digest_text_of("select * from t where id = 1;"));
+  ASSERT_EQ(digest_text_of("select * from t where id = 1;"), digest_text_of("SELECT *\n  FROM t WHERE id=-25"));
+  ASSERT_EQ("select t.id, t.name from t where t.score > ? and name <> ?",
+      digest_text_of("select t.id, t.name from t where t.score > 2.5 and name <> 'abc';"));
+  ASSERT_EQ("update t set d = ? where id = ?", digest_text_of("update t set d = '2023-01-01' where id = 3"));
+
+  // 插入行数不同的语句有相同的摘要文本
+  ASSERT_EQ("insert into t values (?, ?)", digest_text_of("insert into t values (1, 'a');"));
+  ASSERT_EQ("insert into t values (?, ?), ...", digest_text_of("insert into t values (1, 'a'), (2, 'b');"));
+  ASSERT_EQ(digest_text_of("insert into t values (1, 'a'), (2, 'b');"),
+      digest_text_of("insert into t values (1, 'a'), (2, 'b'), (3, \"c\");"));
+
+  // 语法错误的语句也包含完整的内容
+  ASSERT_EQ("selec * from t where id = ?", digest_text_of("selec * from t where id = 1"));
+}
+
+TEST(statement_digest, latency_bucket)
+{
+  int last_bucket = 0;
+  for (int64_t latency = 0; latency < 100000; latency++) {
+    const int bucket = StatementDigestStats::latency_bucket(latency);
+    ASSERT_GE(bucket, last_bucket);
+    ASSERT_LE(latency, StatementDigestStats::bucket_upper_bound(bucket));
+    // 同一个桶中最大值和最小值相差不超过25%
+    ASSERT_LE(StatementDigestStats::bucket_upper_bound(bucket), latency + latency / 4 + 1);
+    last_bucket = bucket;
+  }
+  ASSERT_EQ(StatementDigestStats::LATENCY_BUCKET_NUM - 1, StatementDigestStats::latency_bucket(INT64_MAX));
+}
+
+TEST(statement_digest, record_and_reset)
+{
+  StatementDigests &digests = StatementDigests::instance();
+  digests.reset();
+
+  StatementCounters counters;
+  counters.rows_examined = 10;
+  counters.rows_returned = 1;
+
+  // 多个线程记录同一类语句，延迟从1微秒到1000微秒
+  const int thread_num = 4;
+  vector<thread> threads;
+  for (int t = 0; t < thread_num; t++) {
+    threads.emplace_back([&digests, &counters]() {
+      for (int i = 1; i <= 1000; i++) {
+        digests.record("select * from t where id = ?", i * 1000, counters);
+      }
+    });
+  }
+  for (thread &t : threads) {
+    t.join();
+  }
+  digests.record("select count (*) from t", 5000, StatementCounters());
+
+  vector<StatementDigestStats::Snapshot> snapshots = digests.snapshot();
+  ASSERT_EQ(2, static_cast<int>(snapshots.size()));
+  const StatementDigestStats::Snapshot &snapshot =
+      snapshots[0].digest_text == "select * from t where id = ?" ? snapshots[0] : snapshots[1];
+  ASSERT_EQ(StatementDigests::digest_of("select * from t where id = ?"), snapshot.digest);
+  ASSERT_EQ(thread_num * 1000, snapshot.exec_count);
+  ASSERT_EQ(thread_num * 500500LL * 1000, snapshot.total_latency_ns);
+  ASSERT_EQ(1000, snapshot.min_latency_ns);
+  ASSERT_EQ(1000000, snapshot.max_latency_ns);
+  ASSERT_EQ(thread_num * 10000, snapshot.rows_examined);
+  ASSERT_EQ(thread_num * 1000, snapshot.rows_returned);
+  ASSERT_GE(snapshot.p95_latency_ns, 950000);
+  ASSERT_LE(snapshot.p95_latency_ns, 950000 * 5 / 4);
+  ASSERT_GE(snapshot.p99_latency_ns, 990000);
+  ASSERT_LE(snapshot.p99_latency_ns, 1000000);
+
+  digests.reset();
+  ASSERT_TRUE(digests.snapshot().empty());
+}
+
+TEST(statement_digest, max_digest_num)
+{
+  StatementDigests &digests = StatementDigests::instance();
+  digests.reset();
+
+  // 超出上限的语句都记录在摘要文本为空的统计中
+  const int overflow = 10;
+  for (int i = 0; i < StatementDigests::MAX_DIGEST_NUM + overflow; i++) {
+    digests.record("select * from t" + to_string(i), 1000, StatementCounters());
+  }
+
+  vector<StatementDigestStats::Snapshot> snapshots = digests.snapshot();
+  ASSERT_EQ(StatementDigests::MAX_DIGEST_NUM + 1, static_cast<int>(snapshots.size()));
+  for (const StatementDigestStats::Snapshot &snapshot : snapshots) {
+    if (snapshot.digest == StatementDigests::OVERFLOW_DIGEST) {
+      ASSERT_TRUE(snapshot.digest_text.empty());
+      ASSERT_EQ(overflow, snapshot.exec_count);
+    }
+  }
+  digests.reset();
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,118 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// 表统计信息(NDV估算、直方图)的测试
+//
+
+#include <string.h>
+#include <sstream>
+
+#include "common/math/hyperloglog.h"
+#include "storage/field/field_meta.h"
+#include "storage/record/record.h"
+#include "storage/table/table_stats.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+using namespace common;
+
+TEST(test_table_stats, test_hyperloglog)
+{
+  HyperLogLog hll;
+  const int count = 100000;
+  for (int i = 0; i < count; i++) {
+    hll.add(&i, sizeof(i));
+    hll.add(&i, sizeof(i));  // 重复的值不影响结果
+  }
+  ASSERT_NEAR(count, hll.estimate(), count * 0.05);
+
+  hll.clear();
+  ASSERT_EQ(0, static_cast<int>(hll.estimate()));
+  for (int i = 0; i < 10; i++) {
+    hll.add(&i, sizeof(i));
+  }
+  ASSERT_NEAR(10, hll.estimate(), 1);
+}
+
+static unique_ptr<TableStats> collect(const FieldMeta &field, int count, int total_pages, int sampled_pages)
+{
+  vector<const FieldMeta *> fields{&field};
+  TableStatsCollector collector(fields);
+  for (int i = 0; i < count; i++) {
+    int v = i % 100;  // 0..99，均匀分布
+    Record record;
+    record.set_data(reinterpret_cast<char *>(&v), sizeof(v));
+    collector.add(record);
+  }
+  return collector.finish(total_pages, sampled_pages);
+}
+
+TEST(test_table_stats, test_selectivity)
+{
+  FieldMeta field("id", INTS, 0, 4, true);
+  unique_ptr<TableStats> table_stats = collect(field, 10000, 4, 2);
+
+  // 只采样了一半的页面
+  ASSERT_EQ(20000, table_stats->row_count());
+
+  const ColumnStats *column = table_stats->column("id");
+  ASSERT_NE(nullptr, column);
+  ASSERT_EQ(nullptr, table_stats->column("no_such_column"));
+  ASSERT_NEAR(100, column->ndv(), 5);
+  ASSERT_EQ(0, column->min_value().get_int());
+  ASSERT_EQ(99, column->max_value().get_int());
+
+  Value v10(10);
+  Value v50(50);
+  Value v200(200);
+  ASSERT_NEAR(0.01, column->equal_selectivity(v50), 0.002);
+  ASSERT_EQ(0, column->equal_selectivity(v200));
+
+  ASSERT_NEAR(0.4, column->range_selectivity(&v10, true, &v50, false), 0.05);
+  ASSERT_NEAR(0.5, column->range_selectivity(&v50, true, nullptr, false), 0.05);
+  ASSERT_NEAR(0.1, column->range_selectivity(nullptr, false, &v10, false), 0.05);
+  ASSERT_EQ(0, column->range_selectivity(&v200, true, nullptr, false));
+}
+
+TEST(test_table_stats, test_serialize)
+{
+  FieldMeta field("id", INTS, 0, 4, true);
+  unique_ptr<TableStats> table_stats = collect(field, 1000, 1, 1);
+  table_stats->set_row_count(1234);
+
+  stringstream ss;
+  ASSERT_LT(0, table_stats->serialize(ss));
+
+  TableStats restored;
+  ASSERT_LT(0, restored.deserialize(ss));
+  ASSERT_EQ(1234, restored.row_count());
+
+  const ColumnStats *column = restored.column("id");
+  ASSERT_NE(nullptr, column);
+  const ColumnStats *origin = table_stats->column("id");
+  ASSERT_EQ(origin->ndv(), column->ndv());
+  ASSERT_EQ(origin->min_value().get_int(), column->min_value().get_int());
+  ASSERT_EQ(origin->max_value().get_int(), column->max_value().get_int());
+
+  Value v30(30);
+  ASSERT_EQ(origin->equal_selectivity(v30), column->equal_selectivity(v30));
+  ASSERT_EQ(origin->range_selectivity(&v30, true, nullptr, false), column->range_selectivity(&v30, true, nullptr, false));
+}
+
+int main(int argc, char **argv)
+{
+  // 分析gtest程序的命令行参数
+  testing::InitGoogleTest(&argc, argv);
+
+  // 调用RUN_ALL_TESTS()运行所有测试用例
+  // main函数返回RUN_ALL_TESTS()的运行结果
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,168 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// 工作窃取线程池(Threadpool)的测试
+// 唤醒丢失时任务会一直留在队列中，等待超时就认为测试失败。
+// 销毁线程池也要唤醒线程，所以失败时直接返回，不销毁线程池
+//
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "common/log/log.h"
+#include "common/seda/thread_pool.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+using namespace common;
+
+static const chrono::seconds WAIT_TIMEOUT(20);
+
+static bool wait_for(const atomic<int64_t> &counter, int64_t target)
+{
+  const auto deadline = chrono::steady_clock::now() + WAIT_TIMEOUT;
+  while (counter.load(memory_order_acquire) < target) {
+    if (chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+    this_thread::yield();
+  }
+  return true;
+}
+
+class CountTask : public Runnable
+{
+public:
+  void run() override { counter.fetch_add(1, memory_order_release); }
+
+  atomic<int64_t> counter{0};
+};
+
+/**
+ * @brief 在线程池的线程中提交子任务，子任务放在当前线程自己的队列中，需要其它线程窃取
+ */
+class SpawnTask : public Runnable
+{
+public:
+  SpawnTask(Threadpool &pool, int64_t target) : pool_(pool), target_(target) {}
+
+  void run() override
+  {
+    int64_t spawned = spawned_.fetch_add(2, memory_order_relaxed);
+    for (int64_t i = spawned; i < spawned + 2 && i < target_; i++) {
+      pool_.execute(this);
+    }
+    finished.fetch_add(1, memory_order_release);
+  }
+
+  atomic<int64_t> finished{0};
+
+private:
+  Threadpool     &pool_;
+  int64_t         target_;
+  atomic<int64_t> spawned_{1};
+};
+
+/**
+ * @brief 所有任务都开始运行之后才结束，只有每个任务都唤醒了一个线程才能完成
+ */
+class RendezvousTask : public Runnable
+{
+public:
+  RendezvousTask(Threadpool &pool, int64_t task_num) : pool_(pool), task_num_(task_num) {}
+
+  void run() override
+  {
+    // 第一个任务在工作线程中提交其它任务，它们都放在当前线程的队列里
+    if (started.fetch_add(1, memory_order_acq_rel) == 0) {
+      for (int64_t i = 1; i < task_num_; i++) {
+        pool_.execute(this);
+      }
+    }
+    const auto deadline = chrono::steady_clock::now() + WAIT_TIMEOUT;
+    while (started.load(memory_order_acquire) < task_num_ && chrono::steady_clock::now() < deadline) {
+      this_thread::yield();
+    }
+    finished.fetch_add(1, memory_order_release);
+  }
+
+  atomic<int64_t> started{0};
+  atomic<int64_t> finished{0};
+
+private:
+  Threadpool &pool_;
+  int64_t     task_num_;
+};
+
+class ThreadPoolTest : public testing::Test
+{
+protected:
+  static void SetUpTestSuite()
+  {
+    LoggerFactory::init_default("thread_pool_test.log", LOG_LEVEL_WARN);
+    Threadpool::create_pool_key();
+  }
+};
+
+TEST_F(ThreadPoolTest, execute_from_outside)
+{
+  Threadpool *pool = new Threadpool(4, "TestThreads");
+  CountTask   task;
+
+  // 每次只提交一个任务，线程大多是空闲的，每个任务都要唤醒一个线程
+  for (int64_t i = 1; i <= 2000; i++) {
+    pool->execute(&task);
+    ASSERT_TRUE(wait_for(task.counter, i)) << "lost wakeup at task " << i;
+  }
+
+  // 一次提交一批
+  for (int round = 1; round <= 20; round++) {
+    for (int i = 0; i < 1000; i++) {
+      pool->execute(&task);
+    }
+    ASSERT_TRUE(wait_for(task.counter, 2000 + round * 1000)) << "lost wakeup in round " << round;
+  }
+  delete pool;
+}
+
+TEST_F(ThreadPoolTest, execute_from_workers)
+{
+  Threadpool *pool = new Threadpool(4, "TestThreads");
+  for (int round = 0; round < 20; round++) {
+    const int64_t target = 10000;
+    SpawnTask task(*pool, target);
+    pool->execute(&task);
+    ASSERT_TRUE(wait_for(task.finished, target)) << "lost wakeup in round " << round;
+  }
+  delete pool;
+}
+
+TEST_F(ThreadPoolTest, wakeup_one_for_each_task)
+{
+  // 任务会一直占着线程，直到所有任务都开始运行。某个任务没有唤醒空闲线程的话，
+  // 它会一直留在第一个线程的队列中，所有任务都只能等到超时
+  const int thread_num = 4;
+  Threadpool *pool = new Threadpool(thread_num, "TestThreads");
+  for (int round = 0; round < 200; round++) {
+    RendezvousTask task(*pool, thread_num);
+    pool->execute(&task);
+    ASSERT_TRUE(wait_for(task.finished, thread_num)) << "lost wakeup in round " << round;
+    ASSERT_EQ(thread_num, task.started.load()) << "lost wakeup in round " << round;
+  }
+  delete pool;
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
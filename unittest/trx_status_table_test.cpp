@@ -0,0 +1,72 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// 事务状态表的测试
+//
+
+#include <thread>
+#include <vector>
+
+#include "storage/trx/trx_status_table.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+TEST(trx_status_table, status)
+{
+  TrxStatusTable status_table;
+  ASSERT_EQ(TrxStatusTable::IN_PROGRESS, status_table.commit_xid(1));
+  ASSERT_EQ(TrxStatusTable::IN_PROGRESS, status_table.commit_xid(0));
+  ASSERT_EQ(TrxStatusTable::IN_PROGRESS, status_table.commit_xid(INT32_MAX));
+
+  status_table.set_committed(1, 3);
+  status_table.set_aborted(2);
+  ASSERT_EQ(3, status_table.commit_xid(1));
+  ASSERT_EQ(TrxStatusTable::ABORTED, status_table.commit_xid(2));
+  ASSERT_EQ(TrxStatusTable::IN_PROGRESS, status_table.commit_xid(4));
+
+  // 跨越多个段
+  status_table.set_committed(1 << 20, (1 << 20) + 1);
+  status_table.set_committed(INT32_MAX - 1, INT32_MAX);
+  ASSERT_EQ((1 << 20) + 1, status_table.commit_xid(1 << 20));
+  ASSERT_EQ(INT32_MAX, status_table.commit_xid(INT32_MAX - 1));
+  ASSERT_EQ(TrxStatusTable::IN_PROGRESS, status_table.commit_xid((1 << 20) - 1));
+}
+
+TEST(trx_status_table, concurrency)
+{
+  TrxStatusTable status_table;
+  const int thread_num = 4;
+  const int trx_num    = 200000;
+
+  vector<thread> threads;
+  for (int t = 0; t < thread_num; t++) {
+    threads.emplace_back([&status_table, t]() {
+      for (int32_t trx_id = t + 1; trx_id <= trx_num; trx_id += thread_num) {
+        status_table.set_committed(trx_id, trx_id + 1);
+        ASSERT_EQ(trx_id + 1, status_table.commit_xid(trx_id));
+      }
+    });
+  }
+  for (thread &t : threads) {
+    t.join();
+  }
+
+  for (int32_t trx_id = 1; trx_id <= trx_num; trx_id++) {
+    ASSERT_EQ(trx_id + 1, status_table.commit_xid(trx_id));
+  }
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,89 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// 原地更新的旧版本(UndoLog)的测试
+//
+
+#include <string.h>
+
+#include "storage/trx/undo_log.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+TEST(undo_log, version_chain)
+{
+  UndoLog undo_log;
+  Table  *table = reinterpret_cast<Table *>(0x1000);  // 只作为键值使用
+  const RID rid1(1, 0);
+  const RID rid2(1, 1);
+  const RID rid3(2, 0);
+
+  ASSERT_EQ(nullptr, undo_log.newest(table, rid1));
+  ASSERT_FALSE(undo_log.has_versions(table, 1));
+
+  UndoRecord *v1 = undo_log.append(table, rid1, 10, "aaaa", 4);
+  UndoRecord *v2 = undo_log.append(table, rid1, 11, "bbbb", 4);
+  UndoRecord *v3 = undo_log.append(table, rid2, 12, "cccc", 4);
+  undo_log.append(table, rid3, 13, "dddd", 4);
+
+  const UndoRecord *newest = undo_log.newest(table, rid1);
+  ASSERT_EQ(v2, newest);
+  ASSERT_EQ(v1, newest->older);
+  ASSERT_EQ(0, memcmp(newest->older->data.data(), "aaaa", 4));
+  ASSERT_TRUE(undo_log.has_versions(table, 1));
+  ASSERT_TRUE(undo_log.has_versions(table, 2));
+  ASSERT_FALSE(undo_log.has_versions(table, 3));
+
+  // 回滚
+  undo_log.remove(v2);
+  ASSERT_EQ(v1, undo_log.newest(table, rid1));
+  undo_log.remove(v3);
+  ASSERT_EQ(nullptr, undo_log.newest(table, rid2));
+  ASSERT_TRUE(undo_log.has_versions(table, 1));
+
+  vector<UndoRecord *> undos;
+  undo_log.find_newest([](const UndoRecord &undo) { return undo.trx_id == 13; }, undos);
+  ASSERT_EQ(1, static_cast<int>(undos.size()));
+  ASSERT_EQ(rid3, undos[0]->rid);
+
+  // 释放两个回滚的版本，以及 trx_id 小于13的版本
+  ASSERT_EQ(3, undo_log.purge([](const UndoRecord &undo) { return undo.trx_id < 13; }));
+  ASSERT_EQ(nullptr, undo_log.newest(table, rid1));
+  ASSERT_FALSE(undo_log.has_versions(table, 1));
+  ASSERT_TRUE(undo_log.has_versions(table, 2));
+}
+
+TEST(undo_log, purge_older_versions)
+{
+  UndoLog undo_log;
+  Table  *table = reinterpret_cast<Table *>(0x1000);
+  const RID rid(1, 0);
+
+  for (int i = 1; i <= 10; i++) {
+    undo_log.append(table, rid, i, "xxxx", 4);
+  }
+
+  // 新的版本还需要保留，更早的版本都释放掉
+  ASSERT_EQ(6, undo_log.purge([](const UndoRecord &undo) { return undo.trx_id <= 6; }));
+  int versions = 0;
+  for (const UndoRecord *undo = undo_log.newest(table, rid); undo != nullptr; undo = undo->older) {
+    ASSERT_GT(undo->trx_id, 6);
+    versions++;
+  }
+  ASSERT_EQ(4, versions);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,166 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// 工作窃取队列(WorkStealingQueue)的测试
+//
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "common/seda/work_stealing_queue.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+using namespace common;
+
+TEST(work_stealing_queue, owner_and_thief_order)
+{
+  WorkStealingQueue<int *> queue(4);
+  vector<int> items(100);
+  ASSERT_TRUE(queue.empty());
+  ASSERT_EQ(nullptr, queue.pop());
+  ASSERT_EQ(nullptr, queue.steal());
+
+  // 超过初始容量时扩容，已有的元素不会丢失
+  for (int i = 0; i < 100; i++) {
+    items[i] = i;
+    queue.push(&items[i]);
+  }
+  ASSERT_EQ(100, queue.size());
+
+  // 所有者从底部取最新的，窃取者从顶部取最旧的
+  ASSERT_EQ(&items[99], queue.pop());
+  ASSERT_EQ(&items[0], queue.steal());
+  ASSERT_EQ(&items[98], queue.pop());
+  ASSERT_EQ(&items[1], queue.steal());
+  ASSERT_EQ(96, queue.size());
+
+  for (int i = 97; i >= 2; i--) {
+    ASSERT_EQ(&items[i], queue.pop());
+  }
+  ASSERT_TRUE(queue.empty());
+  ASSERT_EQ(nullptr, queue.pop());
+  ASSERT_EQ(nullptr, queue.steal());
+
+  // 取空之后还可以继续使用
+  queue.push(&items[5]);
+  ASSERT_EQ(&items[5], queue.steal());
+  ASSERT_TRUE(queue.empty());
+}
+
+TEST(work_stealing_queue, concurrent_steal)
+{
+  // 所有者一边放入一边取出，多个窃取者同时窃取，每个元素恰好被取走一次
+  const int item_num   = 200000;
+  const int thief_num  = 3;
+  vector<int>         items(item_num);
+  vector<atomic<int>> taken(item_num);
+  for (int i = 0; i < item_num; i++) {
+    items[i] = i;
+    taken[i].store(0);
+  }
+
+  WorkStealingQueue<int *> queue(16);
+  atomic<bool> done{false};
+  atomic<int>  stolen{0};
+  vector<thread> thieves;
+  for (int t = 0; t < thief_num; t++) {
+    thieves.emplace_back([&]() {
+      while (true) {
+        int *item = queue.steal();
+        if (item != nullptr) {
+          taken[*item]++;
+          stolen++;
+        } else if (done.load() && queue.empty()) {
+          break;
+        }
+      }
+    });
+  }
+
+  int popped = 0;
+  for (int i = 0; i < item_num; i++) {
+    queue.push(&items[i]);
+    if (i % 3 == 0) {
+      int *item = queue.pop();
+      if (item != nullptr) {
+        taken[*item]++;
+        popped++;
+      }
+    }
+  }
+  for (int *item = queue.pop(); item != nullptr; item = queue.pop()) {
+    taken[*item]++;
+    popped++;
+  }
+  done.store(true);
+  for (thread &t : thieves) {
+    t.join();
+  }
+
+  ASSERT_EQ(item_num, popped + stolen.load());
+  for (int i = 0; i < item_num; i++) {
+    ASSERT_EQ(1, taken[i].load()) << "item " << i;
+  }
+}
+
+TEST(work_stealing_queue, last_item_race)
+{
+  // 所有者每次只放入一个元素然后马上取出，窃取者不停地窃取，pop 和 steal 总是在争抢队列中
+  // 唯一的元素，每个元素只能被其中一方拿到
+  const int rounds = 200000;
+  vector<int>         items(rounds);
+  vector<atomic<int>> taken(rounds);
+  for (int i = 0; i < rounds; i++) {
+    items[i] = i;
+    taken[i].store(0);
+  }
+
+  WorkStealingQueue<int *> queue(4);
+  atomic<bool> done{false};
+  atomic<int>  thief_wins{0};
+  thread thief([&]() {
+    while (!done.load(memory_order_acquire) || !queue.empty()) {
+      int *item = queue.steal();
+      if (item != nullptr) {
+        taken[*item]++;
+        thief_wins++;
+      }
+    }
+  });
+
+  int owner_wins = 0;
+  for (int r = 0; r < rounds; r++) {
+    queue.push(&items[r]);
+    int *item = queue.pop();
+    if (item != nullptr) {
+      ASSERT_EQ(&items[r], item);
+      taken[*item]++;
+      owner_wins++;
+    }
+    // 不管谁拿到，队列都已经是空的，不会留给下一轮
+    ASSERT_TRUE(queue.empty()) << "round " << r;
+  }
+  done.store(true, memory_order_release);
+  thief.join();
+
+  ASSERT_EQ(rounds, owner_wins + thief_wins.load());
+  for (int i = 0; i < rounds; i++) {
+    ASSERT_EQ(1, taken[i].load()) << "item " << i;
+  }
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}